@@ -283,6 +283,65 @@ extern NSString * _Nonnull const MSID_FLIGHT_ENABLE_SKIP_BROKER_CACHE;
 /// WorkItem: 3563423
 extern NSString * _Nonnull const MSID_FLIGHT_BROKER_XPC_INSTANCE_CACHE_ENABLED;
 
+/// Flight to route silent broker XPC requests through a long-lived, multiplexed connection to the broker
+/// instance (MSIDXpcBrokerChannel) instead of establishing a connection per request. Requests are pipelined
+/// over the shared connection; a request dropped by a connection failure is retried once on a dedicated
+/// connection.
+/// Default: OFF
+extern NSString * _Nonnull const MSID_FLIGHT_BROKER_XPC_PERSISTENT_CHANNEL_ENABLED;
+
+/// Flight to install MSIDExponentialBackoffRetryPolicy on every MSIDHttpRequest. Transient failures are retried
+/// with decorrelated-jitter backoff, honor Retry-After, and draw from a retry budget shared per endpoint instead
+/// of the fixed retryCountSetting/retryIntervalSetting schedule.
+/// Default: OFF
+extern NSString * _Nonnull const MSID_FLIGHT_HTTP_RETRY_POLICY_ENABLED;
+
+/// Flight to put a per-host circuit breaker (MSIDCircuitBreakerRegistry) in front of the token, instance discovery,
+/// OpenID configuration and DRS endpoints. While a breaker is open, requests fail immediately with
+/// MSIDServerUnavailableStatusKey set, so silent requests fall back to extended-lifetime or refresh-needed tokens
+/// without waiting for the network timeout.
+/// Default: OFF
+extern NSString * _Nonnull const MSID_FLIGHT_HTTP_CIRCUIT_BREAKER_ENABLED;
+
+/// Flight to serve cacheable metadata requests (OpenID configuration, instance discovery, DRS discovery, WebFinger)
+/// from MSIDMetadataResponseCache, which honours HTTP freshness, revalidates stale entries and persists them across
+/// app launches. When off, MSIDHttpRequest keeps using NSURLCache.
+/// Default: OFF
+extern NSString * _Nonnull const MSID_FLIGHT_HTTP_METADATA_RESPONSE_CACHE_ENABLED;
+
+/// Flight to remember which authority alias a legacy (ADAL format) cache item was found under, so that repeated
+/// legacy lookups read that alias first instead of walking every alias. The index is in memory and is dropped
+/// whenever the legacy accessor writes or removes items.
+/// Default: OFF
+extern NSString * _Nonnull const MSID_FLIGHT_LEGACY_CACHE_LOOKUP_INDEX_ENABLED;
+
+/// Flight to copy a refresh token found only in the legacy (ADAL format) cache into the default cache on first use,
+/// so that later silent requests find it with a single default cache read. The legacy item is kept.
+/// Default: OFF
+extern NSString * _Nonnull const MSID_FLIGHT_LEGACY_CACHE_LAZY_MIGRATION_ENABLED;
+
+/// Flight to record per-lookup cache counters (items fetched, deserialization failures, matcher rejections by reason,
+/// data source and filter time) on token cache lookup telemetry events, the execution flow and the shared lookup histogram.
+/// Default: OFF
+extern NSString * _Nonnull const MSID_FLIGHT_CACHE_LOOKUP_METRICS_ENABLED;
+
+/// Flight to stamp a shared change marker item in the keychain access group on every keychain token cache write and
+/// delete, so that account enumeration views in other processes notice updates made within the same second as their
+/// last check. Costs one extra keychain write per cache write.
+/// Default: OFF
+extern NSString * _Nonnull const MSID_FLIGHT_KEYCHAIN_CHANGE_MARKER_ENABLED;
+
+/// Flight to route silent requests by the origin recorded in account metadata: accounts that only ever got tokens
+/// from the broker skip the local refresh token fallback, and accounts that only ever got tokens locally try the local
+/// refresh token before the SSO extension.
+/// Default: OFF
+extern NSString * _Nonnull const MSID_FLIGHT_ACCOUNT_SOURCE_ROUTING_ENABLED;
+
+/// Flight to start interactive request setup (authority resolution, OpenID metadata, PKCE and state generation, device
+/// info) concurrently as soon as the request is created, so the authorize URL is ready sooner once the webview is shown.
+/// Default: OFF
+extern NSString * _Nonnull const MSID_FLIGHT_INTERACTIVE_PREFETCH_ENABLED;
+
 /// Kill-switch flight to disable opening JavaScript-initiated new-window requests (e.g. window.open()) in the system browser
 /// from the WKUIDelegate createWebViewWithConfiguration: path. Does not affect target=_blank anchor clicks,
 /// which are handled separately in decidePolicyForNavigationAction:.
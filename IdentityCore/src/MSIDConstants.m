@@ -127,6 +127,36 @@ NSString *const MSID_FLIGHT_ENABLE_SKIP_BROKER_CACHE = @"skip_brk_cache";
 // Enables caching and reuse of the Broker XPC instance endpoint (macOS only).
 NSString *const MSID_FLIGHT_BROKER_XPC_INSTANCE_CACHE_ENABLED = @"broker_xpc_instance_cache_enabled";
 
+// Enables the persistent, multiplexed Broker XPC channel for silent requests (macOS only).
+NSString *const MSID_FLIGHT_BROKER_XPC_PERSISTENT_CHANNEL_ENABLED = @"broker_xpc_persistent_channel_enabled";
+
+// Enables the backoff/jitter retry policy with per-endpoint retry budget for MSIDHttpRequest.
+NSString *const MSID_FLIGHT_HTTP_RETRY_POLICY_ENABLED = @"http_retry_policy_enabled";
+
+// Enables endpoint circuit breakers for token, discovery, OpenID configuration and DRS requests.
+NSString *const MSID_FLIGHT_HTTP_CIRCUIT_BREAKER_ENABLED = @"http_circuit_breaker_enabled";
+
+// Enables the validating, disk backed metadata response cache for MSIDHttpRequest.
+NSString *const MSID_FLIGHT_HTTP_METADATA_RESPONSE_CACHE_ENABLED = @"http_metadata_response_cache_enabled";
+
+// Enables the in-memory authority alias index for legacy cache lookups.
+NSString *const MSID_FLIGHT_LEGACY_CACHE_LOOKUP_INDEX_ENABLED = @"legacy_cache_lookup_index_enabled";
+
+// Enables copying legacy-only refresh tokens into the default cache on first use.
+NSString *const MSID_FLIGHT_LEGACY_CACHE_LAZY_MIGRATION_ENABLED = @"legacy_cache_lazy_migration_enabled";
+
+// Enables query-plan counters for token cache lookups.
+NSString *const MSID_FLIGHT_CACHE_LOOKUP_METRICS_ENABLED = @"cache_lookup_metrics_enabled";
+
+// Enables the shared keychain change marker for cross-process cache change detection.
+NSString *const MSID_FLIGHT_KEYCHAIN_CHANGE_MARKER_ENABLED = @"keychain_change_marker_enabled";
+
+// Enables routing silent requests by the account source recorded in account metadata.
+NSString *const MSID_FLIGHT_ACCOUNT_SOURCE_ROUTING_ENABLED = @"account_source_routing_enabled";
+
+// Enables the interactive request setup prefetch.
+NSString *const MSID_FLIGHT_INTERACTIVE_PREFETCH_ENABLED = @"interactive_prefetch_enabled";
+
 NSString *const MSID_FLIGHT_IS_BART_SUPPORTED = @"is_bound_app_rt_supported";
 
 NSString *const MSID_FLIGHT_SPINNER_FIX = @"enable_spinner_fix";
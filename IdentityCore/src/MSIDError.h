@@ -74,6 +74,17 @@ extern NSString * _Nonnull MSIDGrantedScopesKey;
  */
 extern NSString * _Nonnull MSIDServerUnavailableStatusKey;
 
+/*!
+ This flag will be set if the request was not sent because the endpoint circuit breaker is open.
+ MSIDServerUnavailableStatusKey is set as well, so callers fall back as they would for a server outage.
+ */
+extern NSString * _Nonnull MSIDCircuitBreakerOpenKey;
+
+/*!
+ This flag will be set if a leg of a hedged silent request was cancelled because the other leg completed first.
+ */
+extern NSString * _Nonnull MSIDHedgedRequestCancelledKey;
+
 /*!
  This flag will be set if we received a valid token response, but returned data mismatched.
  */
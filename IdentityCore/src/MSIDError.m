@@ -22,6 +22,7 @@
 // THE SOFTWARE.
 
 #import "MSIDErrorConverter.h"
+#import "MSIDLazyError.h"
 
 NSString *MSIDErrorDescriptionKey = @"MSIDErrorDescriptionKey";
 NSString *MSIDOAuthErrorKey = @"MSIDOAuthErrorKey";
@@ -39,6 +40,8 @@ NSString *MSIDTokenProtectionRequired = @"MSIDTokenProtectionRequired";
 NSString *MSIDBrokerVersionKey = @"MSIDBrokerVersionKey";
 NSString *MSIDSTSErrorCodesKey = @"MSIDSTSErrorCodesKey";
 NSString *MSIDServerUnavailableStatusKey = @"MSIDServerUnavailableStatusKey";
+NSString *MSIDCircuitBreakerOpenKey = @"MSIDCircuitBreakerOpenKey";
+NSString *MSIDHedgedRequestCancelledKey = @"MSIDHedgedRequestCancelledKey";
 NSString *MSIDThrottlingCacheHitKey = @"MSIDThrottlingCacheHitKey";
 
 NSString *MSIDErrorDomain = @"MSIDErrorDomain";
@@ -64,6 +67,19 @@ NSError *MSIDCreateError(NSString *domain, NSInteger code, NSString *errorDescri
     {
         MSID_LOG_WITH_CORR(MSIDLogLevelError, correlationId, @"Creating Error with description: %@", errorDescription);
     }
+    
+    if (MSIDLazyError.lazyConstructionEnabled)
+    {
+        return [MSIDLazyError errorWithConverter:errorConverter
+                                          domain:domain
+                                            code:code
+                                errorDescription:errorDescription
+                                      oauthError:oauthError
+                                        subError:subError
+                                 underlyingError:underlyingError
+                                   correlationId:correlationId
+                                        userInfo:additionalUserInfo];
+    }
 
     return [errorConverter errorWithDomain:domain
                                       code:code
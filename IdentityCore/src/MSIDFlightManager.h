@@ -33,6 +33,11 @@ NS_ASSUME_NONNULL_BEGIN
 - (BOOL)boolForKey:(NSString *)flightKey;
 - (nullable NSString *)stringForKey:(NSString *)key;
 
+@optional
+
+/// Return YES if flight values only change together with a call to -[MSIDFlightManager flightProviderDidChangeFlights].
+/// The flight manager then answers repeated reads from a snapshot instead of calling the provider every time.
+- (BOOL)supportsFlightSnapshot;
 
 @end
 
@@ -41,10 +46,17 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, nullable) id<MSIDFlightManagerInterface> flightProvider;
 @property (nonatomic, nullable) id<MSIDFlightManagerQueryKeyDelegate> queryKeyFlightProvider;
 
+/// Version of the flight snapshot. Changes every time the provider is replaced or signals a change.
+@property (nonatomic, readonly) NSUInteger snapshotVersion;
+
 + (instancetype)sharedInstance;
 + (instancetype)sharedInstanceByQueryKey:(NSString *)queryKey
                                  keyType:(MSIDFlightManagerQueryKeyType)keyType;
 
+/// Discards the flight snapshot, so that subsequent reads go to the provider again.
+/// Providers that support snapshots must call this when their flight values change.
+- (void)flightProviderDidChangeFlights;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -25,9 +25,46 @@
 
 #import "MSIDFlightManager.h"
 
+// Immutable set of flight values read from the provider. Never mutated after publishing:
+// new values are added by publishing a copy, so readers only need to load the current pointer.
+@interface MSIDFlightSnapshot : NSObject
+
+@property (nonatomic, readonly) NSUInteger version;
+@property (nonatomic, readonly) BOOL enabled;
+@property (nonatomic, readonly) NSDictionary<NSString *, NSNumber *> *boolValues;
+@property (nonatomic, readonly) NSDictionary<NSString *, id> *stringValues;
+
+- (instancetype)initWithVersion:(NSUInteger)version
+                        enabled:(BOOL)enabled
+                     boolValues:(NSDictionary<NSString *, NSNumber *> *)boolValues
+                   stringValues:(NSDictionary<NSString *, id> *)stringValues;
+
+@end
+
+@implementation MSIDFlightSnapshot
+
+- (instancetype)initWithVersion:(NSUInteger)version
+                        enabled:(BOOL)enabled
+                     boolValues:(NSDictionary<NSString *, NSNumber *> *)boolValues
+                   stringValues:(NSDictionary<NSString *, id> *)stringValues
+{
+    self = [super init];
+    if (self)
+    {
+        _version = version;
+        _enabled = enabled;
+        _boolValues = [boolValues copy];
+        _stringValues = [stringValues copy];
+    }
+    return self;
+}
+
+@end
+
 @interface MSIDFlightManager()
 
 @property (nonatomic) dispatch_queue_t synchronizationQueue;
+@property (atomic) MSIDFlightSnapshot *snapshot;
 
 @end
 
@@ -103,6 +140,7 @@
     if (self)
     {
         _synchronizationQueue = [self initializeDispatchQueue];
+        _snapshot = [[MSIDFlightSnapshot alloc] initWithVersion:0 enabled:NO boolValues:@{} stringValues:@{}];
     }
     return self;
 }
@@ -117,6 +155,7 @@
 {
     dispatch_barrier_sync(self.synchronizationQueue, ^{
         self->_flightProvider = flightProvider;
+        [self publishEmptySnapshot];
     });
 }
 
@@ -137,6 +176,13 @@
 
 - (BOOL)boolForKey:(nonnull NSString *)flightKey
 {
+    MSIDFlightSnapshot *snapshot = self.snapshot;
+    if (snapshot.enabled)
+    {
+        NSNumber *snapshotValue = snapshot.boolValues[flightKey];
+        if (snapshotValue) return snapshotValue.boolValue;
+    }
+    
     __block BOOL result = NO;
     // Read the provider only from within the synchronization queue. Testing it via the
     // unsynchronized property getter first would race the barrier write in setFlightProvider:,
@@ -149,11 +195,23 @@
         }
     });
     
+    if (snapshot.enabled)
+    {
+        [self publishValue:@(result) forKey:flightKey isBoolValue:YES basedOnSnapshot:snapshot];
+    }
+    
     return result;
 }
 
 - (nullable NSString *)stringForKey:(nonnull NSString *)flightKey
 {
+    MSIDFlightSnapshot *snapshot = self.snapshot;
+    if (snapshot.enabled)
+    {
+        id snapshotValue = snapshot.stringValues[flightKey];
+        if (snapshotValue) return snapshotValue == [NSNull null] ? nil : snapshotValue;
+    }
+    
     __block NSString *result = nil;
     // Read the provider only from within the synchronization queue. Testing it via the
     // unsynchronized property getter first would race the barrier write in setFlightProvider:,
@@ -166,8 +224,72 @@
         }
     });
     
+    if (snapshot.enabled)
+    {
+        [self publishValue:result ?: [NSNull null] forKey:flightKey isBoolValue:NO basedOnSnapshot:snapshot];
+    }
+    
     return result;
 }
 
+#pragma mark - Snapshot
+
+- (NSUInteger)snapshotVersion
+{
+    return self.snapshot.version;
+}
+
+- (void)flightProviderDidChangeFlights
+{
+    dispatch_barrier_sync(self.synchronizationQueue, ^{
+        [self publishEmptySnapshot];
+    });
+}
+
+// Must be called on the synchronization queue with a barrier
+- (void)publishEmptySnapshot
+{
+    id<MSIDFlightManagerInterface> flightProvider = _flightProvider;
+    BOOL enabled = [flightProvider respondsToSelector:@selector(supportsFlightSnapshot)] && [flightProvider supportsFlightSnapshot];
+    
+    self.snapshot = [[MSIDFlightSnapshot alloc] initWithVersion:self.snapshot.version + 1
+                                                        enabled:enabled
+                                                     boolValues:@{}
+                                                   stringValues:@{}];
+}
+
+- (void)publishValue:(id)value
+              forKey:(NSString *)flightKey
+         isBoolValue:(BOOL)isBoolValue
+     basedOnSnapshot:(MSIDFlightSnapshot *)snapshot
+{
+    dispatch_barrier_sync(self.synchronizationQueue, ^{
+        MSIDFlightSnapshot *currentSnapshot = self.snapshot;
+        
+        // Provider was replaced or signalled a change after the value was read, so the value might be stale
+        if (currentSnapshot.version != snapshot.version) return;
+        
+        NSDictionary *boolValues = currentSnapshot.boolValues;
+        NSDictionary *stringValues = currentSnapshot.stringValues;
+        
+        if (isBoolValue)
+        {
+            NSMutableDictionary *updatedValues = [boolValues mutableCopy];
+            updatedValues[flightKey] = value;
+            boolValues = updatedValues;
+        }
+        else
+        {
+            NSMutableDictionary *updatedValues = [stringValues mutableCopy];
+            updatedValues[flightKey] = value;
+            stringValues = updatedValues;
+        }
+        
+        self.snapshot = [[MSIDFlightSnapshot alloc] initWithVersion:currentSnapshot.version
+                                                            enabled:currentSnapshot.enabled
+                                                         boolValues:boolValues
+                                                       stringValues:stringValues];
+    });
+}
 
 @end
@@ -0,0 +1,62 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+#import "MSIDErrorConverting.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ NSError created by MSIDCreateError that defers building its userInfo until it is inspected.
+ Many errors on silent and cache paths are created only to be dropped by the caller, for them the error converter never runs.
+ The converter is captured at creation time and invoked on first access to userInfo, or to domain and code
+ when a custom converter may remap them. The result is cached. Archiving the error writes the materialized error.
+ */
+@interface MSIDLazyError : NSError
+
+// When NO (default), MSIDCreateError materializes errors immediately.
+@property (class) BOOL lazyConstructionEnabled;
+
+// When YES, createdCount and observedCount are updated. Intended for diagnostics and benchmarks.
+@property (class) BOOL auditEnabled;
+@property (class, readonly) NSUInteger createdCount;
+@property (class, readonly) NSUInteger observedCount;
+
+@property (nonatomic, readonly) BOOL isMaterialized;
+
++ (nullable instancetype)errorWithConverter:(id<MSIDErrorConverting>)errorConverter
+                                     domain:(NSString *)domain
+                                       code:(NSInteger)code
+                           errorDescription:(nullable NSString *)errorDescription
+                                 oauthError:(nullable NSString *)oauthError
+                                   subError:(nullable NSString *)subError
+                            underlyingError:(nullable NSError *)underlyingError
+                              correlationId:(nullable NSUUID *)correlationId
+                                   userInfo:(nullable NSDictionary *)additionalUserInfo;
+
++ (void)resetAuditCounters;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,215 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDLazyError.h"
+#import "MSIDErrorConverter.h"
+#import <stdatomic.h>
+
+static atomic_bool s_lazyConstructionEnabled = false;
+static atomic_bool s_auditEnabled = false;
+static atomic_ulong s_createdCount = 0;
+static atomic_ulong s_observedCount = 0;
+
+@interface MSIDLazyError()
+
+@property (nonatomic) id<MSIDErrorConverting> errorConverter;
+@property (nonatomic, nullable) NSString *errorDescription;
+@property (nonatomic, nullable) NSString *oauthError;
+@property (nonatomic, nullable) NSString *subError;
+@property (nonatomic, nullable) NSError *underlyingError;
+@property (nonatomic, nullable) NSUUID *correlationId;
+@property (nonatomic, nullable) NSDictionary *additionalUserInfo;
+@property (atomic, nullable) NSError *materializedError;
+
+@end
+
+@implementation MSIDLazyError
+
++ (instancetype)errorWithConverter:(id<MSIDErrorConverting>)errorConverter
+                            domain:(NSString *)domain
+                              code:(NSInteger)code
+                  errorDescription:(NSString *)errorDescription
+                        oauthError:(NSString *)oauthError
+                          subError:(NSString *)subError
+                   underlyingError:(NSError *)underlyingError
+                     correlationId:(NSUUID *)correlationId
+                          userInfo:(NSDictionary *)additionalUserInfo
+{
+    if (!domain || !errorConverter)
+    {
+        return nil;
+    }
+    
+    MSIDLazyError *error = [[self alloc] initWithDomain:domain code:code userInfo:nil];
+    error.errorConverter = errorConverter;
+    error.errorDescription = errorDescription;
+    error.oauthError = oauthError;
+    error.subError = subError;
+    error.underlyingError = underlyingError;
+    error.correlationId = correlationId;
+    error.additionalUserInfo = additionalUserInfo;
+    
+    if (atomic_load(&s_auditEnabled))
+    {
+        atomic_fetch_add(&s_createdCount, 1);
+    }
+    
+    return error;
+}
+
+#pragma mark - Configuration
+
++ (BOOL)lazyConstructionEnabled
+{
+    return atomic_load(&s_lazyConstructionEnabled);
+}
+
++ (void)setLazyConstructionEnabled:(BOOL)lazyConstructionEnabled
+{
+    atomic_store(&s_lazyConstructionEnabled, lazyConstructionEnabled);
+}
+
++ (BOOL)auditEnabled
+{
+    return atomic_load(&s_auditEnabled);
+}
+
++ (void)setAuditEnabled:(BOOL)auditEnabled
+{
+    atomic_store(&s_auditEnabled, auditEnabled);
+}
+
++ (NSUInteger)createdCount
+{
+    return atomic_load(&s_createdCount);
+}
+
++ (NSUInteger)observedCount
+{
+    return atomic_load(&s_observedCount);
+}
+
++ (void)resetAuditCounters
+{
+    atomic_store(&s_createdCount, 0);
+    atomic_store(&s_observedCount, 0);
+}
+
+#pragma mark - Materialization
+
+- (BOOL)isMaterialized
+{
+    return self.materializedError != nil;
+}
+
+- (NSError *)materialize
+{
+    NSError *materializedError = self.materializedError;
+    if (materializedError) return materializedError;
+    
+    @synchronized (self)
+    {
+        if (self.materializedError) return self.materializedError;
+        
+        materializedError = [self.errorConverter errorWithDomain:[super domain]
+                                                            code:[super code]
+                                                errorDescription:self.errorDescription
+                                                      oauthError:self.oauthError
+                                                        subError:self.subError
+                                                 underlyingError:self.underlyingError
+                                                   correlationId:self.correlationId
+                                                        userInfo:self.additionalUserInfo];
+        
+        if (!materializedError)
+        {
+            materializedError = [NSError errorWithDomain:[super domain] code:[super code] userInfo:nil];
+        }
+        
+        self.materializedError = materializedError;
+        
+        if (atomic_load(&s_auditEnabled))
+        {
+            atomic_fetch_add(&s_observedCount, 1);
+        }
+    }
+    
+    return materializedError;
+}
+
+// The default converter keeps domain and code as they are, so they can be returned without building userInfo.
+- (BOOL)mayRemapDomainAndCode
+{
+    return self.errorConverter != MSIDErrorConverter.defaultErrorConverter;
+}
+
+#pragma mark - NSError
+
+- (NSErrorDomain)domain
+{
+    return [self mayRemapDomainAndCode] ? [self materialize].domain : [super domain];
+}
+
+- (NSInteger)code
+{
+    return [self mayRemapDomainAndCode] ? [self materialize].code : [super code];
+}
+
+- (NSDictionary<NSErrorUserInfoKey, id> *)userInfo
+{
+    return [self materialize].userInfo;
+}
+
+- (NSString *)localizedDescription
+{
+    return [self materialize].localizedDescription;
+}
+
+- (NSString *)description
+{
+    return [self materialize].description;
+}
+
+- (BOOL)isEqual:(id)object
+{
+    if (self == object) return YES;
+    
+    if ([object isKindOfClass:MSIDLazyError.class])
+    {
+        object = [(MSIDLazyError *)object materialize];
+    }
+    
+    return [[self materialize] isEqual:object];
+}
+
+- (NSUInteger)hash
+{
+    return [self materialize].hash;
+}
+
+- (id)replacementObjectForCoder:(__unused NSCoder *)coder
+{
+    return [self materialize];
+}
+
+@end
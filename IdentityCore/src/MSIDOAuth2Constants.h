@@ -112,6 +112,7 @@ extern NSString *const MSID_REALM_CACHE_KEY;
 extern NSString *const MSID_AUTHORITY_CACHE_KEY;
 extern NSString *const MSID_HOME_ACCOUNT_ID_CACHE_KEY;
 extern NSString *const MSID_SIGN_IN_STATE_CACHE_KEY;
+extern NSString *const MSID_ACCOUNT_SOURCE_CACHE_KEY;
 extern NSString *const MSID_ENROLLMENT_ID_CACHE_KEY;
 extern NSString *const MSID_CLIENT_ID_CACHE_KEY;
 extern NSString *const MSID_FAMILY_ID_CACHE_KEY;
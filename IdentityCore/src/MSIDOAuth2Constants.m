@@ -111,6 +111,7 @@ NSString *const MSID_REALM_CACHE_KEY                     = @"realm";
 NSString *const MSID_AUTHORITY_CACHE_KEY                 = @"authority";
 NSString *const MSID_HOME_ACCOUNT_ID_CACHE_KEY           = @"home_account_id";
 NSString *const MSID_SIGN_IN_STATE_CACHE_KEY             = @"sign_in_state";
+NSString *const MSID_ACCOUNT_SOURCE_CACHE_KEY            = @"account_source";
 NSString *const MSID_ENROLLMENT_ID_CACHE_KEY             = @"enrollment_id";
 NSString *const MSID_CLIENT_ID_CACHE_KEY                 = @"client_id";
 NSString *const MSID_FAMILY_ID_CACHE_KEY                 = @"family_id";
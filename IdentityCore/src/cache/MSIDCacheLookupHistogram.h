@@ -0,0 +1,67 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+#import "MSIDCacheLookupMetrics.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ Process-wide distribution of cache lookup costs, to spot devices with pathological caches.
+ 
+ Each recorded lookup lands in one bucket per dimension. A bucket counts the lookups whose value is at most its upper
+ bound and above the previous bound; the last bucket has no upper bound and holds everything above the last bound.
+ Thread safe.
+ */
+@interface MSIDCacheLookupHistogram : NSObject
+
++ (instancetype)sharedInstance;
+
+// Upper bounds of the items fetched buckets: 0, 10, 100, 1000, 10000.
+@property (class, nonatomic, readonly) NSArray<NSNumber *> *itemsFetchedBucketBounds;
+
+// Upper bounds of the time buckets in milliseconds: 1, 5, 20, 100, 500.
+@property (class, nonatomic, readonly) NSArray<NSNumber *> *durationBucketBounds;
+
+- (void)recordLookupMetrics:(MSIDCacheLookupMetrics *)metrics;
+
+@property (nonatomic, readonly) NSUInteger lookupCount;
+@property (nonatomic, readonly) NSUInteger lookupsWithDeserializationFailures;
+@property (nonatomic, readonly) NSUInteger maxItemsFetched;
+
+// One count per bucket, itemsFetchedBucketBounds.count + 1 entries.
+@property (nonatomic, readonly) NSArray<NSNumber *> *itemsFetchedCounts;
+
+// One count per bucket, durationBucketBounds.count + 1 entries.
+@property (nonatomic, readonly) NSArray<NSNumber *> *dataSourceTimeCounts;
+@property (nonatomic, readonly) NSArray<NSNumber *> *filterTimeCounts;
+
+// Items rejected by matchers, summed over all lookups.
+- (NSUInteger)totalRejectionsForReason:(MSIDCacheLookupRejectionReason)reason;
+
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,195 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDCacheLookupHistogram.h"
+
+static const NSUInteger MSIDCacheLookupHistogramMaxBuckets = 8;
+
+@interface MSIDCacheLookupHistogram()
+{
+    NSUInteger _lookupCount;
+    NSUInteger _lookupsWithDeserializationFailures;
+    NSUInteger _maxItemsFetched;
+    NSUInteger _itemsFetchedCounts[MSIDCacheLookupHistogramMaxBuckets];
+    NSUInteger _dataSourceTimeCounts[MSIDCacheLookupHistogramMaxBuckets];
+    NSUInteger _filterTimeCounts[MSIDCacheLookupHistogramMaxBuckets];
+    NSUInteger _rejections[MSIDCacheLookupRejectionReasonCount];
+}
+
+@end
+
+static NSUInteger MSIDCacheLookupHistogramBucketIndex(double value, NSArray<NSNumber *> *bounds)
+{
+    NSUInteger index = 0;
+    
+    for (NSNumber *bound in bounds)
+    {
+        if (value <= bound.doubleValue) return index;
+        index++;
+    }
+    
+    return index;
+}
+
+static NSArray<NSNumber *> *MSIDCacheLookupHistogramCounts(const NSUInteger *counts, NSUInteger bucketCount)
+{
+    NSMutableArray<NSNumber *> *result = [NSMutableArray arrayWithCapacity:bucketCount];
+    
+    for (NSUInteger i = 0; i < bucketCount; i++)
+    {
+        [result addObject:@(counts[i])];
+    }
+    
+    return result;
+}
+
+@implementation MSIDCacheLookupHistogram
+
++ (instancetype)sharedInstance
+{
+    static MSIDCacheLookupHistogram *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [MSIDCacheLookupHistogram new];
+    });
+    
+    return sharedInstance;
+}
+
++ (NSArray<NSNumber *> *)itemsFetchedBucketBounds
+{
+    return @[@0, @10, @100, @1000, @10000];
+}
+
++ (NSArray<NSNumber *> *)durationBucketBounds
+{
+    return @[@1, @5, @20, @100, @500];
+}
+
+- (void)recordLookupMetrics:(MSIDCacheLookupMetrics *)metrics
+{
+    if (!metrics) return;
+    
+    NSUInteger itemsFetchedBucket = MSIDCacheLookupHistogramBucketIndex(metrics.itemsFetched, [self.class itemsFetchedBucketBounds]);
+    NSUInteger dataSourceTimeBucket = MSIDCacheLookupHistogramBucketIndex(metrics.dataSourceTime * 1000, [self.class durationBucketBounds]);
+    NSUInteger filterTimeBucket = MSIDCacheLookupHistogramBucketIndex(metrics.filterTime * 1000, [self.class durationBucketBounds]);
+    
+    @synchronized (self)
+    {
+        _lookupCount++;
+        _maxItemsFetched = MAX(_maxItemsFetched, metrics.itemsFetched);
+        _itemsFetchedCounts[itemsFetchedBucket]++;
+        _dataSourceTimeCounts[dataSourceTimeBucket]++;
+        _filterTimeCounts[filterTimeBucket]++;
+        
+        if (metrics.deserializationFailures) _lookupsWithDeserializationFailures++;
+        
+        for (NSInteger reason = 0; reason < MSIDCacheLookupRejectionReasonCount; reason++)
+        {
+            _rejections[reason] += [metrics rejectionCountForReason:reason];
+        }
+    }
+}
+
+- (NSUInteger)lookupCount
+{
+    @synchronized (self)
+    {
+        return _lookupCount;
+    }
+}
+
+- (NSUInteger)lookupsWithDeserializationFailures
+{
+    @synchronized (self)
+    {
+        return _lookupsWithDeserializationFailures;
+    }
+}
+
+- (NSUInteger)maxItemsFetched
+{
+    @synchronized (self)
+    {
+        return _maxItemsFetched;
+    }
+}
+
+- (NSArray<NSNumber *> *)itemsFetchedCounts
+{
+    @synchronized (self)
+    {
+        return MSIDCacheLookupHistogramCounts(_itemsFetchedCounts, [self.class itemsFetchedBucketBounds].count + 1);
+    }
+}
+
+- (NSArray<NSNumber *> *)dataSourceTimeCounts
+{
+    @synchronized (self)
+    {
+        return MSIDCacheLookupHistogramCounts(_dataSourceTimeCounts, [self.class durationBucketBounds].count + 1);
+    }
+}
+
+- (NSArray<NSNumber *> *)filterTimeCounts
+{
+    @synchronized (self)
+    {
+        return MSIDCacheLookupHistogramCounts(_filterTimeCounts, [self.class durationBucketBounds].count + 1);
+    }
+}
+
+- (NSUInteger)totalRejectionsForReason:(MSIDCacheLookupRejectionReason)reason
+{
+    if (reason < 0 || reason >= MSIDCacheLookupRejectionReasonCount) return 0;
+    
+    @synchronized (self)
+    {
+        return _rejections[reason];
+    }
+}
+
+- (void)reset
+{
+    @synchronized (self)
+    {
+        _lookupCount = 0;
+        _lookupsWithDeserializationFailures = 0;
+        _maxItemsFetched = 0;
+        memset(_itemsFetchedCounts, 0, sizeof(_itemsFetchedCounts));
+        memset(_dataSourceTimeCounts, 0, sizeof(_dataSourceTimeCounts));
+        memset(_filterTimeCounts, 0, sizeof(_filterTimeCounts));
+        memset(_rejections, 0, sizeof(_rejections));
+    }
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"(lookups=%lu deserializationFailures=%lu maxItemsFetched=%lu itemsFetched=%@ dataSourceTime=%@ filterTime=%@)",
+            (unsigned long)self.lookupCount, (unsigned long)self.lookupsWithDeserializationFailures, (unsigned long)self.maxItemsFetched,
+            [self.itemsFetchedCounts componentsJoinedByString:@","], [self.dataSourceTimeCounts componentsJoinedByString:@","], [self.filterTimeCounts componentsJoinedByString:@","]];
+}
+
+@end
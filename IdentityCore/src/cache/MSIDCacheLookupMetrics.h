@@ -0,0 +1,98 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+@protocol MSIDExtendedCacheItemSerializing;
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, MSIDCacheLookupRejectionReason)
+{
+    // Home account id or environment didn't match.
+    MSIDCacheLookupRejectionReasonAccount = 0,
+    MSIDCacheLookupRejectionReasonRealm,
+    MSIDCacheLookupRejectionReasonTarget,
+    MSIDCacheLookupRejectionReasonClaims,
+    // Neither client id nor family id matched.
+    MSIDCacheLookupRejectionReasonClientId,
+    MSIDCacheLookupRejectionReasonCount
+};
+
+FOUNDATION_EXPORT NSString *MSIDCacheLookupRejectionReasonToString(MSIDCacheLookupRejectionReason reason);
+
+/*!
+ Counters for one cache lookup: how many items the data source returned, how many of them couldn't be deserialized,
+ how many the matchers discarded and why, and where the time went.
+ 
+ A lookup is recorded on the thread that started it. While recording, MSIDAccountCredentialCache reports every read it
+ does on that thread to +currentMetrics. Not thread safe.
+ */
+@interface MSIDCacheLookupMetrics : NSObject
+
+@property (nonatomic, readonly) NSUInteger dataSourceCallCount;
+
+// Items read from storage, including the ones that failed to deserialize.
+@property (nonatomic, readonly) NSUInteger itemsFetched;
+@property (nonatomic, readonly) NSUInteger deserializationFailures;
+@property (nonatomic, readonly) NSUInteger itemsRejected;
+@property (nonatomic, readonly) NSUInteger itemsReturned;
+
+@property (nonatomic, readonly) NSTimeInterval dataSourceTime;
+@property (nonatomic, readonly) NSTimeInterval filterTime;
+
+- (NSUInteger)rejectionCountForReason:(MSIDCacheLookupRejectionReason)reason;
+
+#pragma mark - Recording
+
+/*!
+ Makes metrics the current metrics of the calling thread until +endRecording: is called for it or it is released.
+ The caller keeps metrics alive while recording, the thread only holds it weakly.
+ Recordings nest, the inner recording is added to the enclosing one when it ends.
+ */
++ (void)beginRecording:(MSIDCacheLookupMetrics *)metrics;
+
+/*!
+ Ends recording of metrics on the calling thread.
+ @return The enclosing recording, or nil if metrics was the outermost one.
+ */
++ (nullable MSIDCacheLookupMetrics *)endRecording:(MSIDCacheLookupMetrics *)metrics;
+
++ (nullable MSIDCacheLookupMetrics *)currentMetrics;
+
+// Serializer that forwards to serializer and counts the items it deserializes.
+- (id<MSIDExtendedCacheItemSerializing>)serializerRecordingDeserializationsWithSerializer:(id<MSIDExtendedCacheItemSerializing>)serializer;
+
+- (void)recordDataSourceCallWithStartTime:(NSTimeInterval)startTime;
+- (void)recordRejectionWithReason:(MSIDCacheLookupRejectionReason)reason;
+- (void)recordFilteringWithStartTime:(NSTimeInterval)startTime returnedItemCount:(NSUInteger)returnedItemCount;
+- (void)recordReturnedItemCount:(NSUInteger)returnedItemCount;
+- (void)addMetrics:(MSIDCacheLookupMetrics *)metrics;
+
+// Start time to pass to the record methods.
++ (NSTimeInterval)currentTime;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,270 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDCacheLookupMetrics.h"
+#import "MSIDExtendedCacheItemSerializing.h"
+
+static NSString *const MSIDCacheLookupMetricsStackKey = @"MSIDCacheLookupMetricsStack";
+
+// Recordings abandoned without +endRecording: but still alive are dropped past this depth.
+static const NSUInteger MSIDCacheLookupMetricsMaxStackDepth = 16;
+
+NSString *MSIDCacheLookupRejectionReasonToString(MSIDCacheLookupRejectionReason reason)
+{
+    switch (reason)
+    {
+        case MSIDCacheLookupRejectionReasonAccount:
+            return @"account";
+        case MSIDCacheLookupRejectionReasonRealm:
+            return @"realm";
+        case MSIDCacheLookupRejectionReasonTarget:
+            return @"target";
+        case MSIDCacheLookupRejectionReasonClaims:
+            return @"claims";
+        case MSIDCacheLookupRejectionReasonClientId:
+            return @"client_id";
+        case MSIDCacheLookupRejectionReasonCount:
+            break;
+    }
+    
+    return [NSString stringWithFormat:@"MSIDCacheLookupRejectionReason(%ld)", (long)reason];
+}
+
+@interface MSIDCacheLookupMetrics()
+{
+    NSUInteger _rejections[MSIDCacheLookupRejectionReasonCount];
+}
+
+- (void)recordDeserializedItem:(id)item;
+
+@end
+
+@interface MSIDCacheLookupRecordingSerializer : NSObject <MSIDExtendedCacheItemSerializing>
+
+@property (nonatomic) id<MSIDExtendedCacheItemSerializing> serializer;
+@property (nonatomic, weak) MSIDCacheLookupMetrics *metrics;
+
+@end
+
+@implementation MSIDCacheLookupRecordingSerializer
+
+- (NSData *)serializeCredentialCacheItem:(MSIDCredentialCacheItem *)item
+{
+    return [self.serializer serializeCredentialCacheItem:item];
+}
+
+- (MSIDCredentialCacheItem *)deserializeCredentialCacheItem:(NSData *)data
+{
+    MSIDCredentialCacheItem *item = [self.serializer deserializeCredentialCacheItem:data];
+    [self.metrics recordDeserializedItem:item];
+    return item;
+}
+
+#if TARGET_OS_OSX
+- (NSData *)serializeCredentialStorageItem:(MSIDMacCredentialStorageItem *)item
+{
+    return [self.serializer serializeCredentialStorageItem:item];
+}
+
+- (MSIDMacCredentialStorageItem *)deserializeCredentialStorageItem:(NSData *)data
+{
+    MSIDMacCredentialStorageItem *item = [self.serializer deserializeCredentialStorageItem:data];
+    [self.metrics recordDeserializedItem:item];
+    return item;
+}
+#endif
+
+- (NSData *)serializeCacheItem:(id<MSIDJsonSerializable>)item
+{
+    return [self.serializer serializeCacheItem:item];
+}
+
+- (id<MSIDJsonSerializable>)deserializeCacheItem:(NSData *)data ofClass:(Class)expectedClass
+{
+    id<MSIDJsonSerializable> item = [self.serializer deserializeCacheItem:data ofClass:expectedClass];
+    [self.metrics recordDeserializedItem:item];
+    return item;
+}
+
+@end
+
+@implementation MSIDCacheLookupMetrics
+
+- (NSUInteger)rejectionCountForReason:(MSIDCacheLookupRejectionReason)reason
+{
+    if (reason < 0 || reason >= MSIDCacheLookupRejectionReasonCount) return 0;
+    
+    return _rejections[reason];
+}
+
+#pragma mark - Recording
+
+// The stack holds recordings weakly, so a recording abandoned by its owner (e.g. a cache event that was never stopped) is dropped
+// once it is released instead of swallowing every later recording on the thread as nested ones.
++ (NSPointerArray *)recordingStackCreateIfNeeded:(BOOL)createIfNeeded
+{
+    NSMutableDictionary *threadDictionary = [NSThread currentThread].threadDictionary;
+    NSPointerArray *stack = threadDictionary[MSIDCacheLookupMetricsStackKey];
+    
+    if (!stack && createIfNeeded)
+    {
+        stack = [NSPointerArray weakObjectsPointerArray];
+        threadDictionary[MSIDCacheLookupMetricsStackKey] = stack;
+    }
+    
+    // -compact doesn't reliably remove entries zeroed by weak references, remove them by hand.
+    for (NSUInteger index = stack.count; index > 0; index--)
+    {
+        if (![stack pointerAtIndex:index - 1]) [stack removePointerAtIndex:index - 1];
+    }
+    
+    if (stack && !stack.count && !createIfNeeded)
+    {
+        [threadDictionary removeObjectForKey:MSIDCacheLookupMetricsStackKey];
+        return nil;
+    }
+    
+    return stack;
+}
+
++ (void)beginRecording:(MSIDCacheLookupMetrics *)metrics
+{
+    NSPointerArray *stack = [self recordingStackCreateIfNeeded:YES];
+    
+    if (stack.count >= MSIDCacheLookupMetricsMaxStackDepth)
+    {
+        [stack removePointerAtIndex:0];
+    }
+    
+    [stack addPointer:(__bridge void *)metrics];
+}
+
++ (MSIDCacheLookupMetrics *)endRecording:(MSIDCacheLookupMetrics *)metrics
+{
+    NSPointerArray *stack = [self recordingStackCreateIfNeeded:NO];
+    NSUInteger index = NSNotFound;
+    
+    for (NSUInteger i = 0; i < stack.count; i++)
+    {
+        if ([stack pointerAtIndex:i] == (__bridge void *)metrics)
+        {
+            index = i;
+            break;
+        }
+    }
+    
+    if (index == NSNotFound) return nil;
+    
+    // Recordings started after this one and never ended are dropped with it.
+    while (stack.count > index)
+    {
+        [stack removePointerAtIndex:stack.count - 1];
+    }
+    
+    MSIDCacheLookupMetrics *enclosing = stack.count ? (__bridge MSIDCacheLookupMetrics *)[stack pointerAtIndex:stack.count - 1] : nil;
+    [enclosing addMetrics:metrics];
+    
+    if (!stack.count)
+    {
+        [[NSThread currentThread].threadDictionary removeObjectForKey:MSIDCacheLookupMetricsStackKey];
+    }
+    
+    return enclosing;
+}
+
++ (MSIDCacheLookupMetrics *)currentMetrics
+{
+    NSPointerArray *stack = [self recordingStackCreateIfNeeded:NO];
+    
+    return stack.count ? (__bridge MSIDCacheLookupMetrics *)[stack pointerAtIndex:stack.count - 1] : nil;
+}
+
++ (NSTimeInterval)currentTime
+{
+    return [NSProcessInfo processInfo].systemUptime;
+}
+
+- (id<MSIDExtendedCacheItemSerializing>)serializerRecordingDeserializationsWithSerializer:(id<MSIDExtendedCacheItemSerializing>)serializer
+{
+    MSIDCacheLookupRecordingSerializer *recordingSerializer = [MSIDCacheLookupRecordingSerializer new];
+    recordingSerializer.serializer = serializer;
+    recordingSerializer.metrics = self;
+    return recordingSerializer;
+}
+
+- (void)recordDeserializedItem:(id)item
+{
+    _itemsFetched++;
+    
+    if (!item) _deserializationFailures++;
+}
+
+- (void)recordDataSourceCallWithStartTime:(NSTimeInterval)startTime
+{
+    _dataSourceCallCount++;
+    _dataSourceTime += MAX([MSIDCacheLookupMetrics currentTime] - startTime, 0);
+}
+
+- (void)recordRejectionWithReason:(MSIDCacheLookupRejectionReason)reason
+{
+    if (reason < 0 || reason >= MSIDCacheLookupRejectionReasonCount) return;
+    
+    _rejections[reason]++;
+    _itemsRejected++;
+}
+
+- (void)recordFilteringWithStartTime:(NSTimeInterval)startTime returnedItemCount:(NSUInteger)returnedItemCount
+{
+    _filterTime += MAX([MSIDCacheLookupMetrics currentTime] - startTime, 0);
+    _itemsReturned += returnedItemCount;
+}
+
+- (void)recordReturnedItemCount:(NSUInteger)returnedItemCount
+{
+    _itemsReturned += returnedItemCount;
+}
+
+- (void)addMetrics:(MSIDCacheLookupMetrics *)metrics
+{
+    _dataSourceCallCount += metrics.dataSourceCallCount;
+    _itemsFetched += metrics.itemsFetched;
+    _deserializationFailures += metrics.deserializationFailures;
+    _itemsRejected += metrics.itemsRejected;
+    _itemsReturned += metrics.itemsReturned;
+    _dataSourceTime += metrics.dataSourceTime;
+    _filterTime += metrics.filterTime;
+    
+    for (NSInteger reason = 0; reason < MSIDCacheLookupRejectionReasonCount; reason++)
+    {
+        _rejections[reason] += [metrics rejectionCountForReason:reason];
+    }
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"(calls=%lu fetched=%lu deserializationFailures=%lu rejected=%lu returned=%lu dataSourceTime=%.2fms filterTime=%.2fms)",
+            (unsigned long)self.dataSourceCallCount, (unsigned long)self.itemsFetched, (unsigned long)self.deserializationFailures, (unsigned long)self.itemsRejected, (unsigned long)self.itemsReturned, self.dataSourceTime * 1000, self.filterTime * 1000];
+}
+
+@end
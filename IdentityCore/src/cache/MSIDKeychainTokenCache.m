@@ -37,6 +37,7 @@
 #import "NSKeyedArchiver+MSIDExtensions.h"
 #import "MSIDJsonObject.h"
 #import "MSIDConstants.h"
+#import "MSIDFlightManager.h"
 
 #if TARGET_OS_IPHONE
     NSString *const MSIDAdalKeychainGroup = @"com.microsoft.adalcache";
@@ -45,14 +46,19 @@
 #endif
 
 static NSString *const s_wipeLibraryString = @"Microsoft.ADAL.WipeAll.1";
+static NSString *const s_changeMarkerService = @"Microsoft.MSID.CacheChange.1";
 static MSIDKeychainTokenCache *s_defaultCache = nil;
 static NSString *s_defaultKeychainGroup = MSIDAdalKeychainGroup;
+// Number of keychain writes made by this process. Part of the cache change token, as modification dates
+// alone can't tell apart two writes made within the same second.
+static uint64_t s_localChangeCount = 0;
 
 @interface MSIDKeychainTokenCache ()
 
 @property (atomic, readwrite, nonnull) NSString *keychainGroup;
 @property (atomic, readwrite, nonnull) NSDictionary *defaultKeychainQuery;
 @property (atomic, readwrite, nonnull) NSDictionary *defaultWipeQuery;
+@property (atomic, readwrite, nonnull) NSDictionary *defaultChangeMarkerQuery;
 
 @end
 
@@ -166,6 +172,16 @@ static NSString *s_defaultKeychainGroup = MSIDAdalKeychainGroup;
 #endif
         
     self.defaultWipeQuery = defaultWipeQuery;
+    
+    NSMutableDictionary *defaultChangeMarkerQuery = [@{(id)kSecClass : (id)kSecClassGenericPassword,
+                                                      (id)kSecAttrService : s_changeMarkerService,
+                                                      (id)kSecAttrAccessGroup : self.keychainGroup,
+                                                      (id)kSecAttrAccount : @"CacheChange"} mutableCopy];
+#ifdef __MAC_OS_X_VERSION_MAX_ALLOWED
+    defaultChangeMarkerQuery[(id)kSecUseDataProtectionKeychain] = @YES;
+#endif
+    
+    self.defaultChangeMarkerQuery = defaultChangeMarkerQuery;
     MSID_LOG_WITH_CTX_PII(MSIDLogLevelInfo, nil, @"Init MSIDKeychainTokenCache with keychainGroup: %@", MSID_PII_LOG_MASKABLE(_keychainGroup));
     
     return self;
@@ -454,6 +470,151 @@ static NSString *s_defaultKeychainGroup = MSIDAdalKeychainGroup;
     return [self cacheItemsWithKey:key serializer:serializer cacheItemClass:MSIDAccountMetadataCacheItem.class context:context error:error];
 }
 
+- (NSDate *)accountMetadataModificationDateWithKey:(MSIDCacheKey *)key
+                                           context:(id<MSIDRequestContext>)context
+                                             error:(NSError *__autoreleasing*)error
+{
+    NSMutableDictionary *query = [self.defaultKeychainQuery mutableCopy];
+    if (key.service)
+    {
+        [query setObject:key.service forKey:(id)kSecAttrService];
+    }
+    if (key.account)
+    {
+        [query setObject:key.account forKey:(id)kSecAttrAccount];
+    }
+    if (key.generic)
+    {
+        [query setObject:key.generic forKey:(id)kSecAttrGeneric];
+    }
+    if (key.type != nil)
+    {
+        [query setObject:key.type forKey:(id)kSecAttrType];
+    }
+    if (key.appKeyHash != nil)
+    {
+        [query setObject:key.appKeyHash forKey:(id)kSecAttrCreator];
+    }
+    
+    // Attributes only, the item data is neither decrypted nor returned.
+    [query setObject:@YES forKey:(id)kSecReturnAttributes];
+    [query setObject:(id)kSecMatchLimitOne forKey:(id)kSecMatchLimit];
+    
+    CFTypeRef cfAttributes = nil;
+    OSStatus status = SecItemCopyMatching((CFDictionaryRef)query, &cfAttributes);
+    
+    if (status == errSecItemNotFound)
+    {
+        return nil;
+    }
+    else if (status != errSecSuccess)
+    {
+        if (error)
+        {
+            *error = MSIDCreateError(MSIDKeychainErrorDomain, status, @"Failed to get item attributes from keychain.", nil, nil, nil, context.correlationId, nil, NO);
+        }
+        MSID_LOG_WITH_CTX(MSIDLogLevelError, context, @"Failed to find keychain item attributes (status: %d)", (int)status);
+        return nil;
+    }
+    
+    NSDictionary *attributes = CFBridgingRelease(cfAttributes);
+    return [attributes objectForKey:(id)kSecAttrModificationDate];
+}
+
+#pragma mark - Change tracking
+
+- (NSString *)cacheChangeTokenWithContext:(id<MSIDRequestContext>)context
+                                    error:(NSError *__autoreleasing*)error
+{
+    uint64_t localChangeCount = [self.class localChangeCount];
+    
+    NSMutableDictionary *query = [self.defaultKeychainQuery mutableCopy];
+    
+    // Attributes only, the item data is neither decrypted nor returned.
+    [query setObject:@YES forKey:(id)kSecReturnAttributes];
+    [query setObject:(id)kSecMatchLimitAll forKey:(id)kSecMatchLimit];
+    
+    CFTypeRef cfItems = nil;
+    OSStatus status = SecItemCopyMatching((CFDictionaryRef)query, &cfItems);
+    
+    if (status == errSecItemNotFound)
+    {
+        return [NSString stringWithFormat:@"%llu--0-0", localChangeCount];
+    }
+    else if (status != errSecSuccess)
+    {
+        if (error)
+        {
+            *error = MSIDCreateError(MSIDKeychainErrorDomain, status, @"Failed to get item attributes from keychain.", nil, nil, nil, context.correlationId, nil, NO);
+        }
+        MSID_LOG_WITH_CTX(MSIDLogLevelError, context, @"Failed to find keychain item attributes (status: %d)", (int)status);
+        return nil;
+    }
+    
+    NSArray<NSDictionary *> *items = CFBridgingRelease(cfItems);
+    
+    // Additions and removals change the count, updates move the latest modification date.
+    // Both miss a same-second update made by another process, the change marker (when flighted) doesn't.
+    NSString *changeMarker = @"";
+    NSTimeInterval latestModification = 0;
+    for (NSDictionary *attributes in items)
+    {
+        NSDate *modificationDate = [attributes objectForKey:(id)kSecAttrModificationDate];
+        latestModification = MAX(latestModification, modificationDate.timeIntervalSince1970);
+        
+        if ([[attributes objectForKey:(id)kSecAttrService] isEqual:s_changeMarkerService])
+        {
+            NSData *markerData = [attributes objectForKey:(id)kSecAttrGeneric];
+            changeMarker = (markerData ? [[NSString alloc] initWithData:markerData encoding:NSUTF8StringEncoding] : nil) ?: @"";
+        }
+    }
+    
+    return [NSString stringWithFormat:@"%llu-%@-%lu-%f", localChangeCount, changeMarker, (unsigned long)items.count, latestModification];
+}
+
+// Stamps the shared change marker item with a new random value, so that other processes see every write
+// regardless of modification date resolution. Random rather than incremented, so writers never read it first.
+// The stamp is an extra keychain write, so it's only made when the flight is on.
+- (void)noteChangeWithContext:(id<MSIDRequestContext>)context
+{
+    [self.class noteLocalChange];
+    
+    if (![[MSIDFlightManager sharedInstance] boolForKey:MSID_FLIGHT_KEYCHAIN_CHANGE_MARKER_ENABLED]) return;
+    
+    NSData *marker = [[NSUUID UUID].UUIDString dataUsingEncoding:NSUTF8StringEncoding];
+    OSStatus status = SecItemUpdate((CFDictionaryRef)self.defaultChangeMarkerQuery, (CFDictionaryRef)@{(id)kSecAttrGeneric : marker});
+    
+    if (status == errSecItemNotFound)
+    {
+        NSMutableDictionary *query = [self.defaultChangeMarkerQuery mutableCopy];
+        [query addEntriesFromDictionary:@{(id)kSecAttrAccessible : (id)kSecAttrAccessibleAfterFirstUnlockThisDeviceOnly,
+                                          (id)kSecAttrGeneric : marker,
+                                          (id)kSecValueData : [NSData data]}];
+        status = SecItemAdd((CFDictionaryRef)query, NULL);
+    }
+    
+    if (status != errSecSuccess)
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelWarning, context, @"Failed to update cache change marker (status: %d)", (int)status);
+    }
+}
+
++ (void)noteLocalChange
+{
+    @synchronized ([MSIDKeychainTokenCache class])
+    {
+        s_localChangeCount++;
+    }
+}
+
++ (uint64_t)localChangeCount
+{
+    @synchronized ([MSIDKeychainTokenCache class])
+    {
+        return s_localChangeCount;
+    }
+}
+
 #pragma mark - Removal
 
 - (BOOL)removeTokensWithKey:(MSIDCacheKey *)key
@@ -534,6 +695,8 @@ static NSString *s_defaultKeychainGroup = MSIDAdalKeychainGroup;
     OSStatus status = SecItemDelete((CFDictionaryRef)query);
     MSID_LOG_WITH_CTX(MSIDLogLevelInfo, context, @"Keychain delete status: %d", (int)status);
     
+    if (status == errSecSuccess) [self noteChangeWithContext:context];
+    
     if (status != errSecSuccess && status != errSecItemNotFound)
     {
         if (error)
@@ -905,6 +1068,10 @@ static NSString *s_defaultKeychainGroup = MSIDAdalKeychainGroup;
         }
         MSID_LOG_WITH_CTX(MSIDLogLevelError, context, @"Failed to set item into keychain (status: %d)", (int)status);
     }
+    else
+    {
+        [self noteChangeWithContext:context];
+    }
     
     return status == errSecSuccess;
 }
@@ -919,6 +1086,8 @@ static NSString *s_defaultKeychainGroup = MSIDAdalKeychainGroup;
     OSStatus status = SecItemDelete((CFDictionaryRef)query);
     MSID_LOG_WITH_CTX(MSIDLogLevelVerbose,context, @"Keychain delete status: %d", (int)status);
 
+    if (status == errSecSuccess) [self noteChangeWithContext:context];
+
     if (status != errSecSuccess && status != errSecItemNotFound)
     {
         if (error)
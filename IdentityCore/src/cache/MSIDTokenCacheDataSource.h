@@ -66,4 +66,12 @@
 - (BOOL)clearWithContext:(id<MSIDRequestContext>)context
                    error:(NSError *__autoreleasing*)error;
 
+@optional
+
+// Opaque value that changes whenever an item is saved to or removed from the data source, including changes made by
+// other processes sharing the same storage. Two equal values mean the stored items haven't changed in between.
+// Returns nil if the value couldn't be determined.
+- (NSString *)cacheChangeTokenWithContext:(id<MSIDRequestContext>)context
+                                    error:(NSError *__autoreleasing*)error;
+
 @end
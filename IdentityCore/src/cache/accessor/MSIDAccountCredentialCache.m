@@ -40,6 +40,8 @@
 #import "MSIDConstants.h"
 #import "MSIDJsonObject.h"
 #import "MSIDFlightManager.h"
+#import "MSIDCacheLookupMetrics.h"
+#import "NSString+MSIDExtensions.h"
 
 @interface MSIDAccountCredentialCache()
 {
@@ -67,6 +69,50 @@ static BOOL s_disableFRT = NO;
     return self;
 }
 
+#pragma mark - Lookup metrics
+
+- (id<MSIDExtendedCacheItemSerializing>)serializerForLookupMetrics:(MSIDCacheLookupMetrics *)metrics
+{
+    return metrics ? [metrics serializerRecordingDeserializationsWithSerializer:_serializer] : _serializer;
+}
+
+- (NSArray<MSIDCredentialCacheItem *> *)tokensWithQuery:(MSIDDefaultCredentialCacheQuery *)query
+                                                context:(id<MSIDRequestContext>)context
+                                                  error:(NSError *__autoreleasing*)error
+{
+    MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics currentMetrics];
+    NSTimeInterval startTime = metrics ? [MSIDCacheLookupMetrics currentTime] : 0;
+    
+    NSArray<MSIDCredentialCacheItem *> *results = [_dataSource tokensWithKey:query serializer:[self serializerForLookupMetrics:metrics] context:context error:error];
+    
+    [metrics recordDataSourceCallWithStartTime:startTime];
+    [metrics recordReturnedItemCount:results.count];
+    return results;
+}
+
+// Mirrors the checks of -[MSIDCredentialCacheItem matchesWithRealm:...] to attribute a rejection to its first failing check.
+- (MSIDCacheLookupRejectionReason)rejectionReasonForCredential:(MSIDCredentialCacheItem *)cacheItem
+                                                         query:(MSIDDefaultCredentialCacheQuery *)cacheQuery
+{
+    if (cacheQuery.realm && ![cacheItem.realm.msidNormalizedString isEqualToString:cacheQuery.realm.msidNormalizedString])
+    {
+        return MSIDCacheLookupRejectionReasonRealm;
+    }
+    
+    if (![cacheItem matchesTarget:cacheQuery.target comparisonOptions:cacheQuery.targetMatchingOptions])
+    {
+        return MSIDCacheLookupRejectionReasonTarget;
+    }
+    
+    if (!([NSString msidIsStringNilOrBlank:cacheItem.requestedClaims] && [NSString msidIsStringNilOrBlank:cacheQuery.requestedClaims])
+        && ![cacheItem.requestedClaims isEqualToString:cacheQuery.requestedClaims])
+    {
+        return MSIDCacheLookupRejectionReasonClaims;
+    }
+    
+    return MSIDCacheLookupRejectionReasonClientId;
+}
+
 #pragma mark - Public
 
 // Reading credentials
@@ -78,10 +124,15 @@ static BOOL s_disableFRT = NO;
     MSID_LOG_WITH_CTX(MSIDLogLevelInfo, context, @"(%@) retrieving cached credentials using credential query", className);
     NSError *cacheError = nil;
     
+    MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics currentMetrics];
+    NSTimeInterval startTime = metrics ? [MSIDCacheLookupMetrics currentTime] : 0;
+    
     NSArray<MSIDCredentialCacheItem *> *results = [_dataSource tokensWithKey:cacheQuery
-                                                                  serializer:_serializer
+                                                                  serializer:[self serializerForLookupMetrics:metrics]
                                                                      context:context
                                                                        error:&cacheError];
+    
+    [metrics recordDataSourceCallWithStartTime:startTime];
 
     MSID_LOG_WITH_CTX(MSIDLogLevelInfo, context, @"(%@) retrieved %ld cached credentials", className, (long)results.count);
     if (cacheError)
@@ -97,6 +148,7 @@ static BOOL s_disableFRT = NO;
     if (!cacheQuery.exactMatch)
     {
         BOOL shouldMatchAccount = !cacheQuery.homeAccountId || !cacheQuery.environment;
+        startTime = metrics ? [MSIDCacheLookupMetrics currentTime] : 0;
 
         NSMutableArray *filteredResults = [NSMutableArray array];
         MSID_LOG_WITH_CTX(MSIDLogLevelInfo, context, @"(%@) credential query requires exact match with the cached credential items. Performing additional filtering checks.", className);
@@ -106,9 +158,10 @@ static BOOL s_disableFRT = NO;
             if (shouldMatchAccount
                 && ![cacheItem matchesWithHomeAccountId:cacheQuery.homeAccountId
                                            environment:cacheQuery.environment
-                                    environmentAliases:cacheQuery.environmentAliases])
+                                   environmentAliasSet:cacheQuery.environmentAliasSet])
             {
                 MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, context, @"(%@) cached item had mismatching homeAccountID or environment/aliases with the credential query. excluding from the results.", className);
+                [metrics recordRejectionWithReason:MSIDCacheLookupRejectionReasonAccount];
                 continue;
             }
 
@@ -121,15 +174,18 @@ static BOOL s_disableFRT = NO;
                             clientIdMatching:cacheQuery.clientIdMatchingOptions])
             {
                 MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, context, @"(%@) cached item had mismatching realm/clientId/familyId/target/requestedClaims with the credential query. excluding from the results.", className);
+                if (metrics) [metrics recordRejectionWithReason:[self rejectionReasonForCredential:cacheItem query:cacheQuery]];
                 continue;
             }
             
             [filteredResults addObject:cacheItem];
         }
         MSID_LOG_WITH_CTX(MSIDLogLevelInfo, context, @"(%@) returning %ld filtered credentials", className, (long)filteredResults.count);
+        [metrics recordFilteringWithStartTime:startTime returnedItemCount:filteredResults.count];
         return filteredResults;
     }
     MSID_LOG_WITH_CTX(MSIDLogLevelInfo, context, @"(%@) returning %ld credentials", className, (long)results.count);
+    [metrics recordReturnedItemCount:results.count];
     return results;
 }
 
@@ -141,7 +197,14 @@ static BOOL s_disableFRT = NO;
 
     MSID_LOG_WITH_CTX_PII(MSIDLogLevelVerbose, context, @"(Default cache) Get credential for key %@, account %@", key.logDescription, MSID_EUII_ONLY_LOG_MASKABLE(key.account));
 
-    return [_dataSource tokenWithKey:key serializer:_serializer context:context error:error];
+    MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics currentMetrics];
+    NSTimeInterval startTime = metrics ? [MSIDCacheLookupMetrics currentTime] : 0;
+    
+    MSIDCredentialCacheItem *result = [_dataSource tokenWithKey:key serializer:[self serializerForLookupMetrics:metrics] context:context error:error];
+    
+    [metrics recordDataSourceCallWithStartTime:startTime];
+    [metrics recordReturnedItemCount:result ? 1 : 0];
+    return result;
 }
 
 - (nullable NSArray<MSIDCredentialCacheItem *> *)getAllCredentialsWithType:(MSIDCredentialType)type
@@ -152,7 +215,7 @@ static BOOL s_disableFRT = NO;
 
     MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
     query.credentialType = type;
-    return [_dataSource tokensWithKey:query serializer:_serializer context:context error:error];
+    return [self tokensWithQuery:query context:context error:error];
 }
 
 
@@ -165,30 +228,39 @@ static BOOL s_disableFRT = NO;
 
     MSID_LOG_WITH_CTX_PII(MSIDLogLevelVerbose, context, @"(Default cache) Get accounts with environment %@, unique user id %@", cacheQuery.environment, MSID_PII_LOG_TRACKABLE(cacheQuery.homeAccountId));
 
-    NSArray<MSIDAccountCacheItem *> *cacheItems = [_dataSource accountsWithKey:cacheQuery serializer:_serializer context:context error:error];
+    MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics currentMetrics];
+    NSTimeInterval startTime = metrics ? [MSIDCacheLookupMetrics currentTime] : 0;
+
+    NSArray<MSIDAccountCacheItem *> *cacheItems = [_dataSource accountsWithKey:cacheQuery serializer:[self serializerForLookupMetrics:metrics] context:context error:error];
+
+    [metrics recordDataSourceCallWithStartTime:startTime];
 
     if (!cacheQuery.exactMatch)
     {
         NSMutableArray<MSIDAccountCacheItem *> *filteredResults = [NSMutableArray array];
 
         BOOL shouldMatchAccount = !cacheQuery.homeAccountId || !cacheQuery.environment;
+        startTime = metrics ? [MSIDCacheLookupMetrics currentTime] : 0;
 
         for (MSIDAccountCacheItem *cacheItem in cacheItems)
         {
             if (shouldMatchAccount
                 && ![cacheItem matchesWithHomeAccountId:cacheQuery.homeAccountId
                                            environment:cacheQuery.environment
-                                    environmentAliases:cacheQuery.environmentAliases])
+                                   environmentAliasSet:cacheQuery.environmentAliasSet])
             {
+                [metrics recordRejectionWithReason:MSIDCacheLookupRejectionReasonAccount];
                 continue;
             }
 
             [filteredResults addObject:cacheItem];
         }
 
+        [metrics recordFilteringWithStartTime:startTime returnedItemCount:filteredResults.count];
         return filteredResults;
     }
 
+    [metrics recordReturnedItemCount:cacheItems.count];
     return cacheItems;
 }
 
@@ -222,7 +294,7 @@ static BOOL s_disableFRT = NO;
 
     MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
     query.matchAnyCredentialType = YES;
-    return [_dataSource tokensWithKey:query serializer:_serializer context:context error:error];
+    return [self tokensWithQuery:query context:context error:error];
 }
 
 // Writing credentials
@@ -547,7 +619,7 @@ static BOOL s_disableFRT = NO;
                 if (shouldMatchMetadata
                     && ![cacheItem matchesWithClientId:cacheQuery.clientId
                                            environment:cacheQuery.environment
-                                    environmentAliases:cacheQuery.environmentAliases])
+                                   environmentAliasSet:cacheQuery.environmentAliasSet])
                 {
                     continue;
                 }
@@ -0,0 +1,68 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+@class MSIDAccount;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Account changes between a generation the caller has seen and the current generation of an MSIDAccountEnumerationView.
+ */
+@interface MSIDAccountEnumerationDelta : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+- (instancetype)initWithGeneration:(NSUInteger)generation
+                    isFullSnapshot:(BOOL)isFullSnapshot
+                     addedAccounts:(NSArray<MSIDAccount *> *)addedAccounts
+                   updatedAccounts:(NSArray<MSIDAccount *> *)updatedAccounts
+                   removedAccounts:(NSArray<MSIDAccount *> *)removedAccounts;
+
+/**
+ Generation the delta brings the caller to. Pass it back on the next call.
+ */
+@property (nonatomic, readonly) NSUInteger generation;
+
+/**
+ YES if the changes since the requested generation are no longer known. addedAccounts then holds every current account
+ and the caller should replace its list instead of applying the delta.
+ */
+@property (nonatomic, readonly) BOOL isFullSnapshot;
+
+@property (nonatomic, readonly) NSArray<MSIDAccount *> *addedAccounts;
+
+// Also holds accounts that were removed and added back since the requested generation.
+@property (nonatomic, readonly) NSArray<MSIDAccount *> *updatedAccounts;
+
+// Last known state of accounts that are no longer returned.
+@property (nonatomic, readonly) NSArray<MSIDAccount *> *removedAccounts;
+
+@property (nonatomic, readonly) BOOL hasChanges;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,60 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDAccountEnumerationDelta.h"
+
+@implementation MSIDAccountEnumerationDelta
+
+- (instancetype)initWithGeneration:(NSUInteger)generation
+                    isFullSnapshot:(BOOL)isFullSnapshot
+                     addedAccounts:(NSArray<MSIDAccount *> *)addedAccounts
+                   updatedAccounts:(NSArray<MSIDAccount *> *)updatedAccounts
+                   removedAccounts:(NSArray<MSIDAccount *> *)removedAccounts
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _generation = generation;
+        _isFullSnapshot = isFullSnapshot;
+        _addedAccounts = addedAccounts;
+        _updatedAccounts = updatedAccounts;
+        _removedAccounts = removedAccounts;
+    }
+    
+    return self;
+}
+
+- (BOOL)hasChanges
+{
+    return self.isFullSnapshot || self.addedAccounts.count || self.updatedAccounts.count || self.removedAccounts.count;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"(generation=%lu fullSnapshot=%d added=%lu updated=%lu removed=%lu)",
+            (unsigned long)self.generation, self.isFullSnapshot, (unsigned long)self.addedAccounts.count, (unsigned long)self.updatedAccounts.count, (unsigned long)self.removedAccounts.count];
+}
+
+@end
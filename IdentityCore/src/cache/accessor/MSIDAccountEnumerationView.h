@@ -0,0 +1,81 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+@class MSIDDefaultTokenCacheAccessor;
+@class MSIDAccountMetadataCacheAccessor;
+@class MSIDAuthority;
+@class MSIDAccount;
+@class MSIDAccountEnumerationDelta;
+@protocol MSIDRequestContext;
+@protocol MSIDTokenCacheDataSource;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Change-tracking view over -[MSIDDefaultTokenCacheAccessor accountsWithAuthority:...] for one set of enumeration parameters.
+ 
+ The view keeps the last enumerated accounts and a generation number that grows every time the returned accounts change.
+ Before enumerating again it compares the change tokens of the backing data sources, so polling an unchanged cache
+ doesn't read or parse any cache items. Data sources that don't report change tokens are enumerated on every call.
+ */
+@interface MSIDAccountEnumerationView : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+/**
+ @param dataSources Data sources backing the accessor and its other accessors. If nil, only the data source of the accessor's
+ credential cache is tracked, and changes made only to other accessors' storage are picked up once that one changes too.
+ */
+- (instancetype)initWithCacheAccessor:(MSIDDefaultTokenCacheAccessor *)accessor
+                          dataSources:(nullable NSArray<id<MSIDTokenCacheDataSource>> *)dataSources
+                            authority:(nullable MSIDAuthority *)authority
+                             clientId:(nullable NSString *)clientId
+                             familyId:(nullable NSString *)familyId
+                 accountMetadataCache:(nullable MSIDAccountMetadataCacheAccessor *)accountMetadataCache
+                 signedInAccountsOnly:(BOOL)signedInAccountsOnly;
+
+/**
+ Generation of the accounts last returned by the view, 0 before the first enumeration.
+ */
+@property (atomic, readonly) NSUInteger generation;
+
+/**
+ Current accounts. Enumerates the cache only if it changed since the last call.
+ */
+- (nullable NSArray<MSIDAccount *> *)accountsWithContext:(nullable id<MSIDRequestContext>)context
+                                                   error:(NSError *__autoreleasing*)error;
+
+/**
+ Accounts added, updated or removed since the given generation. Pass 0 to get every current account.
+ */
+- (nullable MSIDAccountEnumerationDelta *)accountChangesSinceGeneration:(NSUInteger)generation
+                                                                context:(nullable id<MSIDRequestContext>)context
+                                                                  error:(NSError *__autoreleasing*)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
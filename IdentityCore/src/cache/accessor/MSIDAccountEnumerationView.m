@@ -0,0 +1,306 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDAccountEnumerationView.h"
+#import "MSIDAccountEnumerationDelta.h"
+#import "MSIDDefaultTokenCacheAccessor.h"
+#import "MSIDAccountCredentialCache.h"
+#import "MSIDExtendedTokenCacheDataSource.h"
+#import "MSIDAccount.h"
+#import "MSIDAccountIdentifier.h"
+
+// Maximum number of removed accounts remembered for deltas. Callers asking for older generations get a full snapshot.
+static const NSUInteger MSIDAccountEnumerationMaxRemovedEntries = 100;
+
+@interface MSIDAccountEnumerationEntry : NSObject
+
+@property (nonatomic) NSString *key;
+@property (nonatomic) MSIDAccount *account;
+@property (nonatomic) NSDictionary *accountJson;
+@property (nonatomic) NSUInteger addedGeneration;
+@property (nonatomic) NSUInteger changedGeneration;
+@property (nonatomic) NSUInteger removedGeneration;
+
+@end
+
+@implementation MSIDAccountEnumerationEntry
+@end
+
+@interface MSIDAccountEnumerationView()
+{
+    MSIDDefaultTokenCacheAccessor *_accessor;
+    NSArray<id<MSIDTokenCacheDataSource>> *_dataSources;
+    MSIDAuthority *_authority;
+    NSString *_clientId;
+    NSString *_familyId;
+    MSIDAccountMetadataCacheAccessor *_accountMetadataCache;
+    BOOL _signedInAccountsOnly;
+    
+    NSArray<NSString *> *_changeTokens;
+    NSMutableDictionary<NSString *, MSIDAccountEnumerationEntry *> *_entries;
+    NSMutableArray<MSIDAccountEnumerationEntry *> *_removedEntries;
+    NSUInteger _oldestDeltaGeneration;
+}
+
+@property (atomic, readwrite) NSUInteger generation;
+
+@end
+
+@implementation MSIDAccountEnumerationView
+
+- (instancetype)initWithCacheAccessor:(MSIDDefaultTokenCacheAccessor *)accessor
+                          dataSources:(NSArray<id<MSIDTokenCacheDataSource>> *)dataSources
+                            authority:(MSIDAuthority *)authority
+                             clientId:(NSString *)clientId
+                             familyId:(NSString *)familyId
+                 accountMetadataCache:(MSIDAccountMetadataCacheAccessor *)accountMetadataCache
+                 signedInAccountsOnly:(BOOL)signedInAccountsOnly
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _accessor = accessor;
+        _dataSources = dataSources ?: @[accessor.accountCredentialCache.dataSource];
+        _authority = authority;
+        _clientId = clientId;
+        _familyId = familyId;
+        _accountMetadataCache = accountMetadataCache;
+        _signedInAccountsOnly = signedInAccountsOnly;
+        _entries = [NSMutableDictionary new];
+        _removedEntries = [NSMutableArray new];
+    }
+    
+    return self;
+}
+
+#pragma mark - Public
+
+- (NSArray<MSIDAccount *> *)accountsWithContext:(id<MSIDRequestContext>)context
+                                          error:(NSError *__autoreleasing*)error
+{
+    @synchronized (self)
+    {
+        if (![self refreshWithContext:context error:error])
+        {
+            return nil;
+        }
+        
+        return [self currentAccounts];
+    }
+}
+
+- (MSIDAccountEnumerationDelta *)accountChangesSinceGeneration:(NSUInteger)generation
+                                                       context:(id<MSIDRequestContext>)context
+                                                         error:(NSError *__autoreleasing*)error
+{
+    @synchronized (self)
+    {
+        if (![self refreshWithContext:context error:error])
+        {
+            return nil;
+        }
+        
+        NSUInteger currentGeneration = self.generation;
+        
+        if (generation == currentGeneration)
+        {
+            return [[MSIDAccountEnumerationDelta alloc] initWithGeneration:currentGeneration isFullSnapshot:NO addedAccounts:@[] updatedAccounts:@[] removedAccounts:@[]];
+        }
+        
+        // Unknown generation, e.g. from a previous view, or changes since it have been pruned
+        if (generation == 0 || generation > currentGeneration || generation < _oldestDeltaGeneration)
+        {
+            return [[MSIDAccountEnumerationDelta alloc] initWithGeneration:currentGeneration isFullSnapshot:YES addedAccounts:[self currentAccounts] updatedAccounts:@[] removedAccounts:@[]];
+        }
+        
+        NSMutableArray<MSIDAccount *> *added = [NSMutableArray new];
+        NSMutableArray<MSIDAccount *> *updated = [NSMutableArray new];
+        NSMutableArray<MSIDAccount *> *removed = [NSMutableArray new];
+        // Accounts the caller knows about that were removed and added back since, reported as updated
+        NSMutableSet<NSString *> *readdedKeys = [NSMutableSet new];
+        
+        for (MSIDAccountEnumerationEntry *entry in _removedEntries)
+        {
+            // Skip accounts that came and went after the caller's generation
+            if (entry.removedGeneration <= generation || entry.addedGeneration > generation)
+            {
+                continue;
+            }
+            
+            if (_entries[entry.key])
+            {
+                [readdedKeys addObject:entry.key];
+            }
+            else
+            {
+                [removed addObject:entry.account];
+            }
+        }
+        
+        for (MSIDAccountEnumerationEntry *entry in _entries.allValues)
+        {
+            if (entry.addedGeneration > generation && ![readdedKeys containsObject:entry.key])
+            {
+                [added addObject:entry.account];
+            }
+            else if (entry.changedGeneration > generation)
+            {
+                [updated addObject:entry.account];
+            }
+        }
+        
+        return [[MSIDAccountEnumerationDelta alloc] initWithGeneration:currentGeneration isFullSnapshot:NO addedAccounts:added updatedAccounts:updated removedAccounts:removed];
+    }
+}
+
+#pragma mark - Private
+
+- (NSArray<MSIDAccount *> *)currentAccounts
+{
+    NSMutableArray<MSIDAccount *> *accounts = [NSMutableArray arrayWithCapacity:_entries.count];
+    for (MSIDAccountEnumerationEntry *entry in _entries.allValues)
+    {
+        [accounts addObject:entry.account];
+    }
+    
+    return accounts;
+}
+
+- (BOOL)refreshWithContext:(id<MSIDRequestContext>)context
+                     error:(NSError *__autoreleasing*)error
+{
+    // Read change tokens before enumerating, so that changes made while enumerating are picked up by the next call
+    NSArray<NSString *> *changeTokens = [self changeTokensWithContext:context];
+    
+    if (self.generation > 0 && changeTokens && [changeTokens isEqualToArray:_changeTokens])
+    {
+        return YES;
+    }
+    
+    NSArray<MSIDAccount *> *accounts = [_accessor accountsWithAuthority:_authority
+                                                               clientId:_clientId
+                                                               familyId:_familyId
+                                                      accountIdentifier:nil
+                                                   accountMetadataCache:_accountMetadataCache
+                                                   signedInAccountsOnly:_signedInAccountsOnly
+                                                                context:context
+                                                                  error:error];
+    
+    if (!accounts)
+    {
+        return NO;
+    }
+    
+    [self applyAccounts:accounts];
+    _changeTokens = changeTokens;
+    return YES;
+}
+
+- (NSArray<NSString *> *)changeTokensWithContext:(id<MSIDRequestContext>)context
+{
+    NSMutableArray<NSString *> *changeTokens = [NSMutableArray arrayWithCapacity:_dataSources.count];
+    
+    for (id<MSIDTokenCacheDataSource> dataSource in _dataSources)
+    {
+        if (![dataSource respondsToSelector:@selector(cacheChangeTokenWithContext:error:)])
+        {
+            return nil;
+        }
+        
+        NSError *tokenError = nil;
+        NSString *changeToken = [dataSource cacheChangeTokenWithContext:context error:&tokenError];
+        
+        if (!changeToken)
+        {
+            MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, context, @"Failed to read cache change token, enumerating accounts. Error %@", MSID_PII_LOG_MASKABLE(tokenError));
+            return nil;
+        }
+        
+        [changeTokens addObject:changeToken];
+    }
+    
+    return changeTokens;
+}
+
+- (void)applyAccounts:(NSArray<MSIDAccount *> *)accounts
+{
+    NSUInteger nextGeneration = self.generation + 1;
+    BOOL changed = self.generation == 0;
+    NSMutableDictionary<NSString *, MSIDAccountEnumerationEntry *> *remainingEntries = [_entries mutableCopy];
+    
+    for (MSIDAccount *account in accounts)
+    {
+        NSString *key = [self keyForAccount:account];
+        NSDictionary *accountJson = [account jsonDictionary];
+        MSIDAccountEnumerationEntry *entry = _entries[key];
+        
+        if (!entry)
+        {
+            entry = [MSIDAccountEnumerationEntry new];
+            entry.key = key;
+            entry.addedGeneration = nextGeneration;
+            entry.changedGeneration = nextGeneration;
+            _entries[key] = entry;
+            changed = YES;
+        }
+        else if (![entry.accountJson isEqualToDictionary:accountJson])
+        {
+            entry.changedGeneration = nextGeneration;
+            changed = YES;
+        }
+        
+        entry.account = account;
+        entry.accountJson = accountJson;
+        [remainingEntries removeObjectForKey:key];
+    }
+    
+    for (NSString *key in remainingEntries)
+    {
+        MSIDAccountEnumerationEntry *entry = remainingEntries[key];
+        entry.removedGeneration = nextGeneration;
+        [_entries removeObjectForKey:key];
+        [_removedEntries addObject:entry];
+        changed = YES;
+    }
+    
+    while (_removedEntries.count > MSIDAccountEnumerationMaxRemovedEntries)
+    {
+        _oldestDeltaGeneration = _removedEntries.firstObject.removedGeneration;
+        [_removedEntries removeObjectAtIndex:0];
+    }
+    
+    if (changed)
+    {
+        self.generation = nextGeneration;
+    }
+}
+
+- (NSString *)keyForAccount:(MSIDAccount *)account
+{
+    NSString *accountId = account.accountIdentifier.homeAccountId ?: account.accountIdentifier.displayableId.lowercaseString;
+    return [NSString stringWithFormat:@"%@|%@|%@", accountId ?: @"", account.environment ?: @"", account.realm ?: @""];
+}
+
+@end
@@ -0,0 +1,60 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDCacheCompactionResult.h"
+
+@implementation MSIDCacheCompactionResult
+
+- (instancetype)initWithScannedItemCount:(NSUInteger)scannedItemCount
+                 expiredAccessTokenCount:(NSUInteger)expiredAccessTokenCount
+                 orphanedCredentialCount:(NSUInteger)orphanedCredentialCount
+                orphanedAppMetadataCount:(NSUInteger)orphanedAppMetadataCount
+                        skippedItemCount:(NSUInteger)skippedItemCount
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _scannedItemCount = scannedItemCount;
+        _expiredAccessTokenCount = expiredAccessTokenCount;
+        _orphanedCredentialCount = orphanedCredentialCount;
+        _orphanedAppMetadataCount = orphanedAppMetadataCount;
+        _skippedItemCount = skippedItemCount;
+    }
+    
+    return self;
+}
+
+- (NSUInteger)reclaimedItemCount
+{
+    return self.expiredAccessTokenCount + self.orphanedCredentialCount + self.orphanedAppMetadataCount;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"(scanned=%lu expiredAccessTokens=%lu orphanedCredentials=%lu orphanedAppMetadata=%lu skipped=%lu)",
+            (unsigned long)self.scannedItemCount, (unsigned long)self.expiredAccessTokenCount, (unsigned long)self.orphanedCredentialCount, (unsigned long)self.orphanedAppMetadataCount, (unsigned long)self.skippedItemCount];
+}
+
+@end
@@ -0,0 +1,103 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+@class MSIDAccountCredentialCache;
+@class MSIDCacheCompactionResult;
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^MSIDCacheCompactionCompletionBlock)(MSIDCacheCompactionResult * _Nullable result, NSError * _Nullable error);
+
+/**
+ Background sweeper that removes expired access tokens, and optionally orphaned credentials and app metadata, from the
+ credential cache.
+ 
+ Sweeps run on a private utility queue. A sweep reads the cache once to find candidates and then removes them in batches
+ of batchSize with batchDelay between batches, so it never holds the cache for long. Every candidate is read again right
+ before removal and left alone if it was updated in the meantime. Refresh tokens are never removed.
+ 
+ Each sweep reports its counts as a cache_compaction telemetry event.
+ */
+@interface MSIDCacheCompactor : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+- (instancetype)initWithAccountCredentialCache:(MSIDAccountCredentialCache *)accountCredentialCache;
+
+/**
+ Delay between -start and the first scheduled sweep. Default: 60 seconds.
+ */
+@property (atomic) NSTimeInterval initialDelay;
+
+/**
+ Minimum time between the end of one sweep and the next scheduled one, including sweeps requested with
+ -sweepWithCompletion:. 0 runs a single scheduled sweep. Default: 24 hours.
+ */
+@property (atomic) NSTimeInterval sweepInterval;
+
+/**
+ Maximum number of items removed before the sweep pauses. Default: 20.
+ */
+@property (atomic) NSUInteger batchSize;
+
+/**
+ Pause between two batches. Default: 0.5 seconds.
+ */
+@property (atomic) NSTimeInterval batchDelay;
+
+/**
+ Access tokens are removed once both expiresOn and extendedExpiresOn are older than this. Default: 0.
+ */
+@property (atomic) NSTimeInterval expirationGracePeriod;
+
+/**
+ Also remove access and ID tokens whose account is no longer cached, and app metadata of clients without credentials.
+ Default: NO.
+ */
+@property (atomic) BOOL removeOrphanedItems;
+
+@property (atomic, readonly) BOOL isScheduled;
+
+/**
+ Starts sweeping on schedule. Does nothing if already started.
+ */
+- (void)start;
+
+/**
+ Cancels scheduled sweeps. A sweep that is already running finishes its current batch and stops.
+ */
+- (void)stop;
+
+/**
+ Runs a sweep now. If one is already running, completion gets that sweep's result instead. Completion is called on the
+ compactor's queue.
+ */
+- (void)sweepWithCompletion:(nullable MSIDCacheCompactionCompletionBlock)completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
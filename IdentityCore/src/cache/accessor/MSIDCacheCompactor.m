@@ -0,0 +1,546 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDCacheCompactor.h"
+#import "MSIDCacheCompactionResult.h"
+#import "MSIDAccountCredentialCache.h"
+#import "MSIDCredentialCacheItem.h"
+#import "MSIDAccountCacheItem.h"
+#import "MSIDAppMetadataCacheItem.h"
+#import "MSIDAppMetadataCacheQuery.h"
+#import "MSIDDefaultAccountCacheQuery.h"
+#import "MSIDDefaultCredentialCacheKey.h"
+#import "MSIDBasicContext.h"
+#if !EXCLUDE_FROM_MSALCPP
+#import "MSIDTelemetry+Internal.h"
+#import "MSIDTelemetry+Cache.h"
+#import "MSIDTelemetryCacheEvent.h"
+#import "MSIDTelemetryEventStrings.h"
+#endif
+
+@interface MSIDCacheCompactionSweep : NSObject
+
+@property (nonatomic) MSIDBasicContext *context;
+@property (nonatomic) NSDate *expirationCutoff;
+@property (nonatomic) NSUInteger batchSize;
+@property (nonatomic) NSTimeInterval batchDelay;
+@property (nonatomic) BOOL removeOrphanedItems;
+@property (nonatomic) NSUInteger stopCount;
+
+@property (nonatomic) NSArray<MSIDCredentialCacheItem *> *credentialCandidates;
+@property (nonatomic) NSArray<MSIDAppMetadataCacheItem *> *appMetadataCandidates;
+@property (nonatomic) NSUInteger nextCandidateIndex;
+
+@property (nonatomic) NSUInteger scannedItemCount;
+@property (nonatomic) NSUInteger expiredAccessTokenCount;
+@property (nonatomic) NSUInteger orphanedCredentialCount;
+@property (nonatomic) NSUInteger orphanedAppMetadataCount;
+@property (nonatomic) NSUInteger skippedItemCount;
+
+#if !EXCLUDE_FROM_MSALCPP
+@property (nonatomic) MSIDTelemetryCacheEvent *telemetryEvent;
+#endif
+
+@end
+
+@implementation MSIDCacheCompactionSweep
+@end
+
+@interface MSIDCacheCompactor()
+{
+    MSIDAccountCredentialCache *_accountCredentialCache;
+    dispatch_queue_t _queue;
+    
+    // Guarded by @synchronized(self).
+    BOOL _scheduled;
+    NSUInteger _scheduleGeneration;
+    NSUInteger _stopCount;
+    
+    // Only accessed on _queue.
+    NSDate *_lastSweepDate;
+    NSMutableArray<MSIDCacheCompactionCompletionBlock> *_pendingCompletions;
+}
+
+@end
+
+@implementation MSIDCacheCompactor
+
+- (instancetype)initWithAccountCredentialCache:(MSIDAccountCredentialCache *)accountCredentialCache
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _accountCredentialCache = accountCredentialCache;
+        _queue = dispatch_queue_create("com.microsoft.msidcachecompactor", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+        _initialDelay = 60;
+        _sweepInterval = 24 * 60 * 60;
+        _batchSize = 20;
+        _batchDelay = 0.5;
+    }
+    
+    return self;
+}
+
+#pragma mark - Scheduling
+
+- (BOOL)isScheduled
+{
+    @synchronized (self)
+    {
+        return _scheduled;
+    }
+}
+
+- (void)start
+{
+    NSUInteger generation;
+    
+    @synchronized (self)
+    {
+        if (_scheduled) return;
+        
+        _scheduled = YES;
+        generation = ++_scheduleGeneration;
+    }
+    
+    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, nil, @"Scheduling cache compaction, initial delay %f, interval %f.", self.initialDelay, self.sweepInterval);
+    
+    [self scheduleSweepAfter:self.initialDelay generation:generation];
+}
+
+- (void)stop
+{
+    @synchronized (self)
+    {
+        _scheduled = NO;
+        _scheduleGeneration++;
+        _stopCount++;
+    }
+}
+
+- (BOOL)isCurrentScheduleGeneration:(NSUInteger)generation
+{
+    @synchronized (self)
+    {
+        return _scheduled && _scheduleGeneration == generation;
+    }
+}
+
+- (NSUInteger)currentStopCount
+{
+    @synchronized (self)
+    {
+        return _stopCount;
+    }
+}
+
+- (void)scheduleSweepAfter:(NSTimeInterval)delay generation:(NSUInteger)generation
+{
+    __weak typeof(self) weakSelf = self;
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(MAX(delay, 0) * NSEC_PER_SEC)), _queue, ^{
+        [weakSelf scheduledSweepFiredWithGeneration:generation];
+    });
+}
+
+- (void)scheduledSweepFiredWithGeneration:(NSUInteger)generation
+{
+    if (![self isCurrentScheduleGeneration:generation]) return;
+    
+    NSTimeInterval sweepInterval = self.sweepInterval;
+    
+    // A sweep requested by the caller counts towards the schedule.
+    if (_lastSweepDate && sweepInterval > 0)
+    {
+        NSTimeInterval sinceLastSweep = -[_lastSweepDate timeIntervalSinceNow];
+        
+        if (sinceLastSweep < sweepInterval)
+        {
+            [self scheduleSweepAfter:sweepInterval - sinceLastSweep generation:generation];
+            return;
+        }
+    }
+    
+    __weak typeof(self) weakSelf = self;
+    
+    [self beginSweepWithCompletion:^(__unused MSIDCacheCompactionResult *result, __unused NSError *error)
+    {
+        if (sweepInterval > 0)
+        {
+            [weakSelf scheduleSweepAfter:sweepInterval generation:generation];
+        }
+        else
+        {
+            [weakSelf finishScheduleWithGeneration:generation];
+        }
+    }];
+}
+
+- (void)finishScheduleWithGeneration:(NSUInteger)generation
+{
+    @synchronized (self)
+    {
+        if (_scheduleGeneration == generation)
+        {
+            _scheduled = NO;
+        }
+    }
+}
+
+#pragma mark - Sweep
+
+- (void)sweepWithCompletion:(MSIDCacheCompactionCompletionBlock)completion
+{
+    dispatch_async(_queue, ^{
+        [self beginSweepWithCompletion:completion];
+    });
+}
+
+- (void)beginSweepWithCompletion:(MSIDCacheCompactionCompletionBlock)completion
+{
+    if (_pendingCompletions)
+    {
+        if (completion) [_pendingCompletions addObject:completion];
+        return;
+    }
+    
+    _pendingCompletions = [NSMutableArray new];
+    if (completion) [_pendingCompletions addObject:completion];
+    
+    MSIDCacheCompactionSweep *sweep = [MSIDCacheCompactionSweep new];
+    sweep.context = [MSIDBasicContext new];
+    sweep.context.correlationId = [NSUUID UUID];
+    sweep.expirationCutoff = [NSDate dateWithTimeIntervalSinceNow:-self.expirationGracePeriod];
+    sweep.batchSize = MAX(self.batchSize, 1);
+    sweep.batchDelay = self.batchDelay;
+    sweep.removeOrphanedItems = self.removeOrphanedItems;
+    sweep.stopCount = [self currentStopCount];
+    
+#if !EXCLUDE_FROM_MSALCPP
+    sweep.context.telemetryRequestId = [[MSIDTelemetry sharedInstance] generateRequestId];
+    sweep.telemetryEvent = [MSIDTelemetry startCacheEventWithName:MSID_TELEMETRY_EVENT_CACHE_COMPACTION context:sweep.context];
+#endif
+    
+    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, sweep.context, @"Starting cache compaction.");
+    
+    NSError *error;
+    NSSet<NSString *> *homeAccountIds = nil;
+    
+    if (sweep.removeOrphanedItems)
+    {
+        homeAccountIds = [self cachedHomeAccountIdsWithContext:sweep.context error:&error];
+        
+        if (!homeAccountIds)
+        {
+            // Without the full account list every credential would look orphaned.
+            MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, sweep.context, @"Failed to read accounts, only removing expired access tokens. Error %@", MSID_PII_LOG_MASKABLE(error));
+            sweep.removeOrphanedItems = NO;
+        }
+    }
+    
+    NSArray<MSIDCredentialCacheItem *> *credentials = [_accountCredentialCache getAllItemsWithContext:sweep.context error:&error];
+    
+    if (!credentials)
+    {
+        MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, sweep.context, @"Failed to read credentials for cache compaction, error %@", MSID_PII_LOG_MASKABLE(error));
+        [self finishSweep:sweep error:error];
+        return;
+    }
+    
+    sweep.scannedItemCount = credentials.count;
+    
+    NSMutableArray<MSIDCredentialCacheItem *> *credentialCandidates = [NSMutableArray new];
+    
+    for (MSIDCredentialCacheItem *credential in credentials)
+    {
+        if ([self isExpiredAccessToken:credential cutoff:sweep.expirationCutoff]
+            || (homeAccountIds && [self isOrphanedCredential:credential homeAccountIds:homeAccountIds]))
+        {
+            [credentialCandidates addObject:credential];
+        }
+    }
+    
+    sweep.credentialCandidates = credentialCandidates;
+    
+    if (sweep.removeOrphanedItems)
+    {
+        // App metadata is checked against a fresh read once the credentials are gone.
+        sweep.appMetadataCandidates = [_accountCredentialCache getAppMetadataEntriesWithQuery:[MSIDAppMetadataCacheQuery new]
+                                                                                      context:sweep.context
+                                                                                        error:&error];
+        
+        if (!sweep.appMetadataCandidates)
+        {
+            MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, sweep.context, @"Failed to read app metadata, skipping it. Error %@", MSID_PII_LOG_MASKABLE(error));
+        }
+    }
+    
+    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, sweep.context, @"Cache compaction scanned %lu credentials, found %lu credential candidates.", (unsigned long)credentials.count, (unsigned long)credentialCandidates.count);
+    
+    [self removeNextBatchOfSweep:sweep];
+}
+
+- (void)removeNextBatchOfSweep:(MSIDCacheCompactionSweep *)sweep
+{
+    if (sweep.stopCount != [self currentStopCount])
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelInfo, sweep.context, @"Cache compaction stopped.");
+        [self finishSweep:sweep error:nil];
+        return;
+    }
+    
+    NSUInteger credentialCount = sweep.credentialCandidates.count;
+    NSUInteger candidateCount = credentialCount + sweep.appMetadataCandidates.count;
+    NSUInteger batchStart = sweep.nextCandidateIndex;
+    NSUInteger batchEnd = MIN(batchStart + sweep.batchSize, candidateCount);
+    
+    // Keep credentials and app metadata in separate batches, app metadata depends on the credentials being gone.
+    if (batchStart < credentialCount)
+    {
+        batchEnd = MIN(batchEnd, credentialCount);
+    }
+    
+    if (batchStart >= batchEnd)
+    {
+        [self finishSweep:sweep error:nil];
+        return;
+    }
+    
+    if (batchStart < credentialCount)
+    {
+        [self removeCredentials:[sweep.credentialCandidates subarrayWithRange:NSMakeRange(batchStart, batchEnd - batchStart)] sweep:sweep];
+    }
+    else
+    {
+        [self removeAppMetadata:[sweep.appMetadataCandidates subarrayWithRange:NSMakeRange(batchStart - credentialCount, batchEnd - batchStart)] sweep:sweep];
+    }
+    
+    sweep.nextCandidateIndex = batchEnd;
+    
+    if (batchEnd == candidateCount)
+    {
+        [self finishSweep:sweep error:nil];
+        return;
+    }
+    
+    __weak typeof(self) weakSelf = self;
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(MAX(sweep.batchDelay, 0) * NSEC_PER_SEC)), _queue, ^{
+        
+        __strong typeof(self) strongSelf = weakSelf;
+        
+        if (!strongSelf) return;
+        
+        [strongSelf removeNextBatchOfSweep:sweep];
+    });
+}
+
+- (void)removeCredentials:(NSArray<MSIDCredentialCacheItem *> *)candidates sweep:(MSIDCacheCompactionSweep *)sweep
+{
+    NSSet<NSString *> *homeAccountIds = nil;
+    
+    if (sweep.removeOrphanedItems)
+    {
+        // Accounts may have been added back since the scan.
+        NSError *error;
+        homeAccountIds = [self cachedHomeAccountIdsWithContext:sweep.context error:&error];
+        
+        if (!homeAccountIds)
+        {
+            MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, sweep.context, @"Failed to read accounts, keeping orphaned credentials in this batch. Error %@", MSID_PII_LOG_MASKABLE(error));
+        }
+    }
+    
+    for (MSIDCredentialCacheItem *candidate in candidates)
+    {
+        MSIDDefaultCredentialCacheKey *key = (MSIDDefaultCredentialCacheKey *)[candidate generateCacheKey];
+        key.appKey = candidate.appKey;
+        
+        NSError *error;
+        MSIDCredentialCacheItem *current = [_accountCredentialCache getCredential:key context:sweep.context error:&error];
+        
+        // Updated or already removed since the scan.
+        if (!current || ![current isEqual:candidate])
+        {
+            sweep.skippedItemCount++;
+            continue;
+        }
+        
+        BOOL expired = [self isExpiredAccessToken:current cutoff:sweep.expirationCutoff];
+        
+        if (!expired && !(homeAccountIds && [self isOrphanedCredential:current homeAccountIds:homeAccountIds]))
+        {
+            sweep.skippedItemCount++;
+            continue;
+        }
+        
+        if (![_accountCredentialCache removeCredential:current context:sweep.context error:&error])
+        {
+            MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, sweep.context, @"Failed to remove credential during cache compaction, error %@", MSID_PII_LOG_MASKABLE(error));
+            sweep.skippedItemCount++;
+            continue;
+        }
+        
+        if (expired)
+        {
+            sweep.expiredAccessTokenCount++;
+        }
+        else
+        {
+            sweep.orphanedCredentialCount++;
+        }
+    }
+}
+
+- (void)removeAppMetadata:(NSArray<MSIDAppMetadataCacheItem *> *)candidates sweep:(MSIDCacheCompactionSweep *)sweep
+{
+    NSError *error;
+    NSArray<MSIDCredentialCacheItem *> *credentials = [_accountCredentialCache getAllItemsWithContext:sweep.context error:&error];
+    
+    if (!credentials)
+    {
+        MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, sweep.context, @"Failed to read credentials, keeping app metadata in this batch. Error %@", MSID_PII_LOG_MASKABLE(error));
+        sweep.skippedItemCount += candidates.count;
+        return;
+    }
+    
+    NSMutableSet<NSString *> *clientIds = [NSMutableSet new];
+    
+    for (MSIDCredentialCacheItem *credential in credentials)
+    {
+        if (credential.clientId) [clientIds addObject:credential.clientId];
+    }
+    
+    for (MSIDAppMetadataCacheItem *candidate in candidates)
+    {
+        BOOL hasCredentials = (candidate.clientId && [clientIds containsObject:candidate.clientId])
+                              || (candidate.familyId && [clientIds containsObject:[MSIDCacheKey familyClientId:candidate.familyId]]);
+        
+        if (hasCredentials)
+        {
+            sweep.skippedItemCount++;
+            continue;
+        }
+        
+        if (![_accountCredentialCache removeAppMetadata:candidate context:sweep.context error:&error])
+        {
+            MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, sweep.context, @"Failed to remove app metadata during cache compaction, error %@", MSID_PII_LOG_MASKABLE(error));
+            sweep.skippedItemCount++;
+            continue;
+        }
+        
+        sweep.orphanedAppMetadataCount++;
+    }
+}
+
+- (void)finishSweep:(MSIDCacheCompactionSweep *)sweep error:(NSError *)error
+{
+    MSIDCacheCompactionResult *result = nil;
+    
+    if (!error)
+    {
+        result = [[MSIDCacheCompactionResult alloc] initWithScannedItemCount:sweep.scannedItemCount
+                                                     expiredAccessTokenCount:sweep.expiredAccessTokenCount
+                                                     orphanedCredentialCount:sweep.orphanedCredentialCount
+                                                    orphanedAppMetadataCount:sweep.orphanedAppMetadataCount
+                                                            skippedItemCount:sweep.skippedItemCount];
+        
+        MSID_LOG_WITH_CTX(MSIDLogLevelInfo, sweep.context, @"Cache compaction finished %@", result);
+    }
+    
+#if !EXCLUDE_FROM_MSALCPP
+    if (result) [sweep.telemetryEvent setCacheCompactionResult:result];
+    [MSIDTelemetry stopCacheEvent:sweep.telemetryEvent withItem:nil success:result != nil context:sweep.context];
+    [[MSIDTelemetry sharedInstance] flush:sweep.context.telemetryRequestId];
+#endif
+    
+    _lastSweepDate = [NSDate date];
+    
+    NSArray<MSIDCacheCompactionCompletionBlock> *completions = _pendingCompletions;
+    _pendingCompletions = nil;
+    
+    for (MSIDCacheCompactionCompletionBlock completion in completions)
+    {
+        completion(result, error);
+    }
+}
+
+#pragma mark - Helpers
+
+- (BOOL)isExpiredAccessToken:(MSIDCredentialCacheItem *)credential cutoff:(NSDate *)cutoff
+{
+    if (credential.credentialType != MSIDAccessTokenType && credential.credentialType != MSIDAccessTokenWithAuthSchemeType)
+    {
+        return NO;
+    }
+    
+    if (!credential.expiresOn || [credential.expiresOn compare:cutoff] != NSOrderedAscending)
+    {
+        return NO;
+    }
+    
+    // Extended lifetime tokens are still served while the service is unavailable.
+    return !credential.extendedExpiresOn || [credential.extendedExpiresOn compare:cutoff] == NSOrderedAscending;
+}
+
+- (BOOL)isOrphanedCredential:(MSIDCredentialCacheItem *)credential homeAccountIds:(NSSet<NSString *> *)homeAccountIds
+{
+    switch (credential.credentialType)
+    {
+        case MSIDAccessTokenType:
+        case MSIDAccessTokenWithAuthSchemeType:
+        case MSIDIDTokenType:
+        case MSIDLegacyIDTokenType:
+            return credential.homeAccountId && ![homeAccountIds containsObject:credential.homeAccountId];
+            
+        default:
+            return NO;
+    }
+}
+
+- (NSSet<NSString *> *)cachedHomeAccountIdsWithContext:(id<MSIDRequestContext>)context error:(NSError *__autoreleasing*)error
+{
+    NSMutableSet<NSString *> *homeAccountIds = [NSMutableSet new];
+    
+    // Account queries are scoped to one account type.
+    for (NSNumber *accountType in @[@(MSIDAccountTypeMSSTS), @(MSIDAccountTypeAADV1), @(MSIDAccountTypeMSA), @(MSIDAccountTypeADFS), @(MSIDAccountTypeOther)])
+    {
+        MSIDDefaultAccountCacheQuery *query = [MSIDDefaultAccountCacheQuery new];
+        query.accountType = accountType.integerValue;
+        
+        NSArray<MSIDAccountCacheItem *> *accounts = [_accountCredentialCache getAccountsWithQuery:query context:context error:error];
+        
+        if (!accounts) return nil;
+        
+        for (MSIDAccountCacheItem *account in accounts)
+        {
+            if (account.homeAccountId) [homeAccountIds addObject:account.homeAccountId];
+        }
+    }
+    
+    return homeAccountIds;
+}
+
+@end
@@ -52,6 +52,9 @@
 #import "MSIDBoundRefreshToken.h"
 #import "MSIDWorkPlaceJoinUtil.h"
 #import "MSIDWPJKeyPairWithCert.h"
+#import "MSIDLegacyRefreshToken.h"
+#import "MSIDFlightManager.h"
+#import "MSIDConstants.h"
 
 @interface MSIDDefaultTokenCacheAccessor()
 {
@@ -201,6 +204,12 @@
         if (refreshToken)
         {
             MSID_LOG_WITH_CTX(MSIDLogLevelInfo, context, @"(Default accessor) Found refresh token in a different accessor %@", [accessor class]);
+            
+            if (!familyId)
+            {
+                [self migrateLegacyRefreshTokenIfNeeded:refreshToken context:context];
+            }
+            
             return refreshToken;
         }
     }
@@ -293,6 +302,7 @@
 {
     MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
     query.environmentAliases = [configuration.authority defaultCacheEnvironmentAliases];
+    query.environmentAliasSet = [configuration.authority defaultCacheEnvironmentAliasSet];
     query.credentialType = MSIDPrimaryRefreshTokenType;
     query.homeAccountId = accountIdentifier.homeAccountId;
 
@@ -319,6 +329,29 @@
     // For nested auth, get the RT using the broker/hub's client id
     NSString *clientId = [configuration isNestedAuthProtocol] ? configuration.nestedAuthBrokerClientId : configuration.clientId;
 
+    if (![NSString msidIsStringNilOrBlank:accountIdentifier.homeAccountId]
+        && ![NSString msidIsStringNilOrBlank:accountIdentifier.displayableId])
+    {
+        MSID_LOG_WITH_CTX_PII(MSIDLogLevelVerbose, context, @"(Default accessor) Finding token with user ID %@ or legacy user ID %@, clientId %@, familyID %@, authority %@", accountIdentifier.maskedHomeAccountId, accountIdentifier.maskedDisplayableId, configuration.clientId, familyId, configuration.authority);
+
+        // Both identifiers are known, so read the candidates once and rank them in memory instead of querying per identifier.
+        // The query doesn't pin the account: with environment aliases the data source can't filter by account anyway.
+        MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
+        query.environmentAliases = [configuration.authority defaultCacheEnvironmentAliases];
+        query.environmentAliasSet = [configuration.authority defaultCacheEnvironmentAliasSet];
+        query.clientId = familyId ? nil : clientId;
+        query.familyId = familyId;
+        query.credentialType = credentialType;
+
+        return (MSIDRefreshToken *)[self getTokenWithEnvironment:configuration.authority.environment
+                                                      cacheQuery:query
+                                                   homeAccountId:accountIdentifier.homeAccountId
+                                                 legacyAccountId:accountIdentifier.displayableId
+                                                       authority:configuration.authority
+                                                         context:context
+                                                           error:error];
+    }
+
     if (![NSString msidIsStringNilOrBlank:accountIdentifier.homeAccountId])
     {
         MSID_LOG_WITH_CTX_PII(MSIDLogLevelVerbose, context, @"(Default accessor) Finding token with user ID %@, clientId %@, familyID %@, authority %@", accountIdentifier.maskedHomeAccountId, configuration.clientId, familyId, configuration.authority);
@@ -326,6 +359,7 @@
         MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
         query.homeAccountId = accountIdentifier.homeAccountId;
         query.environmentAliases = [configuration.authority defaultCacheEnvironmentAliases];
+        query.environmentAliasSet = [configuration.authority defaultCacheEnvironmentAliasSet];
         query.clientId = familyId ? nil : clientId;
         query.familyId = familyId;
         query.credentialType = credentialType;
@@ -412,6 +446,7 @@
     MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
     query.homeAccountId = accountIdentifier.homeAccountId;
     query.environmentAliases = [configuration.authority defaultCacheEnvironmentAliases];
+    query.environmentAliasSet = [configuration.authority defaultCacheEnvironmentAliasSet];
     query.realm = configuration.authority.realm;
     query.clientId = configuration.clientId;
     query.target = configuration.target;
@@ -459,6 +494,7 @@
     MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
     query.homeAccountId = accountIdentifier.homeAccountId;
     query.environmentAliases = [configuration.authority defaultCacheEnvironmentAliases];
+    query.environmentAliasSet = [configuration.authority defaultCacheEnvironmentAliasSet];
     query.realm = configuration.authority.realm;
     query.clientId = configuration.clientId;
     query.credentialType = idTokenType;
@@ -489,6 +525,7 @@
     MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
     query.homeAccountId = accountIdentifier.homeAccountId;
     query.environmentAliases = [authority defaultCacheEnvironmentAliases];
+    query.environmentAliasSet = [authority defaultCacheEnvironmentAliasSet];
     query.realm = authority.realm;
     query.clientId = clientId;
     query.credentialType = MSIDIDTokenType;
@@ -543,6 +580,7 @@
     MSIDDefaultAccountCacheQuery *accountsQuery = [MSIDDefaultAccountCacheQuery new];
     accountsQuery.accountType = MSIDAccountTypeMSSTS;
     accountsQuery.environmentAliases = environmentAliases;
+    accountsQuery.environmentAliasSet = [authority defaultCacheEnvironmentAliasSet];
     accountsQuery.homeAccountId = accountIdentifier.homeAccountId;
     accountsQuery.username = accountIdentifier.displayableId;
 
@@ -657,6 +695,7 @@
     MSIDDefaultAccountCacheQuery *cacheQuery = [MSIDDefaultAccountCacheQuery new];
     cacheQuery.homeAccountId = accountIdentifier.homeAccountId;
     cacheQuery.environmentAliases = [authority defaultCacheEnvironmentAliases];
+    cacheQuery.environmentAliasSet = [authority defaultCacheEnvironmentAliasSet];
     cacheQuery.realm = authority.realm;
     cacheQuery.accountType = MSIDAccountTypeMSSTS;
 
@@ -688,6 +727,7 @@
          */
         if (realmHint && [account.realm isEqualToString:realmHint])
         {
+            CONDITIONAL_STOP_CACHE_EVENT(event, nil, YES, context);
             return account;
         }
         
@@ -769,12 +809,14 @@
     if (homeAccountId)
     {
         NSArray *aliases = [authority defaultCacheEnvironmentAliases];
+        NSSet *aliasSet = [authority defaultCacheEnvironmentAliasSet];
 
         MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
         query.clientId = clientId;
         query.familyId = familyId;
         query.homeAccountId = homeAccountId;
         query.environmentAliases = aliases;
+        query.environmentAliasSet = aliasSet;
         query.matchAnyCredentialType = YES;
 
         NSError *credentialRemovalError;
@@ -791,6 +833,7 @@
             MSIDDefaultAccountCacheQuery *accountQuery = [MSIDDefaultAccountCacheQuery new];
             accountQuery.homeAccountId = homeAccountId;
             accountQuery.environmentAliases = aliases;
+            accountQuery.environmentAliasSet = aliasSet;
             accountQuery.accountType = MSIDAccountTypeMSSTS;
 
             NSError *accountRemovalError;
@@ -991,6 +1034,32 @@
 
 #pragma mark - Internal
 
+- (void)migrateLegacyRefreshTokenIfNeeded:(MSIDRefreshToken *)refreshToken
+                                  context:(id<MSIDRequestContext>)context
+{
+    if (![refreshToken isKindOfClass:[MSIDLegacyRefreshToken class]]
+        || [NSString msidIsStringNilOrBlank:refreshToken.accountIdentifier.homeAccountId]
+        || ![[MSIDFlightManager sharedInstance] boolForKey:MSID_FLIGHT_LEGACY_CACHE_LAZY_MIGRATION_ENABLED])
+    {
+        return;
+    }
+    
+    // Copy the legacy refresh token into the default cache, so that next lookups for it don't fall back to the legacy cache.
+    // The legacy item is left in place for ADAL apps sharing the cache.
+    // The legacy accessor reports the requested environment, the copy keeps the one the token was issued for.
+    MSIDRefreshToken *migratedToken = [refreshToken copy];
+    migratedToken.environment = refreshToken.storageEnvironment ?: refreshToken.environment;
+    
+    NSError *migrationError = nil;
+    if (![self saveToken:migratedToken context:context error:&migrationError])
+    {
+        MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, context, @"(Default accessor) Failed to migrate legacy refresh token, error %@", MSID_PII_LOG_MASKABLE(migrationError));
+        return;
+    }
+    
+    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, context, @"(Default accessor) Migrated legacy refresh token to the default cache");
+}
+
 - (BOOL)saveAccessTokenWithConfiguration:(MSIDConfiguration *)configuration
                                 response:(MSIDTokenResponse *)response
                                  factory:(MSIDOauth2Factory *)factory
@@ -1175,6 +1244,7 @@
     MSIDDefaultAccountCacheQuery *accountsQuery = [MSIDDefaultAccountCacheQuery new];
     accountsQuery.username = legacyAccountId;
     accountsQuery.environmentAliases = [authority defaultCacheEnvironmentAliases];
+    accountsQuery.environmentAliasSet = [authority defaultCacheEnvironmentAliasSet];
     accountsQuery.accountType = MSIDAccountTypeMSSTS;
 
     NSArray<MSIDAccountCacheItem *> *accountCacheItems = [_accountCredentialCache getAccountsWithQuery:accountsQuery
@@ -1196,13 +1266,36 @@
                                 cacheQuery:(MSIDDefaultCredentialCacheQuery *)cacheQuery
                                    context:(id<MSIDRequestContext>)context
                                      error:(NSError *__autoreleasing*)error
+{
+    return [self getTokenWithEnvironment:environment
+                              cacheQuery:cacheQuery
+                           homeAccountId:cacheQuery.homeAccountId
+                         legacyAccountId:nil
+                               authority:nil
+                                 context:context
+                                   error:error];
+}
+
+/*
+ Reads candidates for the query with a single data source call and returns the best one.
+ Candidates matching homeAccountId rank above candidates of the account resolved from legacyAccountId,
+ which is only resolved when there's no match for homeAccountId. Within an account, candidates are ranked by their
+ position in the query's environment aliases, preferred cache alias first. Only the winning item is converted into a token.
+ */
+- (MSIDBaseToken *)getTokenWithEnvironment:(NSString *)environment
+                                cacheQuery:(MSIDDefaultCredentialCacheQuery *)cacheQuery
+                             homeAccountId:(NSString *)homeAccountId
+                           legacyAccountId:(NSString *)legacyAccountId
+                                 authority:(MSIDAuthority *)authority
+                                   context:(id<MSIDRequestContext>)context
+                                     error:(NSError *__autoreleasing*)error
 {
     CONDITIONAL_START_CACHE_EVENT(event, MSID_TELEMETRY_EVENT_TOKEN_CACHE_LOOKUP, context);
 
     MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, context, @"(Default accessor) Looking for token with aliases %@, tenant %@, clientId %@, scopes %@", cacheQuery.environmentAliases, cacheQuery.realm, cacheQuery.clientId, cacheQuery.target);
 
     NSError *cacheError = nil;
-    NSArray<MSIDBaseToken *> *resultTokens = [self getTokensWithEnvironment:environment cacheQuery:cacheQuery context:context error:&cacheError];
+    NSArray<MSIDCredentialCacheItem *> *cacheItems = [_accountCredentialCache getCredentialsWithQuery:cacheQuery context:context error:&cacheError];
 
     if (cacheError)
     {
@@ -1211,12 +1304,48 @@
         return nil;
     }
 
-    MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, context, @"(Default accessor) Found %lu tokens", (unsigned long)[resultTokens count]);
+    MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, context, @"(Default accessor) Found %lu candidate items", (unsigned long)[cacheItems count]);
+
+    MSIDBaseToken *resultToken = [self bestTokenFromCacheItems:cacheItems
+                                                 homeAccountId:homeAccountId
+                                                credentialType:cacheQuery.credentialType
+                                            environmentAliases:cacheQuery.environmentAliases
+                                          requestedEnvironment:environment];
+
+    if (resultToken && legacyAccountId)
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, context, @"(Default accessor) Found %@ by home account id", [MSIDCredentialTypeHelpers credentialTypeAsString:cacheQuery.credentialType]);
+    }
+
+    if (!resultToken && legacyAccountId && cacheItems.count)
+    {
+        NSString *legacyHomeAccountId = [self homeAccountIdForLegacyId:legacyAccountId
+                                                             authority:authority
+                                                               context:context
+                                                                 error:error];
 
-    if (resultTokens.count > 0)
+        if (![NSString msidIsStringNilOrBlank:legacyHomeAccountId]
+            && ![legacyHomeAccountId.msidNormalizedString isEqualToString:homeAccountId.msidNormalizedString])
+        {
+            MSID_LOG_WITH_CTX_PII(MSIDLogLevelVerbose, context, @"(Default accessor) Found home account ID %@ for legacy user ID", MSID_PII_LOG_TRACKABLE(legacyHomeAccountId));
+
+            resultToken = [self bestTokenFromCacheItems:cacheItems
+                                          homeAccountId:legacyHomeAccountId
+                                         credentialType:cacheQuery.credentialType
+                                     environmentAliases:cacheQuery.environmentAliases
+                                   requestedEnvironment:environment];
+
+            if (resultToken)
+            {
+                MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, context, @"(Default accessor) Found %@ by legacy account id", [MSIDCredentialTypeHelpers credentialTypeAsString:cacheQuery.credentialType]);
+            }
+        }
+    }
+
+    if (resultToken)
     {
-        CONDITIONAL_STOP_CACHE_EVENT(event, resultTokens[0], YES, context);
-        return resultTokens[0];
+        CONDITIONAL_STOP_CACHE_EVENT(event, resultToken, YES, context);
+        return resultToken;
     }
 
     if (cacheQuery.credentialType == MSIDRefreshTokenType ||
@@ -1234,6 +1363,93 @@
     return nil;
 }
 
+- (MSIDBaseToken *)bestTokenFromCacheItems:(NSArray<MSIDCredentialCacheItem *> *)cacheItems
+                             homeAccountId:(NSString *)homeAccountId
+                            credentialType:(MSIDCredentialType)credentialType
+                        environmentAliases:(NSArray<NSString *> *)environmentAliases
+                      requestedEnvironment:(NSString *)requestedEnvironment
+{
+    NSString *normalizedHomeAccountId = homeAccountId.msidNormalizedString;
+
+    if (credentialType == MSIDBoundRefreshTokenType)
+    {
+        // Bound tokens need device validation, which also orders them by recency; do it only for this account's candidates
+        NSMutableArray<MSIDCredentialCacheItem *> *accountItems = [NSMutableArray new];
+        for (MSIDCredentialCacheItem *cacheItem in cacheItems)
+        {
+            if (!normalizedHomeAccountId || [cacheItem.homeAccountId.msidNormalizedString isEqualToString:normalizedHomeAccountId])
+            {
+                [accountItems addObject:cacheItem];
+            }
+        }
+
+        cacheItems = [self validateBoundAppRefreshTokens:accountItems homeAccountId:homeAccountId];
+        normalizedHomeAccountId = nil;
+    }
+
+    NSMutableSet<MSIDCredentialCacheItem *> *rejectedItems = nil;
+
+    while (YES)
+    {
+        MSIDCredentialCacheItem *bestItem = nil;
+        NSUInteger bestRank = NSUIntegerMax;
+
+        for (MSIDCredentialCacheItem *cacheItem in cacheItems)
+        {
+            if (normalizedHomeAccountId && ![cacheItem.homeAccountId.msidNormalizedString isEqualToString:normalizedHomeAccountId]) continue;
+            if ([rejectedItems containsObject:cacheItem]) continue;
+
+            NSUInteger rank = [self rankOfEnvironment:cacheItem.environment inAliases:environmentAliases];
+
+            if (rank < bestRank)
+            {
+                bestItem = cacheItem;
+                bestRank = rank;
+            }
+
+            // Nothing can outrank the preferred cache alias
+            if (bestRank == 0) break;
+        }
+
+        if (!bestItem) return nil;
+
+        MSIDBaseToken *resultToken = [self tokenFromCacheItem:bestItem credentialType:credentialType requestedEnvironment:requestedEnvironment];
+        if (resultToken) return resultToken;
+
+        if (!rejectedItems) rejectedItems = [NSMutableSet new];
+        [rejectedItems addObject:bestItem];
+    }
+}
+
+- (NSUInteger)rankOfEnvironment:(NSString *)environment inAliases:(NSArray<NSString *> *)environmentAliases
+{
+    NSUInteger rank = 0;
+    for (NSString *alias in environmentAliases)
+    {
+        if ([alias caseInsensitiveCompare:environment] == NSOrderedSame) return rank;
+        rank++;
+    }
+
+    return rank;
+}
+
+- (MSIDBaseToken *)tokenFromCacheItem:(MSIDCredentialCacheItem *)cacheItem
+                       credentialType:(MSIDCredentialType)credentialType
+                 requestedEnvironment:(NSString *)requestedEnvironment
+{
+    MSIDBaseToken *resultToken = [cacheItem tokenWithType:credentialType];
+    if (!resultToken) return nil;
+
+    resultToken.storageEnvironment = resultToken.environment;
+
+    if (requestedEnvironment)
+    {
+        resultToken.environment = requestedEnvironment;
+    }
+
+    return resultToken;
+}
+
 - (NSArray<MSIDBaseToken *> *)getTokensWithEnvironment:(NSString *)requestedEnvironment
                                             cacheQuery:(MSIDDefaultCredentialCacheQuery *)cacheQuery
                                                context:(id<MSIDRequestContext>)context
@@ -1257,21 +1473,16 @@
     NSMutableArray<MSIDBaseToken *> *resultTokens = [NSMutableArray new];
     for (MSIDCredentialCacheItem *cacheItem in cacheItems)
     {
-        MSIDBaseToken *resultToken = [cacheItem tokenWithType:cacheQuery.credentialType];
+        MSIDBaseToken *resultToken = [self tokenFromCacheItem:cacheItem credentialType:cacheQuery.credentialType requestedEnvironment:requestedEnvironment];
 
         if (resultToken)
         {
             MSID_LOG_WITH_CTX(MSIDLogLevelInfo, context, @"(Default accessor) Found %lu tokens", (unsigned long)[cacheItems count]);
-            resultToken.storageEnvironment = resultToken.environment;
-
-            if (requestedEnvironment)
-            {
-                resultToken.environment = requestedEnvironment;
-            }
             [resultTokens addObject:resultToken];
         }
     }
 
+    CONDITIONAL_STOP_CACHE_EVENT(event, nil, [resultTokens count] > 0, context);
     return resultTokens;
 }
 
@@ -1301,6 +1512,7 @@
     MSIDDefaultCredentialCacheQuery *rtQuery = [MSIDDefaultCredentialCacheQuery new];
     rtQuery.homeAccountId = homeAccountId;
     rtQuery.environmentAliases = [authority defaultCacheEnvironmentAliases];
+    rtQuery.environmentAliasSet = [authority defaultCacheEnvironmentAliasSet];
     rtQuery.clientId = familyId ? nil : clientId;
     rtQuery.familyId = familyId;
     rtQuery.credentialType = credentialType;
@@ -1438,6 +1650,7 @@
     refreshTokenQuery.clientId = clientId;
     refreshTokenQuery.familyId = familyId;
     refreshTokenQuery.environmentAliases = [authority defaultCacheEnvironmentAliases];
+    refreshTokenQuery.environmentAliasSet = [authority defaultCacheEnvironmentAliasSet];
     refreshTokenQuery.clientIdMatchingOptions = MSIDSuperSet;
 
     NSArray<MSIDCredentialCacheItem *> *refreshTokens = [accountCredentialCache getCredentialsWithQuery:refreshTokenQuery context:context error:error];
@@ -1471,6 +1684,19 @@
         [idTokenSearchMap setValue:idToken forKey:key];
     }
 
+    // Sign-in states of all accounts come from the same per-client metadata item, so read it once.
+    NSDictionary<NSString *, NSNumber *> *signInStates = nil;
+    if (signedInAccountsOnly)
+    {
+        NSMutableSet<NSString *> *homeAccountIds = [NSMutableSet new];
+        for (MSIDAccountCacheItem *accountCacheItem in allAccounts)
+        {
+            if (accountCacheItem.homeAccountId) [homeAccountIds addObject:accountCacheItem.homeAccountId];
+        }
+
+        signInStates = [accountMetadataCache signInStatesForHomeAccountIds:homeAccountIds clientId:clientId context:nil error:nil];
+    }
+
     for (MSIDAccountCacheItem *accountCacheItem in allAccounts)
     {
         BOOL shouldReturnAccount = NO;
@@ -1481,7 +1707,7 @@
                 shouldReturnAccount = YES;
             }
 
-            MSIDAccountMetadataState signInState = [accountMetadataCache signInStateForHomeAccountId:accountCacheItem.homeAccountId clientId:clientId context:nil error:nil];
+            MSIDAccountMetadataState signInState = accountCacheItem.homeAccountId ? [signInStates[accountCacheItem.homeAccountId] integerValue] : MSIDAccountMetadataStateUnknown;
             if (signInState == MSIDAccountMetadataStateSignedIn)
             {
                 shouldReturnAccount = YES;
@@ -1544,6 +1770,15 @@
                                                  noReturnAccountUPNs:(NSSet<NSString *> *)noReturnAccountUPNSet
                                                  knownReturnAccounts:(NSSet<MSIDAccount *> *)knownReturnAccounts
 {
+    NSMutableSet<NSString *> *homeAccountIds = [NSMutableSet new];
+    for (MSIDAccount *account in accounts)
+    {
+        NSString *homeAccountId = account.accountIdentifier.homeAccountId;
+        if (![NSString msidIsStringNilOrBlank:homeAccountId] && ![knownReturnAccounts containsObject:account]) [homeAccountIds addObject:homeAccountId];
+    }
+
+    NSDictionary<NSString *, NSNumber *> *signInStates = [accountMetadataCache signInStatesForHomeAccountIds:homeAccountIds clientId:clientId context:nil error:nil];
+
     NSMutableArray *returnAccounts = [NSMutableArray new];
     for (MSIDAccount *account in accounts)
     {
@@ -1558,7 +1793,7 @@
         }
         else
         {
-            MSIDAccountMetadataState signInState = [accountMetadataCache signInStateForHomeAccountId:account.accountIdentifier.homeAccountId clientId:clientId context:nil error:nil];
+            MSIDAccountMetadataState signInState = [signInStates[account.accountIdentifier.homeAccountId] integerValue];
             if (signInState == MSIDAccountMetadataStateSignedOut) continue;
         }
 
@@ -1665,6 +1900,7 @@
     metadataQuery.clientId = configuration.clientId;
     metadataQuery.generalType = MSIDAppMetadataType;
     metadataQuery.environmentAliases = [configuration.authority defaultCacheEnvironmentAliases];
+    metadataQuery.environmentAliasSet = [configuration.authority defaultCacheEnvironmentAliasSet];
     return [_accountCredentialCache getAppMetadataEntriesWithQuery:metadataQuery context:context error:error];
 }
 
@@ -1678,6 +1914,7 @@
     metadataQuery.clientId = clientId;
     metadataQuery.generalType = MSIDAppMetadataType;
     metadataQuery.environmentAliases = [authority defaultCacheEnvironmentAliases];
+    metadataQuery.environmentAliasSet = [authority defaultCacheEnvironmentAliasSet];
     NSArray<MSIDAppMetadataCacheItem *> *appmetadataItems = [_accountCredentialCache getAppMetadataEntriesWithQuery:metadataQuery context:context error:error];
 
     if (!appmetadataItems)
@@ -43,12 +43,17 @@
 #import "MSIDTelemetry+Cache.h"
 #import "NSURL+MSIDExtensions.h"
 #import "NSURL+MSIDAADUtils.h"
+#import "MSIDCache.h"
+#import "MSIDFlightManager.h"
+#import "MSIDConstants.h"
 
 @interface MSIDLegacyTokenCacheAccessor()
 {
     id<MSIDTokenCacheDataSource> _dataSource;
     MSIDKeyedArchiverSerializer *_serializer;
     NSArray *_otherAccessors;
+    // Legacy user id, client id and resource -> authority alias the legacy item was last found under
+    MSIDCache<NSString *, NSURL *> *_lookupIndex;
 }
 
 @end
@@ -67,6 +72,7 @@
         _dataSource = dataSource;
         _serializer = [[MSIDKeyedArchiverSerializer alloc] init];
         _otherAccessors = otherAccessors;
+        _lookupIndex = [MSIDCache new];
     }
 
     return self;
@@ -236,6 +242,7 @@
                    error:(NSError *__autoreleasing*)error
 {
     MSID_LOG_WITH_CTX(MSIDLogLevelWarning,context, @"(Legacy accessor) Clearing everything in cache. This method should only be called in tests!");
+    [_lookupIndex removeAllObjects];
     return [_dataSource clearWithContext:context error:error];
 }
 
@@ -255,10 +262,10 @@
     query.legacyUserId = accountIdentifier.displayableId;
     __auto_type items = [_dataSource tokensWithKey:query serializer:_serializer context:context error:error];
 
-    NSArray<NSString *> *environmentAliases = [authority defaultCacheEnvironmentAliases];
+    NSSet<NSString *> *environmentAliases = [authority defaultCacheEnvironmentAliasSet];
 
     BOOL (^filterBlock)(MSIDCredentialCacheItem *tokenCacheItem) = ^BOOL(MSIDCredentialCacheItem *tokenCacheItem) {
-        if ([environmentAliases count] && ![tokenCacheItem.environment msidIsEquivalentWithAnyAlias:environmentAliases])
+        if ([environmentAliases count] && ![tokenCacheItem.environment msidIsEquivalentWithAnyAliasInSet:environmentAliases])
         {
             return NO;
         }
@@ -502,6 +509,7 @@
     {
         result = [_dataSource removeTokensWithKey:query context:context error:error];
         [_dataSource saveWipeInfoWithContext:context error:nil];
+        [_lookupIndex removeAllObjects];
     }
     else
     {
@@ -511,12 +519,12 @@
         if (results)
         {
             NSString *requestClientID = familyId ? [MSIDCacheKey familyClientId:familyId] : clientId;
-            NSArray *aliases = authority.defaultCacheEnvironmentAliases;
+            NSSet *aliases = authority.defaultCacheEnvironmentAliasSet;
 
             for (MSIDLegacyTokenCacheItem *cacheItem in results)
             {
                 if ((!requestClientID || [cacheItem.clientId isEqualToString:requestClientID])
-                    && (!authority || [cacheItem.environment msidIsEquivalentWithAnyAlias:aliases]))
+                    && (!authority || [cacheItem.environment msidIsEquivalentWithAnyAliasInSet:aliases]))
                 {
                     result &= [self removeTokenEnvironment:cacheItem.environment
                                                      realm:cacheItem.realm
@@ -696,6 +704,11 @@
                               serializer:_serializer
                                  context:context
                                    error:error];
+    
+    // A save can put the item under an alias that is looked up before the indexed one
+    [self invalidateLookupIndexWithLegacyUserId:token.accountIdentifier.displayableId
+                                       clientId:tokenCacheItem.clientId
+                                       resource:tokenCacheItem.target];
 
     if (!result)
     {
@@ -766,6 +779,7 @@
     key.applicationIdentifier = applicationIdentifier;
 
     BOOL result = [_dataSource removeTokensWithKey:key context:context error:error];
+    [self invalidateLookupIndexWithLegacyUserId:userId clientId:clientId resource:target];
 
     if (result && credentialType == MSIDRefreshTokenType)
     {
@@ -789,8 +803,14 @@
                                     error:(NSError *__autoreleasing*)error
 {
     CONDITIONAL_START_CACHE_EVENT(event, MSID_TELEMETRY_EVENT_TOKEN_CACHE_LOOKUP, context);
-
-    for (NSURL *alias in aliases)
+    
+    NSString *indexKey = nil;
+    if (aliases.count > 1 && [[MSIDFlightManager sharedInstance] boolForKey:MSID_FLIGHT_LEGACY_CACHE_LOOKUP_INDEX_ENABLED])
+    {
+        indexKey = [self lookupIndexKeyWithLegacyUserId:legacyUserId clientId:clientId resource:resource];
+    }
+    
+    for (NSURL *alias in [self orderedLookupAliases:aliases indexKey:indexKey])
     {
         MSID_LOG_WITH_CTX_PII(MSIDLogLevelVerbose, context, @"(Legacy accessor) Looking for token with alias %@, clientId %@, resource %@, legacy userId %@", alias, clientId, resource, MSID_PII_LOG_EMAIL(legacyUserId));
         
@@ -819,6 +839,7 @@
         if (cacheItem)
         {
             MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, context,@"(Legacy accessor) Found token");
+            if (indexKey) [_lookupIndex setObject:alias forKey:indexKey];
             MSIDBaseToken *token = [cacheItem tokenWithType:type];
             token.storageEnvironment = token.environment;
             token.environment = environment;
@@ -826,6 +847,8 @@
             return token;
         }
     }
+    
+    if (indexKey) [_lookupIndex removeObjectForKey:indexKey];
 
     if (type == MSIDRefreshTokenType)
     {
@@ -840,4 +863,38 @@
     return nil;
 }
 
+#pragma mark - Lookup index
+
+// Deliberately coarser than the cache key: the indexed alias is only a hint that is verified by a read,
+// and a key that ignores the authority and app identifier lets a save or remove invalidate exactly its entry.
+- (NSString *)lookupIndexKeyWithLegacyUserId:(NSString *)legacyUserId
+                                    clientId:(NSString *)clientId
+                                    resource:(NSString *)resource
+{
+    return [NSString stringWithFormat:@"%@|%@|%@", legacyUserId.lowercaseString ?: @"", clientId.lowercaseString ?: @"", resource.lowercaseString ?: @""];
+}
+
+- (void)invalidateLookupIndexWithLegacyUserId:(NSString *)legacyUserId
+                                     clientId:(NSString *)clientId
+                                     resource:(NSString *)resource
+{
+    [_lookupIndex removeObjectForKey:[self lookupIndexKeyWithLegacyUserId:legacyUserId clientId:clientId resource:resource]];
+}
+
+- (NSArray<NSURL *> *)orderedLookupAliases:(NSArray<NSURL *> *)aliases indexKey:(NSString *)indexKey
+{
+    NSURL *indexedAlias = indexKey ? [_lookupIndex objectForKey:indexKey] : nil;
+    
+    if (!indexedAlias || [aliases.firstObject isEqual:indexedAlias] || ![aliases containsObject:indexedAlias])
+    {
+        return aliases;
+    }
+    
+    // Try the alias the item was last found under first, then fall back to the regular order
+    NSMutableArray<NSURL *> *orderedAliases = [aliases mutableCopy];
+    [orderedAliases removeObject:indexedAlias];
+    [orderedAliases insertObject:indexedAlias atIndex:0];
+    return orderedAliases;
+}
+
 @end
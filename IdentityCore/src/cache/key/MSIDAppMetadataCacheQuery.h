@@ -29,6 +29,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, readonly) BOOL exactMatch;
 @property (nonatomic, nullable) NSArray<NSString *> *environmentAliases;
+// Lowercased environmentAliases, derived from them unless set explicitly. Setting environmentAliases resets it.
+@property (nonatomic, nullable) NSSet<NSString *> *environmentAliasSet;
 
 @end
 
@@ -51,4 +51,20 @@
     return self.clientId && self.environment;
 }
 
+- (void)setEnvironmentAliases:(NSArray<NSString *> *)environmentAliases
+{
+    _environmentAliases = environmentAliases;
+    _environmentAliasSet = nil;
+}
+
+- (NSSet<NSString *> *)environmentAliasSet
+{
+    if (!_environmentAliasSet && _environmentAliases)
+    {
+        _environmentAliasSet = [NSString msidLowercasedAliasSet:_environmentAliases];
+    }
+    
+    return _environmentAliasSet;
+}
+
 @end
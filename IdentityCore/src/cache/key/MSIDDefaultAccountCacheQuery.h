@@ -27,5 +27,7 @@
 
 @property (nonatomic, readonly) BOOL exactMatch;
 @property (nonatomic) NSArray<NSString *> *environmentAliases;
+// Lowercased environmentAliases, derived from them unless set explicitly. Setting environmentAliases resets it.
+@property (nonatomic) NSSet<NSString *> *environmentAliasSet;
 
 @end
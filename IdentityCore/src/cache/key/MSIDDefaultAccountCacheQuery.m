@@ -50,4 +50,20 @@
     return self.homeAccountId && self.environment && self.realm;
 }
 
+- (void)setEnvironmentAliases:(NSArray<NSString *> *)environmentAliases
+{
+    _environmentAliases = environmentAliases;
+    _environmentAliasSet = nil;
+}
+
+- (NSSet<NSString *> *)environmentAliasSet
+{
+    if (!_environmentAliasSet && _environmentAliases)
+    {
+        _environmentAliasSet = [NSString msidLowercasedAliasSet:_environmentAliases];
+    }
+    
+    return _environmentAliasSet;
+}
+
 @end
@@ -29,8 +29,44 @@
 #import "MSIDIntuneEnrollmentIdsCache.h"
 
 static NSString *keyDelimiter = @"-";
+static NSUInteger const MSIDInternedKeyComponentMaxLength = 256;
+
+// Trimmed, lowercased form of a key component. Environment, realm, client id and home account id repeat across
+// almost every key, so their normalized forms are interned rather than trimmed and lowercased for each key.
+static NSString *MSIDNormalizedKeyComponent(NSString *component)
+{
+    if (!component) return nil;
+    
+    if (component.length > MSIDInternedKeyComponentMaxLength) return component.msidTrimmedString.lowercaseString;
+    
+    static NSCache<NSString *, NSString *> *s_internedComponents = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        s_internedComponents = [NSCache new];
+        s_internedComponents.countLimit = 1024;
+    });
+    
+    NSString *normalized = [s_internedComponents objectForKey:component];
+    if (!normalized)
+    {
+        normalized = component.msidTrimmedString.lowercaseString;
+        [s_internedComponents setObject:normalized forKey:[component copy]];
+    }
+    
+    return normalized;
+}
+
+// Matches what "%@" produces for the component, including "(null)" for nil.
+static void MSIDAppendKeyComponent(NSMutableString *string, NSString *component)
+{
+    [string appendString:component ?: @"(null)"];
+}
 
 @implementation MSIDDefaultCredentialCacheKey
+{
+    // Memoized credential id shared by service and generic, see -invalidateDerivedKeyComponents.
+    NSString *_credentialId;
+}
 
 #pragma mark - Helpers
 
@@ -44,31 +80,42 @@ static NSString *keyDelimiter = @"-";
                     tokenType:(NSString *)tokenType
               requestedClaims:(NSString *)requestedClaims
 {
-    realm = realm.msidTrimmedString.lowercaseString;
-    clientId = clientId.msidTrimmedString.lowercaseString;
-    target = target.msidTrimmedString.lowercaseString;
-    applicationIdentifier = applicationIdentifier.msidTrimmedString.lowercaseString;
-    tokenType = tokenType.msidTrimmedString.lowercaseString;
-    requestedClaims = requestedClaims.msidTrimmedString.lowercaseString;
-
     NSString *credentialId = [self credentialIdWithType:type clientId:clientId realm:realm applicationIdentifier:applicationIdentifier];
-    NSString *service = [NSString stringWithFormat:@"%@%@%@%@%@",
-                         credentialId,
-                         keyDelimiter,
-                         (target ? target : @""),
-                         (tokenType ? keyDelimiter : @""),
-                         (tokenType ? tokenType : @"")];
+    return [self serviceWithCredentialId:credentialId target:target appKey:appKey tokenType:tokenType requestedClaims:requestedClaims];
+}
+
+- (NSString *)serviceWithCredentialId:(NSString *)credentialId
+                               target:(NSString *)target
+                               appKey:(NSString *)appKey
+                            tokenType:(NSString *)tokenType
+                      requestedClaims:(NSString *)requestedClaims
+{
+    target = target.msidTrimmedString.lowercaseString;
+    tokenType = MSIDNormalizedKeyComponent(tokenType);
+    
+    NSMutableString *service = [[NSMutableString alloc] initWithCapacity:credentialId.length + target.length + 32];
+    [service appendString:credentialId];
+    [service appendString:keyDelimiter];
+    if (target) [service appendString:target];
+    
+    if (tokenType)
+    {
+        [service appendString:keyDelimiter];
+        [service appendString:tokenType];
+    }
     
     if (![NSString msidIsStringNilOrBlank:appKey])
     {
-        service  = [NSString stringWithFormat:@"%@|%@", service, appKey];
+        [service appendString:@"|"];
+        [service appendString:appKey];
     }
-
+    
     if (![NSString msidIsStringNilOrBlank:requestedClaims])
     {
-        service  = [NSString stringWithFormat:@"%@|%@", service, requestedClaims.msidTokenHash];
+        [service appendString:@"|"];
+        [service appendString:requestedClaims.msidTrimmedString.lowercaseString.msidTokenHash];
     }
-
+    
     return service;
 }
 
@@ -78,29 +125,41 @@ static NSString *keyDelimiter = @"-";
                              realm:(NSString *)realm
              applicationIdentifier:(NSString *)applicationIdentifier
 {
-    realm = realm.msidTrimmedString.lowercaseString;
-    clientId = clientId.msidTrimmedString.lowercaseString;
-    applicationIdentifier = applicationIdentifier.msidTrimmedString.lowercaseString;
-
+    realm = MSIDNormalizedKeyComponent(realm);
+    clientId = MSIDNormalizedKeyComponent(clientId);
+    applicationIdentifier = MSIDNormalizedKeyComponent(applicationIdentifier);
+    
     NSString *credentialType = [MSIDCredentialTypeHelpers credentialTypeAsString:type].lowercaseString;
     
-    return [NSString stringWithFormat:@"%@%@%@%@%@%@%@",
-            credentialType, keyDelimiter, clientId,
-            keyDelimiter,
-            (realm ? realm : @""),
-            (applicationIdentifier ? keyDelimiter : @""),
-            (applicationIdentifier ? applicationIdentifier : @"")];
+    NSMutableString *credentialId = [[NSMutableString alloc] initWithCapacity:credentialType.length + clientId.length + realm.length + applicationIdentifier.length + 3];
+    MSIDAppendKeyComponent(credentialId, credentialType);
+    [credentialId appendString:keyDelimiter];
+    MSIDAppendKeyComponent(credentialId, clientId);
+    [credentialId appendString:keyDelimiter];
+    if (realm) [credentialId appendString:realm];
+    
+    if (applicationIdentifier)
+    {
+        [credentialId appendString:keyDelimiter];
+        [credentialId appendString:applicationIdentifier];
+    }
+    
+    return credentialId;
 }
 
 // kSecAttrAccount - account_id (<unique_id>-<environment>)
 - (NSString *)accountIdWithHomeAccountId:(NSString *)homeAccountId
                              environment:(NSString *)environment
 {
-    homeAccountId = homeAccountId.msidTrimmedString.lowercaseString;
-    environment = environment.msidTrimmedString.lowercaseString;
-
-    return [NSString stringWithFormat:@"%@%@%@",
-            homeAccountId, keyDelimiter, environment];
+    homeAccountId = MSIDNormalizedKeyComponent(homeAccountId);
+    environment = MSIDNormalizedKeyComponent(environment);
+    
+    NSMutableString *accountId = [[NSMutableString alloc] initWithCapacity:homeAccountId.length + environment.length + 1];
+    MSIDAppendKeyComponent(accountId, homeAccountId);
+    [accountId appendString:keyDelimiter];
+    MSIDAppendKeyComponent(accountId, environment);
+    
+    return accountId;
 }
 
 - (NSNumber *)credentialTypeNumber:(MSIDCredentialType)credentialType
@@ -128,10 +187,19 @@ static NSString *keyDelimiter = @"-";
     return self;
 }
 
+// account, service and generic are read several times per save and query, so they are computed once and kept
+// until one of the properties they depend on changes.
 - (NSData *)generic
 {
-    NSString *clientId = self.familyId ? self.familyId : self.clientId;
-    return [[self credentialIdWithType:self.credentialType clientId:clientId realm:self.realm applicationIdentifier:self.applicationIdentifier] dataUsingEncoding:NSUTF8StringEncoding];
+    @synchronized (self)
+    {
+        if (!_generic)
+        {
+            _generic = [[self credentialId] dataUsingEncoding:NSUTF8StringEncoding];
+        }
+        
+        return _generic;
+    }
 }
 
 - (NSNumber *)type
@@ -141,13 +209,51 @@ static NSString *keyDelimiter = @"-";
 
 - (NSString *)account
 {
-    return [self accountIdWithHomeAccountId:self.homeAccountId environment:self.environment];
+    @synchronized (self)
+    {
+        if (!_account)
+        {
+            _account = [self accountIdWithHomeAccountId:self.homeAccountId environment:self.environment];
+        }
+        
+        return _account;
+    }
 }
 
 - (NSString *)service
 {
-    NSString *clientId = self.familyId ? self.familyId : self.clientId;
-    return [self serviceWithType:self.credentialType clientID:clientId realm:self.realm applicationIdentifier:self.applicationIdentifier target:self.target appKey:self.appKey tokenType:self.tokenType requestedClaims:self.requestedClaims];
+    @synchronized (self)
+    {
+        if (!_service)
+        {
+            _service = [self serviceWithCredentialId:[self credentialId] target:self.target appKey:self.appKey tokenType:self.tokenType requestedClaims:self.requestedClaims];
+        }
+        
+        return _service;
+    }
+}
+
+// Must be called under @synchronized (self).
+- (NSString *)credentialId
+{
+    if (!_credentialId)
+    {
+        NSString *clientId = self.familyId ? self.familyId : self.clientId;
+        _credentialId = [self credentialIdWithType:self.credentialType clientId:clientId realm:self.realm applicationIdentifier:self.applicationIdentifier];
+    }
+    
+    return _credentialId;
+}
+
+- (void)invalidateDerivedKeyComponents
+{
+    @synchronized (self)
+    {
+        _account = nil;
+        _service = nil;
+        _generic = nil;
+        _credentialId = nil;
+    }
 }
 
 - (BOOL)isShared
@@ -155,6 +261,74 @@ static NSString *keyDelimiter = @"-";
     return self.credentialType == MSIDRefreshTokenType;
 }
 
+#pragma mark - Setters
+
+- (void)setHomeAccountId:(NSString *)homeAccountId
+{
+    _homeAccountId = homeAccountId;
+    [self invalidateDerivedKeyComponents];
+}
+
+- (void)setEnvironment:(NSString *)environment
+{
+    _environment = environment;
+    [self invalidateDerivedKeyComponents];
+}
+
+- (void)setRealm:(NSString *)realm
+{
+    _realm = realm;
+    [self invalidateDerivedKeyComponents];
+}
+
+- (void)setClientId:(NSString *)clientId
+{
+    _clientId = clientId;
+    [self invalidateDerivedKeyComponents];
+}
+
+- (void)setFamilyId:(NSString *)familyId
+{
+    _familyId = familyId;
+    [self invalidateDerivedKeyComponents];
+}
+
+- (void)setTarget:(NSString *)target
+{
+    _target = target;
+    [self invalidateDerivedKeyComponents];
+}
+
+- (void)setApplicationIdentifier:(NSString *)applicationIdentifier
+{
+    _applicationIdentifier = applicationIdentifier;
+    [self invalidateDerivedKeyComponents];
+}
+
+- (void)setCredentialType:(MSIDCredentialType)credentialType
+{
+    _credentialType = credentialType;
+    [self invalidateDerivedKeyComponents];
+}
+
+- (void)setTokenType:(NSString *)tokenType
+{
+    _tokenType = tokenType;
+    [self invalidateDerivedKeyComponents];
+}
+
+- (void)setRequestedClaims:(NSString *)requestedClaims
+{
+    _requestedClaims = requestedClaims;
+    [self invalidateDerivedKeyComponents];
+}
+
+- (void)setAppKey:(NSString *)appKey
+{
+    [super setAppKey:appKey];
+    [self invalidateDerivedKeyComponents];
+}
+
 #pragma mark - Broker
 
 - (NSNumber *)appKeyHash
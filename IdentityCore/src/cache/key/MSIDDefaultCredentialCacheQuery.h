@@ -40,5 +40,7 @@ typedef NS_ENUM(NSUInteger, MSIDComparisonOptions) {
 @property (nonatomic) BOOL matchAnyCredentialType;
 @property (nonatomic, readonly) BOOL exactMatch;
 @property (nonatomic) NSArray<NSString *> *environmentAliases;
+// Lowercased environmentAliases, derived from them unless set explicitly. Setting environmentAliases resets it.
+@property (nonatomic) NSSet<NSString *> *environmentAliasSet;
 
 @end
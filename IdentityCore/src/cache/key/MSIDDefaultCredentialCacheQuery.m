@@ -186,4 +186,20 @@
     return nil;
 }
 
+- (void)setEnvironmentAliases:(NSArray<NSString *> *)environmentAliases
+{
+    _environmentAliases = environmentAliases;
+    _environmentAliasSet = nil;
+}
+
+- (NSSet<NSString *> *)environmentAliasSet
+{
+    if (!_environmentAliasSet && _environmentAliases)
+    {
+        _environmentAliasSet = [NSString msidLowercasedAliasSet:_environmentAliases];
+    }
+    
+    return _environmentAliasSet;
+}
+
 @end
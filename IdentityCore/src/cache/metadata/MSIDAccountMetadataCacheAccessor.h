@@ -58,12 +58,37 @@
                                                 context:(id<MSIDRequestContext>)context
                                                   error:(NSError *__autoreleasing*)error;
 
+/*!
+ Sign-in states for several accounts of one client, answered from a single lookup of the client's account metadata.
+ Accounts without metadata are left out of the result, i.e. their state is MSIDAccountMetadataStateUnknown.
+ */
+- (NSDictionary<NSString *, NSNumber *> *)signInStatesForHomeAccountIds:(NSSet<NSString *> *)homeAccountIds
+                                                                clientId:(NSString *)clientId
+                                                                 context:(id<MSIDRequestContext>)context
+                                                                   error:(NSError *__autoreleasing*)error;
+
+- (BOOL)updateSignInStateForHomeAccountId:(NSString *)homeAccountId
+                                 clientId:(NSString *)clientId
+                                    state:(MSIDAccountMetadataState)state
+                                  context:(id<MSIDRequestContext>)context
+                                    error:(NSError *__autoreleasing*)error;
+
+/*!
+ Same as above, and records that the account got tokens from source in the same write.
+ Pass MSIDAccountMetadataSourceUnknown to leave the recorded source unchanged.
+ */
 - (BOOL)updateSignInStateForHomeAccountId:(NSString *)homeAccountId
                                  clientId:(NSString *)clientId
                                     state:(MSIDAccountMetadataState)state
+                                   source:(MSIDAccountMetadataSource)source
                                   context:(id<MSIDRequestContext>)context
                                     error:(NSError *__autoreleasing*)error;
 
+- (MSIDAccountMetadataSource)sourceForHomeAccountId:(NSString *)homeAccountId
+                                           clientId:(NSString *)clientId
+                                            context:(id<MSIDRequestContext>)context
+                                              error:(NSError *__autoreleasing*)error;
+
 - (MSIDAccountIdentifier *)principalAccountIdForClientId:(NSString *)clientId
                                                  context:(id<MSIDRequestContext>)context
                                                    error:(NSError *__autoreleasing*)error;
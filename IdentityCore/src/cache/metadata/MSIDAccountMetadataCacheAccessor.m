@@ -147,7 +147,8 @@
     }
     
     NSError *localError;
-    MSIDAccountMetadataCacheItem *cacheItem = [self retrieveAccountMetadataCacheItemForClientId:clientId skipCache:YES context:context error:&localError];
+    MSIDAccountMetadataCacheKey *key = [[MSIDAccountMetadataCacheKey alloc] initWithClientId:clientId];
+    MSIDAccountMetadataCacheItem *cacheItem = [_metadataCache currentAccountMetadataCacheItemWithKey:key context:context error:&localError];
     if (localError)
     {
         if (error) *error = localError;
@@ -160,9 +161,85 @@
     return accountMetadata.signInState;
 }
 
+- (MSIDAccountMetadataSource)sourceForHomeAccountId:(NSString *)homeAccountId
+                                           clientId:(NSString *)clientId
+                                            context:(id<MSIDRequestContext>)context
+                                              error:(NSError *__autoreleasing*)error
+{
+    if ([NSString msidIsStringNilOrBlank:homeAccountId]
+        || [NSString msidIsStringNilOrBlank:clientId])
+    {
+        if (error) *error = MSIDCreateError(MSIDErrorDomain, MSIDErrorInvalidInternalParameter, @"Both homeAccountId and clientId are needed to query account source!", nil, nil, nil, nil, nil, YES);
+        return MSIDAccountMetadataSourceUnknown;
+    }
+    
+    NSError *localError;
+    MSIDAccountMetadataCacheKey *key = [[MSIDAccountMetadataCacheKey alloc] initWithClientId:clientId];
+    MSIDAccountMetadataCacheItem *cacheItem = [_metadataCache currentAccountMetadataCacheItemWithKey:key context:context error:&localError];
+    if (localError)
+    {
+        if (error) *error = localError;
+        return MSIDAccountMetadataSourceUnknown;
+    }
+    
+    MSIDAccountMetadata *accountMetadata = [cacheItem accountMetadataForHomeAccountId:homeAccountId];
+    if (!accountMetadata || accountMetadata.signInState == MSIDAccountMetadataStateSignedOut) return MSIDAccountMetadataSourceUnknown;
+    
+    return accountMetadata.source;
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)signInStatesForHomeAccountIds:(NSSet<NSString *> *)homeAccountIds
+                                                                clientId:(NSString *)clientId
+                                                                 context:(id<MSIDRequestContext>)context
+                                                                   error:(NSError *__autoreleasing*)error
+{
+    if ([NSString msidIsStringNilOrBlank:clientId])
+    {
+        if (error) *error = MSIDCreateError(MSIDErrorDomain, MSIDErrorInvalidInternalParameter, @"ClientId is needed to query signed out state!", nil, nil, nil, nil, nil, YES);
+        return nil;
+    }
+    
+    if (!homeAccountIds.count) return @{};
+    
+    NSError *localError;
+    MSIDAccountMetadataCacheKey *key = [[MSIDAccountMetadataCacheKey alloc] initWithClientId:clientId];
+    MSIDAccountMetadataCacheItem *cacheItem = [_metadataCache currentAccountMetadataCacheItemWithKey:key context:context error:&localError];
+    if (localError)
+    {
+        if (error) *error = localError;
+        return nil;
+    }
+    
+    NSMutableDictionary<NSString *, NSNumber *> *signInStates = [NSMutableDictionary new];
+    for (NSString *homeAccountId in homeAccountIds)
+    {
+        MSIDAccountMetadata *accountMetadata = [cacheItem accountMetadataForHomeAccountId:homeAccountId];
+        if (!accountMetadata) continue;
+        
+        signInStates[homeAccountId] = @(accountMetadata.signInState);
+    }
+    
+    return signInStates;
+}
+
+- (BOOL)updateSignInStateForHomeAccountId:(NSString *)homeAccountId
+                                 clientId:(NSString *)clientId
+                                    state:(MSIDAccountMetadataState)state
+                                  context:(id<MSIDRequestContext>)context
+                                    error:(NSError *__autoreleasing*)error
+{
+    return [self updateSignInStateForHomeAccountId:homeAccountId
+                                          clientId:clientId
+                                             state:state
+                                            source:MSIDAccountMetadataSourceUnknown
+                                           context:context
+                                             error:error];
+}
+
 - (BOOL)updateSignInStateForHomeAccountId:(NSString *)homeAccountId
                                  clientId:(NSString *)clientId
                                     state:(MSIDAccountMetadataState)state
+                                   source:(MSIDAccountMetadataSource)source
                                   context:(id<MSIDRequestContext>)context
                                     error:(NSError *__autoreleasing*)error
 {
@@ -198,6 +275,7 @@
     }
     
     [accountMetadata updateSignInState:state];
+    [accountMetadata updateSource:source];
     
     if (![cacheItem addAccountMetadata:accountMetadata forHomeAccountId:homeAccountId error:error])
     {
@@ -34,6 +34,8 @@
 
 - (instancetype)initWithPersistentDataSource:(id<MSIDMetadataCacheDataSource>)dataSource;
 
+// Saves are synchronous. Saves for the same key that arrive while a write is in progress are coalesced into
+// one follow-up write of the latest item, and every coalesced caller gets that write's result.
 - (BOOL)saveAccountMetadataCacheItem:(MSIDAccountMetadataCacheItem *)item
                                  key:(MSIDCacheKey *)key
                              context:(id<MSIDRequestContext>)context
@@ -52,6 +54,12 @@
                                                           context:(id<MSIDRequestContext>)context
                                                             error:(NSError *__autoreleasing*)error;
 
+// Returns the persisted item, reusing the in-memory copy when the data source reports the item has not been
+// modified since that copy was read. Reads the persistent store every time if the data source can't report it.
+- (MSIDAccountMetadataCacheItem *)currentAccountMetadataCacheItemWithKey:(MSIDCacheKey *)key
+                                                                 context:(id<MSIDRequestContext>)context
+                                                                   error:(NSError *__autoreleasing*)error;
+
 - (NSArray<MSIDAccountMetadataCacheItem *> *)allAccountMetadataCacheItemsWithContext:(id<MSIDRequestContext>)context
                                                                                error:(NSError *__autoreleasing*)error;
 
@@ -31,11 +31,58 @@
 #import "MSIDAccountMetadataCacheItem.h"
 #import "NSDictionary+MSIDExtensions.h"
 
+// A storage read shared by every caller that misses the memory cache for the same key while it is in flight.
+@interface MSIDMetadataCacheLoad : NSObject
+
+@property (nonatomic, readonly) dispatch_group_t group;
+@property (nonatomic) MSIDAccountMetadataCacheItem *item;
+@property (nonatomic) NSError *error;
+
+@end
+
+@implementation MSIDMetadataCacheLoad
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _group = dispatch_group_create();
+        dispatch_group_enter(_group);
+    }
+    return self;
+}
+
+@end
+
+// A storage write that saves issued for the same key before it starts are coalesced into; only the latest item is written.
+@interface MSIDMetadataCacheWrite : NSObject
+
+@property (nonatomic) MSIDAccountMetadataCacheItem *item;
+@property (nonatomic) BOOL completed;
+@property (nonatomic) BOOL success;
+@property (nonatomic) NSError *error;
+
+@end
+
+@implementation MSIDMetadataCacheWrite
+@end
+
 @implementation MSIDMetadataCache
 {
+    // Memory state below is only accessed on _synchronizationQueue, which never waits for storage I/O.
     NSMutableDictionary *_memoryCache;
+    NSMutableDictionary<MSIDCacheKey *, NSDate *> *_modificationDates;
+    // Write version of each key, bumped by every save and removal. Storage reads only install their result in memory
+    // if the key's version didn't change while they were reading, so a slow read can't overwrite a newer save.
+    NSMutableDictionary<MSIDCacheKey *, NSNumber *> *_keyVersions;
+    NSUInteger _writeVersion;
+    NSMutableDictionary<MSIDCacheKey *, MSIDMetadataCacheLoad *> *_inflightLoads;
+    NSMutableDictionary<MSIDCacheKey *, MSIDMetadataCacheWrite *> *_pendingWrites;
     id<MSIDMetadataCacheDataSource> _dataSource;
     dispatch_queue_t _synchronizationQueue;
+    // Serializes storage writes and removals so they reach the data source in order.
+    dispatch_queue_t _storageWriteQueue;
     MSIDCacheItemJsonSerializer *_jsonSerializer;
 }
 
@@ -48,9 +95,15 @@
     if (self)
     {
         _memoryCache = [NSMutableDictionary new];
+        _modificationDates = [NSMutableDictionary new];
+        _keyVersions = [NSMutableDictionary new];
+        _inflightLoads = [NSMutableDictionary new];
+        _pendingWrites = [NSMutableDictionary new];
         _dataSource = dataSource;
         NSString *queueName = [NSString stringWithFormat:@"com.microsoft.msidmetadatacache-%@", [NSUUID UUID].UUIDString];
         _synchronizationQueue = dispatch_queue_create([queueName cStringUsingEncoding:NSASCIIStringEncoding], DISPATCH_QUEUE_SERIAL);
+        NSString *writeQueueName = [NSString stringWithFormat:@"com.microsoft.msidmetadatacache.write-%@", [NSUUID UUID].UUIDString];
+        _storageWriteQueue = dispatch_queue_create([writeQueueName cStringUsingEncoding:NSASCIIStringEncoding], DISPATCH_QUEUE_SERIAL);
         _jsonSerializer = [MSIDCacheItemJsonSerializer new];
     }
     
@@ -74,12 +127,21 @@
         return NO;
     }
     
-    __block NSError *localError;
-    __block BOOL saveSuccess = NO;
     __block BOOL hasChanges = YES;
+    __block MSIDMetadataCacheWrite *write = nil;
     
     dispatch_sync(_synchronizationQueue, ^{
-        hasChanges = ![item isEqual:_memoryCache[key]];
+        hasChanges = ![item isEqual:self->_memoryCache[key]];
+        if (!hasChanges) return;
+        
+        // Join the write that hasn't started yet for this key, if any, so that a burst of saves results in one storage write
+        write = self->_pendingWrites[key];
+        if (!write)
+        {
+            write = [MSIDMetadataCacheWrite new];
+            self->_pendingWrites[key] = write;
+        }
+        write.item = item;
     });
     
     if (!hasChanges)
@@ -87,16 +149,41 @@
         return YES;
     }
     
-    dispatch_barrier_sync(_synchronizationQueue, ^{
-        saveSuccess = [_dataSource saveAccountMetadata:item key:key serializer:_jsonSerializer context:context error:&localError];
-        if (saveSuccess)
-        {
-            _memoryCache[key] = item;
-        }
+    dispatch_sync(_storageWriteQueue, ^{
+        // An earlier save for the same key already wrote the coalesced item
+        if (write.completed) return;
+        
+        __block MSIDAccountMetadataCacheItem *itemToSave = nil;
+        dispatch_sync(self->_synchronizationQueue, ^{
+            if (self->_pendingWrites[key] == write) [self->_pendingWrites removeObjectForKey:key];
+            itemToSave = write.item;
+        });
+        
+        NSError *localError;
+        BOOL saveSuccess = [self->_dataSource saveAccountMetadata:itemToSave key:key serializer:self->_jsonSerializer context:context error:&localError];
+        
+        dispatch_sync(self->_synchronizationQueue, ^{
+            [self bumpVersionForKey:key];
+            [self->_modificationDates removeObjectForKey:key];
+            
+            if (saveSuccess)
+            {
+                self->_memoryCache[key] = itemToSave;
+            }
+            else
+            {
+                // The persisted state is unknown after a failed write, read it again next time
+                [self->_memoryCache removeObjectForKey:key];
+            }
+        });
+        
+        write.success = saveSuccess;
+        write.error = localError;
+        write.completed = YES;
     });
     
-    if (error && localError) *error = localError;
-    return saveSuccess;
+    if (error && write.error) *error = write.error;
+    return write.success;
 }
 
 - (MSIDAccountMetadataCacheItem *)accountMetadataCacheItemWithKey:(MSIDCacheKey *)key
@@ -120,39 +207,105 @@
         MSID_LOG_WITH_CTX(MSIDLogLevelError, context, @"Get account metadata with invalid key.");
         return nil;
     }
+    
+    if (skipCache)
+    {
+        // The caller wants the persisted state as of now, so it can't join a read that started earlier
+        return [[self loadItemWithKey:key context:context error:error] copy];
+    }
 
     __block MSIDAccountMetadataCacheItem *item;
-    __block NSError *localError;
-    __block BOOL updatedItem = NO;
+    __block MSIDMetadataCacheLoad *load;
+    __block BOOL isLoader = NO;
 
     dispatch_sync(_synchronizationQueue, ^{
+        item = self->_memoryCache[key];
+        if (item) return;
         
-        if (!skipCache)
-        {
-            item = _memoryCache[key];
-        }
-        
-        if (!item)
+        load = self->_inflightLoads[key];
+        if (!load)
         {
-            item = [_dataSource accountMetadataWithKey:key serializer:_jsonSerializer context:context error:&localError];
-            updatedItem = item != nil;
+            load = [MSIDMetadataCacheLoad new];
+            self->_inflightLoads[key] = load;
+            isLoader = YES;
         }
     });
     
-    if (error && localError) *error = localError;
+    // return a copy because we don't want external change on the cache status
+    if (item) return [item copy];
     
-    if (!updatedItem)
+    if (isLoader)
+    {
+        NSError *localError;
+        load.item = [self loadItemWithKey:key context:context error:&localError];
+        load.error = localError;
+        
+        dispatch_sync(_synchronizationQueue, ^{
+            [self->_inflightLoads removeObjectForKey:key];
+        });
+        dispatch_group_leave(load.group);
+    }
+    else
     {
-        // return a copy because we don't want external change on the cache status
-        return [item copy];
+        dispatch_group_wait(load.group, DISPATCH_TIME_FOREVER);
     }
     
-    dispatch_barrier_async(_synchronizationQueue, ^{
-        self->_memoryCache[key] = item;
+    if (error && load.error) *error = load.error;
+    
+    // return a copy because we don't want external change on the cache status
+    return [load.item copy];
+}
+
+- (MSIDAccountMetadataCacheItem *)currentAccountMetadataCacheItemWithKey:(MSIDCacheKey *)key
+                                                                 context:(id<MSIDRequestContext>)context
+                                                                   error:(NSError *__autoreleasing*)error
+{
+    if (!key || ![_dataSource respondsToSelector:@selector(accountMetadataModificationDateWithKey:context:error:)])
+    {
+        return [self accountMetadataCacheItemWithKey:key skipCache:YES context:context error:error];
+    }
+    
+    __block NSUInteger version = 0;
+    dispatch_sync(_synchronizationQueue, ^{
+        version = [self versionForKey:key];
+    });
+    
+    NSError *localError;
+    NSDate *modificationDate = [_dataSource accountMetadataModificationDateWithKey:key context:context error:&localError];
+    if (localError)
+    {
+        if (error) *error = localError;
+        return nil;
+    }
+    
+    if (!modificationDate) return nil;
+    
+    __block MSIDAccountMetadataCacheItem *item;
+    dispatch_sync(_synchronizationQueue, ^{
+        if ([self->_modificationDates[key] isEqualToDate:modificationDate])
+        {
+            item = self->_memoryCache[key];
+        }
     });
     
     // return a copy because we don't want external change on the cache status
-    return [item copy];
+    if (item) return [item copy];
+    
+    item = [self accountMetadataCacheItemWithKey:key skipCache:YES context:context error:error];
+    
+    // Keychain modification dates can have whole second resolution. A write in the same second as the one we
+    // just read could keep the same date, so only remember dates old enough that any later write must differ.
+    if (item && -[modificationDate timeIntervalSinceNow] >= 1)
+    {
+        dispatch_sync(_synchronizationQueue, ^{
+            if ([self versionForKey:key] == version)
+            {
+                self->_modificationDates[key] = modificationDate;
+            }
+        });
+    }
+    
+    return item;
 }
 
 - (NSArray<MSIDAccountMetadataCacheItem *> *)allAccountMetadataCacheItemsWithContext:(id<MSIDRequestContext>)context
@@ -160,23 +313,29 @@
 {
     MSIDAccountMetadataCacheKey *key = [[MSIDAccountMetadataCacheKey alloc] initWithClientId:nil];
 
-    __block NSArray *items;
-    __block NSError *localError;
-
+    __block NSUInteger writeVersion = 0;
     dispatch_sync(_synchronizationQueue, ^{
-        items = [_dataSource accountsMetadataWithKey:key serializer:_jsonSerializer context:context error:&localError];
+        writeVersion = self->_writeVersion;
     });
     
+    NSError *localError;
+    NSArray *items = [_dataSource accountsMetadataWithKey:key serializer:_jsonSerializer context:context error:&localError];
+    
     if (!localError)
     {
-        dispatch_barrier_sync(_synchronizationQueue, ^{
-            // update memory cache
-            _memoryCache = [NSMutableDictionary new];
-            for (MSIDAccountMetadataCacheItem *item in items)
+        NSMutableDictionary *memoryCache = [NSMutableDictionary new];
+        for (MSIDAccountMetadataCacheItem *item in items)
+        {
+            MSIDAccountMetadataCacheKey *itemKey = [[MSIDAccountMetadataCacheKey alloc] initWithClientId:item.clientId];
+            // save a copy in memory cache to avoid external change
+            memoryCache[itemKey] = [item copy];
+        }
+        
+        dispatch_sync(_synchronizationQueue, ^{
+            // Skip updating memory cache if anything was written while reading, the items might already be stale
+            if (self->_writeVersion == writeVersion)
             {
-                MSIDAccountMetadataCacheKey *itemKey = [[MSIDAccountMetadataCacheKey alloc] initWithClientId:item.clientId];
-                // save a copy in memory cache to avoid external change
-                _memoryCache[itemKey] = [item copy];
+                self->_memoryCache = memoryCache;
             }
         });
     }
@@ -207,13 +366,68 @@
     __block BOOL success = NO;
     __block NSError *localError;
     
-    dispatch_barrier_sync(_synchronizationQueue, ^{
-        [_memoryCache removeObjectForKey:key];
-        success = [_dataSource removeAccountMetadataForKey:key context:context error:&localError];
+    dispatch_sync(_storageWriteQueue, ^{
+        dispatch_sync(self->_synchronizationQueue, ^{
+            [self bumpVersionForKey:key];
+            [self->_memoryCache removeObjectForKey:key];
+            [self->_modificationDates removeObjectForKey:key];
+        });
+        
+        success = [self->_dataSource removeAccountMetadataForKey:key context:context error:&localError];
+        
+        // A load that started before the removal finished may have read the old item, so invalidate it again
+        dispatch_sync(self->_synchronizationQueue, ^{
+            [self bumpVersionForKey:key];
+            [self->_memoryCache removeObjectForKey:key];
+            [self->_modificationDates removeObjectForKey:key];
+        });
     });
     
     if (error && localError) *error = localError;
     return success;
 }
 
+#pragma mark - Private
+
+// Reads the item from storage outside the synchronization queue and installs it in memory unless a write raced the read
+- (MSIDAccountMetadataCacheItem *)loadItemWithKey:(MSIDCacheKey *)key
+                                          context:(id<MSIDRequestContext>)context
+                                            error:(NSError *__autoreleasing*)error
+{
+    __block NSUInteger version = 0;
+    dispatch_sync(_synchronizationQueue, ^{
+        version = [self versionForKey:key];
+    });
+    
+    NSError *localError;
+    MSIDAccountMetadataCacheItem *item = [_dataSource accountMetadataWithKey:key serializer:_jsonSerializer context:context error:&localError];
+    
+    if (error && localError) *error = localError;
+    
+    if (item)
+    {
+        dispatch_sync(_synchronizationQueue, ^{
+            if ([self versionForKey:key] == version)
+            {
+                self->_memoryCache[key] = item;
+            }
+        });
+    }
+    
+    return item;
+}
+
+// Must be called on the synchronization queue
+- (NSUInteger)versionForKey:(MSIDCacheKey *)key
+{
+    return [_keyVersions[key] unsignedIntegerValue];
+}
+
+// Must be called on the synchronization queue
+- (void)bumpVersionForKey:(MSIDCacheKey *)key
+{
+    _writeVersion++;
+    _keyVersions[key] = @(_writeVersion);
+}
+
 @end
@@ -64,4 +64,12 @@
                            context:(id<MSIDRequestContext>)context
                              error:(NSError *__autoreleasing*)error;
 
+@optional
+
+// Modification date of the persisted account metadata item, nil if there is none.
+// Lets callers check a copy they hold is still current without reading and deserializing the item.
+- (NSDate *)accountMetadataModificationDateWithKey:(MSIDCacheKey *)key
+                                           context:(id<MSIDRequestContext>)context
+                                             error:(NSError *__autoreleasing*)error;
+
 @end
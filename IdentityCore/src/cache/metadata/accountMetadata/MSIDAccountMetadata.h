@@ -31,6 +31,18 @@ typedef NS_ENUM(NSInteger, MSIDAccountMetadataState)
     MSIDAccountMetadataStateSignedOut
 };
 
+// Where the tokens of an account came from.
+typedef NS_ENUM(NSInteger, MSIDAccountMetadataSource)
+{
+    MSIDAccountMetadataSourceUnknown = 0,
+    // Token responses received by this app from the identity provider.
+    MSIDAccountMetadataSourceLocal,
+    // Token responses received from the broker (SSO extension, Xpc or legacy broker).
+    MSIDAccountMetadataSourceBroker,
+    // Both of the above.
+    MSIDAccountMetadataSourceMixed
+};
+
 @interface MSIDAccountMetadata : NSObject <MSIDJsonSerializable, NSCopying>
 
 @property (nonatomic, readonly) NSString *homeAccountId;
@@ -38,6 +50,7 @@ typedef NS_ENUM(NSInteger, MSIDAccountMetadataState)
 @property (nonatomic, readonly) NSDictionary *auhtorityMap;
 
 @property (nonatomic, readonly) MSIDAccountMetadataState signInState;
+@property (nonatomic, readonly) MSIDAccountMetadataSource source;
 
 + (instancetype)new NS_UNAVAILABLE;
 - (instancetype)init NS_UNAVAILABLE;
@@ -55,4 +68,7 @@ typedef NS_ENUM(NSInteger, MSIDAccountMetadataState)
 // Update sign in state
 - (void)updateSignInState:(MSIDAccountMetadataState)state;
 
+// Record that tokens were received from source. An account seen from more than one source becomes MSIDAccountMetadataSourceMixed.
+- (void)updateSource:(MSIDAccountMetadataSource)source;
+
 @end
@@ -104,10 +104,19 @@ static const NSString *AccountMetadataURLMapKey = @"URLMap";
     if (state == MSIDAccountMetadataStateSignedOut)
     {
         _auhtorityMap = [NSMutableDictionary new];
+        _source = MSIDAccountMetadataSourceUnknown;
     }
     
 }
 
+#pragma mark - Source
+- (void)updateSource:(MSIDAccountMetadataSource)source
+{
+    if (source == MSIDAccountMetadataSourceUnknown || source == _source) return;
+    
+    _source = _source == MSIDAccountMetadataSourceUnknown ? source : MSIDAccountMetadataSourceMixed;
+}
+
 - (instancetype)initWithJSONDictionary:(NSDictionary *)json
                                  error:(__unused NSError * __autoreleasing *)error
 {
@@ -126,6 +135,7 @@ static const NSString *AccountMetadataURLMapKey = @"URLMap";
     _homeAccountId = [json msidStringObjectForKey:MSID_HOME_ACCOUNT_ID_CACHE_KEY];
     _auhtorityMap = [[json msidObjectForKey:MSID_AUTHORITY_MAP_CACHE_KEY ofClass:NSDictionary.class] mutableDeepCopy];
     _signInState = [self accountMetadataStateEnumFromString:[json msidStringObjectForKey:MSID_SIGN_IN_STATE_CACHE_KEY]];
+    _source = [self accountMetadataSourceEnumFromString:[json msidStringObjectForKey:MSID_ACCOUNT_SOURCE_CACHE_KEY]];
     
     return self;
 }
@@ -138,6 +148,7 @@ static const NSString *AccountMetadataURLMapKey = @"URLMap";
     dictionary[MSID_HOME_ACCOUNT_ID_CACHE_KEY] = self.homeAccountId;
     dictionary[MSID_AUTHORITY_MAP_CACHE_KEY] = self.auhtorityMap;
     dictionary[MSID_SIGN_IN_STATE_CACHE_KEY] = [self accountMetadataStateStringFromEnum:self.signInState];
+    dictionary[MSID_ACCOUNT_SOURCE_CACHE_KEY] = [self accountMetadataSourceStringFromEnum:self.source];
     
     return dictionary;
 }
@@ -185,6 +196,30 @@ static const NSString *AccountMetadataURLMapKey = @"URLMap";
     return MSIDAccountMetadataStateUnknown;
 }
 
+- (NSString *)accountMetadataSourceStringFromEnum:(MSIDAccountMetadataSource)source
+{
+    switch (source) {
+        case MSIDAccountMetadataSourceLocal:
+            return @"local";
+        case MSIDAccountMetadataSourceBroker:
+            return @"broker";
+        case MSIDAccountMetadataSourceMixed:
+            return @"mixed";
+        default:
+            // Not written, so that metadata without a source reads the same as before.
+            return nil;
+    }
+}
+
+- (MSIDAccountMetadataSource)accountMetadataSourceEnumFromString:(NSString *)sourceString
+{
+    if ([sourceString isEqualToString:@"local"])  return MSIDAccountMetadataSourceLocal;
+    if ([sourceString isEqualToString:@"broker"]) return MSIDAccountMetadataSourceBroker;
+    if ([sourceString isEqualToString:@"mixed"])  return MSIDAccountMetadataSourceMixed;
+    
+    return MSIDAccountMetadataSourceUnknown;
+}
+
 #pragma mark - Equal
 
 - (BOOL)isEqual:(id)object
@@ -209,6 +244,7 @@ static const NSString *AccountMetadataURLMapKey = @"URLMap";
     result &= (!self.homeAccountId && !item.homeAccountId) || [self.homeAccountId isEqualToString:item.homeAccountId];
     result &= ([self.auhtorityMap isEqualToDictionary:item->_auhtorityMap]);
     result &= (self.signInState == item.signInState);
+    result &= (self.source == item.source);
     
     return result;
 }
@@ -222,6 +258,7 @@ static const NSString *AccountMetadataURLMapKey = @"URLMap";
     hash = hash * 31 + self.homeAccountId.hash;
     hash = hash * 31 + self.auhtorityMap.hash;
     hash = hash * 31 + @(self.signInState).hash;
+    hash = hash * 31 + @(self.source).hash;
     
     return hash;
 }
@@ -235,6 +272,7 @@ static const NSString *AccountMetadataURLMapKey = @"URLMap";
     item->_clientId = [self.clientId copyWithZone:zone];
     item->_auhtorityMap = [self->_auhtorityMap mutableDeepCopy];
     item->_signInState = self.signInState;
+    item->_source = self.source;
     
     return item;
 }
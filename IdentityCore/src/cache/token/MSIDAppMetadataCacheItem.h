@@ -38,6 +38,11 @@ NS_ASSUME_NONNULL_BEGIN
                 environment:(nullable NSString *)environment
          environmentAliases:(nullable NSArray<NSString *> *)environmentAliases;
 
+// Same as above with aliases lowercased by msidLowercasedAliasSet:, environment checks are a set lookup.
+- (BOOL)matchesWithClientId:(nullable NSString *)clientId
+                environment:(nullable NSString *)environment
+        environmentAliasSet:(nullable NSSet<NSString *> *)environmentAliasSet;
+
 @end
 
 NS_ASSUME_NONNULL_END
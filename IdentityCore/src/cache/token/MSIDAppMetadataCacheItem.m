@@ -122,24 +122,33 @@
 - (BOOL)matchesWithClientId:(nullable NSString *)clientId
                 environment:(nullable NSString *)environment
          environmentAliases:(nullable NSArray<NSString *> *)environmentAliases
+{
+    return [self matchesWithClientId:clientId
+                         environment:environment
+                 environmentAliasSet:[NSString msidLowercasedAliasSet:environmentAliases]];
+}
+
+- (BOOL)matchesWithClientId:(nullable NSString *)clientId
+                environment:(nullable NSString *)environment
+        environmentAliasSet:(nullable NSSet<NSString *> *)environmentAliasSet
 {
     if (clientId && ![self.clientId isEqualToString:clientId])
     {
         return NO;
     }
     
-    return [self matchByEnvironment:environment environmentAliases:environmentAliases];
+    return [self matchByEnvironment:environment environmentAliasSet:environmentAliasSet];
 }
 
 - (BOOL)matchByEnvironment:(nullable NSString *)environment
-        environmentAliases:(nullable NSArray<NSString *> *)environmentAliases
+       environmentAliasSet:(nullable NSSet<NSString *> *)environmentAliasSet
 {
     if (environment && ![self.environment isEqualToString:environment])
     {
         return NO;
     }
     
-    if ([environmentAliases count] && ![self.environment msidIsEquivalentWithAnyAlias:environmentAliases])
+    if ([environmentAliasSet count] && ![self.environment msidIsEquivalentWithAnyAliasInSet:environmentAliasSet])
     {
         return NO;
     }
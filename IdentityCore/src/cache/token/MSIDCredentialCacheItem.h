@@ -98,6 +98,11 @@
                      environment:(nullable NSString *)environment
               environmentAliases:(nullable NSArray<NSString *> *)environmentAliases;
 
+// Same as above with aliases lowercased by msidLowercasedAliasSet:, environment checks are a set lookup.
+- (BOOL)matchesWithHomeAccountId:(nullable NSString *)homeAccountId
+                     environment:(nullable NSString *)environment
+             environmentAliasSet:(nullable NSSet<NSString *> *)environmentAliasSet;
+
 - (BOOL)matchesWithRealm:(nullable NSString *)realm
                 clientId:(nullable NSString *)clientId
                 familyId:(nullable NSString *)familyId
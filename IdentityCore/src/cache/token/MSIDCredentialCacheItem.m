@@ -290,6 +290,15 @@
 - (BOOL)matchesWithHomeAccountId:(nullable NSString *)homeAccountId
                      environment:(nullable NSString *)environment
               environmentAliases:(nullable NSArray<NSString *> *)environmentAliases
+{
+    return [self matchesWithHomeAccountId:homeAccountId
+                              environment:environment
+                      environmentAliasSet:[NSString msidLowercasedAliasSet:environmentAliases]];
+}
+
+- (BOOL)matchesWithHomeAccountId:(nullable NSString *)homeAccountId
+                     environment:(nullable NSString *)environment
+             environmentAliasSet:(nullable NSSet<NSString *> *)environmentAliasSet
 {
     if (homeAccountId && 
         ![self.homeAccountId.msidNormalizedString isEqualToString:homeAccountId.msidNormalizedString])
@@ -298,11 +307,11 @@
         return NO;
     }
 
-    return [self matchByEnvironment:environment environmentAliases:environmentAliases];
+    return [self matchByEnvironment:environment environmentAliasSet:environmentAliasSet];
 }
 
 - (BOOL)matchByEnvironment:(nullable NSString *)environment
-        environmentAliases:(nullable NSArray<NSString *> *)environmentAliases
+       environmentAliasSet:(nullable NSSet<NSString *> *)environmentAliasSet
 {
     if (environment && 
         ![self.environment.msidNormalizedString isEqualToString:environment.msidNormalizedString])
@@ -311,8 +320,8 @@
         return NO;
     }
 
-    if ([environmentAliases count] && 
-        ![self.environment.msidNormalizedString msidIsEquivalentWithAnyAlias:environmentAliases])
+    if ([environmentAliasSet count] && 
+        ![self.environment.msidNormalizedString msidIsEquivalentWithAnyAliasInSet:environmentAliasSet])
     {
         MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, nil, @"(%@) cached item did not have a valid environment that matches with any of the environment aliases.", NSStringFromClass(self.class));
         return NO;
@@ -31,6 +31,11 @@ NS_ASSUME_NONNULL_BEGIN
                      environment:(nullable NSString *)environment
               environmentAliases:(nullable NSArray<NSString *> *)environmentAliases;
 
+// Same as above with aliases lowercased by msidLowercasedAliasSet:, environment checks are a set lookup.
+- (BOOL)matchesWithHomeAccountId:(nullable NSString *)homeAccountId
+                     environment:(nullable NSString *)environment
+             environmentAliasSet:(nullable NSSet<NSString *> *)environmentAliasSet;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -30,6 +30,15 @@
 - (BOOL)matchesWithHomeAccountId:(nullable NSString *)homeAccountId
                      environment:(nullable NSString *)environment
               environmentAliases:(nullable NSArray<NSString *> *)environmentAliases
+{
+    return [self matchesWithHomeAccountId:homeAccountId
+                              environment:environment
+                      environmentAliasSet:[NSString msidLowercasedAliasSet:environmentAliases]];
+}
+
+- (BOOL)matchesWithHomeAccountId:(nullable NSString *)homeAccountId
+                     environment:(nullable NSString *)environment
+             environmentAliasSet:(nullable NSSet<NSString *> *)environmentAliasSet
 {
     if (homeAccountId && ![self.homeAccountId.msidNormalizedString isEqualToString:homeAccountId.msidNormalizedString])
     {
@@ -41,7 +50,7 @@
         return NO;
     }
     
-    if ([environmentAliases count] && ![self.environment msidIsEquivalentWithAnyAlias:environmentAliases])
+    if ([environmentAliasSet count] && ![self.environment msidIsEquivalentWithAnyAliasInSet:environmentAliasSet])
     {
         return NO;
     }
@@ -41,6 +41,7 @@
 #import "MSIDWebviewNavigationHandler.h"
 #import "MSIDWebMDMEnrollmentCompletionResponse.h"
 #import "MSIDRequestControllerFactory.h"
+#import "MSIDTracer.h"
 
 @interface MSIDLocalInteractiveController()
 
@@ -91,6 +92,9 @@
 {
     MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Beginning interactive flow.");
     
+    MSIDTraceSpan *requestSpan = MSIDTraceRootSpanStart(MSIDTraceSpanInteractiveRequest, self.requestParameters.correlationId);
+    [requestSpan setAttribute:NSStringFromClass(self.class) forKey:@"controller"];
+    
     MSIDInteractiveTokenRequest *request = [self.tokenRequestProvider interactiveTokenRequestWithParameters:self.interactiveRequestParamaters];
 
     MSIDRequestCompletionBlock completionBlockWrapper = ^(MSIDTokenResult * _Nullable result, NSError * _Nullable error)
@@ -110,6 +114,9 @@
                                                                                 error:nil];
         }
         
+        [requestSpan setAttribute:error ? @(error.code) : nil forKey:@"error_code"];
+        MSIDTraceSpanEnd(requestSpan);
+        
         if (!completionBlock)
         {
             MSID_LOG_WITH_CTX(MSIDLogLevelError, self.requestParameters, @"Passed nil completionBlock. End local interactive acquire token.");
@@ -37,6 +37,9 @@
 #import "MSIDRequestParameters+Broker.h"
 #import "MSIDAuthority.h"
 #import "MSIDSignoutController.h"
+#import "MSIDFlightManager.h"
+#import "MSIDConstants.h"
+#import "MSIDTracer.h"
 #if TARGET_OS_OSX
 #import "MSIDXpcSilentTokenRequestController.h"
 #import "MSIDXpcInteractiveTokenRequestController.h"
@@ -53,22 +56,28 @@
     MSIDExecutionFlowInsertTag(MSIDRequestControllerFactoryTagToString(MSIDSilentControllerForParametersTag),
                                    @{MSID_EXECUTION_FLOW_DIAGNOSTIC_ID:@(parameters.xpcMode)},
                                    parameters.correlationId);
+    MSIDTraceSpan *selectionSpan = MSIDTraceSpanStart(MSIDTraceSpanControllerSelection, parameters.correlationId);
+    id<MSIDRequestControlling> controller = nil;
     if (parameters.xpcMode == MSIDXpcModeDisabled)
     {
-        return [self SilentControllerWithoutXpcForParameters:parameters
-                                                forceRefresh:forceRefresh
-                                                 skipLocalRt:skipLocalRt
-                                        tokenRequestProvider:tokenRequestProvider
-                                                       error:error];
+        controller = [self SilentControllerWithoutXpcForParameters:parameters
+                                                      forceRefresh:forceRefresh
+                                                       skipLocalRt:skipLocalRt
+                                              tokenRequestProvider:tokenRequestProvider
+                                                             error:error];
     }
     else
     {
-        return [self silentControllerWithXpcForParameters:parameters
-                                             forceRefresh:forceRefresh
-                                              skipLocalRt:skipLocalRt
-                                     tokenRequestProvider:tokenRequestProvider
-                                                    error:error];
+        controller = [self silentControllerWithXpcForParameters:parameters
+                                                   forceRefresh:forceRefresh
+                                                    skipLocalRt:skipLocalRt
+                                           tokenRequestProvider:tokenRequestProvider
+                                                          error:error];
     }
+    
+    [selectionSpan setAttribute:NSStringFromClass([controller class]) forKey:@"controller"];
+    MSIDTraceSpanEnd(selectionSpan);
+    return controller;
 }
 
 + (nullable id<MSIDRequestControlling>)SilentControllerWithoutXpcForParameters:(MSIDRequestParameters *)parameters
@@ -84,6 +93,7 @@
     }
 
     MSIDSilentController *brokerController;
+    MSIDAccountMetadataSource accountSource = MSIDAccountMetadataSourceUnknown;
     
     if ([parameters shouldUseBroker])
     {
@@ -95,8 +105,15 @@
             MSIDExecutionFlowInsertTag(MSIDRequestControllerFactoryTagToString(MSIDSilentControllerCanPerformSsoExtTag),
                                            @{MSID_EXECUTION_FLOW_DIAGNOSTIC_ID:@(parameters.allowUsingLocalCachedRtWhenSsoExtFailed)},
                                            parameters.correlationId);
+            accountSource = [self accountSourceForParameters:parameters tokenRequestProvider:tokenRequestProvider];
+            
+            // Broker-only accounts have no local refresh token to fall back to,
+            // local-only accounts try theirs before the SSO extension unless the caller skips it.
+            BOOL hasLocalRtToFallBackTo = accountSource != MSIDAccountMetadataSourceBroker
+                && (accountSource != MSIDAccountMetadataSourceLocal || skipLocalRt == MSIDSilentControllerForceSkippingLocalRt);
+            
             MSIDSilentController *localController = nil;
-            if (parameters.allowUsingLocalCachedRtWhenSsoExtFailed)
+            if (parameters.allowUsingLocalCachedRtWhenSsoExtFailed && hasLocalRtToFallBackTo)
             {
                 localController = [[MSIDSilentController alloc] initWithRequestParameters:parameters
                                                                              forceRefresh:YES
@@ -113,8 +130,15 @@
         }
     }
     
-    // TODO: Performance optimization: check account source.
-    // if (parameters.accountIdentifier.source == BROKER) return brokerController;
+    if (brokerController && accountSource == MSIDAccountMetadataSourceBroker)
+    {
+        MSIDExecutionFlowInsertTag(MSIDRequestControllerFactoryTagToString(MSIDSilentControllerBrokerOnlyAccountTag),
+                                       @{MSID_EXECUTION_FLOW_DIAGNOSTIC_ID:@(parameters.skipTokenCacheFromSsoExtensionResponse)},
+                                       parameters.correlationId);
+        
+        // SSO extension responses aren't saved locally, so there is nothing to read from the local cache.
+        if (parameters.skipTokenCacheFromSsoExtensionResponse) return brokerController;
+    }
     
     if (!brokerController)
     {
@@ -143,7 +167,15 @@
             localController.skipLocalRt = NO;
             break;
         case MSIDSilentControllerUndefinedLocalRtUsage:
-            if (brokerController) localController.skipLocalRt = YES;
+            if (brokerController && accountSource == MSIDAccountMetadataSourceLocal)
+            {
+                // The account never got tokens from the broker, try the local refresh token before the SSO extension.
+                MSIDExecutionFlowInsertTag(MSIDRequestControllerFactoryTagToString(MSIDSilentControllerLocalOnlyAccountTag),
+                                               nil,
+                                               parameters.correlationId);
+                localController.skipLocalRt = NO;
+            }
+            else if (brokerController) localController.skipLocalRt = YES;
             break;
         default:
             break;
@@ -156,6 +188,23 @@
     return localController;
 }
 
++ (MSIDAccountMetadataSource)accountSourceForParameters:(MSIDRequestParameters *)parameters
+                                   tokenRequestProvider:(id<MSIDTokenRequestProviding>)tokenRequestProvider
+{
+    if (![[MSIDFlightManager sharedInstance] boolForKey:MSID_FLIGHT_ACCOUNT_SOURCE_ROUTING_ENABLED]
+        || ![tokenRequestProvider respondsToSelector:@selector(accountSourceForParameters:)])
+    {
+        return MSIDAccountMetadataSourceUnknown;
+    }
+    
+    MSIDAccountMetadataSource accountSource = [tokenRequestProvider accountSourceForParameters:parameters];
+    MSIDExecutionFlowInsertTag(MSIDRequestControllerFactoryTagToString(MSIDSilentControllerAccountSourceTag),
+                                   @{MSID_EXECUTION_FLOW_DIAGNOSTIC_ID:@(accountSource)},
+                                   parameters.correlationId);
+    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, parameters, @"Routing silent request for account source %ld", (long)accountSource);
+    return accountSource;
+}
+
 + (nullable id<MSIDRequestControlling>)silentControllerWithXpcForParameters:(MSIDRequestParameters *)parameters
                                                                forceRefresh:(BOOL)forceRefresh
                                                                 skipLocalRt:(MSIDSilentControllerLocalRtUsageType)skipLocalRt
@@ -274,6 +323,7 @@
                                    @{MSID_EXECUTION_FLOW_DIAGNOSTIC_ID:@(parameters.xpcMode)},
                                    parameters.correlationId);
 
+    MSIDTraceSpan *selectionSpan = MSIDTraceSpanStart(MSIDTraceSpanControllerSelection, parameters.correlationId);
     id<MSIDRequestControlling> interactiveController = [self platformInteractiveController:parameters
                                                                       tokenRequestProvider:tokenRequestProvider
                                                                                      error:error];
@@ -292,6 +342,8 @@
                                    @{MSID_EXECUTION_FLOW_DIAGNOSTIC_ID:@(parameters.uiBehaviorType)},
                                    parameters.correlationId);
 
+    [selectionSpan setAttribute:NSStringFromClass([finalController class]) forKey:@"controller"];
+    MSIDTraceSpanEnd(selectionSpan);
     return finalController;
 }
 
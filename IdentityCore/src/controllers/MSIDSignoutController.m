@@ -30,6 +30,7 @@
 #import "MSIDInteractiveRequestParameters.h"
 #import "MSIDRequestParameters+Broker.h"
 #import "MSIDOIDCSignoutRequest.h"
+#import "MSIDTracer.h"
 
 @interface MSIDSignoutController()
 
@@ -73,9 +74,19 @@
 {
     if (!completionBlock) return;
     
+    MSIDTraceSpan *requestSpan = MSIDTraceRootSpanStart(MSIDTraceSpanSignoutRequest, self.parameters.correlationId);
+    [requestSpan setAttribute:NSStringFromClass(self.class) forKey:@"controller"];
+    
+    MSIDSignoutRequestCompletionBlock requestCompletionBlock = ^(BOOL success, NSError *error)
+    {
+        [requestSpan setAttribute:error ? @(error.code) : nil forKey:@"error_code"];
+        MSIDTraceSpanEnd(requestSpan);
+        completionBlock(success, error);
+    };
+    
     if (!self.shouldSignoutFromBrowser)
     {
-        completionBlock(YES, nil);
+        requestCompletionBlock(YES, nil);
         return;
     }
     
@@ -89,7 +100,7 @@
         }
         
         self.currentRequest = nil;
-        completionBlock(success, error);
+        requestCompletionBlock(success, error);
     }];
 }
 
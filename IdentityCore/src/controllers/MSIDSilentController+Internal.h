@@ -22,12 +22,24 @@
 // THE SOFTWARE.
 
 #import "MSIDSilentController.h"
+#import "MSIDSilentRequestHedge.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface MSIDSilentController ()
 
+// Set while the controller runs as a leg of a hedged request, passed on to its token request.
+@property (nonatomic, nullable) MSIDSilentRequestHedge *hedge;
+@property (nonatomic) MSIDSilentRequestHedgeLeg hedgeLeg;
+
+- (void)acquireTokenWithRequest:(MSIDSilentTokenRequest *)request
+                completionBlock:(MSIDRequestCompletionBlock)completionBlock;
+
+// Runs request and, if it hasn't finished after delay, hedgeController in parallel.
+// The first successful result wins and the other leg is cancelled.
 - (void)acquireTokenWithRequest:(MSIDSilentTokenRequest *)request
+          hedgingWithController:(MSIDSilentController *)hedgeController
+                          delay:(NSTimeInterval)delay
                 completionBlock:(MSIDRequestCompletionBlock)completionBlock;
 
 @end
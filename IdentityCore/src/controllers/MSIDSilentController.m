@@ -30,6 +30,7 @@
 #import "MSIDTokenResult.h"
 #import "MSIDAccount.h"
 #import "MSIDAADRequestErrorHandler.h"
+#import "MSIDTracer.h"
 #if TARGET_OS_IPHONE
 #import "MSIDBackgroundTaskManager.h"
 #endif
@@ -86,18 +87,25 @@
     
     MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Beginning silent flow.");
     
+    MSIDTraceSpan *requestSpan = MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, self.requestParameters.correlationId);
+    [requestSpan setAttribute:NSStringFromClass(self.class) forKey:@"controller"];
+    
     MSIDRequestCompletionBlock completionBlockWrapper = ^(MSIDTokenResult * _Nullable result, NSError * _Nullable error)
     {
 #if TARGET_OS_IPHONE
         [[MSIDBackgroundTaskManager sharedInstance] stopOperationWithType:MSIDBackgroundTaskTypeSilentRequest];
 #endif
         MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Silent flow finished. Result %@, error: %ld error domain: %@", _PII_NULLIFY(result), (long)error.code, error.domain);
+        [requestSpan setAttribute:error ? @(error.code) : nil forKey:@"error_code"];
+        MSIDTraceSpanEnd(requestSpan);
         completionBlock(result, error);
     };
     
     __auto_type request = [self.tokenRequestProvider silentTokenRequestWithParameters:self.requestParameters
                                                                          forceRefresh:self.forceRefresh];
     request.skipLocalRt = self.skipLocalRt;
+    request.hedge = self.hedge;
+    request.hedgeLeg = self.hedgeLeg;
     [self acquireTokenWithRequest:request completionBlock:completionBlockWrapper];
 }
 
@@ -116,23 +124,26 @@
     self.currentRequest = request;
     [request executeRequestWithCompletion:^(MSIDTokenResult *result, NSError *error)
     {
-        if (error)
+        if ([self shouldRetryRequest:request withoutBoundAppRefreshTokenAfterError:error])
         {
-            if (request.shouldSkipBoundAppRefreshTokenUsage
-                && [error.domain isEqualToString:MSIDErrorDomain]
-                && error.code == MSIDErrorBoundAppRefreshTokenRedemptionError)
+            [request executeRequestWithCompletion:^(MSIDTokenResult * _Nullable retryResult, NSError * _Nullable retryError)
             {
-                [request executeRequestWithCompletion:^(MSIDTokenResult * _Nullable retryResult, NSError * _Nullable retryError)
-                {
-                    [self processResponse:retryResult error:retryError completionBlock:completionBlock];
-                }];
-                return;
-            }
+                [self processResponse:retryResult error:retryError completionBlock:completionBlock];
+            }];
+            return;
         }
         [self processResponse:result error:error completionBlock:completionBlock];
     }];
 }
 
+- (BOOL)shouldRetryRequest:(MSIDSilentTokenRequest *)request withoutBoundAppRefreshTokenAfterError:(NSError *)error
+{
+    return error
+        && request.shouldSkipBoundAppRefreshTokenUsage
+        && [error.domain isEqualToString:MSIDErrorDomain]
+        && error.code == MSIDErrorBoundAppRefreshTokenRedemptionError;
+}
+
 - (void)processResponse:(MSIDTokenResult *)result
                   error:(NSError *)error
         completionBlock:(MSIDRequestCompletionBlock)completionBlock
@@ -144,20 +155,7 @@
     
     if (result || !self.fallbackController)
     {
-#if !EXCLUDE_FROM_MSALCPP
-        MSIDTelemetryAPIEvent *telemetryEvent = [self telemetryAPIEvent];
-        [telemetryEvent setUserInformation:result.account];
-        [telemetryEvent setIsExtendedLifeTimeToken:result.extendedLifeTimeToken ? MSID_TELEMETRY_VALUE_YES : MSID_TELEMETRY_VALUE_NO];
-        if (self.isLocalFallbackMode)
-        {
-            [telemetryEvent setSsoExtFallBackFlow:1];
-        }
-        
-        [self stopTelemetryEvent:telemetryEvent error:error];
-#endif
-        self.currentRequest = nil;
-        
-        completionBlock(result, error);
+        [self completeWithResult:result error:error completionBlock:completionBlock];
         return;
     }
     
@@ -178,4 +176,151 @@
     [self.fallbackController acquireToken:completionBlockWrapper];
 }
 
+- (void)completeWithResult:(MSIDTokenResult *)result
+                     error:(NSError *)error
+           completionBlock:(MSIDRequestCompletionBlock)completionBlock
+{
+#if !EXCLUDE_FROM_MSALCPP
+    MSIDTelemetryAPIEvent *telemetryEvent = [self telemetryAPIEvent];
+    [telemetryEvent setUserInformation:result.account];
+    [telemetryEvent setIsExtendedLifeTimeToken:result.extendedLifeTimeToken ? MSID_TELEMETRY_VALUE_YES : MSID_TELEMETRY_VALUE_NO];
+    if (self.isLocalFallbackMode)
+    {
+        [telemetryEvent setSsoExtFallBackFlow:1];
+    }
+    
+    [self stopTelemetryEvent:telemetryEvent error:error];
+#endif
+    self.currentRequest = nil;
+    
+    completionBlock(result, error);
+}
+
+#pragma mark - Hedging
+
+- (void)acquireTokenWithRequest:(MSIDSilentTokenRequest *)request
+          hedgingWithController:(MSIDSilentController *)hedgeController
+                          delay:(NSTimeInterval)delay
+                completionBlock:(MSIDRequestCompletionBlock)completionBlock
+{
+    if (!completionBlock)
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelError, nil, @"Passed nil completionBlock");
+        return;
+    }
+    
+    CONDITIONAL_START_EVENT(CONDITIONAL_SHARED_INSTANCE, self.requestParameters.telemetryRequestId, MSID_TELEMETRY_EVENT_API_EVENT);
+    
+    MSIDSilentRequestHedge *hedge = [MSIDSilentRequestHedge new];
+    request.hedge = hedge;
+    request.hedgeLeg = MSIDSilentRequestHedgeLegPrimary;
+    hedgeController.hedge = hedge;
+    hedgeController.hedgeLeg = MSIDSilentRequestHedgeLegSecondary;
+    self.currentRequest = request;
+    
+    // Guarded by hedge.
+    __block BOOL completed = NO;
+    __block BOOL primaryFailed = NO;
+    __block BOOL secondaryFinished = NO;
+    __block MSIDTokenResult *secondaryResult = nil;
+    __block NSError *secondaryError = nil;
+    
+    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Starting hedged silent request, hedge delay %f.", delay);
+    
+    MSIDRequestCompletionBlock primaryCompletionBlock = ^(MSIDTokenResult *result, NSError *error)
+    {
+        BOOL secondaryStarted;
+        BOOL useSecondaryResult = NO;
+        // The sequential path returns network failures as is, without falling back to the local refresh token.
+        BOOL networkFailure = error && [MSIDAADRequestErrorHandler shouldRetryNetworkingFailure:error.code];
+        BOOL waitForSecondary = !result && !networkFailure;
+        
+        @synchronized (hedge)
+        {
+            if (completed) return;
+            
+            [hedge finishPrimaryLeg];
+            secondaryStarted = hedge.secondaryLegStarted;
+            
+            if (waitForSecondary && secondaryStarted && !secondaryFinished)
+            {
+                // Wait for the secondary leg, its result is what the sequential fallback would have returned.
+                primaryFailed = YES;
+                return;
+            }
+            
+            completed = YES;
+            useSecondaryResult = waitForSecondary && secondaryStarted;
+        }
+        
+        if (!secondaryStarted)
+        {
+            // Finished before the hedge delay, continue as a regular request.
+            hedgeController.hedge = nil;
+            [self processResponse:result error:error completionBlock:completionBlock];
+            return;
+        }
+        
+        if (useSecondaryResult)
+        {
+            [self completeWithResult:secondaryResult error:secondaryError completionBlock:completionBlock];
+            return;
+        }
+        
+        [hedge cancelLeg:MSIDSilentRequestHedgeLegSecondary];
+        
+        if (networkFailure)
+        {
+            MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Primary leg of hedged silent request failed with a network error, cancelling secondary leg.");
+            [self processResponse:result error:error completionBlock:completionBlock];
+            return;
+        }
+        
+        MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Primary leg won hedged silent request, cancelling secondary leg.");
+        [self completeWithResult:result error:error completionBlock:completionBlock];
+    };
+    
+    [request executeRequestWithCompletion:^(MSIDTokenResult *result, NSError *error)
+    {
+        // Retried within the primary leg, as in the sequential path.
+        if ([self shouldRetryRequest:request withoutBoundAppRefreshTokenAfterError:error])
+        {
+            [request executeRequestWithCompletion:primaryCompletionBlock];
+            return;
+        }
+        primaryCompletionBlock(result, error);
+    }];
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        
+        if (![hedge startSecondaryLeg]) return;
+        
+        MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Primary leg didn't finish in %f seconds, starting secondary leg of hedged silent request.", delay);
+        
+        [hedgeController acquireToken:^(MSIDTokenResult *hedgeResult, NSError *hedgeError)
+        {
+            @synchronized (hedge)
+            {
+                if (completed) return;
+                
+                secondaryFinished = YES;
+                secondaryResult = hedgeResult;
+                secondaryError = hedgeError;
+                
+                if (!hedgeResult && !primaryFailed) return;
+                
+                completed = YES;
+            }
+            
+            if (hedgeResult)
+            {
+                MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Secondary leg won hedged silent request, cancelling primary leg.");
+                [hedge cancelLeg:MSIDSilentRequestHedgeLegPrimary];
+            }
+            
+            [self completeWithResult:hedgeResult error:hedgeError completionBlock:completionBlock];
+        }];
+    });
+}
+
 @end
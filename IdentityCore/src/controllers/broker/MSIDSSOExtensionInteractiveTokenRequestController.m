@@ -29,6 +29,7 @@
 #import "MSIDInteractiveTokenRequestParameters.h"
 #import "MSIDDefaultTokenCacheAccessor.h"
 #import "MSIDInteractiveTokenRequest+Internal.h"
+#import "MSIDTracer.h"
 
 @implementation MSIDSSOExtensionInteractiveTokenRequestController
 
@@ -54,6 +55,16 @@
 {
     MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Beginning interactive broker extension flow.");
     
+    MSIDTraceSpan *requestSpan = MSIDTraceRootSpanStart(MSIDTraceSpanInteractiveRequest, self.requestParameters.correlationId);
+    [requestSpan setAttribute:NSStringFromClass(self.class) forKey:@"controller"];
+    
+    MSIDRequestCompletionBlock requestCompletionBlock = ^(MSIDTokenResult *result, NSError *error)
+    {
+        [requestSpan setAttribute:error ? @(error.code) : nil forKey:@"error_code"];
+        MSIDTraceSpanEnd(requestSpan);
+        completionBlock(result, error);
+    };
+    
     MSIDInteractiveTokenRequest *request = [self.tokenRequestProvider interactiveSSOExtensionTokenRequestWithParameters:self.interactiveRequestParamaters];
 
     MSIDRequestCompletionBlock completionBlockWrapper = ^(MSIDTokenResult *result, NSError *error)
@@ -71,11 +82,11 @@
         {
             MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Falling back to local controller.");
             
-            [self.fallbackController acquireToken:completionBlock];
+            [self.fallbackController acquireToken:requestCompletionBlock];
             return;
         }
         
-        completionBlock(result, error);
+        requestCompletionBlock(result, error);
     };
 
     [self acquireTokenWithRequest:request completionBlock:completionBlockWrapper];
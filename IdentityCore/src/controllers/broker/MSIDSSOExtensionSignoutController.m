@@ -28,6 +28,7 @@
 #import "MSIDInteractiveRequestParameters.h"
 #import "ASAuthorizationSingleSignOnProvider+MSIDExtensions.h"
 #import "MSIDMainThreadUtil.h"
+#import "MSIDTracer.h"
 
 @interface MSIDSSOExtensionSignoutController()
 
@@ -63,6 +64,16 @@
 {
     if (!completionBlock) return;
     
+    MSIDTraceSpan *requestSpan = MSIDTraceRootSpanStart(MSIDTraceSpanSignoutRequest, self.parameters.correlationId);
+    [requestSpan setAttribute:NSStringFromClass(self.class) forKey:@"controller"];
+    
+    MSIDSignoutRequestCompletionBlock requestCompletionBlock = ^(BOOL success, NSError *error)
+    {
+        [requestSpan setAttribute:error ? @(error.code) : nil forKey:@"error_code"];
+        MSIDTraceSpanEnd(requestSpan);
+        completionBlock(success, error);
+    };
+    
     self.currentSSORequest = [[MSIDSSOExtensionSignoutRequest alloc] initWithRequestParameters:self.parameters
                                                                       shouldSignoutFromBrowser:NO
                                                                              shouldWipeAccount:self.shouldWipeAccount
@@ -77,21 +88,21 @@
         if (!success)
         {
             MSID_LOG_WITH_CTX_PII(MSIDLogLevelError, self.parameters, @"Failed to perform SSO extension signout request with error %@", MSID_PII_LOG_MASKABLE(error));
-            completionBlock(success, error);
+            requestCompletionBlock(success, error);
             return;
         }
         
         if (!self.shouldSignoutFromBrowser)
         {
-            completionBlock(YES, nil);
+            requestCompletionBlock(YES, nil);
             return;
         }
         
         [MSIDMainThreadUtil executeOnMainThreadIfNeeded:^{
 #if TARGET_OS_IPHONE
-            [self waitForSceneActivationAndCompleteSignout:completionBlock];
+            [self waitForSceneActivationAndCompleteSignout:requestCompletionBlock];
 #else
-            [super executeRequestWithCompletion:completionBlock];
+            [super executeRequestWithCompletion:requestCompletionBlock];
 #endif
         }];
     }];
@@ -25,6 +25,8 @@
 #import "MSIDSSOExtensionSilentTokenRequestController.h"
 #import "MSIDSilentController+Internal.h"
 #import "ASAuthorizationSingleSignOnProvider+MSIDExtensions.h"
+#import "MSIDSSOExtensionLatencyTracker.h"
+#import "MSIDTracer.h"
 
 @implementation MSIDSSOExtensionSilentTokenRequestController
 
@@ -33,17 +35,42 @@
 - (void)acquireToken:(MSIDRequestCompletionBlock)completionBlock
 {
     MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Beginning silent broker extension flow.");
+    MSIDTraceSpan *requestSpan = MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, self.requestParameters.correlationId);
+    [requestSpan setAttribute:NSStringFromClass(self.class) forKey:@"controller"];
+    
     MSIDRequestCompletionBlock completionBlockWrapper = ^(MSIDTokenResult *result, NSError *error)
     {
         MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Silent broker extension flow finished. Result %@, error: %ld error domain: %@, shouldFallBack: %@", _PII_NULLIFY(result), (long)error.code, error.domain, @(self.fallbackController != nil));
+        [requestSpan setAttribute:error ? @(error.code) : nil forKey:@"error_code"];
+        MSIDTraceSpanEnd(requestSpan);
         completionBlock(result, error);
     };
     
     __auto_type request = [self.tokenRequestProvider silentSSOExtensionTokenRequestWithParameters:self.requestParameters
                                                                                      forceRefresh:self.forceRefresh];
+    
+    MSIDSilentController *localFallbackController = [self localFallbackControllerForHedging];
+    if (localFallbackController)
+    {
+        [self acquireTokenWithRequest:request
+                hedgingWithController:localFallbackController
+                                delay:[[MSIDSSOExtensionLatencyTracker sharedInstance] hedgeDelay]
+                      completionBlock:completionBlockWrapper];
+        return;
+    }
+    
     [self acquireTokenWithRequest:request completionBlock:completionBlockWrapper];
 }
 
+- (MSIDSilentController *)localFallbackControllerForHedging
+{
+    if (!self.requestParameters.hedgeSsoExtWithLocalCachedRt) return nil;
+    if (![self.fallbackController isKindOfClass:MSIDSilentController.class]) return nil;
+    
+    MSIDSilentController *fallbackController = (MSIDSilentController *)self.fallbackController;
+    return fallbackController.isLocalFallbackMode ? fallbackController : nil;
+}
+
 + (BOOL)canPerformRequest
 {
     return [[ASAuthorizationSingleSignOnProvider msidSharedProvider] canPerformAuthorization];
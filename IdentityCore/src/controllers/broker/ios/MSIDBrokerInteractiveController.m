@@ -51,6 +51,7 @@
 #import "MSIDExecutionFlowConstants.h"
 #import "MSIDLogger+Internal.h"
 #import "NSURL+MSIDExtensions.h"
+#import "MSIDTracer.h"
 #import "MSIDOnboardingStatus.h"
 #import "MSIDOnboardingStatusCache.h"
 #import "MSIDBrokerConstants.h"
@@ -122,6 +123,16 @@ static MSIDBrokerTokenRequest *s_currentBrokerRequest;
         return;
     }
     
+    MSIDTraceSpan *requestSpan = MSIDTraceRootSpanStart(MSIDTraceSpanInteractiveRequest, self.requestParameters.correlationId);
+    [requestSpan setAttribute:NSStringFromClass(self.class) forKey:@"controller"];
+    
+    MSIDRequestCompletionBlock requestCompletionBlock = ^(MSIDTokenResult *result, NSError *error)
+    {
+        [requestSpan setAttribute:error ? @(error.code) : nil forKey:@"error_code"];
+        MSIDTraceSpanEnd(requestSpan);
+        completionBlock(result, error);
+    };
+    
     NSString *upn = self.interactiveParameters.accountIdentifier.displayableId ?: self.interactiveParameters.loginHint;
     
     [self.interactiveParameters.authority resolveAndValidate:self.interactiveParameters.validateAuthority
@@ -132,11 +143,11 @@ static MSIDBrokerTokenRequest *s_currentBrokerRequest;
      {
          if (error)
          {
-             completionBlock(nil, error);
+             requestCompletionBlock(nil, error);
              return;
          }
          
-         [self acquireTokenImpl:completionBlock];
+         [self acquireTokenImpl:requestCompletionBlock];
      }];
 }
 
@@ -31,6 +31,7 @@
 #import "MSIDInteractiveTokenRequest+Internal.h"
 #import "MSIDInteractiveTokenRequestParameters.h"
 #import "MSIDXpcProviderCache.h"
+#import "MSIDTracer.h"
 
 @implementation MSIDXpcInteractiveTokenRequestController
 
@@ -55,6 +56,17 @@
 - (void)acquireToken:(MSIDRequestCompletionBlock)completionBlock
 {
     MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Beginning interactive broker Xpc service flow.");
+    
+    MSIDTraceSpan *requestSpan = MSIDTraceRootSpanStart(MSIDTraceSpanInteractiveRequest, self.requestParameters.correlationId);
+    [requestSpan setAttribute:NSStringFromClass(self.class) forKey:@"controller"];
+    
+    MSIDRequestCompletionBlock requestCompletionBlock = ^(MSIDTokenResult *result, NSError *error)
+    {
+        [requestSpan setAttribute:error ? @(error.code) : nil forKey:@"error_code"];
+        MSIDTraceSpanEnd(requestSpan);
+        completionBlock(result, error);
+    };
+    
     MSIDInteractiveTokenRequest *request = [self.tokenRequestProvider interactiveXpcTokenRequestWithParameters:self.interactiveRequestParamaters];
     
     MSIDRequestCompletionBlock completionBlockWrapper = ^(MSIDTokenResult *result, NSError *error)
@@ -72,11 +84,11 @@
         {
             MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Falling back to local controller.");
             
-            [self.fallbackController acquireToken:completionBlock];
+            [self.fallbackController acquireToken:requestCompletionBlock];
             return;
         }
         
-        completionBlock(result, error);
+        requestCompletionBlock(result, error);
     };
     
     [self acquireTokenWithRequest:request completionBlock:completionBlockWrapper];
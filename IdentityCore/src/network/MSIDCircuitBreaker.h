@@ -0,0 +1,86 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, MSIDCircuitBreakerState)
+{
+    // Requests flow, consecutive failures are counted.
+    MSIDCircuitBreakerStateClosed = 0,
+    // Requests fail fast without hitting the network until openDuration has elapsed.
+    MSIDCircuitBreakerStateOpen,
+    // A single probe request is let through; its outcome closes or re-opens the breaker.
+    MSIDCircuitBreakerStateHalfOpen
+};
+
+FOUNDATION_EXPORT NSString *MSIDCircuitBreakerStateToString(MSIDCircuitBreakerState state);
+
+// Point-in-time snapshot of a breaker's state and transition counters.
+@interface MSIDCircuitBreakerMetrics : NSObject
+
+@property (nonatomic, readonly) MSIDCircuitBreakerState state;
+@property (nonatomic, readonly) NSUInteger consecutiveFailures;
+@property (nonatomic, readonly) NSUInteger openedCount;
+@property (nonatomic, readonly) NSUInteger halfOpenedCount;
+@property (nonatomic, readonly) NSUInteger closedCount;
+@property (nonatomic, readonly) NSUInteger rejectedRequestCount;
+@property (nonatomic, readonly, nullable) NSDate *lastTransitionDate;
+
+@end
+
+/*!
+ Closed/open/half-open circuit breaker for one endpoint. Thread safe.
+ */
+@interface MSIDCircuitBreaker : NSObject
+
+@property (nonatomic, readonly) NSUInteger failureThreshold;
+@property (nonatomic, readonly) NSTimeInterval openDuration;
+@property (nonatomic, readonly) MSIDCircuitBreakerState state;
+@property (nonatomic, readonly) MSIDCircuitBreakerMetrics *metrics;
+
+// Monotonic time source in seconds. Replaceable for tests.
+@property (nonatomic, copy) NSTimeInterval (^clock)(void);
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+- (instancetype)initWithFailureThreshold:(NSUInteger)failureThreshold
+                            openDuration:(NSTimeInterval)openDuration NS_DESIGNATED_INITIALIZER;
+
+/*!
+ Returns NO when the request must fail fast. When YES is returned the caller must report the outcome with one of
+ the record methods below, otherwise a half-open breaker keeps its probe slot until openDuration passes.
+ */
+- (BOOL)allowRequest;
+
+- (void)recordSuccess;
+- (void)recordFailure;
+// The request finished without telling anything about the endpoint health (e.g. the device is offline).
+- (void)recordIgnoredOutcome;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,212 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDCircuitBreaker.h"
+
+NSString *MSIDCircuitBreakerStateToString(MSIDCircuitBreakerState state)
+{
+    switch (state)
+    {
+        case MSIDCircuitBreakerStateClosed:
+            return @"closed";
+        case MSIDCircuitBreakerStateOpen:
+            return @"open";
+        case MSIDCircuitBreakerStateHalfOpen:
+            return @"half-open";
+    }
+    
+    return [NSString stringWithFormat:@"MSIDCircuitBreakerState(%ld)", (long)state];
+}
+
+@interface MSIDCircuitBreakerMetrics ()
+
+@property (nonatomic, readwrite) MSIDCircuitBreakerState state;
+@property (nonatomic, readwrite) NSUInteger consecutiveFailures;
+@property (nonatomic, readwrite) NSUInteger openedCount;
+@property (nonatomic, readwrite) NSUInteger halfOpenedCount;
+@property (nonatomic, readwrite) NSUInteger closedCount;
+@property (nonatomic, readwrite) NSUInteger rejectedRequestCount;
+@property (nonatomic, readwrite, nullable) NSDate *lastTransitionDate;
+
+@end
+
+@implementation MSIDCircuitBreakerMetrics
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: state=%@, failures=%lu, opened=%lu, halfOpened=%lu, closed=%lu, rejected=%lu>",
+            self.class,
+            MSIDCircuitBreakerStateToString(self.state),
+            (unsigned long)self.consecutiveFailures,
+            (unsigned long)self.openedCount,
+            (unsigned long)self.halfOpenedCount,
+            (unsigned long)self.closedCount,
+            (unsigned long)self.rejectedRequestCount];
+}
+
+@end
+
+@implementation MSIDCircuitBreaker
+{
+    MSIDCircuitBreakerState _state;
+    NSUInteger _consecutiveFailures;
+    NSTimeInterval _openedTime;
+    NSTimeInterval _probeStartTime;
+    BOOL _probeInFlight;
+    MSIDCircuitBreakerMetrics *_metrics;
+}
+
+- (instancetype)initWithFailureThreshold:(NSUInteger)failureThreshold
+                            openDuration:(NSTimeInterval)openDuration
+{
+    self = [super init];
+    if (self)
+    {
+        _failureThreshold = MAX(failureThreshold, 1u);
+        _openDuration = MAX(openDuration, 0);
+        _state = MSIDCircuitBreakerStateClosed;
+        _metrics = [MSIDCircuitBreakerMetrics new];
+        _clock = ^NSTimeInterval {
+            return [NSProcessInfo processInfo].systemUptime;
+        };
+    }
+    
+    return self;
+}
+
+- (MSIDCircuitBreakerState)state
+{
+    @synchronized (self)
+    {
+        return _state;
+    }
+}
+
+- (MSIDCircuitBreakerMetrics *)metrics
+{
+    @synchronized (self)
+    {
+        MSIDCircuitBreakerMetrics *snapshot = [MSIDCircuitBreakerMetrics new];
+        snapshot.state = _state;
+        snapshot.consecutiveFailures = _consecutiveFailures;
+        snapshot.openedCount = _metrics.openedCount;
+        snapshot.halfOpenedCount = _metrics.halfOpenedCount;
+        snapshot.closedCount = _metrics.closedCount;
+        snapshot.rejectedRequestCount = _metrics.rejectedRequestCount;
+        snapshot.lastTransitionDate = _metrics.lastTransitionDate;
+        return snapshot;
+    }
+}
+
+- (BOOL)allowRequest
+{
+    @synchronized (self)
+    {
+        NSTimeInterval now = self.clock();
+        
+        switch (_state)
+        {
+            case MSIDCircuitBreakerStateClosed:
+                return YES;
+                
+            case MSIDCircuitBreakerStateOpen:
+                if (now - _openedTime < _openDuration) break;
+                
+                [self transitionToState:MSIDCircuitBreakerStateHalfOpen];
+                _probeInFlight = YES;
+                _probeStartTime = now;
+                return YES;
+                
+            case MSIDCircuitBreakerStateHalfOpen:
+                // A probe whose outcome was never reported must not keep the endpoint blocked forever.
+                if (_probeInFlight && now - _probeStartTime < _openDuration) break;
+                
+                _probeInFlight = YES;
+                _probeStartTime = now;
+                return YES;
+        }
+        
+        _metrics.rejectedRequestCount += 1;
+        return NO;
+    }
+}
+
+- (void)recordSuccess
+{
+    @synchronized (self)
+    {
+        _consecutiveFailures = 0;
+        _probeInFlight = NO;
+        if (_state != MSIDCircuitBreakerStateClosed) [self transitionToState:MSIDCircuitBreakerStateClosed];
+    }
+}
+
+- (void)recordFailure
+{
+    @synchronized (self)
+    {
+        _consecutiveFailures += 1;
+        _probeInFlight = NO;
+        
+        if (_state == MSIDCircuitBreakerStateHalfOpen
+            || (_state == MSIDCircuitBreakerStateClosed && _consecutiveFailures >= _failureThreshold))
+        {
+            _openedTime = self.clock();
+            [self transitionToState:MSIDCircuitBreakerStateOpen];
+        }
+    }
+}
+
+- (void)recordIgnoredOutcome
+{
+    @synchronized (self)
+    {
+        _probeInFlight = NO;
+    }
+}
+
+#pragma mark - Private
+
+- (void)transitionToState:(MSIDCircuitBreakerState)state
+{
+    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, nil, @"Circuit breaker transition %@ -> %@ after %lu consecutive failure(s).", MSIDCircuitBreakerStateToString(_state), MSIDCircuitBreakerStateToString(state), (unsigned long)_consecutiveFailures);
+    
+    _state = state;
+    _metrics.lastTransitionDate = [NSDate date];
+    
+    switch (state)
+    {
+        case MSIDCircuitBreakerStateOpen:
+            _metrics.openedCount += 1;
+            break;
+        case MSIDCircuitBreakerStateHalfOpen:
+            _metrics.halfOpenedCount += 1;
+            break;
+        case MSIDCircuitBreakerStateClosed:
+            _metrics.closedCount += 1;
+            break;
+    }
+}
+
+@end
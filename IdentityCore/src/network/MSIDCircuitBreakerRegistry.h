@@ -0,0 +1,67 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+@class MSIDCircuitBreaker;
+@class MSIDCircuitBreakerMetrics;
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, MSIDCircuitBreakerEndpointClass)
+{
+    // Not guarded by a circuit breaker.
+    MSIDCircuitBreakerEndpointClassNone = 0,
+    MSIDCircuitBreakerEndpointClassToken,
+    MSIDCircuitBreakerEndpointClassInstanceDiscovery,
+    MSIDCircuitBreakerEndpointClassOpenIdConfiguration,
+    MSIDCircuitBreakerEndpointClassDRS
+};
+
+/*!
+ Circuit breakers keyed on host and endpoint class, so that e.g. a failing token endpoint on one cloud does not
+ block instance discovery on it, or the token endpoint of another cloud.
+ */
+@interface MSIDCircuitBreakerRegistry : NSObject
+
+// Consecutive transient failures that open a breaker. Applies to breakers created afterwards.
+@property (nonatomic) NSUInteger failureThreshold;
+// How long an open breaker fails requests before letting a probe through. Applies to breakers created afterwards.
+@property (nonatomic) NSTimeInterval openDuration;
+
++ (instancetype)sharedRegistry;
+
++ (MSIDCircuitBreakerEndpointClass)endpointClassForURL:(nullable NSURL *)url;
+
+// Returns nil for URLs that are not in one of the guarded endpoint classes.
+- (nullable MSIDCircuitBreaker *)circuitBreakerForURL:(nullable NSURL *)url;
+
+// Keyed by "<host>|<endpoint class>".
+- (NSDictionary<NSString *, MSIDCircuitBreakerMetrics *> *)metricsSnapshot;
+
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
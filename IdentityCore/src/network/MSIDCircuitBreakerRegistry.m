@@ -0,0 +1,138 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDCircuitBreakerRegistry.h"
+#import "MSIDCircuitBreaker.h"
+
+static NSUInteger const MSIDCircuitBreakerDefaultFailureThreshold = 5;
+static NSTimeInterval const MSIDCircuitBreakerDefaultOpenDuration = 30;
+
+static NSString *MSIDCircuitBreakerEndpointClassToString(MSIDCircuitBreakerEndpointClass endpointClass)
+{
+    switch (endpointClass)
+    {
+        case MSIDCircuitBreakerEndpointClassNone:
+            return @"none";
+        case MSIDCircuitBreakerEndpointClassToken:
+            return @"token";
+        case MSIDCircuitBreakerEndpointClassInstanceDiscovery:
+            return @"instance_discovery";
+        case MSIDCircuitBreakerEndpointClassOpenIdConfiguration:
+            return @"openid_configuration";
+        case MSIDCircuitBreakerEndpointClassDRS:
+            return @"drs";
+    }
+    
+    return @"unknown";
+}
+
+@implementation MSIDCircuitBreakerRegistry
+{
+    NSMutableDictionary<NSString *, MSIDCircuitBreaker *> *_circuitBreakers;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _circuitBreakers = [NSMutableDictionary new];
+        _failureThreshold = MSIDCircuitBreakerDefaultFailureThreshold;
+        _openDuration = MSIDCircuitBreakerDefaultOpenDuration;
+    }
+    
+    return self;
+}
+
++ (instancetype)sharedRegistry
+{
+    static MSIDCircuitBreakerRegistry *s_sharedRegistry = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        s_sharedRegistry = [MSIDCircuitBreakerRegistry new];
+    });
+    
+    return s_sharedRegistry;
+}
+
++ (MSIDCircuitBreakerEndpointClass)endpointClassForURL:(NSURL *)url
+{
+    NSString *path = url.path.lowercaseString;
+    if (!path.length || !url.host.length) return MSIDCircuitBreakerEndpointClassNone;
+    
+    // .../oauth2/token and .../oauth2/v2.0/token
+    if ([path hasSuffix:@"/token"] && [path containsString:@"/oauth2/"]) return MSIDCircuitBreakerEndpointClassToken;
+    if ([path hasSuffix:@"/discovery/instance"] || [path hasSuffix:@"/discovery/v2.0/instance"]) return MSIDCircuitBreakerEndpointClassInstanceDiscovery;
+    if ([path hasSuffix:@"/.well-known/openid-configuration"]) return MSIDCircuitBreakerEndpointClassOpenIdConfiguration;
+    if ([path hasSuffix:@"/enrollmentserver/contract"]) return MSIDCircuitBreakerEndpointClassDRS;
+    
+    return MSIDCircuitBreakerEndpointClassNone;
+}
+
+- (MSIDCircuitBreaker *)circuitBreakerForURL:(NSURL *)url
+{
+    MSIDCircuitBreakerEndpointClass endpointClass = [self.class endpointClassForURL:url];
+    if (endpointClass == MSIDCircuitBreakerEndpointClassNone) return nil;
+    
+    NSString *key = [NSString stringWithFormat:@"%@|%@", url.host.lowercaseString, MSIDCircuitBreakerEndpointClassToString(endpointClass)];
+    
+    @synchronized (self)
+    {
+        MSIDCircuitBreaker *circuitBreaker = _circuitBreakers[key];
+        if (!circuitBreaker)
+        {
+            circuitBreaker = [[MSIDCircuitBreaker alloc] initWithFailureThreshold:self.failureThreshold openDuration:self.openDuration];
+            _circuitBreakers[key] = circuitBreaker;
+        }
+        
+        return circuitBreaker;
+    }
+}
+
+- (NSDictionary<NSString *, MSIDCircuitBreakerMetrics *> *)metricsSnapshot
+{
+    NSDictionary<NSString *, MSIDCircuitBreaker *> *circuitBreakers = nil;
+    @synchronized (self)
+    {
+        circuitBreakers = [_circuitBreakers copy];
+    }
+    
+    NSMutableDictionary *snapshot = [NSMutableDictionary new];
+    for (NSString *key in circuitBreakers)
+    {
+        snapshot[key] = circuitBreakers[key].metrics;
+    }
+    
+    return snapshot;
+}
+
+- (void)reset
+{
+    @synchronized (self)
+    {
+        [_circuitBreakers removeAllObjects];
+    }
+}
+
+@end
@@ -36,6 +36,9 @@
 @class MSIDExternalSSOContext;
 @protocol MSIDHttpRequestInterceptorProtocol;
 @protocol MSIDHttpRequestHeaderValidating;
+@protocol MSIDHttpRequestRetryPolicy;
+@class MSIDCircuitBreakerRegistry;
+@class MSIDMetadataResponseCache;
 
 @interface MSIDHttpRequest : NSObject <MSIDHttpRequestProtocol>
 {
@@ -89,10 +92,32 @@
 @property (nonatomic) NSTimeInterval retryInterval;
 @property (nonatomic) NSTimeInterval requestTimeoutInterval;
 
+/*!
+ Per-request retry policy. When nil, retryCounter and retryInterval are used. By default a
+ MSIDExponentialBackoffRetryPolicy seeded from retryCountSetting and retryIntervalSetting is installed when
+ the MSID_FLIGHT_HTTP_RETRY_POLICY_ENABLED flight is on.
+ */
+@property (nonatomic, nullable) id<MSIDHttpRequestRetryPolicy> retryPolicy;
+
+/*!
+ Circuit breakers consulted before the request is sent. Requests to an endpoint whose breaker is open fail
+ immediately with MSIDServerUnavailableStatusKey and MSIDCircuitBreakerOpenKey set. Defaults to the shared
+ registry when the MSID_FLIGHT_HTTP_CIRCUIT_BREAKER_ENABLED flight is on, nil otherwise.
+ */
+@property (nonatomic, nullable) MSIDCircuitBreakerRegistry *circuitBreakerRegistry;
+
 @property (class, nonatomic, readwrite) NSInteger retryCountSetting;
 @property (class, nonatomic, readwrite) NSTimeInterval retryIntervalSetting;
 @property (class, nonatomic, readwrite) NSTimeInterval requestTimeoutInterval;
 
 @property (nonatomic, nonnull) NSURLCache *cache;
 
+/*!
+ Cache consulted when the request opts into response caching. Fresh entries are returned without a network call,
+ stale entries with validators are revalidated with a conditional request. Defaults to the shared metadata cache
+ when the MSID_FLIGHT_HTTP_METADATA_RESPONSE_CACHE_ENABLED flight is on, nil otherwise. When nil, responses are
+ cached in cache and served regardless of their freshness.
+ */
+@property (nonatomic, nullable) MSIDMetadataResponseCache *metadataCache;
+
 @end
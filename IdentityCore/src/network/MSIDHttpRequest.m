@@ -39,6 +39,13 @@
 #import "MSIDHttpRequestInterceptorProtocol.h"
 #import "MSIDHttpRequestHeaderValidator.h"
 #import "MSIDHttpRequestHeaderValidating.h"
+#import "MSIDExponentialBackoffRetryPolicy.h"
+#import "MSIDFlightManager.h"
+#import "MSIDConstants.h"
+#import "MSIDCircuitBreaker.h"
+#import "MSIDCircuitBreakerRegistry.h"
+#import "MSIDMetadataResponseCache.h"
+#import "MSIDTracer.h"
 
 static NSInteger s_retryCount = 1;
 static NSTimeInterval s_retryInterval = 0.5;
@@ -66,6 +73,21 @@ static NSTimeInterval s_requestTimeoutInterval = 300;
         _cache = [NSURLCache sharedURLCache];
         _shouldCacheResponse = NO;
         _headerValidator = [MSIDHttpRequestHeaderValidator new];
+        
+        if ([[MSIDFlightManager sharedInstance] boolForKey:MSID_FLIGHT_HTTP_RETRY_POLICY_ENABLED])
+        {
+            _retryPolicy = [[MSIDExponentialBackoffRetryPolicy alloc] initWithMaxRetries:s_retryCount baseDelay:s_retryInterval];
+        }
+        
+        if ([[MSIDFlightManager sharedInstance] boolForKey:MSID_FLIGHT_HTTP_METADATA_RESPONSE_CACHE_ENABLED])
+        {
+            _metadataCache = [MSIDMetadataResponseCache sharedCache];
+        }
+        
+        if ([[MSIDFlightManager sharedInstance] boolForKey:MSID_FLIGHT_HTTP_CIRCUIT_BREAKER_ENABLED])
+        {
+            _circuitBreakerRegistry = [MSIDCircuitBreakerRegistry sharedRegistry];
+        }
     }
 
     return self;
@@ -123,6 +145,37 @@ static NSTimeInterval s_requestTimeoutInterval = 300;
 - (void)sendRequestWithCompletionBlock:(MSIDHttpRequestDidCompleteBlock)completionBlock
 {
     NSCachedURLResponse *response = _shouldCacheResponse ? [self cachedResponse] : nil;
+    NSCachedURLResponse *revalidatingResponse = nil;
+    MSIDMetadataResponseCache *metadataCache = self.metadataCache;
+    
+    if (response && metadataCache && ![metadataCache isCachedResponseFresh:response])
+    {
+        NSDictionary<NSString *, NSString *> *conditionalHeaders = [metadataCache conditionalHeadersForCachedResponse:response];
+        if (conditionalHeaders.count)
+        {
+            NSMutableURLRequest *mutableRequest = [self.urlRequest mutableCopy];
+            for (NSString *field in conditionalHeaders)
+            {
+                [mutableRequest setValue:conditionalHeaders[field] forHTTPHeaderField:field];
+            }
+            
+            self.urlRequest = mutableRequest;
+            revalidatingResponse = response;
+            [metadataCache recordRevalidation];
+            MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, self.context, @"Cached response is stale, revalidating %@", _PII_NULLIFY(self.urlRequest.URL));
+        }
+        else
+        {
+            [metadataCache recordMiss];
+        }
+        
+        response = nil;
+    }
+    else if (!response && _shouldCacheResponse)
+    {
+        [metadataCache recordMiss];
+    }
+    
     if (response)
     {
         NSError *error = nil;
@@ -136,7 +189,8 @@ static NSTimeInterval s_requestTimeoutInterval = 300;
             MSIDExecutionFlowInsertTag([self toString:MSIDCacheResponseFailedObjectTag],
                                            nil,
                                            self.context.correlationId);
-            [self.cache removeCachedResponseForRequest:self.urlRequest];
+            [self removeCachedResponse];
+            [metadataCache recordMiss];
             MSID_LOG_WITH_CTX(MSIDLogLevelVerbose,self.context, @"Removing invalid response from cache %@, response: %@", _PII_NULLIFY(self.urlRequest), _PII_NULLIFY(response.response));
         }
         else
@@ -144,10 +198,26 @@ static NSTimeInterval s_requestTimeoutInterval = 300;
             MSIDExecutionFlowInsertTag([self toString:MSIDCacheResponseSucceededObjectTag],
                                            nil,
                                            self.context.correlationId);
+            [metadataCache recordHit];
             if (completionBlock) { completionBlock(responseObject, error); }
             return;
         }
     }
+    MSIDCircuitBreaker *circuitBreaker = [self.circuitBreakerRegistry circuitBreakerForURL:self.urlRequest.URL];
+    if (circuitBreaker && ![circuitBreaker allowRequest])
+    {
+        MSIDExecutionFlowInsertTag([self toString:MSIDCircuitBreakerOpenTag],
+                                       nil,
+                                       self.context.correlationId);
+        MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, self.context, @"Circuit breaker for %@ is open, failing request without sending it.", MSID_PII_LOG_TRACKABLE(self.urlRequest.URL.host));
+        
+        NSDictionary *userInfo = @{MSIDServerUnavailableStatusKey : @1,
+                                   MSIDCircuitBreakerOpenKey : @1};
+        NSError *circuitOpenError = MSIDCreateError(MSIDHttpErrorCodeDomain, MSIDErrorServerUnhandledResponse, @"Endpoint is temporarily unavailable, request was not sent.", nil, nil, nil, self.context.correlationId, userInfo, YES);
+        if (completionBlock) { completionBlock(nil, circuitOpenError); }
+        return;
+    }
+    
 #if !EXCLUDE_FROM_MSALCPP
     [self.telemetry sendRequestEventWithId:self.context.telemetryRequestId];
 #endif
@@ -155,8 +225,13 @@ static NSTimeInterval s_requestTimeoutInterval = 300;
 
     MSID_LOG_WITH_CTX(MSIDLogLevelVerbose,self.context, @"Sending network request: %@, headers: %@", _PII_NULLIFY(self.urlRequest), _PII_NULLIFY(self.urlRequest.allHTTPHeaderFields));
 
+    MSIDTraceSpan *networkSpan = MSIDTraceSpanStart(MSIDTraceSpanNetworkSend, self.context.correlationId);
+    
     [[self.sessionManager.session dataTaskWithRequest:self.urlRequest completionHandler:^(NSData *data, NSURLResponse *urlResponse, NSError *error)
       {
+        [networkSpan setAttribute:@(((NSHTTPURLResponse *)urlResponse).statusCode) forKey:@"status_code"];
+        [networkSpan setAttribute:error ? @(error.code) : nil forKey:@"error_code"];
+        MSIDTraceSpanEnd(networkSpan);
         MSIDExecutionFlowInsertTag([self toString:MSIDReceiveNetworkResponseTag],
                                        nil,
                                        self.context.correlationId);
@@ -165,6 +240,7 @@ static NSTimeInterval s_requestTimeoutInterval = 300;
           if (urlResponse) NSAssert([urlResponse isKindOfClass:NSHTTPURLResponse.class], NULL);
 
           __auto_type httpResponse = (NSHTTPURLResponse *)urlResponse;
+          [self recordOutcomeForCircuitBreaker:circuitBreaker httpResponse:httpResponse error:error];
 #if !EXCLUDE_FROM_MSALCPP
           [self.telemetry responseReceivedEventWithContext:self.context
                                                 urlRequest:self.urlRequest
@@ -210,9 +286,23 @@ static NSTimeInterval s_requestTimeoutInterval = 300;
                   if (completeBlockWrapper) completeBlockWrapper(nil, error);
               }
           }
+          else if (httpResponse.statusCode == 304 && revalidatingResponse)
+          {
+              NSCachedURLResponse *refreshedResponse = [metadataCache refreshCachedResponseForRequest:self.urlRequest withNotModifiedResponse:httpResponse] ?: revalidatingResponse;
+              id responseObject = [self.responseSerializer responseObjectForResponse:(NSHTTPURLResponse *)refreshedResponse.response
+                                                                                data:refreshedResponse.data
+                                                                             context:self.context
+                                                                               error:&error];
+              
+              MSID_LOG_WITH_CTX(MSIDLogLevelVerbose,self.context, @"Cached response was not modified, parsed response: %@, error %@", _PII_NULLIFY(responseObject), _PII_NULLIFY(error));
+              
+              if (completeBlockWrapper) completeBlockWrapper(responseObject, error);
+          }
           else if (httpResponse.statusCode == 200)
           {
+              MSIDTraceSpan *parseSpan = MSIDTraceSpanStart(MSIDTraceSpanResponseParse, self.context.correlationId);
               id responseObject = [self.responseSerializer responseObjectForResponse:httpResponse data:data context:self.context error:&error];
+              MSIDTraceSpanEnd(parseSpan);
 
               MSID_LOG_WITH_CTX(MSIDLogLevelVerbose,self.context, @"Parsed response: %@, error %@, error domain: %@, error code: %ld", _PII_NULLIFY(responseObject), _PII_NULLIFY(error), error.domain, (long)error.code);
 
@@ -260,16 +350,69 @@ static NSTimeInterval s_requestTimeoutInterval = 300;
 + (void)setRequestTimeoutInterval:(NSTimeInterval)requestTimeoutInterval { s_requestTimeoutInterval = requestTimeoutInterval; }
 + (NSTimeInterval)requestTimeoutInterval { return s_requestTimeoutInterval; }
 
+- (void)recordOutcomeForCircuitBreaker:(MSIDCircuitBreaker *)circuitBreaker
+                         httpResponse:(NSHTTPURLResponse *)httpResponse
+                                error:(NSError *)error
+{
+    if (!circuitBreaker) return;
+    
+    if (httpResponse)
+    {
+        // Any non-5xx answer means the endpoint is up, even if it rejected this particular request.
+        if (httpResponse.statusCode >= 500 && httpResponse.statusCode <= 599) [circuitBreaker recordFailure];
+        else [circuitBreaker recordSuccess];
+        return;
+    }
+    
+    if ([error.domain isEqualToString:NSURLErrorDomain])
+    {
+        switch (error.code)
+        {
+            case NSURLErrorTimedOut:
+            case NSURLErrorCannotFindHost:
+            case NSURLErrorCannotConnectToHost:
+            case NSURLErrorNetworkConnectionLost:
+            case NSURLErrorDNSLookupFailed:
+                [circuitBreaker recordFailure];
+                return;
+            default:
+                break;
+        }
+    }
+    
+    // Offline device, cancellation etc. say nothing about the endpoint.
+    [circuitBreaker recordIgnoredOutcome];
+}
+
 - (NSCachedURLResponse *)cachedResponse
 {
+    if (self.metadataCache) return [self.metadataCache cachedResponseForRequest:self.urlRequest];
+    
     return [self.cache cachedResponseForRequest:self.urlRequest];
 }
 
 - (void)setCachedResponse:(__unused NSCachedURLResponse *)cachedResponse forRequest:(__unused NSURLRequest *)request
 {
+    if (self.metadataCache)
+    {
+        [self.metadataCache storeCachedResponse:cachedResponse forRequest:request];
+        return;
+    }
+    
    [self.cache storeCachedResponse:cachedResponse forRequest:request];
 }
 
+- (void)removeCachedResponse
+{
+    if (self.metadataCache)
+    {
+        [self.metadataCache removeCachedResponseForRequest:self.urlRequest];
+        return;
+    }
+    
+    [self.cache removeCachedResponseForRequest:self.urlRequest];
+}
+
 - (NSString *)toString:(MSIDExecutionFlowNetworkTag)tag
 {
     return MSIDExecutionFlowNetworkTagToString(tag);
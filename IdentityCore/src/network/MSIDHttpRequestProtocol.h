@@ -23,6 +23,8 @@
 
 #import <Foundation/Foundation.h>
 
+@protocol MSIDHttpRequestRetryPolicy;
+
 typedef void (^MSIDHttpRequestDidCompleteBlock)(id response, NSError *error);
 
 @protocol MSIDHttpRequestProtocol <NSObject>
@@ -33,4 +35,9 @@ typedef void (^MSIDHttpRequestDidCompleteBlock)(id response, NSError *error);
 
 - (void)sendWithBlock:(MSIDHttpRequestDidCompleteBlock)completionBlock;
 
+@optional
+
+// When set, replaces retryCounter/retryInterval in deciding whether and when a failed request is retried.
+@property (nonatomic) id<MSIDHttpRequestRetryPolicy> retryPolicy;
+
 @end
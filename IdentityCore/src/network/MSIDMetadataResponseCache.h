@@ -0,0 +1,115 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+@class MSIDHttpRequest;
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface MSIDMetadataResponseCacheStatistics : NSObject
+
+// Fresh responses served without touching the network.
+@property (nonatomic, readonly) NSUInteger hitCount;
+// Lookups that found nothing usable and went to the network unconditionally.
+@property (nonatomic, readonly) NSUInteger missCount;
+// Lookups that found a stale response with validators and sent a conditional request.
+@property (nonatomic, readonly) NSUInteger revalidationCount;
+// Conditional requests answered with 304 Not Modified.
+@property (nonatomic, readonly) NSUInteger notModifiedCount;
+@property (nonatomic, readonly) NSUInteger evictionCount;
+
+@end
+
+/*!
+ Bounded, disk backed cache for GET responses of metadata endpoints (OpenID configuration, instance discovery,
+ DRS discovery and WebFinger). Unlike NSURLCache, freshness is evaluated here: Cache-Control max-age/no-cache/no-store,
+ Age and Expires are honoured, and stale responses carrying an ETag or Last-Modified validator are revalidated
+ with a conditional request instead of being fetched again.
+ 
+ Entries are indexed in memory and persisted one file per request URL, so metadata fetched in a previous app session
+ is available at start-up. Disk I/O happens on a private serial queue; lookups never wait for it. Persisted entries are
+ read in the background on first use, and a lookup made before they are in memory is a miss.
+ */
+@interface MSIDMetadataResponseCache : NSObject
+
+// nil for a memory-only cache.
+@property (nonatomic, readonly, nullable) NSURL *directoryURL;
+@property (nonatomic, readonly) NSUInteger maxEntryCount;
+@property (nonatomic, readonly) NSUInteger maxTotalBytes;
+
+// Freshness lifetime of responses that carry neither Cache-Control max-age nor Expires. Default: 24 hours.
+@property (nonatomic) NSTimeInterval defaultFreshnessLifetime;
+// Upper bound on any freshness lifetime advertised by the server. Default: 7 days.
+@property (nonatomic) NSTimeInterval maxFreshnessLifetime;
+// Current wall clock time, overridable in tests. Freshness is computed from HTTP dates, so this is not monotonic.
+@property (nonatomic, copy) NSDate *(^dateProvider)(void);
+
+@property (nonatomic, readonly) MSIDMetadataResponseCacheStatistics *statistics;
+// In-memory entries only, persisted entries are counted once loaded.
+@property (nonatomic, readonly) NSUInteger entryCount;
+@property (nonatomic, readonly) NSUInteger totalBytes;
+
++ (instancetype)sharedCache;
+
+- (instancetype)initWithDirectoryURL:(nullable NSURL *)directoryURL
+                       maxEntryCount:(NSUInteger)maxEntryCount
+                       maxTotalBytes:(NSUInteger)maxTotalBytes NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+// Returns the stored response regardless of its freshness, or nil. Only GET requests are cached.
+// Does not wait for persisted entries, see loadPersistedResponsesWithCompletionBlock:.
+- (nullable NSCachedURLResponse *)cachedResponseForRequest:(NSURLRequest *)request;
+// Responses marked no-store, non-200 responses and non-GET requests are ignored.
+- (void)storeCachedResponse:(NSCachedURLResponse *)cachedResponse forRequest:(NSURLRequest *)request;
+// Applies the headers of a 304 response to the stored entry, restarting its freshness lifetime.
+- (nullable NSCachedURLResponse *)refreshCachedResponseForRequest:(NSURLRequest *)request
+                                         withNotModifiedResponse:(NSHTTPURLResponse *)notModifiedResponse;
+- (void)removeCachedResponseForRequest:(NSURLRequest *)request;
+- (void)removeAllCachedResponses;
+
+- (BOOL)isCachedResponseFresh:(NSCachedURLResponse *)cachedResponse;
+// If-None-Match / If-Modified-Since headers for revalidating the response, empty if it has no validators.
+- (NSDictionary<NSString *, NSString *> *)conditionalHeadersForCachedResponse:(NSCachedURLResponse *)cachedResponse;
+
+- (void)recordHit;
+- (void)recordMiss;
+- (void)recordRevalidation;
+- (void)resetStatistics;
+
+// Reads persisted entries into memory on a background queue, the completion block runs once they are available.
+- (void)loadPersistedResponsesWithCompletionBlock:(nullable void (^)(void))completionBlock;
+
+/*!
+ Loads persisted entries on a background queue and then sends the given requests, which is a no-op for requests
+ that already have a fresh entry. Intended to be called once at app start for the endpoints the app will need.
+ */
+- (void)warmUpWithRequests:(NSArray<MSIDHttpRequest *> *)requests
+           completionBlock:(nullable void (^)(void))completionBlock;
+
+@end
+
+NS_ASSUME_NONNULL_END
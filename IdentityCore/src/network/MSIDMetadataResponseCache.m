@@ -0,0 +1,696 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDMetadataResponseCache.h"
+#import "MSIDHttpRequest.h"
+#import "NSData+MSIDExtensions.h"
+
+static NSString *const MSIDMetadataResponseCacheStoredDateKey = @"msid_stored_date";
+static NSString *const MSIDMetadataResponseCacheDirectoryName = @"com.microsoft.identitycore.metadata";
+
+static NSUInteger const MSIDMetadataResponseCacheDefaultMaxEntryCount = 64;
+static NSUInteger const MSIDMetadataResponseCacheDefaultMaxTotalBytes = 1024 * 1024;
+
+@interface MSIDMetadataResponseCacheStatistics () <NSCopying>
+
+@property (nonatomic) NSUInteger hitCount;
+@property (nonatomic) NSUInteger missCount;
+@property (nonatomic) NSUInteger revalidationCount;
+@property (nonatomic) NSUInteger notModifiedCount;
+@property (nonatomic) NSUInteger evictionCount;
+
+@end
+
+@implementation MSIDMetadataResponseCacheStatistics
+
+- (id)copyWithZone:(__unused NSZone *)zone
+{
+    MSIDMetadataResponseCacheStatistics *copy = [MSIDMetadataResponseCacheStatistics new];
+    copy.hitCount = self.hitCount;
+    copy.missCount = self.missCount;
+    copy.revalidationCount = self.revalidationCount;
+    copy.notModifiedCount = self.notModifiedCount;
+    copy.evictionCount = self.evictionCount;
+    return copy;
+}
+
+@end
+
+@interface MSIDMetadataResponseCacheEntry : NSObject
+
+@property (nonatomic) NSString *key;
+@property (nonatomic) NSCachedURLResponse *response;
+@property (nonatomic) NSUInteger byteCount;
+@property (nonatomic) uint64_t lastAccess;
+
+@end
+
+@implementation MSIDMetadataResponseCacheEntry
+@end
+
+@implementation MSIDMetadataResponseCache
+{
+    NSMutableDictionary<NSString *, MSIDMetadataResponseCacheEntry *> *_entries;
+    MSIDMetadataResponseCacheStatistics *_statistics;
+    NSUInteger _totalBytes;
+    uint64_t _accessCounter;
+    BOOL _loaded;
+    BOOL _loading;
+    // Bumped by removeAllCachedResponses, so a load started before it does not bring the removed entries back.
+    NSUInteger _generation;
+    // Keys removed while the persisted entries were being read, their files may still be part of the load.
+    NSMutableSet<NSString *> *_keysRemovedWhileLoading;
+    NSMutableArray<void (^)(void)> *_loadCompletionBlocks;
+    dispatch_queue_t _ioQueue;
+}
+
++ (instancetype)sharedCache
+{
+    static MSIDMetadataResponseCache *sharedCache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        // Scoped to the app like NSURLCache: on unsandboxed macOS every app of the user shares the caches directory.
+        // Without a bundle identifier there is nothing to scope by, so nothing is persisted.
+        NSString *appIdentifier = [[NSBundle mainBundle] bundleIdentifier];
+        NSURL *directoryURL = nil;
+        
+        if (appIdentifier.length)
+        {
+            NSURL *cachesURL = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+            directoryURL = [[cachesURL URLByAppendingPathComponent:appIdentifier isDirectory:YES] URLByAppendingPathComponent:MSIDMetadataResponseCacheDirectoryName isDirectory:YES];
+        }
+        
+        sharedCache = [[MSIDMetadataResponseCache alloc] initWithDirectoryURL:directoryURL
+                                                                maxEntryCount:MSIDMetadataResponseCacheDefaultMaxEntryCount
+                                                                maxTotalBytes:MSIDMetadataResponseCacheDefaultMaxTotalBytes];
+    });
+    
+    return sharedCache;
+}
+
+// Shared by all instances, so a cache opening a directory sees writes queued by another instance on the same directory.
++ (dispatch_queue_t)ioQueue
+{
+    static dispatch_queue_t ioQueue = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        ioQueue = dispatch_queue_create("com.microsoft.identitycore.metadataResponseCache", DISPATCH_QUEUE_SERIAL);
+    });
+    
+    return ioQueue;
+}
+
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL
+                       maxEntryCount:(NSUInteger)maxEntryCount
+                       maxTotalBytes:(NSUInteger)maxTotalBytes
+{
+    self = [super init];
+    if (self)
+    {
+        _directoryURL = directoryURL;
+        _maxEntryCount = maxEntryCount;
+        _maxTotalBytes = maxTotalBytes;
+        _defaultFreshnessLifetime = 24 * 60 * 60;
+        _maxFreshnessLifetime = 7 * 24 * 60 * 60;
+        _dateProvider = ^NSDate *{ return [NSDate date]; };
+        _entries = [NSMutableDictionary new];
+        _statistics = [MSIDMetadataResponseCacheStatistics new];
+        _ioQueue = [self.class ioQueue];
+        _keysRemovedWhileLoading = [NSMutableSet new];
+        _loadCompletionBlocks = [NSMutableArray new];
+        // Nothing on disk to load for a memory-only cache.
+        _loaded = directoryURL == nil;
+    }
+    
+    return self;
+}
+
+#pragma mark - Lookup
+
+- (NSCachedURLResponse *)cachedResponseForRequest:(NSURLRequest *)request
+{
+    NSString *key = [self keyForRequest:request];
+    if (!key) return nil;
+    
+    @synchronized (self)
+    {
+        // Until persisted entries are in memory only responses stored in this session are served, the rest is a miss.
+        [self startLoadingIfNeeded];
+        
+        MSIDMetadataResponseCacheEntry *entry = _entries[key];
+        entry.lastAccess = ++_accessCounter;
+        return entry.response;
+    }
+}
+
+- (void)storeCachedResponse:(NSCachedURLResponse *)cachedResponse forRequest:(NSURLRequest *)request
+{
+    NSString *key = [self keyForRequest:request];
+    if (!key) return;
+    
+    if (![cachedResponse.response isKindOfClass:NSHTTPURLResponse.class]) return;
+    
+    NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)cachedResponse.response;
+    if (httpResponse.statusCode != 200) return;
+    
+    NSDictionary *directives = [self cacheControlDirectivesForResponse:httpResponse];
+    if (directives[@"no-store"])
+    {
+        [self removeCachedResponseForRequest:request];
+        return;
+    }
+    
+    NSDate *storedDate = cachedResponse.userInfo[MSIDMetadataResponseCacheStoredDateKey] ?: self.dateProvider();
+    NSCachedURLResponse *responseToStore = [[NSCachedURLResponse alloc] initWithResponse:httpResponse
+                                                                                    data:cachedResponse.data
+                                                                                userInfo:@{MSIDMetadataResponseCacheStoredDateKey : storedDate}
+                                                                           storagePolicy:NSURLCacheStorageAllowed];
+    [self setResponse:responseToStore forKey:key persist:YES];
+}
+
+- (NSCachedURLResponse *)refreshCachedResponseForRequest:(NSURLRequest *)request
+                                withNotModifiedResponse:(NSHTTPURLResponse *)notModifiedResponse
+{
+    NSCachedURLResponse *cachedResponse = [self cachedResponseForRequest:request];
+    if (!cachedResponse) return nil;
+    
+    NSHTTPURLResponse *storedResponse = (NSHTTPURLResponse *)cachedResponse.response;
+    
+    // RFC 7232 4.1: a 304 carries the headers that would have been sent with a 200, which replace the stored ones.
+    NSMutableDictionary *headers = [storedResponse.allHeaderFields mutableCopy] ?: [NSMutableDictionary new];
+    for (NSString *field in @[@"Cache-Control", @"Expires", @"ETag", @"Last-Modified", @"Date", @"Age"])
+    {
+        NSString *value = [self valueForHeader:field inResponse:notModifiedResponse];
+        if (!value) continue;
+        
+        for (NSString *existingField in headers.allKeys)
+        {
+            if ([existingField caseInsensitiveCompare:field] == NSOrderedSame) [headers removeObjectForKey:existingField];
+        }
+        headers[field] = value;
+    }
+    
+    NSHTTPURLResponse *refreshedHttpResponse = [[NSHTTPURLResponse alloc] initWithURL:storedResponse.URL
+                                                                           statusCode:storedResponse.statusCode
+                                                                          HTTPVersion:nil
+                                                                         headerFields:headers];
+    NSCachedURLResponse *refreshedResponse = [[NSCachedURLResponse alloc] initWithResponse:refreshedHttpResponse
+                                                                                      data:cachedResponse.data
+                                                                                  userInfo:@{MSIDMetadataResponseCacheStoredDateKey : self.dateProvider()}
+                                                                             storagePolicy:NSURLCacheStorageAllowed];
+    
+    @synchronized (self)
+    {
+        self->_statistics.notModifiedCount++;
+    }
+    
+    [self setResponse:refreshedResponse forKey:[self keyForRequest:request] persist:YES];
+    return refreshedResponse;
+}
+
+- (void)removeCachedResponseForRequest:(NSURLRequest *)request
+{
+    NSString *key = [self keyForRequest:request];
+    if (!key) return;
+    
+    @synchronized (self)
+    {
+        if (_loading) [_keysRemovedWhileLoading addObject:key];
+        
+        [self removeEntryForKey:key deleteFile:NO];
+    }
+    
+    // The entry may only exist on disk if persisted entries are not loaded yet.
+    [self deleteFileForKey:key];
+}
+
+- (void)removeAllCachedResponses
+{
+    @synchronized (self)
+    {
+        [_entries removeAllObjects];
+        _totalBytes = 0;
+        _generation++;
+    }
+    
+    NSURL *directoryURL = self.directoryURL;
+    if (!directoryURL) return;
+    
+    dispatch_async(_ioQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtURL:directoryURL error:nil];
+    });
+}
+
+#pragma mark - Freshness
+
+- (BOOL)isCachedResponseFresh:(NSCachedURLResponse *)cachedResponse
+{
+    if (![cachedResponse.response isKindOfClass:NSHTTPURLResponse.class]) return NO;
+    
+    NSHTTPURLResponse *response = (NSHTTPURLResponse *)cachedResponse.response;
+    NSDate *storedDate = cachedResponse.userInfo[MSIDMetadataResponseCacheStoredDateKey];
+    if (!storedDate) return NO;
+    
+    NSDictionary *directives = [self cacheControlDirectivesForResponse:response];
+    if (directives[@"no-cache"]) return NO;
+    
+    NSTimeInterval lifetime = self.defaultFreshnessLifetime;
+    NSString *maxAge = directives[@"max-age"];
+    NSDate *expires = [self dateFromHTTPDateString:[self valueForHeader:@"Expires" inResponse:response]];
+    
+    if (maxAge)
+    {
+        lifetime = maxAge.doubleValue;
+    }
+    else if ([self valueForHeader:@"Expires" inResponse:response])
+    {
+        // An invalid Expires value, e.g. "0", means already expired.
+        NSDate *responseDate = [self dateFromHTTPDateString:[self valueForHeader:@"Date" inResponse:response]] ?: storedDate;
+        lifetime = expires ? [expires timeIntervalSinceDate:responseDate] : 0;
+    }
+    
+    lifetime = MIN(lifetime, self.maxFreshnessLifetime);
+    
+    NSTimeInterval initialAge = MAX([self valueForHeader:@"Age" inResponse:response].doubleValue, 0);
+    NSTimeInterval currentAge = initialAge + [self.dateProvider() timeIntervalSinceDate:storedDate];
+    
+    return currentAge < lifetime;
+}
+
+- (NSDictionary<NSString *, NSString *> *)conditionalHeadersForCachedResponse:(NSCachedURLResponse *)cachedResponse
+{
+    if (![cachedResponse.response isKindOfClass:NSHTTPURLResponse.class]) return @{};
+    
+    NSHTTPURLResponse *response = (NSHTTPURLResponse *)cachedResponse.response;
+    NSMutableDictionary *headers = [NSMutableDictionary new];
+    headers[@"If-None-Match"] = [self valueForHeader:@"ETag" inResponse:response];
+    headers[@"If-Modified-Since"] = [self valueForHeader:@"Last-Modified" inResponse:response];
+    return headers;
+}
+
+#pragma mark - Statistics
+
+- (MSIDMetadataResponseCacheStatistics *)statistics
+{
+    @synchronized (self)
+    {
+        return [_statistics copy];
+    }
+}
+
+- (NSUInteger)entryCount
+{
+    @synchronized (self)
+    {
+        return _entries.count;
+    }
+}
+
+- (NSUInteger)totalBytes
+{
+    @synchronized (self)
+    {
+        return _totalBytes;
+    }
+}
+
+- (void)recordHit
+{
+    @synchronized (self) { _statistics.hitCount++; }
+}
+
+- (void)recordMiss
+{
+    @synchronized (self) { _statistics.missCount++; }
+}
+
+- (void)recordRevalidation
+{
+    @synchronized (self) { _statistics.revalidationCount++; }
+}
+
+- (void)resetStatistics
+{
+    @synchronized (self)
+    {
+        _statistics = [MSIDMetadataResponseCacheStatistics new];
+    }
+}
+
+#pragma mark - Warm up
+
+- (void)warmUpWithRequests:(NSArray<MSIDHttpRequest *> *)requests
+           completionBlock:(void (^)(void))completionBlock
+{
+    [self loadPersistedResponsesWithCompletionBlock:^{
+        dispatch_group_t group = dispatch_group_create();
+        for (MSIDHttpRequest *request in requests)
+        {
+            dispatch_group_enter(group);
+            [request sendWithBlock:^(__unused id response, NSError *error)
+            {
+                if (error)
+                {
+                    MSID_LOG_WITH_CTX(MSIDLogLevelWarning, nil, @"Failed to warm up metadata cache, error %@", MSID_PII_LOG_MASKABLE(error));
+                }
+                
+                dispatch_group_leave(group);
+            }];
+        }
+        
+        dispatch_group_notify(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            if (completionBlock) completionBlock();
+        });
+    }];
+}
+
+#pragma mark - Private
+
+- (NSString *)keyForRequest:(NSURLRequest *)request
+{
+    if (request.HTTPMethod && ![request.HTTPMethod.uppercaseString isEqualToString:@"GET"]) return nil;
+    
+    return request.URL.absoluteString;
+}
+
+- (void)setResponse:(NSCachedURLResponse *)response forKey:(NSString *)key persist:(BOOL)persist
+{
+    if (!key) return;
+    
+    MSIDMetadataResponseCacheEntry *entry = [MSIDMetadataResponseCacheEntry new];
+    entry.key = key;
+    entry.response = response;
+    entry.byteCount = response.data.length;
+    
+    if (entry.byteCount > self.maxTotalBytes) return;
+    
+    @synchronized (self)
+    {
+        [self removeEntryForKey:key deleteFile:NO];
+        
+        entry.lastAccess = ++_accessCounter;
+        _entries[key] = entry;
+        _totalBytes += entry.byteCount;
+        
+        [self evictIfNeeded];
+    }
+    
+    if (persist) [self writeEntryToDisk:entry];
+}
+
+- (void)removeEntryForKey:(NSString *)key
+{
+    [self removeEntryForKey:key deleteFile:YES];
+}
+
+- (void)removeEntryForKey:(NSString *)key deleteFile:(BOOL)deleteFile
+{
+    MSIDMetadataResponseCacheEntry *entry = _entries[key];
+    if (!entry) return;
+    
+    _totalBytes -= entry.byteCount;
+    [_entries removeObjectForKey:key];
+    
+    if (deleteFile) [self deleteFileForKey:key];
+}
+
+- (void)evictIfNeeded
+{
+    while (_entries.count > self.maxEntryCount || _totalBytes > self.maxTotalBytes)
+    {
+        MSIDMetadataResponseCacheEntry *leastRecentlyUsed = nil;
+        for (MSIDMetadataResponseCacheEntry *entry in _entries.objectEnumerator)
+        {
+            if (!leastRecentlyUsed || entry.lastAccess < leastRecentlyUsed.lastAccess) leastRecentlyUsed = entry;
+        }
+        
+        if (!leastRecentlyUsed) break;
+        
+        [self removeEntryForKey:leastRecentlyUsed.key];
+        _statistics.evictionCount++;
+    }
+}
+
+- (NSDictionary<NSString *, NSString *> *)cacheControlDirectivesForResponse:(NSHTTPURLResponse *)response
+{
+    NSString *cacheControl = [self valueForHeader:@"Cache-Control" inResponse:response];
+    if (!cacheControl) return @{};
+    
+    NSMutableDictionary *directives = [NSMutableDictionary new];
+    for (NSString *component in [cacheControl componentsSeparatedByString:@","])
+    {
+        NSArray<NSString *> *parts = [component componentsSeparatedByString:@"="];
+        NSString *name = [parts.firstObject msidTrimmedString].lowercaseString;
+        if (!name.length) continue;
+        
+        NSString *value = parts.count > 1 ? [[parts[1] msidTrimmedString] stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"\""]] : @"";
+        directives[name] = value;
+    }
+    
+    return directives;
+}
+
+- (NSString *)valueForHeader:(NSString *)header inResponse:(NSHTTPURLResponse *)response
+{
+    NSDictionary *headers = response.allHeaderFields;
+    
+    NSString *value = headers[header];
+    if (value) return value;
+    
+    for (NSString *field in headers)
+    {
+        if ([field caseInsensitiveCompare:header] == NSOrderedSame) return headers[field];
+    }
+    
+    return nil;
+}
+
+- (NSDate *)dateFromHTTPDateString:(NSString *)dateString
+{
+    if (!dateString) return nil;
+    
+    static NSDateFormatter *s_httpDateFormatter = nil;
+    static dispatch_once_t s_httpDateOnce;
+    
+    dispatch_once(&s_httpDateOnce, ^{
+        s_httpDateFormatter = [NSDateFormatter new];
+        s_httpDateFormatter.locale = [[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"];
+        s_httpDateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
+        s_httpDateFormatter.dateFormat = @"EEE, dd MMM yyyy HH:mm:ss zzz";
+    });
+    
+    @synchronized (s_httpDateFormatter)
+    {
+        return [s_httpDateFormatter dateFromString:dateString];
+    }
+}
+
+#pragma mark - Persistence
+
++ (NSString *)fileNameForKey:(NSString *)key
+{
+    return [[[key dataUsingEncoding:NSUTF8StringEncoding] msidSHA256] msidHexString];
+}
+
+- (NSURL *)fileURLForKey:(NSString *)key
+{
+    return [self.directoryURL URLByAppendingPathComponent:[self.class fileNameForKey:key] isDirectory:NO];
+}
+
+- (void)writeEntryToDisk:(MSIDMetadataResponseCacheEntry *)entry
+{
+    if (!self.directoryURL) return;
+    
+    NSHTTPURLResponse *response = (NSHTTPURLResponse *)entry.response.response;
+    NSDictionary *record = @{@"key" : entry.key,
+                             @"url" : response.URL.absoluteString ?: entry.key,
+                             @"status" : @(response.statusCode),
+                             @"headers" : response.allHeaderFields ?: @{},
+                             @"data" : entry.response.data ?: [NSData data],
+                             @"stored" : entry.response.userInfo[MSIDMetadataResponseCacheStoredDateKey],
+                             @"digest" : [entry.response.data ?: [NSData data] msidSHA256]};
+    NSURL *fileURL = [self fileURLForKey:entry.key];
+    NSURL *directoryURL = self.directoryURL;
+    
+    dispatch_async(_ioQueue, ^{
+        NSError *error = nil;
+        NSData *serialized = [NSPropertyListSerialization dataWithPropertyList:record format:NSPropertyListBinaryFormat_v1_0 options:0 error:&error];
+        
+        if (serialized)
+        {
+            [[NSFileManager defaultManager] createDirectoryAtURL:directoryURL withIntermediateDirectories:YES attributes:@{NSFilePosixPermissions : @(0700)} error:nil];
+            [serialized writeToURL:fileURL options:NSDataWritingAtomic error:&error];
+        }
+        
+        if (error)
+        {
+            MSID_LOG_WITH_CTX(MSIDLogLevelWarning, nil, @"Failed to persist metadata response, error %@", MSID_PII_LOG_MASKABLE(error));
+        }
+    });
+}
+
+- (void)deleteFileForKey:(NSString *)key
+{
+    if (!self.directoryURL) return;
+    
+    NSURL *fileURL = [self fileURLForKey:key];
+    dispatch_async(_ioQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+    });
+}
+
+// Must be called under @synchronized (self).
+- (void)startLoadingIfNeeded
+{
+    if (_loaded || _loading) return;
+    _loading = YES;
+    
+    NSUInteger generation = _generation;
+    NSURL *directoryURL = self.directoryURL;
+    
+    // The I/O queue is serial, so writes queued before this point land first and are part of the load.
+    dispatch_async(_ioQueue, ^{
+        NSArray<MSIDMetadataResponseCacheEntry *> *entries = [self.class readEntriesFromDirectory:directoryURL];
+        NSArray<void (^)(void)> *completionBlocks = nil;
+        
+        @synchronized (self)
+        {
+            if (generation == self->_generation)
+            {
+                [self mergeLoadedEntries:entries];
+            }
+            
+            [self->_keysRemovedWhileLoading removeAllObjects];
+            self->_loading = NO;
+            self->_loaded = YES;
+            
+            completionBlocks = [self->_loadCompletionBlocks copy];
+            [self->_loadCompletionBlocks removeAllObjects];
+        }
+        
+        MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, nil, @"Loaded %lu persisted metadata responses.", (unsigned long)entries.count);
+        
+        for (void (^completionBlock)(void) in completionBlocks)
+        {
+            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), completionBlock);
+        }
+    });
+}
+
+- (void)loadPersistedResponsesWithCompletionBlock:(void (^)(void))completionBlock
+{
+    void (^block)(void) = completionBlock ?: ^{};
+    
+    @synchronized (self)
+    {
+        if (_loaded)
+        {
+            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), block);
+            return;
+        }
+        
+        [_loadCompletionBlocks addObject:block];
+        [self startLoadingIfNeeded];
+    }
+}
+
+// Must be called under @synchronized (self). Responses stored in this session are newer than the persisted ones and win.
+- (void)mergeLoadedEntries:(NSArray<MSIDMetadataResponseCacheEntry *> *)entries
+{
+    for (MSIDMetadataResponseCacheEntry *entry in entries)
+    {
+        if (_entries[entry.key] || [_keysRemovedWhileLoading containsObject:entry.key]) continue;
+        
+        entry.lastAccess = ++_accessCounter;
+        _entries[entry.key] = entry;
+        _totalBytes += entry.byteCount;
+    }
+    
+    [self evictIfNeeded];
+}
+
+// Runs on the I/O queue.
++ (NSArray<MSIDMetadataResponseCacheEntry *> *)readEntriesFromDirectory:(NSURL *)directoryURL
+{
+    NSArray<NSURL *> *fileURLs = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:directoryURL
+                                                               includingPropertiesForKeys:nil
+                                                                                  options:NSDirectoryEnumerationSkipsHiddenFiles
+                                                                                    error:nil];
+    NSMutableArray<MSIDMetadataResponseCacheEntry *> *entries = [NSMutableArray new];
+    for (NSURL *fileURL in fileURLs)
+    {
+        NSData *serialized = [NSData dataWithContentsOfURL:fileURL];
+        NSDictionary *record = serialized ? [NSPropertyListSerialization propertyListWithData:serialized options:NSPropertyListImmutable format:nil error:nil] : nil;
+        if (![record isKindOfClass:NSDictionary.class]) record = nil;
+        
+        NSString *key = record[@"key"];
+        NSURL *url = [record[@"url"] isKindOfClass:NSString.class] ? [NSURL URLWithString:record[@"url"]] : nil;
+        NSDate *storedDate = record[@"stored"];
+        NSData *data = record[@"data"];
+        
+        if (![key isKindOfClass:NSString.class] || !url || ![storedDate isKindOfClass:NSDate.class] || ![data isKindOfClass:NSData.class]
+            || ![self isRecord:record withKey:key url:url data:data storedInFile:fileURL])
+        {
+            MSID_LOG_WITH_CTX(MSIDLogLevelWarning, nil, @"Discarding invalid persisted metadata response.");
+            [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+            continue;
+        }
+        
+        NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:url
+                                                                  statusCode:[record[@"status"] integerValue]
+                                                                 HTTPVersion:nil
+                                                                headerFields:record[@"headers"]];
+        // Keyed like the request that stored it, the response URL can differ from the request URL after a redirect.
+        MSIDMetadataResponseCacheEntry *entry = [MSIDMetadataResponseCacheEntry new];
+        entry.key = key;
+        entry.response = [[NSCachedURLResponse alloc] initWithResponse:response
+                                                                  data:data
+                                                              userInfo:@{MSIDMetadataResponseCacheStoredDateKey : storedDate}
+                                                         storagePolicy:NSURLCacheStorageAllowed];
+        entry.byteCount = data.length;
+        [entries addObject:entry];
+    }
+    
+    return entries;
+}
+
+// Rejects records that were corrupted, renamed or written for a different request than their file name says.
++ (BOOL)isRecord:(NSDictionary *)record
+         withKey:(NSString *)key
+             url:(NSURL *)url
+            data:(NSData *)data
+    storedInFile:(NSURL *)fileURL
+{
+    if (![fileURL.lastPathComponent isEqualToString:[self fileNameForKey:key]]) return NO;
+    
+    NSURL *requestURL = [NSURL URLWithString:key];
+    if (![requestURL.scheme.lowercaseString isEqualToString:@"https"] || !url.host || [requestURL.host caseInsensitiveCompare:url.host] != NSOrderedSame) return NO;
+    
+    if ([record[@"status"] integerValue] != 200 || ![record[@"headers"] isKindOfClass:NSDictionary.class]) return NO;
+    
+    NSData *digest = record[@"digest"];
+    return [digest isKindOfClass:NSData.class] && [digest isEqualToData:[data msidSHA256]];
+}
+
+@end
@@ -31,6 +31,7 @@
 #import "MSIDMainThreadUtil.h"
 #import "MSIDExecutionFlowLogger.h"
 #import "MSIDExecutionFlowConstants.h"
+#import "MSIDHttpRequestRetryPolicy.h"
 
 @implementation MSIDAADRequestErrorHandler
 
@@ -43,33 +44,41 @@
             context:(id<MSIDRequestContext>)context
     completionBlock:(MSIDHttpRequestDidCompleteBlock)completionBlock
 {
-    BOOL shouldRetry = YES;
-    shouldRetry &= httpRequest.retryCounter > 0;
+    id<MSIDHttpRequestRetryPolicy> retryPolicy = [httpRequest respondsToSelector:@selector(retryPolicy)] ? httpRequest.retryPolicy : nil;
+    
+    BOOL isTransientFailure = NO;
     if (!httpResponse)
     {
-        BOOL shouldRetryNetworkingFailure = NO;
-        if (shouldRetry && error)
-        {
-            // Networking errors (-1001, -1003. -1004. -1005. -1009)
-            shouldRetryNetworkingFailure = [MSIDAADRequestErrorHandler shouldRetryNetworkingFailure:error.code];
-            if (shouldRetryNetworkingFailure && error.code == NSURLErrorNotConnectedToInternet)
-            {
-                // For handling the NSURLErrorNotConnectedToInternet error, retry the network request after a longer delay.
-                httpRequest.retryInterval = 2.0;
-            }
-        }
-
-        shouldRetry &= shouldRetryNetworkingFailure;
-        if (!shouldRetry)
-        {
-            if (completionBlock) completionBlock(nil, error);
-            return;
-        }
+        // Networking errors (-1001, -1003. -1004. -1005. -1009)
+        isTransientFailure = error && [MSIDAADRequestErrorHandler shouldRetryNetworkingFailure:error.code];
     }
     else
     {
         // 5xx Server errors.
-        if (shouldRetry) shouldRetry &= httpResponse.statusCode >= 500 && httpResponse.statusCode <= 599;
+        isTransientFailure = httpResponse.statusCode >= 500 && httpResponse.statusCode <= 599;
+    }
+    
+    BOOL shouldRetry = NO;
+    NSTimeInterval retryDelay = 0;
+    if (isTransientFailure && retryPolicy)
+    {
+        shouldRetry = [retryPolicy shouldRetryRequest:httpRequest.urlRequest
+                                         httpResponse:httpResponse
+                                                error:error
+                                              context:context
+                                           retryDelay:&retryDelay];
+    }
+    else if (isTransientFailure && httpRequest.retryCounter > 0)
+    {
+        if (!httpResponse && error.code == NSURLErrorNotConnectedToInternet)
+        {
+            // For handling the NSURLErrorNotConnectedToInternet error, retry the network request after a longer delay.
+            httpRequest.retryInterval = 2.0;
+        }
+        
+        httpRequest.retryCounter--;
+        retryDelay = httpRequest.retryInterval;
+        shouldRetry = YES;
     }
     
     if (shouldRetry)
@@ -77,11 +86,10 @@
         MSIDExecutionFlowInsertTag(MSIDExecutionFlowNetworkTagToString(MSIDRetryOnNetworkFailureTag),
                                        nil,
                                        context.correlationId);
-        httpRequest.retryCounter--;
         
-        MSID_LOG_WITH_CTX(MSIDLogLevelVerbose,context, @"Retrying network request, retryCounter: %ld", (long)httpRequest.retryCounter);
+        MSID_LOG_WITH_CTX(MSIDLogLevelVerbose,context, @"Retrying network request, retryCounter: %ld, delay: %.2f", (long)httpRequest.retryCounter, retryDelay);
         
-        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(httpRequest.retryInterval * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(retryDelay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
             MSIDExecutionFlowInsertTag(MSIDExecutionFlowNetworkTagToString(MSIDStartToRetryOnNetworkFailureTag),
                                            nil,
                                            context.correlationId);
@@ -91,6 +99,12 @@
         return;
     }
     
+    if (!httpResponse)
+    {
+        if (completionBlock) completionBlock(nil, error);
+        return;
+    }
+    
     // pkeyauth challenge
     if (httpResponse.statusCode == 400 || httpResponse.statusCode == 401)
     {
@@ -0,0 +1,66 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+#import "MSIDHttpRequestRetryPolicy.h"
+
+@class MSIDRetryBudget;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ Exponential backoff with decorrelated jitter: each delay is drawn uniformly from [baseDelay, 3 * previousDelay]
+ and capped at maxDelay, so clients that failed at the same moment spread out instead of retrying in lockstep.
+
+ A Retry-After header on the response sets the minimum delay. A Retry-After longer than maxRetryAfterDelay is
+ not waited out in-process: the request fails and the throttling service records the server's instruction
+ (see MSIDThrottlingModel429).
+
+ Every retry also takes a token from retryBudget, shared per endpoint by default.
+ */
+@interface MSIDExponentialBackoffRetryPolicy : NSObject <MSIDHttpRequestRetryPolicy>
+
+@property (nonatomic, readonly) NSInteger maxRetries;
+@property (nonatomic, readonly) NSTimeInterval baseDelay;
+@property (nonatomic) NSTimeInterval maxDelay;
+@property (nonatomic) NSTimeInterval maxRetryAfterDelay;
+// Minimum delay before retrying a request that failed because the device is offline.
+@property (nonatomic) NSTimeInterval offlineRetryDelay;
+// When nil, the budget shared by all requests to the same endpoint is used.
+@property (nonatomic, nullable) MSIDRetryBudget *retryBudget;
+// Returns a value in [0, 1). Replaceable for deterministic tests and simulations.
+@property (nonatomic, copy) double (^randomGenerator)(void);
+
+@property (nonatomic, readonly) NSInteger retryCount;
+@property (nonatomic, readonly) NSTimeInterval lastRetryDelay;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+- (instancetype)initWithMaxRetries:(NSInteger)maxRetries
+                         baseDelay:(NSTimeInterval)baseDelay NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
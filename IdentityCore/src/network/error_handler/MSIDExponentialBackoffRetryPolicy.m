@@ -0,0 +1,119 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDExponentialBackoffRetryPolicy.h"
+#import "MSIDRetryBudget.h"
+#import "NSDate+MSIDExtensions.h"
+
+static NSTimeInterval const MSIDRetryPolicyDefaultMaxDelay = 8.0;
+static NSTimeInterval const MSIDRetryPolicyDefaultMaxRetryAfterDelay = 10.0;
+static NSTimeInterval const MSIDRetryPolicyDefaultOfflineRetryDelay = 2.0;
+
+@interface MSIDExponentialBackoffRetryPolicy ()
+
+@property (nonatomic, readwrite) NSInteger retryCount;
+@property (nonatomic, readwrite) NSTimeInterval lastRetryDelay;
+
+@end
+
+@implementation MSIDExponentialBackoffRetryPolicy
+
+- (instancetype)initWithMaxRetries:(NSInteger)maxRetries
+                         baseDelay:(NSTimeInterval)baseDelay
+{
+    self = [super init];
+    if (self)
+    {
+        _maxRetries = MAX(maxRetries, 0);
+        _baseDelay = MAX(baseDelay, 0);
+        _maxDelay = MAX(MSIDRetryPolicyDefaultMaxDelay, _baseDelay);
+        _maxRetryAfterDelay = MSIDRetryPolicyDefaultMaxRetryAfterDelay;
+        _offlineRetryDelay = MSIDRetryPolicyDefaultOfflineRetryDelay;
+        _randomGenerator = ^double {
+            return (double)arc4random_uniform(UINT32_MAX) / (double)UINT32_MAX;
+        };
+    }
+    
+    return self;
+}
+
+#pragma mark - MSIDHttpRequestRetryPolicy
+
+- (BOOL)shouldRetryRequest:(NSURLRequest *)urlRequest
+              httpResponse:(NSHTTPURLResponse *)httpResponse
+                     error:(NSError *)error
+                   context:(id<MSIDRequestContext>)context
+                retryDelay:(NSTimeInterval *)retryDelay
+{
+    if (self.retryCount >= self.maxRetries)
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, context, @"Retry policy: retry limit %ld reached.", (long)self.maxRetries);
+        return NO;
+    }
+    
+    NSTimeInterval delay = [self nextBackoffDelay];
+    
+    if (!httpResponse && error.code == NSURLErrorNotConnectedToInternet)
+    {
+        delay = MAX(delay, self.offlineRetryDelay);
+    }
+    
+    NSDate *retryAfterDate = [NSDate msidDateFromRetryHeader:httpResponse.allHeaderFields[@"Retry-After"]];
+    if (retryAfterDate)
+    {
+        NSTimeInterval retryAfter = [retryAfterDate timeIntervalSinceNow];
+        if (retryAfter > self.maxRetryAfterDelay)
+        {
+            MSID_LOG_WITH_CTX(MSIDLogLevelInfo, context, @"Retry policy: Retry-After %.1fs exceeds %.1fs, not retrying in-process.", retryAfter, self.maxRetryAfterDelay);
+            return NO;
+        }
+        
+        delay = MAX(delay, retryAfter);
+    }
+    
+    MSIDRetryBudget *budget = self.retryBudget ?: [MSIDRetryBudget sharedBudgetForURL:urlRequest.URL];
+    if (![budget tryConsumeToken])
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelWarning, context, @"Retry policy: retry budget for endpoint exhausted, not retrying.");
+        return NO;
+    }
+    
+    self.retryCount += 1;
+    self.lastRetryDelay = delay;
+    if (retryDelay) *retryDelay = delay;
+    return YES;
+}
+
+#pragma mark - Private
+
+- (NSTimeInterval)nextBackoffDelay
+{
+    // Decorrelated jitter, see https://aws.amazon.com/blogs/architecture/exponential-backoff-and-jitter/
+    NSTimeInterval previousDelay = self.lastRetryDelay > 0 ? self.lastRetryDelay : self.baseDelay;
+    NSTimeInterval upperBound = MAX(previousDelay * 3, self.baseDelay);
+    NSTimeInterval delay = self.baseDelay + self.randomGenerator() * (upperBound - self.baseDelay);
+    return MIN(delay, self.maxDelay);
+}
+
+@end
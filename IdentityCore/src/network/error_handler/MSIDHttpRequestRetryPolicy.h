@@ -0,0 +1,49 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+@protocol MSIDRequestContext;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ Decides whether and when a failed MSIDHttpRequest is sent again. A policy object belongs to a single request
+ and may keep per-request state (attempt count, previous delay) across retries of that request.
+ */
+@protocol MSIDHttpRequestRetryPolicy <NSObject>
+
+/*!
+ Called by the error handler after it has classified a failure as transient (networking failure or 5xx).
+ Returns YES and sets retryDelay when the request should be sent again after that delay.
+ */
+- (BOOL)shouldRetryRequest:(NSURLRequest *)urlRequest
+              httpResponse:(nullable NSHTTPURLResponse *)httpResponse
+                     error:(nullable NSError *)error
+                   context:(nullable id<MSIDRequestContext>)context
+                retryDelay:(NSTimeInterval *)retryDelay;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,64 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ Token bucket limiting how many retries may be issued against an endpoint. Every retry takes one token, tokens
+ refill at a fixed rate up to the capacity. When an endpoint is failing for everybody the bucket drains and
+ further failures are surfaced immediately instead of adding another retry wave.
+ */
+@interface MSIDRetryBudget : NSObject
+
+@property (nonatomic, readonly) double capacity;
+@property (nonatomic, readonly) double refillRatePerSecond;
+@property (nonatomic, readonly) double availableTokens;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+- (instancetype)initWithCapacity:(double)capacity
+             refillRatePerSecond:(double)refillRatePerSecond NS_DESIGNATED_INITIALIZER;
+
+// Takes a token if one is available.
+- (BOOL)tryConsumeToken;
+
+/*!
+ Budget shared by all requests to the same kind of endpoint on a host (scheme, host, port and endpoint kind, e.g.
+ token or instance discovery). Tenants share the budget of their authority host. For endpoints of no known kind the
+ path without its first (tenant) segment is used. The query is ignored.
+ */
++ (MSIDRetryBudget *)sharedBudgetForURL:(NSURL *)url;
+
+// Capacity and refill rate used for budgets created by sharedBudgetForURL:.
+@property (class, nonatomic) double sharedBudgetCapacity;
+@property (class, nonatomic) double sharedBudgetRefillRatePerSecond;
+
++ (void)resetSharedBudgets;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,165 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDRetryBudget.h"
+#import "MSIDCircuitBreakerRegistry.h"
+
+static double s_sharedBudgetCapacity = 10;
+static double s_sharedBudgetRefillRatePerSecond = 0.1;
+static NSMutableDictionary<NSString *, MSIDRetryBudget *> *s_sharedBudgets = nil;
+
+@implementation MSIDRetryBudget
+{
+    double _tokens;
+    NSTimeInterval _lastRefillTime;
+}
+
+- (instancetype)initWithCapacity:(double)capacity
+             refillRatePerSecond:(double)refillRatePerSecond
+{
+    self = [super init];
+    if (self)
+    {
+        _capacity = MAX(capacity, 0);
+        _refillRatePerSecond = MAX(refillRatePerSecond, 0);
+        _tokens = _capacity;
+        _lastRefillTime = [self currentTime];
+    }
+    
+    return self;
+}
+
+- (double)availableTokens
+{
+    @synchronized (self)
+    {
+        [self refill];
+        return _tokens;
+    }
+}
+
+- (BOOL)tryConsumeToken
+{
+    @synchronized (self)
+    {
+        [self refill];
+        if (_tokens < 1) return NO;
+        
+        _tokens -= 1;
+        return YES;
+    }
+}
+
+#pragma mark - Shared budgets
+
++ (MSIDRetryBudget *)sharedBudgetForURL:(NSURL *)url
+{
+    NSString *key = [self budgetKeyForURL:url];
+    
+    @synchronized (self)
+    {
+        if (!s_sharedBudgets) s_sharedBudgets = [NSMutableDictionary new];
+        
+        MSIDRetryBudget *budget = s_sharedBudgets[key];
+        if (!budget)
+        {
+            budget = [[MSIDRetryBudget alloc] initWithCapacity:s_sharedBudgetCapacity refillRatePerSecond:s_sharedBudgetRefillRatePerSecond];
+            s_sharedBudgets[key] = budget;
+        }
+        
+        return budget;
+    }
+}
+
++ (double)sharedBudgetCapacity
+{
+    @synchronized (self) { return s_sharedBudgetCapacity; }
+}
+
++ (void)setSharedBudgetCapacity:(double)sharedBudgetCapacity
+{
+    @synchronized (self) { s_sharedBudgetCapacity = sharedBudgetCapacity; }
+}
+
++ (double)sharedBudgetRefillRatePerSecond
+{
+    @synchronized (self) { return s_sharedBudgetRefillRatePerSecond; }
+}
+
++ (void)setSharedBudgetRefillRatePerSecond:(double)sharedBudgetRefillRatePerSecond
+{
+    @synchronized (self) { s_sharedBudgetRefillRatePerSecond = sharedBudgetRefillRatePerSecond; }
+}
+
++ (void)resetSharedBudgets
+{
+    @synchronized (self)
+    {
+        [s_sharedBudgets removeAllObjects];
+    }
+}
+
+#pragma mark - Private
+
++ (NSString *)budgetKeyForURL:(NSURL *)url
+{
+    NSURLComponents *components = [NSURLComponents componentsWithURL:url resolvingAgainstBaseURL:NO];
+    NSString *origin = [NSString stringWithFormat:@"%@://%@:%@",
+                        components.scheme.lowercaseString ?: @"",
+                        components.host.lowercaseString ?: @"",
+                        components.port ?: @""];
+    
+    // Keyed on the endpoint kind rather than the path, so that all tenants of an authority host share one budget.
+    MSIDCircuitBreakerEndpointClass endpointClass = [MSIDCircuitBreakerRegistry endpointClassForURL:url];
+    if (endpointClass != MSIDCircuitBreakerEndpointClassNone)
+    {
+        return [NSString stringWithFormat:@"%@|%ld", origin, (long)endpointClass];
+    }
+    
+    // Other endpoints are keyed on their path without the leading tenant segment.
+    NSArray<NSString *> *pathComponents = components.path.lowercaseString.pathComponents;
+    NSString *path = @"";
+    if (pathComponents.count > 2)
+    {
+        path = [NSString pathWithComponents:[pathComponents subarrayWithRange:NSMakeRange(2, pathComponents.count - 2)]];
+    }
+    
+    return [NSString stringWithFormat:@"%@|%@", origin, path];
+}
+
+- (NSTimeInterval)currentTime
+{
+    // Monotonic, not affected by wall clock changes.
+    return [NSProcessInfo processInfo].systemUptime;
+}
+
+- (void)refill
+{
+    NSTimeInterval now = [self currentTime];
+    NSTimeInterval elapsed = MAX(now - _lastRefillTime, 0);
+    _lastRefillTime = now;
+    _tokens = MIN(_capacity, _tokens + elapsed * _refillRatePerSecond);
+}
+
+@end
@@ -62,6 +62,8 @@
         [requestConfigurator configure:self];
         
         _responseSerializer = [MSIDDRSDiscoveryResponseSerializer new];
+        // NSURLCache would serve the response regardless of its freshness, so only cache it in the metadata cache.
+        _shouldCacheResponse = self.metadataCache != nil;
     }
     
     return self;
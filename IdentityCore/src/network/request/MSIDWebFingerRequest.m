@@ -46,6 +46,8 @@
         urlRequest.URL = [NSURL URLWithString:[NSString stringWithFormat:@"https://%@/.well-known/webfinger", issuer.host]];
         urlRequest.HTTPMethod = @"GET";
         _urlRequest = urlRequest;
+        // NSURLCache would serve the response regardless of its freshness, so only cache it in the metadata cache.
+        _shouldCacheResponse = self.metadataCache != nil;
     }
     
     return self;
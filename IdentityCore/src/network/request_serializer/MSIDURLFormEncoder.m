@@ -0,0 +1,240 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDURLFormEncoder.h"
+
+// Characters that are written as is: ASCII alphanumerics and "-._~". Non-ASCII characters are checked against
+// alphanumericCharacterSet, the same set msidURLEncode uses.
+static BOOL s_unreservedASCII[128];
+static const char s_hexDigits[] = "0123456789ABCDEF";
+
+@implementation MSIDURLFormEncoder
+
++ (void)initialize
+{
+    if (self != [MSIDURLFormEncoder class]) return;
+    
+    for (unsigned char c = 0; c < 128; c++)
+    {
+        s_unreservedASCII[c] = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                               || c == '-' || c == '.' || c == '_' || c == '~';
+    }
+}
+
++ (NSData *)formURLEncodedDataWithParameters:(NSDictionary *)parameters
+{
+    NSMutableArray<NSString *> *keys = [NSMutableArray arrayWithCapacity:parameters.count];
+    NSMutableArray<NSString *> *values = [NSMutableArray arrayWithCapacity:parameters.count];
+    NSUInteger estimatedLength = [self collectKeys:keys values:values fromParameters:parameters];
+    
+    // Most parameters are ASCII with few reserved characters, reserve a little more than the raw length up front.
+    NSMutableData *data = [NSMutableData dataWithCapacity:estimatedLength + estimatedLength / 4];
+    [self appendKeys:keys values:values toData:data formEncode:YES];
+    return data;
+}
+
++ (NSString *)percentEncodedQueryWithParameters:(NSDictionary *)parameters
+{
+    NSMutableData *data = [NSMutableData new];
+    [self appendParameters:parameters toData:data formEncode:NO];
+    
+    if (!data.length) return nil;
+    
+    return [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+}
+
++ (void)appendParameters:(NSDictionary *)parameters
+                  toData:(NSMutableData *)data
+              formEncode:(BOOL)formEncode
+{
+    NSMutableArray<NSString *> *keys = [NSMutableArray arrayWithCapacity:parameters.count];
+    NSMutableArray<NSString *> *values = [NSMutableArray arrayWithCapacity:parameters.count];
+    [self collectKeys:keys values:values fromParameters:parameters];
+    [self appendKeys:keys values:values toData:data formEncode:formEncode];
+}
+
+#pragma mark - Private
+
+// Fills keys and values with the trimmed parameters in ascending key order, returns their total length.
++ (NSUInteger)collectKeys:(NSMutableArray<NSString *> *)keys
+                   values:(NSMutableArray<NSString *> *)values
+           fromParameters:(NSDictionary *)parameters
+{
+    NSUInteger totalLength = 0;
+    NSArray *sortedKeys = [[parameters allKeys] sortedArrayUsingComparator:^NSComparisonResult(id key1, id key2) {
+        return [[key1 description] compare:[key2 description]];
+    }];
+    
+    for (id key in sortedKeys)
+    {
+        if (![key isKindOfClass:NSString.class] || [NSString msidIsStringNilOrBlank:key]) continue;
+        
+        id value = parameters[key];
+        NSString *stringValue = [value isKindOfClass:NSUUID.class] ? ((NSUUID *)value).UUIDString : [value description];
+        
+        NSString *trimmedKey = [key msidTrimmedString];
+        NSString *trimmedValue = [stringValue msidTrimmedString] ?: @"";
+        
+        [keys addObject:trimmedKey];
+        [values addObject:trimmedValue];
+        totalLength += trimmedKey.length + trimmedValue.length + 2;
+    }
+    
+    return totalLength;
+}
+
++ (void)appendKeys:(NSArray<NSString *> *)keys
+            values:(NSArray<NSString *> *)values
+            toData:(NSMutableData *)data
+        formEncode:(BOOL)formEncode
+{
+    BOOL needsSeparator = data.length > 0;
+    
+    for (NSUInteger i = 0; i < keys.count; i++)
+    {
+        NSUInteger parameterStart = data.length;
+        
+        if (needsSeparator)
+        {
+            [data appendBytes:"&" length:1];
+        }
+        
+        if (![self appendEncodedString:keys[i] toData:data formEncode:formEncode])
+        {
+            data.length = parameterStart;
+            continue;
+        }
+        
+        needsSeparator = YES;
+        NSUInteger valueStart = data.length;
+        [data appendBytes:"=" length:1];
+        
+        if (![self appendEncodedString:values[i] toData:data formEncode:formEncode])
+        {
+            // Matches msidURLEncode, a value that can't be encoded leaves just the key.
+            data.length = valueStart;
+        }
+    }
+}
+
++ (BOOL)appendEncodedString:(NSString *)string
+                     toData:(NSMutableData *)data
+                 formEncode:(BOOL)formEncode
+{
+    const char *utf8 = [string UTF8String];
+    if (!utf8) return NO;
+    
+    size_t length = strlen(utf8);
+    if (!length) return YES;
+    
+    NSUInteger startLength = data.length;
+    
+    // Each input byte becomes at most 3 output bytes, write directly into the buffer and trim afterwards.
+    [data increaseLengthBy:length * 3];
+    unsigned char *output = (unsigned char *)data.mutableBytes + startLength;
+    unsigned char *cursor = output;
+    const unsigned char *input = (const unsigned char *)utf8;
+    
+    size_t i = 0;
+    while (i < length)
+    {
+        unsigned char c = input[i];
+        
+        if (c < 0x80)
+        {
+            if (s_unreservedASCII[c])
+            {
+                *cursor++ = c;
+            }
+            else if (c == ' ' && formEncode)
+            {
+                *cursor++ = '+';
+            }
+            else
+            {
+                *cursor++ = '%';
+                *cursor++ = s_hexDigits[c >> 4];
+                *cursor++ = s_hexDigits[c & 0x0F];
+            }
+            
+            i++;
+            continue;
+        }
+        
+        size_t sequenceLength = [self utf8SequenceLengthForLeadByte:c];
+        if (!sequenceLength || i + sequenceLength > length)
+        {
+            data.length = startLength;
+            return NO;
+        }
+        
+        UTF32Char codePoint = c & (0xFF >> (sequenceLength + 1));
+        for (size_t j = 1; j < sequenceLength; j++)
+        {
+            codePoint = (codePoint << 6) | (input[i + j] & 0x3F);
+        }
+        
+        if ([self isUnreservedNonASCIICodePoint:codePoint])
+        {
+            memcpy(cursor, input + i, sequenceLength);
+            cursor += sequenceLength;
+        }
+        else
+        {
+            for (size_t j = 0; j < sequenceLength; j++)
+            {
+                unsigned char b = input[i + j];
+                *cursor++ = '%';
+                *cursor++ = s_hexDigits[b >> 4];
+                *cursor++ = s_hexDigits[b & 0x0F];
+            }
+        }
+        
+        i += sequenceLength;
+    }
+    
+    data.length = startLength + (NSUInteger)(cursor - output);
+    return YES;
+}
+
++ (size_t)utf8SequenceLengthForLeadByte:(unsigned char)c
+{
+    if ((c & 0xE0) == 0xC0) return 2;
+    if ((c & 0xF0) == 0xE0) return 3;
+    if ((c & 0xF8) == 0xF0) return 4;
+    return 0;
+}
+
++ (BOOL)isUnreservedNonASCIICodePoint:(UTF32Char)codePoint
+{
+    static NSCharacterSet *alphanumericSet = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        alphanumericSet = [NSCharacterSet alphanumericCharacterSet];
+    });
+    
+    return [alphanumericSet longCharacterIsMember:codePoint];
+}
+
+@end
@@ -23,6 +23,7 @@
 
 #import "MSIDUrlRequestSerializer.h"
 #import "NSDictionary+MSIDExtensions.h"
+#import "MSIDURLFormEncoder.h"
 
 @implementation MSIDUrlRequestSerializer
 
@@ -44,14 +45,23 @@
            NSAssert(mutableRequest.URL, NULL);
            
            NSURLComponents *urlComponents = [NSURLComponents componentsWithURL:mutableRequest.URL resolvingAgainstBaseURL:NO];
-           NSMutableDictionary *urlParameters = [[mutableRequest.URL msidQueryParameters] mutableCopy] ?: [NSMutableDictionary new];
-           [urlParameters addEntriesFromDictionary:parameters];
-           urlComponents.percentEncodedQuery = [urlParameters msidURLEncode];
+           NSDictionary *urlParameters = parameters;
+           
+           // Only re-parse the query when there is one, parameters override existing query items with the same name.
+           if (urlComponents.percentEncodedQuery.length)
+           {
+               NSMutableDictionary *mergedParameters = [[mutableRequest.URL msidQueryParameters] mutableCopy] ?: [NSMutableDictionary new];
+               [mergedParameters addEntriesFromDictionary:parameters];
+               urlParameters = mergedParameters;
+           }
+           
+           urlComponents.percentEncodedQuery = [MSIDURLFormEncoder percentEncodedQueryWithParameters:urlParameters];
            mutableRequest.URL = urlComponents.URL;
        }
        else
        {
-           mutableRequest.HTTPBody = [[parameters msidWWWFormURLEncode] dataUsingEncoding:NSUTF8StringEncoding];
+           NSData *body = [MSIDURLFormEncoder formURLEncodedDataWithParameters:parameters];
+           mutableRequest.HTTPBody = body.length ? body : nil;
            [requestHeaders setObject:@"application/x-www-form-urlencoded" forKey:@"Content-Type"];
        }
     }
@@ -64,9 +74,16 @@
 
 - (BOOL)shouldEncodeParametersInURL:(NSURLRequest *)request
 {
-    __auto_type urlMethods = @[@"GET", @"HEAD", @"DELETE"];
+    static NSSet<NSString *> *urlMethods = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        urlMethods = [NSSet setWithObjects:@"GET", @"HEAD", @"DELETE", nil];
+    });
+    
+    NSString *method = request.HTTPMethod;
     
-    return [urlMethods containsObject:request.HTTPMethod.uppercaseString];
+    // HTTP methods are almost always upper case already, avoid allocating an upper case copy for them.
+    return [urlMethods containsObject:method] || [urlMethods containsObject:method.uppercaseString];
 }
 
 @end
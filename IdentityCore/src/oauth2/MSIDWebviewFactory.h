@@ -83,6 +83,11 @@
 
 - (MSIDAuthorizeWebRequestConfiguration *)authorizeWebRequestConfigurationWithRequestParameters:(MSIDInteractiveTokenRequestParameters *)parameters;
 
+// Builds the authorize configuration with PKCE and state generated ahead of time (e.g. by the interactive prefetch)
+- (MSIDAuthorizeWebRequestConfiguration *)authorizeWebRequestConfigurationWithRequestParameters:(MSIDInteractiveTokenRequestParameters *)parameters
+                                                                                           pkce:(MSIDPkce *)pkce
+                                                                                          state:(NSString *)state;
+
 - (MSIDSignoutWebRequestConfiguration *)logoutWebRequestConfigurationWithRequestParameters:(MSIDInteractiveRequestParameters *)parameters;
 
 @end
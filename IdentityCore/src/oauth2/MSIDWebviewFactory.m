@@ -269,6 +269,17 @@
 }
 
 - (MSIDAuthorizeWebRequestConfiguration *)authorizeWebRequestConfigurationWithRequestParameters:(MSIDInteractiveTokenRequestParameters *)parameters
+{
+    MSIDPkce *pkce = parameters.enablePkce ? [MSIDPkce new] : nil;
+    
+    return [self authorizeWebRequestConfigurationWithRequestParameters:parameters
+                                                                  pkce:pkce
+                                                                 state:[self generateStateValue]];
+}
+
+- (MSIDAuthorizeWebRequestConfiguration *)authorizeWebRequestConfigurationWithRequestParameters:(MSIDInteractiveTokenRequestParameters *)parameters
+                                                                                           pkce:(MSIDPkce *)pkce
+                                                                                          state:(NSString *)oauthState
 {
     NSURL *authorizeEndpoint = parameters.authority.metadata.authorizationEndpoint;
     
@@ -277,9 +288,6 @@
         return nil;
     }
     
-    MSIDPkce *pkce = parameters.enablePkce ? [MSIDPkce new] : nil;
-        
-    NSString *oauthState = [self generateStateValue];
     NSDictionary *authorizeQuery = [self authorizationParametersFromRequestParameters:parameters pkce:pkce requestState:oauthState];
     NSURL *startURL = [self startURLWithEndpoint:authorizeEndpoint authority:parameters.authority query:authorizeQuery context:parameters];
     NSString *endRedirectUri = parameters.redirectUri;
@@ -83,6 +83,9 @@
 @property (nonatomic) BOOL extendedLifetimeEnabled;
 @property (nonatomic) BOOL instanceAware;
 @property (nonatomic) BOOL allowUsingLocalCachedRtWhenSsoExtFailed;
+// Starts the local refresh token fallback in parallel when the SSO extension is slower than its p95 latency,
+// see MSIDSSOExtensionLatencyTracker. Requires allowUsingLocalCachedRtWhenSsoExtFailed.
+@property (nonatomic) BOOL hedgeSsoExtWithLocalCachedRt;
 @property (nonatomic) BOOL clientBrokerKeyCapabilityNotSupported;
 @property (nonatomic) NSString *intuneApplicationIdentifier;
 @property (nonatomic) MSIDRequestType requestType;
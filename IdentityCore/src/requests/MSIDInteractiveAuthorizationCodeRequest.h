@@ -28,6 +28,7 @@
 @class MSIDInteractiveTokenRequestParameters;
 @class MSIDOauth2Factory;
 @class MSIDWebviewResponse;
+@class MSIDInteractiveRequestPrefetchContext;
 
 typedef void (^MSIDInteractiveAuthorizationCodeCompletionBlock)(MSIDAuthorizationCodeResult * _Nullable result, NSError * _Nullable error, MSIDWebviewResponse * _Nullable installBrokerResponse);
 
@@ -38,6 +39,8 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly) MSIDInteractiveTokenRequestParameters *requestParameters;
 @property (nonatomic, readonly) MSIDOauth2Factory *oauthFactory;
 @property (nonatomic, copy) MSIDExternalDecidePolicyForBrowserActionBlock externalDecidePolicyForBrowserAction;
+// Setup work started at creation time, nil unless MSID_FLIGHT_INTERACTIVE_PREFETCH_ENABLED is on.
+@property (nonatomic, readonly, nullable) MSIDInteractiveRequestPrefetchContext *prefetchContext;
 
 - (nullable instancetype)initWithRequestParameters:(MSIDInteractiveTokenRequestParameters *)parameters
                                       oauthFactory:(MSIDOauth2Factory *)oauthFactory;
@@ -43,6 +43,8 @@
 #import "MSIDWebResponseBaseOperation.h"
 #import "MSIDMainThreadUtil.h"
 #import "MSIDWebMDMEnrollmentCompletionResponse.h"
+#import "MSIDInteractiveRequestPrefetchContext.h"
+#import "MSIDTracer.h"
 
 #if TARGET_OS_IPHONE
 #import "MSIDAppExtensionUtil.h"
@@ -74,6 +76,13 @@
 #if !EXCLUDE_FROM_MSALCPP
         _lastRequestTelemetry = [MSIDLastRequestTelemetry sharedInstance];
 #endif
+        
+        if ([[MSIDFlightManager sharedInstance] boolForKey:MSID_FLIGHT_INTERACTIVE_PREFETCH_ENABLED])
+        {
+            _prefetchContext = [[MSIDInteractiveRequestPrefetchContext alloc] initWithRequestParameters:parameters
+                                                                                         webviewFactory:oauthFactory.webviewFactory];
+            [_prefetchContext start];
+        }
     }
 
     return self;
@@ -81,7 +90,23 @@
 
 - (void)getAuthCodeWithCompletion:(MSIDInteractiveAuthorizationCodeCompletionBlock)completionBlock
 {
+    if (self.prefetchContext)
+    {
+        [self.prefetchContext waitWithCompletion:^(NSError *error)
+         {
+            if (error)
+            {
+                completionBlock(nil, error, nil);
+                return;
+            }
+            
+            [self getAuthCodeWithCompletionImpl:completionBlock];
+        }];
+        return;
+    }
+    
     NSString *upn = self.requestParameters.accountIdentifier.displayableId ?: self.requestParameters.loginHint;
+    MSIDTraceSpan *authoritySpan = MSIDTraceSpanStart(MSIDTraceSpanAuthorityResolution, self.requestParameters.correlationId);
 
     [self.requestParameters.authority resolveAndValidate:self.requestParameters.validateAuthority
                                        userPrincipalName:upn
@@ -91,6 +116,7 @@
      {
          if (error)
          {
+             MSIDTraceSpanEnd(authoritySpan);
              completionBlock(nil, error, nil);
              return;
          }
@@ -98,6 +124,7 @@
          [self.requestParameters.authority loadOpenIdMetadataWithContext:self.requestParameters
                                                          completionBlock:^(__unused MSIDOpenIdProviderMetadata *metadata, NSError *loadError)
           {
+              MSIDTraceSpanEnd(authoritySpan);
               if (loadError)
               {
                   completionBlock(nil, loadError, nil);
@@ -110,12 +137,24 @@
 }
 
 - (void)getAuthCodeWithCompletionImpl:(MSIDInteractiveAuthorizationCodeCompletionBlock)completionBlock
-{   
-    self.webViewConfiguration = [self.oauthFactory.webviewFactory authorizeWebRequestConfigurationWithRequestParameters:self.requestParameters];
+{
+    if (self.prefetchContext)
+    {
+        self.webViewConfiguration = [self.oauthFactory.webviewFactory authorizeWebRequestConfigurationWithRequestParameters:self.requestParameters
+                                                                                                                      pkce:self.prefetchContext.pkce
+                                                                                                                     state:self.prefetchContext.state];
+        [self.prefetchContext markAuthorizeURLReady];
+    }
+    else
+    {
+        self.webViewConfiguration = [self.oauthFactory.webviewFactory authorizeWebRequestConfigurationWithRequestParameters:self.requestParameters];
+    }
     
     __typeof__(self) __weak weakSelf = self;
+    MSIDTraceSpan *webUISpan = MSIDTraceSpanStart(MSIDTraceSpanWebUI, self.requestParameters.correlationId);
     [self showWebComponentWithCompletion:^(MSIDWebviewResponse *response, NSError *error)
      {
+        MSIDTraceSpanEnd(webUISpan);
         __typeof__(self) strongSelf = weakSelf;
         
         if ([response useV2WebResponseHandling])
@@ -0,0 +1,64 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+@class MSIDInteractiveTokenRequestParameters;
+@class MSIDWebviewFactory;
+@class MSIDPkce;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ Request-scoped setup for an interactive request that doesn't depend on user input.
+ Authority resolution with OpenID metadata loading, PKCE and state generation and device info collection
+ are started concurrently when the request is created, so that by the time the webview is presented only the
+ authorize URL has to be assembled. The generated PKCE verifier is reused by the code redemption.
+ */
+@interface MSIDInteractiveRequestPrefetchContext : NSObject
+
+@property (nonatomic, readonly, nullable) MSIDPkce *pkce;
+@property (nonatomic, readonly, nullable) NSString *state;
+@property (nonatomic, readonly) BOOL started;
+// Time between the prefetch start and the authorize URL being built, 0 until markAuthorizeURLReady is called.
+@property (nonatomic, readonly) NSTimeInterval authorizeURLReadyInterval;
+
+- (instancetype)initWithRequestParameters:(MSIDInteractiveTokenRequestParameters *)parameters
+                           webviewFactory:(MSIDWebviewFactory *)webviewFactory;
+
+// Starts all prefetch work. Subsequent calls are no-ops.
+- (void)start;
+
+// Starts the prefetch if needed and calls completion once all prefetch work has finished.
+// error is the authority resolution or OpenID metadata error, if any.
+- (void)waitWithCompletion:(void (^)(NSError * _Nullable error))completion;
+
+- (void)markAuthorizeURLReady;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
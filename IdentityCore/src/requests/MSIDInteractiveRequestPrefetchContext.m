@@ -0,0 +1,165 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDInteractiveRequestPrefetchContext.h"
+#import "MSIDInteractiveTokenRequestParameters.h"
+#import "MSIDAccountIdentifier.h"
+#import "MSIDAuthority.h"
+#import "MSIDWebviewFactory.h"
+#import "MSIDPkce.h"
+#import "MSIDDeviceId.h"
+#import "MSIDTracer.h"
+
+@interface MSIDInteractiveRequestPrefetchContext()
+
+@property (nonatomic) MSIDInteractiveTokenRequestParameters *requestParameters;
+@property (nonatomic) MSIDWebviewFactory *webviewFactory;
+@property (nonatomic) dispatch_group_t group;
+@property (nonatomic) NSDate *startDate;
+@property (nonatomic, nullable) MSIDPkce *pkce;
+@property (nonatomic, nullable) NSString *state;
+@property (nonatomic, nullable) NSError *authorityError;
+@property (nonatomic) BOOL started;
+@property (nonatomic) NSTimeInterval authorizeURLReadyInterval;
+
+@end
+
+@implementation MSIDInteractiveRequestPrefetchContext
+
+- (instancetype)initWithRequestParameters:(MSIDInteractiveTokenRequestParameters *)parameters
+                           webviewFactory:(MSIDWebviewFactory *)webviewFactory
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _requestParameters = parameters;
+        _webviewFactory = webviewFactory;
+        _group = dispatch_group_create();
+    }
+    
+    return self;
+}
+
+- (void)start
+{
+    @synchronized (self)
+    {
+        if (self.started) return;
+        
+        self.started = YES;
+        self.startDate = [NSDate date];
+    }
+    
+    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Starting interactive request prefetch.");
+    
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+    MSIDInteractiveTokenRequestParameters *parameters = self.requestParameters;
+    
+    // Authority resolution is the only step that can go to the network, start it first.
+    dispatch_group_enter(self.group);
+    NSString *upn = parameters.accountIdentifier.displayableId ?: parameters.loginHint;
+    MSIDTraceSpan *authoritySpan = MSIDTraceSpanStart(MSIDTraceSpanAuthorityResolution, parameters.correlationId);
+    [authoritySpan setAttribute:@YES forKey:@"prefetch"];
+    [parameters.authority resolveAndValidate:parameters.validateAuthority
+                           userPrincipalName:upn
+                                     context:parameters
+                             completionBlock:^(__unused NSURL *openIdConfigurationEndpoint, __unused BOOL validated, NSError *error)
+     {
+        if (error)
+        {
+            MSIDTraceSpanEnd(authoritySpan);
+            [self finishAuthorityWithError:error];
+            return;
+        }
+        
+        [parameters.authority loadOpenIdMetadataWithContext:parameters
+                                            completionBlock:^(__unused MSIDOpenIdProviderMetadata *metadata, NSError *loadError)
+         {
+            MSIDTraceSpanEnd(authoritySpan);
+            [self finishAuthorityWithError:loadError];
+        }];
+    }];
+    
+    dispatch_group_async(self.group, queue, ^{
+        MSIDPkce *pkce = parameters.enablePkce ? [MSIDPkce new] : nil;
+        NSString *state = [self.webviewFactory generateStateValue];
+        
+        @synchronized (self)
+        {
+            self.pkce = pkce;
+            self.state = state;
+        }
+    });
+    
+    // Device info is computed once per process and added to every authorize URL.
+    dispatch_group_async(self.group, queue, ^{
+        [MSIDDeviceId deviceId];
+    });
+}
+
+- (void)finishAuthorityWithError:(NSError *)error
+{
+    if (error)
+    {
+        MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, self.requestParameters, @"Interactive request prefetch failed to resolve authority, error %@", MSID_PII_LOG_MASKABLE(error));
+    }
+    
+    @synchronized (self)
+    {
+        self.authorityError = error;
+    }
+    
+    dispatch_group_leave(self.group);
+}
+
+- (void)waitWithCompletion:(void (^)(NSError *error))completion
+{
+    [self start];
+    
+    dispatch_group_notify(self.group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        NSError *error = nil;
+        
+        @synchronized (self)
+        {
+            error = self.authorityError;
+        }
+        
+        completion(error);
+    });
+}
+
+- (void)markAuthorizeURLReady
+{
+    @synchronized (self)
+    {
+        if (!self.startDate) return;
+        
+        self.authorizeURLReadyInterval = [[NSDate date] timeIntervalSinceDate:self.startDate];
+    }
+    
+    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Authorize URL ready %.0f ms after prefetch start.", self.authorizeURLReadyInterval * 1000);
+}
+
+@end
@@ -33,8 +33,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable instancetype)initWithRequestParameters:(nonnull MSIDRequestParameters *)parameters;
 
+// Returns the cached nonce for the authority environment or fetches a new one.
+// Concurrent fetches for the same environment are coalesced into a single network request,
+// and a cached nonce close to expiry is refreshed in the background.
 - (void)executeRequestWithCompletion:(nonnull MSIDNonceRequestCompletion)completionBlock;
 
+// Starts fetching a nonce for the authority environment unless a fresh one is cached or a fetch is already running,
+// so a later executeRequestWithCompletion: doesn't wait for the nonce round trip.
++ (void)prefetchNonceWithRequestParameters:(nonnull MSIDRequestParameters *)parameters;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -31,6 +31,9 @@
 #import "MSIDCachedNonce.h"
 
 const static NSUInteger kMSIDNonceLifetimeInSeconds = 180;
+// Cached nonces older than this are still returned, but refreshed in the background.
+const static NSUInteger kMSIDNonceRefreshAheadInSeconds = 120;
+
 @implementation MSIDNonceTokenRequest
 
 - (nullable instancetype)initWithRequestParameters:(nonnull MSIDRequestParameters *)parameters
@@ -45,13 +48,91 @@ const static NSUInteger kMSIDNonceLifetimeInSeconds = 180;
 
 - (void)executeRequestWithCompletion:(nonnull MSIDNonceRequestCompletion)completionBlock
 {
-    MSIDCachedNonce *cachedNonce = [self.class getCachedNonceForKey:self.requestParameters.authority.environment];
+    NSString *environment = self.requestParameters.authority.environment;
+    MSIDCachedNonce *cachedNonce = [self.class getCachedNonceForKey:environment];
     if (cachedNonce)
     {
+        if ([self.class shouldRefreshAheadCachedNonce:cachedNonce])
+        {
+            MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Cached nonce is close to expiry, refreshing it in background.");
+            [self fetchNonceForKey:environment completion:nil];
+        }
+        
         completionBlock(cachedNonce.nonce, nil);
         return;
     }
+    
+    [self fetchNonceForKey:environment completion:completionBlock];
+}
+
++ (void)prefetchNonceWithRequestParameters:(MSIDRequestParameters *)parameters
+{
+    NSString *environment = parameters.authority.environment;
+    MSIDCachedNonce *cachedNonce = [self getCachedNonceForKey:environment];
+    if (cachedNonce && ![self shouldRefreshAheadCachedNonce:cachedNonce]) return;
+    
+    MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, parameters, @"Prefetching nonce.");
+    MSIDNonceTokenRequest *request = [[self alloc] initWithRequestParameters:parameters];
+    [request fetchNonceForKey:environment completion:nil];
+}
+
+#pragma mark - Single flight
+
+- (void)fetchNonceForKey:(NSString *)key completion:(nullable MSIDNonceRequestCompletion)completionBlock
+{
+    if (!key)
+    {
+        [self executeFetchWithCompletion:completionBlock];
+        return;
+    }
+    
+    NSMutableDictionary<NSString *, NSMutableArray<MSIDNonceRequestCompletion> *> *inflightFetches = [self.class inflightFetches];
+    MSIDNonceRequestCompletion noopCompletion = ^(__unused NSString *nonce, __unused NSError *error) {};
+    
+    @synchronized (inflightFetches)
+    {
+        NSMutableArray<MSIDNonceRequestCompletion> *waiters = inflightFetches[key];
+        if (waiters)
+        {
+            MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, self.requestParameters, @"Nonce fetch already in flight, waiting for it.");
+            [waiters addObject:completionBlock ?: noopCompletion];
+            return;
+        }
+        
+        inflightFetches[key] = [NSMutableArray arrayWithObject:completionBlock ?: noopCompletion];
+    }
+    
+    [self executeFetchWithCompletion:^(NSString *nonce, NSError *error)
+    {
+        NSArray<MSIDNonceRequestCompletion> *waiters;
+        @synchronized (inflightFetches)
+        {
+            waiters = inflightFetches[key];
+            [inflightFetches removeObjectForKey:key];
+        }
+        
+        for (MSIDNonceRequestCompletion waiter in waiters)
+        {
+            waiter(nonce, error);
+        }
+    }];
+}
 
++ (NSMutableDictionary<NSString *, NSMutableArray<MSIDNonceRequestCompletion> *> *)inflightFetches
+{
+    static NSMutableDictionary *k_inflightFetches;
+    static dispatch_once_t once_token;
+    dispatch_once(&once_token, ^{
+        k_inflightFetches = [NSMutableDictionary new];
+    });
+    
+    return k_inflightFetches;
+}
+
+#pragma mark - Network
+
+- (void)executeFetchWithCompletion:(nullable MSIDNonceRequestCompletion)completionBlock
+{
     if (self.requestParameters.authority.metadata.tokenEndpoint)
     {
         [self executeNetworkRequestWithCompletion:completionBlock];
@@ -65,7 +146,7 @@ const static NSUInteger kMSIDNonceLifetimeInSeconds = 180;
     {
         if (error)
         {
-            completionBlock(nil, error);
+            if (completionBlock) completionBlock(nil, error);
             return;
         }
         
@@ -75,7 +156,7 @@ const static NSUInteger kMSIDNonceLifetimeInSeconds = 180;
              
              if (openIdError)
              {
-                 completionBlock(nil, openIdError);
+                 if (completionBlock) completionBlock(nil, openIdError);
                  return;
              }
              
@@ -84,7 +165,7 @@ const static NSUInteger kMSIDNonceLifetimeInSeconds = 180;
     }];
 }
 
-- (void)executeNetworkRequestWithCompletion:(nonnull MSIDNonceRequestCompletion)completionBlock
+- (void)executeNetworkRequestWithCompletion:(nullable MSIDNonceRequestCompletion)completionBlock
 {
     MSIDNonceHttpRequest *nonceRequest = [[MSIDNonceHttpRequest alloc] initWithTokenEndpoint:self.requestParameters.tokenEndpoint
                                                                                      context:self.requestParameters];
@@ -151,6 +232,11 @@ const static NSUInteger kMSIDNonceLifetimeInSeconds = 180;
     return nil;
 }
 
++ (BOOL)shouldRefreshAheadCachedNonce:(MSIDCachedNonce *)cachedNonce
+{
+    return [[NSDate date] timeIntervalSinceDate:cachedNonce.cachedDate] >= kMSIDNonceRefreshAheadInSeconds;
+}
+
 + (BOOL)cacheNonceForKey:(NSString *)key nonce:(NSString *)nonce
 {
     if (!nonce || !key)
@@ -0,0 +1,68 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, MSIDSilentRequestHedgeLeg)
+{
+    // Request that is started first, e.g. the SSO extension request.
+    MSIDSilentRequestHedgeLegPrimary = 0,
+    // Request that is started in parallel once the primary leg is slow, e.g. the local refresh token request.
+    MSIDSilentRequestHedgeLegSecondary
+};
+
+/*!
+ Shared state of a primary silent request raced against a delayed secondary request.
+ Only one leg is allowed to write its response to the token cache: the first leg to claim the write wins
+ and the other leg is cancelled, so a late response can't overwrite the tokens the winner just saved.
+ Cancellation is cooperative, legs check it before sending a request and before saving a response.
+ */
+@interface MSIDSilentRequestHedge : NSObject
+
+@property (nonatomic, readonly) BOOL secondaryLegStarted;
+
+// Marks the secondary leg as started. Returns NO if the race is already decided or the primary leg has finished.
+- (BOOL)startSecondaryLeg;
+
+// Marks the primary leg as finished, the secondary leg won't be started after this.
+- (void)finishPrimaryLeg;
+
+// Returns YES if the leg may write its response to the token cache. The first leg to claim wins and cancels the other one,
+// so only claim once the response has been validated and is about to be saved.
+- (BOOL)claimCacheWriteForLeg:(MSIDSilentRequestHedgeLeg)leg;
+
+// Runs block, e.g. the removal of a refresh token rejected by the server, unless the other leg already claimed the cache write
+// or this leg was cancelled. The other leg can't claim the cache write while block runs. Returns NO if block was skipped.
+- (BOOL)performCacheCleanupForLeg:(MSIDSilentRequestHedgeLeg)leg block:(void (^)(void))block;
+
+- (void)cancelLeg:(MSIDSilentRequestHedgeLeg)leg;
+- (BOOL)isLegCancelled:(MSIDSilentRequestHedgeLeg)leg;
+
+- (NSError *)cancellationErrorForLeg:(MSIDSilentRequestHedgeLeg)leg correlationId:(nullable NSUUID *)correlationId;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,111 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDSilentRequestHedge.h"
+
+@interface MSIDSilentRequestHedge()
+
+@property (nonatomic) BOOL secondaryLegStarted;
+@property (nonatomic) BOOL primaryLegFinished;
+@property (nonatomic) BOOL primaryLegCancelled;
+@property (nonatomic) BOOL secondaryLegCancelled;
+@property (nonatomic, nullable) NSNumber *cacheWriter;
+
+@end
+
+@implementation MSIDSilentRequestHedge
+
+- (BOOL)startSecondaryLeg
+{
+    @synchronized (self)
+    {
+        if (self.primaryLegFinished || self.cacheWriter || self.secondaryLegCancelled) return NO;
+        
+        self.secondaryLegStarted = YES;
+        return YES;
+    }
+}
+
+- (void)finishPrimaryLeg
+{
+    @synchronized (self)
+    {
+        self.primaryLegFinished = YES;
+    }
+}
+
+- (BOOL)claimCacheWriteForLeg:(MSIDSilentRequestHedgeLeg)leg
+{
+    @synchronized (self)
+    {
+        if (self.cacheWriter) return self.cacheWriter.integerValue == leg;
+        if ([self isLegCancelled:leg]) return NO;
+        
+        self.cacheWriter = @(leg);
+        [self cancelLeg:leg == MSIDSilentRequestHedgeLegPrimary ? MSIDSilentRequestHedgeLegSecondary : MSIDSilentRequestHedgeLegPrimary];
+        return YES;
+    }
+}
+
+- (BOOL)performCacheCleanupForLeg:(MSIDSilentRequestHedgeLeg)leg block:(void (^)(void))block
+{
+    @synchronized (self)
+    {
+        if (self.cacheWriter || [self isLegCancelled:leg]) return NO;
+        
+        block();
+        return YES;
+    }
+}
+
+- (void)cancelLeg:(MSIDSilentRequestHedgeLeg)leg
+{
+    @synchronized (self)
+    {
+        if (leg == MSIDSilentRequestHedgeLegPrimary)
+        {
+            self.primaryLegCancelled = YES;
+        }
+        else
+        {
+            self.secondaryLegCancelled = YES;
+        }
+    }
+}
+
+- (BOOL)isLegCancelled:(MSIDSilentRequestHedgeLeg)leg
+{
+    @synchronized (self)
+    {
+        return leg == MSIDSilentRequestHedgeLegPrimary ? self.primaryLegCancelled : self.secondaryLegCancelled;
+    }
+}
+
+- (NSError *)cancellationErrorForLeg:(MSIDSilentRequestHedgeLeg)leg correlationId:(NSUUID *)correlationId
+{
+    NSString *description = leg == MSIDSilentRequestHedgeLegPrimary ? @"Primary leg of hedged silent request was cancelled." : @"Secondary leg of hedged silent request was cancelled.";
+    return MSIDCreateError(MSIDErrorDomain, MSIDErrorInternal, description, nil, nil, nil, correlationId, @{MSIDHedgedRequestCancelledKey : @YES}, NO);
+}
+
+@end
@@ -25,6 +25,7 @@
 #import "MSIDCacheAccessor.h"
 #import "MSIDConstants.h"
 #import "MSIDThrottlingService.h"
+#import "MSIDSilentRequestHedge.h"
 
 @class MSIDRequestParameters;
 @class MSIDOauth2Factory;
@@ -48,6 +49,9 @@
 @property (nonatomic) BOOL forceRefresh;
 // Temporary property to skip bound app RT lookup for fallback to regular RTs when BART fails.
 @property (nonatomic) BOOL shouldSkipBoundAppRefreshTokenUsage;
+// Set when the request runs as a leg of a hedged silent request.
+@property (nonatomic, nullable) MSIDSilentRequestHedge *hedge;
+@property (nonatomic) MSIDSilentRequestHedgeLeg hedgeLeg;
 
 #if TARGET_OS_OSX && !EXCLUDE_FROM_MSALCPP
 @property (nonatomic, nullable) MSIDExternalAADCacheSeeder *externalCacheSeeder;
@@ -53,6 +53,7 @@
 #import "MSIDAADTokenRequestServerTelemetry.h"
 #import "MSIDExecutionFlowLogger.h"
 #import "MSIDExecutionFlowConstants.h"
+#import "MSIDTracer.h"
 
 #if TARGET_OS_OSX && !EXCLUDE_FROM_MSALCPP
 #import "MSIDExternalAADCacheSeeder.h"
@@ -142,7 +143,10 @@ typedef NS_ENUM(NSInteger, MSIDRefreshTokenTypes)
         NSError *accessTokenError = nil;
         
         MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Looking for access token...");
+        MSIDTraceSpan *cacheReadSpan = MSIDTraceSpanStart(MSIDTraceSpanCacheRead, self.requestParameters.correlationId);
         MSIDAccessToken *accessToken = [self accessTokenWithError:&accessTokenError];
+        [cacheReadSpan setAttribute:@(accessToken != nil) forKey:@"hit"];
+        MSIDTraceSpanEnd(cacheReadSpan);
         
         if (accessTokenError)
         {
@@ -591,8 +595,11 @@ typedef NS_ENUM(NSInteger, MSIDRefreshTokenTypes)
     else
     {
         // Invoke throttling service before making the call to server. If the request should be throttled, return the cached response (error) immediately
+        MSIDTraceSpan *throttlingSpan = MSIDTraceSpanStart(MSIDTraceSpanThrottlingCheck, self.requestParameters.correlationId);
         [self.throttlingService shouldThrottleRequest:tokenRequest resultBlock:^(BOOL shouldBeThrottled, NSError * _Nullable cachedError)
          {
+            [throttlingSpan setAttribute:@(shouldBeThrottled) forKey:@"throttled"];
+            MSIDTraceSpanEnd(throttlingSpan);
             MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Throttle decision: %@" , (shouldBeThrottled ? @"YES" : @"NO"));
             
             if (cachedError)
@@ -619,6 +626,13 @@ typedef NS_ENUM(NSInteger, MSIDRefreshTokenTypes)
                 refreshToken:(MSIDBaseToken<MSIDRefreshableToken> *)refreshToken
                 tokenRequest:(MSIDRefreshTokenGrantRequest *)tokenRequest
 {
+    if ([self.hedge isLegCancelled:self.hedgeLeg])
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Hedged request leg was cancelled, not sending refresh token request.");
+        completionBlock(nil, [self.hedge cancellationErrorForLeg:self.hedgeLeg correlationId:self.requestParameters.correlationId]);
+        return;
+    }
+    
     [tokenRequest sendWithBlock:^(MSIDTokenResponse *tokenResponse, NSError *error)
      {
         if (error)
@@ -632,6 +646,11 @@ typedef NS_ENUM(NSInteger, MSIDRefreshTokenTypes)
             }
             
             BOOL serverUnavailable = error.userInfo[MSIDServerUnavailableStatusKey] != nil;
+            if (error.userInfo[MSIDCircuitBreakerOpenKey])
+            {
+                MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Token endpoint circuit breaker is open, request was not sent.");
+            }
+            
             if (serverUnavailable && self.unexpiredRefreshNeededAccessToken)
             {
                 
@@ -677,6 +696,8 @@ typedef NS_ENUM(NSInteger, MSIDRefreshTokenTypes)
 #if TARGET_OS_OSX
         self.tokenResponseHandler.externalCacheSeeder = self.externalCacheSeeder;
 #endif
+        self.tokenResponseHandler.hedge = self.hedge;
+        self.tokenResponseHandler.hedgeLeg = self.hedgeLeg;
         [self.tokenResponseHandler handleTokenResponse:tokenResponse
                                      requestParameters:self.requestParameters
                                          homeAccountId:self.requestParameters.accountIdentifier.homeAccountId
@@ -700,27 +721,40 @@ typedef NS_ENUM(NSInteger, MSIDRefreshTokenTypes)
                 [self.throttlingService updateThrottlingService:localError tokenRequest:tokenRequest];
             }
             
-            if (!result && [self shouldRemoveRefreshToken:localError])
+            void (^removeInvalidArtifacts)(void) = ^
             {
-                MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Refresh token invalid, removing it...");
-                NSError *removalError = nil;
-                BOOL removalResult = [self.tokenCache validateAndRemoveRefreshToken:refreshToken
-                                                                     context:self.requestParameters
-                                                                       error:&removalError];
+                if (!result && [self shouldRemoveRefreshToken:localError])
+                {
+                    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Refresh token invalid, removing it...");
+                    NSError *removalError = nil;
+                    BOOL removalResult = [self.tokenCache validateAndRemoveRefreshToken:refreshToken
+                                                                         context:self.requestParameters
+                                                                           error:&removalError];
+                    
+                    if (!removalResult)
+                    {
+                        MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, self.requestParameters, @"Failed to remove invalid refresh token with error %@", MSID_PII_LOG_MASKABLE(removalError));
+                    }
+                }
                 
-                if (!removalResult)
+                BOOL disableRemoveAccountArtifacts = [MSIDFlightManager.sharedInstance boolForKey:MSID_FLIGHT_DISABLE_REMOVE_ACCOUNT_ARTIFACTS];
+
+                // remove account artifacts only if we test flight feature is not disabled
+                if (!result && !disableRemoveAccountArtifacts && [self shouldRemoveAccountArtifacts:localError])
                 {
-                    MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, self.requestParameters, @"Failed to remove invalid refresh token with error %@", MSID_PII_LOG_MASKABLE(removalError));
+                    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Account deleted, Removing any user account artifacts from device...");
+                    [self removeAccountArtifacts:self.requestParameters];
                 }
-            }
+            };
             
-            BOOL disableRemoveAccountArtifacts = [MSIDFlightManager.sharedInstance boolForKey:MSID_FLIGHT_DISABLE_REMOVE_ACCOUNT_ARTIFACTS];
-
-            // remove account artifacts only if we test flight feature is not disabled
-            if (!result && !disableRemoveAccountArtifacts && [self shouldRemoveAccountArtifacts:localError])
+            if (!self.hedge)
+            {
+                removeInvalidArtifacts();
+            }
+            else if (!result && ![self.hedge performCacheCleanupForLeg:self.hedgeLeg block:removeInvalidArtifacts])
             {
-                MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Account deleted, Removing any user account artifacts from device...");
-                [self removeAccountArtifacts:self.requestParameters];
+                // A leg of a hedged request that lost the race must not touch the cache the winning leg saved its response to.
+                MSID_LOG_WITH_CTX(MSIDLogLevelInfo, self.requestParameters, @"Other leg of hedged request already saved its response, not removing cache artifacts.");
             }
 
             completionBlock(result, localError);
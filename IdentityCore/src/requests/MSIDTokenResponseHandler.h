@@ -23,6 +23,8 @@
 
 #import <Foundation/Foundation.h>
 #import "MSIDConstants.h"
+#import "MSIDAccountMetadata.h"
+#import "MSIDSilentRequestHedge.h"
 
 #if TARGET_OS_OSX && !EXCLUDE_FROM_MSALCPP
 @class MSIDExternalAADCacheSeeder;
@@ -43,6 +45,13 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, nullable) MSIDExternalAADCacheSeeder *externalCacheSeeder;
 #endif
 
+// Origin recorded in account metadata for accounts in handled responses. MSIDAccountMetadataSourceLocal by default.
+@property (nonatomic, readonly) MSIDAccountMetadataSource accountSource;
+
+// When set, a valid response is only saved if this leg wins the cache write of the hedged request.
+@property (nonatomic, nullable) MSIDSilentRequestHedge *hedge;
+@property (nonatomic) MSIDSilentRequestHedgeLeg hedgeLeg;
+
 - (void)handleTokenResponse:(nullable MSIDTokenResponse *)tokenResponse
           requestParameters:(MSIDRequestParameters *)requestParameters
               homeAccountId:(nullable NSString *)homeAccountId
@@ -28,6 +28,7 @@
 #import "MSIDAccountIdentifier.h"
 #import "MSIDTokenResult.h"
 #import "MSIDAccount.h"
+#import "MSIDTracer.h"
 
 #if TARGET_OS_OSX && !EXCLUDE_FROM_MSALCPP
 #import "MSIDExternalAADCacheSeeder.h"
@@ -35,6 +36,11 @@
 
 @implementation MSIDTokenResponseHandler
 
+- (MSIDAccountMetadataSource)accountSource
+{
+    return MSIDAccountMetadataSourceLocal;
+}
+
 - (void)handleTokenResponse:(MSIDTokenResponse *)tokenResponse
           requestParameters:(MSIDRequestParameters *)requestParameters
               homeAccountId:(NSString *)homeAccountId
@@ -59,13 +65,18 @@ brokerRequestReceivedTimeStamp:(nullable NSDate *)brokerRequestReceivedTimeStamp
     MSID_LOG_WITH_CTX(MSIDLogLevelInfo, requestParameters, @"Validate and save token response...");
         
     NSError *validationError;
+    MSIDTraceSpan *cacheWriteSpan = MSIDTraceSpanStart(MSIDTraceSpanCacheWrite, requestParameters.correlationId);
     MSIDTokenResult *tokenResult = [tokenResponseValidator validateAndSaveTokenResponse:tokenResponse
                                                                            oauthFactory:oauthFactory
                                                                              tokenCache:tokenCache
                                                                    accountMetadataCache:accountMetadataCache
                                                                       requestParameters:requestParameters
                                                                        saveSSOStateOnly:saveSSOStateOnly
+                                                                          accountSource:self.accountSource
+                                                                                  hedge:self.hedge
+                                                                               hedgeLeg:self.hedgeLeg
                                                                                   error:&validationError];
+    MSIDTraceSpanEnd(cacheWriteSpan);
        
     if (!tokenResult)
     {
@@ -31,6 +31,7 @@
 #import "NSDictionary+MSIDQueryItems.h"
 #import "MSIDInteractiveRequestControlling.h"
 #import "ASAuthorizationController+MSIDExtensions.h"
+#import "MSIDTracer.h"
 
 #if TARGET_OS_IPHONE
 #import "MSIDBackgroundTaskManager.h"
@@ -101,7 +102,12 @@
     self.authorizationController = [[ASAuthorizationController alloc] initWithAuthorizationRequests:@[ssoRequest]];
     self.authorizationController.delegate = self.extensionDelegate;
     self.authorizationController.presentationContextProvider = self;
-    self.requestCompletionBlock = completionBlock;
+    MSIDTraceSpan *ipcSpan = MSIDTraceSpanStart(MSIDTraceSpanBrokerIPC, self.requestParameters.correlationId);
+    self.requestCompletionBlock = ^(MSIDTokenResult *result, NSError *error, MSIDWebviewResponse *installBrokerResponse)
+    {
+        MSIDTraceSpanEnd(ipcSpan);
+        completionBlock(result, error, installBrokerResponse);
+    };
     
     [self.authorizationController msidPerformRequests];
 }
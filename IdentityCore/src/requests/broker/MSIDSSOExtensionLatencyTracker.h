@@ -0,0 +1,58 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ Keeps a rolling window of SSO extension silent request latencies and derives the delay after which
+ a hedged silent request starts its local refresh token leg.
+ */
+@interface MSIDSSOExtensionLatencyTracker : NSObject
+
+// Percentile of recorded latencies used as hedge delay. Default: 0.95.
+@property (atomic) double hedgePercentile;
+// Bounds of the hedge delay in seconds. Default: 0.5 and 5.
+@property (atomic) NSTimeInterval minimumHedgeDelay;
+@property (atomic) NSTimeInterval maximumHedgeDelay;
+// Hedge delay used until minimumSampleCount latencies are recorded. Default: 2 seconds, 20 samples.
+@property (atomic) NSTimeInterval defaultHedgeDelay;
+@property (atomic) NSUInteger minimumSampleCount;
+
+@property (nonatomic, readonly) NSUInteger sampleCount;
+
++ (instancetype)sharedInstance;
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+- (void)recordLatency:(NSTimeInterval)latency;
+
+- (NSTimeInterval)hedgeDelay;
+
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
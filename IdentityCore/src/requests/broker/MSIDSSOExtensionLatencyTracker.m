@@ -0,0 +1,136 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDSSOExtensionLatencyTracker.h"
+
+static const NSUInteger kDefaultSampleCapacity = 128;
+
+@interface MSIDSSOExtensionLatencyTracker()
+{
+    NSTimeInterval *_samples;
+    NSUInteger _capacity;
+    NSUInteger _nextIndex;
+    NSUInteger _sampleCount;
+}
+
+@end
+
+@implementation MSIDSSOExtensionLatencyTracker
+
++ (instancetype)sharedInstance
+{
+    static MSIDSSOExtensionLatencyTracker *sharedInstance;
+    static dispatch_once_t once;
+    
+    dispatch_once(&once, ^{
+        sharedInstance = [[self alloc] initWithCapacity:kDefaultSampleCapacity];
+    });
+    
+    return sharedInstance;
+}
+
+- (instancetype)init
+{
+    return [self initWithCapacity:kDefaultSampleCapacity];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _capacity = MAX(capacity, 1);
+        _samples = calloc(_capacity, sizeof(NSTimeInterval));
+        _hedgePercentile = 0.95;
+        _minimumHedgeDelay = 0.5;
+        _maximumHedgeDelay = 5;
+        _defaultHedgeDelay = 2;
+        _minimumSampleCount = 20;
+    }
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_samples);
+}
+
+- (void)recordLatency:(NSTimeInterval)latency
+{
+    if (latency < 0) return;
+    
+    @synchronized (self)
+    {
+        _samples[_nextIndex] = latency;
+        _nextIndex = (_nextIndex + 1) % _capacity;
+        _sampleCount = MIN(_sampleCount + 1, _capacity);
+    }
+}
+
+- (NSUInteger)sampleCount
+{
+    @synchronized (self)
+    {
+        return _sampleCount;
+    }
+}
+
+- (NSTimeInterval)hedgeDelay
+{
+    NSTimeInterval delay = self.defaultHedgeDelay;
+    
+    @synchronized (self)
+    {
+        if (_sampleCount > 0 && _sampleCount >= self.minimumSampleCount)
+        {
+            NSTimeInterval *sorted = malloc(_sampleCount * sizeof(NSTimeInterval));
+            memcpy(sorted, _samples, _sampleCount * sizeof(NSTimeInterval));
+            qsort_b(sorted, _sampleCount, sizeof(NSTimeInterval), ^int(const void *lhs, const void *rhs) {
+                NSTimeInterval l = *(const NSTimeInterval *)lhs;
+                NSTimeInterval r = *(const NSTimeInterval *)rhs;
+                return l < r ? -1 : (l > r ? 1 : 0);
+            });
+            
+            double percentile = MIN(MAX(self.hedgePercentile, 0), 1);
+            NSUInteger index = (NSUInteger)ceil(percentile * _sampleCount);
+            delay = sorted[index > 0 ? index - 1 : 0];
+            free(sorted);
+        }
+    }
+    
+    return MIN(MAX(delay, self.minimumHedgeDelay), self.maximumHedgeDelay);
+}
+
+- (void)reset
+{
+    @synchronized (self)
+    {
+        _nextIndex = 0;
+        _sampleCount = 0;
+    }
+}
+
+@end
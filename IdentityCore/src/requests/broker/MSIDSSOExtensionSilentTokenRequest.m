@@ -33,6 +33,8 @@
 #import "ASAuthorizationController+MSIDExtensions.h"
 #import "MSIDGCDStarvationDetector.h"
 #import "MSIDFlightManager.h"
+#import "MSIDSSOExtensionLatencyTracker.h"
+#import "MSIDTracer.h"
 
 @interface MSIDSSOExtensionSilentTokenRequest () <ASAuthorizationControllerDelegate>
 
@@ -117,7 +119,15 @@
     self.authorizationController = [[ASAuthorizationController alloc] initWithAuthorizationRequests:@[ssoRequest]];
     self.authorizationController.delegate = self.extensionDelegate;
     
-    self.requestCompletionBlock = completionBlock;
+    NSDate *requestStartDate = [NSDate date];
+    MSIDTraceSpan *ipcSpan = MSIDTraceSpanStart(MSIDTraceSpanBrokerIPC, self.requestParameters.correlationId);
+    self.requestCompletionBlock = ^(MSIDTokenResult *result, NSError *error)
+    {
+        // Feeds the hedge delay of hedged silent requests.
+        [[MSIDSSOExtensionLatencyTracker sharedInstance] recordLatency:[[NSDate date] timeIntervalSinceDate:requestStartDate]];
+        MSIDTraceSpanEnd(ipcSpan);
+        completionBlock(result, error);
+    };
     [self.authorizationController msidPerformRequests];
     if ([self isThreadStarvationMonitoringEnabled])
     {
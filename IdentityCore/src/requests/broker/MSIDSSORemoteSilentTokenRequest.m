@@ -102,6 +102,8 @@ NSString *const MSID_TOKEN_RESULT_BROKER_REQUEST_STARVATION_DURATION = @"broker_
     #if TARGET_OS_OSX && !EXCLUDE_FROM_MSALCPP
                     strongSelf.ssoTokenResponseHandler.externalCacheSeeder = strongSelf.externalCacheSeeder;
     #endif
+                    strongSelf.ssoTokenResponseHandler.hedge = strongSelf.hedge;
+                    strongSelf.ssoTokenResponseHandler.hedgeLeg = strongSelf.hedgeLeg;
                     __typeof__(strongSelf) __weak weakStrongSelf = strongSelf;
                     MSIDExecutionFlowInsertTag(MSIDSSORemoteSilentTokenRequestTagToString(MSIDSilentHandleOperationResponseTag),
                                                    error ? @{MSID_EXECUTION_FLOW_ERROR_CODE:@(error.code)} : nil,
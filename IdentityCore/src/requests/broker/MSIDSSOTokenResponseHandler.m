@@ -31,6 +31,11 @@
 
 @implementation MSIDSSOTokenResponseHandler
 
+- (MSIDAccountMetadataSource)accountSource
+{
+    return MSIDAccountMetadataSourceBroker;
+}
+
 - (void)handleOperationResponse:(MSIDBrokerOperationTokenResponse *)operationResponse
               requestParameters:(MSIDRequestParameters *)requestParameters
          tokenResponseValidator:(MSIDTokenResponseValidator *)tokenResponseValidator
@@ -45,8 +50,10 @@
     
     BOOL saveSSOStateOnly = operationResponse.deviceInfo.deviceMode == MSIDDeviceModeShared;
     
-    if (operationResponse.additionalTokenResponse)
+    void (^saveAdditionalTokenResponse)(void) = ^
     {
+        if (!operationResponse.additionalTokenResponse) return;
+        
         MSID_LOG_WITH_CTX(MSIDLogLevelInfo, requestParameters, @"Saving additional token response...");
         NSError *localError;
         MSIDRequestParameters *parameters = [requestParameters copy];
@@ -64,6 +71,7 @@
                                         accountMetadataCache:accountMetadataCache
                                            requestParameters:parameters
                                             saveSSOStateOnly:saveSSOStateOnly
+                                               accountSource:self.accountSource
                                                        error:&localError];
         
         if (localError)
@@ -74,6 +82,24 @@
         {
            MSID_LOG_WITH_CTX(MSIDLogLevelInfo, requestParameters, @"Saved additional token response.");
         }
+    };
+    
+    MSIDRequestCompletionBlock responseCompletionBlock = [self wrapCompletionBlock:completionBlock
+                                                                withOnboardingBlob:operationResponse.onboardingBlob];
+    
+    if (self.hedge)
+    {
+        // The cache write is claimed when the main response is saved, save the additional response only if this leg won it.
+        MSIDRequestCompletionBlock hedgedCompletionBlock = responseCompletionBlock;
+        responseCompletionBlock = ^(MSIDTokenResult *result, NSError *resultError)
+        {
+            if (result) saveAdditionalTokenResponse();
+            hedgedCompletionBlock(result, resultError);
+        };
+    }
+    else
+    {
+        saveAdditionalTokenResponse();
     }
     
     [self handleTokenResponse:operationResponse.tokenResponse
@@ -89,8 +115,7 @@
 brokerResponseGenerationTimeStamp:operationResponse.responseGenerationTimeStamp
 brokerRequestReceivedTimeStamp:operationResponse.requestReceivedTimeStamp
                         error:error
-              completionBlock:[self wrapCompletionBlock:completionBlock
-                                     withOnboardingBlob:operationResponse.onboardingBlob]];
+              completionBlock:responseCompletionBlock];
 }
 
 // Round-trip the onboarding telemetry blob from MSIDBrokerOperationTokenResponse
@@ -23,6 +23,7 @@
 
 #import <Foundation/Foundation.h>
 #import "MSIDInteractiveRequestControlling.h"
+#import "MSIDAccountMetadata.h"
 
 @class MSIDInteractiveTokenRequest;
 @class MSIDSilentTokenRequest;
@@ -53,4 +54,9 @@
 - (nullable MSIDSilentTokenRequest *)silentXpcTokenRequestWithParameters:(nonnull MSIDRequestParameters *)parameters
                                                                         forceRefresh:(BOOL)forceRefresh;
 
+@optional
+
+// Where the tokens of the request account came from, as recorded in account metadata.
+- (MSIDAccountMetadataSource)accountSourceForParameters:(nonnull MSIDRequestParameters *)parameters;
+
 @end
@@ -23,6 +23,8 @@
 
 #import <Foundation/Foundation.h>
 #import "MSIDCacheAccessor.h"
+#import "MSIDAccountMetadata.h"
+#import "MSIDSilentRequestHedge.h"
 
 @class MSIDTokenResponse;
 @class MSIDRequestParameters;
@@ -41,6 +43,29 @@
                                           saveSSOStateOnly:(BOOL)saveSSOStateOnly
                                                      error:(NSError * _Nullable __autoreleasing * _Nullable)error;
 
+// Same as above, recording accountSource as the origin of the account in account metadata. The method above records MSIDAccountMetadataSourceLocal.
+- (nullable MSIDTokenResult *)validateAndSaveTokenResponse:(nonnull MSIDTokenResponse *)tokenResponse
+                                              oauthFactory:(nonnull MSIDOauth2Factory *)factory
+                                                tokenCache:(nonnull id<MSIDCacheAccessor>)tokenCache
+                                      accountMetadataCache:(nullable MSIDAccountMetadataCacheAccessor *)metadataCache
+                                         requestParameters:(nonnull MSIDRequestParameters *)parameters
+                                          saveSSOStateOnly:(BOOL)saveSSOStateOnly
+                                             accountSource:(MSIDAccountMetadataSource)accountSource
+                                                     error:(NSError * _Nullable __autoreleasing * _Nullable)error;
+
+// Same as above, but when hedge is set the response is only saved if leg wins the cache write of the hedged request.
+// The write is claimed after the response has been validated, a leg that lost the race fails with the hedge cancellation error.
+- (nullable MSIDTokenResult *)validateAndSaveTokenResponse:(nonnull MSIDTokenResponse *)tokenResponse
+                                              oauthFactory:(nonnull MSIDOauth2Factory *)factory
+                                                tokenCache:(nonnull id<MSIDCacheAccessor>)tokenCache
+                                      accountMetadataCache:(nullable MSIDAccountMetadataCacheAccessor *)metadataCache
+                                         requestParameters:(nonnull MSIDRequestParameters *)parameters
+                                          saveSSOStateOnly:(BOOL)saveSSOStateOnly
+                                             accountSource:(MSIDAccountMetadataSource)accountSource
+                                                     hedge:(nullable MSIDSilentRequestHedge *)hedge
+                                                  hedgeLeg:(MSIDSilentRequestHedgeLeg)hedgeLeg
+                                                     error:(NSError * _Nullable __autoreleasing * _Nullable)error;
+
 - (nullable MSIDTokenResult *)validateAndSaveBrokerResponse:(nonnull MSIDBrokerResponse *)brokerResponse
                                                   oidcScope:(nullable NSString *)oidcScope
                                            requestAuthority:(nullable NSURL *)requestAuthority
@@ -233,6 +233,7 @@
                                        clientId:configuration.clientId
                                   instanceAware:instanceAware
                                           state:MSIDAccountMetadataStateSignedIn
+                                         source:MSIDAccountMetadataSourceBroker
                                requestAuthority:requestAuthority
                              resultingAuthority:resultingAuthority.url
                            accountMetadataCache:accountMetadataCache
@@ -267,6 +268,48 @@
                                 requestParameters:(MSIDRequestParameters *)parameters
                                  saveSSOStateOnly:(BOOL)saveSSOStateOnly
                                             error:(NSError *__autoreleasing*)error
+{
+    return [self validateAndSaveTokenResponse:tokenResponse
+                                 oauthFactory:factory
+                                   tokenCache:tokenCache
+                         accountMetadataCache:accountMetadataCache
+                            requestParameters:parameters
+                             saveSSOStateOnly:saveSSOStateOnly
+                                accountSource:MSIDAccountMetadataSourceLocal
+                                        error:error];
+}
+
+- (MSIDTokenResult *)validateAndSaveTokenResponse:(MSIDTokenResponse *)tokenResponse
+                                     oauthFactory:(MSIDOauth2Factory *)factory
+                                       tokenCache:(id<MSIDCacheAccessor>)tokenCache
+                             accountMetadataCache:(MSIDAccountMetadataCacheAccessor *)accountMetadataCache
+                                requestParameters:(MSIDRequestParameters *)parameters
+                                 saveSSOStateOnly:(BOOL)saveSSOStateOnly
+                                    accountSource:(MSIDAccountMetadataSource)accountSource
+                                            error:(NSError *__autoreleasing*)error
+{
+    return [self validateAndSaveTokenResponse:tokenResponse
+                                 oauthFactory:factory
+                                   tokenCache:tokenCache
+                         accountMetadataCache:accountMetadataCache
+                            requestParameters:parameters
+                             saveSSOStateOnly:saveSSOStateOnly
+                                accountSource:accountSource
+                                        hedge:nil
+                                     hedgeLeg:MSIDSilentRequestHedgeLegPrimary
+                                        error:error];
+}
+
+- (MSIDTokenResult *)validateAndSaveTokenResponse:(MSIDTokenResponse *)tokenResponse
+                                     oauthFactory:(MSIDOauth2Factory *)factory
+                                       tokenCache:(id<MSIDCacheAccessor>)tokenCache
+                             accountMetadataCache:(MSIDAccountMetadataCacheAccessor *)accountMetadataCache
+                                requestParameters:(MSIDRequestParameters *)parameters
+                                 saveSSOStateOnly:(BOOL)saveSSOStateOnly
+                                    accountSource:(MSIDAccountMetadataSource)accountSource
+                                            hedge:(MSIDSilentRequestHedge *)hedge
+                                         hedgeLeg:(MSIDSilentRequestHedgeLeg)hedgeLeg
+                                            error:(NSError *__autoreleasing*)error
 {
     MSIDTokenResult *tokenResult = [self validateTokenResponse:tokenResponse
                                                   oauthFactory:factory
@@ -280,6 +323,14 @@
         return nil;
     }
     
+    // Claim the cache write only for a valid response, so an error response doesn't cancel the other leg of a hedged request.
+    if (hedge && ![hedge claimCacheWriteForLeg:hedgeLeg])
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelInfo, parameters, @"Other leg of hedged request already saved its response, dropping response without saving it.");
+        if (error) *error = [hedge cancellationErrorForLeg:hedgeLeg correlationId:parameters.correlationId];
+        return nil;
+    }
+    
     if ([MSID_REFRESH_TOKEN_TYPE_BOUND_APP_RT isEqualToString:tokenResponse.additionalServerInfo[MSID_REFRESH_TOKEN_TYPE]] && tokenResponse.boundAppRefreshTokenDeviceId)
     {
         tokenResult.refreshToken = [[MSIDBoundRefreshToken alloc] initWithRefreshToken:(MSIDRefreshToken *)tokenResult.refreshToken
@@ -298,6 +349,7 @@
                                        clientId:parameters.clientId
                                   instanceAware:parameters.instanceAware
                                           state:MSIDAccountMetadataStateSignedIn
+                                         source:accountSource
                                requestAuthority:providedAuthority.url
                              resultingAuthority:resultingAuthority.url
                            accountMetadataCache:accountMetadataCache
@@ -380,6 +432,7 @@
                                      clientId:(NSString *)clientId
                                 instanceAware:(BOOL)instanceAware
                                         state:(MSIDAccountMetadataState)state
+                                       source:(MSIDAccountMetadataSource)source
                              requestAuthority:(NSURL *)requestAuthority
                            resultingAuthority:(NSURL *)resultingAuthority
                          accountMetadataCache:(MSIDAccountMetadataCacheAccessor *)accountMetadataCache
@@ -390,6 +443,7 @@
     [accountMetadataCache updateSignInStateForHomeAccountId:homeAccountId
                                                    clientId:clientId
                                                       state:state
+                                                     source:source
                                                     context:context
                                                       error:&updateMetadataError];
     if (updateMetadataError)
@@ -30,6 +30,8 @@
 #import "MSIDDefaultTokenRequestProvider+Internal.h"
 #import "MSIDSSOExtensionSilentTokenRequest.h"
 #import "MSIDSSOExtensionInteractiveTokenRequest.h"
+#import "MSIDAccountMetadataCacheAccessor.h"
+#import "MSIDAccountIdentifier.h"
 #if TARGET_OS_OSX
 #import "MSIDSSOXpcSilentTokenRequest.h"
 #import "MSIDSSOXpcInteractiveTokenRequest.h"
@@ -158,4 +160,22 @@
 }
 
 
+- (MSIDAccountMetadataSource)accountSourceForParameters:(MSIDRequestParameters *)parameters
+{
+    NSString *homeAccountId = parameters.accountIdentifier.homeAccountId;
+    if (!homeAccountId || !self.accountMetadataCache) return MSIDAccountMetadataSourceUnknown;
+    
+    NSError *error;
+    MSIDAccountMetadataSource source = [self.accountMetadataCache sourceForHomeAccountId:homeAccountId
+                                                                                clientId:parameters.clientId
+                                                                                 context:parameters
+                                                                                   error:&error];
+    if (error)
+    {
+        MSID_LOG_WITH_CTX_PII(MSIDLogLevelWarning, parameters, @"Failed to read account source, error %@", MSID_PII_LOG_MASKABLE(error));
+    }
+    
+    return source;
+}
+
 @end
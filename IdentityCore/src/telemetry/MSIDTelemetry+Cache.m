@@ -27,6 +27,12 @@
 #import "MSIDTelemetryCacheEvent.h"
 #import "MSIDTelemetry+Internal.h"
 #import "MSIDTelemetryEventStrings.h"
+#import "MSIDCacheLookupMetrics.h"
+#import "MSIDCacheLookupHistogram.h"
+#import "MSIDFlightManager.h"
+#import "MSIDConstants.h"
+#import "MSIDExecutionFlowConstants.h"
+#import "MSIDExecutionFlowLogger.h"
 
 @implementation MSIDTelemetry (Cache)
 
@@ -37,7 +43,16 @@
 {
     CONDITIONAL_START_EVENT(CONDITIONAL_SHARED_INSTANCE, [context telemetryRequestId], cacheEventName);
 
-    return [[MSIDTelemetryCacheEvent alloc] initWithName:cacheEventName context:context];
+    MSIDTelemetryCacheEvent *event = [[MSIDTelemetryCacheEvent alloc] initWithName:cacheEventName context:context];
+    
+    if ([cacheEventName isEqualToString:MSID_TELEMETRY_EVENT_TOKEN_CACHE_LOOKUP]
+        && [[MSIDFlightManager sharedInstance] boolForKey:MSID_FLIGHT_CACHE_LOOKUP_METRICS_ENABLED])
+    {
+        event.lookupMetrics = [MSIDCacheLookupMetrics new];
+        [MSIDCacheLookupMetrics beginRecording:event.lookupMetrics];
+    }
+    
+    return event;
 }
 
 + (void)stopCacheEvent:(MSIDTelemetryCacheEvent *)event
@@ -50,6 +65,10 @@
     {
         [event setToken:token];
     }
+    if (event.lookupMetrics)
+    {
+        [self finishLookupMetricsForEvent:event context:context];
+    }
     CONDITIONAL_STOP_EVENT(CONDITIONAL_SHARED_INSTANCE, [context telemetryRequestId], event);
 }
 
@@ -65,6 +84,32 @@
     [self stopCacheEvent:event withItem:nil success:NO context:context];
 }
 
+#pragma mark - Lookup metrics
+
++ (void)finishLookupMetricsForEvent:(MSIDTelemetryCacheEvent *)event
+                            context:(id<MSIDRequestContext>)context
+{
+    MSIDCacheLookupMetrics *metrics = event.lookupMetrics;
+    event.lookupMetrics = nil;
+    
+    [event setCacheLookupMetrics:metrics];
+    
+    // Nested lookups are already part of the enclosing one, only report the outermost
+    if ([MSIDCacheLookupMetrics endRecording:metrics])
+    {
+        return;
+    }
+    
+    [[MSIDCacheLookupHistogram sharedInstance] recordLookupMetrics:metrics];
+    
+    NSDictionary *info = @{MSID_EXECUTION_FLOW_CACHE_ITEMS_FETCHED: @(metrics.itemsFetched),
+                           MSID_EXECUTION_FLOW_CACHE_ITEMS_DISCARDED: @(metrics.deserializationFailures + metrics.itemsRejected),
+                           MSID_EXECUTION_FLOW_CACHE_DATA_SOURCE_TIME: @((NSUInteger)(metrics.dataSourceTime * USEC_PER_SEC)),
+                           MSID_EXECUTION_FLOW_CACHE_FILTER_TIME: @((NSUInteger)(metrics.filterTime * USEC_PER_SEC))};
+    
+    MSIDExecutionFlowInsertTag(MSIDCacheLookupTagToString(MSIDCacheLookupCompletedTag), info, context.correlationId);
+}
+
 @end
 
 #endif
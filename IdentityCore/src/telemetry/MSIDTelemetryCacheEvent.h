@@ -27,8 +27,14 @@
 #import "MSIDCredentialCacheItem.h"
 #import "MSIDCredentialCacheItem+MSIDBaseToken.h"
 
+@class MSIDCacheCompactionResult;
+@class MSIDCacheLookupMetrics;
+
 @interface MSIDTelemetryCacheEvent : MSIDTelemetryBaseEvent
 
+// Set on token cache lookup events while MSID_FLIGHT_CACHE_LOOKUP_METRICS_ENABLED is on.
+@property (nonatomic) MSIDCacheLookupMetrics *lookupMetrics;
+
 - (void)setTokenType:(MSIDCredentialType)tokenType;
 - (void)setStatus:(NSString *)status;
 - (void)setIsRT:(NSString *)isRT;
@@ -43,6 +49,8 @@
 - (void)setCacheWipeTime:(NSString *)wipeTime;
 - (void)setWipeData:(NSDictionary *)wipeData;
 - (void)setExternalCacheSeedingStatus:(NSString *)status;
+- (void)setCacheCompactionResult:(MSIDCacheCompactionResult *)result;
+- (void)setCacheLookupMetrics:(MSIDCacheLookupMetrics *)metrics;
 
 @end
 
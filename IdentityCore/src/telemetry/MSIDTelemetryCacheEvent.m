@@ -29,6 +29,8 @@
 #import "MSIDRefreshToken.h"
 #import "NSDate+MSIDExtensions.h"
 #import "MSIDCacheKey.h"
+#import "MSIDCacheCompactionResult.h"
+#import "MSIDCacheLookupMetrics.h"
 
 @implementation MSIDTelemetryCacheEvent
 
@@ -168,6 +170,45 @@
     [self setProperty:MSID_TELEMETRY_KEY_EXTERNAL_CACHE_SEEDING_STATUS value:status];
 }
 
+- (void)setCacheCompactionResult:(MSIDCacheCompactionResult *)result
+{
+    [self setProperty:MSID_TELEMETRY_KEY_COMPACTION_SCANNED_COUNT value:[NSString stringWithFormat:@"%lu", (unsigned long)result.scannedItemCount]];
+    [self setProperty:MSID_TELEMETRY_KEY_COMPACTION_EXPIRED_AT_COUNT value:[NSString stringWithFormat:@"%lu", (unsigned long)result.expiredAccessTokenCount]];
+    [self setProperty:MSID_TELEMETRY_KEY_COMPACTION_ORPHANED_CREDENTIAL_COUNT value:[NSString stringWithFormat:@"%lu", (unsigned long)result.orphanedCredentialCount]];
+    [self setProperty:MSID_TELEMETRY_KEY_COMPACTION_ORPHANED_APP_METADATA_COUNT value:[NSString stringWithFormat:@"%lu", (unsigned long)result.orphanedAppMetadataCount]];
+    [self setProperty:MSID_TELEMETRY_KEY_COMPACTION_SKIPPED_COUNT value:[NSString stringWithFormat:@"%lu", (unsigned long)result.skippedItemCount]];
+}
+
+- (void)setCacheLookupMetrics:(MSIDCacheLookupMetrics *)metrics
+{
+    if (!metrics)
+    {
+        return;
+    }
+    
+    [self setProperty:MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_FETCHED value:[NSString stringWithFormat:@"%lu", (unsigned long)metrics.itemsFetched]];
+    [self setProperty:MSID_TELEMETRY_KEY_CACHE_LOOKUP_DESERIALIZATION_FAILURES value:[NSString stringWithFormat:@"%lu", (unsigned long)metrics.deserializationFailures]];
+    [self setProperty:MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_REJECTED value:[NSString stringWithFormat:@"%lu", (unsigned long)metrics.itemsRejected]];
+    [self setProperty:MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_RETURNED value:[NSString stringWithFormat:@"%lu", (unsigned long)metrics.itemsReturned]];
+    [self setProperty:MSID_TELEMETRY_KEY_CACHE_LOOKUP_DATA_SOURCE_TIME value:[NSString stringWithFormat:@"%.3f", metrics.dataSourceTime * 1000]];
+    [self setProperty:MSID_TELEMETRY_KEY_CACHE_LOOKUP_FILTER_TIME value:[NSString stringWithFormat:@"%.3f", metrics.filterTime * 1000]];
+    
+    // Only reasons that rejected something, e.g. "realm:3,target:12"
+    NSMutableArray *reasons = [NSMutableArray new];
+    
+    for (NSInteger reason = 0; reason < MSIDCacheLookupRejectionReasonCount; reason++)
+    {
+        NSUInteger count = [metrics rejectionCountForReason:reason];
+        
+        if (count)
+        {
+            [reasons addObject:[NSString stringWithFormat:@"%@:%lu", MSIDCacheLookupRejectionReasonToString(reason), (unsigned long)count]];
+        }
+    }
+    
+    [self setProperty:MSID_TELEMETRY_KEY_CACHE_LOOKUP_REJECTION_REASONS value:[reasons componentsJoinedByString:@","]];
+}
+
 #pragma mark - MSIDTelemetryBaseEvent
 
 + (NSArray<NSString *> *)propertiesToAggregate
@@ -186,7 +227,19 @@
                                      MSID_TELEMETRY_KEY_SPE_INFO,
                                      MSID_TELEMETRY_KEY_WIPE_APP,
                                      MSID_TELEMETRY_KEY_WIPE_TIME,
-                                     MSID_TELEMETRY_KEY_EXTERNAL_CACHE_SEEDING_STATUS
+                                     MSID_TELEMETRY_KEY_EXTERNAL_CACHE_SEEDING_STATUS,
+                                     MSID_TELEMETRY_KEY_COMPACTION_SCANNED_COUNT,
+                                     MSID_TELEMETRY_KEY_COMPACTION_EXPIRED_AT_COUNT,
+                                     MSID_TELEMETRY_KEY_COMPACTION_ORPHANED_CREDENTIAL_COUNT,
+                                     MSID_TELEMETRY_KEY_COMPACTION_ORPHANED_APP_METADATA_COUNT,
+                                     MSID_TELEMETRY_KEY_COMPACTION_SKIPPED_COUNT,
+                                     MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_FETCHED,
+                                     MSID_TELEMETRY_KEY_CACHE_LOOKUP_DESERIALIZATION_FAILURES,
+                                     MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_REJECTED,
+                                     MSID_TELEMETRY_KEY_CACHE_LOOKUP_REJECTION_REASONS,
+                                     MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_RETURNED,
+                                     MSID_TELEMETRY_KEY_CACHE_LOOKUP_DATA_SOURCE_TIME,
+                                     MSID_TELEMETRY_KEY_CACHE_LOOKUP_FILTER_TIME
                                      ]];
     });
     
@@ -40,6 +40,7 @@ extern NSString *const MSID_TELEMETRY_EVENT_AUTHORIZATION_CODE;
 extern NSString *const MSID_TELEMETRY_EVENT_TOKEN_CACHE_LOOKUP;
 extern NSString *const MSID_TELEMETRY_EVENT_TOKEN_CACHE_WRITE;
 extern NSString *const MSID_TELEMETRY_EVENT_TOKEN_CACHE_DELETE;
+extern NSString *const MSID_TELEMETRY_EVENT_CACHE_COMPACTION;
 extern NSString *const MSID_TELEMETRY_EVENT_APP_METADATA_WRITE;
 extern NSString *const MSID_TELEMETRY_EVENT_APP_METADATA_DELETE;
 extern NSString *const MSID_TELEMETRY_EVENT_UI_EVENT;
@@ -118,6 +119,18 @@ extern NSString *const MSID_TELEMETRY_KEY_CLIENT_TELEMETRY_RAW;
 extern NSString *const MSID_TELEMETRY_KEY_ACCOUNT_SELECTION_ISSUE;
 extern NSString *const MSID_TELEMETRY_KEY_IS_EXTERNAL_CACHE_SEEDING;
 extern NSString *const MSID_TELEMETRY_KEY_EXTERNAL_CACHE_SEEDING_STATUS;
+extern NSString *const MSID_TELEMETRY_KEY_COMPACTION_SCANNED_COUNT;
+extern NSString *const MSID_TELEMETRY_KEY_COMPACTION_EXPIRED_AT_COUNT;
+extern NSString *const MSID_TELEMETRY_KEY_COMPACTION_ORPHANED_CREDENTIAL_COUNT;
+extern NSString *const MSID_TELEMETRY_KEY_COMPACTION_ORPHANED_APP_METADATA_COUNT;
+extern NSString *const MSID_TELEMETRY_KEY_COMPACTION_SKIPPED_COUNT;
+extern NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_FETCHED;
+extern NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_DESERIALIZATION_FAILURES;
+extern NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_REJECTED;
+extern NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_REJECTION_REASONS;
+extern NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_RETURNED;
+extern NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_DATA_SOURCE_TIME;
+extern NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_FILTER_TIME;
 
 extern NSString *const MSID_TELEMETRY_VALUE_YES;
 extern NSString *const MSID_TELEMETRY_VALUE_NO;
@@ -41,6 +41,7 @@ NSString *const MSID_TELEMETRY_EVENT_AUTHORIZATION_CODE     = @"authorization_co
 NSString *const MSID_TELEMETRY_EVENT_TOKEN_CACHE_LOOKUP     = @"token_cache_lookup";
 NSString *const MSID_TELEMETRY_EVENT_TOKEN_CACHE_WRITE      = @"token_cache_write";
 NSString *const MSID_TELEMETRY_EVENT_TOKEN_CACHE_DELETE     = @"token_cache_delete";
+NSString *const MSID_TELEMETRY_EVENT_CACHE_COMPACTION       = @"cache_compaction";
 NSString *const MSID_TELEMETRY_EVENT_APP_METADATA_WRITE     = @"app_metadata_write";
 NSString *const MSID_TELEMETRY_EVENT_APP_METADATA_DELETE     = @"app_metadata_delete";
 
@@ -81,6 +82,18 @@ NSString *const MSID_TELEMETRY_KEY_IS_MRRT                      = @"is_mrrt";
 NSString *const MSID_TELEMETRY_KEY_IS_FRT                       = @"is_frt";
 NSString *const MSID_TELEMETRY_KEY_IS_EXTERNAL_CACHE_SEEDING    = @"is_external_cache_seeding";
 NSString *const MSID_TELEMETRY_KEY_EXTERNAL_CACHE_SEEDING_STATUS = @"external_cache_seeding_status";
+NSString *const MSID_TELEMETRY_KEY_COMPACTION_SCANNED_COUNT     = @"compaction_scanned_count";
+NSString *const MSID_TELEMETRY_KEY_COMPACTION_EXPIRED_AT_COUNT  = @"compaction_expired_at_count";
+NSString *const MSID_TELEMETRY_KEY_COMPACTION_ORPHANED_CREDENTIAL_COUNT = @"compaction_orphaned_credential_count";
+NSString *const MSID_TELEMETRY_KEY_COMPACTION_ORPHANED_APP_METADATA_COUNT = @"compaction_orphaned_app_metadata_count";
+NSString *const MSID_TELEMETRY_KEY_COMPACTION_SKIPPED_COUNT     = @"compaction_skipped_count";
+NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_FETCHED   = @"cache_lookup_items_fetched";
+NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_DESERIALIZATION_FAILURES = @"cache_lookup_deserialization_failures";
+NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_REJECTED  = @"cache_lookup_items_rejected";
+NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_REJECTION_REASONS = @"cache_lookup_rejection_reasons";
+NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_RETURNED  = @"cache_lookup_items_returned";
+NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_DATA_SOURCE_TIME = @"cache_lookup_data_source_time_ms";
+NSString *const MSID_TELEMETRY_KEY_CACHE_LOOKUP_FILTER_TIME     = @"cache_lookup_filter_time_ms";
 NSString *const MSID_TELEMETRY_KEY_RT_STATUS                    = @"token_rt_status";
 NSString *const MSID_TELEMETRY_KEY_MRRT_STATUS                  = @"token_mrrt_status";
 NSString *const MSID_TELEMETRY_KEY_FRT_STATUS                   = @"token_frt_status";
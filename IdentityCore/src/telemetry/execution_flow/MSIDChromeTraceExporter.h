@@ -0,0 +1,48 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+#import "MSIDTracer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^MSIDChromeTraceHandler)(NSData *traceData, NSUUID *correlationId);
+
+/**
+ Exporter that converts the spans of each finished request into Chrome trace event JSON
+ (loadable in chrome://tracing or Perfetto) and passes it to the handler.
+ */
+@interface MSIDChromeTraceExporter : NSObject <MSIDTraceExporting>
+
+- (instancetype)initWithHandler:(MSIDChromeTraceHandler)handler;
+
+// Complete ("X") events with microsecond timestamps. Span ids, the correlation id and span attributes are written to args.
++ (nullable NSData *)traceDataWithSpans:(NSArray<MSIDTraceSpan *> *)spans;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,99 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDChromeTraceExporter.h"
+
+@interface MSIDChromeTraceExporter()
+
+@property (nonatomic, copy) MSIDChromeTraceHandler handler;
+
+@end
+
+@implementation MSIDChromeTraceExporter
+
+- (instancetype)initWithHandler:(MSIDChromeTraceHandler)handler
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _handler = [handler copy];
+    }
+    
+    return self;
+}
+
+- (void)exportSpans:(NSArray<MSIDTraceSpan *> *)spans correlationId:(NSUUID *)correlationId
+{
+    NSData *traceData = [self.class traceDataWithSpans:spans];
+    if (!traceData || !self.handler) return;
+    
+    self.handler(traceData, correlationId);
+}
+
++ (NSData *)traceDataWithSpans:(NSArray<MSIDTraceSpan *> *)spans
+{
+    int pid = [[NSProcessInfo processInfo] processIdentifier];
+    NSMutableArray *events = [NSMutableArray arrayWithCapacity:spans.count];
+    
+    for (MSIDTraceSpan *span in spans)
+    {
+        if (!span.endTimeNanoseconds) continue;
+        
+        NSMutableDictionary *args = [NSMutableDictionary new];
+        [span.attributes enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, __unused BOOL *stop) {
+            args[key] = [self isJSONScalar:value] ? value : [value description];
+        }];
+        args[@"correlation_id"] = span.correlationId.UUIDString;
+        args[@"span_id"] = @(span.spanId);
+        args[@"parent_span_id"] = @(span.parentSpanId);
+        
+        [events addObject:@{@"name" : span.name,
+                            @"cat" : @"msid",
+                            @"ph" : @"X",
+                            @"ts" : @(span.startTimeNanoseconds / 1000.0),
+                            @"dur" : @(span.durationNanoseconds / 1000.0),
+                            @"pid" : @(pid),
+                            @"tid" : @(span.threadId),
+                            @"args" : args}];
+    }
+    
+    NSError *error = nil;
+    NSData *data = [NSJSONSerialization dataWithJSONObject:@{@"traceEvents" : events, @"displayTimeUnit" : @"ns"}
+                                                   options:0
+                                                     error:&error];
+    if (!data)
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelWarning, nil, @"Failed to serialize trace events, error %ld", (long)error.code);
+    }
+    
+    return data;
+}
+
++ (BOOL)isJSONScalar:(id)value
+{
+    return [value isKindOfClass:NSString.class] || [value isKindOfClass:NSNumber.class] || [value isKindOfClass:NSNull.class];
+}
+
+@end
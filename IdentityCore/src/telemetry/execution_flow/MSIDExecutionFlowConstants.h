@@ -45,6 +45,10 @@ extern NSString * _Nonnull const MSID_EXECUTION_FLOW_THREAD_ID;
 // Optional
 extern NSString * _Nonnull const MSID_EXECUTION_FLOW_DIAGNOSTIC_ID;
 extern NSString * _Nonnull const MSID_EXECUTION_FLOW_ERROR_CODE;
+extern NSString * _Nonnull const MSID_EXECUTION_FLOW_CACHE_ITEMS_FETCHED;
+extern NSString * _Nonnull const MSID_EXECUTION_FLOW_CACHE_ITEMS_DISCARDED;
+extern NSString * _Nonnull const MSID_EXECUTION_FLOW_CACHE_DATA_SOURCE_TIME;
+extern NSString * _Nonnull const MSID_EXECUTION_FLOW_CACHE_FILTER_TIME;
 
 // Log messages
 FOUNDATION_EXPORT NSString * _Nonnull const MSID_EXECUTION_FLOW_TAG_NIL_MESSAGE;
@@ -68,6 +72,7 @@ typedef NS_ENUM(NSInteger, MSIDExecutionFlowNetworkTag)
     MSIDStartToRetryOnNetworkFailureTag,
     MSIDParseNetworkResponseTag,
     MSIDOtherHttpNetworkStatusCodeTag,
+    MSIDCircuitBreakerOpenTag,
 };
 
 /// Returns the string representation for each MSIDExecutionFlowNetworkTag value.
@@ -96,7 +101,10 @@ typedef NS_ENUM(NSInteger, MSIDRequestControllerFactoryTag)
     MSIDInteractiveControllerCanPerformSsoExtTag,
     MSIDInteractiveControllerCanPerformBrokerXpcTag,
     MSIDInteractiveControllerNoBrokerFallbackTag,
-    MSIDInteractiveControllerFinishTag
+    MSIDInteractiveControllerFinishTag,
+    MSIDSilentControllerAccountSourceTag,
+    MSIDSilentControllerBrokerOnlyAccountTag,
+    MSIDSilentControllerLocalOnlyAccountTag
 };
 
 /// Returns the string representation for each MSIDRequestControllerFactoryTag value.
@@ -141,3 +149,12 @@ typedef NS_ENUM(NSInteger, MSIDPkeyAuthTag)
 
 /// Returns the string representation for each MSIDPkeyAuthTag value.
 FOUNDATION_EXPORT NSString * _Nonnull MSIDPkeyAuthTagToString(MSIDPkeyAuthTag state);
+
+/// An enum of MSIDCacheLookupTag.
+typedef NS_ENUM(NSInteger, MSIDCacheLookupTag)
+{
+    MSIDCacheLookupCompletedTag = 0
+};
+
+/// Returns the string representation for each MSIDCacheLookupTag value.
+FOUNDATION_EXPORT NSString * _Nonnull MSIDCacheLookupTagToString(MSIDCacheLookupTag state);
@@ -34,6 +34,18 @@ NSString *const MSID_EXECUTION_FLOW_DIAGNOSTIC_ID  = @"d";
 
 NSString *const MSID_EXECUTION_FLOW_ERROR_CODE  = @"e";
 
+// Items read from storage, including the ones that failed to deserialize
+NSString *const MSID_EXECUTION_FLOW_CACHE_ITEMS_FETCHED  = @"cf";
+
+// Items that failed to deserialize or were rejected by the matchers
+NSString *const MSID_EXECUTION_FLOW_CACHE_ITEMS_DISCARDED  = @"cx";
+
+// Microseconds
+NSString *const MSID_EXECUTION_FLOW_CACHE_DATA_SOURCE_TIME  = @"cd";
+
+// Microseconds
+NSString *const MSID_EXECUTION_FLOW_CACHE_FILTER_TIME  = @"cm";
+
 // Log messages
 NSString *const MSID_EXECUTION_FLOW_TAG_NIL_MESSAGE = @"Tag cannot be nil";
 NSString *const MSID_EXECUTION_FLOW_TID_NIL_MESSAGE = @"tid cannot be nil";
@@ -66,6 +78,8 @@ NSString *MSIDExecutionFlowNetworkTagToString(MSIDExecutionFlowNetworkTag state)
             return @"fxjo7";
         case MSIDOtherHttpNetworkStatusCodeTag:
             return @"5kbvm";
+        case MSIDCircuitBreakerOpenTag:
+            return @"c8kbo";
     }
 
     // Fallback for any future enum values
@@ -112,6 +126,12 @@ NSString *MSIDRequestControllerFactoryTagToString(MSIDRequestControllerFactoryTa
             return @"beb43";
         case MSIDInteractiveControllerFinishTag:
             return @"29h5q";
+        case MSIDSilentControllerAccountSourceTag:
+            return @"UNTAGGED";
+        case MSIDSilentControllerBrokerOnlyAccountTag:
+            return @"UNTAGGED";
+        case MSIDSilentControllerLocalOnlyAccountTag:
+            return @"UNTAGGED";
     }
 
     // Fallback for any future enum values
@@ -173,3 +193,14 @@ NSString *MSIDPkeyAuthTagToString(MSIDPkeyAuthTag state)
     // Fallback for any future enum values
     return [NSString stringWithFormat:@"MSIDPkeyAuthTag(%ld)", (long)state];
 }
+
+NSString *MSIDCacheLookupTagToString(MSIDCacheLookupTag state)
+{
+    switch (state)
+    {
+        case MSIDCacheLookupCompletedTag:
+            return @"UNTAGGED";
+    }
+    // Fallback for any future enum values
+    return [NSString stringWithFormat:@"MSIDCacheLookupTag(%ld)", (long)state];
+}
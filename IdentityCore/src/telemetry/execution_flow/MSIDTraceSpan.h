@@ -0,0 +1,67 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A timed phase of a request. Spans are created and finished by MSIDTracer, timestamps are taken from a monotonic clock
+ in nanoseconds. Spans of the same request share a correlation id and form a tree through parentSpanId.
+ */
+@interface MSIDTraceSpan : NSObject
+
+@property (nonatomic, readonly) NSString *name;
+@property (nonatomic, readonly) NSUUID *correlationId;
+@property (nonatomic, readonly) uint64_t spanId;
+// 0 for spans started while no other span of the request was open.
+@property (nonatomic, readonly) uint64_t parentSpanId;
+@property (nonatomic, readonly, getter=isRoot) BOOL root;
+@property (nonatomic, readonly) uint64_t startTimeNanoseconds;
+// 0 while the span is open.
+@property (nonatomic, readonly) uint64_t endTimeNanoseconds;
+@property (nonatomic, readonly) uint64_t durationNanoseconds;
+@property (nonatomic, readonly) uint64_t threadId;
+@property (nonatomic, readonly) NSDictionary<NSString *, id> *attributes;
+
+- (instancetype)initWithName:(NSString *)name
+               correlationId:(NSUUID *)correlationId
+                      spanId:(uint64_t)spanId
+                parentSpanId:(uint64_t)parentSpanId
+                        root:(BOOL)root;
+
+- (void)setAttribute:(nullable id)value forKey:(NSString *)key;
+
+// Called by MSIDTracer, returns NO if the span was already finished.
+- (BOOL)finish;
+
+// Monotonic clock used for span timestamps.
++ (uint64_t)currentTimeNanoseconds;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
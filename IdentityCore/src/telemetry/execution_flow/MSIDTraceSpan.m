@@ -0,0 +1,112 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#include <pthread.h>
+#include <time.h>
+#import "MSIDTraceSpan.h"
+
+@interface MSIDTraceSpan()
+
+@property (nonatomic) uint64_t endTimeNanoseconds;
+@property (nonatomic) NSMutableDictionary<NSString *, id> *mutableAttributes;
+
+@end
+
+@implementation MSIDTraceSpan
+
+- (instancetype)initWithName:(NSString *)name
+               correlationId:(NSUUID *)correlationId
+                      spanId:(uint64_t)spanId
+                parentSpanId:(uint64_t)parentSpanId
+                        root:(BOOL)root
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _name = name;
+        _correlationId = correlationId;
+        _spanId = spanId;
+        _parentSpanId = parentSpanId;
+        _root = root;
+        
+        __uint64_t tid = 0;
+        if (pthread_threadid_np(NULL, &tid) != 0)
+        {
+            tid = (uint64_t)[NSThread currentThread].hash; // Fallback
+        }
+        _threadId = tid;
+        _startTimeNanoseconds = [self.class currentTimeNanoseconds];
+    }
+    
+    return self;
+}
+
++ (uint64_t)currentTimeNanoseconds
+{
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+- (uint64_t)durationNanoseconds
+{
+    uint64_t endTime = self.endTimeNanoseconds;
+    return endTime ? endTime - self.startTimeNanoseconds : 0;
+}
+
+- (void)setAttribute:(id)value forKey:(NSString *)key
+{
+    if (!key) return;
+    
+    @synchronized (self)
+    {
+        if (!self.mutableAttributes) self.mutableAttributes = [NSMutableDictionary new];
+        self.mutableAttributes[key] = value;
+    }
+}
+
+- (NSDictionary<NSString *, id> *)attributes
+{
+    @synchronized (self)
+    {
+        return [self.mutableAttributes copy] ?: @{};
+    }
+}
+
+- (BOOL)finish
+{
+    @synchronized (self)
+    {
+        if (self.endTimeNanoseconds) return NO;
+        
+        self.endTimeNanoseconds = [self.class currentTimeNanoseconds];
+        return YES;
+    }
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %@, span %llu, parent %llu, duration %llu ns>", self.class, self.name, self.spanId, self.parentSpanId, self.durationNanoseconds];
+}
+
+@end
@@ -0,0 +1,112 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+#import "MSIDTraceSpan.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@protocol MSIDTraceExporting <NSObject>
+
+/**
+ Called on a background queue once a request finishes: its root span has ended and none of its spans are open.
+ Spans started without a root span are exported once they have been idle for idleTraceTimeout.
+ Spans are ordered by start time.
+ */
+- (void)exportSpans:(NSArray<MSIDTraceSpan *> *)spans correlationId:(NSUUID *)correlationId;
+
+@end
+
+// Span names
+extern NSString * _Nonnull const MSIDTraceSpanControllerSelection;
+extern NSString * _Nonnull const MSIDTraceSpanSilentRequest;
+extern NSString * _Nonnull const MSIDTraceSpanInteractiveRequest;
+extern NSString * _Nonnull const MSIDTraceSpanCacheRead;
+extern NSString * _Nonnull const MSIDTraceSpanThrottlingCheck;
+extern NSString * _Nonnull const MSIDTraceSpanNetworkSend;
+extern NSString * _Nonnull const MSIDTraceSpanResponseParse;
+extern NSString * _Nonnull const MSIDTraceSpanCacheWrite;
+extern NSString * _Nonnull const MSIDTraceSpanBrokerIPC;
+extern NSString * _Nonnull const MSIDTraceSpanAuthorityResolution;
+extern NSString * _Nonnull const MSIDTraceSpanWebUI;
+extern NSString * _Nonnull const MSIDTraceSpanSignoutRequest;
+
+/**
+ Collects spans per correlation id and hands finished requests to the installed exporter.
+ Tracing is enabled only while an exporter is installed, otherwise starting a span is a single flag check.
+ A span becomes a child of the most recently started open span of the same request.
+ 
+ Request controllers start a root span per request. Spans of the same correlation id started outside it, e.g. network calls
+ made outside a controller or spans of a request leg that finished after the request, are collected as a request
+ without a root span.
+ */
+@interface MSIDTracer : NSObject
+
++ (MSIDTracer *)sharedInstance;
+
+// Installing an exporter enables tracing, setting nil disables it and drops all collected spans.
+@property (nonatomic, nullable) id<MSIDTraceExporting> exporter;
+
+// Requests without a root span are exported once none of their spans has been open for this long. Default: 30 seconds.
+@property (atomic) NSTimeInterval idleTraceTimeout;
+// Requests that still have open spans after this long, e.g. because their root span was never ended, are dropped. Default: 10 minutes.
+@property (atomic) NSTimeInterval maxTraceAge;
+
+- (nullable MSIDTraceSpan *)startSpanWithName:(NSString *)name
+                                correlationId:(nullable NSUUID *)correlationId
+                                         root:(BOOL)root;
+
+- (void)endSpan:(nullable MSIDTraceSpan *)span;
+
+@end
+
+FOUNDATION_EXPORT BOOL MSIDTraceIsEnabled(void);
+
+// Convenience inline functions, no-ops while tracing is disabled.
+NS_INLINE MSIDTraceSpan * _Nullable MSIDTraceSpanStart(NSString *name, NSUUID * _Nullable correlationId) __attribute__((unused));
+NS_INLINE MSIDTraceSpan * _Nullable MSIDTraceSpanStart(NSString *name, NSUUID * _Nullable correlationId)
+{
+    if (!MSIDTraceIsEnabled()) return nil;
+    
+    return [[MSIDTracer sharedInstance] startSpanWithName:name correlationId:correlationId root:NO];
+}
+
+// Starts the span that covers a whole request, the request's spans are exported when it ends.
+NS_INLINE MSIDTraceSpan * _Nullable MSIDTraceRootSpanStart(NSString *name, NSUUID * _Nullable correlationId) __attribute__((unused));
+NS_INLINE MSIDTraceSpan * _Nullable MSIDTraceRootSpanStart(NSString *name, NSUUID * _Nullable correlationId)
+{
+    if (!MSIDTraceIsEnabled()) return nil;
+    
+    return [[MSIDTracer sharedInstance] startSpanWithName:name correlationId:correlationId root:YES];
+}
+
+NS_INLINE void MSIDTraceSpanEnd(MSIDTraceSpan * _Nullable span) __attribute__((unused));
+NS_INLINE void MSIDTraceSpanEnd(MSIDTraceSpan * _Nullable span)
+{
+    if (!span) return;
+    
+    [[MSIDTracer sharedInstance] endSpan:span];
+}
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,276 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <stdatomic.h>
+#import "MSIDTracer.h"
+#import "NSString+MSIDExtensions.h"
+
+#define MAX_TRACED_REQUESTS 200
+
+NSString *const MSIDTraceSpanControllerSelection = @"controller_selection";
+NSString *const MSIDTraceSpanSilentRequest = @"silent_request";
+NSString *const MSIDTraceSpanInteractiveRequest = @"interactive_request";
+NSString *const MSIDTraceSpanCacheRead = @"cache_read";
+NSString *const MSIDTraceSpanThrottlingCheck = @"throttling_check";
+NSString *const MSIDTraceSpanNetworkSend = @"network_send";
+NSString *const MSIDTraceSpanResponseParse = @"response_parse";
+NSString *const MSIDTraceSpanCacheWrite = @"cache_write";
+NSString *const MSIDTraceSpanBrokerIPC = @"broker_ipc";
+NSString *const MSIDTraceSpanAuthorityResolution = @"authority_resolution";
+NSString *const MSIDTraceSpanWebUI = @"web_ui";
+NSString *const MSIDTraceSpanSignoutRequest = @"signout_request";
+
+static atomic_bool s_traceEnabled = false;
+
+BOOL MSIDTraceIsEnabled(void)
+{
+    return atomic_load_explicit(&s_traceEnabled, memory_order_relaxed);
+}
+
+@interface MSIDTraceState : NSObject
+
+@property (nonatomic) NSMutableArray<MSIDTraceSpan *> *spans;
+@property (nonatomic) NSMutableArray<MSIDTraceSpan *> *openSpans;
+@property (nonatomic) BOOL hasRoot;
+@property (nonatomic) BOOL rootEnded;
+@property (nonatomic) uint64_t startTimeNanoseconds;
+// Last time a span of the request started or ended.
+@property (nonatomic) uint64_t lastActivityNanoseconds;
+
+@end
+
+@implementation MSIDTraceState
+
+- (instancetype)init
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _spans = [NSMutableArray new];
+        _openSpans = [NSMutableArray new];
+        _startTimeNanoseconds = [MSIDTraceSpan currentTimeNanoseconds];
+        _lastActivityNanoseconds = _startTimeNanoseconds;
+    }
+    
+    return self;
+}
+
+@end
+
+@interface MSIDTracer()
+{
+    id<MSIDTraceExporting> _exporter;
+    atomic_ullong _lastSpanId;
+}
+
+@property (nonatomic) NSMutableDictionary<NSUUID *, MSIDTraceState *> *traces;
+
+@end
+
+@implementation MSIDTracer
+
++ (MSIDTracer *)sharedInstance
+{
+    static dispatch_once_t once;
+    static MSIDTracer *singleton = nil;
+    
+    dispatch_once(&once, ^{
+        singleton = [[MSIDTracer alloc] init];
+    });
+    
+    return singleton;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _traces = [NSMutableDictionary new];
+        _idleTraceTimeout = 30;
+        _maxTraceAge = 600;
+    }
+    
+    return self;
+}
+
+- (id<MSIDTraceExporting>)exporter
+{
+    @synchronized (self)
+    {
+        return _exporter;
+    }
+}
+
+- (void)setExporter:(id<MSIDTraceExporting>)exporter
+{
+    @synchronized (self)
+    {
+        _exporter = exporter;
+        [self.traces removeAllObjects];
+        atomic_store(&s_traceEnabled, exporter != nil);
+    }
+}
+
+- (MSIDTraceSpan *)startSpanWithName:(NSString *)name
+                       correlationId:(NSUUID *)correlationId
+                                root:(BOOL)root
+{
+    if (!MSIDTraceIsEnabled() || !correlationId || [NSString msidIsStringNilOrBlank:name]) return nil;
+    
+    NSDictionary<NSUUID *, NSArray<MSIDTraceSpan *> *> *evictedTraces = nil;
+    MSIDTraceSpan *span = nil;
+    id<MSIDTraceExporting> exporter = nil;
+    
+    @synchronized (self)
+    {
+        if (!_exporter) return nil;
+        
+        exporter = _exporter;
+        MSIDTraceState *state = self.traces[correlationId];
+        if (!state)
+        {
+            evictedTraces = [self evictStaleTraces];
+            
+            if (self.traces.count >= MAX_TRACED_REQUESTS)
+            {
+                MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, nil, @"The number of traced requests is reaching the maximum, cannot trace new requests. Please check that root spans are ended.");
+            }
+            else
+            {
+                state = [MSIDTraceState new];
+                self.traces[correlationId] = state;
+            }
+        }
+        
+        if (state)
+        {
+            MSIDTraceSpan *parent = state.openSpans.lastObject;
+            uint64_t spanId = atomic_fetch_add(&_lastSpanId, 1) + 1;
+            span = [[MSIDTraceSpan alloc] initWithName:name
+                                         correlationId:correlationId
+                                                spanId:spanId
+                                          parentSpanId:parent.spanId
+                                                  root:root];
+            [state.spans addObject:span];
+            [state.openSpans addObject:span];
+            if (root) state.hasRoot = YES;
+            state.lastActivityNanoseconds = span.startTimeNanoseconds;
+        }
+    }
+    
+    for (NSUUID *evictedCorrelationId in evictedTraces)
+    {
+        [self exportSpans:evictedTraces[evictedCorrelationId] correlationId:evictedCorrelationId exporter:exporter];
+    }
+    
+    return span;
+}
+
+- (void)endSpan:(MSIDTraceSpan *)span
+{
+    if (!span || ![span finish]) return;
+    
+    NSArray<MSIDTraceSpan *> *finishedSpans = nil;
+    id<MSIDTraceExporting> exporter = nil;
+    
+    @synchronized (self)
+    {
+        MSIDTraceState *state = self.traces[span.correlationId];
+        if (![state.openSpans containsObject:span]) return;
+        
+        [state.openSpans removeObjectIdenticalTo:span];
+        state.lastActivityNanoseconds = span.endTimeNanoseconds;
+        if (span.isRoot) state.rootEnded = YES;
+        
+        if (!state.rootEnded || state.openSpans.count) return;
+        
+        [self.traces removeObjectForKey:span.correlationId];
+        finishedSpans = [state.spans copy];
+        exporter = _exporter;
+    }
+    
+    [self exportSpans:finishedSpans correlationId:span.correlationId exporter:exporter];
+}
+
+#pragma mark - Private
+
+// Must be called under @synchronized (self). Removes requests without a root span that have been idle for idleTraceTimeout
+// and requests older than maxTraceAge. If the limit is still reached, the least recently active idle request without
+// a root span is removed too. Returns the removed requests that can be exported, the others are dropped.
+- (NSDictionary<NSUUID *, NSArray<MSIDTraceSpan *> *> *)evictStaleTraces
+{
+    uint64_t now = [MSIDTraceSpan currentTimeNanoseconds];
+    uint64_t idleTimeout = (uint64_t)(MAX(self.idleTraceTimeout, 0) * NSEC_PER_SEC);
+    uint64_t maxAge = (uint64_t)(MAX(self.maxTraceAge, 0) * NSEC_PER_SEC);
+    
+    NSMutableDictionary<NSUUID *, NSArray<MSIDTraceSpan *> *> *evictedTraces = [NSMutableDictionary new];
+    NSUUID *leastRecentlyActiveCorrelationId = nil;
+    uint64_t leastRecentActivity = UINT64_MAX;
+    
+    for (NSUUID *correlationId in [self.traces allKeys])
+    {
+        MSIDTraceState *state = self.traces[correlationId];
+        BOOL idleWithoutRoot = !state.hasRoot && !state.openSpans.count;
+        
+        if (idleWithoutRoot && now - state.lastActivityNanoseconds >= idleTimeout)
+        {
+            evictedTraces[correlationId] = [state.spans copy];
+            [self.traces removeObjectForKey:correlationId];
+        }
+        else if (now - state.startTimeNanoseconds >= maxAge)
+        {
+            MSID_LOG_WITH_CORR(MSIDLogLevelVerbose, correlationId, @"Dropping trace with %lu open spans, request didn't finish in %f seconds.", (unsigned long)state.openSpans.count, self.maxTraceAge);
+            [self.traces removeObjectForKey:correlationId];
+        }
+        else if (idleWithoutRoot && state.lastActivityNanoseconds < leastRecentActivity)
+        {
+            leastRecentlyActiveCorrelationId = correlationId;
+            leastRecentActivity = state.lastActivityNanoseconds;
+        }
+    }
+    
+    if (self.traces.count >= MAX_TRACED_REQUESTS && leastRecentlyActiveCorrelationId)
+    {
+        evictedTraces[leastRecentlyActiveCorrelationId] = [self.traces[leastRecentlyActiveCorrelationId].spans copy];
+        [self.traces removeObjectForKey:leastRecentlyActiveCorrelationId];
+    }
+    
+    return evictedTraces;
+}
+
+- (void)exportSpans:(NSArray<MSIDTraceSpan *> *)spans
+      correlationId:(NSUUID *)correlationId
+           exporter:(id<MSIDTraceExporting>)exporter
+{
+    if (!exporter || !spans.count) return;
+    
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        [exporter exportSpans:spans correlationId:correlationId];
+    });
+}
+
+@end
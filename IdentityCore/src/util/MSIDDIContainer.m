@@ -23,11 +23,16 @@
 
 #import "MSIDDIContainer.h"
 #import "MSIDLogger+Internal.h"
+#import <objc/runtime.h>
 
 @interface MSIDDIContainerEntry : NSObject
 
 @property (nonatomic, assign) MSIDDIContainerLifetime lifetime;
 @property (nonatomic, copy) id _Nonnull (^factory)(void);
+// Installed once for singleton lifetime under @synchronized(entry); read without locking.
+@property (atomic) id singletonInstance;
+// Last class that passed protocol conformance validation for this registration.
+@property (atomic) Class validatedImplClass;
 
 @end
 
@@ -36,8 +41,9 @@
 
 @interface MSIDDIContainer ()
 
-@property (nonatomic) NSMutableDictionary<NSString *, MSIDDIContainerEntry *> *entryByKey;
-@property (nonatomic) NSMutableDictionary<NSString *, id> *singletonCache;
+// Registry keyed by the Class / Protocol pointer. A published table is never mutated:
+// writers publish a modified copy under a barrier, so resolution is a pointer load and a lookup.
+@property (atomic) NSMapTable<id, MSIDDIContainerEntry *> *entryByKey;
 @property (nonatomic) dispatch_queue_t synchronizationQueue;
 
 @end
@@ -64,8 +70,7 @@
 
     if (self)
     {
-        _entryByKey = [NSMutableDictionary new];
-        _singletonCache = [NSMutableDictionary new];
+        _entryByKey = [self.class newEntryTable];
         NSString *queueName = [NSString stringWithFormat:@"com.microsoft.msiddicontainer-%@", [NSUUID UUID].UUIDString];
         _synchronizationQueue = dispatch_queue_create([queueName cStringUsingEncoding:NSASCIIStringEncoding], DISPATCH_QUEUE_CONCURRENT);
     }
@@ -82,7 +87,7 @@
     NSParameterAssert(cls);
     NSParameterAssert(factory);
 
-    [self registerKey:[self keyForClass:cls] lifetime:lifetime factory:factory];
+    [self registerKey:cls lifetime:lifetime factory:factory];
 }
 
 - (void)registerProtocol:(Protocol *)proto
@@ -92,19 +97,21 @@
     NSParameterAssert(proto);
     NSParameterAssert(factory);
 
-    [self registerKey:[self keyForProtocol:proto] lifetime:lifetime factory:factory];
+    [self registerKey:proto lifetime:lifetime factory:factory];
 }
 
-- (void)registerKey:(NSString *)key
+- (void)registerKey:(id)key
            lifetime:(MSIDDIContainerLifetime)lifetime
             factory:(id _Nonnull (^)(void))factory
 {
+    // A new entry starts without a cached singleton, which replaces any previous one.
     MSIDDIContainerEntry *entry = [MSIDDIContainerEntry new];
     entry.lifetime = lifetime;
     entry.factory = factory;
     dispatch_barrier_sync(self.synchronizationQueue, ^{
-        self.entryByKey[key] = entry;
-        [self.singletonCache removeObjectForKey:key];
+        NSMapTable *entryByKey = [self.entryByKey copy];
+        [entryByKey setObject:entry forKey:key];
+        self.entryByKey = entryByKey;
     });
 }
 
@@ -113,17 +120,13 @@
 - (id)resolveClass:(Class)cls
 {
     NSParameterAssert(cls);
-    return [self resolveKey:[self keyForClass:cls]
-                description:NSStringFromClass(cls)
-            defaultProvider:nil];
+    return [self resolveKey:cls entry:[self.entryByKey objectForKey:cls] defaultProvider:nil];
 }
 
 - (id)resolveProtocol:(Protocol *)proto
 {
     NSParameterAssert(proto);
-    return [self resolveKey:[self keyForProtocol:proto]
-                description:NSStringFromProtocol(proto)
-            defaultProvider:nil];
+    return [self resolveKey:proto entry:[self.entryByKey objectForKey:proto] defaultProvider:nil];
 }
 
 - (id)resolveClass:(Class)cls
@@ -131,9 +134,7 @@
 {
     NSParameterAssert(cls);
     NSParameterAssert(defaultProvider);
-    return [self resolveKey:[self keyForClass:cls]
-                description:NSStringFromClass(cls)
-            defaultProvider:defaultProvider];
+    return [self resolveKey:cls entry:[self.entryByKey objectForKey:cls] defaultProvider:defaultProvider];
 }
 
 - (id)resolveProtocol:(Protocol *)proto
@@ -141,9 +142,7 @@
 {
     NSParameterAssert(proto);
     NSParameterAssert(defaultProvider);
-    return [self resolveKey:[self keyForProtocol:proto]
-                description:NSStringFromProtocol(proto)
-            defaultProvider:defaultProvider];
+    return [self resolveKey:proto entry:[self.entryByKey objectForKey:proto] defaultProvider:defaultProvider];
 }
 
 #pragma mark - Class-method seams
@@ -154,16 +153,24 @@
     NSParameterAssert(proto);
     NSParameterAssert(defaultProvider);
 
-    id resolved = [self resolveKey:[self keyForProtocol:proto]
-                       description:NSStringFromProtocol(proto)
+    MSIDDIContainerEntry *entry = [self.entryByKey objectForKey:proto];
+    id resolved = [self resolveKey:proto
+                             entry:entry
                    defaultProvider:^id _Nonnull {
                        Class defaultClass = defaultProvider();
-                       // Cast Class -> id; +resolveKey: validates non-nil.
+                       // Cast Class -> id; -resolveKey: validates non-nil.
                        return (id)defaultClass;
                    }];
 
     Class resolvedClass = (Class)resolved;
 
+    // Only registrations are validated: the default is the caller's own production class.
+    // A registration is validated once; later resolutions of the same class skip the check.
+    if (!entry || entry.validatedImplClass == resolvedClass)
+    {
+        return resolvedClass;
+    }
+
     // Validate that the resolved class conforms to the requested protocol.
     // A misregistered fake class would otherwise return successfully and the
     // failure would surface as an unrecognized-selector crash at the call
@@ -178,24 +185,23 @@
                           @"MSIDDIContainer: class '%@' resolved for protocol '%@' does not conform to it; falling back to default",
                           NSStringFromClass(resolvedClass), NSStringFromProtocol(proto));
 
-        // Self-heal: evict the bad cached entry under a barrier write so
-        // subsequent resolves return the default cleanly instead of
-        // repeatedly hitting the cached non-conforming class (which would
-        // re-trip the assert in Debug and spam logs + re-call the default
-        // provider in Release). removeObjectForKey: is a safe no-op for
-        // missing keys, so we evict from both maps unconditionally — the
-        // singleton cache is only populated for singleton-lifetime
-        // registrations, but transient registrations simply skip that
-        // dictionary without needing a lifetime branch here.
-        NSString *key = [self keyForProtocol:proto];
+        // Self-heal: evict the bad registration so subsequent resolves return
+        // the default cleanly instead of repeatedly hitting the non-conforming
+        // class (which would re-trip the assert in Debug and spam logs +
+        // re-call the default provider in Release). Only evict if the entry
+        // wasn't replaced by a newer registration in the meantime.
         dispatch_barrier_sync(self.synchronizationQueue, ^{
-            [self.singletonCache removeObjectForKey:key];
-            [self.entryByKey removeObjectForKey:key];
+            if ([self.entryByKey objectForKey:proto] != entry) return;
+
+            NSMapTable *entryByKey = [self.entryByKey copy];
+            [entryByKey removeObjectForKey:proto];
+            self.entryByKey = entryByKey;
         });
 
         return defaultProvider();
     }
 
+    entry.validatedImplClass = resolvedClass;
     return resolvedClass;
 }
 
@@ -205,8 +211,8 @@
     NSParameterAssert(cls);
     NSParameterAssert(defaultProvider);
 
-    id resolved = [self resolveKey:[self keyForClass:cls]
-                       description:NSStringFromClass(cls)
+    id resolved = [self resolveKey:cls
+                             entry:[self.entryByKey objectForKey:cls]
                    defaultProvider:^id _Nonnull {
                        Class defaultClass = defaultProvider();
                        return (id)defaultClass;
@@ -219,92 +225,75 @@
     return (Class)resolved;
 }
 
-- (id)resolveKey:(NSString *)key
-     description:(NSString *)description
+- (id)resolveKey:(id)key
+           entry:(MSIDDIContainerEntry *)entry
  defaultProvider:(id _Nullable (^)(void))defaultProvider
 {
-    __block id cached = nil;
-    __block MSIDDIContainerEntry *entry = nil;
-
-    // Concurrent read: many resolves can run in parallel; only writes
-    // (registration / singleton install / reset) take the barrier.
-    dispatch_sync(self.synchronizationQueue, ^{
-        cached = self.singletonCache[key];
-        if (cached) return;
-        entry = self.entryByKey[key];
-    });
-
-    if (cached) return cached;
-
     if (!entry)
     {
         if (defaultProvider)
         {
             // No registration: the caller has supplied its own default.
-            // Invoke it outside the queue — defaults often re-enter via
+            // Invoke it outside any lock — defaults often re-enter via
             // the caller's existing +sharedInstance and must not deadlock
             // the container. Result is intentionally not cached here; the
             // caller owns its own singleton storage.
             id defaultInstance = defaultProvider();
             if (!defaultInstance)
             {
-                NSAssert(NO, @"MSIDDIContainer: default provider returned nil for '%@'", description);
+                NSAssert(NO, @"MSIDDIContainer: default provider returned nil for '%@'", [self descriptionForKey:key]);
                 @throw [NSException exceptionWithName:NSInternalInconsistencyException
-                                               reason:[NSString stringWithFormat:@"MSIDDIContainer: default provider returned nil for '%@'", description]
+                                               reason:[NSString stringWithFormat:@"MSIDDIContainer: default provider returned nil for '%@'", [self descriptionForKey:key]]
                                              userInfo:nil];
             }
             return defaultInstance;
         }
 
-        NSAssert(NO, @"MSIDDIContainer: no factory registered for '%@'", description);
+        NSAssert(NO, @"MSIDDIContainer: no factory registered for '%@'", [self descriptionForKey:key]);
         @throw [NSException exceptionWithName:NSInternalInconsistencyException
-                                       reason:[NSString stringWithFormat:@"MSIDDIContainer: no factory registered for '%@'", description]
+                                       reason:[NSString stringWithFormat:@"MSIDDIContainer: no factory registered for '%@'", [self descriptionForKey:key]]
                                      userInfo:nil];
     }
 
     if (entry.lifetime == MSIDDIContainerLifetimeSingleton)
     {
-        // Double-checked install under a barrier so concurrent resolves
+        id cached = entry.singletonInstance;
+        if (cached) return cached;
+
+        // Double-checked install under the entry lock so concurrent resolves
         // observe the cached singleton instead of racing parallel factory
         // invocations. Factories registered with this lifetime are expected
         // to be cheap, side-effect free, and free of re-entrant calls back
-        // into the container for the same key (which would deadlock).
-        __block id resolvedInstance = nil;
-        dispatch_barrier_sync(self.synchronizationQueue, ^{
-            id existing = self.singletonCache[key];
-            if (existing)
-            {
-                resolvedInstance = existing;
-                return;
-            }
-            id newInstance = entry.factory();
-            if (!newInstance)
+        // into the container for the same key.
+        id resolvedInstance = nil;
+        @synchronized (entry)
+        {
+            resolvedInstance = entry.singletonInstance;
+            if (!resolvedInstance)
             {
-                // Leave resolvedInstance nil; caller throws below.
-                return;
+                resolvedInstance = entry.factory();
+                entry.singletonInstance = resolvedInstance;
             }
-            self.singletonCache[key] = newInstance;
-            resolvedInstance = newInstance;
-        });
+        }
 
         if (!resolvedInstance)
         {
-            NSAssert(NO, @"MSIDDIContainer: factory returned nil for '%@'", description);
+            NSAssert(NO, @"MSIDDIContainer: factory returned nil for '%@'", [self descriptionForKey:key]);
             @throw [NSException exceptionWithName:NSInternalInconsistencyException
-                                           reason:[NSString stringWithFormat:@"MSIDDIContainer: factory returned nil for '%@'", description]
+                                           reason:[NSString stringWithFormat:@"MSIDDIContainer: factory returned nil for '%@'", [self descriptionForKey:key]]
                                          userInfo:nil];
         }
         return resolvedInstance;
     }
 
-    // Transient: invoke the factory outside the queue. Each resolve
-    // produces a fresh instance and never touches the singleton cache.
+    // Transient: each resolve produces a fresh instance and never touches
+    // the singleton slot.
     id instance = entry.factory();
     if (!instance)
     {
-        NSAssert(NO, @"MSIDDIContainer: factory returned nil for '%@'", description);
+        NSAssert(NO, @"MSIDDIContainer: factory returned nil for '%@'", [self descriptionForKey:key]);
         @throw [NSException exceptionWithName:NSInternalInconsistencyException
-                                       reason:[NSString stringWithFormat:@"MSIDDIContainer: factory returned nil for '%@'", description]
+                                       reason:[NSString stringWithFormat:@"MSIDDIContainer: factory returned nil for '%@'", [self descriptionForKey:key]]
                                      userInfo:nil];
     }
     return instance;
@@ -315,21 +304,24 @@
 - (void)reset
 {
     dispatch_barrier_sync(self.synchronizationQueue, ^{
-        [self.entryByKey removeAllObjects];
-        [self.singletonCache removeAllObjects];
+        self.entryByKey = [self.class newEntryTable];
     });
 }
 
 #pragma mark - Private
 
-- (NSString *)keyForClass:(Class)cls
++ (NSMapTable *)newEntryTable
 {
-    return [@"C:" stringByAppendingString:NSStringFromClass(cls)];
+    // Classes and protocols live for the lifetime of the process, so keys are compared by pointer and not retained.
+    return [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality
+                                     valueOptions:NSPointerFunctionsStrongMemory
+                                         capacity:0];
 }
 
-- (NSString *)keyForProtocol:(Protocol *)proto
+// Only used for error messages, so the common path doesn't build strings.
+- (NSString *)descriptionForKey:(id)key
 {
-    return [@"P:" stringByAppendingString:NSStringFromProtocol(proto)];
+    return object_isClass(key) ? NSStringFromClass((Class)key) : NSStringFromProtocol((Protocol *)key);
 }
 
 @end
@@ -69,6 +69,9 @@
 /*! Check if current string is included in the array - case insensitive */
 - (BOOL)msidIsEquivalentWithAnyAlias:(NSArray<NSString *> *)aliases;
 
+/*! Check if current string is included in a set built by msidLowercasedAliasSet: - case insensitive */
+- (BOOL)msidIsEquivalentWithAnyAliasInSet:(NSSet<NSString *> *)lowercasedAliases;
+
 /*! Converts from hex string */
 - (NSData *)msidHexData;
 
@@ -106,6 +109,9 @@
 /*! Convenience method to convert string to NSOrderedSet */
 + (NSString *)msidStringFromOrderedSet:(NSOrderedSet *)set;
 
+/*! Lowercases aliases into a set for msidIsEquivalentWithAnyAliasInSet: */
++ (NSSet<NSString *> *)msidLowercasedAliasSet:(NSArray<NSString *> *)aliases;
+
 /*! Convenience method to convert string to scope set */
 - (NSOrderedSet<NSString *> *)msidScopeSet;
 
@@ -279,6 +279,13 @@ typedef unsigned char byte;
     return result;
 }
 
+- (BOOL)msidIsEquivalentWithAnyAliasInSet:(NSSet<NSString *> *)lowercasedAliases
+{
+    if (!lowercasedAliases) return NO;
+    
+    return [lowercasedAliases containsObject:self.lowercaseString];
+}
+
 - (NSData *)msidHexData
 {
     NSMutableData *data= [NSMutableData new];
@@ -310,6 +317,19 @@ typedef unsigned char byte;
     return [[set array] componentsJoinedByString:@" "];
 }
 
++ (NSSet<NSString *> *)msidLowercasedAliasSet:(NSArray<NSString *> *)aliases
+{
+    if (!aliases) return nil;
+    
+    NSMutableSet<NSString *> *aliasSet = [NSMutableSet setWithCapacity:aliases.count];
+    for (NSString *alias in aliases)
+    {
+        [aliasSet addObject:alias.lowercaseString];
+    }
+    
+    return aliasSet;
+}
+
 
 - (NSData *)msidData
 {
@@ -0,0 +1,84 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+#import "MSIDXpcBrokerProtocols.h"
+#import "MSIDXpcTransport.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Invoked by the connector once the broker instance connection is established (service and transport set)
+// or failed (error set). May be invoked again later with an error when the established connection is
+// interrupted or invalidated.
+typedef void (^MSIDXpcBrokerChannelConnectionBlock)(id<MSIDXpcBrokerInstanceProtocol> _Nullable service, id<MSIDXpcTransport> _Nullable transport, NSError * _Nullable error);
+typedef void (^MSIDXpcBrokerChannelConnector)(MSIDXpcBrokerChannelConnectionBlock connectionBlock);
+// connectionDropped is YES when the request had been sent but the connection went away before the reply
+// arrived. The broker may or may not have seen the request; callers decide whether it is safe to resend.
+typedef void (^MSIDXpcBrokerChannelReplyBlock)(NSDictionary<NSString *, id> * _Nullable reply, NSError * _Nullable error, BOOL connectionDropped);
+
+// Point-in-time snapshot of MSIDXpcBrokerChannel counters.
+@interface MSIDXpcBrokerChannelMetrics : NSObject
+
+@property (nonatomic, readonly) NSUInteger inFlightCount;
+@property (nonatomic, readonly) NSUInteger peakInFlightCount;
+@property (nonatomic, readonly) NSUInteger queuedCount;
+@property (nonatomic, readonly) NSUInteger totalRequestCount;
+@property (nonatomic, readonly) NSUInteger failedRequestCount;
+@property (nonatomic, readonly) NSUInteger connectCount;
+@property (nonatomic, readonly) NSUInteger reconnectCount;
+// Time requests spent waiting for the connection before being sent to the broker.
+@property (nonatomic, readonly) NSTimeInterval lastQueueWait;
+@property (nonatomic, readonly) NSTimeInterval maxQueueWait;
+@property (nonatomic, readonly) NSTimeInterval averageQueueWait;
+
+@end
+
+// Long-lived, multiplexed connection to the broker instance service. Requests are tagged by correlation
+// id and pipelined over one connection without waiting for earlier replies. Requests submitted while the
+// connection is being established are queued and flushed together once it is up. When the connection
+// drops, in-flight requests fail with a transport error and the next request reconnects. The connection
+// is closed after idleTimeout without traffic.
+@interface MSIDXpcBrokerChannel : NSObject
+
+@property (nonatomic) NSTimeInterval idleTimeout;
+@property (nonatomic, readonly) MSIDXpcBrokerChannelMetrics *metrics;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+- (instancetype)initWithConnector:(MSIDXpcBrokerChannelConnector)connector NS_DESIGNATED_INITIALIZER;
+
+// replyTimeout <= 0 disables the per-request reply watchdog. Completion is called exactly once, on a
+// background queue.
+- (void)sendRequest:(NSDictionary *)requestParam
+      correlationId:(nullable NSString *)correlationId
+       replyTimeout:(NSTimeInterval)replyTimeout
+         completion:(MSIDXpcBrokerChannelReplyBlock)completion;
+
+// Closes the connection and fails all queued and in-flight requests.
+- (void)invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
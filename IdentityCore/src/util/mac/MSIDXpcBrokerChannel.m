@@ -0,0 +1,377 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDXpcBrokerChannel.h"
+#import "MSIDLogger+Internal.h"
+
+static const NSTimeInterval MSIDXpcBrokerChannelDefaultIdleTimeout = 60.0;
+
+typedef NS_ENUM(NSInteger, MSIDXpcBrokerChannelState)
+{
+    MSIDXpcBrokerChannelStateIdle = 0,
+    MSIDXpcBrokerChannelStateConnecting,
+    MSIDXpcBrokerChannelStateConnected
+};
+
+static NSError *MSIDXpcBrokerChannelError(NSString *description, NSError *underlyingError)
+{
+    return MSIDCreateError(MSIDErrorDomain, MSIDErrorBrokerXpcUnexpectedError, description, nil, nil, underlyingError, nil, nil, YES);
+}
+
+@interface MSIDXpcBrokerChannelMetrics ()
+
+@property (nonatomic, readwrite) NSUInteger inFlightCount;
+@property (nonatomic, readwrite) NSUInteger peakInFlightCount;
+@property (nonatomic, readwrite) NSUInteger queuedCount;
+@property (nonatomic, readwrite) NSUInteger totalRequestCount;
+@property (nonatomic, readwrite) NSUInteger failedRequestCount;
+@property (nonatomic, readwrite) NSUInteger connectCount;
+@property (nonatomic, readwrite) NSUInteger reconnectCount;
+@property (nonatomic, readwrite) NSTimeInterval lastQueueWait;
+@property (nonatomic, readwrite) NSTimeInterval maxQueueWait;
+@property (nonatomic, readwrite) NSTimeInterval averageQueueWait;
+
+@end
+
+@implementation MSIDXpcBrokerChannelMetrics
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: inFlight=%lu, peakInFlight=%lu, queued=%lu, total=%lu, failed=%lu, connects=%lu, reconnects=%lu, avgQueueWait=%.3f, maxQueueWait=%.3f>",
+            self.class,
+            (unsigned long)self.inFlightCount,
+            (unsigned long)self.peakInFlightCount,
+            (unsigned long)self.queuedCount,
+            (unsigned long)self.totalRequestCount,
+            (unsigned long)self.failedRequestCount,
+            (unsigned long)self.connectCount,
+            (unsigned long)self.reconnectCount,
+            self.averageQueueWait,
+            self.maxQueueWait];
+}
+
+@end
+
+@interface MSIDXpcBrokerChannelRequest : NSObject
+
+@property (nonatomic) NSString *tag;
+@property (nonatomic) NSDictionary *requestParam;
+@property (nonatomic) NSTimeInterval replyTimeout;
+@property (nonatomic) NSDate *enqueueDate;
+@property (nonatomic, copy) MSIDXpcBrokerChannelReplyBlock completion;
+
+@end
+
+@implementation MSIDXpcBrokerChannelRequest
+@end
+
+@implementation MSIDXpcBrokerChannel
+{
+    dispatch_queue_t _queue;
+    MSIDXpcBrokerChannelConnector _connector;
+    MSIDXpcBrokerChannelState _state;
+    NSUInteger _connectionGeneration;
+    NSUInteger _idleGeneration;
+    NSUInteger _sequence;
+    BOOL _hasConnected;
+    id<MSIDXpcBrokerInstanceProtocol> _service;
+    id<MSIDXpcTransport> _transport;
+    NSMutableArray<MSIDXpcBrokerChannelRequest *> *_pendingRequests;
+    NSMutableDictionary<NSString *, MSIDXpcBrokerChannelRequest *> *_inFlightRequests;
+    MSIDXpcBrokerChannelMetrics *_metrics;
+    NSTimeInterval _totalQueueWait;
+    NSUInteger _sentRequestCount;
+}
+
+- (instancetype)initWithConnector:(MSIDXpcBrokerChannelConnector)connector
+{
+    self = [super init];
+    if (self)
+    {
+        _queue = dispatch_queue_create("com.microsoft.msidxpcbrokerchannel", DISPATCH_QUEUE_SERIAL);
+        _connector = [connector copy];
+        _pendingRequests = [NSMutableArray new];
+        _inFlightRequests = [NSMutableDictionary new];
+        _metrics = [MSIDXpcBrokerChannelMetrics new];
+        _idleTimeout = MSIDXpcBrokerChannelDefaultIdleTimeout;
+    }
+    
+    return self;
+}
+
+#pragma mark - Public
+
+- (void)sendRequest:(NSDictionary *)requestParam
+      correlationId:(NSString *)correlationId
+       replyTimeout:(NSTimeInterval)replyTimeout
+         completion:(MSIDXpcBrokerChannelReplyBlock)completion
+{
+    MSIDXpcBrokerChannelRequest *request = [MSIDXpcBrokerChannelRequest new];
+    request.requestParam = requestParam;
+    request.replyTimeout = replyTimeout;
+    request.completion = completion;
+    request.enqueueDate = [NSDate date];
+    
+    dispatch_async(_queue, ^{
+        // Correlation ids are not guaranteed to be unique per broker call (e.g. retries), so tag with a
+        // sequence number as well.
+        self->_sequence += 1;
+        request.tag = [NSString stringWithFormat:@"%@#%lu", correlationId ?: @"none", (unsigned long)self->_sequence];
+        self->_metrics.totalRequestCount += 1;
+        self->_idleGeneration += 1;
+        
+        [self->_pendingRequests addObject:request];
+        [self drainOrConnect];
+    });
+}
+
+- (void)invalidate
+{
+    dispatch_async(_queue, ^{
+        [self tearDownWithError:MSIDXpcBrokerChannelError(@"[Entra broker] CLIENT -- broker channel was invalidated", nil)
+                     failPending:YES
+                         dropped:NO];
+    });
+}
+
+- (MSIDXpcBrokerChannelMetrics *)metrics
+{
+    __block MSIDXpcBrokerChannelMetrics *snapshot = nil;
+    dispatch_sync(_queue, ^{
+        snapshot = [MSIDXpcBrokerChannelMetrics new];
+        snapshot.inFlightCount = self->_inFlightRequests.count;
+        snapshot.peakInFlightCount = self->_metrics.peakInFlightCount;
+        snapshot.queuedCount = self->_pendingRequests.count;
+        snapshot.totalRequestCount = self->_metrics.totalRequestCount;
+        snapshot.failedRequestCount = self->_metrics.failedRequestCount;
+        snapshot.connectCount = self->_metrics.connectCount;
+        snapshot.reconnectCount = self->_metrics.reconnectCount;
+        snapshot.lastQueueWait = self->_metrics.lastQueueWait;
+        snapshot.maxQueueWait = self->_metrics.maxQueueWait;
+        snapshot.averageQueueWait = self->_sentRequestCount ? self->_totalQueueWait / self->_sentRequestCount : 0;
+    });
+    
+    return snapshot;
+}
+
+#pragma mark - Connection (channel queue only)
+
+- (void)drainOrConnect
+{
+    if (_state == MSIDXpcBrokerChannelStateConnected)
+    {
+        NSArray<MSIDXpcBrokerChannelRequest *> *requests = [_pendingRequests copy];
+        [_pendingRequests removeAllObjects];
+        for (MSIDXpcBrokerChannelRequest *request in requests)
+        {
+            [self sendRequestOverConnection:request];
+        }
+        return;
+    }
+    
+    if (_state == MSIDXpcBrokerChannelStateConnecting || !_pendingRequests.count) return;
+    
+    _state = MSIDXpcBrokerChannelStateConnecting;
+    _connectionGeneration += 1;
+    NSUInteger generation = _connectionGeneration;
+    
+    MSID_LOG_WITH_CTX(MSIDLogLevelInfo, nil, @"[Entra broker] CLIENT -- broker channel connecting, %lu request(s) queued", (unsigned long)_pendingRequests.count);
+    
+    __weak typeof(self) weakSelf = self;
+    _connector(^(id<MSIDXpcBrokerInstanceProtocol> service, id<MSIDXpcTransport> transport, NSError *error) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf)
+        {
+            [transport invalidate];
+            return;
+        }
+        
+        dispatch_async(strongSelf->_queue, ^{
+            [strongSelf handleConnectionEventWithService:service transport:transport error:error generation:generation];
+        });
+    });
+}
+
+- (void)handleConnectionEventWithService:(id<MSIDXpcBrokerInstanceProtocol>)service
+                               transport:(id<MSIDXpcTransport>)transport
+                                   error:(NSError *)error
+                              generation:(NSUInteger)generation
+{
+    if (generation != _connectionGeneration)
+    {
+        // Late event from a connection we already tore down.
+        if (service && transport && !error && transport != _transport) [transport invalidate];
+        return;
+    }
+    
+    if (_state == MSIDXpcBrokerChannelStateConnecting)
+    {
+        if (service && transport && !error)
+        {
+            _service = service;
+            _transport = transport;
+            _state = MSIDXpcBrokerChannelStateConnected;
+            _metrics.connectCount += 1;
+            if (_hasConnected) _metrics.reconnectCount += 1;
+            _hasConnected = YES;
+            
+            MSID_LOG_WITH_CTX(MSIDLogLevelInfo, nil, @"[Entra broker] CLIENT -- broker channel connected, flushing %lu queued request(s)", (unsigned long)_pendingRequests.count);
+            [self drainOrConnect];
+            return;
+        }
+        
+        NSError *connectError = error ?: MSIDXpcBrokerChannelError(@"[Entra broker] CLIENT -- broker channel failed to connect", nil);
+        [self tearDownWithError:connectError failPending:YES dropped:NO];
+        return;
+    }
+    
+    if (_state == MSIDXpcBrokerChannelStateConnected && (error || !service))
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelWarning, nil, @"[Entra broker] CLIENT -- broker channel connection dropped with %lu request(s) in flight, error: %@", (unsigned long)_inFlightRequests.count, error);
+        NSError *dropError = MSIDXpcBrokerChannelError(@"[Entra broker] CLIENT -- broker channel connection was interrupted", error);
+        [self tearDownWithError:dropError failPending:NO dropped:YES];
+        
+        // Anything queued after the drop has not been sent yet and can safely go over a new connection.
+        [self drainOrConnect];
+    }
+}
+
+- (void)tearDownWithError:(NSError *)error failPending:(BOOL)failPending dropped:(BOOL)dropped
+{
+    id<MSIDXpcTransport> transport = _transport;
+    
+    // Bump the generation first so that the invalidation handler fired by our own invalidate is ignored.
+    _connectionGeneration += 1;
+    _state = MSIDXpcBrokerChannelStateIdle;
+    _service = nil;
+    _transport = nil;
+    
+    NSArray<MSIDXpcBrokerChannelRequest *> *inFlightRequests = _inFlightRequests.allValues;
+    [_inFlightRequests removeAllObjects];
+    for (MSIDXpcBrokerChannelRequest *request in inFlightRequests)
+    {
+        [self completeRequest:request reply:nil error:error dropped:dropped];
+    }
+    
+    if (failPending)
+    {
+        NSArray<MSIDXpcBrokerChannelRequest *> *pendingRequests = [_pendingRequests copy];
+        [_pendingRequests removeAllObjects];
+        for (MSIDXpcBrokerChannelRequest *request in pendingRequests)
+        {
+            [self completeRequest:request reply:nil error:error dropped:NO];
+        }
+    }
+    
+    // Detach the handlers so our own invalidate is not reported back through the connector.
+    transport.interruptionHandler = nil;
+    transport.invalidationHandler = nil;
+    [transport invalidate];
+}
+
+#pragma mark - Requests (channel queue only)
+
+- (void)sendRequestOverConnection:(MSIDXpcBrokerChannelRequest *)request
+{
+    NSTimeInterval queueWait = -[request.enqueueDate timeIntervalSinceNow];
+    _metrics.lastQueueWait = queueWait;
+    _metrics.maxQueueWait = MAX(_metrics.maxQueueWait, queueWait);
+    _totalQueueWait += queueWait;
+    _sentRequestCount += 1;
+    
+    _inFlightRequests[request.tag] = request;
+    _metrics.peakInFlightCount = MAX(_metrics.peakInFlightCount, _inFlightRequests.count);
+    
+    NSString *tag = request.tag;
+    __weak typeof(self) weakSelf = self;
+    
+    if (request.replyTimeout > 0)
+    {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(request.replyTimeout * NSEC_PER_SEC)), _queue, ^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            if (!strongSelf || strongSelf->_inFlightRequests[tag] != request) return;
+            
+            [strongSelf->_inFlightRequests removeObjectForKey:tag];
+            [strongSelf completeRequest:request reply:nil error:MSIDXpcBrokerChannelError(@"[Entra broker] CLIENT -- broker reply timed out", nil) dropped:NO];
+            [strongSelf scheduleIdleCloseIfNeeded];
+        });
+    }
+    
+    [_service handleXpcWithRequestParams:request.requestParam
+                         parentViewFrame:NSZeroRect
+                         completionBlock:^(NSDictionary<NSString *,id> * _Nullable replyParam, NSDate * _Nonnull __unused xpcStartDate, NSString * _Nonnull __unused processId, NSError * _Nullable callbackError) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf) return;
+        
+        dispatch_async(strongSelf->_queue, ^{
+            // The request may already have been failed by the watchdog or a dropped connection.
+            if (strongSelf->_inFlightRequests[tag] != request) return;
+            
+            [strongSelf->_inFlightRequests removeObjectForKey:tag];
+            [strongSelf completeRequest:request reply:replyParam error:callbackError dropped:NO];
+            [strongSelf scheduleIdleCloseIfNeeded];
+        });
+    }];
+}
+
+- (void)completeRequest:(MSIDXpcBrokerChannelRequest *)request
+                  reply:(NSDictionary *)reply
+                  error:(NSError *)error
+                dropped:(BOOL)dropped
+{
+    if (!reply && error) _metrics.failedRequestCount += 1;
+    
+    MSIDXpcBrokerChannelReplyBlock completion = request.completion;
+    request.completion = nil;
+    if (!completion) return;
+    
+    // Never run caller code on the channel queue, replies would otherwise be serialized behind it.
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+        completion(reply, error, dropped);
+    });
+}
+
+- (void)scheduleIdleCloseIfNeeded
+{
+    if (_inFlightRequests.count || _pendingRequests.count || _idleTimeout <= 0) return;
+    
+    _idleGeneration += 1;
+    NSUInteger idleGeneration = _idleGeneration;
+    __weak typeof(self) weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_idleTimeout * NSEC_PER_SEC)), _queue, ^{
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf || strongSelf->_idleGeneration != idleGeneration) return;
+        if (strongSelf->_state != MSIDXpcBrokerChannelStateConnected || strongSelf->_inFlightRequests.count) return;
+        
+        MSID_LOG_WITH_CTX(MSIDLogLevelInfo, nil, @"[Entra broker] CLIENT -- broker channel idle, closing connection");
+        [strongSelf tearDownWithError:nil failPending:NO dropped:NO];
+    });
+}
+
+- (void)dealloc
+{
+    [_transport invalidate];
+}
+
+@end
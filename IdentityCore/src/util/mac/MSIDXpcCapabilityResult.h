@@ -0,0 +1,60 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+#import "MSIDXpcCanPerformFailureReason.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Default lifetime of a cached +[MSIDXpcSingleSignOnProvider canPerformRequest:] result.
+extern const NSTimeInterval MSIDXpcCapabilityResultDefaultTTL;
+
+// Immutable outcome of a single Xpc capability probe, held by MSIDXpcProviderCaching so that
+// request paths can answer canPerformRequest: without repeating the broker handshake.
+@interface MSIDXpcCapabilityResult : NSObject
+
+@property (nonatomic, readonly) BOOL canPerform;
+@property (nonatomic, readonly) MSIDXpcCanPerformFailureReason failureReason;
+@property (nonatomic, readonly) NSDate *probeDate;
+// Set when a broker connection was interrupted or invalidated after the probe completed.
+@property (nonatomic, readonly) BOOL invalidated;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+- (instancetype)initWithCanPerform:(BOOL)canPerform
+                     failureReason:(MSIDXpcCanPerformFailureReason)failureReason
+                         probeDate:(NSDate *)probeDate NS_DESIGNATED_INITIALIZER;
+
+// Returns a copy of the receiver marked as invalidated.
+- (MSIDXpcCapabilityResult *)invalidatedResult;
+
+// A stale result is still returned to callers, but should be refreshed in the background.
+// Results are stale once the TTL has elapsed, after invalidation, or immediately when the probe
+// failed for a transient reason (handshake error or timeout).
+- (BOOL)isStaleWithTTL:(NSTimeInterval)ttl;
+
+@end
+
+NS_ASSUME_NONNULL_END
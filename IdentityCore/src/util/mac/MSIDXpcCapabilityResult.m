@@ -0,0 +1,79 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDXpcCapabilityResult.h"
+
+const NSTimeInterval MSIDXpcCapabilityResultDefaultTTL = 300.0;
+
+@interface MSIDXpcCapabilityResult ()
+
+@property (nonatomic, readwrite) BOOL invalidated;
+
+@end
+
+@implementation MSIDXpcCapabilityResult
+
+- (instancetype)initWithCanPerform:(BOOL)canPerform
+                     failureReason:(MSIDXpcCanPerformFailureReason)failureReason
+                         probeDate:(NSDate *)probeDate
+{
+    self = [super init];
+    if (self)
+    {
+        _canPerform = canPerform;
+        _failureReason = failureReason;
+        _probeDate = probeDate;
+    }
+    
+    return self;
+}
+
+- (MSIDXpcCapabilityResult *)invalidatedResult
+{
+    MSIDXpcCapabilityResult *result = [[MSIDXpcCapabilityResult alloc] initWithCanPerform:self.canPerform
+                                                                             failureReason:self.failureReason
+                                                                                 probeDate:self.probeDate];
+    result.invalidated = YES;
+    return result;
+}
+
+- (BOOL)isStaleWithTTL:(NSTimeInterval)ttl
+{
+    if (self.invalidated) return YES;
+    
+    if (self.failureReason == MSIDXpcCanPerformFailureReasonDeviceInfoHandshakeError
+        || self.failureReason == MSIDXpcCanPerformFailureReasonDeviceInfoHandshakeTimeout)
+    {
+        return YES;
+    }
+    
+    return -[self.probeDate timeIntervalSinceNow] >= ttl;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: canPerform=%d, reason=%@, invalidated=%d>", self.class, self.canPerform, MSIDXpcCanPerformFailureReasonToString(self.failureReason), self.invalidated];
+}
+
+@end
@@ -28,6 +28,7 @@
 #import "MSIDDeviceInfo.h"
 #import "MSIDXpcConfiguration.h"
 #import "MSIDLogger+Internal.h"
+#import "MSIDXpcCapabilityResult.h"
 
 NSString *const MSID_XPC_CACHE_QUEUE_NAME = @"com.microsoft.msidxpcprovidercache";
 NSString *const MSID_XPC_PROVIDER_TYPE_KEY = @"xpc_provider_type";
@@ -45,9 +46,12 @@ NSString *const MSID_XPC_PROVIDER_TYPE_KEY = @"xpc_provider_type";
 @implementation MSIDXpcProviderCache
 {
     NSXPCListenerEndpoint *_cachedBrokerInstanceEndpoint;
+    MSIDXpcCapabilityResult *_cachedCapabilityResult;
+    BOOL _capabilityRefreshInFlight;
 }
 
 @synthesize xpcConfiguration = _xpcConfiguration;
+@synthesize capabilityResultTTL = _capabilityResultTTL;
 
 + (instancetype)sharedInstance
 {
@@ -68,6 +72,7 @@ NSString *const MSID_XPC_PROVIDER_TYPE_KEY = @"xpc_provider_type";
         NSString *queueName = [NSString stringWithFormat:@"%@-%@", MSID_XPC_CACHE_QUEUE_NAME, [NSUUID UUID].UUIDString];
         _synchronizationQueue = dispatch_queue_create([queueName cStringUsingEncoding:NSASCIIStringEncoding], DISPATCH_QUEUE_CONCURRENT);
         _userDefaults = [NSUserDefaults standardUserDefaults];
+        _capabilityResultTTL = MSIDXpcCapabilityResultDefaultTTL;
     }
     
     return self;
@@ -141,6 +146,51 @@ NSString *const MSID_XPC_PROVIDER_TYPE_KEY = @"xpc_provider_type";
     });
 }
 
+- (nullable MSIDXpcCapabilityResult *)cachedCapabilityResult
+{
+    __block MSIDXpcCapabilityResult *result = nil;
+    dispatch_sync(self.synchronizationQueue, ^{
+        result = self->_cachedCapabilityResult;
+    });
+    
+    return result;
+}
+
+- (void)setCachedCapabilityResult:(nullable MSIDXpcCapabilityResult *)cachedCapabilityResult
+{
+    dispatch_barrier_sync(self.synchronizationQueue, ^{
+        self->_cachedCapabilityResult = cachedCapabilityResult;
+    });
+}
+
+- (void)invalidateCachedCapabilityResult
+{
+    dispatch_barrier_sync(self.synchronizationQueue, ^{
+        self->_cachedCapabilityResult = [self->_cachedCapabilityResult invalidatedResult];
+    });
+}
+
+- (BOOL)beginCapabilityRefresh
+{
+    __block BOOL began = NO;
+    dispatch_barrier_sync(self.synchronizationQueue, ^{
+        if (!self->_capabilityRefreshInFlight)
+        {
+            self->_capabilityRefreshInFlight = YES;
+            began = YES;
+        }
+    });
+    
+    return began;
+}
+
+- (void)endCapabilityRefresh
+{
+    dispatch_barrier_sync(self.synchronizationQueue, ^{
+        self->_capabilityRefreshInFlight = NO;
+    });
+}
+
 - (BOOL)isXpcProviderInstalledOnDevice
 {
     dispatch_barrier_sync(self.synchronizationQueue, ^{
@@ -27,6 +27,7 @@
 #import "MSIDDeviceInfo.h"
 
 @class MSIDXpcConfiguration;
+@class MSIDXpcCapabilityResult;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -60,6 +61,22 @@ NS_ASSUME_NONNULL_BEGIN
 // Clears the cached broker instance endpoint. Safe to call from any thread.
 - (void)clearCachedBrokerInstanceEndpoint;
 
+// Last result of +[MSIDXpcSingleSignOnProvider canPerformRequest:]. In-memory only. Once a result
+// exists, callers are answered from it and stale results are refreshed in the background.
+@property (nonatomic, nullable) MSIDXpcCapabilityResult *cachedCapabilityResult;
+
+// Lifetime of cachedCapabilityResult before it is considered stale.
+@property (nonatomic) NSTimeInterval capabilityResultTTL;
+
+// Marks cachedCapabilityResult stale without discarding it, so the next caller still gets an answer
+// immediately and triggers a background re-probe. Called on broker connection interruption/invalidation.
+- (void)invalidateCachedCapabilityResult;
+
+// Single-flight gate for background capability refresh. Returns YES if the caller owns the refresh
+// and must call endCapabilityRefresh when done, NO if a refresh is already in flight.
+- (BOOL)beginCapabilityRefresh;
+- (void)endCapabilityRefresh;
+
 @end
 
 NS_ASSUME_NONNULL_END
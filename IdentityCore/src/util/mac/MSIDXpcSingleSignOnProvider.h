@@ -29,6 +29,8 @@
 #import "MSIDXpcProviderCaching.h"
 #import "MSIDXpcCanPerformFailureReason.h"
 
+@class MSIDXpcBrokerChannelMetrics;
+
 NS_ASSUME_NONNULL_BEGIN
 
 @interface MSIDXpcSingleSignOnProvider : NSObject
@@ -56,6 +58,10 @@ NS_ASSUME_NONNULL_BEGIN
 + (BOOL)canPerformRequest:(id<MSIDXpcProviderCaching>)xpcProviderCache
                     reason:(MSIDXpcCanPerformFailureReason * _Nullable)reason;
 
+// Counters of the persistent broker channel used for silent requests against xpcProviderCache, or nil
+// if no silent request has gone through the channel yet.
++ (nullable MSIDXpcBrokerChannelMetrics *)brokerChannelMetricsForProviderCache:(id<MSIDXpcProviderCaching>)xpcProviderCache;
+
 NS_ASSUME_NONNULL_END
 
 @end
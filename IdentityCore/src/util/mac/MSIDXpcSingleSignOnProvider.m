@@ -66,6 +66,11 @@
 #import "MSIDXpcConfiguration.h"
 #import "MSIDXpcProviderCaching.h"
 #import "MSIDFlightManager.h"
+#import "MSIDXpcCapabilityResult.h"
+#import "MSIDXpcTransport.h"
+#import "MSIDXpcBrokerProtocols.h"
+#import "MSIDXpcBrokerChannel.h"
+#import <objc/runtime.h>
 
 static const NSTimeInterval MSIDXpcDispatcherEndpointLookupTimeout = 10.0;
 static const NSTimeInterval MSIDXpcBrokerReplyTimeout = 60.0;
@@ -90,23 +95,7 @@ static NSError *MSIDXpcCreateTransportError(NSString *description, NSError *unde
                            YES);
 }
 
-@protocol MSIDXpcBrokerInstanceProtocol <NSObject>
-
-- (void)handleXpcWithRequestParams:(NSDictionary *)passedInParams
-                   parentViewFrame:(NSRect)frame
-                   completionBlock:(void (^)(NSDictionary<NSString *,id> * _Nullable, NSDate * _Nonnull, NSString * _Nonnull, NSError * _Nullable))blockName;
-
-- (void)canPerformWithMetadata:(NSDictionary *)passedInParams
-               completionBlock:(void (^)(BOOL))blockName;
-
-@end
-
-@protocol MSIDXpcBrokerDispatcherProtocol <NSObject>
-
-- (void)getBrokerInstanceEndpointWithReply:(void (^)(NSXPCListenerEndpoint  * _Nullable listenerEndpoint, NSDictionary * _Nullable params, NSError * _Nullable error))reply;
-@end
-
-typedef void (^NSXPCListenerEndpointCompletionBlock)(id<MSIDXpcBrokerInstanceProtocol> _Nullable xpcService, NSXPCConnection  * _Nullable directConnection, NSError *error);
+typedef void (^NSXPCListenerEndpointCompletionBlock)(id<MSIDXpcBrokerInstanceProtocol> _Nullable xpcService, id<MSIDXpcTransport> _Nullable directConnection, NSError *error);
 typedef BOOL (^MSIDXpcRequestCompletedBlock)(void);
 
 @interface MSIDXpcSingleSignOnProvider ()
@@ -116,10 +105,11 @@ typedef BOOL (^MSIDXpcRequestCompletedBlock)(void);
 // Tests swizzle this to honor the flight regardless of build configuration so that
 // flight-controlled behavior can be verified deterministically.
 - (BOOL)isXpcInstanceCacheEnabled;
+- (BOOL)isXpcPersistentChannelEnabled;
 - (BOOL)isXpcPlatformSupported;
 
-- (NSXPCConnection *)dispatcherConnectionWithMachServiceName:(NSString *)machServiceName;
-- (NSXPCConnection *)directConnectionWithEndpoint:(NSXPCListenerEndpoint *)endpoint;
+- (id<MSIDXpcTransport>)dispatcherConnectionWithMachServiceName:(NSString *)machServiceName;
+- (id<MSIDXpcTransport>)directConnectionWithEndpoint:(NSXPCListenerEndpoint *)endpoint;
 - (void)scheduleBlock:(dispatch_block_t)block afterTimeout:(NSTimeInterval)timeout;
 - (void)getXpcService:(id<MSIDXpcProviderCaching>)xpcProviderCache
      requestCompleted:(MSIDXpcRequestCompletedBlock)requestCompleted
@@ -144,6 +134,21 @@ typedef BOOL (^MSIDXpcRequestCompletedBlock)(void);
                      context:(id<MSIDRequestContext>)context
                continueBlock:(MSIDSSOExtensionRequestDelegateCompletionBlock)continueBlock;
 
+// Silent requests go through a long-lived channel shared per provider cache when
+// MSID_FLIGHT_BROKER_XPC_PERSISTENT_CHANNEL_ENABLED is on.
+- (MSIDXpcBrokerChannel *)brokerChannelForProviderCache:(id<MSIDXpcProviderCaching>)xpcProviderCache;
+- (void)sendRequestThroughBrokerChannel:(NSDictionary *)requestParam
+              assertKindOfResponseClass:(Class)aClass
+                       xpcProviderCache:(id<MSIDXpcProviderCaching>)xpcProviderCache
+                                context:(id<MSIDRequestContext>)context
+                     brokerReplyTimeout:(NSTimeInterval)brokerReplyTimeout
+                          continueBlock:(MSIDSSOExtensionRequestDelegateCompletionBlock)continueBlock;
+
+// Runs the full (potentially blocking) capability probe without consulting the cached result.
++ (BOOL)probeCanPerformRequest:(id<MSIDXpcProviderCaching>)xpcProviderCache
+                         reason:(MSIDXpcCanPerformFailureReason *)reason;
++ (void)refreshCapabilityInBackground:(id<MSIDXpcProviderCaching>)xpcProviderCache;
+
 @end
 
 NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason reason)
@@ -180,6 +185,11 @@ NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason
 #endif
 }
 
+- (BOOL)isXpcPersistentChannelEnabled
+{
+    return [[MSIDFlightManager sharedInstance] boolForKey:MSID_FLIGHT_BROKER_XPC_PERSISTENT_CHANNEL_ENABLED];
+}
+
 - (BOOL)isXpcPlatformSupported
 {
     if (@available(macOS 13.0, *))
@@ -232,6 +242,18 @@ NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason
         brokerReplyTimeout:(NSTimeInterval)brokerReplyTimeout
              continueBlock:(MSIDSSOExtensionRequestDelegateCompletionBlock)continueBlock
 {
+    // Only silent requests are pipelined. Interactive requests are rare, long-lived and tied to UI.
+    if (brokerReplyTimeout > 0 && [self isXpcPersistentChannelEnabled])
+    {
+        [self sendRequestThroughBrokerChannel:requestParam
+                    assertKindOfResponseClass:aClass
+                             xpcProviderCache:xpcProviderCache
+                                      context:context
+                           brokerReplyTimeout:brokerReplyTimeout
+                                continueBlock:continueBlock];
+        return;
+    }
+    
     [self attemptBrokerRequest:requestParam
                parentViewFrame:frame
      assertKindOfResponseClass:aClass
@@ -311,7 +333,7 @@ NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason
         }
     };
 
-    NSXPCListenerEndpointCompletionBlock continueBlockInternal = ^(id<MSIDXpcBrokerInstanceProtocol> xpcService, NSXPCConnection *directConnection, NSError *error)
+    NSXPCListenerEndpointCompletionBlock continueBlockInternal = ^(id<MSIDXpcBrokerInstanceProtocol> xpcService, id<MSIDXpcTransport> directConnection, NSError *error)
     {
         if (isCompleted())
         {
@@ -337,6 +359,10 @@ NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason
             if (isReplyReceived()) return;
             if (!claimCompletion()) return;
 
+            // The broker went away underneath us, so the last capability probe result can no longer be
+            // trusted. Keep answering from it, but let the next canPerformRequest: refresh it.
+            [xpcProviderCache invalidateCachedCapabilityResult];
+
             if (fromCache && useCachedEndpoint)
             {
                 MSID_LOG_WITH_CTX(MSIDLogLevelError, context, @"[Entra broker] CLIENT - cached XPC endpoint failed (%@), clearing cache and retrying via dispatcher", transportError);
@@ -396,26 +422,10 @@ NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason
             [self forceRunOnBackgroundQueue:forceRunOnBackgroundQueue dispatchBlock:^{
                 if (!claimCompletion()) return;
 
-                if (callbackError)
-                {
-                    MSID_LOG_WITH_CTX_PII(MSIDLogLevelError, nil, @"[Entra broker] CLIENT received operationResponse with error: %@", callbackError);
-                    if (continueBlock) continueBlock(nil, callbackError);
-                    return;
-                }
-
-                NSError *innerError = nil;
-                __auto_type operationResponse = (MSIDBrokerOperationTokenResponse *)[MSIDJsonSerializableFactory createFromJSONDictionary:replyParam classTypeJSONKey:MSID_BROKER_OPERATION_RESPONSE_TYPE_JSON_KEY assertKindOfClass:aClass error:&innerError];
-
-                if (!operationResponse)
-                {
-                    MSID_LOG_WITH_CTX(MSIDLogLevelError, nil, @"[Entra broker] CLIENT cannot create operationResponse");
-                    if (continueBlock) continueBlock(nil, innerError);
-                }
-                else
-                {
-                    MSID_LOG_WITH_CTX(MSIDLogLevelError, nil, @"[Entra broker] CLIENT received operationResponse, error: %@", callbackError);
-                    if (continueBlock) continueBlock(operationResponse, callbackError);
-                }
+                [self completeWithBrokerReply:replyParam
+                                        error:callbackError
+                    assertKindOfResponseClass:aClass
+                                continueBlock:continueBlock];
             }];
         }];
     };
@@ -438,6 +448,177 @@ NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason
     }
 }
 
+- (void)completeWithBrokerReply:(NSDictionary *)replyParam
+                          error:(NSError *)callbackError
+      assertKindOfResponseClass:(Class)aClass
+                  continueBlock:(MSIDSSOExtensionRequestDelegateCompletionBlock)continueBlock
+{
+    if (callbackError)
+    {
+        MSID_LOG_WITH_CTX_PII(MSIDLogLevelError, nil, @"[Entra broker] CLIENT received operationResponse with error: %@", callbackError);
+        if (continueBlock) continueBlock(nil, callbackError);
+        return;
+    }
+
+    NSError *innerError = nil;
+    __auto_type operationResponse = (MSIDBrokerOperationTokenResponse *)[MSIDJsonSerializableFactory createFromJSONDictionary:replyParam classTypeJSONKey:MSID_BROKER_OPERATION_RESPONSE_TYPE_JSON_KEY assertKindOfClass:aClass error:&innerError];
+
+    if (!operationResponse)
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelError, nil, @"[Entra broker] CLIENT cannot create operationResponse");
+        if (continueBlock) continueBlock(nil, innerError);
+    }
+    else
+    {
+        MSID_LOG_WITH_CTX(MSIDLogLevelError, nil, @"[Entra broker] CLIENT received operationResponse, error: %@", callbackError);
+        if (continueBlock) continueBlock(operationResponse, callbackError);
+    }
+}
+
+#pragma mark - Persistent broker channel
+
+// The provider cache owns its channel, so the channel and its connection go away with the cache.
+static char MSIDXpcBrokerChannelKey;
+
++ (NSObject *)brokerChannelsLock
+{
+    static NSObject *brokerChannelsLock = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        brokerChannelsLock = [NSObject new];
+    });
+    
+    return brokerChannelsLock;
+}
+
++ (nullable MSIDXpcBrokerChannelMetrics *)brokerChannelMetricsForProviderCache:(id<MSIDXpcProviderCaching>)xpcProviderCache
+{
+    MSIDXpcBrokerChannel *channel = nil;
+    @synchronized ([self brokerChannelsLock])
+    {
+        channel = objc_getAssociatedObject(xpcProviderCache, &MSIDXpcBrokerChannelKey);
+    }
+    
+    return channel.metrics;
+}
+
+- (MSIDXpcBrokerChannel *)brokerChannelForProviderCache:(id<MSIDXpcProviderCaching>)xpcProviderCache
+{
+    @synchronized ([self.class brokerChannelsLock])
+    {
+        MSIDXpcBrokerChannel *channel = objc_getAssociatedObject(xpcProviderCache, &MSIDXpcBrokerChannelKey);
+        if (channel) return channel;
+        
+        // The channel keeps the provider that created it to establish (and re-establish) connections.
+        // It must not keep the provider cache that owns it alive.
+        __weak id<MSIDXpcProviderCaching> weakProviderCache = xpcProviderCache;
+        channel = [[MSIDXpcBrokerChannel alloc] initWithConnector:^(MSIDXpcBrokerChannelConnectionBlock connectionBlock) {
+            id<MSIDXpcProviderCaching> strongProviderCache = weakProviderCache;
+            if (!strongProviderCache)
+            {
+                NSError *error = MSIDCreateError(MSIDErrorDomain, MSIDErrorInternal, @"[Entra broker] CLIENT -- provider cache of broker channel was released", nil, nil, nil, nil, nil, NO);
+                connectionBlock(nil, nil, error);
+                return;
+            }
+            
+            [self connectBrokerChannelWithProviderCache:strongProviderCache connectionBlock:connectionBlock];
+        }];
+        objc_setAssociatedObject(xpcProviderCache, &MSIDXpcBrokerChannelKey, channel, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+        return channel;
+    }
+}
+
+- (void)connectBrokerChannelWithProviderCache:(id<MSIDXpcProviderCaching>)xpcProviderCache
+                              connectionBlock:(MSIDXpcBrokerChannelConnectionBlock)connectionBlock
+{
+    NSXPCListenerEndpointCompletionBlock dispatcherContinueBlock = ^(id<MSIDXpcBrokerInstanceProtocol> xpcService, id<MSIDXpcTransport> directConnection, NSError *error)
+    {
+        if (error || !xpcService)
+        {
+            [xpcProviderCache clearCachedBrokerInstanceEndpoint];
+            [xpcProviderCache invalidateCachedCapabilityResult];
+        }
+        connectionBlock(xpcService, directConnection, error);
+    };
+    
+    NSXPCListenerEndpoint *cachedEndpoint = [self isXpcInstanceCacheEnabled] ? xpcProviderCache.cachedBrokerInstanceEndpoint : nil;
+    if (!cachedEndpoint)
+    {
+        [self getXpcService:xpcProviderCache requestCompleted:^BOOL{ return NO; } withContinueBlock:dispatcherContinueBlock];
+        return;
+    }
+    
+    // A stale cached endpoint fails before the channel ever connects; retry once through the dispatcher.
+    NSObject *stateLock = [NSObject new];
+    __block BOOL connected = NO;
+    __block BOOL retried = NO;
+    [self getXpcServiceFromCachedEndpoint:cachedEndpoint
+                         xpcProviderCache:xpcProviderCache
+                                  context:nil
+                        withContinueBlock:^(id<MSIDXpcBrokerInstanceProtocol> xpcService, id<MSIDXpcTransport> directConnection, NSError *error)
+    {
+        BOOL shouldRetry = NO;
+        @synchronized (stateLock)
+        {
+            if (!error && xpcService && directConnection)
+            {
+                connected = YES;
+            }
+            else if (!connected && !retried)
+            {
+                retried = YES;
+                shouldRetry = YES;
+            }
+        }
+        
+        if (shouldRetry)
+        {
+            MSID_LOG_WITH_CTX(MSIDLogLevelWarning, nil, @"[Entra broker] CLIENT - cached XPC endpoint failed for broker channel (%@), retrying via dispatcher", error);
+            [xpcProviderCache clearCachedBrokerInstanceEndpoint];
+            [self getXpcService:xpcProviderCache requestCompleted:^BOOL{ return NO; } withContinueBlock:dispatcherContinueBlock];
+            return;
+        }
+        
+        dispatcherContinueBlock(xpcService, directConnection, error);
+    }];
+}
+
+- (void)sendRequestThroughBrokerChannel:(NSDictionary *)requestParam
+              assertKindOfResponseClass:(Class)aClass
+                       xpcProviderCache:(id<MSIDXpcProviderCaching>)xpcProviderCache
+                                context:(id<MSIDRequestContext>)context
+                     brokerReplyTimeout:(NSTimeInterval)brokerReplyTimeout
+                          continueBlock:(MSIDSSOExtensionRequestDelegateCompletionBlock)continueBlock
+{
+    MSIDXpcBrokerChannel *channel = [self brokerChannelForProviderCache:xpcProviderCache];
+    [channel sendRequest:requestParam
+           correlationId:context.correlationId.UUIDString
+            replyTimeout:brokerReplyTimeout
+              completion:^(NSDictionary<NSString *,id> *replyParam, NSError *error, BOOL connectionDropped)
+    {
+        if (connectionDropped)
+        {
+            // Same contract as the per-request path: a transport failure before the reply gets one retry on
+            // a dedicated connection through the dispatcher.
+            MSID_LOG_WITH_CTX(MSIDLogLevelWarning, context, @"[Entra broker] CLIENT - broker channel dropped request (%@), retrying on dedicated connection", error);
+            [self attemptBrokerRequest:requestParam
+                       parentViewFrame:CGRectZero
+             assertKindOfResponseClass:aClass
+                      xpcProviderCache:xpcProviderCache
+                     useCachedEndpoint:NO
+                    brokerReplyTimeout:brokerReplyTimeout
+                               context:context
+                         continueBlock:continueBlock];
+            return;
+        }
+        
+        [self completeWithBrokerReply:replyParam
+                                error:error
+            assertKindOfResponseClass:aClass
+                        continueBlock:continueBlock];
+    }];
+}
+
 + (BOOL)canPerformRequest:(id<MSIDXpcProviderCaching>)xpcProviderCache
 {
     return [self canPerformRequest:xpcProviderCache reason:nil];
@@ -445,6 +626,81 @@ NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason
 
 + (BOOL)canPerformRequest:(id<MSIDXpcProviderCaching>)xpcProviderCache
                     reason:(MSIDXpcCanPerformFailureReason *)reason
+{
+    // Only the first probe against a given cache blocks the caller. After that the last known result
+    // is returned immediately and, once stale, refreshed on a background queue.
+    MSIDXpcCapabilityResult *cachedResult = xpcProviderCache.cachedCapabilityResult;
+    if (cachedResult)
+    {
+        if ([cachedResult isStaleWithTTL:xpcProviderCache.capabilityResultTTL])
+        {
+            [self refreshCapabilityInBackground:xpcProviderCache];
+        }
+        
+        if (reason)
+        {
+            *reason = cachedResult.failureReason;
+        }
+        return cachedResult.canPerform;
+    }
+    
+    // Callers racing the first probe wait for it and share its result instead of each running a handshake.
+    @synchronized ([self capabilityProbeLockForProviderCache:xpcProviderCache])
+    {
+        MSIDXpcCapabilityResult *probedResult = xpcProviderCache.cachedCapabilityResult;
+        if (!probedResult)
+        {
+            MSIDXpcCanPerformFailureReason probeReason = MSIDXpcCanPerformFailureReasonNone;
+            BOOL canPerform = [self probeCanPerformRequest:xpcProviderCache reason:&probeReason];
+            probedResult = [[MSIDXpcCapabilityResult alloc] initWithCanPerform:canPerform
+                                                                 failureReason:probeReason
+                                                                     probeDate:[NSDate date]];
+            xpcProviderCache.cachedCapabilityResult = probedResult;
+        }
+        
+        if (reason)
+        {
+            *reason = probedResult.failureReason;
+        }
+        return probedResult.canPerform;
+    }
+}
+
+// One lock per provider cache, owned by the cache, so that probes against different caches don't wait for each other.
+static char MSIDXpcCapabilityProbeLockKey;
+
++ (NSObject *)capabilityProbeLockForProviderCache:(id<MSIDXpcProviderCaching>)xpcProviderCache
+{
+    @synchronized ([self brokerChannelsLock])
+    {
+        NSObject *probeLock = objc_getAssociatedObject(xpcProviderCache, &MSIDXpcCapabilityProbeLockKey);
+        if (!probeLock)
+        {
+            probeLock = [NSObject new];
+            objc_setAssociatedObject(xpcProviderCache, &MSIDXpcCapabilityProbeLockKey, probeLock, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+        }
+        return probeLock;
+    }
+}
+
++ (void)refreshCapabilityInBackground:(id<MSIDXpcProviderCaching>)xpcProviderCache
+{
+    if (![xpcProviderCache beginCapabilityRefresh]) return;
+    
+    MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, nil, @"[Entra broker] CLIENT Xpc capability result is stale, refreshing in background", nil, nil);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        MSIDXpcCanPerformFailureReason probeReason = MSIDXpcCanPerformFailureReasonNone;
+        BOOL canPerform = [self probeCanPerformRequest:xpcProviderCache reason:&probeReason];
+        xpcProviderCache.cachedCapabilityResult = [[MSIDXpcCapabilityResult alloc] initWithCanPerform:canPerform
+                                                                                        failureReason:probeReason
+                                                                                            probeDate:[NSDate date]];
+        [xpcProviderCache endCapabilityRefresh];
+        MSID_LOG_WITH_CTX(MSIDLogLevelInfo, nil, @"[Entra broker] CLIENT Xpc capability refreshed, canPerform: %d, reason: %@", canPerform, MSIDXpcCanPerformFailureReasonToString(probeReason));
+    });
+}
+
++ (BOOL)probeCanPerformRequest:(id<MSIDXpcProviderCaching>)xpcProviderCache
+                         reason:(MSIDXpcCanPerformFailureReason *)reason
 {
     // Step 0: If none of the XPC components (CP or MacBrokerApp) exist on the device, return false.
     // Step 1: Read from the userDefaults cache to find the correct XPC configuration based on the active SsoExtension.
@@ -665,12 +921,12 @@ NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason
     }
 }
 
-- (NSXPCConnection *)dispatcherConnectionWithMachServiceName:(NSString *)machServiceName
+- (id<MSIDXpcTransport>)dispatcherConnectionWithMachServiceName:(NSString *)machServiceName
 {
     return [[NSXPCConnection alloc] initWithMachServiceName:machServiceName options:0];
 }
 
-- (NSXPCConnection *)directConnectionWithEndpoint:(NSXPCListenerEndpoint *)endpoint
+- (id<MSIDXpcTransport>)directConnectionWithEndpoint:(NSXPCListenerEndpoint *)endpoint
 {
     return [[NSXPCConnection alloc] initWithListenerEndpoint:endpoint];
 }
@@ -701,7 +957,7 @@ NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason
     BOOL cacheEnabled = [self isXpcInstanceCacheEnabled];
 
     MSID_LOG_WITH_CTX(MSIDLogLevelInfo, nil, @"[Entra broker] CLIENT - started establishing connection to %@", xpcProviderCache.xpcConfiguration.xpcMachServiceName);
-    NSXPCConnection *connection = [self dispatcherConnectionWithMachServiceName:xpcProviderCache.xpcConfiguration.xpcMachServiceName];
+    id<MSIDXpcTransport> connection = [self dispatcherConnectionWithMachServiceName:xpcProviderCache.xpcConfiguration.xpcMachServiceName];
     if (!connection)
     {
         continueBlock(nil, nil, MSIDXpcCreateTransportError(@"[Entra broker] CLIENT -- dispatcher connection is unavailable", nil));
@@ -826,7 +1082,7 @@ NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason
             }
         }
 
-        NSXPCConnection *directConnection = [self directConnectionWithEndpoint:listenerEndpoint];
+        id<MSIDXpcTransport> directConnection = [self directConnectionWithEndpoint:listenerEndpoint];
         if (!directConnection)
         {
             NSError *xpcUnexpectedError = MSIDXpcCreateTransportError(@"[Entra broker] CLIENT -- direct connection is unavailable", nil);
@@ -910,7 +1166,7 @@ NSString *MSIDXpcCanPerformFailureReasonToString(MSIDXpcCanPerformFailureReason
         return;
     }
 
-    NSXPCConnection *directConnection = [self directConnectionWithEndpoint:endpoint];
+    id<MSIDXpcTransport> directConnection = [self directConnectionWithEndpoint:endpoint];
     if (!directConnection)
     {
         if (continueBlock) continueBlock(nil, nil, MSIDXpcCreateTransportError(@"[Entra broker] CLIENT -- cached direct connection is unavailable", nil));
@@ -41,6 +41,15 @@
 
 @property (nonatomic) MSIDAadAuthorityCache *authorityCache;
 
+// Cache aliases memoized for the authority cache generation they were computed in. An authority lives for
+// one request, so aliases are computed once per request unless authority metadata changes in between.
+@property (nonatomic) MSIDAadAuthorityCache *memoizedAliasesCache;
+@property (nonatomic) uint64_t memoizedAliasesGeneration;
+@property (nonatomic) NSURL *memoizedAliasesURL;
+@property (nonatomic) NSArray<NSString *> *memoizedEnvironmentAliases;
+@property (nonatomic) NSSet<NSString *> *memoizedEnvironmentAliasSet;
+@property (nonatomic) NSArray<NSURL *> *memoizedLegacyAccessTokenLookupAuthorities;
+
 @end
 
 @implementation MSIDAADAuthority
@@ -111,16 +120,67 @@
 
 - (NSArray<NSURL *> *)legacyAccessTokenLookupAuthorities
 {
-    __auto_type universalAuthorityURL = [self universalAuthorityURL];
-    __auto_type authority = [[MSIDAADAuthority alloc] initWithURL:universalAuthorityURL context:nil error:nil];
-    if (authority) NSParameterAssert([authority isKindOfClass:MSIDAADAuthority.class]);
-    
-    return [self.authorityCache cacheAliasesForAuthority:authority];
+    @synchronized (self)
+    {
+        [self invalidateMemoizedAliasesIfNeeded];
+        
+        if (!self.memoizedLegacyAccessTokenLookupAuthorities)
+        {
+            __auto_type universalAuthorityURL = [self universalAuthorityURL];
+            __auto_type authority = [[MSIDAADAuthority alloc] initWithURL:universalAuthorityURL context:nil error:nil];
+            if (authority) NSParameterAssert([authority isKindOfClass:MSIDAADAuthority.class]);
+            
+            self.memoizedLegacyAccessTokenLookupAuthorities = [self.authorityCache cacheAliasesForAuthority:authority];
+        }
+        
+        return self.memoizedLegacyAccessTokenLookupAuthorities;
+    }
 }
 
 - (NSArray<NSString *> *)defaultCacheEnvironmentAliases
 {
-    return [self.authorityCache cacheAliasesForEnvironment:self.environment];
+    @synchronized (self)
+    {
+        [self invalidateMemoizedAliasesIfNeeded];
+        
+        if (!self.memoizedEnvironmentAliases)
+        {
+            self.memoizedEnvironmentAliases = [self.authorityCache cacheAliasesForEnvironment:self.environment];
+            self.memoizedEnvironmentAliasSet = [NSString msidLowercasedAliasSet:self.memoizedEnvironmentAliases];
+        }
+        
+        return self.memoizedEnvironmentAliases;
+    }
+}
+
+- (NSSet<NSString *> *)defaultCacheEnvironmentAliasSet
+{
+    @synchronized (self)
+    {
+        [self defaultCacheEnvironmentAliases];
+        return self.memoizedEnvironmentAliasSet;
+    }
+}
+
+- (void)invalidateMemoizedAliasesIfNeeded
+{
+    // Read the generation before computing, so aliases computed during a metadata update are recomputed on next use.
+    uint64_t generation = self.authorityCache.generation;
+    NSURL *url = self.url;
+    
+    if (self.memoizedAliasesCache == self.authorityCache
+        && self.memoizedAliasesGeneration == generation
+        && [self.memoizedAliasesURL isEqual:url])
+    {
+        return;
+    }
+    
+    self.memoizedAliasesCache = self.authorityCache;
+    self.memoizedAliasesGeneration = generation;
+    self.memoizedAliasesURL = url;
+    self.memoizedEnvironmentAliases = nil;
+    self.memoizedEnvironmentAliasSet = nil;
+    self.memoizedLegacyAccessTokenLookupAuthorities = nil;
 }
 
 - (nonnull NSURL *)universalAuthorityURL
@@ -268,12 +328,12 @@
 
 - (BOOL)checkTokenEndpointForRTRefresh:(NSURL *)tokenEndpoint
 {
-    NSArray *environmentAliases = self.defaultCacheEnvironmentAliases;
+    NSSet *environmentAliases = self.defaultCacheEnvironmentAliasSet;
     
     if (!tokenEndpoint || ![environmentAliases count])
         return YES;
     
-    return [tokenEndpoint.host.msidNormalizedString msidIsEquivalentWithAnyAlias:environmentAliases];
+    return [tokenEndpoint.host.msidNormalizedString msidIsEquivalentWithAnyAliasInSet:environmentAliases];
 }
 
 - (BOOL)needsUpdateToHomeAuthority:(BOOL)isAccountFromMSATenant
@@ -35,6 +35,15 @@
 
 @property (nonatomic) NSSet<NSString *> *allCloudNetworkEnvironments;
 
+/*!
+ Incremented every time a record is added, replaced or removed. Authorities memoize their cache aliases
+ and recompute them only when the generation changes.
+ */
+@property (nonatomic, readonly) uint64_t generation;
+
+// Number of times cache aliases were computed from the records.
+@property (nonatomic, readonly) uint64_t aliasComputationCount;
+
 + (MSIDAadAuthorityCache *)sharedInstance;
 
 - (NSURL *)networkUrlForAuthority:(MSIDAADAuthority *)authority
@@ -27,6 +27,7 @@
 
 #import "MSIDAadAuthorityCache.h"
 #include <pthread.h>
+#import <stdatomic.h>
 #import "MSIDError.h"
 #import "MSIDAADAuthority.h"
 #import "MSIDAadAuthorityCacheRecord.h"
@@ -40,6 +41,10 @@
     }
 
 @implementation MSIDAadAuthorityCache
+{
+    atomic_ullong _generation;
+    atomic_ullong _aliasComputationCount;
+}
 
 + (MSIDAadAuthorityCache *)sharedInstance
 {
@@ -200,6 +205,51 @@ openIdConfigEndpoint:(NSURL *)openIdConfigEndpoint
     [self setObject:record forKey:authority.environment];
 }
 
+#pragma mark -
+#pragma mark Generation
+
+- (uint64_t)generation
+{
+    return atomic_load(&_generation);
+}
+
+- (uint64_t)aliasComputationCount
+{
+    return atomic_load(&_aliasComputationCount);
+}
+
+- (void)setObject:(id)obj forKey:(id)key
+{
+    [super setObject:obj forKey:key];
+    atomic_fetch_add(&_generation, 1);
+}
+
+- (void)removeObjectForKey:(id)key
+{
+    [super removeObjectForKey:key];
+    atomic_fetch_add(&_generation, 1);
+}
+
+- (void)removeAllObjects
+{
+    [super removeAllObjects];
+    atomic_fetch_add(&_generation, 1);
+}
+
+- (id)copyAndRemoveObjectForKey:(id)key
+{
+    id object = [super copyAndRemoveObjectForKey:key];
+    atomic_fetch_add(&_generation, 1);
+    return object;
+}
+
+- (id)copyAndReplaceObjectForKey:(id)key withObject:(id)obj
+{
+    id object = [super copyAndReplaceObjectForKey:key withObject:obj];
+    atomic_fetch_add(&_generation, 1);
+    return object;
+}
+
 #pragma mark -
 #pragma mark Cache Accessors
 
@@ -338,6 +388,7 @@ static NSURL *urlForPreferredHost(NSURL *url, NSString *preferredHost)
 
 - (NSArray<NSURL *> *)cacheAliasesForAuthorityImpl:(MSIDAADAuthority *)authority
 {
+    atomic_fetch_add_explicit(&_aliasComputationCount, 1, memory_order_relaxed);
     NSMutableArray<NSURL *> *authorities = [NSMutableArray new];
     
     MSIDAadAuthorityCacheRecord *record = [self objectForKey:authority.url.msidHostWithPortIfNecessary];
@@ -382,6 +433,7 @@ static NSURL *urlForPreferredHost(NSURL *url, NSString *preferredHost)
 
 - (NSArray<NSString *> *)cacheAliasesForEnvironmentImpl:(NSString *)environment
 {
+    atomic_fetch_add_explicit(&_aliasComputationCount, 1, memory_order_relaxed);
     NSMutableArray<NSString *> *environments = [NSMutableArray new];
 
     MSIDAadAuthorityCacheRecord *record = [self objectForKey:environment];
@@ -77,6 +77,9 @@ typedef void(^MSIDOpenIdConfigurationInfoBlock)(MSIDOpenIdProviderMetadata * _Nu
 
 - (nonnull NSArray<NSString *> *)defaultCacheEnvironmentAliases;
 
+// Lowercased defaultCacheEnvironmentAliases for matching cache items with msidIsEquivalentWithAnyAliasInSet:.
+- (nonnull NSSet<NSString *> *)defaultCacheEnvironmentAliasSet;
+
 - (nullable NSString *)enrollmentIdForHomeAccountId:(nullable NSString *)homeAccountId
                                        legacyUserId:(nullable NSString *)legacyUserId
                                             context:(nullable id<MSIDRequestContext>)context
@@ -163,6 +163,11 @@ NSString *const MSID_AUTHORITY_TYPE_JSON_KEY = @"authority_type";
     return @[self.environment];
 }
 
+- (NSSet<NSString *> *)defaultCacheEnvironmentAliasSet
+{
+    return [NSString msidLowercasedAliasSet:[self defaultCacheEnvironmentAliases]];
+}
+
 - (NSString *)enrollmentIdForHomeAccountId:(__unused NSString *)homeAccountId
                               legacyUserId:(__unused NSString *)legacyUserId
                                    context:(__unused id<MSIDRequestContext>)context
@@ -138,6 +138,19 @@
         return;
     }
 
+    MSIDRequestParameters *nonceRequestParameters = [MSIDRequestParameters new];
+    nonceRequestParameters.correlationId = requestParameters.correlationId;
+    nonceRequestParameters.authority = [[MSIDAADAuthority alloc] initWithURL:endpoint
+                                                                   rawTenant:MSIDAADTenantTypeCommonRawValue
+                                                                     context:requestParameters
+                                                                       error:nil];
+    // Blank account id bypasses the nonce cache and forces a fresh nonce request.
+    nonceRequestParameters.accountIdentifier = [[MSIDAccountIdentifier alloc] initWithDisplayableId:@""
+                                                                                     homeAccountId:@""];
+    
+    // Start the nonce round trip while the enrollment id is looked up, the nonce request below joins it.
+    [MSIDNonceTokenRequest prefetchNonceWithRequestParameters:nonceRequestParameters];
+
     // Device tokens are not tied to a user, so use the first available enrollment id (if any).
     NSString *deviceEnrollmentId = enrollmentId;
     if ([NSString msidIsStringNilOrBlank:deviceEnrollmentId])
@@ -156,16 +169,6 @@
     }
 
     // 1. Fetch a fresh nonce from the server. It is embedded into the signed JWT as request_nonce.
-    MSIDRequestParameters *nonceRequestParameters = [MSIDRequestParameters new];
-    nonceRequestParameters.correlationId = requestParameters.correlationId;
-    nonceRequestParameters.authority = [[MSIDAADAuthority alloc] initWithURL:endpoint
-                                                                   rawTenant:MSIDAADTenantTypeCommonRawValue
-                                                                     context:requestParameters
-                                                                       error:nil];
-    // Blank account id bypasses the nonce cache and forces a fresh nonce request.
-    nonceRequestParameters.accountIdentifier = [[MSIDAccountIdentifier alloc] initWithDisplayableId:@""
-                                                                                     homeAccountId:@""];
-
     MSIDNonceTokenRequest *nonceRequest =
         [[MSIDNonceTokenRequest alloc] initWithRequestParameters:nonceRequestParameters];
     [nonceRequest executeRequestWithCompletion:^(NSString * _Nullable resultNonce, NSError * _Nullable nonceError)
@@ -22,3 +22,4 @@
 #import "MSIDSwitchBrowserResumeOperation.h"
 #import "MSIDFlightManagerMockProvider.h"
 #import "MSIDFlightManager.h"
+#import "MSIDBenchmarkTestCase.h"
@@ -597,6 +597,56 @@
     XCTAssertEqualObjects(aliases, expectedAliases);
 }
 
+- (void)testDefaultCacheEnvironmentAliases_whenCalledRepeatedly_shouldComputeAliasesOnce
+{
+    [self setupAADAuthorityCache];
+    __auto_type cache = [MSIDAadAuthorityCache sharedInstance];
+    __auto_type authority = [@"https://login.microsoftonline.com/contoso.com" aadAuthority];
+    uint64_t computationCount = cache.aliasComputationCount;
+    
+    NSArray *aliases = [authority defaultCacheEnvironmentAliases];
+    
+    for (int i = 0; i < 10; i++)
+    {
+        XCTAssertEqual([authority defaultCacheEnvironmentAliases], aliases);
+        [authority defaultCacheEnvironmentAliasSet];
+    }
+    
+    XCTAssertEqual(cache.aliasComputationCount - computationCount, 1);
+    XCTAssertEqualObjects([authority defaultCacheEnvironmentAliasSet], [NSSet setWithArray:aliases]);
+}
+
+- (void)testDefaultCacheEnvironmentAliases_whenAuthorityCacheChanges_shouldRecomputeAliases
+{
+    __auto_type cache = [MSIDAadAuthorityCache sharedInstance];
+    __auto_type authority = [@"https://login.microsoftonline.com/contoso.com" aadAuthority];
+    uint64_t generation = cache.generation;
+    
+    XCTAssertEqualObjects([authority defaultCacheEnvironmentAliases], @[@"login.microsoftonline.com"]);
+    
+    [self setupAADAuthorityCache];
+    XCTAssertGreaterThan(cache.generation, generation);
+    
+    NSArray *expectedAliases = @[@"login.windows.net",
+                                 @"login.microsoftonline.com",
+                                 @"login.microsoft.com"];
+    XCTAssertEqualObjects([authority defaultCacheEnvironmentAliases], expectedAliases);
+    XCTAssertTrue([@"LOGIN.WINDOWS.NET" msidIsEquivalentWithAnyAliasInSet:[authority defaultCacheEnvironmentAliasSet]]);
+}
+
+- (void)testLegacyAccessTokenLookupAuthorities_whenCalledRepeatedly_shouldComputeAliasesOnce
+{
+    [self setupAADAuthorityCache];
+    __auto_type cache = [MSIDAadAuthorityCache sharedInstance];
+    __auto_type authority = [@"https://login.microsoftonline.com/contoso.com" aadAuthority];
+    uint64_t computationCount = cache.aliasComputationCount;
+    
+    NSArray *aliases = [authority legacyAccessTokenLookupAuthorities];
+    XCTAssertEqual([authority legacyAccessTokenLookupAuthorities], aliases);
+    
+    XCTAssertEqual(cache.aliasComputationCount - computationCount, 1);
+}
+
 #pragma mark - legacyRefreshTokenLookupAliases
 
 - (void)testLegacyRefreshTokenLookupAliases_whenAuthorityIsNotConsumers_shouldReturnAliases
@@ -28,6 +28,8 @@
 #import "MSIDAADTokenResponseSerializer.h"
 #import "MSIDAADV2Oauth2Factory.h"
 #import "MSIDAADTokenResponse.h"
+#import "MSIDExponentialBackoffRetryPolicy.h"
+#import "MSIDRetryBudget.h"
 
 @interface MSIDHttpTestRequest : NSObject <MSIDHttpRequestProtocol>
 
@@ -37,6 +39,7 @@
 @property (nonatomic) NSInteger retryCounter;
 @property (nonatomic) NSTimeInterval retryInterval;
 @property (nonatomic) NSURLRequest *urlRequest;
+@property (nonatomic) id<MSIDHttpRequestRetryPolicy> retryPolicy;
 
 @end
 
@@ -411,4 +414,73 @@
     XCTAssertTrue(isBlockInvoked);
 }
 
+#pragma mark - Retry policy
+
+- (void)testHandleError_whenServerErrorAndRetryPolicyAllowsRetry_shouldRetryWithoutTouchingRetryCounter
+{
+    __auto_type httpResponse = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://contoso.com/token"]
+                                                           statusCode:503
+                                                          HTTPVersion:nil
+                                                         headerFields:nil];
+    __auto_type httpRequest = [MSIDHttpTestRequest new];
+    httpRequest.urlRequest = [NSURLRequest requestWithURL:httpResponse.URL];
+    MSIDExponentialBackoffRetryPolicy *retryPolicy = [[MSIDExponentialBackoffRetryPolicy alloc] initWithMaxRetries:1 baseDelay:0.01];
+    retryPolicy.retryBudget = [[MSIDRetryBudget alloc] initWithCapacity:1 refillRatePerSecond:0];
+    httpRequest.retryPolicy = retryPolicy;
+    __block BOOL isBlockInvoked = NO;
+    __auto_type block = ^(__unused id response, __unused NSError *error) {
+        isBlockInvoked = YES;
+    };
+
+    [self keyValueObservingExpectationForObject:httpRequest keyPath:@"sendWithBlockCounter" expectedValue:@1];
+
+    [self.errorHandler handleError:nil
+                      httpResponse:httpResponse
+                              data:nil
+                       httpRequest:httpRequest
+                responseSerializer:[MSIDHttpResponseSerializer new]
+                externalSSOContext:nil
+                           context:[MSIDTestContext new]
+                   completionBlock:block];
+
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+
+    XCTAssertEqual(1, retryPolicy.retryCount);
+    XCTAssertEqual(1, httpRequest.retryCounter);
+    XCTAssertFalse(isBlockInvoked);
+}
+
+- (void)testHandleError_whenServerErrorAndRetryPolicyDeclines_shouldReturnServerError
+{
+    __auto_type httpResponse = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://contoso.com/token"]
+                                                           statusCode:503
+                                                          HTTPVersion:nil
+                                                         headerFields:@{@"Retry-After": @"600"}];
+    __auto_type httpRequest = [MSIDHttpTestRequest new];
+    httpRequest.urlRequest = [NSURLRequest requestWithURL:httpResponse.URL];
+    MSIDExponentialBackoffRetryPolicy *retryPolicy = [[MSIDExponentialBackoffRetryPolicy alloc] initWithMaxRetries:1 baseDelay:0.01];
+    retryPolicy.retryBudget = [[MSIDRetryBudget alloc] initWithCapacity:1 refillRatePerSecond:0];
+    httpRequest.retryPolicy = retryPolicy;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Block invoked"];
+    __block NSError *returnedError = nil;
+
+    [self.errorHandler handleError:nil
+                      httpResponse:httpResponse
+                              data:nil
+                       httpRequest:httpRequest
+                responseSerializer:[MSIDHttpResponseSerializer new]
+                externalSSOContext:nil
+                           context:[MSIDTestContext new]
+                   completionBlock:^(__unused id response, NSError *error) {
+        returnedError = error;
+        [expectation fulfill];
+    }];
+
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+
+    XCTAssertEqual(0, httpRequest.sendWithBlockCounter);
+    XCTAssertEqual(MSIDErrorServerUnhandledResponse, returnedError.code);
+    XCTAssertEqualObjects(returnedError.userInfo[MSIDHTTPHeadersKey][@"Retry-After"], @"600");
+}
+
 @end
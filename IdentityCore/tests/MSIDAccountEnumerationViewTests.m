@@ -0,0 +1,356 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDAccountEnumerationView.h"
+#import "MSIDAccountEnumerationDelta.h"
+#import "MSIDDefaultTokenCacheAccessor.h"
+#import "MSIDAccountCredentialCache.h"
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDAccountCacheItem.h"
+#import "MSIDCredentialCacheItem.h"
+#import "MSIDAccount.h"
+#import "MSIDAccountIdentifier.h"
+#import "MSIDBenchmarkTestCase.h"
+
+@interface MSIDAccountEnumerationCountingTestCacheDataSource : MSIDTestCacheDataSource
+
+@property (atomic) NSUInteger accountQueryCount;
+@property (atomic) BOOL reportsChangeToken;
+
+@end
+
+@implementation MSIDAccountEnumerationCountingTestCacheDataSource
+
+- (NSArray<MSIDAccountCacheItem *> *)accountsWithKey:(MSIDCacheKey *)key
+                                          serializer:(id<MSIDExtendedCacheItemSerializing>)serializer
+                                             context:(id<MSIDRequestContext>)context
+                                               error:(NSError *__autoreleasing *)error
+{
+    self.accountQueryCount++;
+    return [super accountsWithKey:key serializer:serializer context:context error:error];
+}
+
+- (NSString *)cacheChangeTokenWithContext:(id<MSIDRequestContext>)context error:(NSError *__autoreleasing *)error
+{
+    return self.reportsChangeToken ? [super cacheChangeTokenWithContext:context error:error] : nil;
+}
+
+@end
+
+@interface MSIDAccountEnumerationViewTests : XCTestCase
+
+@property (nonatomic) MSIDAccountEnumerationCountingTestCacheDataSource *dataSource;
+@property (nonatomic) MSIDDefaultTokenCacheAccessor *accessor;
+@property (nonatomic) MSIDAccountEnumerationView *view;
+
+@end
+
+@implementation MSIDAccountEnumerationViewTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    self.dataSource = [MSIDAccountEnumerationCountingTestCacheDataSource new];
+    self.dataSource.reportsChangeToken = YES;
+    self.accessor = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:self.dataSource otherCacheAccessors:nil];
+    self.view = [self viewWithAccessor:self.accessor];
+}
+
+- (void)tearDown
+{
+    [self.dataSource reset];
+    [super tearDown];
+}
+
+#pragma mark - Tests
+
+- (void)testAccountChanges_whenGenerationZero_shouldReturnFullSnapshot
+{
+    [self saveAccountWithUid:@"uid1" username:@"user1@contoso.com"];
+    [self saveAccountWithUid:@"uid2" username:@"user2@contoso.com"];
+    
+    NSError *error = nil;
+    MSIDAccountEnumerationDelta *delta = [self.view accountChangesSinceGeneration:0 context:nil error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssertTrue(delta.isFullSnapshot);
+    XCTAssertEqual(delta.generation, 1u);
+    XCTAssertEqual(delta.addedAccounts.count, 2u);
+    XCTAssertEqual(self.view.generation, 1u);
+}
+
+- (void)testAccountChanges_whenCacheUnchanged_shouldReturnEmptyDeltaWithoutReadingCache
+{
+    [self saveAccountWithUid:@"uid1" username:@"user1@contoso.com"];
+    NSUInteger generation = [self.view accountChangesSinceGeneration:0 context:nil error:nil].generation;
+    self.dataSource.accountQueryCount = 0;
+    
+    MSIDAccountEnumerationDelta *delta = [self.view accountChangesSinceGeneration:generation context:nil error:nil];
+    
+    XCTAssertNotNil(delta);
+    XCTAssertFalse(delta.hasChanges);
+    XCTAssertEqual(delta.generation, generation);
+    XCTAssertEqual(self.dataSource.accountQueryCount, 0u);
+    XCTAssertEqual([self.view accountsWithContext:nil error:nil].count, 1u);
+    XCTAssertEqual(self.dataSource.accountQueryCount, 0u);
+}
+
+- (void)testAccountChanges_whenAccountAdded_shouldReturnOnlyAddedAccount
+{
+    [self saveAccountWithUid:@"uid1" username:@"user1@contoso.com"];
+    NSUInteger generation = [self.view accountChangesSinceGeneration:0 context:nil error:nil].generation;
+    
+    [self saveAccountWithUid:@"uid2" username:@"user2@contoso.com"];
+    MSIDAccountEnumerationDelta *delta = [self.view accountChangesSinceGeneration:generation context:nil error:nil];
+    
+    XCTAssertFalse(delta.isFullSnapshot);
+    XCTAssertEqual(delta.generation, generation + 1);
+    XCTAssertEqual(delta.addedAccounts.count, 1u);
+    XCTAssertEqualObjects(delta.addedAccounts.firstObject.accountIdentifier.homeAccountId, @"uid2.utid");
+    XCTAssertEqual(delta.updatedAccounts.count, 0u);
+    XCTAssertEqual(delta.removedAccounts.count, 0u);
+}
+
+- (void)testAccountChanges_whenAccountUpdated_shouldReturnUpdatedAccount
+{
+    [self saveAccountWithUid:@"uid1" username:@"user1@contoso.com"];
+    NSUInteger generation = [self.view accountChangesSinceGeneration:0 context:nil error:nil].generation;
+    
+    [self saveAccountWithUid:@"uid1" username:@"renamed@contoso.com"];
+    MSIDAccountEnumerationDelta *delta = [self.view accountChangesSinceGeneration:generation context:nil error:nil];
+    
+    XCTAssertEqual(delta.addedAccounts.count, 0u);
+    XCTAssertEqual(delta.updatedAccounts.count, 1u);
+    XCTAssertEqualObjects(delta.updatedAccounts.firstObject.username, @"renamed@contoso.com");
+    XCTAssertEqual(delta.removedAccounts.count, 0u);
+}
+
+- (void)testAccountChanges_whenAccountRemoved_shouldReturnRemovedAccount
+{
+    MSIDAccountCacheItem *account = [self saveAccountWithUid:@"uid1" username:@"user1@contoso.com"];
+    [self saveAccountWithUid:@"uid2" username:@"user2@contoso.com"];
+    NSUInteger generation = [self.view accountChangesSinceGeneration:0 context:nil error:nil].generation;
+    
+    XCTAssertTrue([self.accessor.accountCredentialCache removeAccount:account context:nil error:nil]);
+    MSIDAccountEnumerationDelta *delta = [self.view accountChangesSinceGeneration:generation context:nil error:nil];
+    
+    XCTAssertEqual(delta.addedAccounts.count, 0u);
+    XCTAssertEqual(delta.updatedAccounts.count, 0u);
+    XCTAssertEqual(delta.removedAccounts.count, 1u);
+    XCTAssertEqualObjects(delta.removedAccounts.firstObject.accountIdentifier.homeAccountId, @"uid1.utid");
+    XCTAssertEqual([self.view accountsWithContext:nil error:nil].count, 1u);
+}
+
+- (void)testAccountChanges_whenAccountAddedAndRemovedAfterGeneration_shouldNotReportIt
+{
+    [self saveAccountWithUid:@"uid1" username:@"user1@contoso.com"];
+    NSUInteger generation = [self.view accountChangesSinceGeneration:0 context:nil error:nil].generation;
+    
+    MSIDAccountCacheItem *account = [self saveAccountWithUid:@"uid2" username:@"user2@contoso.com"];
+    [self.view accountsWithContext:nil error:nil];
+    XCTAssertTrue([self.accessor.accountCredentialCache removeAccount:account context:nil error:nil]);
+    
+    MSIDAccountEnumerationDelta *delta = [self.view accountChangesSinceGeneration:generation context:nil error:nil];
+    
+    XCTAssertEqual(delta.generation, generation + 2);
+    XCTAssertFalse(delta.hasChanges);
+}
+
+- (void)testAccountChanges_whenAccountRemovedAndAddedBackAfterGeneration_shouldReportItUpdatedOnly
+{
+    MSIDAccountCacheItem *account = [self saveAccountWithUid:@"uid1" username:@"user1@contoso.com"];
+    [self saveAccountWithUid:@"uid2" username:@"user2@contoso.com"];
+    NSUInteger generation = [self.view accountChangesSinceGeneration:0 context:nil error:nil].generation;
+    
+    XCTAssertTrue([self.accessor.accountCredentialCache removeAccount:account context:nil error:nil]);
+    NSUInteger removalGeneration = [self.view accountChangesSinceGeneration:generation context:nil error:nil].generation;
+    [self saveAccountWithUid:@"uid1" username:@"user1@contoso.com"];
+    
+    MSIDAccountEnumerationDelta *delta = [self.view accountChangesSinceGeneration:generation context:nil error:nil];
+    
+    XCTAssertEqual(delta.addedAccounts.count, 0u);
+    XCTAssertEqual(delta.removedAccounts.count, 0u);
+    XCTAssertEqual(delta.updatedAccounts.count, 1u);
+    XCTAssertEqualObjects(delta.updatedAccounts.firstObject.accountIdentifier.homeAccountId, @"uid1.utid");
+    
+    // A caller that has seen the removal gets the account as added
+    delta = [self.view accountChangesSinceGeneration:removalGeneration context:nil error:nil];
+    
+    XCTAssertEqual(delta.addedAccounts.count, 1u);
+    XCTAssertEqual(delta.removedAccounts.count, 0u);
+    XCTAssertEqual(delta.updatedAccounts.count, 0u);
+}
+
+- (void)testAccountChanges_whenUnrelatedItemSaved_shouldKeepGeneration
+{
+    [self saveAccountWithUid:@"uid1" username:@"user1@contoso.com"];
+    NSUInteger generation = [self.view accountChangesSinceGeneration:0 context:nil error:nil].generation;
+    self.dataSource.accountQueryCount = 0;
+    
+    MSIDCredentialCacheItem *refreshToken = [MSIDCredentialCacheItem new];
+    refreshToken.credentialType = MSIDRefreshTokenType;
+    refreshToken.homeAccountId = @"uid1.utid";
+    refreshToken.environment = @"login.microsoftonline.com";
+    refreshToken.clientId = @"client";
+    refreshToken.secret = @"rt";
+    XCTAssertTrue([self.accessor.accountCredentialCache saveCredential:refreshToken context:nil error:nil]);
+    
+    MSIDAccountEnumerationDelta *delta = [self.view accountChangesSinceGeneration:generation context:nil error:nil];
+    
+    XCTAssertEqual(self.dataSource.accountQueryCount, 1u);
+    XCTAssertEqual(delta.generation, generation);
+    XCTAssertFalse(delta.hasChanges);
+}
+
+- (void)testAccountChanges_whenGenerationUnknown_shouldReturnFullSnapshot
+{
+    [self saveAccountWithUid:@"uid1" username:@"user1@contoso.com"];
+    [self.view accountChangesSinceGeneration:0 context:nil error:nil];
+    
+    MSIDAccountEnumerationDelta *delta = [self.view accountChangesSinceGeneration:42 context:nil error:nil];
+    
+    XCTAssertTrue(delta.isFullSnapshot);
+    XCTAssertEqual(delta.addedAccounts.count, 1u);
+}
+
+- (void)testAccountChanges_whenDataSourceDoesNotReportChangeToken_shouldEnumerateEveryCall
+{
+    self.dataSource.reportsChangeToken = NO;
+    [self saveAccountWithUid:@"uid1" username:@"user1@contoso.com"];
+    NSUInteger generation = [self.view accountChangesSinceGeneration:0 context:nil error:nil].generation;
+    self.dataSource.accountQueryCount = 0;
+    
+    MSIDAccountEnumerationDelta *delta = [self.view accountChangesSinceGeneration:generation context:nil error:nil];
+    
+    XCTAssertFalse(delta.hasChanges);
+    XCTAssertEqual(self.dataSource.accountQueryCount, 1u);
+}
+
+#pragma mark - Helpers
+
+- (MSIDAccountEnumerationView *)viewWithAccessor:(MSIDDefaultTokenCacheAccessor *)accessor
+{
+    return [[MSIDAccountEnumerationView alloc] initWithCacheAccessor:accessor
+                                                         dataSources:nil
+                                                           authority:nil
+                                                            clientId:nil
+                                                            familyId:nil
+                                                accountMetadataCache:nil
+                                                signedInAccountsOnly:NO];
+}
+
+- (void)saveAccounts:(NSUInteger)count
+{
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        [self saveAccountWithUid:[NSString stringWithFormat:@"uid%lu", (unsigned long)i]
+                        username:[NSString stringWithFormat:@"user%lu@contoso.com", (unsigned long)i]];
+    }
+}
+
+- (MSIDAccountCacheItem *)saveAccountWithUid:(NSString *)uid username:(NSString *)username
+{
+    MSIDAccountCacheItem *item = [MSIDAccountCacheItem new];
+    item.accountType = MSIDAccountTypeMSSTS;
+    item.homeAccountId = [NSString stringWithFormat:@"%@.utid", uid];
+    item.environment = @"login.microsoftonline.com";
+    item.realm = @"utid";
+    item.localAccountId = uid;
+    item.username = username;
+    XCTAssertTrue([self.accessor.accountCredentialCache saveAccount:item context:nil error:nil]);
+    return item;
+}
+
+@end
+
+@interface MSIDAccountEnumerationViewBenchmarks : MSIDBenchmarkTestCase
+
+@property (nonatomic) MSIDAccountEnumerationCountingTestCacheDataSource *dataSource;
+@property (nonatomic) MSIDDefaultTokenCacheAccessor *accessor;
+
+@end
+
+@implementation MSIDAccountEnumerationViewBenchmarks
+
+- (void)setUp
+{
+    [super setUp];
+    
+    self.dataSource = [MSIDAccountEnumerationCountingTestCacheDataSource new];
+    self.dataSource.reportsChangeToken = YES;
+    self.accessor = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:self.dataSource otherCacheAccessors:nil];
+    
+    for (NSUInteger i = 0; i < 100; i++)
+    {
+        MSIDAccountCacheItem *item = [MSIDAccountCacheItem new];
+        item.accountType = MSIDAccountTypeMSSTS;
+        item.homeAccountId = [NSString stringWithFormat:@"uid%lu.utid", (unsigned long)i];
+        item.environment = @"login.microsoftonline.com";
+        item.realm = @"utid";
+        item.localAccountId = [NSString stringWithFormat:@"uid%lu", (unsigned long)i];
+        item.username = [NSString stringWithFormat:@"user%lu@contoso.com", (unsigned long)i];
+        XCTAssertTrue([self.accessor.accountCredentialCache saveAccount:item context:nil error:nil]);
+    }
+}
+
+- (void)tearDown
+{
+    [self.dataSource reset];
+    [super tearDown];
+}
+
+#pragma mark - Benchmarks
+
+- (void)testAccountsWithAuthority_repeatedEnumeration_100Accounts_benchmark
+{
+    [self benchmark:@"accounts_with_authority_100_accounts" operations:20 block:^{
+        NSArray *accounts = [self.accessor accountsWithAuthority:nil clientId:nil familyId:nil accountIdentifier:nil accountMetadataCache:nil signedInAccountsOnly:NO context:nil error:nil];
+        XCTAssertEqual(accounts.count, 100u);
+    }];
+}
+
+- (void)testAccountChanges_repeatedEnumeration_100Accounts_benchmark
+{
+    // One full snapshot followed by 19 unchanged checks per operation.
+    [self benchmark:@"account_changes_100_accounts" operations:1 block:^{
+        MSIDAccountEnumerationView *view = [[MSIDAccountEnumerationView alloc] initWithCacheAccessor:self.accessor
+                                                                                          dataSources:nil
+                                                                                            authority:nil
+                                                                                             clientId:nil
+                                                                                             familyId:nil
+                                                                                 accountMetadataCache:nil
+                                                                                 signedInAccountsOnly:NO];
+        NSUInteger generation = 0;
+        for (NSUInteger i = 0; i < 20; i++)
+        {
+            MSIDAccountEnumerationDelta *delta = [view accountChangesSinceGeneration:generation context:nil error:nil];
+            XCTAssertEqual(delta.addedAccounts.count, i == 0 ? 100u : 0u);
+            generation = delta.generation;
+        }
+    }];
+}
+
+@end
@@ -44,6 +44,31 @@
 @end
 
 
+// Reports a controllable modification date for account metadata and counts full reads.
+@interface MSIDModificationDateTestCacheDataSource : MSIDTestCacheDataSource
+
+@property (nonatomic) NSDate *modificationDate;
+@property (nonatomic) NSUInteger accountMetadataReadCount;
+
+@end
+
+@implementation MSIDModificationDateTestCacheDataSource
+
+- (NSDate *)accountMetadataModificationDateWithKey:(__unused MSIDCacheKey *)key
+                                           context:(__unused id<MSIDRequestContext>)context
+                                             error:(__unused NSError *__autoreleasing *)error
+{
+    return self.modificationDate;
+}
+
+- (MSIDAccountMetadataCacheItem *)accountMetadataWithKey:(MSIDCacheKey *)key serializer:(id<MSIDExtendedCacheItemSerializing>)serializer context:(id<MSIDRequestContext>)context error:(NSError *__autoreleasing *)error
+{
+    self.accountMetadataReadCount++;
+    return [super accountMetadataWithKey:key serializer:serializer context:context error:error];
+}
+
+@end
+
 @interface MSIDAccountMetadataCacheAccessorTests : XCTestCase
 
 @property (nonatomic) MSIDAccountMetadataCacheAccessor *accountMetadataCache;
@@ -195,6 +220,34 @@
     XCTAssertEqualObjects(@"https://login.microsoftonline.com/contoso", retrievedCacheURL.absoluteString);
 }
 
+- (void)testUpdateSignInStateForHomeAccountId_whenSourcePassed_shouldRecordSource {
+    NSError *error;
+    XCTAssertTrue([self.accountMetadataCache updateSignInStateForHomeAccountId:@"uid.utid" clientId:@"my-client-id" state:MSIDAccountMetadataStateSignedIn source:MSIDAccountMetadataSourceBroker context:nil error:&error]);
+    XCTAssertNil(error);
+    
+    XCTAssertEqual([self.accountMetadataCache sourceForHomeAccountId:@"uid.utid" clientId:@"my-client-id" context:nil error:&error], MSIDAccountMetadataSourceBroker);
+    XCTAssertNil(error);
+    
+    // Unknown leaves the source alone, another source makes it mixed.
+    XCTAssertTrue([self.accountMetadataCache updateSignInStateForHomeAccountId:@"uid.utid" clientId:@"my-client-id" state:MSIDAccountMetadataStateSignedIn context:nil error:&error]);
+    XCTAssertEqual([self.accountMetadataCache sourceForHomeAccountId:@"uid.utid" clientId:@"my-client-id" context:nil error:&error], MSIDAccountMetadataSourceBroker);
+    
+    XCTAssertTrue([self.accountMetadataCache updateSignInStateForHomeAccountId:@"uid.utid" clientId:@"my-client-id" state:MSIDAccountMetadataStateSignedIn source:MSIDAccountMetadataSourceLocal context:nil error:&error]);
+    XCTAssertEqual([self.accountMetadataCache sourceForHomeAccountId:@"uid.utid" clientId:@"my-client-id" context:nil error:&error], MSIDAccountMetadataSourceMixed);
+    
+    XCTAssertTrue([self.accountMetadataCache updateSignInStateForHomeAccountId:@"uid.utid" clientId:@"my-client-id" state:MSIDAccountMetadataStateSignedOut context:nil error:&error]);
+    XCTAssertEqual([self.accountMetadataCache sourceForHomeAccountId:@"uid.utid" clientId:@"my-client-id" context:nil error:&error], MSIDAccountMetadataSourceUnknown);
+    XCTAssertNil(error);
+}
+
+- (void)testSourceForHomeAccountId_whenHomeAccountIdNil_shouldReturnErrorAndUnknown {
+    NSError *error;
+    MSIDAccountMetadataSource source = [self.accountMetadataCache sourceForHomeAccountId:nil clientId:@"my-client-id" context:nil error:&error];
+    
+    XCTAssertNotNil(error);
+    XCTAssertEqual(source, MSIDAccountMetadataSourceUnknown);
+}
+
 - (void)testGetAuthorityURL_whenAuthorityMappingRecordExists_shouldReturnAuthorityMapping {
     //Save account metadata
     NSError *error;
@@ -619,4 +672,97 @@
     XCTAssertNotNil([cacheItem2 accountMetadataForHomeAccountId:@"uid2.utid2"]);
 }
 
+#pragma mark - Batch sign-in state
+
+- (void)testSignInStatesForHomeAccountIds_whenClientIdNil_shouldReturnError
+{
+    NSError *error;
+    NSDictionary *states = [self.accountMetadataCache signInStatesForHomeAccountIds:[NSSet setWithObject:@"uid.utid"] clientId:nil context:nil error:&error];
+    
+    XCTAssertNil(states);
+    XCTAssertEqual(error.code, MSIDErrorInvalidInternalParameter);
+}
+
+- (void)testSignInStatesForHomeAccountIds_shouldReturnStatesOfKnownAccountsOnly
+{
+    XCTAssertTrue([self.accountMetadataCache updateSignInStateForHomeAccountId:@"uid1.utid" clientId:@"client" state:MSIDAccountMetadataStateSignedIn context:nil error:nil]);
+    XCTAssertTrue([self.accountMetadataCache updateSignInStateForHomeAccountId:@"uid2.utid" clientId:@"client" state:MSIDAccountMetadataStateSignedOut context:nil error:nil]);
+    XCTAssertTrue([self.accountMetadataCache updateSignInStateForHomeAccountId:@"uid3.utid" clientId:@"other_client" state:MSIDAccountMetadataStateSignedIn context:nil error:nil]);
+    
+    NSError *error;
+    NSSet *homeAccountIds = [NSSet setWithObjects:@"uid1.utid", @"uid2.utid", @"uid3.utid", nil];
+    NSDictionary *states = [self.accountMetadataCache signInStatesForHomeAccountIds:homeAccountIds clientId:@"client" context:nil error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(states, (@{@"uid1.utid": @(MSIDAccountMetadataStateSignedIn),
+                                     @"uid2.utid": @(MSIDAccountMetadataStateSignedOut)}));
+}
+
+- (void)testSignInStatesForHomeAccountIds_whenMultipleCaches_shouldReadStateFromDisc
+{
+    NSSet *homeAccountIds = [NSSet setWithObject:@"id1"];
+    [self.accountMetadataCache updateSignInStateForHomeAccountId:@"id1" clientId:@"clientId1" state:MSIDAccountMetadataStateSignedIn context:nil error:nil];
+    NSDictionary *states = [self.secondAccountMetadataCache signInStatesForHomeAccountIds:homeAccountIds clientId:@"clientId1" context:nil error:nil];
+    XCTAssertEqualObjects(states[@"id1"], @(MSIDAccountMetadataStateSignedIn));
+    
+    [self.accountMetadataCache updateSignInStateForHomeAccountId:@"id1" clientId:@"clientId1" state:MSIDAccountMetadataStateSignedOut context:nil error:nil];
+    states = [self.secondAccountMetadataCache signInStatesForHomeAccountIds:homeAccountIds clientId:@"clientId1" context:nil error:nil];
+    
+    XCTAssertEqualObjects(states[@"id1"], @(MSIDAccountMetadataStateSignedOut));
+}
+
+- (void)testSignInStatesForHomeAccountIds_whenModificationDateUnchanged_shouldNotReadItemAgain
+{
+    MSIDModificationDateTestCacheDataSource *dataSource = [MSIDModificationDateTestCacheDataSource new];
+    MSIDAccountMetadataCacheAccessor *accessor = [[MSIDAccountMetadataCacheAccessor alloc] initWithDataSource:dataSource];
+    XCTAssertTrue([accessor updateSignInStateForHomeAccountId:@"id1" clientId:@"client" state:MSIDAccountMetadataStateSignedIn context:nil error:nil]);
+    dataSource.modificationDate = [NSDate dateWithTimeIntervalSinceNow:-60];
+    dataSource.accountMetadataReadCount = 0;
+    
+    NSSet *homeAccountIds = [NSSet setWithObject:@"id1"];
+    for (NSUInteger i = 0; i < 5; i++)
+    {
+        NSDictionary *states = [accessor signInStatesForHomeAccountIds:homeAccountIds clientId:@"client" context:nil error:nil];
+        XCTAssertEqualObjects(states[@"id1"], @(MSIDAccountMetadataStateSignedIn));
+    }
+    
+    XCTAssertEqual(dataSource.accountMetadataReadCount, 1u);
+    
+    // Another process signs the account out.
+    MSIDAccountMetadataCacheAccessor *otherProcessAccessor = [[MSIDAccountMetadataCacheAccessor alloc] initWithDataSource:dataSource];
+    XCTAssertTrue([otherProcessAccessor updateSignInStateForHomeAccountId:@"id1" clientId:@"client" state:MSIDAccountMetadataStateSignedOut context:nil error:nil]);
+    dataSource.modificationDate = [NSDate dateWithTimeIntervalSinceNow:-30];
+    dataSource.accountMetadataReadCount = 0;
+    
+    NSDictionary *states = [accessor signInStatesForHomeAccountIds:homeAccountIds clientId:@"client" context:nil error:nil];
+    
+    XCTAssertEqualObjects(states[@"id1"], @(MSIDAccountMetadataStateSignedOut));
+    XCTAssertEqual(dataSource.accountMetadataReadCount, 1u);
+}
+
+- (void)testSignInStatesForHomeAccountIds_whenModificationDateTooRecent_shouldReadItemEveryTime
+{
+    MSIDModificationDateTestCacheDataSource *dataSource = [MSIDModificationDateTestCacheDataSource new];
+    MSIDAccountMetadataCacheAccessor *accessor = [[MSIDAccountMetadataCacheAccessor alloc] initWithDataSource:dataSource];
+    XCTAssertTrue([accessor updateSignInStateForHomeAccountId:@"id1" clientId:@"client" state:MSIDAccountMetadataStateSignedIn context:nil error:nil]);
+    dataSource.modificationDate = [NSDate date];
+    dataSource.accountMetadataReadCount = 0;
+    
+    [accessor signInStatesForHomeAccountIds:[NSSet setWithObject:@"id1"] clientId:@"client" context:nil error:nil];
+    [accessor signInStatesForHomeAccountIds:[NSSet setWithObject:@"id1"] clientId:@"client" context:nil error:nil];
+    
+    XCTAssertEqual(dataSource.accountMetadataReadCount, 2u);
+}
+
+- (void)testSignInStatesForHomeAccountIds_whenNothingPersisted_shouldNotReadItem
+{
+    MSIDModificationDateTestCacheDataSource *dataSource = [MSIDModificationDateTestCacheDataSource new];
+    MSIDAccountMetadataCacheAccessor *accessor = [[MSIDAccountMetadataCacheAccessor alloc] initWithDataSource:dataSource];
+    
+    NSDictionary *states = [accessor signInStatesForHomeAccountIds:[NSSet setWithObject:@"id1"] clientId:@"client" context:nil error:nil];
+    
+    XCTAssertEqual(states.count, 0u);
+    XCTAssertEqual(dataSource.accountMetadataReadCount, 0u);
+}
+
 @end
@@ -347,4 +347,57 @@
     XCTAssertEqual(accountMetadata.signInState, MSIDAccountMetadataStateUnknown);
 }
 
+#pragma mark - Source
+
+- (void)testUpdateSource_whenUnknown_shouldRecordFirstSource
+{
+    MSIDAccountMetadata *accountMetadata = [[MSIDAccountMetadata alloc] initWithHomeAccountId:@"homeAccountId" clientId:@"clientId"];
+    XCTAssertEqual(accountMetadata.source, MSIDAccountMetadataSourceUnknown);
+    
+    [accountMetadata updateSource:MSIDAccountMetadataSourceBroker];
+    XCTAssertEqual(accountMetadata.source, MSIDAccountMetadataSourceBroker);
+    
+    [accountMetadata updateSource:MSIDAccountMetadataSourceBroker];
+    [accountMetadata updateSource:MSIDAccountMetadataSourceUnknown];
+    XCTAssertEqual(accountMetadata.source, MSIDAccountMetadataSourceBroker);
+}
+
+- (void)testUpdateSource_whenDifferentSource_shouldBecomeMixed
+{
+    MSIDAccountMetadata *accountMetadata = [[MSIDAccountMetadata alloc] initWithHomeAccountId:@"homeAccountId" clientId:@"clientId"];
+    
+    [accountMetadata updateSource:MSIDAccountMetadataSourceLocal];
+    [accountMetadata updateSource:MSIDAccountMetadataSourceBroker];
+    XCTAssertEqual(accountMetadata.source, MSIDAccountMetadataSourceMixed);
+    
+    [accountMetadata updateSource:MSIDAccountMetadataSourceLocal];
+    XCTAssertEqual(accountMetadata.source, MSIDAccountMetadataSourceMixed);
+}
+
+- (void)testUpdateSignInState_whenSetSignedOut_shouldForgetSource
+{
+    MSIDAccountMetadata *accountMetadata = [[MSIDAccountMetadata alloc] initWithHomeAccountId:@"homeAccountId" clientId:@"clientId"];
+    [accountMetadata updateSource:MSIDAccountMetadataSourceLocal];
+    
+    [accountMetadata updateSignInState:MSIDAccountMetadataStateSignedOut];
+    
+    XCTAssertEqual(accountMetadata.source, MSIDAccountMetadataSourceUnknown);
+}
+
+- (void)testJSONDictionary_whenSourceSet_shouldRoundTripSource
+{
+    MSIDAccountMetadata *accountMetadata = [[MSIDAccountMetadata alloc] initWithHomeAccountId:@"homeAccountId" clientId:@"clientId"];
+    [accountMetadata updateSource:MSIDAccountMetadataSourceBroker];
+    
+    NSDictionary *json = accountMetadata.jsonDictionary;
+    XCTAssertEqualObjects(json[@"account_source"], @"broker");
+    
+    NSError *error;
+    MSIDAccountMetadata *decoded = [[MSIDAccountMetadata alloc] initWithJSONDictionary:json error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqual(decoded.source, MSIDAccountMetadataSourceBroker);
+    XCTAssertEqualObjects(decoded, accountMetadata);
+    XCTAssertEqual([accountMetadata copy].source, MSIDAccountMetadataSourceBroker);
+}
+
 @end
@@ -0,0 +1,516 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDCacheCompactor.h"
+#import "MSIDCacheCompactionResult.h"
+#import "MSIDAccountCredentialCache.h"
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDCredentialCacheItem.h"
+#import "MSIDAccountCacheItem.h"
+#import "MSIDAppMetadataCacheItem.h"
+#import "MSIDAppMetadataCacheQuery.h"
+#import "MSIDDefaultCredentialCacheQuery.h"
+#import "MSIDTelemetry.h"
+#import "MSIDTelemetryEventStrings.h"
+#import "MSIDTelemetryTestDispatcher.h"
+#import "MSIDBenchmarkTestCase.h"
+
+@interface MSIDScanHookCacheDataSource : MSIDTestCacheDataSource
+
+// Called once, after the first read of all credentials.
+@property (nonatomic, copy) void (^afterFullScanBlock)(void);
+
+@end
+
+@implementation MSIDScanHookCacheDataSource
+
+- (NSArray<MSIDCredentialCacheItem *> *)tokensWithKey:(MSIDCacheKey *)key
+                                           serializer:(id<MSIDExtendedCacheItemSerializing>)serializer
+                                              context:(id<MSIDRequestContext>)context
+                                                error:(NSError *__autoreleasing*)error
+{
+    NSArray *result = [super tokensWithKey:key serializer:serializer context:context error:error];
+    
+    if ([key isKindOfClass:[MSIDDefaultCredentialCacheQuery class]] && ((MSIDDefaultCredentialCacheQuery *)key).matchAnyCredentialType && self.afterFullScanBlock)
+    {
+        void (^block)(void) = self.afterFullScanBlock;
+        self.afterFullScanBlock = nil;
+        block();
+    }
+    
+    return result;
+}
+
+@end
+
+@interface MSIDCacheCompactorTests : XCTestCase
+
+@property (nonatomic) MSIDScanHookCacheDataSource *dataSource;
+@property (nonatomic) MSIDAccountCredentialCache *cache;
+@property (nonatomic) MSIDCacheCompactor *compactor;
+
+@end
+
+@implementation MSIDCacheCompactorTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    self.dataSource = [MSIDScanHookCacheDataSource new];
+    self.cache = [[MSIDAccountCredentialCache alloc] initWithDataSource:self.dataSource];
+    self.compactor = [[MSIDCacheCompactor alloc] initWithAccountCredentialCache:self.cache];
+    self.compactor.batchSize = 500;
+    self.compactor.batchDelay = 0;
+}
+
+- (void)tearDown
+{
+    [self.compactor stop];
+    [[MSIDTelemetry sharedInstance] removeAllDispatchers];
+    [super tearDown];
+}
+
+#pragma mark - Sweep
+
+- (void)testSweep_whenSeededWith10kMixedItems_shouldRemoveOnlyExpiredAccessTokens
+{
+    [self seedAccounts:100 credentialsPerAccount:100 orphanedAccounts:25];
+    XCTAssertEqual([self allCredentials].count, 10050u);
+    
+    MSIDCacheCompactionResult *result = [self sweep];
+    
+    XCTAssertEqual(result.scannedItemCount, 10050u);
+    XCTAssertEqual(result.expiredAccessTokenCount, 2500u);
+    XCTAssertEqual(result.orphanedCredentialCount, 0u);
+    XCTAssertEqual(result.orphanedAppMetadataCount, 0u);
+    XCTAssertEqual(result.skippedItemCount, 0u);
+    XCTAssertEqual(result.reclaimedItemCount, 2500u);
+    
+    NSArray<MSIDCredentialCacheItem *> *remaining = [self allCredentials];
+    XCTAssertEqual(remaining.count, 7550u);
+    
+    for (MSIDCredentialCacheItem *credential in remaining)
+    {
+        XCTAssertFalse([credential.target hasPrefix:@"expired"]);
+    }
+    
+    // Extended lifetime tokens are kept until extendedExpiresOn.
+    XCTAssertEqual([self credentialsWithTargetPrefix:@"extended" in:remaining], 2500u);
+    XCTAssertEqual([self.dataSource allDefaultRefreshTokens].count, 125u);
+    XCTAssertEqual([self allAppMetadata].count, 2u);
+}
+
+- (void)testSweep_whenRemoveOrphanedItemsEnabled_shouldRemoveOrphanedTokensAndAppMetadata
+{
+    [self seedAccounts:100 credentialsPerAccount:100 orphanedAccounts:25];
+    self.compactor.removeOrphanedItems = YES;
+    
+    MSIDCacheCompactionResult *result = [self sweep];
+    
+    XCTAssertEqual(result.expiredAccessTokenCount, 2500u);
+    // The ID token of every orphaned account.
+    XCTAssertEqual(result.orphanedCredentialCount, 25u);
+    XCTAssertEqual(result.orphanedAppMetadataCount, 1u);
+    XCTAssertEqual(result.reclaimedItemCount, 2526u);
+    
+    NSArray<MSIDCredentialCacheItem *> *remaining = [self allCredentials];
+    XCTAssertEqual(remaining.count, 10050u - 2525u);
+    
+    // Refresh tokens are never removed, even without an account.
+    XCTAssertEqual([self.dataSource allDefaultRefreshTokens].count, 125u);
+    
+    NSArray<MSIDAppMetadataCacheItem *> *appMetadata = [self allAppMetadata];
+    XCTAssertEqual(appMetadata.count, 1u);
+    XCTAssertEqualObjects(appMetadata.firstObject.clientId, @"client");
+}
+
+- (void)testSweep_whenAccessTokenRenewedAfterScan_shouldKeepIt
+{
+    MSIDCredentialCacheItem *expired = [self accessTokenWithHomeAccountId:@"uid.utid" target:@"expired" expiresIn:-3600 extendedExpiresIn:0];
+    [self.cache saveCredential:expired context:nil error:nil];
+    [self.cache saveCredential:[self accessTokenWithHomeAccountId:@"uid.utid" target:@"expired2" expiresIn:-3600 extendedExpiresIn:0] context:nil error:nil];
+    
+    __weak typeof(self) weakSelf = self;
+    self.dataSource.afterFullScanBlock = ^{
+        MSIDCredentialCacheItem *renewed = [expired copy];
+        renewed.secret = @"renewed";
+        renewed.expiresOn = [NSDate dateWithTimeIntervalSinceNow:3600];
+        [weakSelf.cache saveCredential:renewed context:nil error:nil];
+    };
+    
+    MSIDCacheCompactionResult *result = [self sweep];
+    
+    XCTAssertEqual(result.expiredAccessTokenCount, 1u);
+    XCTAssertEqual(result.skippedItemCount, 1u);
+    
+    NSArray<MSIDCredentialCacheItem *> *remaining = [self allCredentials];
+    XCTAssertEqual(remaining.count, 1u);
+    XCTAssertEqualObjects(remaining.firstObject.secret, @"renewed");
+}
+
+- (void)testSweep_whenAccountAddedBackAfterScan_shouldKeepItsTokens
+{
+    [self.cache saveCredential:[self idTokenWithHomeAccountId:@"uid.utid"] context:nil error:nil];
+    self.compactor.removeOrphanedItems = YES;
+    
+    __weak typeof(self) weakSelf = self;
+    self.dataSource.afterFullScanBlock = ^{
+        [weakSelf.cache saveAccount:[weakSelf accountWithHomeAccountId:@"uid.utid"] context:nil error:nil];
+    };
+    
+    MSIDCacheCompactionResult *result = [self sweep];
+    
+    XCTAssertEqual(result.orphanedCredentialCount, 0u);
+    XCTAssertEqual(result.skippedItemCount, 1u);
+    XCTAssertEqual([self allCredentials].count, 1u);
+}
+
+- (void)testSweep_whenSmallBatchSize_shouldPauseBetweenBatches
+{
+    for (NSUInteger i = 0; i < 10; i++)
+    {
+        NSString *target = [NSString stringWithFormat:@"expired%lu", (unsigned long)i];
+        [self.cache saveCredential:[self accessTokenWithHomeAccountId:@"uid.utid" target:target expiresIn:-3600 extendedExpiresIn:0] context:nil error:nil];
+    }
+    
+    self.compactor.batchSize = 3;
+    self.compactor.batchDelay = 0.1;
+    
+    NSDate *start = [NSDate date];
+    MSIDCacheCompactionResult *result = [self sweep];
+    
+    // 4 batches, 3 pauses.
+    XCTAssertGreaterThanOrEqual(-[start timeIntervalSinceNow], 0.3);
+    XCTAssertEqual(result.expiredAccessTokenCount, 10u);
+    XCTAssertEqual([self allCredentials].count, 0u);
+}
+
+- (void)testSweep_whenStoppedAfterScan_shouldNotRemoveAnything
+{
+    [self.cache saveCredential:[self accessTokenWithHomeAccountId:@"uid.utid" target:@"expired" expiresIn:-3600 extendedExpiresIn:0] context:nil error:nil];
+    
+    __weak typeof(self) weakSelf = self;
+    self.dataSource.afterFullScanBlock = ^{
+        [weakSelf.compactor stop];
+    };
+    
+    MSIDCacheCompactionResult *result = [self sweep];
+    
+    XCTAssertEqual(result.scannedItemCount, 1u);
+    XCTAssertEqual(result.reclaimedItemCount, 0u);
+    XCTAssertEqual([self allCredentials].count, 1u);
+}
+
+- (void)testSweep_whenSweepAlreadyRunning_shouldShareItsResult
+{
+    for (NSUInteger i = 0; i < 3; i++)
+    {
+        NSString *target = [NSString stringWithFormat:@"expired%lu", (unsigned long)i];
+        [self.cache saveCredential:[self accessTokenWithHomeAccountId:@"uid.utid" target:target expiresIn:-3600 extendedExpiresIn:0] context:nil error:nil];
+    }
+    
+    self.compactor.batchSize = 1;
+    self.compactor.batchDelay = 0.1;
+    
+    XCTestExpectation *firstExpectation = [self expectationWithDescription:@"First sweep"];
+    XCTestExpectation *secondExpectation = [self expectationWithDescription:@"Second sweep"];
+    __block MSIDCacheCompactionResult *firstResult = nil;
+    __block MSIDCacheCompactionResult *secondResult = nil;
+    
+    [self.compactor sweepWithCompletion:^(MSIDCacheCompactionResult *result, __unused NSError *error) {
+        firstResult = result;
+        [firstExpectation fulfill];
+    }];
+    
+    [self.compactor sweepWithCompletion:^(MSIDCacheCompactionResult *result, __unused NSError *error) {
+        secondResult = result;
+        [secondExpectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    XCTAssertNotNil(firstResult);
+    XCTAssertEqual(firstResult, secondResult);
+    XCTAssertEqual(firstResult.expiredAccessTokenCount, 3u);
+}
+
+#pragma mark - Schedule
+
+- (void)testStart_shouldSweepOnScheduleAndReportTelemetry
+{
+    [self seedAccounts:2 credentialsPerAccount:10 orphanedAccounts:0];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Compaction telemetry"];
+    __block NSDictionary *properties = nil;
+    
+    MSIDTelemetryTestDispatcher *dispatcher = [MSIDTelemetryTestDispatcher new];
+    [dispatcher setTestCallback:^(id<MSIDTelemetryEventInterface> event)
+     {
+         if ([event.propertyMap[MSID_TELEMETRY_KEY_EVENT_NAME] isEqualToString:MSID_TELEMETRY_EVENT_CACHE_COMPACTION])
+         {
+             properties = event.propertyMap;
+             [expectation fulfill];
+         }
+     }];
+    [[MSIDTelemetry sharedInstance] addDispatcher:dispatcher];
+    
+    self.compactor.initialDelay = 0;
+    self.compactor.sweepInterval = 0;
+    [self.compactor start];
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    XCTAssertEqualObjects(properties[MSID_TELEMETRY_KEY_COMPACTION_SCANNED_COUNT], @"20");
+    XCTAssertEqualObjects(properties[MSID_TELEMETRY_KEY_COMPACTION_EXPIRED_AT_COUNT], @"4");
+    XCTAssertEqualObjects(properties[MSID_TELEMETRY_KEY_COMPACTION_ORPHANED_CREDENTIAL_COUNT], @"0");
+    XCTAssertEqualObjects(properties[MSID_TELEMETRY_KEY_COMPACTION_ORPHANED_APP_METADATA_COUNT], @"0");
+    XCTAssertEqual([self allCredentials].count, 16u);
+}
+
+- (void)testStart_whenSweptRecently_shouldWaitForSweepInterval
+{
+    [self.cache saveCredential:[self accessTokenWithHomeAccountId:@"uid.utid" target:@"expired" expiresIn:-3600 extendedExpiresIn:0] context:nil error:nil];
+    [self sweep];
+    
+    [self.cache saveCredential:[self accessTokenWithHomeAccountId:@"uid.utid" target:@"expired2" expiresIn:-3600 extendedExpiresIn:0] context:nil error:nil];
+    
+    self.compactor.initialDelay = 0;
+    self.compactor.sweepInterval = 60;
+    [self.compactor start];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Wait"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.3 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    XCTAssertTrue(self.compactor.isScheduled);
+    XCTAssertEqual([self allCredentials].count, 1u);
+    
+    [self.compactor stop];
+    XCTAssertFalse(self.compactor.isScheduled);
+}
+
+#pragma mark - Helpers
+
+- (MSIDCacheCompactionResult *)sweep
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Sweep"];
+    __block MSIDCacheCompactionResult *sweepResult = nil;
+    
+    [self.compactor sweepWithCompletion:^(MSIDCacheCompactionResult *result, NSError *error) {
+        XCTAssertNil(error);
+        sweepResult = result;
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:30 handler:nil];
+    return sweepResult;
+}
+
+/*
+ Per account: an account, an ID token, a refresh token and credentialsPerAccount - 2 access tokens, a quarter of them
+ expired, a quarter expired with a valid extended lifetime. Orphaned accounts get an ID token and a refresh token but no
+ account. App metadata is saved for "client" and for "stale_client", which has no credentials.
+ */
+- (void)seedAccounts:(NSUInteger)accountCount credentialsPerAccount:(NSUInteger)credentialsPerAccount orphanedAccounts:(NSUInteger)orphanedCount
+{
+    for (NSUInteger i = 0; i < accountCount; i++)
+    {
+        NSString *homeAccountId = [NSString stringWithFormat:@"uid%lu.utid", (unsigned long)i];
+        
+        [self.cache saveAccount:[self accountWithHomeAccountId:homeAccountId] context:nil error:nil];
+        [self.cache saveCredential:[self idTokenWithHomeAccountId:homeAccountId] context:nil error:nil];
+        [self.cache saveCredential:[self refreshTokenWithHomeAccountId:homeAccountId] context:nil error:nil];
+        
+        for (NSUInteger j = 0; j < credentialsPerAccount - 2; j++)
+        {
+            MSIDCredentialCacheItem *accessToken = nil;
+            
+            switch (j % 4)
+            {
+                case 0:
+                    accessToken = [self accessTokenWithHomeAccountId:homeAccountId target:[NSString stringWithFormat:@"expired%lu", (unsigned long)j] expiresIn:-3600 extendedExpiresIn:-60];
+                    break;
+                case 1:
+                    accessToken = [self accessTokenWithHomeAccountId:homeAccountId target:[NSString stringWithFormat:@"extended%lu", (unsigned long)j] expiresIn:-3600 extendedExpiresIn:3600];
+                    break;
+                default:
+                    accessToken = [self accessTokenWithHomeAccountId:homeAccountId target:[NSString stringWithFormat:@"valid%lu", (unsigned long)j] expiresIn:3600 extendedExpiresIn:0];
+                    break;
+            }
+            
+            [self.cache saveCredential:accessToken context:nil error:nil];
+        }
+    }
+    
+    for (NSUInteger i = 0; i < orphanedCount; i++)
+    {
+        NSString *homeAccountId = [NSString stringWithFormat:@"orphan%lu.utid", (unsigned long)i];
+        [self.cache saveCredential:[self idTokenWithHomeAccountId:homeAccountId] context:nil error:nil];
+        [self.cache saveCredential:[self refreshTokenWithHomeAccountId:homeAccountId] context:nil error:nil];
+    }
+    
+    for (NSString *clientId in @[@"client", @"stale_client"])
+    {
+        MSIDAppMetadataCacheItem *appMetadata = [MSIDAppMetadataCacheItem new];
+        appMetadata.clientId = clientId;
+        appMetadata.environment = @"login.microsoftonline.com";
+        [self.cache saveAppMetadata:appMetadata context:nil error:nil];
+    }
+}
+
+- (MSIDAccountCacheItem *)accountWithHomeAccountId:(NSString *)homeAccountId
+{
+    MSIDAccountCacheItem *account = [MSIDAccountCacheItem new];
+    account.accountType = MSIDAccountTypeMSSTS;
+    account.homeAccountId = homeAccountId;
+    account.environment = @"login.microsoftonline.com";
+    account.realm = @"utid";
+    account.username = [NSString stringWithFormat:@"%@@contoso.com", homeAccountId];
+    return account;
+}
+
+- (MSIDCredentialCacheItem *)credentialWithType:(MSIDCredentialType)type homeAccountId:(NSString *)homeAccountId
+{
+    MSIDCredentialCacheItem *credential = [MSIDCredentialCacheItem new];
+    credential.credentialType = type;
+    credential.homeAccountId = homeAccountId;
+    credential.environment = @"login.microsoftonline.com";
+    credential.clientId = @"client";
+    credential.secret = @"secret";
+    return credential;
+}
+
+- (MSIDCredentialCacheItem *)idTokenWithHomeAccountId:(NSString *)homeAccountId
+{
+    MSIDCredentialCacheItem *idToken = [self credentialWithType:MSIDIDTokenType homeAccountId:homeAccountId];
+    idToken.realm = @"utid";
+    return idToken;
+}
+
+- (MSIDCredentialCacheItem *)refreshTokenWithHomeAccountId:(NSString *)homeAccountId
+{
+    return [self credentialWithType:MSIDRefreshTokenType homeAccountId:homeAccountId];
+}
+
+- (MSIDCredentialCacheItem *)accessTokenWithHomeAccountId:(NSString *)homeAccountId
+                                                   target:(NSString *)target
+                                                expiresIn:(NSTimeInterval)expiresIn
+                                        extendedExpiresIn:(NSTimeInterval)extendedExpiresIn
+{
+    MSIDCredentialCacheItem *accessToken = [self credentialWithType:MSIDAccessTokenType homeAccountId:homeAccountId];
+    accessToken.realm = @"utid";
+    accessToken.target = target;
+    accessToken.expiresOn = [NSDate dateWithTimeIntervalSinceNow:expiresIn];
+    accessToken.extendedExpiresOn = extendedExpiresIn ? [NSDate dateWithTimeIntervalSinceNow:extendedExpiresIn] : nil;
+    return accessToken;
+}
+
+- (NSArray<MSIDCredentialCacheItem *> *)allCredentials
+{
+    return [self.cache getAllItemsWithContext:nil error:nil];
+}
+
+- (NSArray<MSIDAppMetadataCacheItem *> *)allAppMetadata
+{
+    return [self.cache getAppMetadataEntriesWithQuery:[MSIDAppMetadataCacheQuery new] context:nil error:nil];
+}
+
+- (NSUInteger)credentialsWithTargetPrefix:(NSString *)prefix in:(NSArray<MSIDCredentialCacheItem *> *)credentials
+{
+    NSUInteger count = 0;
+    
+    for (MSIDCredentialCacheItem *credential in credentials)
+    {
+        if ([credential.target hasPrefix:prefix]) count++;
+    }
+    
+    return count;
+}
+
+@end
+
+@interface MSIDCacheCompactorBenchmarks : MSIDBenchmarkTestCase
+
+@end
+
+@implementation MSIDCacheCompactorBenchmarks
+
+#pragma mark - Benchmarks
+
+- (void)testSweep_10kItemsWithNothingToReclaim_benchmark
+{
+    MSIDAccountCredentialCache *cache = [[MSIDAccountCredentialCache alloc] initWithDataSource:[MSIDTestCacheDataSource new]];
+    MSIDCacheCompactor *compactor = [[MSIDCacheCompactor alloc] initWithAccountCredentialCache:cache];
+    compactor.batchSize = 500;
+    compactor.batchDelay = 0;
+    
+    // 100 accounts with an ID token, a refresh token and 98 valid access tokens each, none of which can be reclaimed.
+    for (NSUInteger i = 0; i < 100; i++)
+    {
+        NSString *homeAccountId = [NSString stringWithFormat:@"uid%lu.utid", (unsigned long)i];
+        
+        MSIDAccountCacheItem *account = [MSIDAccountCacheItem new];
+        account.accountType = MSIDAccountTypeMSSTS;
+        account.homeAccountId = homeAccountId;
+        account.environment = @"login.microsoftonline.com";
+        account.realm = @"utid";
+        account.username = [NSString stringWithFormat:@"%@@contoso.com", homeAccountId];
+        [cache saveAccount:account context:nil error:nil];
+        
+        for (NSUInteger j = 0; j < 100; j++)
+        {
+            MSIDCredentialCacheItem *credential = [MSIDCredentialCacheItem new];
+            credential.credentialType = j == 0 ? MSIDIDTokenType : (j == 1 ? MSIDRefreshTokenType : MSIDAccessTokenType);
+            credential.homeAccountId = homeAccountId;
+            credential.environment = @"login.microsoftonline.com";
+            credential.realm = j == 1 ? nil : @"utid";
+            credential.clientId = @"client";
+            credential.secret = @"secret";
+            
+            if (credential.credentialType == MSIDAccessTokenType)
+            {
+                credential.target = [NSString stringWithFormat:@"valid%lu", (unsigned long)j];
+                credential.expiresOn = [NSDate dateWithTimeIntervalSinceNow:3600];
+            }
+            
+            [cache saveCredential:credential context:nil error:nil];
+        }
+    }
+    
+    [self benchmark:@"cache_compactor_sweep_10k_items" asyncBlock:^(dispatch_block_t done) {
+        [compactor sweepWithCompletion:^(MSIDCacheCompactionResult *result, NSError *error) {
+            XCTAssertNil(error);
+            XCTAssertEqual(result.reclaimedItemCount, 0u);
+            done();
+        }];
+    }];
+    
+    [compactor stop];
+}
+
+@end
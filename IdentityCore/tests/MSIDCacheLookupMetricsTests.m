@@ -0,0 +1,514 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDCacheLookupMetrics.h"
+#import "MSIDCacheLookupHistogram.h"
+#import "MSIDAccountCredentialCache.h"
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDCredentialCacheItem.h"
+#import "MSIDDefaultCredentialCacheKey.h"
+#import "MSIDDefaultCredentialCacheQuery.h"
+#import "MSIDCacheItemJsonSerializer.h"
+#import "MSIDTelemetry.h"
+#import "MSIDTelemetry+Cache.h"
+#import "MSIDTelemetryCacheEvent.h"
+#import "MSIDTelemetryEventStrings.h"
+#import "MSIDTestContext.h"
+#import "MSIDFlightManager.h"
+#import "MSIDFlightManagerMockProvider.h"
+#import "MSIDConstants.h"
+#import "MSIDExecutionFlowLogger.h"
+#import "MSIDExecutionFlowConstants.h"
+#import "MSIDDefaultTokenCacheAccessor.h"
+#import "MSIDTestConfiguration.h"
+#import "MSIDBenchmarkTestCase.h"
+
+@interface MSIDCorruptingCacheItemSerializer : MSIDCacheItemJsonSerializer
+
+@end
+
+@implementation MSIDCorruptingCacheItemSerializer
+
+- (NSData *)serializeCredentialCacheItem:(__unused MSIDCredentialCacheItem *)item
+{
+    return [@"{not json" dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+@end
+
+@interface MSIDCacheLookupMetricsTests : XCTestCase
+
+@property (nonatomic) MSIDTestCacheDataSource *dataSource;
+@property (nonatomic) MSIDAccountCredentialCache *cache;
+@property (nonatomic) MSIDFlightManagerMockProvider *flightProvider;
+
+@end
+
+@implementation MSIDCacheLookupMetricsTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    self.dataSource = [MSIDTestCacheDataSource new];
+    self.cache = [[MSIDAccountCredentialCache alloc] initWithDataSource:self.dataSource];
+    self.flightProvider = [MSIDFlightManagerMockProvider new];
+    MSIDFlightManager.sharedInstance.flightProvider = self.flightProvider;
+    [[MSIDCacheLookupHistogram sharedInstance] reset];
+}
+
+- (void)tearDown
+{
+    MSIDFlightManager.sharedInstance.flightProvider = nil;
+    [[MSIDCacheLookupHistogram sharedInstance] reset];
+    [super tearDown];
+}
+
+#pragma mark - Credential cache
+
+- (void)testGetCredentials_whenRecording_shouldCountFetchedRejectedAndReturnedItems
+{
+    [self seedCredentials];
+    
+    MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics new];
+    [MSIDCacheLookupMetrics beginRecording:metrics];
+    NSArray *results = [self.cache getCredentialsWithQuery:[self userReadQuery] context:nil error:nil];
+    XCTAssertNil([MSIDCacheLookupMetrics endRecording:metrics]);
+    
+    XCTAssertEqual(results.count, 1u);
+    XCTAssertEqual(metrics.dataSourceCallCount, 1u);
+    XCTAssertEqual(metrics.itemsFetched, 6u);
+    XCTAssertEqual(metrics.deserializationFailures, 1u);
+    XCTAssertEqual(metrics.itemsRejected, 4u);
+    XCTAssertEqual(metrics.itemsReturned, 1u);
+    XCTAssertEqual([metrics rejectionCountForReason:MSIDCacheLookupRejectionReasonAccount], 0u);
+    XCTAssertEqual([metrics rejectionCountForReason:MSIDCacheLookupRejectionReasonRealm], 1u);
+    XCTAssertEqual([metrics rejectionCountForReason:MSIDCacheLookupRejectionReasonTarget], 1u);
+    XCTAssertEqual([metrics rejectionCountForReason:MSIDCacheLookupRejectionReasonClaims], 1u);
+    XCTAssertEqual([metrics rejectionCountForReason:MSIDCacheLookupRejectionReasonClientId], 1u);
+    XCTAssertGreaterThanOrEqual(metrics.dataSourceTime, 0);
+    XCTAssertGreaterThanOrEqual(metrics.filterTime, 0);
+}
+
+- (void)testGetCredentials_whenQueryDoesNotMatchAccount_shouldCountAccountRejections
+{
+    [self seedCredentials];
+    
+    MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
+    query.matchAnyCredentialType = YES;
+    query.homeAccountId = @"uid.utid";
+    
+    MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics new];
+    [MSIDCacheLookupMetrics beginRecording:metrics];
+    NSArray *results = [self.cache getCredentialsWithQuery:query context:nil error:nil];
+    [MSIDCacheLookupMetrics endRecording:metrics];
+    
+    // Every readable item of uid.utid, the other account's access token is rejected on its home account id.
+    XCTAssertEqual(results.count, 5u);
+    XCTAssertEqual(metrics.itemsFetched, 7u);
+    XCTAssertEqual(metrics.deserializationFailures, 1u);
+    XCTAssertEqual([metrics rejectionCountForReason:MSIDCacheLookupRejectionReasonAccount], 1u);
+    XCTAssertEqual(metrics.itemsRejected, 1u);
+}
+
+- (void)testGetCredentials_whenNotRecording_shouldNotRecordMetrics
+{
+    [self seedCredentials];
+    
+    MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics new];
+    [MSIDCacheLookupMetrics beginRecording:metrics];
+    [MSIDCacheLookupMetrics endRecording:metrics];
+    
+    NSArray *results = [self.cache getCredentialsWithQuery:[self userReadQuery] context:nil error:nil];
+    
+    XCTAssertEqual(results.count, 1u);
+    XCTAssertNil([MSIDCacheLookupMetrics currentMetrics]);
+    XCTAssertEqual(metrics.itemsFetched, 0u);
+    XCTAssertEqual(metrics.dataSourceCallCount, 0u);
+}
+
+#pragma mark - Recording
+
+- (void)testEndRecording_whenNested_shouldAddInnerMetricsToEnclosingOne
+{
+    [self seedCredentials];
+    
+    MSIDCacheLookupMetrics *outer = [MSIDCacheLookupMetrics new];
+    MSIDCacheLookupMetrics *inner = [MSIDCacheLookupMetrics new];
+    
+    [MSIDCacheLookupMetrics beginRecording:outer];
+    [self.cache getCredentialsWithQuery:[self userReadQuery] context:nil error:nil];
+    [MSIDCacheLookupMetrics beginRecording:inner];
+    XCTAssertEqual([MSIDCacheLookupMetrics currentMetrics], inner);
+    [self.cache getCredentialsWithQuery:[self userReadQuery] context:nil error:nil];
+    
+    XCTAssertEqual([MSIDCacheLookupMetrics endRecording:inner], outer);
+    XCTAssertEqual([MSIDCacheLookupMetrics currentMetrics], outer);
+    XCTAssertNil([MSIDCacheLookupMetrics endRecording:outer]);
+    XCTAssertNil([MSIDCacheLookupMetrics currentMetrics]);
+    
+    XCTAssertEqual(inner.dataSourceCallCount, 1u);
+    XCTAssertEqual(inner.itemsFetched, 6u);
+    XCTAssertEqual(outer.dataSourceCallCount, 2u);
+    XCTAssertEqual(outer.itemsFetched, 12u);
+    XCTAssertEqual(outer.itemsRejected, 8u);
+    XCTAssertEqual([outer rejectionCountForReason:MSIDCacheLookupRejectionReasonTarget], 2u);
+}
+
+- (void)testEndRecording_whenInnerRecordingWasNeverEnded_shouldDropIt
+{
+    MSIDCacheLookupMetrics *outer = [MSIDCacheLookupMetrics new];
+    MSIDCacheLookupMetrics *abandoned = [MSIDCacheLookupMetrics new];
+    
+    [MSIDCacheLookupMetrics beginRecording:outer];
+    [MSIDCacheLookupMetrics beginRecording:abandoned];
+    
+    XCTAssertNil([MSIDCacheLookupMetrics endRecording:outer]);
+    XCTAssertNil([MSIDCacheLookupMetrics currentMetrics]);
+    XCTAssertNil([MSIDCacheLookupMetrics endRecording:abandoned]);
+}
+
+- (void)testBeginRecording_whenOutermostRecordingWasNeverEnded_shouldDropItOnceReleased
+{
+    @autoreleasepool
+    {
+        MSIDCacheLookupMetrics *abandoned = [MSIDCacheLookupMetrics new];
+        [MSIDCacheLookupMetrics beginRecording:abandoned];
+    }
+    
+    XCTAssertNil([MSIDCacheLookupMetrics currentMetrics]);
+    
+    MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics new];
+    [MSIDCacheLookupMetrics beginRecording:metrics];
+    
+    XCTAssertEqual([MSIDCacheLookupMetrics currentMetrics], metrics);
+    XCTAssertNil([MSIDCacheLookupMetrics endRecording:metrics]);
+    XCTAssertNil([MSIDCacheLookupMetrics currentMetrics]);
+}
+
+- (void)testCurrentMetrics_shouldBeLocalToRecordingThread
+{
+    MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics new];
+    [MSIDCacheLookupMetrics beginRecording:metrics];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Other thread"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+        XCTAssertNil([MSIDCacheLookupMetrics currentMetrics]);
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertEqual([MSIDCacheLookupMetrics currentMetrics], metrics);
+    [MSIDCacheLookupMetrics endRecording:metrics];
+}
+
+#pragma mark - Histogram
+
+- (void)testRecordLookupMetrics_shouldCountLookupsPerBucket
+{
+    MSIDCacheLookupHistogram *histogram = [MSIDCacheLookupHistogram new];
+    
+    [histogram recordLookupMetrics:[self metricsWithFetchedItemCount:0 corruptedItemCount:0]];
+    [histogram recordLookupMetrics:[self metricsWithFetchedItemCount:10 corruptedItemCount:0]];
+    [histogram recordLookupMetrics:[self metricsWithFetchedItemCount:11 corruptedItemCount:2]];
+    [histogram recordLookupMetrics:[self metricsWithFetchedItemCount:20000 corruptedItemCount:0]];
+    
+    XCTAssertEqual(histogram.lookupCount, 4u);
+    XCTAssertEqual(histogram.lookupsWithDeserializationFailures, 1u);
+    XCTAssertEqual(histogram.maxItemsFetched, 20000u);
+    XCTAssertEqualObjects(histogram.itemsFetchedCounts, (@[@1, @1, @1, @0, @0, @1]));
+    XCTAssertEqual(histogram.dataSourceTimeCounts.count, MSIDCacheLookupHistogram.durationBucketBounds.count + 1);
+    XCTAssertEqual([[histogram.dataSourceTimeCounts valueForKeyPath:@"@sum.self"] unsignedIntegerValue], 4u);
+    XCTAssertEqual([[histogram.filterTimeCounts valueForKeyPath:@"@sum.self"] unsignedIntegerValue], 4u);
+    
+    [histogram reset];
+    
+    XCTAssertEqual(histogram.lookupCount, 0u);
+    XCTAssertEqual(histogram.maxItemsFetched, 0u);
+    XCTAssertEqualObjects(histogram.itemsFetchedCounts, (@[@0, @0, @0, @0, @0, @0]));
+}
+
+- (void)testRecordLookupMetrics_shouldSumRejectionsPerReason
+{
+    [self seedCredentials];
+    MSIDCacheLookupHistogram *histogram = [MSIDCacheLookupHistogram new];
+    
+    for (NSUInteger i = 0; i < 3; i++)
+    {
+        MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics new];
+        [MSIDCacheLookupMetrics beginRecording:metrics];
+        [self.cache getCredentialsWithQuery:[self userReadQuery] context:nil error:nil];
+        [MSIDCacheLookupMetrics endRecording:metrics];
+        [histogram recordLookupMetrics:metrics];
+    }
+    
+    XCTAssertEqual([histogram totalRejectionsForReason:MSIDCacheLookupRejectionReasonRealm], 3u);
+    XCTAssertEqual([histogram totalRejectionsForReason:MSIDCacheLookupRejectionReasonClientId], 3u);
+    XCTAssertEqual([histogram totalRejectionsForReason:MSIDCacheLookupRejectionReasonAccount], 0u);
+}
+
+#pragma mark - Telemetry
+
+- (void)testStopCacheEvent_whenFlightEnabled_shouldReportLookupMetrics
+{
+    self.flightProvider.boolForKeyContainer = @{MSID_FLIGHT_CACHE_LOOKUP_METRICS_ENABLED: @YES};
+    [self seedCredentials];
+    
+    MSIDTestContext *context = [MSIDTestContext new];
+    context.correlationId = [NSUUID UUID];
+    MSIDExecutionFlowRegister(context.correlationId);
+    
+    MSIDTelemetryCacheEvent *event = [MSIDTelemetry startCacheEventWithName:MSID_TELEMETRY_EVENT_TOKEN_CACHE_LOOKUP context:context];
+    [self.cache getCredentialsWithQuery:[self userReadQuery] context:context error:nil];
+    [MSIDTelemetry stopCacheEvent:event withItem:nil success:YES context:context];
+    
+    XCTAssertNil(event.lookupMetrics);
+    XCTAssertNil([MSIDCacheLookupMetrics currentMetrics]);
+    XCTAssertEqualObjects(event.propertyMap[MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_FETCHED], @"6");
+    XCTAssertEqualObjects(event.propertyMap[MSID_TELEMETRY_KEY_CACHE_LOOKUP_DESERIALIZATION_FAILURES], @"1");
+    XCTAssertEqualObjects(event.propertyMap[MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_REJECTED], @"4");
+    XCTAssertEqualObjects(event.propertyMap[MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_RETURNED], @"1");
+    XCTAssertEqualObjects(event.propertyMap[MSID_TELEMETRY_KEY_CACHE_LOOKUP_REJECTION_REASONS], @"realm:1,target:1,claims:1,client_id:1");
+    XCTAssertNotNil(event.propertyMap[MSID_TELEMETRY_KEY_CACHE_LOOKUP_DATA_SOURCE_TIME]);
+    XCTAssertNotNil(event.propertyMap[MSID_TELEMETRY_KEY_CACHE_LOOKUP_FILTER_TIME]);
+    XCTAssertEqual([MSIDCacheLookupHistogram sharedInstance].lookupCount, 1u);
+    
+    XCTestExpectation *flowExpectation = [self expectationWithDescription:@"Execution flow"];
+    MSIDExecutionFlowRetrieve(context.correlationId, nil, YES, ^(NSString * _Nullable executionFlow) {
+        NSArray<NSDictionary *> *blobs = [NSJSONSerialization JSONObjectWithData:[executionFlow dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+        NSDictionary *lookupBlob = nil;
+        
+        for (NSDictionary *blob in blobs)
+        {
+            if ([blob[MSID_EXECUTION_FLOW_TAG] isEqualToString:MSIDCacheLookupTagToString(MSIDCacheLookupCompletedTag)]) lookupBlob = blob;
+        }
+        
+        XCTAssertEqualObjects(lookupBlob[MSID_EXECUTION_FLOW_CACHE_ITEMS_FETCHED], @6);
+        XCTAssertEqualObjects(lookupBlob[MSID_EXECUTION_FLOW_CACHE_ITEMS_DISCARDED], @5);
+        XCTAssertNotNil(lookupBlob[MSID_EXECUTION_FLOW_CACHE_DATA_SOURCE_TIME]);
+        [flowExpectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+}
+
+- (void)testStopCacheEvent_whenLookupEventsNest_shouldRecordOuterLookupOnceInHistogram
+{
+    self.flightProvider.boolForKeyContainer = @{MSID_FLIGHT_CACHE_LOOKUP_METRICS_ENABLED: @YES};
+    [self seedCredentials];
+    
+    MSIDTelemetryCacheEvent *outerEvent = [MSIDTelemetry startCacheEventWithName:MSID_TELEMETRY_EVENT_TOKEN_CACHE_LOOKUP context:nil];
+    MSIDTelemetryCacheEvent *innerEvent = [MSIDTelemetry startCacheEventWithName:MSID_TELEMETRY_EVENT_TOKEN_CACHE_LOOKUP context:nil];
+    [self.cache getCredentialsWithQuery:[self userReadQuery] context:nil error:nil];
+    [MSIDTelemetry stopCacheEvent:innerEvent withItem:nil success:YES context:nil];
+    [self.cache getCredentialsWithQuery:[self userReadQuery] context:nil error:nil];
+    [MSIDTelemetry stopCacheEvent:outerEvent withItem:nil success:YES context:nil];
+    
+    XCTAssertEqualObjects(innerEvent.propertyMap[MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_FETCHED], @"6");
+    XCTAssertEqualObjects(outerEvent.propertyMap[MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_FETCHED], @"12");
+    XCTAssertEqual([MSIDCacheLookupHistogram sharedInstance].lookupCount, 1u);
+    XCTAssertEqual([MSIDCacheLookupHistogram sharedInstance].maxItemsFetched, 12u);
+}
+
+- (void)testStopCacheEvent_whenEarlierLookupEventWasNeverStopped_shouldReportNextLookup
+{
+    self.flightProvider.boolForKeyContainer = @{MSID_FLIGHT_CACHE_LOOKUP_METRICS_ENABLED: @YES};
+    [self seedCredentials];
+    
+    @autoreleasepool
+    {
+        __unused MSIDTelemetryCacheEvent *abandonedEvent = [MSIDTelemetry startCacheEventWithName:MSID_TELEMETRY_EVENT_TOKEN_CACHE_LOOKUP context:nil];
+    }
+    
+    MSIDTelemetryCacheEvent *event = [MSIDTelemetry startCacheEventWithName:MSID_TELEMETRY_EVENT_TOKEN_CACHE_LOOKUP context:nil];
+    [self.cache getCredentialsWithQuery:[self userReadQuery] context:nil error:nil];
+    [MSIDTelemetry stopCacheEvent:event withItem:nil success:YES context:nil];
+    
+    XCTAssertNil([MSIDCacheLookupMetrics currentMetrics]);
+    XCTAssertEqual([MSIDCacheLookupHistogram sharedInstance].lookupCount, 1u);
+    XCTAssertEqual([MSIDCacheLookupHistogram sharedInstance].maxItemsFetched, 6u);
+}
+
+- (void)testGetPrimaryRefreshTokens_whenFlightEnabled_shouldEndLookupRecording
+{
+    self.flightProvider.boolForKeyContainer = @{MSID_FLIGHT_CACHE_LOOKUP_METRICS_ENABLED: @YES};
+    MSIDDefaultTokenCacheAccessor *accessor = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:self.dataSource otherCacheAccessors:nil];
+    
+    NSArray *tokens = [accessor getPrimaryRefreshTokensForConfiguration:[MSIDTestConfiguration v2DefaultConfiguration] context:nil error:nil];
+    
+    XCTAssertEqual(tokens.count, 0u);
+    XCTAssertNil([MSIDCacheLookupMetrics currentMetrics]);
+    XCTAssertEqual([MSIDCacheLookupHistogram sharedInstance].lookupCount, 1u);
+}
+
+- (void)testStartCacheEvent_whenFlightDisabled_shouldNotRecord
+{
+    [self seedCredentials];
+    
+    MSIDTelemetryCacheEvent *event = [MSIDTelemetry startCacheEventWithName:MSID_TELEMETRY_EVENT_TOKEN_CACHE_LOOKUP context:nil];
+    XCTAssertNil(event.lookupMetrics);
+    XCTAssertNil([MSIDCacheLookupMetrics currentMetrics]);
+    
+    [self.cache getCredentialsWithQuery:[self userReadQuery] context:nil error:nil];
+    [MSIDTelemetry stopCacheEvent:event withItem:nil success:YES context:nil];
+    
+    XCTAssertNil(event.propertyMap[MSID_TELEMETRY_KEY_CACHE_LOOKUP_ITEMS_FETCHED]);
+    XCTAssertEqual([MSIDCacheLookupHistogram sharedInstance].lookupCount, 0u);
+}
+
+- (void)testStartCacheEvent_whenNotLookupEvent_shouldNotRecord
+{
+    self.flightProvider.boolForKeyContainer = @{MSID_FLIGHT_CACHE_LOOKUP_METRICS_ENABLED: @YES};
+    
+    MSIDTelemetryCacheEvent *event = [MSIDTelemetry startCacheEventWithName:MSID_TELEMETRY_EVENT_TOKEN_CACHE_WRITE context:nil];
+    
+    XCTAssertNil(event.lookupMetrics);
+    XCTAssertNil([MSIDCacheLookupMetrics currentMetrics]);
+    [MSIDTelemetry stopCacheEvent:event withItem:nil success:YES context:nil];
+}
+
+#pragma mark - Helpers
+
+/*
+ uid.utid gets one access token matching userReadQuery, one for another realm, one for another scope, one with claims,
+ one for another client and an item that fails to deserialize. uid2.utid gets one access token.
+ */
+- (void)seedCredentials
+{
+    [self.cache saveCredential:[self accessTokenWithHomeAccountId:@"uid.utid" realm:@"utid" clientId:@"client" target:@"user.read"] context:nil error:nil];
+    [self.cache saveCredential:[self accessTokenWithHomeAccountId:@"uid.utid" realm:@"other_utid" clientId:@"client" target:@"user.read"] context:nil error:nil];
+    [self.cache saveCredential:[self accessTokenWithHomeAccountId:@"uid.utid" realm:@"utid" clientId:@"client" target:@"mail.read"] context:nil error:nil];
+    [self.cache saveCredential:[self accessTokenWithHomeAccountId:@"uid.utid" realm:@"utid" clientId:@"other_client" target:@"user.read"] context:nil error:nil];
+    
+    MSIDCredentialCacheItem *claimsToken = [self accessTokenWithHomeAccountId:@"uid.utid" realm:@"utid" clientId:@"client" target:@"user.read"];
+    claimsToken.requestedClaims = @"{\"access_token\":{\"xms_cc\":{\"values\":[\"cp1\"]}}}";
+    [self.cache saveCredential:claimsToken context:nil error:nil];
+    
+    [self.cache saveCredential:[self accessTokenWithHomeAccountId:@"uid2.utid" realm:@"utid" clientId:@"client" target:@"user.read"] context:nil error:nil];
+    
+    MSIDCredentialCacheItem *corrupted = [self accessTokenWithHomeAccountId:@"uid.utid" realm:@"utid" clientId:@"client" target:@"corrupted"];
+    MSIDDefaultCredentialCacheKey *key = [[MSIDDefaultCredentialCacheKey alloc] initWithHomeAccountId:corrupted.homeAccountId
+                                                                                          environment:corrupted.environment
+                                                                                             clientId:corrupted.clientId
+                                                                                       credentialType:corrupted.credentialType];
+    key.realm = corrupted.realm;
+    key.target = corrupted.target;
+    [self.dataSource saveToken:corrupted key:key serializer:[MSIDCorruptingCacheItemSerializer new] context:nil error:nil];
+}
+
+- (MSIDDefaultCredentialCacheQuery *)userReadQuery
+{
+    MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
+    query.homeAccountId = @"uid.utid";
+    query.environment = @"login.microsoftonline.com";
+    query.realm = @"utid";
+    query.clientId = @"client";
+    query.target = @"user.read";
+    query.matchAnyCredentialType = YES;
+    return query;
+}
+
+- (MSIDCredentialCacheItem *)accessTokenWithHomeAccountId:(NSString *)homeAccountId
+                                                    realm:(NSString *)realm
+                                                 clientId:(NSString *)clientId
+                                                   target:(NSString *)target
+{
+    MSIDCredentialCacheItem *accessToken = [MSIDCredentialCacheItem new];
+    accessToken.credentialType = MSIDAccessTokenType;
+    accessToken.homeAccountId = homeAccountId;
+    accessToken.environment = @"login.microsoftonline.com";
+    accessToken.realm = realm;
+    accessToken.clientId = clientId;
+    accessToken.target = target;
+    accessToken.secret = @"secret";
+    accessToken.expiresOn = [NSDate dateWithTimeIntervalSinceNow:3600];
+    return accessToken;
+}
+
+- (MSIDCacheLookupMetrics *)metricsWithFetchedItemCount:(NSUInteger)fetchedCount corruptedItemCount:(NSUInteger)corruptedCount
+{
+    MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics new];
+    id<MSIDExtendedCacheItemSerializing> serializer = [metrics serializerRecordingDeserializationsWithSerializer:[MSIDCacheItemJsonSerializer new]];
+    NSData *validData = [[MSIDCacheItemJsonSerializer new] serializeCredentialCacheItem:[self accessTokenWithHomeAccountId:@"uid.utid" realm:@"utid" clientId:@"client" target:@"user.read"]];
+    NSData *corruptedData = [@"{not json" dataUsingEncoding:NSUTF8StringEncoding];
+    
+    for (NSUInteger i = 0; i < fetchedCount; i++)
+    {
+        [serializer deserializeCredentialCacheItem:i < corruptedCount ? corruptedData : validData];
+    }
+    
+    [metrics recordDataSourceCallWithStartTime:[MSIDCacheLookupMetrics currentTime]];
+    [metrics recordReturnedItemCount:fetchedCount - corruptedCount];
+    return metrics;
+}
+
+@end
+
+@interface MSIDCacheLookupMetricsBenchmarks : MSIDBenchmarkTestCase
+
+@end
+
+@implementation MSIDCacheLookupMetricsBenchmarks
+
+#pragma mark - Benchmarks
+
+- (void)testGetCredentials_whenRecordingWith10kItems_benchmark
+{
+    MSIDAccountCredentialCache *cache = [[MSIDAccountCredentialCache alloc] initWithDataSource:[MSIDTestCacheDataSource new]];
+    
+    for (NSUInteger i = 0; i < 10000; i++)
+    {
+        MSIDCredentialCacheItem *accessToken = [MSIDCredentialCacheItem new];
+        accessToken.credentialType = MSIDAccessTokenType;
+        accessToken.homeAccountId = @"uid.utid";
+        accessToken.environment = @"login.microsoftonline.com";
+        accessToken.realm = @"utid";
+        accessToken.clientId = @"client";
+        accessToken.target = [NSString stringWithFormat:@"scope%lu", (unsigned long)i];
+        accessToken.secret = @"secret";
+        accessToken.expiresOn = [NSDate dateWithTimeIntervalSinceNow:3600];
+        [cache saveCredential:accessToken context:nil error:nil];
+    }
+    
+    MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
+    query.homeAccountId = @"uid.utid";
+    query.environment = @"login.microsoftonline.com";
+    query.realm = @"utid";
+    query.clientId = @"client";
+    query.target = @"scope9999";
+    query.matchAnyCredentialType = YES;
+    
+    [self benchmark:@"get_credentials_recording_10k_items" operations:1 block:^{
+        MSIDCacheLookupMetrics *metrics = [MSIDCacheLookupMetrics new];
+        [MSIDCacheLookupMetrics beginRecording:metrics];
+        NSArray *results = [cache getCredentialsWithQuery:query context:nil error:nil];
+        [MSIDCacheLookupMetrics endRecording:metrics];
+        
+        XCTAssertEqual(results.count, 1u);
+        XCTAssertEqual(metrics.itemsFetched, 10000u);
+        XCTAssertEqual([metrics rejectionCountForReason:MSIDCacheLookupRejectionReasonTarget], 9999u);
+    }];
+}
+
+@end
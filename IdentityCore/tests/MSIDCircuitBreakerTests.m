@@ -0,0 +1,215 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDCircuitBreaker.h"
+#import "MSIDCircuitBreakerRegistry.h"
+
+@interface MSIDCircuitBreakerTests : XCTestCase
+
+@property (nonatomic) NSTimeInterval now;
+@property (nonatomic) MSIDCircuitBreaker *circuitBreaker;
+
+@end
+
+@implementation MSIDCircuitBreakerTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.now = 1000;
+    self.circuitBreaker = [[MSIDCircuitBreaker alloc] initWithFailureThreshold:3 openDuration:30];
+    
+    __weak typeof(self) weakSelf = self;
+    self.circuitBreaker.clock = ^NSTimeInterval {
+        return weakSelf.now;
+    };
+}
+
+#pragma mark - Helpers
+
+- (void)openCircuitBreaker
+{
+    for (int i = 0; i < 3; i++)
+    {
+        XCTAssertTrue([self.circuitBreaker allowRequest]);
+        [self.circuitBreaker recordFailure];
+    }
+    
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateOpen);
+}
+
+#pragma mark - Closed
+
+- (void)testInitialState_shouldBeClosedAndAllowRequests
+{
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateClosed);
+    XCTAssertTrue([self.circuitBreaker allowRequest]);
+}
+
+- (void)testRecordFailure_belowThreshold_shouldStayClosed
+{
+    [self.circuitBreaker recordFailure];
+    [self.circuitBreaker recordFailure];
+    
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateClosed);
+    XCTAssertEqual(self.circuitBreaker.metrics.consecutiveFailures, 2u);
+}
+
+- (void)testRecordSuccess_shouldResetConsecutiveFailures
+{
+    [self.circuitBreaker recordFailure];
+    [self.circuitBreaker recordFailure];
+    [self.circuitBreaker recordSuccess];
+    [self.circuitBreaker recordFailure];
+    [self.circuitBreaker recordFailure];
+    
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateClosed);
+}
+
+#pragma mark - Open
+
+- (void)testRecordFailure_atThreshold_shouldOpenAndRejectRequests
+{
+    [self openCircuitBreaker];
+    
+    XCTAssertFalse([self.circuitBreaker allowRequest]);
+    XCTAssertFalse([self.circuitBreaker allowRequest]);
+    
+    MSIDCircuitBreakerMetrics *metrics = self.circuitBreaker.metrics;
+    XCTAssertEqual(metrics.openedCount, 1u);
+    XCTAssertEqual(metrics.rejectedRequestCount, 2u);
+    XCTAssertNotNil(metrics.lastTransitionDate);
+}
+
+- (void)testAllowRequest_whenOpenDurationElapsed_shouldLetSingleProbeThrough
+{
+    [self openCircuitBreaker];
+    self.now += 30;
+    
+    XCTAssertTrue([self.circuitBreaker allowRequest]);
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateHalfOpen);
+    XCTAssertFalse([self.circuitBreaker allowRequest], @"only one probe at a time");
+    XCTAssertEqual(self.circuitBreaker.metrics.halfOpenedCount, 1u);
+}
+
+#pragma mark - Half-open
+
+- (void)testProbeSuccess_shouldClose
+{
+    [self openCircuitBreaker];
+    self.now += 30;
+    XCTAssertTrue([self.circuitBreaker allowRequest]);
+    
+    [self.circuitBreaker recordSuccess];
+    
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateClosed);
+    XCTAssertTrue([self.circuitBreaker allowRequest]);
+    XCTAssertEqual(self.circuitBreaker.metrics.closedCount, 1u);
+}
+
+- (void)testProbeFailure_shouldReopenForAnotherOpenDuration
+{
+    [self openCircuitBreaker];
+    self.now += 30;
+    XCTAssertTrue([self.circuitBreaker allowRequest]);
+    
+    [self.circuitBreaker recordFailure];
+    
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateOpen);
+    self.now += 29;
+    XCTAssertFalse([self.circuitBreaker allowRequest]);
+    self.now += 1;
+    XCTAssertTrue([self.circuitBreaker allowRequest]);
+    XCTAssertEqual(self.circuitBreaker.metrics.openedCount, 2u);
+}
+
+- (void)testProbeIgnoredOutcome_shouldReleaseProbeSlot
+{
+    [self openCircuitBreaker];
+    self.now += 30;
+    XCTAssertTrue([self.circuitBreaker allowRequest]);
+    
+    [self.circuitBreaker recordIgnoredOutcome];
+    
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateHalfOpen);
+    XCTAssertTrue([self.circuitBreaker allowRequest]);
+}
+
+- (void)testProbeNeverReported_shouldAllowNewProbeAfterOpenDuration
+{
+    [self openCircuitBreaker];
+    self.now += 30;
+    XCTAssertTrue([self.circuitBreaker allowRequest]);
+    
+    self.now += 10;
+    XCTAssertFalse([self.circuitBreaker allowRequest]);
+    self.now += 20;
+    XCTAssertTrue([self.circuitBreaker allowRequest]);
+}
+
+#pragma mark - Registry
+
+- (void)testEndpointClassForURL_shouldClassifyGuardedEndpoints
+{
+    XCTAssertEqual([MSIDCircuitBreakerRegistry endpointClassForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/common/oauth2/v2.0/token"]], MSIDCircuitBreakerEndpointClassToken);
+    XCTAssertEqual([MSIDCircuitBreakerRegistry endpointClassForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/contoso.com/oauth2/token"]], MSIDCircuitBreakerEndpointClassToken);
+    XCTAssertEqual([MSIDCircuitBreakerRegistry endpointClassForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/common/discovery/instance?api-version=1.1"]], MSIDCircuitBreakerEndpointClassInstanceDiscovery);
+    XCTAssertEqual([MSIDCircuitBreakerRegistry endpointClassForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/common/v2.0/.well-known/openid-configuration"]], MSIDCircuitBreakerEndpointClassOpenIdConfiguration);
+    XCTAssertEqual([MSIDCircuitBreakerRegistry endpointClassForURL:[NSURL URLWithString:@"https://enterpriseregistration.windows.net/contoso.com/enrollmentserver/contract?api-version=1.0"]], MSIDCircuitBreakerEndpointClassDRS);
+    XCTAssertEqual([MSIDCircuitBreakerRegistry endpointClassForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/common/oauth2/v2.0/authorize"]], MSIDCircuitBreakerEndpointClassNone);
+    XCTAssertEqual([MSIDCircuitBreakerRegistry endpointClassForURL:nil], MSIDCircuitBreakerEndpointClassNone);
+}
+
+- (void)testCircuitBreakerForURL_shouldBeKeyedOnHostAndEndpointClass
+{
+    MSIDCircuitBreakerRegistry *registry = [MSIDCircuitBreakerRegistry new];
+    
+    MSIDCircuitBreaker *token1 = [registry circuitBreakerForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/common/oauth2/v2.0/token"]];
+    MSIDCircuitBreaker *token2 = [registry circuitBreakerForURL:[NSURL URLWithString:@"https://LOGIN.microsoftonline.com/contoso.com/oauth2/v2.0/token"]];
+    MSIDCircuitBreaker *discovery = [registry circuitBreakerForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/common/discovery/instance"]];
+    MSIDCircuitBreaker *otherCloud = [registry circuitBreakerForURL:[NSURL URLWithString:@"https://login.microsoftonline.us/common/oauth2/v2.0/token"]];
+    
+    XCTAssertNotNil(token1);
+    XCTAssertEqual(token1, token2);
+    XCTAssertNotEqual(token1, discovery);
+    XCTAssertNotEqual(token1, otherCloud);
+    XCTAssertNil([registry circuitBreakerForURL:[NSURL URLWithString:@"https://contoso.com/api"]]);
+    XCTAssertEqual(registry.metricsSnapshot.count, 3u);
+    XCTAssertNotNil(registry.metricsSnapshot[@"login.microsoftonline.com|token"]);
+}
+
+- (void)testCircuitBreakerForURL_shouldUseRegistryConfiguration
+{
+    MSIDCircuitBreakerRegistry *registry = [MSIDCircuitBreakerRegistry new];
+    registry.failureThreshold = 2;
+    registry.openDuration = 5;
+    
+    MSIDCircuitBreaker *circuitBreaker = [registry circuitBreakerForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/common/oauth2/v2.0/token"]];
+    
+    XCTAssertEqual(circuitBreaker.failureThreshold, 2u);
+    XCTAssertEqual(circuitBreaker.openDuration, 5);
+}
+
+@end
@@ -23,6 +23,7 @@
 
 #import <XCTest/XCTest.h>
 #import "MSIDDIContainer.h"
+#import "MSIDBenchmarkTestCase.h"
 
 #pragma mark - Test fixtures
 
@@ -506,10 +507,10 @@
                                   return [MSIDDIContainerTestClassMethodService class];
                               }];
 
-        // After the first resolve, the bad entry should have been evicted from
-        // both _singletonCache and _entryByKey. The second resolve therefore
+        // After the first resolve, the bad registration (and its cached
+        // singleton) should have been evicted. The second resolve therefore
         // finds no registration, takes the "no entry + defaultProvider" branch
-        // in -resolveKey:description:defaultProvider:, and returns the default
+        // in -resolveKey:entry:defaultProvider:, and returns the default
         // without re-invoking the (broken) factory.
         Class second = [self.container
             resolveImplClassForProtocol:@protocol(MSIDDIContainerTestClassMethodProtocol)
@@ -568,15 +569,69 @@
     XCTAssertEqualObjects([impl greeting], @"hello-class");
 }
 
+#pragma mark - Validation caching
+
+- (void)testResolveImplClassForProtocol_whenRegisteredClassConforms_shouldValidateOnce
+{
+    __block NSInteger factoryInvocations = 0;
+    [self.container registerProtocol:@protocol(MSIDDIContainerTestClassMethodProtocol)
+                            lifetime:MSIDDIContainerLifetimeTransient
+                             factory:^id {
+                                 factoryInvocations++;
+                                 return (id)[MSIDDIContainerTestClassMethodMockService class];
+                             }];
+
+    for (NSInteger i = 0; i < 3; i++)
+    {
+        Class<MSIDDIContainerTestClassMethodProtocol> impl =
+            (Class<MSIDDIContainerTestClassMethodProtocol>)[self.container
+                resolveImplClassForProtocol:@protocol(MSIDDIContainerTestClassMethodProtocol)
+                                  orDefault:^Class { return [MSIDDIContainerTestClassMethodService class]; }];
+        XCTAssertEqualObjects([impl greeting], @"mocked-class");
+    }
+
+    XCTAssertEqual(factoryInvocations, 3);
+}
+
+- (void)testResolveImplClassForProtocol_whenReregisteredWithNonConformingClass_shouldValidateNewRegistration
+{
+    [self.container registerProtocol:@protocol(MSIDDIContainerTestClassMethodProtocol)
+                            lifetime:MSIDDIContainerLifetimeSingleton
+                             factory:^id { return (id)[MSIDDIContainerTestClassMethodMockService class]; }];
+    [self.container resolveImplClassForProtocol:@protocol(MSIDDIContainerTestClassMethodProtocol)
+                                      orDefault:^Class { return [MSIDDIContainerTestClassMethodService class]; }];
+
+    [self.container registerProtocol:@protocol(MSIDDIContainerTestClassMethodProtocol)
+                            lifetime:MSIDDIContainerLifetimeSingleton
+                             factory:^id { return (id)[MSIDDIContainerTestNonConformingService class]; }];
+
+    XCTAssertThrows(([self.container
+        resolveImplClassForProtocol:@protocol(MSIDDIContainerTestClassMethodProtocol)
+                          orDefault:^Class { return [MSIDDIContainerTestClassMethodService class]; }]));
+}
+
+- (void)testResolveClass_whenSameClassRegisteredOnTwoContainers_shouldKeepRegistriesSeparate
+{
+    MSIDDIContainer *otherContainer = [MSIDDIContainer new];
+    [self.container registerClass:[MSIDDIContainerTestService class]
+                         lifetime:MSIDDIContainerLifetimeSingleton
+                          factory:^id { return [MSIDDIContainerTestMockService new]; }];
+
+    id resolved = [otherContainer resolveClass:[MSIDDIContainerTestService class]
+                                     orDefault:^id { return [MSIDDIContainerTestService new]; }];
+
+    XCTAssertTrue([resolved isKindOfClass:[MSIDDIContainerTestService class]]);
+}
+
 #pragma mark - Concurrent registration + resolution stress test
 
 - (void)testConcurrentRegistrationAndResolution_shouldNotCrashAndConverge
 {
     // Race the public mutating API (registerProtocol:lifetime:factory:) against
     // resolveImplClassForProtocol:orDefault: across many iterations. The
-    // container guards its mutable maps with a concurrent queue + barrier
-    // writes; this test pins that no concurrent register/resolve pair can
-    // crash or yield a torn class reference.
+    // container publishes a new registry copy on every write and resolves
+    // from whichever copy is current; this test pins that no concurrent
+    // register/resolve pair can crash or yield a torn class reference.
     NSInteger iterations = 100;
 
     // XCTest assertions are not guaranteed to be thread-safe, so we collect any
@@ -628,3 +683,41 @@
 }
 
 @end
+
+#pragma mark - Benchmarks
+
+@interface MSIDDIContainerBenchmarks : MSIDBenchmarkTestCase
+@end
+
+@implementation MSIDDIContainerBenchmarks
+
+- (void)testResolveProtocol_whenResolvedConcurrently_benchmark
+{
+    MSIDDIContainer *container = [MSIDDIContainer new];
+    [container registerProtocol:@protocol(MSIDDIContainerTestProtocol)
+                       lifetime:MSIDDIContainerLifetimeSingleton
+                        factory:^id { return [MSIDDIContainerTestService new]; }];
+    [container registerProtocol:@protocol(MSIDDIContainerTestClassMethodProtocol)
+                       lifetime:MSIDDIContainerLifetimeSingleton
+                        factory:^id { return (id)[MSIDDIContainerTestClassMethodMockService class]; }];
+
+    // 100k resolutions per sample across 8 threads, split between instance and class-method seams.
+    size_t threadCount = 8;
+    NSInteger resolutionsPerThread = 100000 / threadCount / 2;
+
+    [self benchmark:@"di_container_resolve_concurrent" operations:1 block:^{
+        dispatch_apply(threadCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(__unused size_t thread) {
+            for (NSInteger i = 0; i < resolutionsPerThread; i++)
+            {
+                @autoreleasepool
+                {
+                    __unused id service = [container resolveProtocol:@protocol(MSIDDIContainerTestProtocol)];
+                    __unused Class impl = [container resolveImplClassForProtocol:@protocol(MSIDDIContainerTestClassMethodProtocol)
+                                                                       orDefault:^Class { return [MSIDDIContainerTestClassMethodService class]; }];
+                }
+            }
+        });
+    }];
+}
+
+@end
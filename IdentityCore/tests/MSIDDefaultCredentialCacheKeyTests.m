@@ -207,4 +207,73 @@
     XCTAssertEqualObjects(key.type, @2002);
 }
 
+- (void)testKeyComponents_whenReadRepeatedly_shouldReturnSameInstances
+{
+    MSIDDefaultCredentialCacheKey *key = [[MSIDDefaultCredentialCacheKey alloc] initWithHomeAccountId:@"uid.utid"
+                                                                                         environment:@"login.microsoftonline.com"
+                                                                                            clientId:@"client"
+                                                                                      credentialType:MSIDAccessTokenType];
+    key.realm = @"contoso.com";
+    key.target = @"user.read";
+    
+    XCTAssertTrue(key.account == key.account);
+    XCTAssertTrue(key.service == key.service);
+    XCTAssertTrue(key.generic == key.generic);
+}
+
+- (void)testKeyComponents_whenPropertyChangesAfterRead_shouldRecompute
+{
+    MSIDDefaultCredentialCacheKey *key = [[MSIDDefaultCredentialCacheKey alloc] initWithHomeAccountId:@"uid.utid"
+                                                                                         environment:@"login.microsoftonline.com"
+                                                                                            clientId:@"client"
+                                                                                      credentialType:MSIDAccessTokenType];
+    key.realm = @"contoso.com";
+    key.target = @"user.read";
+    XCTAssertEqualObjects(key.service, @"accesstoken-client-contoso.com-user.read");
+    XCTAssertEqualObjects(key.account, @"uid.utid-login.microsoftonline.com");
+    
+    key.realm = @"Fabrikam.com";
+    key.environment = @"login.windows.net";
+    key.tokenType = @"Pop";
+    key.appKey = @"app-key";
+    
+    XCTAssertEqualObjects(key.service, @"accesstoken-client-fabrikam.com-user.read-pop|app-key");
+    XCTAssertEqualObjects(key.generic, [@"accesstoken-client-fabrikam.com" dataUsingEncoding:NSUTF8StringEncoding]);
+    XCTAssertEqualObjects(key.account, @"uid.utid-login.windows.net");
+    
+    key.familyId = @"1";
+    key.credentialType = MSIDRefreshTokenType;
+    
+    XCTAssertEqualObjects(key.generic, [@"refreshtoken-1-fabrikam.com" dataUsingEncoding:NSUTF8StringEncoding]);
+}
+
+- (void)testKeyComponents_whenComponentsNeedNormalization_shouldTrimAndLowercase
+{
+    MSIDDefaultCredentialCacheKey *key = [[MSIDDefaultCredentialCacheKey alloc] initWithHomeAccountId:@" UID.UTID "
+                                                                                         environment:@"Login.MicrosoftOnline.com\n"
+                                                                                            clientId:@" Client"
+                                                                                      credentialType:MSIDAccessTokenType];
+    key.realm = @"Contoso.com ";
+    key.target = @" User.Read";
+    
+    // Same raw components again, served from the interned normalized forms.
+    MSIDDefaultCredentialCacheKey *secondKey = [key copy];
+    
+    XCTAssertEqualObjects(key.account, @"uid.utid-login.microsoftonline.com");
+    XCTAssertEqualObjects(key.service, @"accesstoken-client-contoso.com-user.read");
+    XCTAssertEqualObjects(secondKey.account, key.account);
+    XCTAssertEqualObjects(secondKey.service, key.service);
+}
+
+- (void)testKeyComponents_whenNilComponents_shouldKeepLegacyFormat
+{
+    MSIDDefaultCredentialCacheKey *key = [[MSIDDefaultCredentialCacheKey alloc] initWithHomeAccountId:nil
+                                                                                         environment:nil
+                                                                                            clientId:nil
+                                                                                      credentialType:MSIDIDTokenType];
+    
+    XCTAssertEqualObjects(key.account, @"(null)-(null)");
+    XCTAssertEqualObjects(key.service, @"idtoken-(null)--");
+}
+
 @end
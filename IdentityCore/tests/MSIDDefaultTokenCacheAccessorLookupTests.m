@@ -0,0 +1,362 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDDefaultTokenCacheAccessor.h"
+#import "MSIDAccountCredentialCache.h"
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDCredentialCacheItem.h"
+#import "MSIDAccountCacheItem.h"
+#import "MSIDAccountIdentifier.h"
+#import "MSIDRefreshToken.h"
+#import "MSIDConfiguration.h"
+#import "MSIDTestConfiguration.h"
+#import "MSIDTestIdentifiers.h"
+#import "MSIDAadAuthorityCache.h"
+#import "MSIDAadAuthorityCacheRecord.h"
+#import "MSIDBenchmarkTestCase.h"
+
+@interface MSIDDefaultTokenCacheAccessor (LookupTesting)
+
+- (MSIDRefreshToken *)getRefreshableTokenWithAccount:(MSIDAccountIdentifier *)accountIdentifier
+                                            familyId:(NSString *)familyId
+                                      credentialType:(MSIDCredentialType)credentialType
+                                       configuration:(MSIDConfiguration *)configuration
+                                             context:(id<MSIDRequestContext>)context
+                                               error:(NSError *__autoreleasing *)error;
+
+@end
+
+@interface MSIDLookupCountingTestCacheDataSource : MSIDTestCacheDataSource
+
+@property (nonatomic) NSUInteger tokenQueryCount;
+@property (nonatomic) NSUInteger accountQueryCount;
+
+@end
+
+@implementation MSIDLookupCountingTestCacheDataSource
+
+- (NSArray<MSIDCredentialCacheItem *> *)tokensWithKey:(MSIDCacheKey *)key
+                                           serializer:(id<MSIDCacheItemSerializing>)serializer
+                                              context:(id<MSIDRequestContext>)context
+                                                error:(NSError *__autoreleasing *)error
+{
+    self.tokenQueryCount++;
+    return [super tokensWithKey:key serializer:serializer context:context error:error];
+}
+
+- (NSArray<MSIDAccountCacheItem *> *)accountsWithKey:(MSIDCacheKey *)key
+                                          serializer:(id<MSIDExtendedCacheItemSerializing>)serializer
+                                             context:(id<MSIDRequestContext>)context
+                                               error:(NSError *__autoreleasing *)error
+{
+    self.accountQueryCount++;
+    return [super accountsWithKey:key serializer:serializer context:context error:error];
+}
+
+@end
+
+@interface MSIDDefaultTokenCacheAccessorLookupTests : XCTestCase
+
+@property (nonatomic) MSIDLookupCountingTestCacheDataSource *dataSource;
+@property (nonatomic) MSIDAccountCredentialCache *credentialCache;
+@property (nonatomic) MSIDDefaultTokenCacheAccessor *accessor;
+
+@end
+
+@implementation MSIDDefaultTokenCacheAccessorLookupTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    self.dataSource = [MSIDLookupCountingTestCacheDataSource new];
+    self.credentialCache = [[MSIDAccountCredentialCache alloc] initWithDataSource:self.dataSource];
+    self.accessor = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:self.dataSource otherCacheAccessors:nil];
+    
+    __auto_type record = [MSIDAadAuthorityCacheRecord new];
+    record.validated = YES;
+    record.cacheHost = @"login.windows.net";
+    record.aliases = @[DEFAULT_TEST_ENVIRONMENT, @"login.windows.net", @"login.microsoft.com"];
+    [[MSIDAadAuthorityCache sharedInstance] setObject:record forKey:DEFAULT_TEST_ENVIRONMENT];
+}
+
+- (void)tearDown
+{
+    [[MSIDAadAuthorityCache sharedInstance] removeAllObjects];
+    [self.dataSource reset];
+    [super tearDown];
+}
+
+#pragma mark - Tests
+
+- (void)testGetRefreshableToken_whenHomeAccountIdAndDisplayableIdProvidedAndHomeAccountMatches_shouldQueryCredentialsOnce
+{
+    [self saveRefreshTokenWithHomeAccountId:@"uid.utid" environment:@"login.windows.net" secret:@"rt"];
+    [self saveAccountWithHomeAccountId:@"uid.utid" username:@"user@contoso.com"];
+    [self resetCounters];
+    
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:@"user@contoso.com" homeAccountId:@"uid.utid"];
+    MSIDRefreshToken *refreshToken = [self refreshTokenForAccount:account];
+    
+    XCTAssertEqualObjects(refreshToken.refreshToken, @"rt");
+    XCTAssertEqual(self.dataSource.tokenQueryCount, 1u);
+    XCTAssertEqual(self.dataSource.accountQueryCount, 0u);
+}
+
+- (void)testGetRefreshableToken_whenOnlyLegacyAccountMatches_shouldResolveLegacyAccountWithoutSecondCredentialQuery
+{
+    [self saveRefreshTokenWithHomeAccountId:@"legacy_uid.utid" environment:@"login.windows.net" secret:@"legacy rt"];
+    [self saveAccountWithHomeAccountId:@"legacy_uid.utid" username:@"user@contoso.com"];
+    [self resetCounters];
+    
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:@"user@contoso.com" homeAccountId:@"uid.utid"];
+    MSIDRefreshToken *refreshToken = [self refreshTokenForAccount:account];
+    
+    XCTAssertEqualObjects(refreshToken.refreshToken, @"legacy rt");
+    XCTAssertEqualObjects(refreshToken.accountIdentifier.homeAccountId, @"legacy_uid.utid");
+    XCTAssertEqual(self.dataSource.tokenQueryCount, 1u);
+    XCTAssertEqual(self.dataSource.accountQueryCount, 1u);
+}
+
+- (void)testGetRefreshableToken_whenNoCandidates_shouldNotResolveLegacyAccount
+{
+    [self saveAccountWithHomeAccountId:@"legacy_uid.utid" username:@"user@contoso.com"];
+    [self resetCounters];
+    
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:@"user@contoso.com" homeAccountId:@"uid.utid"];
+    MSIDRefreshToken *refreshToken = [self refreshTokenForAccount:account];
+    
+    XCTAssertNil(refreshToken);
+    XCTAssertEqual(self.dataSource.tokenQueryCount, 1u);
+    XCTAssertEqual(self.dataSource.accountQueryCount, 0u);
+}
+
+- (void)testGetRefreshableToken_whenTokensInSeveralAliases_shouldReturnPreferredCacheAlias
+{
+    [self saveRefreshTokenWithHomeAccountId:@"uid.utid" environment:@"login.microsoft.com" secret:@"other alias rt"];
+    [self saveRefreshTokenWithHomeAccountId:@"uid.utid" environment:@"login.windows.net" secret:@"preferred rt"];
+    [self saveRefreshTokenWithHomeAccountId:@"uid.utid" environment:DEFAULT_TEST_ENVIRONMENT secret:@"requested alias rt"];
+    
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:nil homeAccountId:@"uid.utid"];
+    MSIDRefreshToken *refreshToken = [self refreshTokenForAccount:account];
+    
+    XCTAssertEqualObjects(refreshToken.refreshToken, @"preferred rt");
+    XCTAssertEqualObjects(refreshToken.storageEnvironment, @"login.windows.net");
+    XCTAssertEqualObjects(refreshToken.environment, DEFAULT_TEST_ENVIRONMENT);
+}
+
+- (void)testGetRefreshableToken_whenHomeAccountMatchesInOtherAliasAndLegacyAccountInPreferredAlias_shouldReturnHomeAccountMatch
+{
+    [self saveRefreshTokenWithHomeAccountId:@"uid.utid" environment:@"login.microsoft.com" secret:@"home rt"];
+    [self saveRefreshTokenWithHomeAccountId:@"legacy_uid.utid" environment:@"login.windows.net" secret:@"legacy rt"];
+    [self saveAccountWithHomeAccountId:@"legacy_uid.utid" username:@"user@contoso.com"];
+    
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:@"user@contoso.com" homeAccountId:@"uid.utid"];
+    MSIDRefreshToken *refreshToken = [self refreshTokenForAccount:account];
+    
+    XCTAssertEqualObjects(refreshToken.refreshToken, @"home rt");
+    XCTAssertEqualObjects(refreshToken.storageEnvironment, @"login.microsoft.com");
+}
+
+- (void)testGetRefreshableToken_whenOtherAccountsCached_shouldIgnoreThem
+{
+    [self saveRefreshTokenWithHomeAccountId:@"other_uid.utid" environment:@"login.windows.net" secret:@"other rt"];
+    [self saveRefreshTokenWithHomeAccountId:@"uid.utid" environment:DEFAULT_TEST_ENVIRONMENT secret:@"rt"];
+    
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:@"user@contoso.com" homeAccountId:@"uid.utid"];
+    MSIDRefreshToken *refreshToken = [self refreshTokenForAccount:account];
+    
+    XCTAssertEqualObjects(refreshToken.refreshToken, @"rt");
+}
+
+- (void)testSilentLookups_whenSameConfiguration_shouldComputeAliasesOncePerRequest
+{
+    [self saveRefreshTokenWithHomeAccountId:@"uid.utid" environment:@"login.windows.net" secret:@"rt"];
+    [self saveAccountWithHomeAccountId:@"uid.utid" username:@"user@contoso.com"];
+    
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:@"user@contoso.com" homeAccountId:@"uid.utid"];
+    MSIDConfiguration *configuration = [MSIDTestConfiguration v2DefaultConfiguration];
+    uint64_t computationCount = [MSIDAadAuthorityCache sharedInstance].aliasComputationCount;
+    
+    [self performSilentLookupsForAccount:account configuration:configuration];
+    
+    XCTAssertEqual([MSIDAadAuthorityCache sharedInstance].aliasComputationCount - computationCount, 1u);
+}
+
+- (void)testSilentLookups_whenNewAuthorityPerLookup_shouldComputeAliasesPerLookup
+{
+    [self saveRefreshTokenWithHomeAccountId:@"uid.utid" environment:@"login.windows.net" secret:@"rt"];
+    [self saveAccountWithHomeAccountId:@"uid.utid" username:@"user@contoso.com"];
+    
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:@"user@contoso.com" homeAccountId:@"uid.utid"];
+    MSIDConfiguration *configuration = [MSIDTestConfiguration v2DefaultConfiguration];
+    uint64_t computationCount = [MSIDAadAuthorityCache sharedInstance].aliasComputationCount;
+    
+    // Same lookups as above with a fresh authority each, which is what every lookup of a request cost before memoization.
+    [self.accessor getAccessTokenForAccount:account configuration:[configuration copy] context:nil error:nil];
+    [self.accessor getIDTokenForAccount:account configuration:[configuration copy] idTokenType:MSIDIDTokenType context:nil error:nil];
+    [self.accessor getAccountForIdentifier:account authority:[configuration.authority copy] realmHint:nil accountHomeTenantId:nil accountSelectionLog:nil context:nil error:nil];
+    XCTAssertNotNil([self.accessor getRefreshTokenWithAccount:account familyId:nil configuration:[configuration copy] context:nil error:nil]);
+    
+    XCTAssertEqual([MSIDAadAuthorityCache sharedInstance].aliasComputationCount - computationCount, 4u);
+}
+
+- (void)testSilentLookups_whenAuthorityMetadataChangesDuringRequest_shouldRecomputeAliases
+{
+    MSIDConfiguration *configuration = [MSIDTestConfiguration v2DefaultConfiguration];
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:@"user@contoso.com" homeAccountId:@"uid.utid"];
+    [self saveRefreshTokenWithHomeAccountId:@"uid.utid" environment:@"login.contoso.net" secret:@"rt"];
+    
+    XCTAssertNil([self.accessor getRefreshTokenWithAccount:account familyId:nil configuration:configuration context:nil error:nil]);
+    
+    __auto_type record = [MSIDAadAuthorityCacheRecord new];
+    record.validated = YES;
+    record.cacheHost = @"login.contoso.net";
+    record.aliases = @[DEFAULT_TEST_ENVIRONMENT, @"login.contoso.net"];
+    [[MSIDAadAuthorityCache sharedInstance] setObject:record forKey:DEFAULT_TEST_ENVIRONMENT];
+    
+    MSIDRefreshToken *refreshToken = [self.accessor getRefreshTokenWithAccount:account familyId:nil configuration:configuration context:nil error:nil];
+    XCTAssertEqualObjects(refreshToken.refreshToken, @"rt");
+}
+
+#pragma mark - Helpers
+
+- (MSIDRefreshToken *)refreshTokenForAccount:(MSIDAccountIdentifier *)account
+{
+    return [self.accessor getRefreshableTokenWithAccount:account
+                                                familyId:nil
+                                          credentialType:MSIDRefreshTokenType
+                                           configuration:[MSIDTestConfiguration v2DefaultConfiguration]
+                                                 context:nil
+                                                   error:nil];
+}
+
+- (void)saveRefreshTokenWithHomeAccountId:(NSString *)homeAccountId environment:(NSString *)environment secret:(NSString *)secret
+{
+    MSIDCredentialCacheItem *item = [MSIDCredentialCacheItem new];
+    item.credentialType = MSIDRefreshTokenType;
+    item.homeAccountId = homeAccountId;
+    item.environment = environment;
+    item.clientId = DEFAULT_TEST_CLIENT_ID;
+    item.secret = secret;
+    XCTAssertTrue([self.credentialCache saveCredential:item context:nil error:nil]);
+}
+
+- (void)saveAccountWithHomeAccountId:(NSString *)homeAccountId username:(NSString *)username
+{
+    MSIDAccountCacheItem *item = [MSIDAccountCacheItem new];
+    item.accountType = MSIDAccountTypeMSSTS;
+    item.homeAccountId = homeAccountId;
+    item.environment = @"login.windows.net";
+    item.realm = @"utid";
+    item.localAccountId = @"uid";
+    item.username = username;
+    XCTAssertTrue([self.credentialCache saveAccount:item context:nil error:nil]);
+}
+
+- (void)performSilentLookupsForAccount:(MSIDAccountIdentifier *)account configuration:(MSIDConfiguration *)configuration
+{
+    [self.accessor getAccessTokenForAccount:account configuration:configuration context:nil error:nil];
+    [self.accessor getIDTokenForAccount:account configuration:configuration idTokenType:MSIDIDTokenType context:nil error:nil];
+    [self.accessor getAccountForIdentifier:account authority:configuration.authority realmHint:nil accountHomeTenantId:nil accountSelectionLog:nil context:nil error:nil];
+    XCTAssertNotNil([self.accessor getRefreshTokenWithAccount:account familyId:nil configuration:configuration context:nil error:nil]);
+}
+
+- (void)resetCounters
+{
+    self.dataSource.tokenQueryCount = 0;
+    self.dataSource.accountQueryCount = 0;
+}
+
+@end
+
+@interface MSIDDefaultTokenCacheAccessorLookupBenchmarks : MSIDBenchmarkTestCase
+
+@property (nonatomic) MSIDTestCacheDataSource *dataSource;
+@property (nonatomic) MSIDDefaultTokenCacheAccessor *accessor;
+
+@end
+
+@implementation MSIDDefaultTokenCacheAccessorLookupBenchmarks
+
+- (void)setUp
+{
+    [super setUp];
+    
+    self.dataSource = [MSIDTestCacheDataSource new];
+    self.accessor = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:self.dataSource otherCacheAccessors:nil];
+    
+    __auto_type record = [MSIDAadAuthorityCacheRecord new];
+    record.validated = YES;
+    record.cacheHost = @"login.windows.net";
+    record.aliases = @[DEFAULT_TEST_ENVIRONMENT, @"login.windows.net", @"login.microsoft.com"];
+    [[MSIDAadAuthorityCache sharedInstance] setObject:record forKey:DEFAULT_TEST_ENVIRONMENT];
+}
+
+- (void)tearDown
+{
+    [[MSIDAadAuthorityCache sharedInstance] removeAllObjects];
+    [self.dataSource reset];
+    [super tearDown];
+}
+
+#pragma mark - Benchmarks
+
+- (void)testGetRefreshableToken_withManyAccounts_benchmark
+{
+    for (NSUInteger i = 0; i < 50; i++)
+    {
+        MSIDCredentialCacheItem *refreshToken = [MSIDCredentialCacheItem new];
+        refreshToken.credentialType = MSIDRefreshTokenType;
+        refreshToken.homeAccountId = [NSString stringWithFormat:@"uid%lu.utid", (unsigned long)i];
+        refreshToken.environment = @"login.windows.net";
+        refreshToken.clientId = DEFAULT_TEST_CLIENT_ID;
+        refreshToken.secret = @"rt";
+        XCTAssertTrue([self.accessor.accountCredentialCache saveCredential:refreshToken context:nil error:nil]);
+        
+        MSIDAccountCacheItem *account = [MSIDAccountCacheItem new];
+        account.accountType = MSIDAccountTypeMSSTS;
+        account.homeAccountId = refreshToken.homeAccountId;
+        account.environment = @"login.windows.net";
+        account.realm = @"utid";
+        account.localAccountId = @"uid";
+        account.username = [NSString stringWithFormat:@"user%lu@contoso.com", (unsigned long)i];
+        XCTAssertTrue([self.accessor.accountCredentialCache saveAccount:account context:nil error:nil]);
+    }
+    
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:@"user49@contoso.com" homeAccountId:@"uid49.utid"];
+    
+    // A new configuration per lookup, as every silent request brings its own.
+    [self benchmark:@"get_refreshable_token_50_accounts" operations:100 block:^{
+        XCTAssertNotNil([self.accessor getRefreshableTokenWithAccount:account
+                                                             familyId:nil
+                                                       credentialType:MSIDRefreshTokenType
+                                                        configuration:[MSIDTestConfiguration v2DefaultConfiguration]
+                                                              context:nil
+                                                                error:nil]);
+    }];
+}
+
+@end
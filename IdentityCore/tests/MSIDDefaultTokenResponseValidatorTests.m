@@ -593,4 +593,50 @@
 }
 
 
+- (void)testValidateAndSaveTokenResponse_whenAccountSourcePassed_shouldRecordSourceInAccountMetadata
+{
+    __auto_type authority = [@"https://login.microsoftonline.com/contoso.com" aadAuthority];
+    
+    MSIDRequestParameters *parameters = [[MSIDRequestParameters alloc] initWithAuthority:authority
+                                                                              authScheme:[MSIDAuthenticationScheme new]
+                                                                             redirectUri:@"some_uri"
+                                                                                clientId:@"myclient"
+                                                                                  scopes:[NSOrderedSet orderedSetWithObject:DEFAULT_TEST_SCOPE]
+                                                                              oidcScopes:[NSOrderedSet orderedSetWithObjects:@"openid", @"profile", @"offline_access", nil]
+                                                                           correlationId:[NSUUID new]
+                                                                          telemetryApiId:nil
+                                                                     intuneAppIdentifier:nil
+                                                                             requestType:MSIDRequestLocalType
+                                                                                   error:nil];
+    
+    MSIDAADV2Oauth2Factory *factory = [MSIDAADV2Oauth2Factory new];
+    
+    NSError *error = nil;
+    MSIDTokenResult *result = [self.validator validateAndSaveTokenResponse:[MSIDTestTokenResponse v2DefaultTokenResponse]
+                                                             oauthFactory:factory
+                                                               tokenCache:self.tokenCache
+                                                     accountMetadataCache:self.accountMetadataCache
+                                                        requestParameters:parameters
+                                                         saveSSOStateOnly:NO
+                                                            accountSource:MSIDAccountMetadataSourceBroker
+                                                                    error:&error];
+    
+    XCTAssertNotNil(result);
+    XCTAssertNil(error);
+    
+    NSString *homeAccountId = result.account.accountIdentifier.homeAccountId;
+    XCTAssertEqual([self.accountMetadataCache sourceForHomeAccountId:homeAccountId clientId:@"myclient" context:nil error:nil], MSIDAccountMetadataSourceBroker);
+    
+    result = [self.validator validateAndSaveTokenResponse:[MSIDTestTokenResponse v2DefaultTokenResponse]
+                                             oauthFactory:factory
+                                               tokenCache:self.tokenCache
+                                     accountMetadataCache:self.accountMetadataCache
+                                        requestParameters:parameters
+                                         saveSSOStateOnly:NO
+                                                    error:&error];
+    
+    XCTAssertNotNil(result);
+    XCTAssertEqual([self.accountMetadataCache sourceForHomeAccountId:homeAccountId clientId:@"myclient" context:nil error:nil], MSIDAccountMetadataSourceMixed);
+}
+
 @end
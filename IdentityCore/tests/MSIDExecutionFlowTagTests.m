@@ -40,7 +40,8 @@
         MSIDExecutionFlowNetworkTagToString(MSIDReceiveNetworkResponseTag),
         MSIDExecutionFlowNetworkTagToString(MSIDRetryOnNetworkFailureTag),
         MSIDExecutionFlowNetworkTagToString(MSIDParseNetworkResponseTag),
-        MSIDExecutionFlowNetworkTagToString(MSIDOtherHttpNetworkStatusCodeTag)
+        MSIDExecutionFlowNetworkTagToString(MSIDOtherHttpNetworkStatusCodeTag),
+        MSIDExecutionFlowNetworkTagToString(MSIDCircuitBreakerOpenTag)
     ];
     
     NSSet *uniqueTags = [NSSet setWithArray:tags];
@@ -68,7 +69,8 @@
         MSIDExecutionFlowNetworkTagToString(MSIDReceiveNetworkResponseTag),
         MSIDExecutionFlowNetworkTagToString(MSIDRetryOnNetworkFailureTag),
         MSIDExecutionFlowNetworkTagToString(MSIDParseNetworkResponseTag),
-        MSIDExecutionFlowNetworkTagToString(MSIDOtherHttpNetworkStatusCodeTag)
+        MSIDExecutionFlowNetworkTagToString(MSIDOtherHttpNetworkStatusCodeTag),
+        MSIDExecutionFlowNetworkTagToString(MSIDCircuitBreakerOpenTag)
     ]];
     
     [allTags addObjectsFromArray:@[
@@ -88,6 +90,7 @@
     XCTAssertEqualObjects(MSIDExecutionFlowNetworkTagToString(MSIDRetryOnNetworkFailureTag), @"rz95n");
     XCTAssertEqualObjects(MSIDExecutionFlowNetworkTagToString(MSIDParseNetworkResponseTag), @"fxjo7");
     XCTAssertEqualObjects(MSIDExecutionFlowNetworkTagToString(MSIDOtherHttpNetworkStatusCodeTag), @"5kbvm");
+    XCTAssertEqualObjects(MSIDExecutionFlowNetworkTagToString(MSIDCircuitBreakerOpenTag), @"c8kbo");
 }
 
 - (void)test_MSIDTokenRequestTagToString_returnsExpectedStrings
@@ -0,0 +1,251 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDExponentialBackoffRetryPolicy.h"
+#import "MSIDRetryBudget.h"
+
+@interface MSIDExponentialBackoffRetryPolicyTests : XCTestCase
+
+@property (nonatomic) NSURLRequest *urlRequest;
+
+@end
+
+@implementation MSIDExponentialBackoffRetryPolicyTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.urlRequest = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://login.microsoftonline.com/common/oauth2/v2.0/token"]];
+    [MSIDRetryBudget resetSharedBudgets];
+}
+
+- (void)tearDown
+{
+    [MSIDRetryBudget resetSharedBudgets];
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (MSIDExponentialBackoffRetryPolicy *)policyWithMaxRetries:(NSInteger)maxRetries random:(double)random
+{
+    MSIDExponentialBackoffRetryPolicy *policy = [[MSIDExponentialBackoffRetryPolicy alloc] initWithMaxRetries:maxRetries baseDelay:0.5];
+    policy.retryBudget = [[MSIDRetryBudget alloc] initWithCapacity:100 refillRatePerSecond:0];
+    policy.randomGenerator = ^double { return random; };
+    return policy;
+}
+
+- (NSHTTPURLResponse *)responseWithStatusCode:(NSInteger)statusCode headers:(NSDictionary *)headers
+{
+    return [[NSHTTPURLResponse alloc] initWithURL:self.urlRequest.URL statusCode:statusCode HTTPVersion:nil headerFields:headers];
+}
+
+- (BOOL)retry:(MSIDExponentialBackoffRetryPolicy *)policy response:(NSHTTPURLResponse *)response error:(NSError *)error delay:(NSTimeInterval *)delay
+{
+    return [policy shouldRetryRequest:self.urlRequest httpResponse:response error:error context:nil retryDelay:delay];
+}
+
+#pragma mark - Backoff
+
+- (void)testShouldRetry_whenUnderMaxRetries_shouldRetryUntilLimit
+{
+    MSIDExponentialBackoffRetryPolicy *policy = [self policyWithMaxRetries:2 random:0];
+    NSHTTPURLResponse *response = [self responseWithStatusCode:503 headers:nil];
+    NSTimeInterval delay = 0;
+    
+    XCTAssertTrue([self retry:policy response:response error:nil delay:&delay]);
+    XCTAssertTrue([self retry:policy response:response error:nil delay:&delay]);
+    XCTAssertFalse([self retry:policy response:response error:nil delay:&delay]);
+    XCTAssertEqual(policy.retryCount, 2);
+}
+
+- (void)testShouldRetry_whenZeroMaxRetries_shouldNotRetry
+{
+    MSIDExponentialBackoffRetryPolicy *policy = [self policyWithMaxRetries:0 random:0];
+    NSTimeInterval delay = 0;
+    
+    XCTAssertFalse([self retry:policy response:[self responseWithStatusCode:500 headers:nil] error:nil delay:&delay]);
+}
+
+- (void)testRetryDelay_withMaxRandom_shouldGrowByThreeUpToMaxDelay
+{
+    MSIDExponentialBackoffRetryPolicy *policy = [self policyWithMaxRetries:5 random:0.999999];
+    policy.maxDelay = 5;
+    NSHTTPURLResponse *response = [self responseWithStatusCode:500 headers:nil];
+    NSTimeInterval delay = 0;
+    
+    [self retry:policy response:response error:nil delay:&delay];
+    XCTAssertEqualWithAccuracy(delay, 1.5, 0.001);
+    [self retry:policy response:response error:nil delay:&delay];
+    XCTAssertEqualWithAccuracy(delay, 4.5, 0.001);
+    [self retry:policy response:response error:nil delay:&delay];
+    XCTAssertEqualWithAccuracy(delay, 5, 0.001);
+}
+
+- (void)testRetryDelay_withMinRandom_shouldStayAtBaseDelay
+{
+    MSIDExponentialBackoffRetryPolicy *policy = [self policyWithMaxRetries:3 random:0];
+    NSHTTPURLResponse *response = [self responseWithStatusCode:500 headers:nil];
+    NSTimeInterval delay = 0;
+    
+    for (int i = 0; i < 3; i++)
+    {
+        [self retry:policy response:response error:nil delay:&delay];
+        XCTAssertEqualWithAccuracy(delay, 0.5, 0.001);
+    }
+}
+
+- (void)testRetryDelay_withDefaultRandom_shouldSpreadClientsWithinBounds
+{
+    NSMutableSet<NSNumber *> *delays = [NSMutableSet new];
+    for (int i = 0; i < 100; i++)
+    {
+        MSIDExponentialBackoffRetryPolicy *policy = [[MSIDExponentialBackoffRetryPolicy alloc] initWithMaxRetries:1 baseDelay:0.5];
+        policy.retryBudget = [[MSIDRetryBudget alloc] initWithCapacity:1 refillRatePerSecond:0];
+        NSTimeInterval delay = 0;
+        XCTAssertTrue([self retry:policy response:[self responseWithStatusCode:503 headers:nil] error:nil delay:&delay]);
+        XCTAssertGreaterThanOrEqual(delay, 0.5);
+        XCTAssertLessThanOrEqual(delay, 1.5);
+        [delays addObject:@(delay)];
+    }
+    
+    XCTAssertGreaterThan(delays.count, 50u, @"clients failing together must not retry in lockstep");
+}
+
+- (void)testRetryDelay_whenNotConnectedToInternet_shouldWaitAtLeastOfflineDelay
+{
+    MSIDExponentialBackoffRetryPolicy *policy = [self policyWithMaxRetries:1 random:0];
+    NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNotConnectedToInternet userInfo:nil];
+    NSTimeInterval delay = 0;
+    
+    XCTAssertTrue([self retry:policy response:nil error:error delay:&delay]);
+    XCTAssertEqualWithAccuracy(delay, 2.0, 0.001);
+}
+
+#pragma mark - Retry-After
+
+- (void)testRetryDelay_whenShortRetryAfter_shouldWaitAtLeastRetryAfter
+{
+    MSIDExponentialBackoffRetryPolicy *policy = [self policyWithMaxRetries:1 random:0];
+    NSTimeInterval delay = 0;
+    
+    XCTAssertTrue([self retry:policy response:[self responseWithStatusCode:503 headers:@{@"Retry-After": @"3"}] error:nil delay:&delay]);
+    XCTAssertEqualWithAccuracy(delay, 3, 0.1);
+}
+
+- (void)testShouldRetry_whenRetryAfterExceedsMax_shouldNotRetryAndNotConsumeBudget
+{
+    MSIDExponentialBackoffRetryPolicy *policy = [self policyWithMaxRetries:1 random:0];
+    policy.retryBudget = [[MSIDRetryBudget alloc] initWithCapacity:1 refillRatePerSecond:0];
+    NSTimeInterval delay = 0;
+    
+    XCTAssertFalse([self retry:policy response:[self responseWithStatusCode:503 headers:@{@"Retry-After": @"120"}] error:nil delay:&delay]);
+    XCTAssertEqual(policy.retryCount, 0);
+    XCTAssertEqualWithAccuracy(policy.retryBudget.availableTokens, 1, 0.001);
+}
+
+#pragma mark - Budget
+
+- (void)testShouldRetry_whenBudgetExhausted_shouldNotRetry
+{
+    MSIDRetryBudget *budget = [[MSIDRetryBudget alloc] initWithCapacity:1 refillRatePerSecond:0];
+    MSIDExponentialBackoffRetryPolicy *first = [self policyWithMaxRetries:3 random:0];
+    MSIDExponentialBackoffRetryPolicy *second = [self policyWithMaxRetries:3 random:0];
+    first.retryBudget = budget;
+    second.retryBudget = budget;
+    NSHTTPURLResponse *response = [self responseWithStatusCode:500 headers:nil];
+    NSTimeInterval delay = 0;
+    
+    XCTAssertTrue([self retry:first response:response error:nil delay:&delay]);
+    XCTAssertFalse([self retry:second response:response error:nil delay:&delay]);
+    XCTAssertFalse([self retry:first response:response error:nil delay:&delay]);
+}
+
+- (void)testRetryBudget_shouldRefillOverTime
+{
+    MSIDRetryBudget *budget = [[MSIDRetryBudget alloc] initWithCapacity:1 refillRatePerSecond:20];
+    XCTAssertTrue([budget tryConsumeToken]);
+    XCTAssertFalse([budget tryConsumeToken]);
+    
+    [NSThread sleepForTimeInterval:0.1];
+    
+    XCTAssertTrue([budget tryConsumeToken]);
+}
+
+- (void)testRetryBudget_shouldNotExceedCapacity
+{
+    MSIDRetryBudget *budget = [[MSIDRetryBudget alloc] initWithCapacity:2 refillRatePerSecond:1000];
+    [NSThread sleepForTimeInterval:0.05];
+    
+    XCTAssertEqualWithAccuracy(budget.availableTokens, 2, 0.001);
+}
+
+- (void)testSharedBudget_shouldBeSharedPerEndpointIgnoringQuery
+{
+    MSIDRetryBudget *budget1 = [MSIDRetryBudget sharedBudgetForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/common/oauth2/v2.0/token?a=1"]];
+    MSIDRetryBudget *budget2 = [MSIDRetryBudget sharedBudgetForURL:[NSURL URLWithString:@"https://LOGIN.microsoftonline.com/common/oauth2/v2.0/token"]];
+    MSIDRetryBudget *otherPath = [MSIDRetryBudget sharedBudgetForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/common/discovery/instance"]];
+    MSIDRetryBudget *otherHost = [MSIDRetryBudget sharedBudgetForURL:[NSURL URLWithString:@"https://login.microsoft.com/common/oauth2/v2.0/token"]];
+    
+    XCTAssertEqual(budget1, budget2);
+    XCTAssertNotEqual(budget1, otherPath);
+    XCTAssertNotEqual(budget1, otherHost);
+}
+
+- (void)testSharedBudget_whenDifferentTenants_shouldShareHostBudget
+{
+    MSIDRetryBudget *commonBudget = [MSIDRetryBudget sharedBudgetForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/common/oauth2/v2.0/token"]];
+    MSIDRetryBudget *tenantBudget = [MSIDRetryBudget sharedBudgetForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/contoso.onmicrosoft.com/oauth2/v2.0/token"]];
+    MSIDRetryBudget *otherPortBudget = [MSIDRetryBudget sharedBudgetForURL:[NSURL URLWithString:@"https://login.microsoftonline.com:8443/common/oauth2/v2.0/token"]];
+    MSIDRetryBudget *otherEndpointBudget = [MSIDRetryBudget sharedBudgetForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/contoso.onmicrosoft.com/v2.0/.well-known/openid-configuration"]];
+    MSIDRetryBudget *unknownEndpointBudget1 = [MSIDRetryBudget sharedBudgetForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/tenant1/oauth2/v2.0/devicecode"]];
+    MSIDRetryBudget *unknownEndpointBudget2 = [MSIDRetryBudget sharedBudgetForURL:[NSURL URLWithString:@"https://login.microsoftonline.com/tenant2/oauth2/v2.0/devicecode"]];
+    
+    XCTAssertEqual(commonBudget, tenantBudget);
+    XCTAssertNotEqual(commonBudget, otherPortBudget);
+    XCTAssertNotEqual(commonBudget, otherEndpointBudget);
+    XCTAssertEqual(unknownEndpointBudget1, unknownEndpointBudget2);
+    XCTAssertNotEqual(unknownEndpointBudget1, commonBudget);
+}
+
+- (void)testShouldRetry_whenNoBudgetSet_shouldUseSharedEndpointBudget
+{
+    double originalCapacity = MSIDRetryBudget.sharedBudgetCapacity;
+    MSIDRetryBudget.sharedBudgetCapacity = 1;
+    
+    MSIDExponentialBackoffRetryPolicy *first = [self policyWithMaxRetries:1 random:0];
+    MSIDExponentialBackoffRetryPolicy *second = [self policyWithMaxRetries:1 random:0];
+    first.retryBudget = nil;
+    second.retryBudget = nil;
+    NSHTTPURLResponse *response = [self responseWithStatusCode:500 headers:nil];
+    NSTimeInterval delay = 0;
+    
+    XCTAssertTrue([self retry:first response:response error:nil delay:&delay]);
+    XCTAssertFalse([self retry:second response:response error:nil delay:&delay]);
+    
+    MSIDRetryBudget.sharedBudgetCapacity = originalCapacity;
+}
+
+@end
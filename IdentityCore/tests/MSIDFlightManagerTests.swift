@@ -248,6 +248,75 @@ class MSIDFlightManagerTests: XCTestCase {
         flightManager.flightProvider = nil
     }
     
+    // MARK: - Snapshot Tests
+    
+    func testBoolForKey_WithSnapshotProvider_CallsProviderOnce() {
+        let flightManager = MSIDFlightManager.sharedInstance(byQueryKey: "snapshot-bool-\(UUID().uuidString)", keyType: .tenantId)
+        let provider = MockSnapshotFlightProvider()
+        provider.boolValues["bool-key"] = true
+        flightManager.flightProvider = provider
+        
+        for _ in 0..<10 {
+            XCTAssertTrue(flightManager.bool(forKey: "bool-key"))
+        }
+        
+        XCTAssertEqual(provider.boolReadCount, 1, "Repeated reads should be served from the snapshot")
+    }
+    
+    func testStringForKey_WithSnapshotProvider_CachesMissingValue() {
+        let flightManager = MSIDFlightManager.sharedInstance(byQueryKey: "snapshot-string-\(UUID().uuidString)", keyType: .tenantId)
+        let provider = MockSnapshotFlightProvider()
+        flightManager.flightProvider = provider
+        
+        XCTAssertNil(flightManager.string(forKey: "string-key"))
+        XCTAssertNil(flightManager.string(forKey: "string-key"))
+        
+        XCTAssertEqual(provider.stringReadCount, 1, "Missing values should be part of the snapshot too")
+    }
+    
+    func testFlightProviderDidChangeFlights_WithSnapshotProvider_ReadsNewValues() {
+        let flightManager = MSIDFlightManager.sharedInstance(byQueryKey: "snapshot-change-\(UUID().uuidString)", keyType: .tenantId)
+        let provider = MockSnapshotFlightProvider()
+        provider.stringValues["string-key"] = "old-value"
+        flightManager.flightProvider = provider
+        XCTAssertEqual(flightManager.string(forKey: "string-key"), "old-value")
+        let version = flightManager.snapshotVersion
+        
+        provider.stringValues["string-key"] = "new-value"
+        XCTAssertEqual(flightManager.string(forKey: "string-key"), "old-value", "Value should not change until the provider signals a change")
+        
+        flightManager.flightProviderDidChangeFlights()
+        
+        XCTAssertEqual(flightManager.string(forKey: "string-key"), "new-value")
+        XCTAssertGreaterThan(flightManager.snapshotVersion, version)
+    }
+    
+    func testSetFlightProvider_WithSnapshotProvider_DiscardsPreviousSnapshot() {
+        let flightManager = MSIDFlightManager.sharedInstance(byQueryKey: "snapshot-swap-\(UUID().uuidString)", keyType: .tenantId)
+        let firstProvider = MockSnapshotFlightProvider()
+        firstProvider.boolValues["bool-key"] = true
+        flightManager.flightProvider = firstProvider
+        XCTAssertTrue(flightManager.bool(forKey: "bool-key"))
+        
+        flightManager.flightProvider = MockSnapshotFlightProvider()
+        
+        XCTAssertFalse(flightManager.bool(forKey: "bool-key"))
+    }
+    
+    func testBoolForKey_WithProviderWithoutSnapshotSupport_CallsProviderOnEveryRead() {
+        let flightManager = MSIDFlightManager.sharedInstance(byQueryKey: "no-snapshot-\(UUID().uuidString)", keyType: .tenantId)
+        let provider = MockSnapshotFlightProvider()
+        provider.snapshotSupported = false
+        provider.boolValues["bool-key"] = true
+        flightManager.flightProvider = provider
+        
+        XCTAssertTrue(flightManager.bool(forKey: "bool-key"))
+        provider.boolValues["bool-key"] = false
+        XCTAssertFalse(flightManager.bool(forKey: "bool-key"))
+        
+        XCTAssertEqual(provider.boolReadCount, 2)
+    }
+    
     // MARK: - Edge Cases
     
     func testQueryKeyInstance_WithWhitespaceOnlyKey_ReturnsSharedInstance() {
@@ -268,6 +337,28 @@ class MSIDFlightManagerTests: XCTestCase {
     }
 }
 
+// MARK: - Benchmarks
+
+class MSIDFlightManagerBenchmarks: MSIDBenchmarkTestCase {
+    
+    func testBoolForKey_WithSnapshotProviderAndContendedReads_benchmark() {
+        let flightManager = MSIDFlightManager.sharedInstance(byQueryKey: "snapshot-perf-\(UUID().uuidString)", keyType: .tenantId)
+        let provider = MockSnapshotFlightProvider()
+        provider.boolValues["bool-key"] = true
+        provider.stringValues["string-key"] = "value"
+        flightManager.flightProvider = provider
+        
+        benchmark("flight_manager_contended_reads", operations: 1) {
+            DispatchQueue.concurrentPerform(iterations: 8) { _ in
+                for _ in 0..<10_000 {
+                    _ = flightManager.bool(forKey: "bool-key")
+                    _ = flightManager.string(forKey: "string-key")
+                }
+            }
+        }
+    }
+}
+
 // MARK: - Mock Classes
 
 class MockFlightProvider: NSObject, MSIDFlightManagerInterface {
@@ -320,6 +411,44 @@ class MockFlightProvider: NSObject, MSIDFlightManagerInterface {
     }
 }
 
+class MockSnapshotFlightProvider: NSObject, MSIDFlightManagerInterface {
+    var snapshotSupported = true
+    var boolValues: [String: Bool] = [:]
+    var stringValues: [String: String] = [:]
+    
+    private let lock = NSLock()
+    private var _boolReadCount = 0
+    private var _stringReadCount = 0
+    
+    var boolReadCount: Int {
+        lock.lock(); defer { lock.unlock() }
+        return _boolReadCount
+    }
+    
+    var stringReadCount: Int {
+        lock.lock(); defer { lock.unlock() }
+        return _stringReadCount
+    }
+    
+    func supportsFlightSnapshot() -> Bool {
+        return snapshotSupported
+    }
+    
+    func bool(forKey flightKey: String) -> Bool {
+        lock.lock()
+        _boolReadCount += 1
+        lock.unlock()
+        return boolValues[flightKey] ?? false
+    }
+    
+    func string(forKey key: String) -> String? {
+        lock.lock()
+        _stringReadCount += 1
+        lock.unlock()
+        return stringValues[key]
+    }
+}
+
 class MockQueryKeyDelegate: NSObject, MSIDFlightManagerQueryKeyDelegate {
     var mockFlightProvider: MockFlightProvider?
     
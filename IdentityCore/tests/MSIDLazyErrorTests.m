@@ -0,0 +1,229 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDError.h"
+#import "MSIDLazyError.h"
+#import "MSIDErrorConverter.h"
+#import "MSIDErrorConverting.h"
+#import "MSIDJsonSerializableFactory.h"
+#import "MSIDBenchmarkTestCase.h"
+
+@interface MSIDLazyErrorTestConverter : NSObject <MSIDErrorConverting>
+
+@property (nonatomic) NSUInteger conversionCount;
+
+@end
+
+@implementation MSIDLazyErrorTestConverter
+
+- (nullable NSError *)errorWithDomain:(nonnull NSString *)domain
+                                 code:(NSInteger)code
+                     errorDescription:(nullable NSString *)errorDescription
+                           oauthError:(__unused NSString *)oauthError
+                             subError:(__unused NSString *)subError
+                      underlyingError:(__unused NSError *)underlyingError
+                        correlationId:(__unused NSUUID *)correlationId
+                             userInfo:(nullable NSDictionary *)userInfo
+{
+    self.conversionCount++;
+    
+    NSMutableDictionary *customUserInfo = [userInfo mutableCopy] ?: [NSMutableDictionary new];
+    customUserInfo[@"custom_description"] = errorDescription;
+    return [NSError errorWithDomain:[NSString stringWithFormat:@"custom_%@", domain] code:1000 + code userInfo:customUserInfo];
+}
+
+- (NSString *)oauthErrorKey
+{
+    return @"custom_oautherror";
+}
+
+- (nonnull NSString *)subErrorKey
+{
+    return @"custom_suberror";
+}
+
+@end
+
+@interface MSIDLazyErrorTests : XCTestCase
+
+@end
+
+@implementation MSIDLazyErrorTests
+
+- (void)setUp
+{
+    [super setUp];
+    MSIDLazyError.lazyConstructionEnabled = YES;
+}
+
+- (void)tearDown
+{
+    MSIDLazyError.lazyConstructionEnabled = NO;
+    MSIDLazyError.auditEnabled = NO;
+    [MSIDLazyError resetAuditCounters];
+    MSIDErrorConverter.errorConverter = nil;
+    [super tearDown];
+}
+
+#pragma mark - Tests
+
+- (void)testCreateError_whenLazyConstructionDisabled_shouldReturnRegularError
+{
+    MSIDLazyError.lazyConstructionEnabled = NO;
+    
+    NSError *error = MSIDCreateError(@"TestDomain", -5555, @"Test description", nil, nil, nil, nil, nil, NO);
+    
+    XCTAssertFalse([error isKindOfClass:MSIDLazyError.class]);
+}
+
+- (void)testCreateError_whenDefaultConverter_shouldReturnDomainAndCodeWithoutMaterializing
+{
+    NSError *error = MSIDCreateError(@"TestDomain", -5555, @"Test description", nil, nil, nil, nil, nil, NO);
+    
+    XCTAssertTrue([error isKindOfClass:MSIDLazyError.class]);
+    XCTAssertEqualObjects(error.domain, @"TestDomain");
+    XCTAssertEqual(error.code, -5555);
+    XCTAssertFalse(((MSIDLazyError *)error).isMaterialized);
+}
+
+- (void)testCreateError_whenUserInfoAccessed_shouldMatchEagerError
+{
+    NSError *underlyingError = [NSError errorWithDomain:@"UnderlyingDomain" code:-5556 userInfo:nil];
+    NSUUID *correlationId = [NSUUID UUID];
+    NSDictionary *additionalUserInfo = @{MSIDErrorMethodAndLineKey : @"method [Line 1]"};
+    
+    NSError *lazyError = MSIDCreateError(@"TestDomain", -5555, @"Test description", @"oauth_error", @"suberror", underlyingError, correlationId, additionalUserInfo, NO);
+    
+    MSIDLazyError.lazyConstructionEnabled = NO;
+    NSError *eagerError = MSIDCreateError(@"TestDomain", -5555, @"Test description", @"oauth_error", @"suberror", underlyingError, correlationId, additionalUserInfo, NO);
+    
+    XCTAssertEqualObjects(lazyError.userInfo, eagerError.userInfo);
+    XCTAssertTrue(((MSIDLazyError *)lazyError).isMaterialized);
+    XCTAssertEqualObjects(lazyError, eagerError);
+    XCTAssertEqualObjects(lazyError.localizedDescription, eagerError.localizedDescription);
+}
+
+- (void)testCreateError_whenCustomConverter_shouldConvertOnceOnFirstAccess
+{
+    MSIDLazyErrorTestConverter *converter = [MSIDLazyErrorTestConverter new];
+    MSIDErrorConverter.errorConverter = converter;
+    
+    NSError *error = MSIDCreateError(@"TestDomain", -5555, @"Test description", nil, nil, nil, nil, @{@"key" : @"value"}, NO);
+    
+    XCTAssertEqual(converter.conversionCount, 0);
+    XCTAssertEqualObjects(error.domain, @"custom_TestDomain");
+    XCTAssertEqual(error.code, -4555);
+    XCTAssertEqualObjects(error.userInfo[@"custom_description"], @"Test description");
+    XCTAssertEqualObjects(error.userInfo[@"key"], @"value");
+    XCTAssertEqual(converter.conversionCount, 1);
+}
+
+- (void)testCreateError_whenNilDomain_shouldReturnNil
+{
+    NSString *domain = nil;
+    
+    XCTAssertNil(MSIDCreateError(domain, 0, nil, nil, nil, nil, nil, nil, NO));
+}
+
+- (void)testArchiving_whenLazyError_shouldArchiveMaterializedError
+{
+    NSError *error = MSIDCreateError(@"TestDomain", -5555, @"Test description", nil, nil, nil, nil, nil, NO);
+    
+    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:error requiringSecureCoding:YES error:nil];
+    NSError *unarchivedError = [NSKeyedUnarchiver unarchivedObjectOfClass:NSError.class fromData:data error:nil];
+    
+    XCTAssertNotNil(unarchivedError);
+    XCTAssertFalse([unarchivedError isKindOfClass:MSIDLazyError.class]);
+    XCTAssertEqualObjects(unarchivedError.domain, @"TestDomain");
+    XCTAssertEqual(unarchivedError.code, -5555);
+    XCTAssertEqualObjects(unarchivedError.userInfo[MSIDErrorDescriptionKey], @"Test description");
+}
+
+- (void)testAudit_whenSomeErrorsInspected_shouldCountCreatedAndObservedErrors
+{
+    MSIDLazyError.auditEnabled = YES;
+    [MSIDLazyError resetAuditCounters];
+    
+    for (NSUInteger i = 0; i < 10; i++)
+    {
+        NSError *error = MSIDCreateError(@"TestDomain", (NSInteger)i, @"Test description", nil, nil, nil, nil, nil, NO);
+        
+        if (i % 4 == 0)
+        {
+            XCTAssertNotNil(error.userInfo);
+            // Inspecting twice is still one observation.
+            XCTAssertNotNil(error.userInfo);
+        }
+    }
+    
+    XCTAssertEqual(MSIDLazyError.createdCount, 10);
+    XCTAssertEqual(MSIDLazyError.observedCount, 3);
+}
+
+@end
+
+@interface MSIDLazyErrorBenchmarks : MSIDBenchmarkTestCase
+
+@end
+
+@implementation MSIDLazyErrorBenchmarks
+
+- (void)tearDown
+{
+    MSIDLazyError.lazyConstructionEnabled = NO;
+    [super tearDown];
+}
+
+#pragma mark - Benchmarks
+
+- (void)testDiscardedFallbackErrors_lazy_benchmark
+{
+    MSIDLazyError.lazyConstructionEnabled = YES;
+    [self benchmarkDiscardedFallbackErrors:@"discarded_fallback_errors_lazy"];
+}
+
+- (void)testDiscardedFallbackErrors_eager_benchmark
+{
+    MSIDLazyError.lazyConstructionEnabled = NO;
+    [self benchmarkDiscardedFallbackErrors:@"discarded_fallback_errors_eager"];
+}
+
+#pragma mark - Helpers
+
+// Mirrors the silent token path falling back through cache misses and unregistered factory lookups,
+// where every step creates an error that the caller drops.
+- (void)benchmarkDiscardedFallbackErrors:(NSString *)name
+{
+    NSUUID *correlationId = [NSUUID UUID];
+    
+    [self benchmark:name operations:1000 block:^{
+        __unused NSError *cacheError = MSIDCreateError(MSIDKeychainErrorDomain, -25300, @"Failed to read item from keychain.", nil, nil, nil, correlationId, @{MSIDErrorMethodAndLineKey : @"method [Line 1]"}, NO);
+        
+        NSError *factoryError = nil;
+        [MSIDJsonSerializableFactory createFromJSONDictionary:@{} classType:@"unregistered_type" assertKindOfClass:NSObject.class error:&factoryError];
+    }];
+}
+
+@end
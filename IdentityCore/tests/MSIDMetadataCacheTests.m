@@ -0,0 +1,324 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDMetadataCache.h"
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDAccountMetadataCacheItem.h"
+#import "MSIDAccountMetadataCacheKey.h"
+#import "MSIDCacheItemJsonSerializer.h"
+#import "MSIDBenchmarkTestCase.h"
+
+@interface MSIDLatencyInjectingMetadataDataSource : MSIDTestCacheDataSource
+
+@property (atomic) NSTimeInterval readLatency;
+@property (atomic) NSTimeInterval writeLatency;
+@property (atomic) dispatch_semaphore_t writeStartedSemaphore;
+@property (atomic) dispatch_semaphore_t removeStartedSemaphore;
+@property (atomic) dispatch_semaphore_t removeResumeSemaphore;
+@property (nonatomic, readonly) NSUInteger readCount;
+@property (nonatomic, readonly) NSUInteger writeCount;
+
+@end
+
+@implementation MSIDLatencyInjectingMetadataDataSource
+{
+    NSUInteger _readCount;
+    NSUInteger _writeCount;
+}
+
+- (NSUInteger)readCount
+{
+    @synchronized (self)
+    {
+        return _readCount;
+    }
+}
+
+- (NSUInteger)writeCount
+{
+    @synchronized (self)
+    {
+        return _writeCount;
+    }
+}
+
+- (MSIDAccountMetadataCacheItem *)accountMetadataWithKey:(MSIDCacheKey *)key
+                                              serializer:(id<MSIDExtendedCacheItemSerializing>)serializer
+                                                 context:(id<MSIDRequestContext>)context
+                                                   error:(NSError *__autoreleasing *)error
+{
+    @synchronized (self)
+    {
+        _readCount++;
+    }
+    
+    // Read first and then wait, so that writes landing during the latency make the result stale
+    MSIDAccountMetadataCacheItem *item = [super accountMetadataWithKey:key serializer:serializer context:context error:error];
+    [NSThread sleepForTimeInterval:self.readLatency];
+    return item;
+}
+
+- (BOOL)saveAccountMetadata:(MSIDAccountMetadataCacheItem *)item
+                        key:(MSIDCacheKey *)key
+                 serializer:(id<MSIDExtendedCacheItemSerializing>)serializer
+                    context:(id<MSIDRequestContext>)context
+                      error:(NSError *__autoreleasing *)error
+{
+    @synchronized (self)
+    {
+        _writeCount++;
+    }
+    
+    if (self.writeStartedSemaphore) dispatch_semaphore_signal(self.writeStartedSemaphore);
+    [NSThread sleepForTimeInterval:self.writeLatency];
+    return [super saveAccountMetadata:(MSIDAccountMetadata *)item key:key serializer:serializer context:context error:error];
+}
+
+- (BOOL)removeAccountMetadataForKey:(MSIDCacheKey *)key
+                            context:(id<MSIDRequestContext>)context
+                              error:(NSError *__autoreleasing *)error
+{
+    if (self.removeStartedSemaphore) dispatch_semaphore_signal(self.removeStartedSemaphore);
+    if (self.removeResumeSemaphore) dispatch_semaphore_wait(self.removeResumeSemaphore, DISPATCH_TIME_FOREVER);
+    return [super removeAccountMetadataForKey:key context:context error:error];
+}
+
+@end
+
+@interface MSIDMetadataCacheTests : XCTestCase
+
+@property (nonatomic) MSIDLatencyInjectingMetadataDataSource *dataSource;
+@property (nonatomic) MSIDMetadataCache *metadataCache;
+@property (nonatomic) MSIDAccountMetadataCacheKey *key;
+
+@end
+
+@implementation MSIDMetadataCacheTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    self.dataSource = [MSIDLatencyInjectingMetadataDataSource new];
+    self.metadataCache = [[MSIDMetadataCache alloc] initWithPersistentDataSource:self.dataSource];
+    self.key = [[MSIDAccountMetadataCacheKey alloc] initWithClientId:@"client"];
+}
+
+#pragma mark - Reads
+
+- (void)testAccountMetadataCacheItem_whenConcurrentMissesForSameKey_shouldReadStorageOnce
+{
+    XCTAssertTrue([self.dataSource saveAccountMetadata:[self itemWithEnvironment:@"login.microsoftonline.com"] key:self.key serializer:[MSIDCacheItemJsonSerializer new] context:nil error:nil]);
+    self.dataSource.readLatency = 0.2;
+    
+    NSMutableArray *results = [NSMutableArray new];
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(__unused size_t i) {
+        MSIDAccountMetadataCacheItem *item = [self.metadataCache accountMetadataCacheItemWithKey:self.key context:nil error:nil];
+        @synchronized (results)
+        {
+            [results addObject:item ?: [NSNull null]];
+        }
+    });
+    
+    XCTAssertEqual(self.dataSource.readCount, 1u);
+    XCTAssertEqual(results.count, 8u);
+    for (id item in results)
+    {
+        XCTAssertEqualObjects([item principalAccountEnvironment], @"login.microsoftonline.com");
+    }
+}
+
+- (void)testAccountMetadataCacheItem_whenWriteInProgress_shouldNotWaitForStorage
+{
+    XCTAssertTrue([self.metadataCache saveAccountMetadataCacheItem:[self itemWithEnvironment:@"env1"] key:self.key context:nil error:nil]);
+    self.dataSource.writeLatency = 1;
+    self.dataSource.writeStartedSemaphore = dispatch_semaphore_create(0);
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Save completed"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        [self.metadataCache saveAccountMetadataCacheItem:[self itemWithEnvironment:@"env2"] key:self.key context:nil error:nil];
+        [expectation fulfill];
+    });
+    dispatch_semaphore_wait(self.dataSource.writeStartedSemaphore, DISPATCH_TIME_FOREVER);
+    
+    NSDate *start = [NSDate date];
+    MSIDAccountMetadataCacheItem *item = [self.metadataCache accountMetadataCacheItemWithKey:self.key context:nil error:nil];
+    NSTimeInterval elapsed = -[start timeIntervalSinceNow];
+    
+    XCTAssertEqualObjects(item.principalAccountEnvironment, @"env1");
+    XCTAssertLessThan(elapsed, 0.5);
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    item = [self.metadataCache accountMetadataCacheItemWithKey:self.key context:nil error:nil];
+    XCTAssertEqualObjects(item.principalAccountEnvironment, @"env2");
+}
+
+- (void)testAccountMetadataCacheItem_whenSaveCompletesDuringRead_shouldNotInstallStaleItem
+{
+    XCTAssertTrue([self.dataSource saveAccountMetadata:[self itemWithEnvironment:@"stale"] key:self.key serializer:[MSIDCacheItemJsonSerializer new] context:nil error:nil]);
+    self.dataSource.readLatency = 0.5;
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Read completed"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        MSIDAccountMetadataCacheItem *item = [self.metadataCache accountMetadataCacheItemWithKey:self.key context:nil error:nil];
+        XCTAssertEqualObjects(item.principalAccountEnvironment, @"stale");
+        [expectation fulfill];
+    });
+    
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertTrue([self.metadataCache saveAccountMetadataCacheItem:[self itemWithEnvironment:@"fresh"] key:self.key context:nil error:nil]);
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    self.dataSource.readLatency = 0;
+    MSIDAccountMetadataCacheItem *item = [self.metadataCache accountMetadataCacheItemWithKey:self.key context:nil error:nil];
+    XCTAssertEqualObjects(item.principalAccountEnvironment, @"fresh");
+}
+
+#pragma mark - Writes
+
+- (void)testSaveAccountMetadataCacheItem_whenBurstOfSavesWhileWriting_shouldCoalesceWrites
+{
+    self.dataSource.writeLatency = 0.3;
+    self.dataSource.writeStartedSemaphore = dispatch_semaphore_create(0);
+    
+    XCTestExpectation *firstSave = [self expectationWithDescription:@"First save completed"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        XCTAssertTrue([self.metadataCache saveAccountMetadataCacheItem:[self itemWithEnvironment:@"first"] key:self.key context:nil error:nil]);
+        [firstSave fulfill];
+    });
+    dispatch_semaphore_wait(self.dataSource.writeStartedSemaphore, DISPATCH_TIME_FOREVER);
+    self.dataSource.writeStartedSemaphore = nil;
+    
+    __block NSUInteger failures = 0;
+    dispatch_apply(5, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        NSString *environment = [NSString stringWithFormat:@"burst%zu", i];
+        if (![self.metadataCache saveAccountMetadataCacheItem:[self itemWithEnvironment:environment] key:self.key context:nil error:nil])
+        {
+            @synchronized (self)
+            {
+                failures++;
+            }
+        }
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    XCTAssertEqual(failures, 0u);
+    XCTAssertEqual(self.dataSource.writeCount, 2u);
+    
+    MSIDAccountMetadataCacheItem *persisted = [self.dataSource accountMetadataWithKey:self.key serializer:[MSIDCacheItemJsonSerializer new] context:nil error:nil];
+    MSIDAccountMetadataCacheItem *cached = [self.metadataCache accountMetadataCacheItemWithKey:self.key context:nil error:nil];
+    XCTAssertTrue([persisted.principalAccountEnvironment hasPrefix:@"burst"]);
+    XCTAssertEqualObjects(cached, persisted);
+}
+
+- (void)testRemoveAccountMetadataCacheItem_whenCached_shouldRemoveFromMemoryAndStorage
+{
+    XCTAssertTrue([self.metadataCache saveAccountMetadataCacheItem:[self itemWithEnvironment:@"env1"] key:self.key context:nil error:nil]);
+    
+    XCTAssertTrue([self.metadataCache removeAccountMetadataCacheItemForKey:self.key context:nil error:nil]);
+    
+    XCTAssertNil([self.metadataCache accountMetadataCacheItemWithKey:self.key context:nil error:nil]);
+    XCTAssertEqual(self.dataSource.readCount, 1u);
+}
+
+- (void)testRemoveAccountMetadataCacheItem_whenLoadRacesRemoval_shouldNotReinstallRemovedItem
+{
+    XCTAssertTrue([self.dataSource saveAccountMetadata:[self itemWithEnvironment:@"removed"] key:self.key serializer:[MSIDCacheItemJsonSerializer new] context:nil error:nil]);
+    self.dataSource.removeStartedSemaphore = dispatch_semaphore_create(0);
+    self.dataSource.removeResumeSemaphore = dispatch_semaphore_create(0);
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Remove completed"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        XCTAssertTrue([self.metadataCache removeAccountMetadataCacheItemForKey:self.key context:nil error:nil]);
+        [expectation fulfill];
+    });
+    dispatch_semaphore_wait(self.dataSource.removeStartedSemaphore, DISPATCH_TIME_FOREVER);
+    
+    // The item is still in storage, so this load reads it after the removal has started
+    MSIDAccountMetadataCacheItem *item = [self.metadataCache accountMetadataCacheItemWithKey:self.key context:nil error:nil];
+    XCTAssertEqualObjects(item.principalAccountEnvironment, @"removed");
+    
+    dispatch_semaphore_signal(self.dataSource.removeResumeSemaphore);
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    XCTAssertNil([self.metadataCache accountMetadataCacheItemWithKey:self.key context:nil error:nil]);
+    XCTAssertNil([self.metadataCache allAccountMetadataCacheItemsWithContext:nil error:nil].firstObject);
+}
+
+#pragma mark - Helpers
+
+- (MSIDAccountMetadataCacheItem *)itemWithEnvironment:(NSString *)environment
+{
+    MSIDAccountMetadataCacheItem *item = [[MSIDAccountMetadataCacheItem alloc] initWithClientId:@"client"];
+    item.principalAccountEnvironment = environment;
+    return item;
+}
+
+@end
+
+@interface MSIDMetadataCacheBenchmarks : MSIDBenchmarkTestCase
+
+@end
+
+@implementation MSIDMetadataCacheBenchmarks
+
+#pragma mark - Benchmarks
+
+- (void)testConcurrentReadsAndWrites_withStorageLatency_benchmark
+{
+    MSIDLatencyInjectingMetadataDataSource *dataSource = [MSIDLatencyInjectingMetadataDataSource new];
+    dataSource.readLatency = 0.002;
+    dataSource.writeLatency = 0.005;
+    MSIDMetadataCache *metadataCache = [[MSIDMetadataCache alloc] initWithPersistentDataSource:dataSource];
+    
+    NSArray<NSString *> *clientIds = @[@"client1", @"client2", @"client3"];
+    NSMutableArray<MSIDAccountMetadataCacheKey *> *keys = [NSMutableArray new];
+    for (NSString *clientId in clientIds)
+    {
+        [keys addObject:[[MSIDAccountMetadataCacheKey alloc] initWithClientId:clientId]];
+    }
+    
+    [self benchmark:@"metadata_cache_concurrent_reads_and_writes" operations:1 block:^{
+        dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+            for (NSUInteger i = 0; i < 200; i++)
+            {
+                NSUInteger index = (thread + i) % keys.count;
+                MSIDAccountMetadataCacheKey *key = keys[index];
+                if (thread == 0 && i % 10 == 0)
+                {
+                    MSIDAccountMetadataCacheItem *item = [[MSIDAccountMetadataCacheItem alloc] initWithClientId:clientIds[index]];
+                    item.principalAccountEnvironment = [NSString stringWithFormat:@"env%lu", (unsigned long)i];
+                    [metadataCache saveAccountMetadataCacheItem:item key:key context:nil error:nil];
+                }
+                else
+                {
+                    [metadataCache accountMetadataCacheItemWithKey:key context:nil error:nil];
+                }
+            }
+        });
+    }];
+}
+
+@end
@@ -0,0 +1,423 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDMetadataResponseCache.h"
+
+@interface MSIDMetadataResponseCacheTests : XCTestCase
+
+@property (nonatomic) NSURL *directoryURL;
+@property (nonatomic) NSDate *now;
+
+@end
+
+@implementation MSIDMetadataResponseCacheTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.directoryURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString isDirectory:YES];
+    self.now = [NSDate dateWithTimeIntervalSince1970:1700000000];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtURL:self.directoryURL error:nil];
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (MSIDMetadataResponseCache *)cacheWithDirectory:(NSURL *)directoryURL maxEntryCount:(NSUInteger)maxEntryCount maxTotalBytes:(NSUInteger)maxTotalBytes
+{
+    MSIDMetadataResponseCache *cache = [[MSIDMetadataResponseCache alloc] initWithDirectoryURL:directoryURL maxEntryCount:maxEntryCount maxTotalBytes:maxTotalBytes];
+    __weak typeof(self) weakSelf = self;
+    cache.dateProvider = ^NSDate *{ return weakSelf.now; };
+    return cache;
+}
+
+- (MSIDMetadataResponseCache *)memoryCache
+{
+    return [self cacheWithDirectory:nil maxEntryCount:10 maxTotalBytes:1024 * 1024];
+}
+
+- (NSURLRequest *)requestWithPath:(NSString *)path
+{
+    NSString *urlString = [NSString stringWithFormat:@"https://login.microsoftonline.com/%@", path];
+    return [NSURLRequest requestWithURL:[NSURL URLWithString:urlString]];
+}
+
+- (NSCachedURLResponse *)responseForRequest:(NSURLRequest *)request headers:(NSDictionary *)headers data:(NSData *)data
+{
+    NSHTTPURLResponse *httpResponse = [[NSHTTPURLResponse alloc] initWithURL:request.URL statusCode:200 HTTPVersion:nil headerFields:headers];
+    return [[NSCachedURLResponse alloc] initWithResponse:httpResponse data:data ?: [@"{}" dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+- (void)storeResponseWithHeaders:(NSDictionary *)headers forRequest:(NSURLRequest *)request inCache:(MSIDMetadataResponseCache *)cache
+{
+    [cache storeCachedResponse:[self responseForRequest:request headers:headers data:nil] forRequest:request];
+}
+
+- (MSIDMetadataResponseCache *)loadedCacheWithDirectory:(NSURL *)directoryURL
+{
+    MSIDMetadataResponseCache *cache = [self cacheWithDirectory:directoryURL maxEntryCount:10 maxTotalBytes:1024];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"persisted responses loaded"];
+    [cache loadPersistedResponsesWithCompletionBlock:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    return cache;
+}
+
+- (void)waitForDiskWrites
+{
+    // Pending writes are flushed before persisted entries are read, so loading a second cache is a sufficient barrier.
+    [self loadedCacheWithDirectory:self.directoryURL];
+}
+
+#pragma mark - Freshness
+
+- (void)testIsCachedResponseFresh_whenMaxAgeNotElapsed_shouldReturnYes
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    NSURLRequest *request = [self requestWithPath:@"common/v2.0/.well-known/openid-configuration"];
+    [self storeResponseWithHeaders:@{@"Cache-Control": @"public, max-age=60"} forRequest:request inCache:cache];
+    
+    self.now = [self.now dateByAddingTimeInterval:59];
+    XCTAssertTrue([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+    
+    self.now = [self.now dateByAddingTimeInterval:1];
+    XCTAssertFalse([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+}
+
+- (void)testIsCachedResponseFresh_shouldSubtractAgeHeader
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    NSURLRequest *request = [self requestWithPath:@"common/discovery/instance"];
+    [self storeResponseWithHeaders:@{@"cache-control": @"max-age=60", @"age": @"50"} forRequest:request inCache:cache];
+    
+    self.now = [self.now dateByAddingTimeInterval:11];
+    
+    XCTAssertFalse([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+}
+
+- (void)testIsCachedResponseFresh_whenNoCache_shouldReturnNo
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    NSURLRequest *request = [self requestWithPath:@"common/discovery/instance"];
+    [self storeResponseWithHeaders:@{@"Cache-Control": @"no-cache", @"ETag": @"\"v1\""} forRequest:request inCache:cache];
+    
+    NSCachedURLResponse *cachedResponse = [cache cachedResponseForRequest:request];
+    
+    XCTAssertNotNil(cachedResponse);
+    XCTAssertFalse([cache isCachedResponseFresh:cachedResponse]);
+}
+
+- (void)testIsCachedResponseFresh_whenExpiresInFuture_shouldUseExpiresRelativeToDate
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    NSURLRequest *request = [self requestWithPath:@"contoso.com/.well-known/webfinger"];
+    [self storeResponseWithHeaders:@{@"Date": @"Tue, 14 Nov 2023 22:13:20 GMT",
+                                     @"Expires": @"Tue, 14 Nov 2023 22:23:20 GMT"}
+                        forRequest:request
+                           inCache:cache];
+    
+    self.now = [self.now dateByAddingTimeInterval:599];
+    XCTAssertTrue([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+    
+    self.now = [self.now dateByAddingTimeInterval:1];
+    XCTAssertFalse([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+}
+
+- (void)testIsCachedResponseFresh_whenExpiresInvalid_shouldTreatAsExpired
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    NSURLRequest *request = [self requestWithPath:@"contoso.com/.well-known/webfinger"];
+    [self storeResponseWithHeaders:@{@"Expires": @"0"} forRequest:request inCache:cache];
+    
+    XCTAssertFalse([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+}
+
+- (void)testIsCachedResponseFresh_whenNoFreshnessHeaders_shouldUseDefaultLifetime
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    cache.defaultFreshnessLifetime = 100;
+    NSURLRequest *request = [self requestWithPath:@"enrollmentserver/contract"];
+    [self storeResponseWithHeaders:nil forRequest:request inCache:cache];
+    
+    self.now = [self.now dateByAddingTimeInterval:99];
+    XCTAssertTrue([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+    
+    self.now = [self.now dateByAddingTimeInterval:1];
+    XCTAssertFalse([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+}
+
+- (void)testIsCachedResponseFresh_whenMaxAgeAboveCap_shouldUseCap
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    cache.maxFreshnessLifetime = 10;
+    NSURLRequest *request = [self requestWithPath:@"common/discovery/instance"];
+    [self storeResponseWithHeaders:@{@"Cache-Control": @"max-age=86400"} forRequest:request inCache:cache];
+    
+    self.now = [self.now dateByAddingTimeInterval:10];
+    
+    XCTAssertFalse([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+}
+
+#pragma mark - Store
+
+- (void)testStore_whenNoStore_shouldNotStoreAndRemoveExisting
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    NSURLRequest *request = [self requestWithPath:@"common/discovery/instance"];
+    [self storeResponseWithHeaders:nil forRequest:request inCache:cache];
+    
+    [self storeResponseWithHeaders:@{@"Cache-Control": @"private, no-store"} forRequest:request inCache:cache];
+    
+    XCTAssertNil([cache cachedResponseForRequest:request]);
+}
+
+- (void)testStore_whenPostRequest_shouldNotStore
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    NSMutableURLRequest *request = [[self requestWithPath:@"common/oauth2/v2.0/token"] mutableCopy];
+    request.HTTPMethod = @"POST";
+    
+    [self storeResponseWithHeaders:nil forRequest:request inCache:cache];
+    
+    XCTAssertEqual(cache.entryCount, 0u);
+}
+
+- (void)testStore_whenEntryCountExceeded_shouldEvictLeastRecentlyUsed
+{
+    MSIDMetadataResponseCache *cache = [self cacheWithDirectory:nil maxEntryCount:2 maxTotalBytes:1024];
+    NSURLRequest *first = [self requestWithPath:@"1"];
+    NSURLRequest *second = [self requestWithPath:@"2"];
+    NSURLRequest *third = [self requestWithPath:@"3"];
+    [self storeResponseWithHeaders:nil forRequest:first inCache:cache];
+    [self storeResponseWithHeaders:nil forRequest:second inCache:cache];
+    
+    // Touch the first entry so the second one becomes least recently used.
+    XCTAssertNotNil([cache cachedResponseForRequest:first]);
+    [self storeResponseWithHeaders:nil forRequest:third inCache:cache];
+    
+    XCTAssertNotNil([cache cachedResponseForRequest:first]);
+    XCTAssertNil([cache cachedResponseForRequest:second]);
+    XCTAssertNotNil([cache cachedResponseForRequest:third]);
+    XCTAssertEqual(cache.statistics.evictionCount, 1u);
+}
+
+- (void)testStore_whenTotalBytesExceeded_shouldEvictUntilWithinBound
+{
+    MSIDMetadataResponseCache *cache = [self cacheWithDirectory:nil maxEntryCount:10 maxTotalBytes:100];
+    NSData *data = [NSMutableData dataWithLength:40];
+    
+    for (NSString *path in @[@"1", @"2", @"3"])
+    {
+        NSURLRequest *request = [self requestWithPath:path];
+        [cache storeCachedResponse:[self responseForRequest:request headers:nil data:data] forRequest:request];
+    }
+    
+    XCTAssertEqual(cache.entryCount, 2u);
+    XCTAssertEqual(cache.totalBytes, 80u);
+    XCTAssertNil([cache cachedResponseForRequest:[self requestWithPath:@"1"]]);
+}
+
+#pragma mark - Revalidation
+
+- (void)testConditionalHeaders_shouldUseETagAndLastModified
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    NSURLRequest *request = [self requestWithPath:@"common/discovery/instance"];
+    [self storeResponseWithHeaders:@{@"etag": @"\"v1\"", @"Last-Modified": @"Tue, 14 Nov 2023 22:13:20 GMT"} forRequest:request inCache:cache];
+    
+    NSDictionary *headers = [cache conditionalHeadersForCachedResponse:[cache cachedResponseForRequest:request]];
+    
+    XCTAssertEqualObjects(headers, (@{@"If-None-Match": @"\"v1\"", @"If-Modified-Since": @"Tue, 14 Nov 2023 22:13:20 GMT"}));
+}
+
+- (void)testConditionalHeaders_whenNoValidators_shouldReturnEmpty
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    NSURLRequest *request = [self requestWithPath:@"common/discovery/instance"];
+    [self storeResponseWithHeaders:@{@"Cache-Control": @"max-age=1"} forRequest:request inCache:cache];
+    
+    XCTAssertEqual([cache conditionalHeadersForCachedResponse:[cache cachedResponseForRequest:request]].count, 0u);
+}
+
+- (void)testRefreshWithNotModifiedResponse_shouldRestartLifetimeAndKeepData
+{
+    MSIDMetadataResponseCache *cache = [self memoryCache];
+    NSURLRequest *request = [self requestWithPath:@"common/discovery/instance"];
+    NSData *data = [@"{\"tenant_discovery_endpoint\":\"x\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    [cache storeCachedResponse:[self responseForRequest:request headers:@{@"Cache-Control": @"max-age=10", @"ETag": @"\"v1\""} data:data] forRequest:request];
+    self.now = [self.now dateByAddingTimeInterval:20];
+    XCTAssertFalse([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+    
+    NSHTTPURLResponse *notModified = [[NSHTTPURLResponse alloc] initWithURL:request.URL statusCode:304 HTTPVersion:nil headerFields:@{@"cache-control": @"max-age=30", @"ETag": @"\"v2\""}];
+    NSCachedURLResponse *refreshed = [cache refreshCachedResponseForRequest:request withNotModifiedResponse:notModified];
+    
+    XCTAssertEqualObjects(refreshed.data, data);
+    XCTAssertEqual(((NSHTTPURLResponse *)refreshed.response).statusCode, 200);
+    XCTAssertTrue([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+    XCTAssertEqualObjects([cache conditionalHeadersForCachedResponse:refreshed][@"If-None-Match"], @"\"v2\"");
+    XCTAssertEqual(cache.statistics.notModifiedCount, 1u);
+    
+    self.now = [self.now dateByAddingTimeInterval:30];
+    XCTAssertFalse([cache isCachedResponseFresh:[cache cachedResponseForRequest:request]]);
+}
+
+#pragma mark - Persistence
+
+- (void)testPersistence_whenNewInstanceWithSameDirectory_shouldLoadEntries
+{
+    MSIDMetadataResponseCache *cache = [self cacheWithDirectory:self.directoryURL maxEntryCount:10 maxTotalBytes:1024];
+    NSURLRequest *request = [self requestWithPath:@"common/v2.0/.well-known/openid-configuration"];
+    NSData *data = [@"{\"issuer\":\"https://login.microsoftonline.com/{tenantid}/v2.0\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    [cache storeCachedResponse:[self responseForRequest:request headers:@{@"Cache-Control": @"max-age=60", @"ETag": @"\"v1\""} data:data] forRequest:request];
+    
+    MSIDMetadataResponseCache *reloadedCache = [self loadedCacheWithDirectory:self.directoryURL];
+    NSCachedURLResponse *reloaded = [reloadedCache cachedResponseForRequest:request];
+    
+    XCTAssertEqualObjects(reloaded.data, data);
+    XCTAssertEqualObjects([reloadedCache conditionalHeadersForCachedResponse:reloaded][@"If-None-Match"], @"\"v1\"");
+    XCTAssertTrue([reloadedCache isCachedResponseFresh:reloaded]);
+    
+    self.now = [self.now dateByAddingTimeInterval:60];
+    XCTAssertFalse([reloadedCache isCachedResponseFresh:reloaded]);
+}
+
+- (void)testPersistence_whenRemoved_shouldNotLoadEntry
+{
+    MSIDMetadataResponseCache *cache = [self cacheWithDirectory:self.directoryURL maxEntryCount:10 maxTotalBytes:1024];
+    NSURLRequest *request = [self requestWithPath:@"common/discovery/instance"];
+    [self storeResponseWithHeaders:nil forRequest:request inCache:cache];
+    [self waitForDiskWrites];
+    
+    [cache removeCachedResponseForRequest:request];
+    
+    MSIDMetadataResponseCache *reloadedCache = [self loadedCacheWithDirectory:self.directoryURL];
+    XCTAssertNil([reloadedCache cachedResponseForRequest:request]);
+}
+
+- (void)testPersistence_whenCorruptedFile_shouldSkipIt
+{
+    [[NSFileManager defaultManager] createDirectoryAtURL:self.directoryURL withIntermediateDirectories:YES attributes:nil error:nil];
+    [[@"garbage" dataUsingEncoding:NSUTF8StringEncoding] writeToURL:[self.directoryURL URLByAppendingPathComponent:@"corrupted"] atomically:YES];
+    
+    MSIDMetadataResponseCache *cache = [self loadedCacheWithDirectory:self.directoryURL];
+    
+    XCTAssertEqual(cache.entryCount, 0u);
+}
+
+- (void)testPersistence_whenRecordDataTampered_shouldDiscardIt
+{
+    NSURLRequest *request = [self requestWithPath:@"common/v2.0/.well-known/openid-configuration"];
+    [self storeResponseWithHeaders:@{@"Cache-Control": @"max-age=60"} forRequest:request inCache:[self cacheWithDirectory:self.directoryURL maxEntryCount:10 maxTotalBytes:1024]];
+    [self waitForDiskWrites];
+    
+    NSURL *fileURL = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:self.directoryURL includingPropertiesForKeys:nil options:0 error:nil].firstObject;
+    NSMutableDictionary *record = [[NSPropertyListSerialization propertyListWithData:[NSData dataWithContentsOfURL:fileURL] options:NSPropertyListMutableContainers format:nil error:nil] mutableCopy];
+    record[@"data"] = [@"{\"issuer\":\"https://evil.example.com\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    [[NSPropertyListSerialization dataWithPropertyList:record format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil] writeToURL:fileURL atomically:YES];
+    
+    MSIDMetadataResponseCache *cache = [self loadedCacheWithDirectory:self.directoryURL];
+    
+    XCTAssertNil([cache cachedResponseForRequest:request]);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:fileURL.path]);
+}
+
+- (void)testPersistence_whenRecordPlantedUnderOtherFileName_shouldDiscardIt
+{
+    NSURLRequest *request = [self requestWithPath:@"common/discovery/instance"];
+    [self storeResponseWithHeaders:@{@"Cache-Control": @"max-age=60"} forRequest:request inCache:[self cacheWithDirectory:self.directoryURL maxEntryCount:10 maxTotalBytes:1024]];
+    [self waitForDiskWrites];
+    
+    NSURL *fileURL = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:self.directoryURL includingPropertiesForKeys:nil options:0 error:nil].firstObject;
+    NSURL *plantedURL = [self.directoryURL URLByAppendingPathComponent:@"planted"];
+    XCTAssertTrue([[NSFileManager defaultManager] copyItemAtURL:fileURL toURL:plantedURL error:nil]);
+    
+    MSIDMetadataResponseCache *cache = [self loadedCacheWithDirectory:self.directoryURL];
+    
+    XCTAssertEqual(cache.entryCount, 1u);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:plantedURL.path]);
+}
+
+- (void)testCachedResponse_whenPersistedEntriesNotLoaded_shouldMissWithoutWaitingForDisk
+{
+    NSURLRequest *request = [self requestWithPath:@"common/discovery/instance"];
+    [self storeResponseWithHeaders:@{@"Cache-Control": @"max-age=60"} forRequest:request inCache:[self cacheWithDirectory:self.directoryURL maxEntryCount:10 maxTotalBytes:1024]];
+    [self waitForDiskWrites];
+    
+    MSIDMetadataResponseCache *cache = [self cacheWithDirectory:self.directoryURL maxEntryCount:10 maxTotalBytes:1024];
+    XCTAssertNil([cache cachedResponseForRequest:request]);
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"persisted responses loaded"];
+    [cache loadPersistedResponsesWithCompletionBlock:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    XCTAssertNotNil([cache cachedResponseForRequest:request]);
+}
+
+- (void)testPersistence_whenResponseURLDiffersFromRequestURL_shouldLoadEntryForRequest
+{
+    NSURLRequest *request = [self requestWithPath:@"common/v2.0/.well-known/openid-configuration"];
+    NSURL *redirectedURL = [NSURL URLWithString:@"https://login.microsoftonline.com/organizations/v2.0/.well-known/openid-configuration"];
+    NSHTTPURLResponse *httpResponse = [[NSHTTPURLResponse alloc] initWithURL:redirectedURL statusCode:200 HTTPVersion:nil headerFields:@{@"Cache-Control": @"max-age=60"}];
+    NSData *data = [@"{\"issuer\":\"v1\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    MSIDMetadataResponseCache *cache = [self cacheWithDirectory:self.directoryURL maxEntryCount:10 maxTotalBytes:1024];
+    [cache storeCachedResponse:[[NSCachedURLResponse alloc] initWithResponse:httpResponse data:data] forRequest:request];
+    
+    MSIDMetadataResponseCache *reloadedCache = [self loadedCacheWithDirectory:self.directoryURL];
+    
+    XCTAssertEqualObjects([reloadedCache cachedResponseForRequest:request].data, data);
+    XCTAssertNil([reloadedCache cachedResponseForRequest:[NSURLRequest requestWithURL:redirectedURL]]);
+}
+
+- (void)testPersistence_whenStoredBeforeLoadCompleted_shouldKeepNewerResponse
+{
+    NSURLRequest *request = [self requestWithPath:@"common/discovery/instance"];
+    NSData *newData = [@"{\"v\":2}" dataUsingEncoding:NSUTF8StringEncoding];
+    [[self cacheWithDirectory:self.directoryURL maxEntryCount:10 maxTotalBytes:1024] storeCachedResponse:[self responseForRequest:request headers:nil data:[@"{\"v\":1}" dataUsingEncoding:NSUTF8StringEncoding]] forRequest:request];
+    [self waitForDiskWrites];
+    
+    MSIDMetadataResponseCache *cache = [self cacheWithDirectory:self.directoryURL maxEntryCount:10 maxTotalBytes:1024];
+    XCTAssertNil([cache cachedResponseForRequest:request]);
+    [cache storeCachedResponse:[self responseForRequest:request headers:nil data:newData] forRequest:request];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"persisted responses loaded"];
+    [cache loadPersistedResponsesWithCompletionBlock:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    XCTAssertEqualObjects([cache cachedResponseForRequest:request].data, newData);
+    XCTAssertEqual(cache.entryCount, 1u);
+}
+
+@end
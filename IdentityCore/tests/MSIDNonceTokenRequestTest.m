@@ -328,6 +328,124 @@
     [self waitForExpectationsWithTimeout:1 handler:nil];
 }
 
+#pragma mark - Single flight
+
+- (void)testExecuteRequestWithCompletion_whenConcurrentRequestsForSameEnvironment_shouldSendSingleNonceRequest
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self testRequestParameters];
+    // Only one nonce response is registered, any additional nonce request fails.
+    [MSIDTestURLSession addResponse:[self nonceResponseWithParameters:parameters nonce:@"1234_nonce_abcd"]];
+    
+    NSUInteger requestCount = 5;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Acquire Nonce."];
+    expectation.expectedFulfillmentCount = requestCount;
+    
+    for (NSUInteger i = 0; i < requestCount; i++)
+    {
+        MSIDNonceTokenRequest *request = [[MSIDNonceTokenRequest alloc] initWithRequestParameters:parameters];
+        [request executeRequestWithCompletion:^(NSString * _Nullable resultNonce, NSError * _Nullable error)
+        {
+            XCTAssertNil(error);
+            XCTAssertEqualObjects(resultNonce, @"1234_nonce_abcd");
+            [expectation fulfill];
+        }];
+    }
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    XCTAssertTrue([MSIDTestURLSession noResponsesLeft]);
+}
+
+- (void)testExecuteRequestWithCompletion_whenSingleFlightFetchFails_shouldReturnErrorToAllWaiters
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self testRequestParameters];
+    NSError *nonceError = [[NSError alloc] initWithDomain:@"Test domain" code:-1 userInfo:nil];
+    MSIDTestURLResponse *nonceResponse = [MSIDTestURLResponse request:parameters.authority.metadata.tokenEndpoint
+                                                     respondWithError:nonceError];
+    nonceResponse->_requestHeaders = [self mockedRequestHeaders];
+    [MSIDTestURLSession addResponse:nonceResponse];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Acquire Nonce."];
+    expectation.expectedFulfillmentCount = 2;
+    
+    for (NSUInteger i = 0; i < 2; i++)
+    {
+        MSIDNonceTokenRequest *request = [[MSIDNonceTokenRequest alloc] initWithRequestParameters:parameters];
+        [request executeRequestWithCompletion:^(NSString * _Nullable resultNonce, NSError * _Nullable error)
+        {
+            XCTAssertNil(resultNonce);
+            XCTAssertEqualObjects(error.domain, @"Test domain");
+            [expectation fulfill];
+        }];
+    }
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+}
+
+- (void)testExecuteRequestWithCompletion_whenCachedNonceCloseToExpiry_shouldReturnCachedNonceAndRefreshItInBackground
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self testRequestParameters];
+    
+    MSIDCachedNonce *cachedNonce = [[MSIDCachedNonce alloc] initWithNonce:@"my-nonce"];
+    [cachedNonce setValue:[[NSDate new] dateByAddingTimeInterval:-150] forKey:@"cachedDate"];
+    MSIDCache *nonceCache = [MSIDNonceTokenRequest.class nonceCache];
+    [nonceCache setObject:cachedNonce forKey:parameters.authority.environment];
+    
+    [MSIDTestURLSession addResponse:[self nonceResponseWithParameters:parameters nonce:@"1234_nonce_abcd"]];
+    
+    MSIDNonceTokenRequest *request = [[MSIDNonceTokenRequest alloc] initWithRequestParameters:parameters];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Return cached Nonce."];
+    [request executeRequestWithCompletion:^(NSString * _Nullable resultNonce, NSError * _Nullable error)
+    {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(resultNonce, @"my-nonce");
+        [expectation fulfill];
+    }];
+    
+    NSString *environment = parameters.authority.environment;
+    NSPredicate *refreshedPredicate = [NSPredicate predicateWithBlock:^BOOL(MSIDCache *cache, __unused NSDictionary *bindings) {
+        return [[(MSIDCachedNonce *)[cache objectForKey:environment] nonce] isEqualToString:@"1234_nonce_abcd"];
+    }];
+    [self expectationForPredicate:refreshedPredicate evaluatedWithObject:nonceCache handler:nil];
+    
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+- (void)testPrefetchNonce_whenNoCachedNonce_shouldFetchNonceOnceForLaterRequest
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self testRequestParameters];
+    [MSIDTestURLSession addResponse:[self nonceResponseWithParameters:parameters nonce:@"1234_nonce_abcd"]];
+    
+    [MSIDNonceTokenRequest prefetchNonceWithRequestParameters:parameters];
+    
+    MSIDNonceTokenRequest *request = [[MSIDNonceTokenRequest alloc] initWithRequestParameters:parameters];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Acquire Nonce."];
+    [request executeRequestWithCompletion:^(NSString * _Nullable resultNonce, NSError * _Nullable error)
+    {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(resultNonce, @"1234_nonce_abcd");
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    XCTAssertTrue([MSIDTestURLSession noResponsesLeft]);
+}
+
+- (void)testPrefetchNonce_whenFreshCachedNonce_shouldNotSendNonceRequest
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self testRequestParameters];
+    MSIDCachedNonce *cachedNonce = [[MSIDCachedNonce alloc] initWithNonce:@"my-nonce"];
+    MSIDCache *nonceCache = [MSIDNonceTokenRequest.class nonceCache];
+    [nonceCache setObject:cachedNonce forKey:parameters.authority.environment];
+    
+    MSIDTestURLResponse *nonceResponse = [self nonceResponseWithParameters:parameters nonce:@"1234_nonce_abcd"];
+    [MSIDTestURLSession addResponse:nonceResponse];
+    
+    [MSIDNonceTokenRequest prefetchNonceWithRequestParameters:parameters];
+    
+    XCTAssertFalse([MSIDTestURLSession noResponsesLeft]);
+    XCTAssertEqualObjects([(MSIDCachedNonce *)[nonceCache objectForKey:parameters.authority.environment] nonce], @"my-nonce");
+}
+
 #pragma mark - Utils
 
 - (MSIDInteractiveTokenRequestParameters *)testRequestParameters
@@ -366,4 +484,14 @@
     
     return [requestHeaders mutableCopy];
 }
+
+- (MSIDTestURLResponse *)nonceResponseWithParameters:(MSIDRequestParameters *)parameters nonce:(NSString *)nonce
+{
+    NSHTTPURLResponse *httpResponse = [[NSHTTPURLResponse alloc] initWithURL:[NSURL new] statusCode:200 HTTPVersion:nil headerFields:nil];
+    MSIDTestURLResponse *nonceResponse = [MSIDTestURLResponse request:parameters.authority.metadata.tokenEndpoint
+                                                              reponse:httpResponse];
+    nonceResponse->_requestHeaders = [self mockedRequestHeaders];
+    [nonceResponse setResponseJSON:@{@"Nonce": nonce}];
+    return nonceResponse;
+}
 @end
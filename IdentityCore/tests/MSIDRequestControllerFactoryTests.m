@@ -34,6 +34,9 @@
 #import "MSIDTestSwizzle.h"
 #import "MSIDRequestParameters+Broker.h"
 #import "MSIDSSOExtensionInteractiveTokenRequestController.h"
+#import "MSIDFlightManager.h"
+#import "MSIDFlightManagerMockProvider.h"
+#import "MSIDConstants.h"
 #if TARGET_OS_OSX
 #import "MSIDXpcSilentTokenRequestController.h"
 #import "MSIDXpcInteractiveTokenRequestController.h"
@@ -58,6 +61,7 @@
 - (void)tearDown {
     // Put teardown code here. This method is called after the invocation of each test method in the class.
     [MSIDTestSwizzle reset];
+    MSIDFlightManager.sharedInstance.flightProvider = nil;
 }
 
 - (void)testWhenForceToSkipLocalRt_isSet_shouldSkip_whenFallBackController_isValid
@@ -845,6 +849,155 @@
     XCTAssertEqualObjects(requestParameters.nestedAuthBrokerRedirectUri, @"my_redirect_uri");
 }
 
+#pragma mark - Account source routing
+
+- (void)testSilentController_whenAccountSourceIsBroker_andRoutingEnabled_shouldNotFallBackToLocalRt
+{
+    MSIDTestTokenRequestProvider *provider = [[MSIDTestTokenRequestProvider alloc] initWithTestResponse:nil
+                                                                                              testError:nil
+                                                                                  testWebMSAuthResponse:nil];
+    provider.accountSource = MSIDAccountMetadataSourceBroker;
+    MSIDRequestParameters *parameters = [self requestParameters];
+    parameters.allowUsingLocalCachedRtWhenSsoExtFailed = YES;
+    [self enableAccountSourceRouting:YES];
+    [self swizzleSsoExtensionAvailable];
+
+    NSError *error;
+    id<MSIDRequestControlling> controller = [MSIDRequestControllerFactory silentControllerForParameters:parameters
+                                                                                           forceRefresh:NO
+                                                                                            skipLocalRt:MSIDSilentControllerUndefinedLocalRtUsage
+                                                                                   tokenRequestProvider:provider
+                                                                                                  error:&error];
+
+    XCTAssertTrue([controller isKindOfClass:MSIDSilentController.class]);
+    XCTAssertTrue([(MSIDSilentController *)controller skipLocalRt]);
+    
+    MSIDBaseRequestController *ssoExtensionController = (MSIDBaseRequestController *)[(MSIDBaseRequestController *)controller fallbackController];
+    XCTAssertTrue([ssoExtensionController isKindOfClass:MSIDSSOExtensionSilentTokenRequestController.class]);
+    XCTAssertNil(ssoExtensionController.fallbackController);
+}
+
+- (void)testSilentController_whenAccountSourceIsBroker_andSkipTokenCacheFromSsoExtension_shouldReturnSsoExtensionController
+{
+    MSIDTestTokenRequestProvider *provider = [[MSIDTestTokenRequestProvider alloc] initWithTestResponse:nil
+                                                                                              testError:nil
+                                                                                  testWebMSAuthResponse:nil];
+    provider.accountSource = MSIDAccountMetadataSourceBroker;
+    MSIDRequestParameters *parameters = [self requestParameters];
+    parameters.skipTokenCacheFromSsoExtensionResponse = YES;
+    [self enableAccountSourceRouting:YES];
+    [self swizzleSsoExtensionAvailable];
+
+    NSError *error;
+    id<MSIDRequestControlling> controller = [MSIDRequestControllerFactory silentControllerForParameters:parameters
+                                                                                           forceRefresh:NO
+                                                                                            skipLocalRt:MSIDSilentControllerUndefinedLocalRtUsage
+                                                                                   tokenRequestProvider:provider
+                                                                                                  error:&error];
+
+    XCTAssertTrue([controller isKindOfClass:MSIDSSOExtensionSilentTokenRequestController.class]);
+}
+
+- (void)testSilentController_whenAccountSourceIsLocal_andRoutingEnabled_shouldUseLocalRtBeforeSsoExtension
+{
+    MSIDTestTokenRequestProvider *provider = [[MSIDTestTokenRequestProvider alloc] initWithTestResponse:nil
+                                                                                              testError:nil
+                                                                                  testWebMSAuthResponse:nil];
+    provider.accountSource = MSIDAccountMetadataSourceLocal;
+    MSIDRequestParameters *parameters = [self requestParameters];
+    parameters.allowUsingLocalCachedRtWhenSsoExtFailed = YES;
+    [self enableAccountSourceRouting:YES];
+    [self swizzleSsoExtensionAvailable];
+
+    NSError *error;
+    id<MSIDRequestControlling> controller = [MSIDRequestControllerFactory silentControllerForParameters:parameters
+                                                                                           forceRefresh:NO
+                                                                                            skipLocalRt:MSIDSilentControllerUndefinedLocalRtUsage
+                                                                                   tokenRequestProvider:provider
+                                                                                                  error:&error];
+
+    XCTAssertTrue([controller isKindOfClass:MSIDSilentController.class]);
+    XCTAssertFalse([(MSIDSilentController *)controller skipLocalRt]);
+    
+    MSIDBaseRequestController *ssoExtensionController = (MSIDBaseRequestController *)[(MSIDBaseRequestController *)controller fallbackController];
+    XCTAssertTrue([ssoExtensionController isKindOfClass:MSIDSSOExtensionSilentTokenRequestController.class]);
+    XCTAssertNil(ssoExtensionController.fallbackController);
+}
+
+- (void)testSilentController_whenAccountSourceIsMixed_andRoutingEnabled_shouldKeepDefaultRouting
+{
+    MSIDTestTokenRequestProvider *provider = [[MSIDTestTokenRequestProvider alloc] initWithTestResponse:nil
+                                                                                              testError:nil
+                                                                                  testWebMSAuthResponse:nil];
+    provider.accountSource = MSIDAccountMetadataSourceMixed;
+    MSIDRequestParameters *parameters = [self requestParameters];
+    parameters.allowUsingLocalCachedRtWhenSsoExtFailed = YES;
+    [self enableAccountSourceRouting:YES];
+    [self swizzleSsoExtensionAvailable];
+
+    NSError *error;
+    id<MSIDRequestControlling> controller = [MSIDRequestControllerFactory silentControllerForParameters:parameters
+                                                                                           forceRefresh:NO
+                                                                                            skipLocalRt:MSIDSilentControllerUndefinedLocalRtUsage
+                                                                                   tokenRequestProvider:provider
+                                                                                                  error:&error];
+
+    XCTAssertTrue([(MSIDSilentController *)controller skipLocalRt]);
+    MSIDBaseRequestController *ssoExtensionController = (MSIDBaseRequestController *)[(MSIDBaseRequestController *)controller fallbackController];
+    XCTAssertTrue([ssoExtensionController.fallbackController isKindOfClass:MSIDSilentController.class]);
+}
+
+- (void)testSilentController_whenAccountSourceIsBroker_andRoutingDisabled_shouldKeepDefaultRouting
+{
+    MSIDTestTokenRequestProvider *provider = [[MSIDTestTokenRequestProvider alloc] initWithTestResponse:nil
+                                                                                              testError:nil
+                                                                                  testWebMSAuthResponse:nil];
+    provider.accountSource = MSIDAccountMetadataSourceBroker;
+    MSIDRequestParameters *parameters = [self requestParameters];
+    parameters.allowUsingLocalCachedRtWhenSsoExtFailed = YES;
+    parameters.skipTokenCacheFromSsoExtensionResponse = YES;
+    [self enableAccountSourceRouting:NO];
+    [self swizzleSsoExtensionAvailable];
+
+    NSError *error;
+    id<MSIDRequestControlling> controller = [MSIDRequestControllerFactory silentControllerForParameters:parameters
+                                                                                           forceRefresh:NO
+                                                                                            skipLocalRt:MSIDSilentControllerUndefinedLocalRtUsage
+                                                                                   tokenRequestProvider:provider
+                                                                                                  error:&error];
+
+    XCTAssertFalse([controller isKindOfClass:MSIDSSOExtensionSilentTokenRequestController.class]);
+    XCTAssertTrue([(MSIDSilentController *)controller skipLocalRt]);
+    MSIDBaseRequestController *ssoExtensionController = (MSIDBaseRequestController *)[(MSIDBaseRequestController *)controller fallbackController];
+    XCTAssertTrue([ssoExtensionController.fallbackController isKindOfClass:MSIDSilentController.class]);
+}
+
+#pragma mark - Helpers
+
+- (void)enableAccountSourceRouting:(BOOL)enabled
+{
+    MSIDFlightManagerMockProvider *flightProvider = [MSIDFlightManagerMockProvider new];
+    flightProvider.boolForKeyContainer = @{MSID_FLIGHT_ACCOUNT_SOURCE_ROUTING_ENABLED : @(enabled)};
+    MSIDFlightManager.sharedInstance.flightProvider = flightProvider;
+}
+
+- (void)swizzleSsoExtensionAvailable
+{
+    [MSIDTestSwizzle classMethod:NSSelectorFromString(@"canPerformRequest")
+                           class:[MSIDSSOExtensionSilentTokenRequestController class]
+                           block:(id)^(void)
+    {
+        return YES;
+    }];
+    
+    [MSIDTestSwizzle instanceMethod:NSSelectorFromString(@"shouldUseBroker")
+                              class:[MSIDRequestParameters class]
+                              block:(id)^(void)
+    {
+        return YES;
+    }];
+}
+
 - (MSIDInteractiveTokenRequestParameters *)requestParameters
 {
     MSIDInteractiveTokenRequestParameters *parameters = [MSIDInteractiveTokenRequestParameters new];
@@ -0,0 +1,94 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDSSOExtensionLatencyTracker.h"
+
+@interface MSIDSSOExtensionLatencyTrackerTests : XCTestCase
+
+@end
+
+@implementation MSIDSSOExtensionLatencyTrackerTests
+
+- (void)testHedgeDelay_whenNotEnoughSamples_shouldReturnDefaultDelay
+{
+    MSIDSSOExtensionLatencyTracker *tracker = [[MSIDSSOExtensionLatencyTracker alloc] initWithCapacity:10];
+    tracker.minimumSampleCount = 5;
+    [tracker recordLatency:0.1];
+    
+    XCTAssertEqual([tracker hedgeDelay], tracker.defaultHedgeDelay);
+}
+
+- (void)testHedgeDelay_whenEnoughSamples_shouldReturnPercentile
+{
+    MSIDSSOExtensionLatencyTracker *tracker = [[MSIDSSOExtensionLatencyTracker alloc] initWithCapacity:100];
+    tracker.minimumSampleCount = 20;
+    tracker.minimumHedgeDelay = 0;
+    tracker.maximumHedgeDelay = 100;
+    
+    for (NSUInteger i = 100; i > 0; i--)
+    {
+        [tracker recordLatency:i];
+    }
+    
+    XCTAssertEqual(tracker.sampleCount, 100);
+    XCTAssertEqualWithAccuracy([tracker hedgeDelay], 95, 0.0001);
+    
+    tracker.hedgePercentile = 0.5;
+    XCTAssertEqualWithAccuracy([tracker hedgeDelay], 50, 0.0001);
+}
+
+- (void)testHedgeDelay_shouldClampToBounds
+{
+    MSIDSSOExtensionLatencyTracker *tracker = [[MSIDSSOExtensionLatencyTracker alloc] initWithCapacity:10];
+    tracker.minimumSampleCount = 1;
+    tracker.minimumHedgeDelay = 0.5;
+    tracker.maximumHedgeDelay = 5;
+    
+    [tracker recordLatency:0.01];
+    XCTAssertEqual([tracker hedgeDelay], 0.5);
+    
+    [tracker reset];
+    [tracker recordLatency:30];
+    XCTAssertEqual([tracker hedgeDelay], 5);
+}
+
+- (void)testRecordLatency_whenCapacityExceeded_shouldKeepMostRecentSamples
+{
+    MSIDSSOExtensionLatencyTracker *tracker = [[MSIDSSOExtensionLatencyTracker alloc] initWithCapacity:4];
+    tracker.minimumSampleCount = 1;
+    tracker.minimumHedgeDelay = 0;
+    tracker.hedgePercentile = 1;
+    
+    [tracker recordLatency:4];
+    for (NSUInteger i = 0; i < 4; i++)
+    {
+        [tracker recordLatency:1];
+    }
+    
+    XCTAssertEqual(tracker.sampleCount, 4);
+    XCTAssertEqual([tracker hedgeDelay], 1);
+}
+
+@end
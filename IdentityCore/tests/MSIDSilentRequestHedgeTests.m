@@ -0,0 +1,293 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDSilentRequestHedge.h"
+#import "MSIDTokenResponseHandler.h"
+#import "MSIDDefaultTokenResponseValidator.h"
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDDefaultTokenCacheAccessor.h"
+#import "MSIDAccountMetadataCacheAccessor.h"
+#import "MSIDAADV2Oauth2Factory.h"
+#import "MSIDTestTokenResponse.h"
+#import "MSIDAADV2TokenResponse.h"
+#import "MSIDRequestParameters.h"
+#import "MSIDAuthenticationScheme.h"
+#import "MSIDTestIdentifiers.h"
+#import "NSString+MSIDTestUtil.h"
+
+@interface MSIDSilentRequestHedgeTests : XCTestCase
+
+@end
+
+@implementation MSIDSilentRequestHedgeTests
+
+#pragma mark - Legs
+
+- (void)testStartSecondaryLeg_whenPrimaryLegRunning_shouldStart
+{
+    MSIDSilentRequestHedge *hedge = [MSIDSilentRequestHedge new];
+    
+    XCTAssertTrue([hedge startSecondaryLeg]);
+    XCTAssertTrue(hedge.secondaryLegStarted);
+}
+
+- (void)testStartSecondaryLeg_whenPrimaryLegFinished_shouldNotStart
+{
+    MSIDSilentRequestHedge *hedge = [MSIDSilentRequestHedge new];
+    [hedge finishPrimaryLeg];
+    
+    XCTAssertFalse([hedge startSecondaryLeg]);
+    XCTAssertFalse(hedge.secondaryLegStarted);
+}
+
+- (void)testClaimCacheWrite_whenFirstLegClaims_shouldWinAndCancelOtherLeg
+{
+    MSIDSilentRequestHedge *hedge = [MSIDSilentRequestHedge new];
+    
+    XCTAssertTrue([hedge claimCacheWriteForLeg:MSIDSilentRequestHedgeLegSecondary]);
+    XCTAssertTrue([hedge claimCacheWriteForLeg:MSIDSilentRequestHedgeLegSecondary]);
+    XCTAssertFalse([hedge claimCacheWriteForLeg:MSIDSilentRequestHedgeLegPrimary]);
+    
+    XCTAssertTrue([hedge isLegCancelled:MSIDSilentRequestHedgeLegPrimary]);
+    XCTAssertFalse([hedge isLegCancelled:MSIDSilentRequestHedgeLegSecondary]);
+}
+
+- (void)testClaimCacheWrite_whenLegCancelled_shouldNotClaim
+{
+    MSIDSilentRequestHedge *hedge = [MSIDSilentRequestHedge new];
+    [hedge cancelLeg:MSIDSilentRequestHedgeLegPrimary];
+    
+    XCTAssertFalse([hedge claimCacheWriteForLeg:MSIDSilentRequestHedgeLegPrimary]);
+    XCTAssertTrue([hedge claimCacheWriteForLeg:MSIDSilentRequestHedgeLegSecondary]);
+}
+
+- (void)testCancellationError_shouldBeMarkedAsHedgeCancellation
+{
+    MSIDSilentRequestHedge *hedge = [MSIDSilentRequestHedge new];
+    NSUUID *correlationId = [NSUUID new];
+    
+    NSError *error = [hedge cancellationErrorForLeg:MSIDSilentRequestHedgeLegPrimary correlationId:correlationId];
+    
+    XCTAssertEqualObjects(error.domain, MSIDErrorDomain);
+    XCTAssertEqual(error.code, MSIDErrorInternal);
+    XCTAssertEqualObjects(error.userInfo[MSIDHedgedRequestCancelledKey], @YES);
+}
+
+- (void)testPerformCacheCleanup_whenNoLegClaimedCacheWrite_shouldRunBlock
+{
+    MSIDSilentRequestHedge *hedge = [MSIDSilentRequestHedge new];
+    __block BOOL blockRan = NO;
+    
+    XCTAssertTrue([hedge performCacheCleanupForLeg:MSIDSilentRequestHedgeLegSecondary block:^{ blockRan = YES; }]);
+    XCTAssertTrue(blockRan);
+    XCTAssertFalse([hedge isLegCancelled:MSIDSilentRequestHedgeLegPrimary]);
+}
+
+- (void)testPerformCacheCleanup_whenOtherLegClaimedCacheWrite_shouldSkipBlock
+{
+    MSIDSilentRequestHedge *hedge = [MSIDSilentRequestHedge new];
+    XCTAssertTrue([hedge claimCacheWriteForLeg:MSIDSilentRequestHedgeLegPrimary]);
+    __block BOOL blockRan = NO;
+    
+    XCTAssertFalse([hedge performCacheCleanupForLeg:MSIDSilentRequestHedgeLegSecondary block:^{ blockRan = YES; }]);
+    XCTAssertFalse(blockRan);
+}
+
+#pragma mark - Token response handler
+
+- (void)testHandleTokenResponse_whenOtherLegSavedResponse_shouldNotWriteToCache
+{
+    MSIDTestCacheDataSource *dataSource = [MSIDTestCacheDataSource new];
+    MSIDDefaultTokenCacheAccessor *tokenCache = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:dataSource otherCacheAccessors:nil];
+    MSIDAccountMetadataCacheAccessor *accountMetadataCache = [[MSIDAccountMetadataCacheAccessor alloc] initWithDataSource:dataSource];
+    
+    MSIDSilentRequestHedge *hedge = [MSIDSilentRequestHedge new];
+    XCTAssertTrue([hedge claimCacheWriteForLeg:MSIDSilentRequestHedgeLegPrimary]);
+    
+    MSIDTokenResponseHandler *handler = [MSIDTokenResponseHandler new];
+    handler.hedge = hedge;
+    handler.hedgeLeg = MSIDSilentRequestHedgeLegSecondary;
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Handle token response"];
+    [handler handleTokenResponse:[MSIDTestTokenResponse v2DefaultTokenResponse]
+               requestParameters:[self requestParameters]
+                   homeAccountId:nil
+          tokenResponseValidator:[MSIDDefaultTokenResponseValidator new]
+                    oauthFactory:[MSIDAADV2Oauth2Factory new]
+                      tokenCache:tokenCache
+            accountMetadataCache:accountMetadataCache
+                 validateAccount:NO
+                saveSSOStateOnly:NO
+                brokerAppVersion:nil
+brokerResponseGenerationTimeStamp:nil
+  brokerRequestReceivedTimeStamp:nil
+                           error:nil
+                 completionBlock:^(MSIDTokenResult *result, NSError *error)
+    {
+        XCTAssertNil(result);
+        XCTAssertEqualObjects(error.userInfo[MSIDHedgedRequestCancelledKey], @YES);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+    
+    XCTAssertEqual([dataSource allDefaultAccessTokens].count, 0);
+    XCTAssertEqual([dataSource allDefaultRefreshTokens].count, 0);
+}
+
+- (void)testHandleTokenResponse_whenLegWinsCacheWrite_shouldSaveResponse
+{
+    MSIDTestCacheDataSource *dataSource = [MSIDTestCacheDataSource new];
+    MSIDDefaultTokenCacheAccessor *tokenCache = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:dataSource otherCacheAccessors:nil];
+    MSIDAccountMetadataCacheAccessor *accountMetadataCache = [[MSIDAccountMetadataCacheAccessor alloc] initWithDataSource:dataSource];
+    
+    MSIDSilentRequestHedge *hedge = [MSIDSilentRequestHedge new];
+    MSIDTokenResponseHandler *handler = [MSIDTokenResponseHandler new];
+    handler.hedge = hedge;
+    handler.hedgeLeg = MSIDSilentRequestHedgeLegSecondary;
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Handle token response"];
+    [handler handleTokenResponse:[MSIDTestTokenResponse v2DefaultTokenResponse]
+               requestParameters:[self requestParameters]
+                   homeAccountId:nil
+          tokenResponseValidator:[MSIDDefaultTokenResponseValidator new]
+                    oauthFactory:[MSIDAADV2Oauth2Factory new]
+                      tokenCache:tokenCache
+            accountMetadataCache:accountMetadataCache
+                 validateAccount:NO
+                saveSSOStateOnly:NO
+                brokerAppVersion:nil
+brokerResponseGenerationTimeStamp:nil
+  brokerRequestReceivedTimeStamp:nil
+                           error:nil
+                 completionBlock:^(MSIDTokenResult *result, NSError *error)
+    {
+        XCTAssertNotNil(result);
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+    
+    XCTAssertEqual([dataSource allDefaultAccessTokens].count, 1);
+    XCTAssertTrue([hedge isLegCancelled:MSIDSilentRequestHedgeLegPrimary]);
+}
+
+- (void)testHandleTokenResponse_whenOneLegFailsWithOAuthError_andOtherLegSucceeds_shouldSaveSuccessfulResponse
+{
+    MSIDTestCacheDataSource *dataSource = [MSIDTestCacheDataSource new];
+    MSIDDefaultTokenCacheAccessor *tokenCache = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:dataSource otherCacheAccessors:nil];
+    MSIDAccountMetadataCacheAccessor *accountMetadataCache = [[MSIDAccountMetadataCacheAccessor alloc] initWithDataSource:dataSource];
+    MSIDSilentRequestHedge *hedge = [MSIDSilentRequestHedge new];
+    
+    MSIDTokenResponseHandler *primaryHandler = [MSIDTokenResponseHandler new];
+    primaryHandler.hedge = hedge;
+    primaryHandler.hedgeLeg = MSIDSilentRequestHedgeLegPrimary;
+    
+    MSIDAADV2TokenResponse *errorResponse = [[MSIDAADV2TokenResponse alloc] initWithJSONDictionary:@{@"error" : @"invalid_grant"} error:nil];
+    
+    XCTestExpectation *primaryExpectation = [self expectationWithDescription:@"Handle primary token response"];
+    [primaryHandler handleTokenResponse:errorResponse
+                      requestParameters:[self requestParameters]
+                          homeAccountId:nil
+                 tokenResponseValidator:[MSIDDefaultTokenResponseValidator new]
+                           oauthFactory:[MSIDAADV2Oauth2Factory new]
+                             tokenCache:tokenCache
+                   accountMetadataCache:accountMetadataCache
+                        validateAccount:NO
+                       saveSSOStateOnly:NO
+                       brokerAppVersion:nil
+      brokerResponseGenerationTimeStamp:nil
+         brokerRequestReceivedTimeStamp:nil
+                                  error:nil
+                        completionBlock:^(MSIDTokenResult *result, NSError *error)
+    {
+        XCTAssertNil(result);
+        XCTAssertEqualObjects(error.domain, MSIDOAuthErrorDomain);
+        XCTAssertEqualObjects(error.userInfo[MSIDOAuthErrorKey], @"invalid_grant");
+        XCTAssertNil(error.userInfo[MSIDHedgedRequestCancelledKey]);
+        [primaryExpectation fulfill];
+    }];
+    
+    [self waitForExpectations:@[primaryExpectation] timeout:1.0];
+    
+    // The error response must not have claimed the cache write.
+    XCTAssertFalse([hedge isLegCancelled:MSIDSilentRequestHedgeLegSecondary]);
+    
+    MSIDTokenResponseHandler *secondaryHandler = [MSIDTokenResponseHandler new];
+    secondaryHandler.hedge = hedge;
+    secondaryHandler.hedgeLeg = MSIDSilentRequestHedgeLegSecondary;
+    
+    XCTestExpectation *secondaryExpectation = [self expectationWithDescription:@"Handle secondary token response"];
+    [secondaryHandler handleTokenResponse:[MSIDTestTokenResponse v2DefaultTokenResponse]
+                        requestParameters:[self requestParameters]
+                            homeAccountId:nil
+                   tokenResponseValidator:[MSIDDefaultTokenResponseValidator new]
+                             oauthFactory:[MSIDAADV2Oauth2Factory new]
+                               tokenCache:tokenCache
+                     accountMetadataCache:accountMetadataCache
+                          validateAccount:NO
+                         saveSSOStateOnly:NO
+                         brokerAppVersion:nil
+        brokerResponseGenerationTimeStamp:nil
+           brokerRequestReceivedTimeStamp:nil
+                                    error:nil
+                          completionBlock:^(MSIDTokenResult *result, NSError *error)
+    {
+        XCTAssertNotNil(result);
+        XCTAssertNil(error);
+        [secondaryExpectation fulfill];
+    }];
+    
+    [self waitForExpectations:@[secondaryExpectation] timeout:1.0];
+    
+    XCTAssertEqual([dataSource allDefaultAccessTokens].count, 1);
+    XCTAssertEqual([dataSource allDefaultRefreshTokens].count, 1);
+    XCTAssertTrue([hedge isLegCancelled:MSIDSilentRequestHedgeLegPrimary]);
+    
+    // The failed leg's refresh token removal can't run anymore.
+    __block BOOL cleanupRan = NO;
+    XCTAssertFalse([hedge performCacheCleanupForLeg:MSIDSilentRequestHedgeLegPrimary block:^{ cleanupRan = YES; }]);
+    XCTAssertFalse(cleanupRan);
+}
+
+#pragma mark - Helpers
+
+- (MSIDRequestParameters *)requestParameters
+{
+    return [[MSIDRequestParameters alloc] initWithAuthority:[@"https://login.microsoftonline.com/common" aadAuthority]
+                                                 authScheme:[MSIDAuthenticationScheme new]
+                                                redirectUri:@"some_uri"
+                                                   clientId:@"myclient"
+                                                     scopes:[NSOrderedSet orderedSetWithObject:DEFAULT_TEST_SCOPE]
+                                                 oidcScopes:[NSOrderedSet orderedSetWithObjects:@"openid", @"profile", @"offline_access", nil]
+                                              correlationId:[NSUUID new]
+                                             telemetryApiId:nil
+                                        intuneAppIdentifier:nil
+                                                requestType:MSIDRequestLocalType
+                                                      error:nil];
+}
+
+@end
@@ -232,6 +232,26 @@
     XCTAssertFalse([@"authorityX" msidIsEquivalentWithAnyAlias:alias]);
 }
 
+- (void)testMsidIsEquivalentWithAnyAliasInSet_whenContainedWithDifferentCase_shouldReturnYes
+{
+    NSSet *aliases = [NSString msidLowercasedAliasSet:@[@"Login.Windows.net", @"login.microsoftonline.com"]];
+    
+    XCTAssertEqualObjects(aliases, ([NSSet setWithObjects:@"login.windows.net", @"login.microsoftonline.com", nil]));
+    XCTAssertTrue([@"LOGIN.windows.net" msidIsEquivalentWithAnyAliasInSet:aliases]);
+}
+
+- (void)testMsidIsEquivalentWithAnyAliasInSet_whenNotContained_shouldReturnNo
+{
+    NSSet *aliases = [NSString msidLowercasedAliasSet:@[@"authority1", @"authority2"]];
+    XCTAssertFalse([@"authorityX" msidIsEquivalentWithAnyAliasInSet:aliases]);
+}
+
+- (void)testMsidIsEquivalentWithAnyAliasInSet_whenSetNil_shouldReturnNo
+{
+    XCTAssertNil([NSString msidLowercasedAliasSet:nil]);
+    XCTAssertFalse([@"authorityX" msidIsEquivalentWithAnyAliasInSet:nil]);
+}
+
 - (void)testMsidHexStringFromData_whenJsonData_shouldReturnCorrectHexString
 {
     NSString *string = @"{\"key\":\"val\"}";
@@ -0,0 +1,211 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDTestCacheShape.h"
+#import "MSIDTestCacheGenerator.h"
+#import "MSIDTestCacheReplayer.h"
+#import "MSIDAccessToken.h"
+#import "MSIDAADNetworkConfiguration.h"
+
+@interface MSIDTestCacheGeneratorTests : XCTestCase
+
+@end
+
+@implementation MSIDTestCacheGeneratorTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    [MSIDAADNetworkConfiguration.defaultConfiguration setValue:@"v2.0" forKey:@"aadApiVersion"];
+}
+
+- (void)tearDown
+{
+    [MSIDAADNetworkConfiguration.defaultConfiguration setValue:nil forKey:@"aadApiVersion"];
+    [super tearDown];
+}
+
+#pragma mark - Generator
+
+- (void)testPopulateDataSource_whenDefaultShape_shouldWriteItemsMatchingShape
+{
+    MSIDTestCacheShape *shape = [MSIDTestCacheShape defaultShape];
+    MSIDTestCacheDataSource *dataSource = [MSIDTestCacheDataSource new];
+    MSIDTestCacheGenerator *generator = [[MSIDTestCacheGenerator alloc] initWithShape:shape];
+    
+    NSError *error = nil;
+    XCTAssertTrue([generator populateDataSource:dataSource error:&error]);
+    XCTAssertNil(error);
+    
+    XCTAssertEqual(generator.accountIdentifiers.count, shape.accountCount);
+    XCTAssertEqual(generator.clientIds.count, shape.familyClientCount + shape.nonFamilyClientCount);
+    
+    NSUInteger tenantCount = 0;
+    for (NSArray *tenants in generator.tenantIds)
+    {
+        XCTAssertGreaterThanOrEqual(tenants.count, shape.minTenantsPerAccount);
+        XCTAssertLessThanOrEqual(tenants.count, shape.maxTenantsPerAccount);
+        tenantCount += tenants.count;
+    }
+    
+    NSDictionary *counts = generator.itemCounts;
+    XCTAssertEqual([counts[MSIDTestCacheItemCountAccounts] unsignedIntegerValue], tenantCount);
+    XCTAssertEqual([counts[MSIDTestCacheItemCountIdTokens] unsignedIntegerValue], tenantCount * generator.clientIds.count);
+    XCTAssertEqual([counts[MSIDTestCacheItemCountRefreshTokens] unsignedIntegerValue], shape.accountCount * (1 + shape.nonFamilyClientCount));
+    XCTAssertEqual([counts[MSIDTestCacheItemCountAppMetadata] unsignedIntegerValue], generator.clientIds.count);
+    XCTAssertEqual([counts[MSIDTestCacheItemCountAccountMetadata] unsignedIntegerValue], shape.accountCount * generator.clientIds.count);
+    
+    XCTAssertEqual([dataSource allAccounts].count, [counts[MSIDTestCacheItemCountAccounts] unsignedIntegerValue]);
+    XCTAssertEqual([dataSource allDefaultAccessTokens].count, [counts[MSIDTestCacheItemCountAccessTokens] unsignedIntegerValue]);
+    XCTAssertEqual([dataSource allDefaultRefreshTokens].count, [counts[MSIDTestCacheItemCountRefreshTokens] unsignedIntegerValue]);
+}
+
+- (void)testPopulateDataSource_whenLegacyAndDefaultShape_shouldWriteLegacyItems
+{
+    MSIDTestCacheDataSource *dataSource = [MSIDTestCacheDataSource new];
+    MSIDTestCacheGenerator *generator = [[MSIDTestCacheGenerator alloc] initWithShape:[MSIDTestCacheShape legacyAndDefaultShape]];
+    
+    XCTAssertTrue([generator populateDataSource:dataSource error:nil]);
+    
+    NSUInteger legacyCount = [generator.itemCounts[MSIDTestCacheItemCountLegacyTokens] unsignedIntegerValue];
+    XCTAssertGreaterThan(legacyCount, 0);
+    XCTAssertEqual([dataSource allLegacySingleResourceTokens].count, legacyCount);
+}
+
+- (void)testPopulateDataSource_whenSameSeed_shouldProduceSameCache
+{
+    MSIDTestCacheDataSource *firstDataSource = [MSIDTestCacheDataSource new];
+    MSIDTestCacheGenerator *firstGenerator = [[MSIDTestCacheGenerator alloc] initWithShape:[MSIDTestCacheShape manyAccessTokensShape]];
+    XCTAssertTrue([firstGenerator populateDataSource:firstDataSource error:nil]);
+    
+    MSIDTestCacheDataSource *secondDataSource = [MSIDTestCacheDataSource new];
+    MSIDTestCacheGenerator *secondGenerator = [[MSIDTestCacheGenerator alloc] initWithShape:[MSIDTestCacheShape manyAccessTokensShape]];
+    XCTAssertTrue([secondGenerator populateDataSource:secondDataSource error:nil]);
+    
+    XCTAssertEqualObjects(firstGenerator.clientIds, secondGenerator.clientIds);
+    XCTAssertEqualObjects(firstGenerator.tenantIds, secondGenerator.tenantIds);
+    XCTAssertEqualObjects(firstGenerator.itemCounts, secondGenerator.itemCounts);
+    XCTAssertEqualObjects([self accessTokenSecretsInDataSource:firstDataSource], [self accessTokenSecretsInDataSource:secondDataSource]);
+}
+
+- (void)testPopulateDataSource_whenDifferentSeed_shouldProduceDifferentCache
+{
+    MSIDTestCacheShape *otherShape = [MSIDTestCacheShape defaultShape];
+    otherShape.seed = 2;
+    
+    MSIDTestCacheDataSource *firstDataSource = [MSIDTestCacheDataSource new];
+    MSIDTestCacheGenerator *firstGenerator = [[MSIDTestCacheGenerator alloc] initWithShape:[MSIDTestCacheShape defaultShape]];
+    XCTAssertTrue([firstGenerator populateDataSource:firstDataSource error:nil]);
+    
+    MSIDTestCacheDataSource *secondDataSource = [MSIDTestCacheDataSource new];
+    MSIDTestCacheGenerator *secondGenerator = [[MSIDTestCacheGenerator alloc] initWithShape:otherShape];
+    XCTAssertTrue([secondGenerator populateDataSource:secondDataSource error:nil]);
+    
+    XCTAssertNotEqualObjects(firstGenerator.clientIds, secondGenerator.clientIds);
+    XCTAssertNotEqualObjects([self accessTokenSecretsInDataSource:firstDataSource], [self accessTokenSecretsInDataSource:secondDataSource]);
+}
+
+#pragma mark - Replayer
+
+- (void)testOperationsWithGenerator_whenSameSeed_shouldReturnSameSequence
+{
+    MSIDTestCacheGenerator *generator = [[MSIDTestCacheGenerator alloc] initWithShape:[MSIDTestCacheShape defaultShape]];
+    
+    NSArray *firstOperations = [MSIDTestCacheReplayer operationsWithGenerator:generator count:50 seed:7];
+    NSArray *secondOperations = [MSIDTestCacheReplayer operationsWithGenerator:generator count:50 seed:7];
+    
+    XCTAssertEqual(firstOperations.count, 50);
+    XCTAssertEqualObjects(firstOperations, secondOperations);
+}
+
+- (void)testOperationsFromJSONData_whenValidSequence_shouldReturnOperations
+{
+    NSData *data = [@"[{\"op\":\"get_accounts\",\"client\":1},{\"op\":\"silent_token\",\"account\":0,\"tenant\":0,\"client\":0,\"scopes\":3}]" dataUsingEncoding:NSUTF8StringEncoding];
+    
+    NSError *error = nil;
+    NSArray *operations = [MSIDTestCacheReplayer operationsFromJSONData:data error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssertEqual(operations.count, 2);
+    XCTAssertEqualObjects(operations[1][MSIDTestCacheOperationKey], MSIDTestCacheOperationSilentToken);
+}
+
+- (void)testOperationsFromJSONData_whenOperationWithoutName_shouldReturnError
+{
+    NSData *data = [@"[{\"client\":1}]" dataUsingEncoding:NSUTF8StringEncoding];
+    
+    NSError *error = nil;
+    NSArray *operations = [MSIDTestCacheReplayer operationsFromJSONData:data error:&error];
+    
+    XCTAssertNil(operations);
+    XCTAssertNotNil(error);
+}
+
+- (void)testReplayOperations_whenPopulatedCache_shouldReportLatencyPercentiles
+{
+    MSIDTestCacheDataSource *dataSource = [MSIDTestCacheDataSource new];
+    MSIDTestCacheGenerator *generator = [[MSIDTestCacheGenerator alloc] initWithShape:[MSIDTestCacheShape defaultShape]];
+    XCTAssertTrue([generator populateDataSource:dataSource error:nil]);
+    
+    MSIDTestCacheReplayer *replayer = [[MSIDTestCacheReplayer alloc] initWithGenerator:generator dataSource:dataSource];
+    NSArray *operations = [MSIDTestCacheReplayer operationsWithGenerator:generator count:100 seed:7];
+    MSIDTestCacheReplayReport *report = [replayer replayOperations:operations];
+    
+    XCTAssertEqual(report.failedOperations, 0);
+    XCTAssertGreaterThan(report.silentTokenHits, 0);
+    
+    NSUInteger replayedCount = 0;
+    for (NSString *operation in report.latenciesByOperation)
+    {
+        replayedCount += report.latenciesByOperation[operation].count;
+        
+        double p50 = [report percentile:50 forOperation:operation];
+        double p90 = [report percentile:90 forOperation:operation];
+        XCTAssertLessThanOrEqual(p50, p90);
+        XCTAssertLessThanOrEqual(p90, [report percentile:100 forOperation:operation]);
+        XCTAssertEqualObjects(report.summary[operation][@"count"], @(report.latenciesByOperation[operation].count));
+    }
+    
+    XCTAssertEqual(replayedCount, operations.count);
+    XCTAssertEqual([report percentile:50 forOperation:@"unknown"], 0);
+}
+
+#pragma mark - Helpers
+
+- (NSArray<NSString *> *)accessTokenSecretsInDataSource:(MSIDTestCacheDataSource *)dataSource
+{
+    NSMutableArray *secrets = [NSMutableArray new];
+    
+    for (MSIDAccessToken *accessToken in [dataSource allDefaultAccessTokens])
+    {
+        [secrets addObject:accessToken.accessToken];
+    }
+    
+    return [secrets sortedArrayUsingSelector:@selector(compare:)];
+}
+
+@end
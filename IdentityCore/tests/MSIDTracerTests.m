@@ -0,0 +1,330 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDTracer.h"
+#import "MSIDChromeTraceExporter.h"
+#import "MSIDBenchmarkTestCase.h"
+
+@interface MSIDTestTraceExporter : NSObject <MSIDTraceExporting>
+
+@property (nonatomic) NSArray<MSIDTraceSpan *> *exportedSpans;
+@property (nonatomic) NSUUID *exportedCorrelationId;
+@property (nonatomic) XCTestExpectation *expectation;
+
+@end
+
+@implementation MSIDTestTraceExporter
+
+- (void)exportSpans:(NSArray<MSIDTraceSpan *> *)spans correlationId:(NSUUID *)correlationId
+{
+    self.exportedSpans = spans;
+    self.exportedCorrelationId = correlationId;
+    [self.expectation fulfill];
+}
+
+@end
+
+@interface MSIDTracerTests : XCTestCase
+
+@property (nonatomic) MSIDTestTraceExporter *exporter;
+
+@end
+
+@implementation MSIDTracerTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    self.exporter = [MSIDTestTraceExporter new];
+    self.exporter.expectation = [self expectationWithDescription:@"Export spans"];
+    [MSIDTracer sharedInstance].exporter = self.exporter;
+}
+
+- (void)tearDown
+{
+    [MSIDTracer sharedInstance].exporter = nil;
+    [MSIDTracer sharedInstance].idleTraceTimeout = 30;
+    [MSIDTracer sharedInstance].maxTraceAge = 600;
+    
+    [super tearDown];
+}
+
+#pragma mark - Tests
+
+- (void)testSpanStart_whenNoExporterInstalled_shouldReturnNil
+{
+    [MSIDTracer sharedInstance].exporter = nil;
+    [self.exporter.expectation fulfill];
+    
+    XCTAssertFalse(MSIDTraceIsEnabled());
+    XCTAssertNil(MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, [NSUUID UUID]));
+    XCTAssertNil(MSIDTraceSpanStart(MSIDTraceSpanCacheRead, [NSUUID UUID]));
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+}
+
+- (void)testSpanStart_whenNilCorrelationId_shouldReturnNil
+{
+    [self.exporter.expectation fulfill];
+    
+    XCTAssertTrue(MSIDTraceIsEnabled());
+    XCTAssertNil(MSIDTraceSpanStart(MSIDTraceSpanCacheRead, nil));
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+}
+
+- (void)testSpans_whenNestedWithinRootSpan_shouldSetParentsAndExportAfterRootEnds
+{
+    NSUUID *correlationId = [NSUUID UUID];
+    
+    MSIDTraceSpan *rootSpan = MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, correlationId);
+    MSIDTraceSpan *cacheSpan = MSIDTraceSpanStart(MSIDTraceSpanCacheRead, correlationId);
+    [cacheSpan setAttribute:@NO forKey:@"hit"];
+    MSIDTraceSpanEnd(cacheSpan);
+    MSIDTraceSpan *networkSpan = MSIDTraceSpanStart(MSIDTraceSpanNetworkSend, correlationId);
+    MSIDTraceSpan *parseSpan = MSIDTraceSpanStart(MSIDTraceSpanResponseParse, correlationId);
+    MSIDTraceSpanEnd(parseSpan);
+    MSIDTraceSpanEnd(networkSpan);
+    
+    XCTAssertNil(self.exporter.exportedSpans);
+    
+    MSIDTraceSpanEnd(rootSpan);
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertEqualObjects(self.exporter.exportedCorrelationId, correlationId);
+    NSArray *spans = self.exporter.exportedSpans;
+    XCTAssertEqual(spans.count, 4);
+    XCTAssertEqualObjects([spans valueForKey:@"name"], (@[@"silent_request", @"cache_read", @"network_send", @"response_parse"]));
+    XCTAssertTrue(rootSpan.isRoot);
+    XCTAssertEqual(rootSpan.parentSpanId, 0);
+    XCTAssertEqual(cacheSpan.parentSpanId, rootSpan.spanId);
+    XCTAssertEqual(networkSpan.parentSpanId, rootSpan.spanId);
+    XCTAssertEqual(parseSpan.parentSpanId, networkSpan.spanId);
+    XCTAssertEqualObjects(cacheSpan.attributes[@"hit"], @NO);
+    
+    for (MSIDTraceSpan *span in spans)
+    {
+        XCTAssertGreaterThan(span.endTimeNanoseconds, 0);
+        XCTAssertGreaterThanOrEqual(span.endTimeNanoseconds, span.startTimeNanoseconds);
+        XCTAssertGreaterThanOrEqual(span.startTimeNanoseconds, rootSpan.startTimeNanoseconds);
+        XCTAssertLessThanOrEqual(span.endTimeNanoseconds, rootSpan.endTimeNanoseconds);
+    }
+}
+
+- (void)testSpans_whenChildEndsAfterRoot_shouldExportOnceChildEnds
+{
+    NSUUID *correlationId = [NSUUID UUID];
+    
+    MSIDTraceSpan *rootSpan = MSIDTraceRootSpanStart(MSIDTraceSpanInteractiveRequest, correlationId);
+    MSIDTraceSpan *webUISpan = MSIDTraceSpanStart(MSIDTraceSpanWebUI, correlationId);
+    MSIDTraceSpanEnd(rootSpan);
+    
+    XCTAssertNil(self.exporter.exportedSpans);
+    
+    MSIDTraceSpanEnd(webUISpan);
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertEqual(self.exporter.exportedSpans.count, 2);
+}
+
+- (void)testSpanEnd_whenCalledTwice_shouldKeepFirstEndTime
+{
+    NSUUID *correlationId = [NSUUID UUID];
+    
+    MSIDTraceSpan *rootSpan = MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, correlationId);
+    MSIDTraceSpanEnd(rootSpan);
+    uint64_t endTime = rootSpan.endTimeNanoseconds;
+    MSIDTraceSpanEnd(rootSpan);
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertEqual(rootSpan.endTimeNanoseconds, endTime);
+    XCTAssertEqual(self.exporter.exportedSpans.count, 1);
+}
+
+- (void)testSpans_whenDifferentCorrelationIds_shouldTraceRequestsSeparately
+{
+    NSUUID *firstCorrelationId = [NSUUID UUID];
+    NSUUID *secondCorrelationId = [NSUUID UUID];
+    
+    MSIDTraceSpan *firstRoot = MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, firstCorrelationId);
+    MSIDTraceSpan *secondRoot = MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, secondCorrelationId);
+    MSIDTraceSpan *child = MSIDTraceSpanStart(MSIDTraceSpanCacheRead, secondCorrelationId);
+    
+    XCTAssertEqual(secondRoot.parentSpanId, 0);
+    XCTAssertEqual(child.parentSpanId, secondRoot.spanId);
+    
+    MSIDTraceSpanEnd(child);
+    MSIDTraceSpanEnd(secondRoot);
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertEqualObjects(self.exporter.exportedCorrelationId, secondCorrelationId);
+    XCTAssertEqual(self.exporter.exportedSpans.count, 2);
+    
+    self.exporter.expectation = nil;
+    MSIDTraceSpanEnd(firstRoot);
+}
+
+- (void)testSpans_whenStartedWithoutRootSpan_shouldExportOnceIdle
+{
+    [MSIDTracer sharedInstance].idleTraceTimeout = 0;
+    NSUUID *correlationId = [NSUUID UUID];
+    
+    MSIDTraceSpan *networkSpan = MSIDTraceSpanStart(MSIDTraceSpanNetworkSend, correlationId);
+    MSIDTraceSpanEnd(networkSpan);
+    
+    XCTAssertNil(self.exporter.exportedSpans);
+    
+    // Idle requests are evicted when the next request starts tracing.
+    MSIDTraceSpan *otherRootSpan = MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, [NSUUID UUID]);
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertEqualObjects(self.exporter.exportedCorrelationId, correlationId);
+    XCTAssertEqualObjects(self.exporter.exportedSpans, @[networkSpan]);
+    
+    self.exporter.expectation = nil;
+    MSIDTraceSpanEnd(otherRootSpan);
+}
+
+- (void)testSpanStart_whenTraceLimitReached_shouldEvictLeastRecentlyActiveTraceWithoutRoot
+{
+    NSUUID *firstCorrelationId = [NSUUID UUID];
+    MSIDTraceSpanEnd(MSIDTraceSpanStart(MSIDTraceSpanControllerSelection, firstCorrelationId));
+    
+    for (NSUInteger i = 1; i < 200; i++)
+    {
+        MSIDTraceSpanEnd(MSIDTraceSpanStart(MSIDTraceSpanControllerSelection, [NSUUID UUID]));
+    }
+    
+    MSIDTraceSpan *rootSpan = MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, [NSUUID UUID]);
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertNotNil(rootSpan);
+    XCTAssertEqualObjects(self.exporter.exportedCorrelationId, firstCorrelationId);
+    
+    self.exporter.expectation = nil;
+    MSIDTraceSpanEnd(rootSpan);
+}
+
+- (void)testSpanStart_whenRequestOlderThanMaxTraceAge_shouldDropIt
+{
+    NSUUID *correlationId = [NSUUID UUID];
+    MSIDTraceSpan *abandonedRootSpan = MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, [NSUUID UUID]);
+    [MSIDTracer sharedInstance].maxTraceAge = 0;
+    
+    MSIDTraceSpan *rootSpan = MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, correlationId);
+    MSIDTraceSpanEnd(abandonedRootSpan);
+    MSIDTraceSpanEnd(rootSpan);
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertEqualObjects(self.exporter.exportedCorrelationId, correlationId);
+    XCTAssertEqual(self.exporter.exportedSpans.count, 1);
+}
+
+- (void)testTraceDataWithSpans_shouldWriteChromeTraceEvents
+{
+    [self.exporter.expectation fulfill];
+    
+    NSUUID *correlationId = [NSUUID UUID];
+    MSIDTraceSpan *rootSpan = [[MSIDTraceSpan alloc] initWithName:MSIDTraceSpanSilentRequest correlationId:correlationId spanId:1 parentSpanId:0 root:YES];
+    MSIDTraceSpan *childSpan = [[MSIDTraceSpan alloc] initWithName:MSIDTraceSpanNetworkSend correlationId:correlationId spanId:2 parentSpanId:1 root:NO];
+    [childSpan setAttribute:@200 forKey:@"status_code"];
+    [childSpan finish];
+    [rootSpan finish];
+    
+    NSData *data = [MSIDChromeTraceExporter traceDataWithSpans:@[rootSpan, childSpan]];
+    XCTAssertNotNil(data);
+    
+    NSDictionary *json = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    NSArray *events = json[@"traceEvents"];
+    XCTAssertEqual(events.count, 2);
+    
+    NSDictionary *event = events[1];
+    XCTAssertEqualObjects(event[@"name"], @"network_send");
+    XCTAssertEqualObjects(event[@"ph"], @"X");
+    XCTAssertNotNil(event[@"ts"]);
+    XCTAssertNotNil(event[@"dur"]);
+    XCTAssertNotNil(event[@"pid"]);
+    XCTAssertEqualObjects(event[@"tid"], @(childSpan.threadId));
+    XCTAssertEqualObjects(event[@"args"][@"status_code"], @200);
+    XCTAssertEqualObjects(event[@"args"][@"correlation_id"], correlationId.UUIDString);
+    XCTAssertEqualObjects(event[@"args"][@"span_id"], @2);
+    XCTAssertEqualObjects(event[@"args"][@"parent_span_id"], @1);
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+}
+
+- (void)testChromeTraceExporter_whenRequestFinishes_shouldCallHandler
+{
+    [self.exporter.expectation fulfill];
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Chrome trace"];
+    NSUUID *correlationId = [NSUUID UUID];
+    __block NSData *traceData = nil;
+    [MSIDTracer sharedInstance].exporter = [[MSIDChromeTraceExporter alloc] initWithHandler:^(NSData *data, NSUUID *exportedCorrelationId)
+    {
+        XCTAssertEqualObjects(exportedCorrelationId, correlationId);
+        traceData = data;
+        [expectation fulfill];
+    }];
+    
+    MSIDTraceSpanEnd(MSIDTraceRootSpanStart(MSIDTraceSpanSilentRequest, correlationId));
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    NSDictionary *json = [NSJSONSerialization JSONObjectWithData:traceData options:0 error:nil];
+    XCTAssertEqual([json[@"traceEvents"] count], 1);
+}
+
+@end
+
+@interface MSIDTracerBenchmarks : MSIDBenchmarkTestCase
+
+@end
+
+@implementation MSIDTracerBenchmarks
+
+#pragma mark - Benchmarks
+
+- (void)testSpanStartEnd_whenTracingDisabled_benchmark
+{
+    [MSIDTracer sharedInstance].exporter = nil;
+    NSUUID *correlationId = [NSUUID UUID];
+    
+    [self benchmark:@"trace_span_disabled" operations:100000 block:^{
+        MSIDTraceSpan *span = MSIDTraceSpanStart(MSIDTraceSpanCacheRead, correlationId);
+        MSIDTraceSpanEnd(span);
+    }];
+}
+
+@end
@@ -50,7 +50,7 @@
     __auto_type parameters = @{@"p1" : @"v1", @"p2" : @"v2"};
     NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:baseUrl];
     urlRequest.HTTPMethod = @"POST";;
-    __auto_type expectedBody = [[parameters msidWWWFormURLEncode] dataUsingEncoding:NSUTF8StringEncoding];
+    __auto_type expectedBody = [@"p1=v1&p2=v2" dataUsingEncoding:NSUTF8StringEncoding];
     
     __auto_type newUrlRequest = [self.urlRequestSerializer serializeWithRequest:urlRequest parameters:parameters headers:nil];
     
@@ -70,7 +70,42 @@
     __auto_type newUrlRequest = [self.urlRequestSerializer serializeWithRequest:urlRequest parameters:parameters headers:nil];
     
     XCTAssertNil(newUrlRequest.HTTPBody);
-    XCTAssertEqualObjects(@"https://fake.url?p2=v2&p1=v1", newUrlRequest.URL.absoluteString);
+    XCTAssertEqualObjects(@"https://fake.url?p1=v1&p2=v2", newUrlRequest.URL.absoluteString);
+}
+
+- (void)testSerializeWithRequest_whenGetRequestWithExistingQuery_shouldMergeAndOverrideQueryParameters
+{
+    __auto_type baseUrl = [[NSURL alloc] initWithString:@"https://fake.url?p1=old&p3=v3"];
+    __auto_type parameters = @{@"p1" : @"v1", @"p2" : @"v 2"};
+    NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:baseUrl];
+    urlRequest.HTTPMethod = @"get";
+    
+    __auto_type newUrlRequest = [self.urlRequestSerializer serializeWithRequest:urlRequest parameters:parameters headers:nil];
+    
+    XCTAssertNil(newUrlRequest.HTTPBody);
+    XCTAssertEqualObjects(@"https://fake.url?p1=v1&p2=v%202&p3=v3", newUrlRequest.URL.absoluteString);
+}
+
+- (void)testSerializeWithRequest_whenPostRequestWithSameParametersInDifferentOrder_shouldProduceSameBody
+{
+    __auto_type baseUrl = [[NSURL alloc] initWithString:@"https://fake.url"];
+    NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:baseUrl];
+    urlRequest.HTTPMethod = @"POST";
+    
+    NSMutableDictionary *parameters1 = [NSMutableDictionary new];
+    NSMutableDictionary *parameters2 = [NSMutableDictionary new];
+    
+    for (NSUInteger i = 0; i < 50; i++)
+    {
+        NSString *key = [NSString stringWithFormat:@"key%lu", (unsigned long)i];
+        parameters1[key] = @"value";
+        parameters2[[NSString stringWithFormat:@"key%lu", (unsigned long)(49 - i)]] = @"value";
+    }
+    
+    __auto_type request1 = [self.urlRequestSerializer serializeWithRequest:urlRequest parameters:parameters1 headers:nil];
+    __auto_type request2 = [self.urlRequestSerializer serializeWithRequest:urlRequest parameters:parameters2 headers:nil];
+    
+    XCTAssertEqualObjects(request1.HTTPBody, request2.HTTPBody);
 }
 
 @end
@@ -282,6 +282,27 @@
     XCTAssertNotNil(conf.state);
 }
 
+- (void)testAuthorizeWebRequestConfiguration_whenPkceAndStateProvided_shouldUseProvidedValues
+{
+    MSIDWebviewFactory *factory = [MSIDWebviewFactory new];
+    MSIDInteractiveTokenRequestParameters *parameters = [MSIDTestParametersProvider testInteractiveParameters];
+    parameters.authority.metadata.authorizationEndpoint = [NSURL URLWithString:@"https://login.microsoftonline.com/contoso.com/authorizeme"];
+    
+    MSIDPkce *pkce = [MSIDPkce new];
+    
+    MSIDAuthorizeWebRequestConfiguration *conf = [factory authorizeWebRequestConfigurationWithRequestParameters:parameters
+                                                                                                           pkce:pkce
+                                                                                                          state:@"prefetched_state"];
+    
+    XCTAssertNotNil(conf);
+    XCTAssertEqual(conf.pkce, pkce);
+    XCTAssertEqualObjects(conf.state, @"prefetched_state");
+    
+    NSDictionary *query = conf.startURL.msidQueryParameters;
+    XCTAssertEqualObjects(query[@"code_challenge"], pkce.codeChallenge);
+    XCTAssertEqualObjects(query[@"state"], @"prefetched_state".msidBase64UrlEncode);
+}
+
 #pragma mark - Webview (Response)
 - (void)testResponseWithURL_whenNilURL_shouldReturnNilAndError
 {
@@ -0,0 +1,110 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDBenchmarkTestCase.h"
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDTestCacheShape.h"
+#import "MSIDTestCacheGenerator.h"
+#import "MSIDTestCacheReplayer.h"
+#import "MSIDAADNetworkConfiguration.h"
+
+static NSUInteger const MSIDCacheReplayOperationCount = 500;
+static uint64_t const MSIDCacheReplaySeed = 42;
+
+// Replays the same synthetic operation sequence against the cache shapes that caused performance issues in the field
+// and reports per operation latencies.
+@interface MSIDCacheReplayBenchmarks : MSIDBenchmarkTestCase
+
+@end
+
+@implementation MSIDCacheReplayBenchmarks
+
+- (void)setUp
+{
+    [super setUp];
+    
+    [MSIDAADNetworkConfiguration.defaultConfiguration setValue:@"v2.0" forKey:@"aadApiVersion"];
+}
+
+- (void)tearDown
+{
+    [MSIDAADNetworkConfiguration.defaultConfiguration setValue:nil forKey:@"aadApiVersion"];
+    [super tearDown];
+}
+
+- (void)testReplay_whenDefaultShape
+{
+    [self replayWithShape:[MSIDTestCacheShape defaultShape] name:@"default"];
+}
+
+- (void)testReplay_whenManyTenants
+{
+    [self replayWithShape:[MSIDTestCacheShape manyTenantsShape] name:@"many_tenants"];
+}
+
+- (void)testReplay_whenManyAccessTokens
+{
+    [self replayWithShape:[MSIDTestCacheShape manyAccessTokensShape] name:@"many_access_tokens"];
+}
+
+- (void)testReplay_whenManyFamilyApps
+{
+    [self replayWithShape:[MSIDTestCacheShape manyFamilyAppsShape] name:@"many_family_apps"];
+}
+
+- (void)testReplay_whenLegacyAndDefaultItems
+{
+    [self replayWithShape:[MSIDTestCacheShape legacyAndDefaultShape] name:@"legacy_and_default"];
+}
+
+- (void)testReplay_whenLargeAccountMetadata
+{
+    [self replayWithShape:[MSIDTestCacheShape largeAccountMetadataShape] name:@"large_account_metadata"];
+}
+
+#pragma mark - Helpers
+
+- (void)replayWithShape:(MSIDTestCacheShape *)shape name:(NSString *)name
+{
+    MSIDTestCacheDataSource *dataSource = [MSIDTestCacheDataSource new];
+    MSIDTestCacheGenerator *generator = [[MSIDTestCacheGenerator alloc] initWithShape:shape];
+    
+    NSError *error = nil;
+    XCTAssertTrue([generator populateDataSource:dataSource error:&error]);
+    XCTAssertNil(error);
+    
+    MSIDTestCacheReplayer *replayer = [[MSIDTestCacheReplayer alloc] initWithGenerator:generator dataSource:dataSource];
+    NSArray *operations = [MSIDTestCacheReplayer operationsWithGenerator:generator count:MSIDCacheReplayOperationCount seed:MSIDCacheReplaySeed];
+    
+    // The warm up pass also makes saves in the measured pass overwrite existing items, so both passes see the same cache size.
+    [replayer replayOperations:operations];
+    MSIDTestCacheReplayReport *report = [replayer replayOperations:operations];
+    XCTAssertEqual(report.failedOperations, 0);
+    
+    [report.latenciesByOperation enumerateKeysAndObjectsUsingBlock:^(NSString *operation, NSArray<NSNumber *> *latencies, __unused BOOL *stop) {
+        [self recordLatencies:latencies name:[NSString stringWithFormat:@"%@.%@", name, operation]];
+    }];
+}
+
+@end
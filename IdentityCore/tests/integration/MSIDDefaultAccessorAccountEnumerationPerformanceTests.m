@@ -0,0 +1,146 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDBenchmarkTestCase.h"
+#import "MSIDDefaultTokenCacheAccessor.h"
+#import "MSIDKeychainTokenCache.h"
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDAccountMetadataCacheAccessor.h"
+#import "MSIDAADV2Oauth2Factory.h"
+#import "MSIDTestConfiguration.h"
+#import "MSIDTestIdTokenUtil.h"
+#import "MSIDTestTokenResponse.h"
+#import "MSIDAADV2TokenResponse.h"
+#import "NSString+MSIDExtensions.h"
+
+// Account enumeration with sign-in state filtering. All accounts share one per-client account metadata item,
+// which should be read once per enumeration rather than once per account.
+@interface MSIDDefaultAccessorAccountEnumerationPerformanceTests : MSIDBenchmarkTestCase
+{
+    MSIDDefaultTokenCacheAccessor *_defaultAccessor;
+    id<MSIDExtendedTokenCacheDataSource> _dataSource;
+    MSIDAccountMetadataCacheAccessor *_accountMetadataCache;
+}
+
+@end
+
+@implementation MSIDDefaultAccessorAccountEnumerationPerformanceTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+#if TARGET_OS_IOS
+    _dataSource = [[MSIDKeychainTokenCache alloc] initWithGroup:nil error:nil];
+#else
+    _dataSource = [[MSIDTestCacheDataSource alloc] init];
+#endif
+    _defaultAccessor = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:_dataSource otherCacheAccessors:nil];
+    _accountMetadataCache = [[MSIDAccountMetadataCacheAccessor alloc] initWithDataSource:_dataSource];
+}
+
+- (void)tearDown
+{
+    [_dataSource clearWithContext:nil error:nil];
+    [super tearDown];
+}
+
+#pragma mark - Benchmarks
+
+- (void)testAccountsWithAuthority_signedInAccountsOnly_1Account_benchmark
+{
+    [self benchmarkAccountEnumerationWithAccountCount:1];
+}
+
+- (void)testAccountsWithAuthority_signedInAccountsOnly_10Accounts_benchmark
+{
+    [self benchmarkAccountEnumerationWithAccountCount:10];
+}
+
+- (void)testAccountsWithAuthority_signedInAccountsOnly_100Accounts_benchmark
+{
+    [self benchmarkAccountEnumerationWithAccountCount:100];
+}
+
+#pragma mark - Helpers
+
+- (void)benchmarkAccountEnumerationWithAccountCount:(NSUInteger)accountCount
+{
+    NSString *clientId = @"test_client_id";
+    
+    for (NSUInteger i = 0; i < accountCount; i++)
+    {
+        NSString *uid = [NSString stringWithFormat:@"uid%lu", (unsigned long)i];
+        [self saveAccountWithUid:uid utid:@"utid" clientId:clientId];
+        
+        // Every other account is signed out, so filtering has to consult the metadata for all of them.
+        MSIDAccountMetadataState state = i % 2 ? MSIDAccountMetadataStateSignedOut : MSIDAccountMetadataStateSignedIn;
+        XCTAssertTrue([_accountMetadataCache updateSignInStateForHomeAccountId:[NSString stringWithFormat:@"%@.utid", uid] clientId:clientId state:state context:nil error:nil]);
+    }
+    
+    NSUInteger expectedCount = (accountCount + 1) / 2;
+    
+    NSString *name = [NSString stringWithFormat:@"account_enumeration_signed_in_%lu_accounts", (unsigned long)accountCount];
+    [self benchmark:name operations:10 block:^{
+        NSError *error = nil;
+        NSArray *accounts = [self->_defaultAccessor accountsWithAuthority:nil
+                                                                 clientId:clientId
+                                                                 familyId:nil
+                                                        accountIdentifier:nil
+                                                     accountMetadataCache:self->_accountMetadataCache
+                                                     signedInAccountsOnly:YES
+                                                                  context:nil
+                                                                    error:&error];
+        XCTAssertNil(error);
+        XCTAssertEqual(accounts.count, expectedCount);
+    }];
+}
+
+- (void)saveAccountWithUid:(NSString *)uid utid:(NSString *)utid clientId:(NSString *)clientId
+{
+    NSString *upn = [NSString stringWithFormat:@"%@@contoso.com", uid];
+    NSString *idToken = [MSIDTestIdTokenUtil idTokenWithPreferredUsername:upn subject:@"subject" givenName:@"Hello" familyName:@"World" name:@"Hello World" version:@"2.0" tid:utid];
+    MSIDTokenResponse *response = [MSIDTestTokenResponse v2TokenResponseWithAT:@"access token"
+                                                                            RT:[NSString stringWithFormat:@"refresh token %@", uid]
+                                                                        scopes:[@"user.read" msidScopeSet]
+                                                                       idToken:idToken
+                                                                           uid:uid
+                                                                          utid:utid
+                                                                      familyId:nil];
+    MSIDConfiguration *configuration = [MSIDTestConfiguration configurationWithAuthority:@"https://login.microsoftonline.com/common"
+                                                                                clientId:clientId
+                                                                             redirectUri:nil
+                                                                                  target:@"user.read"];
+    
+    NSError *error = nil;
+    BOOL result = [_defaultAccessor saveTokensWithConfiguration:configuration
+                                                       response:response
+                                                        factory:[MSIDAADV2Oauth2Factory new]
+                                                        context:nil
+                                                          error:&error];
+    XCTAssertNil(error);
+    XCTAssertTrue(result);
+}
+
+@end
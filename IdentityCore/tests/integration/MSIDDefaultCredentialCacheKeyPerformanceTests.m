@@ -0,0 +1,130 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDBenchmarkTestCase.h"
+#import "MSIDAccountCredentialCache.h"
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDCredentialCacheItem.h"
+#import "MSIDDefaultCredentialCacheKey.h"
+#import "MSIDDefaultCredentialCacheQuery.h"
+
+static NSUInteger const MSIDCacheKeyBenchmarkAccountCount = 10;
+static NSUInteger const MSIDCacheKeyBenchmarkTokensPerAccount = 20;
+
+// Save and lookup through MSIDAccountCredentialCache over the in-memory data source, so that key construction
+// dominates.
+@interface MSIDDefaultCredentialCacheKeyPerformanceTests : MSIDBenchmarkTestCase
+
+@property (nonatomic) MSIDAccountCredentialCache *cache;
+
+@end
+
+@implementation MSIDDefaultCredentialCacheKeyPerformanceTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.cache = [[MSIDAccountCredentialCache alloc] initWithDataSource:[MSIDTestCacheDataSource new]];
+}
+
+#pragma mark - Benchmarks
+
+- (void)testSaveCredential_benchmark
+{
+    NSArray<MSIDCredentialCacheItem *> *items = [self accessTokenItems];
+    
+    [self benchmark:@"credential_cache_save" operations:1 block:^{
+        for (MSIDCredentialCacheItem *item in items)
+        {
+            XCTAssertTrue([self.cache saveCredential:item context:nil error:nil]);
+        }
+    }];
+}
+
+- (void)testGetCredentialsWithExactMatchQuery_benchmark
+{
+    NSArray<MSIDCredentialCacheItem *> *items = [self accessTokenItems];
+    for (MSIDCredentialCacheItem *item in items)
+    {
+        XCTAssertTrue([self.cache saveCredential:item context:nil error:nil]);
+    }
+    
+    [self benchmark:@"credential_cache_exact_match_query" operations:1 block:^{
+        for (MSIDCredentialCacheItem *item in items)
+        {
+            MSIDDefaultCredentialCacheQuery *query = [MSIDDefaultCredentialCacheQuery new];
+            query.credentialType = MSIDAccessTokenType;
+            query.homeAccountId = item.homeAccountId;
+            query.environment = item.environment;
+            query.realm = item.realm;
+            query.clientId = item.clientId;
+            query.target = item.target;
+            
+            NSArray *results = [self.cache getCredentialsWithQuery:query context:nil error:nil];
+            XCTAssertEqual(results.count, 1u);
+        }
+    }];
+}
+
+- (void)testKeyComponents_whenReadRepeatedly_benchmark
+{
+    MSIDDefaultCredentialCacheKey *key = [[MSIDDefaultCredentialCacheKey alloc] initWithHomeAccountId:@"uid.utid"
+                                                                                         environment:@"login.microsoftonline.com"
+                                                                                            clientId:@"client"
+                                                                                      credentialType:MSIDAccessTokenType];
+    key.realm = @"contoso.com";
+    key.target = @"user.read user.write";
+    
+    [self benchmark:@"credential_cache_key_components" operations:10000 block:^{
+        __unused NSString *account = key.account;
+        __unused NSString *service = key.service;
+        __unused NSData *generic = key.generic;
+    }];
+}
+
+#pragma mark - Helpers
+
+- (NSArray<MSIDCredentialCacheItem *> *)accessTokenItems
+{
+    NSMutableArray *items = [NSMutableArray new];
+    for (NSUInteger account = 0; account < MSIDCacheKeyBenchmarkAccountCount; account++)
+    {
+        for (NSUInteger token = 0; token < MSIDCacheKeyBenchmarkTokensPerAccount; token++)
+        {
+            MSIDCredentialCacheItem *item = [MSIDCredentialCacheItem new];
+            item.credentialType = MSIDAccessTokenType;
+            item.homeAccountId = [NSString stringWithFormat:@"uid%lu.utid", (unsigned long)account];
+            item.environment = @"login.microsoftonline.com";
+            item.realm = @"contoso.com";
+            item.clientId = @"client";
+            item.target = [NSString stringWithFormat:@"scope%lu.read", (unsigned long)token];
+            item.secret = @"at";
+            [items addObject:item];
+        }
+    }
+    
+    return items;
+}
+
+@end
@@ -0,0 +1,203 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDHttpRequest.h"
+#import "MSIDAADRequestErrorHandler.h"
+#import "MSIDCircuitBreaker.h"
+#import "MSIDCircuitBreakerRegistry.h"
+#import "MSIDTestURLSession.h"
+#import "MSIDTestURLResponse.h"
+#import "MSIDTestContext.h"
+
+// Fault injection against the stubbed URL session: the endpoint goes down, the breaker opens and stops traffic,
+// then a probe finds the endpoint back up and the breaker closes.
+@interface MSIDHttpRequestCircuitBreakerTests : XCTestCase
+
+@property (nonatomic) NSURL *endpoint;
+@property (nonatomic) MSIDCircuitBreakerRegistry *registry;
+
+@end
+
+@implementation MSIDHttpRequestCircuitBreakerTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.endpoint = [NSURL URLWithString:@"https://login.microsoftonline.com/common/oauth2/v2.0/token"];
+    self.registry = [MSIDCircuitBreakerRegistry new];
+    self.registry.failureThreshold = 2;
+    self.registry.openDuration = 0.2;
+}
+
+- (void)tearDown
+{
+    XCTAssertTrue([MSIDTestURLSession noResponsesLeft]);
+    [MSIDTestURLSession clearResponses];
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (void)addResponseWithStatusCode:(NSInteger)statusCode
+{
+    NSHTTPURLResponse *httpResponse = [[NSHTTPURLResponse alloc] initWithURL:self.endpoint statusCode:statusCode HTTPVersion:nil headerFields:nil];
+    NSData *data = statusCode == 200 ? [NSJSONSerialization dataWithJSONObject:@{@"result": @"ok"} options:0 error:nil] : nil;
+    [MSIDTestURLSession addResponse:[MSIDTestURLResponse request:self.endpoint response:httpResponse reponseData:data]];
+}
+
+- (void)addTimeoutResponse
+{
+    MSIDTestURLResponse *response = [MSIDTestURLResponse request:self.endpoint reponse:nil];
+    [response setError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil]];
+    [MSIDTestURLSession addResponse:response];
+}
+
+- (NSError *)sendRequestWithRetries:(NSInteger)retries
+{
+    MSIDHttpRequest *request = [MSIDHttpRequest new];
+    NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:self.endpoint];
+    urlRequest.HTTPMethod = @"GET";
+    request.urlRequest = urlRequest;
+    request.context = [MSIDTestContext new];
+    request.errorHandler = [MSIDAADRequestErrorHandler new];
+    request.retryCounter = retries;
+    request.retryInterval = 0;
+    request.circuitBreakerRegistry = self.registry;
+    
+    __block NSError *requestError = nil;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"request completed"];
+    [request sendWithBlock:^(__unused id response, NSError *error) {
+        requestError = error;
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectations:@[expectation] timeout:5];
+    return requestError;
+}
+
+- (MSIDCircuitBreaker *)circuitBreaker
+{
+    return [self.registry circuitBreakerForURL:self.endpoint];
+}
+
+#pragma mark - Tests
+
+- (void)testSend_whenEndpointKeepsFailing_shouldOpenAndFailFastWithoutNetwork
+{
+    [self addResponseWithStatusCode:503];
+    [self addTimeoutResponse];
+    
+    NSError *first = [self sendRequestWithRetries:0];
+    XCTAssertNil(first.userInfo[MSIDCircuitBreakerOpenKey]);
+    NSError *second = [self sendRequestWithRetries:0];
+    XCTAssertEqualObjects(second.domain, NSURLErrorDomain);
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateOpen);
+    
+    // No stub is queued: a request reaching the session here would fail the test.
+    NSError *failFast = [self sendRequestWithRetries:0];
+    XCTAssertEqualObjects(failFast.domain, MSIDHttpErrorCodeDomain);
+    XCTAssertNotNil(failFast.userInfo[MSIDServerUnavailableStatusKey]);
+    XCTAssertNotNil(failFast.userInfo[MSIDCircuitBreakerOpenKey]);
+    XCTAssertEqual(self.circuitBreaker.metrics.rejectedRequestCount, 1u);
+}
+
+- (void)testSend_whenBreakerOpensDuringRetries_shouldStopRetrying
+{
+    [self addResponseWithStatusCode:500];
+    [self addResponseWithStatusCode:500];
+    
+    NSError *error = [self sendRequestWithRetries:5];
+    
+    XCTAssertNotNil(error.userInfo[MSIDCircuitBreakerOpenKey]);
+    XCTAssertEqual(self.circuitBreaker.metrics.openedCount, 1u);
+}
+
+- (void)testSend_whenEndpointRecovers_probeShouldCloseBreaker
+{
+    [self addResponseWithStatusCode:500];
+    [self addResponseWithStatusCode:500];
+    [self sendRequestWithRetries:0];
+    [self sendRequestWithRetries:0];
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateOpen);
+    
+    [NSThread sleepForTimeInterval:0.25];
+    [self addResponseWithStatusCode:200];
+    
+    NSError *probeError = [self sendRequestWithRetries:0];
+    
+    XCTAssertNil(probeError);
+    MSIDCircuitBreakerMetrics *metrics = self.circuitBreaker.metrics;
+    XCTAssertEqual(metrics.state, MSIDCircuitBreakerStateClosed);
+    XCTAssertEqual(metrics.openedCount, 1u);
+    XCTAssertEqual(metrics.halfOpenedCount, 1u);
+    XCTAssertEqual(metrics.closedCount, 1u);
+}
+
+- (void)testSend_whenServerRejectsRequestWith4xx_shouldNotCountAsFailure
+{
+    [self addResponseWithStatusCode:400];
+    [self addResponseWithStatusCode:400];
+    [self addResponseWithStatusCode:400];
+    
+    [self sendRequestWithRetries:0];
+    [self sendRequestWithRetries:0];
+    [self sendRequestWithRetries:0];
+    
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateClosed);
+    XCTAssertEqual(self.circuitBreaker.metrics.consecutiveFailures, 0u);
+}
+
+- (void)testSend_whenDeviceOffline_shouldNotOpenBreaker
+{
+    for (int i = 0; i < 3; i++)
+    {
+        MSIDTestURLResponse *response = [MSIDTestURLResponse request:self.endpoint reponse:nil];
+        [response setError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNotConnectedToInternet userInfo:nil]];
+        [MSIDTestURLSession addResponse:response];
+        [self sendRequestWithRetries:0];
+    }
+    
+    XCTAssertEqual(self.circuitBreaker.state, MSIDCircuitBreakerStateClosed);
+}
+
+- (void)testSend_whenNoRegistry_shouldNotTrackEndpoint
+{
+    [self addResponseWithStatusCode:500];
+    MSIDHttpRequest *request = [MSIDHttpRequest new];
+    request.circuitBreakerRegistry = nil;
+    NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:self.endpoint];
+    urlRequest.HTTPMethod = @"GET";
+    request.urlRequest = urlRequest;
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"request completed"];
+    [request sendWithBlock:^(__unused id response, __unused NSError *error) {
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    XCTAssertEqual(self.registry.metricsSnapshot.count, 0u);
+}
+
+@end
@@ -0,0 +1,235 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDHttpRequest.h"
+#import "MSIDMetadataResponseCache.h"
+#import "MSIDTestURLSession.h"
+#import "MSIDTestURLResponse.h"
+#import "MSIDTestContext.h"
+#import "MSIDFlightManager.h"
+#import "MSIDFlightManagerMockProvider.h"
+#import "MSIDConstants.h"
+
+// The test bundle stubs out cache writes on MSIDHttpRequest, this request restores them for the cache under test.
+@interface MSIDMetadataCacheTestHttpRequest : MSIDHttpRequest
+@end
+
+@implementation MSIDMetadataCacheTestHttpRequest
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _shouldCacheResponse = YES;
+    }
+    
+    return self;
+}
+
+- (void)setCachedResponse:(NSCachedURLResponse *)cachedResponse forRequest:(NSURLRequest *)request
+{
+    [self.metadataCache storeCachedResponse:cachedResponse forRequest:request];
+}
+
+@end
+
+@interface MSIDHttpRequestMetadataCacheTests : XCTestCase
+
+@property (nonatomic) NSURL *endpoint;
+@property (nonatomic) NSURL *directoryURL;
+@property (nonatomic) MSIDMetadataResponseCache *cache;
+
+@end
+
+@implementation MSIDHttpRequestMetadataCacheTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.endpoint = [NSURL URLWithString:@"https://login.microsoftonline.com/common/v2.0/.well-known/openid-configuration"];
+    self.directoryURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString isDirectory:YES];
+    self.cache = [[MSIDMetadataResponseCache alloc] initWithDirectoryURL:self.directoryURL maxEntryCount:10 maxTotalBytes:1024 * 1024];
+}
+
+- (void)tearDown
+{
+    XCTAssertTrue([MSIDTestURLSession noResponsesLeft]);
+    [MSIDTestURLSession clearResponses];
+    [[NSFileManager defaultManager] removeItemAtURL:self.directoryURL error:nil];
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (void)addResponseForURL:(NSURL *)url
+               statusCode:(NSInteger)statusCode
+           requestHeaders:(NSDictionary *)requestHeaders
+          responseHeaders:(NSDictionary *)responseHeaders
+                     json:(NSDictionary *)json
+{
+    NSHTTPURLResponse *httpResponse = [[NSHTTPURLResponse alloc] initWithURL:url statusCode:statusCode HTTPVersion:nil headerFields:responseHeaders];
+    NSData *data = json ? [NSJSONSerialization dataWithJSONObject:json options:0 error:nil] : nil;
+    MSIDTestURLResponse *response = [MSIDTestURLResponse request:url response:httpResponse reponseData:data];
+    [response setRequestHeaders:requestHeaders];
+    [MSIDTestURLSession addResponse:response];
+}
+
+- (id)sendRequestToURL:(NSURL *)url error:(NSError **)error
+{
+    MSIDHttpRequest *request = [self requestToURL:url];
+    
+    __block id result = nil;
+    __block NSError *requestError = nil;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"request completed"];
+    [request sendWithBlock:^(id response, NSError *responseError) {
+        result = response;
+        requestError = responseError;
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectations:@[expectation] timeout:5];
+    if (error) *error = requestError;
+    return result;
+}
+
+- (MSIDHttpRequest *)requestToURL:(NSURL *)url
+{
+    MSIDMetadataCacheTestHttpRequest *request = [MSIDMetadataCacheTestHttpRequest new];
+    NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:url];
+    urlRequest.HTTPMethod = @"GET";
+    request.urlRequest = urlRequest;
+    request.context = [MSIDTestContext new];
+    request.metadataCache = self.cache;
+    return request;
+}
+
+#pragma mark - Tests
+
+- (void)testInit_whenMetadataCacheFlightOff_shouldUseURLCacheOnly
+{
+    MSIDHttpRequest *request = [MSIDHttpRequest new];
+    
+    XCTAssertNil(request.metadataCache);
+    XCTAssertEqual(request.cache, [NSURLCache sharedURLCache]);
+}
+
+- (void)testInit_whenMetadataCacheFlightOn_shouldUseSharedMetadataCache
+{
+    MSIDFlightManagerMockProvider *flightProvider = [MSIDFlightManagerMockProvider new];
+    flightProvider.boolForKeyContainer = @{MSID_FLIGHT_HTTP_METADATA_RESPONSE_CACHE_ENABLED : @YES};
+    MSIDFlightManager.sharedInstance.flightProvider = flightProvider;
+    
+    MSIDHttpRequest *request = [MSIDHttpRequest new];
+    MSIDFlightManager.sharedInstance.flightProvider = nil;
+    
+    XCTAssertEqual(request.metadataCache, [MSIDMetadataResponseCache sharedCache]);
+}
+
+- (void)testSend_whenResponseHasMaxAge_shouldServeRepeatedRequestsFromCache
+{
+    [self addResponseForURL:self.endpoint statusCode:200 requestHeaders:nil responseHeaders:@{@"Cache-Control": @"max-age=300"} json:@{@"issuer": @"v1"}];
+    
+    for (NSUInteger i = 0; i < 10; i++)
+    {
+        NSError *error = nil;
+        NSDictionary *response = [self sendRequestToURL:self.endpoint error:&error];
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(response[@"issuer"], @"v1");
+    }
+    
+    MSIDMetadataResponseCacheStatistics *statistics = self.cache.statistics;
+    XCTAssertEqual(statistics.missCount, 1u);
+    XCTAssertEqual(statistics.hitCount, 9u);
+    XCTAssertEqual(statistics.revalidationCount, 0u);
+}
+
+- (void)testSend_whenResponseStaleWithETag_shouldRevalidateAndServeCachedBodyOn304
+{
+    [self addResponseForURL:self.endpoint statusCode:200 requestHeaders:nil responseHeaders:@{@"Cache-Control": @"no-cache", @"ETag": @"\"v1\""} json:@{@"issuer": @"v1"}];
+    [self addResponseForURL:self.endpoint statusCode:304 requestHeaders:@{@"If-None-Match": @"\"v1\""} responseHeaders:@{@"Cache-Control": @"no-cache", @"ETag": @"\"v1\""} json:nil];
+    
+    [self sendRequestToURL:self.endpoint error:nil];
+    NSError *error = nil;
+    NSDictionary *response = [self sendRequestToURL:self.endpoint error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(response[@"issuer"], @"v1");
+    XCTAssertEqual(self.cache.statistics.revalidationCount, 1u);
+    XCTAssertEqual(self.cache.statistics.notModifiedCount, 1u);
+}
+
+- (void)testSend_whenResponseStaleAndChanged_shouldReplaceCachedResponse
+{
+    [self addResponseForURL:self.endpoint statusCode:200 requestHeaders:nil responseHeaders:@{@"Cache-Control": @"no-cache", @"ETag": @"\"v1\""} json:@{@"issuer": @"v1"}];
+    [self addResponseForURL:self.endpoint statusCode:200 requestHeaders:@{@"If-None-Match": @"\"v1\""} responseHeaders:@{@"Cache-Control": @"max-age=300", @"ETag": @"\"v2\""} json:@{@"issuer": @"v2"}];
+    
+    [self sendRequestToURL:self.endpoint error:nil];
+    NSDictionary *changed = [self sendRequestToURL:self.endpoint error:nil];
+    NSDictionary *cached = [self sendRequestToURL:self.endpoint error:nil];
+    
+    XCTAssertEqualObjects(changed[@"issuer"], @"v2");
+    XCTAssertEqualObjects(cached[@"issuer"], @"v2");
+    XCTAssertEqual(self.cache.statistics.hitCount, 1u);
+}
+
+- (void)testSend_whenResponseNoStore_shouldAlwaysGoToNetwork
+{
+    [self addResponseForURL:self.endpoint statusCode:200 requestHeaders:nil responseHeaders:@{@"Cache-Control": @"no-store"} json:@{@"issuer": @"v1"}];
+    [self addResponseForURL:self.endpoint statusCode:200 requestHeaders:nil responseHeaders:@{@"Cache-Control": @"no-store"} json:@{@"issuer": @"v1"}];
+    
+    [self sendRequestToURL:self.endpoint error:nil];
+    [self sendRequestToURL:self.endpoint error:nil];
+    
+    XCTAssertEqual(self.cache.statistics.missCount, 2u);
+    XCTAssertEqual(self.cache.entryCount, 0u);
+}
+
+- (void)testWarmUp_whenOneEndpointPersisted_shouldOnlyFetchMissingEndpoint
+{
+    NSURL *discoveryEndpoint = [NSURL URLWithString:@"https://login.microsoftonline.com/common/discovery/instance"];
+    [self addResponseForURL:self.endpoint statusCode:200 requestHeaders:nil responseHeaders:@{@"Cache-Control": @"max-age=300"} json:@{@"issuer": @"v1"}];
+    [self sendRequestToURL:self.endpoint error:nil];
+    
+    // Simulates the next app launch: a new cache over the same directory.
+    self.cache = [[MSIDMetadataResponseCache alloc] initWithDirectoryURL:self.directoryURL maxEntryCount:10 maxTotalBytes:1024 * 1024];
+    [self addResponseForURL:discoveryEndpoint statusCode:200 requestHeaders:nil responseHeaders:@{@"Cache-Control": @"max-age=300"} json:@{@"tenant_discovery_endpoint": @"x"}];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"warm up completed"];
+    [self.cache warmUpWithRequests:@[[self requestToURL:self.endpoint], [self requestToURL:discoveryEndpoint]] completionBlock:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    XCTAssertEqual(self.cache.statistics.hitCount, 1u);
+    XCTAssertEqual(self.cache.statistics.missCount, 1u);
+    XCTAssertEqual(self.cache.entryCount, 2u);
+    
+    // Both endpoints are now served without network.
+    [self sendRequestToURL:discoveryEndpoint error:nil];
+    XCTAssertEqual(self.cache.statistics.hitCount, 2u);
+}
+
+@end
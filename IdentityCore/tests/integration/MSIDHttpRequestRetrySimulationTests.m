@@ -0,0 +1,205 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDHttpRequest.h"
+#import "MSIDAADRequestErrorHandler.h"
+#import "MSIDExponentialBackoffRetryPolicy.h"
+#import "MSIDRetryBudget.h"
+#import "MSIDThrottlingModel429.h"
+#import "NSError+MSIDThrottlingExtension.h"
+#import "MSIDTestURLSession.h"
+#import "MSIDTestURLResponse.h"
+#import "MSIDTestContext.h"
+
+// Drives MSIDHttpRequest + MSIDAADRequestErrorHandler + MSIDExponentialBackoffRetryPolicy against the stubbed
+// URL session, injecting 5xx responses and timeouts the way a partial outage would.
+@interface MSIDHttpRequestRetrySimulationTests : XCTestCase
+
+@property (nonatomic) NSURL *endpoint;
+
+@end
+
+@implementation MSIDHttpRequestRetrySimulationTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.endpoint = [NSURL URLWithString:@"https://login.microsoftonline.com/common/oauth2/v2.0/token"];
+    [MSIDRetryBudget resetSharedBudgets];
+}
+
+- (void)tearDown
+{
+    [MSIDTestURLSession clearResponses];
+    [MSIDRetryBudget resetSharedBudgets];
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (MSIDHttpRequest *)requestWithRetryPolicy:(MSIDExponentialBackoffRetryPolicy *)retryPolicy
+{
+    MSIDHttpRequest *request = [MSIDHttpRequest new];
+    NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:self.endpoint];
+    urlRequest.HTTPMethod = @"GET";
+    request.urlRequest = urlRequest;
+    request.context = [MSIDTestContext new];
+    request.errorHandler = [MSIDAADRequestErrorHandler new];
+    request.retryPolicy = retryPolicy;
+    return request;
+}
+
+- (MSIDExponentialBackoffRetryPolicy *)fastPolicyWithMaxRetries:(NSInteger)maxRetries budget:(MSIDRetryBudget *)budget
+{
+    MSIDExponentialBackoffRetryPolicy *policy = [[MSIDExponentialBackoffRetryPolicy alloc] initWithMaxRetries:maxRetries baseDelay:0.01];
+    policy.maxDelay = 0.05;
+    policy.retryBudget = budget;
+    return policy;
+}
+
+- (MSIDTestURLResponse *)serverErrorResponse:(NSInteger)statusCode headers:(NSDictionary *)headers
+{
+    NSHTTPURLResponse *httpResponse = [[NSHTTPURLResponse alloc] initWithURL:self.endpoint statusCode:statusCode HTTPVersion:nil headerFields:headers];
+    return [MSIDTestURLResponse request:self.endpoint reponse:httpResponse];
+}
+
+- (MSIDTestURLResponse *)timeoutResponse
+{
+    MSIDTestURLResponse *response = [MSIDTestURLResponse request:self.endpoint reponse:nil];
+    [response setError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil]];
+    return response;
+}
+
+- (MSIDTestURLResponse *)successResponse
+{
+    NSHTTPURLResponse *httpResponse = [[NSHTTPURLResponse alloc] initWithURL:self.endpoint statusCode:200 HTTPVersion:nil headerFields:nil];
+    return [MSIDTestURLResponse request:self.endpoint
+                               response:httpResponse
+                            reponseData:[NSJSONSerialization dataWithJSONObject:@{@"result": @"ok"} options:0 error:nil]];
+}
+
+#pragma mark - Tests
+
+- (void)testSend_when5xxThenTimeoutThenSuccess_shouldRecoverWithBackoff
+{
+    [MSIDTestURLSession addResponses:@[[self serverErrorResponse:503 headers:nil], [self timeoutResponse], [self successResponse]]];
+    MSIDExponentialBackoffRetryPolicy *policy = [self fastPolicyWithMaxRetries:3 budget:[[MSIDRetryBudget alloc] initWithCapacity:10 refillRatePerSecond:0]];
+    MSIDHttpRequest *request = [self requestWithRetryPolicy:policy];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"request completed"];
+    [request sendWithBlock:^(id response, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(response[@"result"], @"ok");
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(policy.retryCount, 2);
+    XCTAssertTrue([MSIDTestURLSession noResponsesLeft]);
+}
+
+- (void)testSend_whenOutageOutlastsRetries_shouldFailWithServerError
+{
+    [MSIDTestURLSession addResponses:@[[self serverErrorResponse:500 headers:nil], [self serverErrorResponse:502 headers:nil], [self serverErrorResponse:503 headers:nil]]];
+    MSIDExponentialBackoffRetryPolicy *policy = [self fastPolicyWithMaxRetries:2 budget:[[MSIDRetryBudget alloc] initWithCapacity:10 refillRatePerSecond:0]];
+    MSIDHttpRequest *request = [self requestWithRetryPolicy:policy];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"request completed"];
+    [request sendWithBlock:^(id response, NSError *error) {
+        XCTAssertNil(response);
+        XCTAssertEqual(error.code, MSIDErrorServerUnhandledResponse);
+        XCTAssertEqualObjects(error.userInfo[MSIDHTTPResponseCodeKey], @"503");
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(policy.retryCount, 2);
+    XCTAssertTrue([MSIDTestURLSession noResponsesLeft]);
+}
+
+- (void)testSend_whenLongRetryAfter_shouldFailFastAndLeaveItToThrottling
+{
+    [MSIDTestURLSession addResponses:@[[self serverErrorResponse:503 headers:@{@"Retry-After": @"300"}]]];
+    MSIDExponentialBackoffRetryPolicy *policy = [self fastPolicyWithMaxRetries:3 budget:[[MSIDRetryBudget alloc] initWithCapacity:10 refillRatePerSecond:0]];
+    MSIDHttpRequest *request = [self requestWithRetryPolicy:policy];
+    
+    __block NSError *returnedError = nil;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"request completed"];
+    [request sendWithBlock:^(__unused id response, NSError *error) {
+        returnedError = error;
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(policy.retryCount, 0);
+    XCTAssertTrue([MSIDThrottlingModel429 isApplicableForTheThrottleModel:returnedError]);
+    XCTAssertNotNil([returnedError msidGetRetryDateFromError]);
+}
+
+- (void)testSend_whenManyClientsHitFailingEndpoint_totalRetriesShouldBeBoundedBySharedBudget
+{
+    NSUInteger clientCount = 20;
+    NSUInteger budgetCapacity = 5;
+    MSIDRetryBudget *budget = [[MSIDRetryBudget alloc] initWithCapacity:budgetCapacity refillRatePerSecond:0];
+    
+    // Every client gets its first attempt, only budgetCapacity retries are allowed across all of them.
+    NSMutableArray *responses = [NSMutableArray new];
+    for (NSUInteger i = 0; i < clientCount + budgetCapacity; i++)
+    {
+        [responses addObject:[self serverErrorResponse:500 headers:nil]];
+    }
+    [MSIDTestURLSession addResponses:responses];
+    
+    NSMutableArray<MSIDExponentialBackoffRetryPolicy *> *policies = [NSMutableArray new];
+    NSMutableArray<MSIDHttpRequest *> *requests = [NSMutableArray new];
+    NSMutableArray<XCTestExpectation *> *expectations = [NSMutableArray new];
+    for (NSUInteger i = 0; i < clientCount; i++)
+    {
+        MSIDExponentialBackoffRetryPolicy *policy = [self fastPolicyWithMaxRetries:3 budget:budget];
+        MSIDHttpRequest *request = [self requestWithRetryPolicy:policy];
+        XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"client %lu", (unsigned long)i]];
+        [policies addObject:policy];
+        [requests addObject:request];
+        [expectations addObject:expectation];
+        
+        [request sendWithBlock:^(__unused id response, NSError *error) {
+            XCTAssertNotNil(error);
+            [expectation fulfill];
+        }];
+    }
+    
+    [self waitForExpectations:expectations timeout:10];
+    
+    NSInteger totalRetries = 0;
+    for (MSIDExponentialBackoffRetryPolicy *policy in policies)
+    {
+        totalRetries += policy.retryCount;
+    }
+    
+    XCTAssertEqual(totalRetries, (NSInteger)budgetCapacity);
+    XCTAssertTrue([MSIDTestURLSession noResponsesLeft]);
+}
+
+@end
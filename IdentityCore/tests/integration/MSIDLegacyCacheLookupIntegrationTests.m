@@ -0,0 +1,365 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDDefaultTokenCacheAccessor.h"
+#import "MSIDLegacyTokenCacheAccessor.h"
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDLegacyRefreshToken.h"
+#import "MSIDRefreshToken.h"
+#import "MSIDAccountIdentifier.h"
+#import "MSIDConfiguration.h"
+#import "MSIDTestConfiguration.h"
+#import "MSIDTestIdentifiers.h"
+#import "MSIDAadAuthorityCache.h"
+#import "MSIDAadAuthorityCacheRecord.h"
+#import "MSIDFlightManager.h"
+#import "MSIDFlightManagerMockProvider.h"
+#import "MSIDConstants.h"
+#import "MSIDBenchmarkTestCase.h"
+
+@interface MSIDLegacyLookupCountingTestCacheDataSource : MSIDTestCacheDataSource
+
+@property (atomic) NSUInteger tokenReadCount;
+@property (atomic) NSUInteger tokenQueryCount;
+
+@end
+
+@implementation MSIDLegacyLookupCountingTestCacheDataSource
+
+- (MSIDCredentialCacheItem *)tokenWithKey:(MSIDCacheKey *)key
+                               serializer:(id<MSIDCacheItemSerializing>)serializer
+                                  context:(id<MSIDRequestContext>)context
+                                    error:(NSError *__autoreleasing *)error
+{
+    self.tokenReadCount++;
+    return [super tokenWithKey:key serializer:serializer context:context error:error];
+}
+
+- (NSArray<MSIDCredentialCacheItem *> *)tokensWithKey:(MSIDCacheKey *)key
+                                           serializer:(id<MSIDCacheItemSerializing>)serializer
+                                              context:(id<MSIDRequestContext>)context
+                                                error:(NSError *__autoreleasing *)error
+{
+    self.tokenQueryCount++;
+    return [super tokensWithKey:key serializer:serializer context:context error:error];
+}
+
+@end
+
+@interface MSIDLegacyCacheLookupIntegrationTests : XCTestCase
+
+@property (nonatomic) MSIDLegacyLookupCountingTestCacheDataSource *defaultDataSource;
+@property (nonatomic) MSIDLegacyLookupCountingTestCacheDataSource *legacyDataSource;
+@property (nonatomic) MSIDLegacyTokenCacheAccessor *legacyAccessor;
+@property (nonatomic) MSIDDefaultTokenCacheAccessor *defaultAccessor;
+@property (nonatomic) MSIDFlightManagerMockProvider *flightProvider;
+
+@end
+
+@implementation MSIDLegacyCacheLookupIntegrationTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    self.defaultDataSource = [MSIDLegacyLookupCountingTestCacheDataSource new];
+    self.legacyDataSource = [MSIDLegacyLookupCountingTestCacheDataSource new];
+    self.legacyAccessor = [[MSIDLegacyTokenCacheAccessor alloc] initWithDataSource:self.legacyDataSource otherCacheAccessors:nil];
+    self.defaultAccessor = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:self.defaultDataSource otherCacheAccessors:@[self.legacyAccessor]];
+    
+    // Legacy lookup order becomes login.windows.net, login.microsoftonline.com, login.microsoft.com
+    __auto_type record = [MSIDAadAuthorityCacheRecord new];
+    record.validated = YES;
+    record.cacheHost = @"login.windows.net";
+    record.aliases = @[DEFAULT_TEST_ENVIRONMENT, @"login.windows.net", @"login.microsoft.com"];
+    [[MSIDAadAuthorityCache sharedInstance] setObject:record forKey:DEFAULT_TEST_ENVIRONMENT];
+    
+    self.flightProvider = [MSIDFlightManagerMockProvider new];
+    self.flightProvider.boolForKeyContainer = @{ MSID_FLIGHT_LEGACY_CACHE_LOOKUP_INDEX_ENABLED: @YES,
+                                                 MSID_FLIGHT_LEGACY_CACHE_LAZY_MIGRATION_ENABLED: @YES };
+    MSIDFlightManager.sharedInstance.flightProvider = self.flightProvider;
+}
+
+- (void)tearDown
+{
+    MSIDFlightManager.sharedInstance.flightProvider = nil;
+    [[MSIDAadAuthorityCache sharedInstance] removeAllObjects];
+    [self.defaultDataSource reset];
+    [self.legacyDataSource reset];
+    [super tearDown];
+}
+
+#pragma mark - Lookup index
+
+- (void)testLegacyGetRefreshToken_whenTokenInLastAliasAndIndexEnabled_shouldReadIndexedAliasOnRepeatedLookup
+{
+    [self saveLegacyRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid" environment:@"login.microsoft.com" secret:@"legacy rt"];
+    
+    XCTAssertEqualObjects([self legacyRefreshTokenForUser:@"user@contoso.com"].refreshToken, @"legacy rt");
+    XCTAssertEqual(self.legacyDataSource.tokenReadCount, 3u);
+    
+    self.legacyDataSource.tokenReadCount = 0;
+    MSIDRefreshToken *refreshToken = [self legacyRefreshTokenForUser:@"user@contoso.com"];
+    
+    XCTAssertEqualObjects(refreshToken.refreshToken, @"legacy rt");
+    XCTAssertEqualObjects(refreshToken.storageEnvironment, @"login.microsoft.com");
+    XCTAssertEqual(self.legacyDataSource.tokenReadCount, 1u);
+}
+
+- (void)testLegacyGetRefreshToken_whenIndexDisabled_shouldReadAllAliasesOnRepeatedLookup
+{
+    self.flightProvider.boolForKeyContainer = @{};
+    [self saveLegacyRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid" environment:@"login.microsoft.com" secret:@"legacy rt"];
+    [self legacyRefreshTokenForUser:@"user@contoso.com"];
+    
+    self.legacyDataSource.tokenReadCount = 0;
+    XCTAssertEqualObjects([self legacyRefreshTokenForUser:@"user@contoso.com"].refreshToken, @"legacy rt");
+    XCTAssertEqual(self.legacyDataSource.tokenReadCount, 3u);
+}
+
+- (void)testLegacyGetRefreshToken_whenTokenSavedUnderPreferredAliasAfterIndexing_shouldReturnPreferredAliasToken
+{
+    [self saveLegacyRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid" environment:@"login.microsoft.com" secret:@"old rt"];
+    XCTAssertEqualObjects([self legacyRefreshTokenForUser:@"user@contoso.com"].refreshToken, @"old rt");
+    
+    [self saveLegacyRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid" environment:@"login.windows.net" secret:@"new rt"];
+    
+    XCTAssertEqualObjects([self legacyRefreshTokenForUser:@"user@contoso.com"].refreshToken, @"new rt");
+}
+
+- (void)testLegacyGetRefreshToken_whenIndexedItemRemovedByAnotherAccessor_shouldFallBackToRemainingAliases
+{
+    [self saveLegacyRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid" environment:@"login.microsoft.com" secret:@"indexed rt"];
+    [self legacyRefreshTokenForUser:@"user@contoso.com"];
+    
+    // Simulate another app sharing the cache replacing the item under a different alias
+    MSIDLegacyTokenCacheAccessor *otherAppAccessor = [[MSIDLegacyTokenCacheAccessor alloc] initWithDataSource:self.legacyDataSource otherCacheAccessors:nil];
+    [self.legacyDataSource reset];
+    MSIDLegacyRefreshToken *token = [self legacyRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid" environment:DEFAULT_TEST_ENVIRONMENT secret:@"other app rt"];
+    XCTAssertTrue([otherAppAccessor saveRefreshToken:token configuration:[MSIDTestConfiguration v2DefaultConfiguration] context:nil error:nil]);
+    
+    XCTAssertEqualObjects([self legacyRefreshTokenForUser:@"user@contoso.com"].refreshToken, @"other app rt");
+}
+
+- (void)testLegacyGetRefreshToken_whenOtherAccountSavedAfterIndexing_shouldKeepIndex
+{
+    [self saveLegacyRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid" environment:@"login.microsoft.com" secret:@"legacy rt"];
+    [self legacyRefreshTokenForUser:@"user@contoso.com"];
+    
+    [self saveLegacyRefreshTokenForUser:@"other@contoso.com" homeAccountId:@"uid2.utid" environment:@"login.windows.net" secret:@"other rt"];
+    
+    self.legacyDataSource.tokenReadCount = 0;
+    XCTAssertEqualObjects([self legacyRefreshTokenForUser:@"user@contoso.com"].refreshToken, @"legacy rt");
+    XCTAssertEqual(self.legacyDataSource.tokenReadCount, 1u);
+}
+
+#pragma mark - Lazy migration
+
+- (void)testDefaultGetRefreshToken_whenTokenOnlyInLegacyCacheAndMigrationEnabled_shouldMigrateToDefaultCache
+{
+    [self saveLegacyRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid" environment:@"login.microsoft.com" secret:@"legacy rt"];
+    
+    XCTAssertEqualObjects([self defaultRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid"].refreshToken, @"legacy rt");
+    XCTAssertEqual(self.defaultDataSource.allDefaultRefreshTokens.count, 1u);
+    XCTAssertEqual(self.legacyDataSource.allLegacyRefreshTokens.count, 1u);
+    
+    self.legacyDataSource.tokenReadCount = 0;
+    MSIDRefreshToken *refreshToken = [self defaultRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid"];
+    
+    XCTAssertEqualObjects(refreshToken.refreshToken, @"legacy rt");
+    XCTAssertEqualObjects(refreshToken.accountIdentifier.homeAccountId, @"uid.utid");
+    XCTAssertEqual(self.legacyDataSource.tokenReadCount, 0u);
+}
+
+- (void)testDefaultGetRefreshToken_whenLegacyTokenStoredUnderOtherAlias_shouldMigrateWithStoredEnvironment
+{
+    [self saveLegacyRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid" environment:@"login.microsoft.com" secret:@"legacy rt"];
+    
+    MSIDRefreshToken *refreshToken = [self defaultRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid"];
+    
+    XCTAssertEqualObjects(refreshToken.environment, DEFAULT_TEST_ENVIRONMENT);
+    MSIDRefreshToken *migratedToken = self.defaultDataSource.allDefaultRefreshTokens.firstObject;
+    XCTAssertEqualObjects(migratedToken.environment, @"login.microsoft.com");
+}
+
+- (void)testDefaultGetRefreshToken_whenMigrationDisabled_shouldNotWriteDefaultCache
+{
+    self.flightProvider.boolForKeyContainer = @{};
+    [self saveLegacyRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid" environment:@"login.microsoft.com" secret:@"legacy rt"];
+    
+    XCTAssertEqualObjects([self defaultRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid"].refreshToken, @"legacy rt");
+    XCTAssertEqual(self.defaultDataSource.allDefaultRefreshTokens.count, 0u);
+}
+
+- (void)testDefaultGetRefreshToken_whenLegacyTokenHasNoHomeAccountId_shouldNotMigrate
+{
+    [self saveLegacyRefreshTokenForUser:@"user@contoso.com" homeAccountId:nil environment:@"login.microsoft.com" secret:@"adal rt"];
+    
+    XCTAssertEqualObjects([self defaultRefreshTokenForUser:@"user@contoso.com" homeAccountId:@"uid.utid"].refreshToken, @"adal rt");
+    XCTAssertEqual(self.defaultDataSource.allDefaultRefreshTokens.count, 0u);
+}
+
+#pragma mark - Helpers
+
+- (MSIDRefreshToken *)legacyRefreshTokenForUser:(NSString *)user
+{
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:user homeAccountId:nil];
+    return [self.legacyAccessor getRefreshTokenWithAccount:account
+                                                  familyId:nil
+                                             configuration:[MSIDTestConfiguration v2DefaultConfiguration]
+                                                   context:nil
+                                                     error:nil];
+}
+
+- (MSIDRefreshToken *)defaultRefreshTokenForUser:(NSString *)user homeAccountId:(NSString *)homeAccountId
+{
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:user homeAccountId:homeAccountId];
+    return [self.defaultAccessor getRefreshTokenWithAccount:account
+                                                   familyId:nil
+                                              configuration:[MSIDTestConfiguration v2DefaultConfiguration]
+                                                    context:nil
+                                                      error:nil];
+}
+
+- (MSIDLegacyRefreshToken *)legacyRefreshTokenForUser:(NSString *)user
+                                        homeAccountId:(NSString *)homeAccountId
+                                          environment:(NSString *)environment
+                                               secret:(NSString *)secret
+{
+    MSIDLegacyRefreshToken *token = [MSIDLegacyRefreshToken new];
+    token.environment = environment;
+    token.realm = @"common";
+    token.clientId = DEFAULT_TEST_CLIENT_ID;
+    token.refreshToken = secret;
+    token.accountIdentifier = [[MSIDAccountIdentifier alloc] initWithDisplayableId:user homeAccountId:homeAccountId];
+    return token;
+}
+
+- (void)saveLegacyRefreshTokenForUser:(NSString *)user
+                        homeAccountId:(NSString *)homeAccountId
+                          environment:(NSString *)environment
+                               secret:(NSString *)secret
+{
+    MSIDLegacyRefreshToken *token = [self legacyRefreshTokenForUser:user homeAccountId:homeAccountId environment:environment secret:secret];
+    XCTAssertTrue([self.legacyAccessor saveRefreshToken:token configuration:[MSIDTestConfiguration v2DefaultConfiguration] context:nil error:nil]);
+}
+
+- (MSIDRefreshToken *)defaultRefreshTokenFromToken:(MSIDRefreshToken *)token
+{
+    MSIDRefreshToken *refreshToken = [MSIDRefreshToken new];
+    refreshToken.environment = token.environment;
+    refreshToken.clientId = token.clientId;
+    refreshToken.refreshToken = token.refreshToken;
+    refreshToken.accountIdentifier = token.accountIdentifier;
+    return refreshToken;
+}
+
+@end
+
+@interface MSIDLegacyCacheLookupBenchmarks : MSIDBenchmarkTestCase
+
+@property (nonatomic) MSIDTestCacheDataSource *defaultDataSource;
+@property (nonatomic) MSIDTestCacheDataSource *legacyDataSource;
+@property (nonatomic) MSIDLegacyTokenCacheAccessor *legacyAccessor;
+@property (nonatomic) MSIDDefaultTokenCacheAccessor *defaultAccessor;
+
+@end
+
+@implementation MSIDLegacyCacheLookupBenchmarks
+
+- (void)setUp
+{
+    [super setUp];
+    
+    self.defaultDataSource = [MSIDTestCacheDataSource new];
+    self.legacyDataSource = [MSIDTestCacheDataSource new];
+    self.legacyAccessor = [[MSIDLegacyTokenCacheAccessor alloc] initWithDataSource:self.legacyDataSource otherCacheAccessors:nil];
+    self.defaultAccessor = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:self.defaultDataSource otherCacheAccessors:@[self.legacyAccessor]];
+    
+    __auto_type record = [MSIDAadAuthorityCacheRecord new];
+    record.validated = YES;
+    record.cacheHost = @"login.windows.net";
+    record.aliases = @[DEFAULT_TEST_ENVIRONMENT, @"login.windows.net", @"login.microsoft.com"];
+    [[MSIDAadAuthorityCache sharedInstance] setObject:record forKey:DEFAULT_TEST_ENVIRONMENT];
+    
+    MSIDFlightManagerMockProvider *flightProvider = [MSIDFlightManagerMockProvider new];
+    flightProvider.boolForKeyContainer = @{ MSID_FLIGHT_LEGACY_CACHE_LOOKUP_INDEX_ENABLED: @YES,
+                                            MSID_FLIGHT_LEGACY_CACHE_LAZY_MIGRATION_ENABLED: @YES };
+    MSIDFlightManager.sharedInstance.flightProvider = flightProvider;
+}
+
+- (void)tearDown
+{
+    MSIDFlightManager.sharedInstance.flightProvider = nil;
+    [[MSIDAadAuthorityCache sharedInstance] removeAllObjects];
+    [self.defaultDataSource reset];
+    [self.legacyDataSource reset];
+    [super tearDown];
+}
+
+#pragma mark - Benchmarks
+
+- (void)testDefaultGetRefreshToken_withMixedLegacyAndDefaultCaches_benchmark
+{
+    MSIDConfiguration *configuration = [MSIDTestConfiguration v2DefaultConfiguration];
+    NSUInteger accountCount = 50;
+    NSMutableArray<MSIDAccountIdentifier *> *accounts = [NSMutableArray arrayWithCapacity:accountCount];
+    
+    for (NSUInteger i = 0; i < accountCount; i++)
+    {
+        NSString *user = [NSString stringWithFormat:@"user%lu@contoso.com", (unsigned long)i];
+        NSString *homeAccountId = [NSString stringWithFormat:@"uid%lu.utid", (unsigned long)i];
+        MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:user homeAccountId:homeAccountId];
+        [accounts addObject:account];
+        
+        // Half of the accounts were only ever signed in through ADAL, the other half are in both caches
+        if (i % 2)
+        {
+            MSIDRefreshToken *refreshToken = [MSIDRefreshToken new];
+            refreshToken.environment = @"login.windows.net";
+            refreshToken.clientId = DEFAULT_TEST_CLIENT_ID;
+            refreshToken.refreshToken = @"rt";
+            refreshToken.accountIdentifier = account;
+            XCTAssertTrue([self.defaultAccessor saveToken:refreshToken context:nil error:nil]);
+        }
+        
+        MSIDLegacyRefreshToken *legacyToken = [MSIDLegacyRefreshToken new];
+        legacyToken.environment = @"login.microsoft.com";
+        legacyToken.realm = @"common";
+        legacyToken.clientId = DEFAULT_TEST_CLIENT_ID;
+        legacyToken.refreshToken = @"legacy rt";
+        legacyToken.accountIdentifier = account;
+        XCTAssertTrue([self.legacyAccessor saveRefreshToken:legacyToken configuration:configuration context:nil error:nil]);
+    }
+    
+    [self benchmark:@"default_get_refresh_token_mixed_legacy_caches" operations:1 block:^{
+        for (MSIDAccountIdentifier *account in accounts)
+        {
+            XCTAssertNotNil([self.defaultAccessor getRefreshTokenWithAccount:account familyId:nil configuration:configuration context:nil error:nil]);
+        }
+    }];
+}
+
+@end
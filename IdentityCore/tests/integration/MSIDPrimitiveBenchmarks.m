@@ -0,0 +1,181 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDBenchmarkTestCase.h"
+#import "MSIDDefaultCredentialCacheKey.h"
+#import "MSIDCacheItemJsonSerializer.h"
+#import "MSIDCredentialCacheItem.h"
+#import "MSIDAADIdTokenClaimsFactory.h"
+#import "MSIDIdTokenClaims.h"
+#import "MSIDTestIdTokenUtil.h"
+#import "MSIDThumbprintCalculator.h"
+#import "MSIDRefreshTokenGrantRequest.h"
+#import "MSIDURLFormEncoder.h"
+#import "MSIDTestLogger.h"
+#import "MSIDLogger+Internal.h"
+#import "MSIDError.h"
+#import "MSIDOAuth2Constants.h"
+
+// Microbenchmarks of primitives that run on every request: cache keys, cache item (de)serialization, id token parsing,
+// request thumbprints, form encoding, logging and error creation.
+@interface MSIDPrimitiveBenchmarks : MSIDBenchmarkTestCase
+
+@end
+
+@implementation MSIDPrimitiveBenchmarks
+
+- (void)tearDown
+{
+    [[MSIDTestLogger sharedLogger] reset];
+    [super tearDown];
+}
+
+#pragma mark - Cache
+
+- (void)testCredentialCacheKey_benchmark
+{
+    [self benchmark:@"credential_cache_key" operations:1000 block:^{
+        MSIDDefaultCredentialCacheKey *key = [[MSIDDefaultCredentialCacheKey alloc] initWithHomeAccountId:@"uid.utid"
+                                                                                              environment:@"login.microsoftonline.com"
+                                                                                                 clientId:@"client_id"
+                                                                                           credentialType:MSIDAccessTokenType];
+        key.realm = @"utid";
+        key.target = @"user.read user.write tasks.read";
+        
+        XCTAssertNotNil(key.account);
+        XCTAssertNotNil(key.service);
+        XCTAssertNotNil(key.generic);
+    }];
+}
+
+- (void)testCredentialSerialization_benchmark
+{
+    MSIDCacheItemJsonSerializer *serializer = [MSIDCacheItemJsonSerializer new];
+    MSIDCredentialCacheItem *item = [self accessTokenItem];
+    
+    [self benchmark:@"credential_serialize" operations:1000 block:^{
+        XCTAssertNotNil([serializer serializeCredentialCacheItem:item]);
+    }];
+}
+
+- (void)testCredentialDeserialization_benchmark
+{
+    MSIDCacheItemJsonSerializer *serializer = [MSIDCacheItemJsonSerializer new];
+    NSData *data = [serializer serializeCredentialCacheItem:[self accessTokenItem]];
+    
+    [self benchmark:@"credential_deserialize" operations:1000 block:^{
+        XCTAssertNotNil([serializer deserializeCredentialCacheItem:data]);
+    }];
+}
+
+#pragma mark - Tokens
+
+- (void)testIdTokenParsing_benchmark
+{
+    NSString *idToken = [MSIDTestIdTokenUtil defaultV2IdToken];
+    
+    [self benchmark:@"id_token_parse" operations:1000 block:^{
+        XCTAssertNotNil([MSIDAADIdTokenClaimsFactory claimsFromRawIdToken:idToken error:nil]);
+    }];
+}
+
+- (void)testRequestThumbprint_benchmark
+{
+    NSDictionary *parameters = @{MSID_OAUTH2_CLIENT_ID : @"client_id",
+                                 MSID_OAUTH2_SCOPE : @"user.read user.write tasks.read openid profile offline_access",
+                                 MSID_OAUTH2_GRANT_TYPE : MSID_OAUTH2_REFRESH_TOKEN,
+                                 MSID_OAUTH2_REFRESH_TOKEN : @"refresh token value",
+                                 MSID_OAUTH2_REDIRECT_URI : @"my_redirect_uri",
+                                 MSID_OAUTH2_CLIENT_INFO : @"1",
+                                 MSID_OAUTH2_REQUEST_ENDPOINT : @"https://login.microsoftonline.com/common/oauth2/v2.0/token"};
+    NSSet *strictParameters = [MSIDRefreshTokenGrantRequest strictRequestThumbprintIncludeParams];
+    
+    [self benchmark:@"request_thumbprint" operations:1000 block:^{
+        XCTAssertNotNil([MSIDThumbprintCalculator calculateThumbprint:parameters filteringSet:strictParameters shouldIncludeKeys:YES]);
+    }];
+}
+
+- (void)testFormEncoding_benchmark
+{
+    NSDictionary *parameters = @{@"client_id" : @"27922004-5251-4030-b22d-91ecd9a37ea4",
+                                 @"scope" : @"user.read user.write tasks.read openid profile offline_access",
+                                 @"grant_type" : @"refresh_token",
+                                 @"refresh_token" : [@"" stringByPaddingToLength:1500 withString:@"0.AAAA-_=" startingAtIndex:0],
+                                 @"redirect_uri" : @"msauth.com.microsoft.identity.client.sample://auth",
+                                 @"client_info" : @"1"};
+    
+    [self benchmark:@"form_encode" operations:1000 block:^{
+        XCTAssertNotNil([MSIDURLFormEncoder formURLEncodedDataWithParameters:parameters]);
+    }];
+}
+
+#pragma mark - Logging
+
+- (void)testLogging_whenLevelFiltered_benchmark
+{
+    [[MSIDTestLogger sharedLogger] reset:MSIDLogLevelError];
+    
+    [self benchmark:@"log_filtered" operations:10000 block:^{
+        MSID_LOG_WITH_CTX(MSIDLogLevelVerbose, nil, @"Benchmark message %@", @"parameter");
+    }];
+}
+
+- (void)testLogging_whenLevelEnabled_benchmark
+{
+    [[MSIDTestLogger sharedLogger] reset:MSIDLogLevelVerbose];
+    
+    [self benchmark:@"log_enabled" operations:1000 block:^{
+        MSID_LOG_WITH_CTX_PII(MSIDLogLevelVerbose, nil, @"Benchmark message %@", MSID_PII_LOG_MASKABLE(@"parameter"));
+    }];
+}
+
+#pragma mark - Errors
+
+- (void)testErrorCreation_benchmark
+{
+    NSUUID *correlationId = [NSUUID UUID];
+    
+    [self benchmark:@"error_create" operations:1000 block:^{
+        XCTAssertNotNil(MSIDCreateError(MSIDErrorDomain, MSIDErrorInteractionRequired, @"Benchmark error", @"invalid_grant", @"bad_token", nil, correlationId, nil, NO));
+    }];
+}
+
+#pragma mark - Helpers
+
+- (MSIDCredentialCacheItem *)accessTokenItem
+{
+    MSIDCredentialCacheItem *item = [MSIDCredentialCacheItem new];
+    item.credentialType = MSIDAccessTokenType;
+    item.homeAccountId = @"uid.utid";
+    item.environment = @"login.microsoftonline.com";
+    item.realm = @"utid";
+    item.clientId = @"client_id";
+    item.target = @"user.read user.write tasks.read";
+    item.secret = [@"" stringByPaddingToLength:1500 withString:@"eyJ0eXAiOiJKV1Qi" startingAtIndex:0];
+    item.expiresOn = [NSDate dateWithTimeIntervalSinceNow:3600];
+    item.cachedAt = [NSDate date];
+    return item;
+}
+
+@end
@@ -39,6 +39,7 @@
 #import "MSIDSSOExtensionSilentTokenRequestController.h"
 #import "MSIDAADRequestErrorHandler.h"
 #import "MSIDTestBoundAppRefreshTokenRequest.h"
+#import "MSIDSSOExtensionLatencyTracker.h"
 
 @interface MSIDSilentControllerIntegrationTests : XCTestCase
 
@@ -46,6 +47,16 @@
 
 @implementation MSIDSilentControllerIntegrationTests
 
+- (void)tearDown
+{
+    MSIDSSOExtensionLatencyTracker *tracker = [MSIDSSOExtensionLatencyTracker sharedInstance];
+    [tracker reset];
+    tracker.minimumHedgeDelay = 0.5;
+    tracker.defaultHedgeDelay = 2;
+    
+    [super tearDown];
+}
+
 #pragma mark - Helpers
 
 - (MSIDInteractiveTokenRequestParameters *)requestParameters
@@ -597,4 +608,251 @@
     
 }
 
+
+#pragma mark - Hedging
+
+- (void)testAcquireToken_whenHedgingEnabled_andSsoExtensionSlow_shouldReturnLocalResultWithoutWaitingForSsoExtension
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self requestParameters];
+    parameters.allowUsingLocalCachedRtWhenSsoExtFailed = YES;
+    parameters.hedgeSsoExtWithLocalCachedRt = YES;
+    [self setHedgeDelay:0.1];
+    
+    MSIDTokenResult *localResult = [self resultWithParameters:parameters];
+    MSIDTokenResult *brokerResult = [self resultWithParameters:parameters];
+    MSIDSilentController *brokerController = [self hedgedBrokerControllerWithParameters:parameters
+                                                                           brokerResult:brokerResult
+                                                                            brokerError:nil
+                                                                            brokerDelay:2.0
+                                                                            localResult:localResult
+                                                                             localError:nil
+                                                                             localDelay:0];
+    
+    NSDate *startDate = [NSDate date];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Acquire token"];
+    [brokerController acquireToken:^(MSIDTokenResult * _Nullable result, NSError * _Nullable error)
+    {
+        XCTAssertEqual(result, localResult);
+        XCTAssertNil(error);
+        XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:startDate], 1.0);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:1.5 handler:nil];
+}
+
+- (void)testAcquireToken_whenHedgingEnabled_andSsoExtensionFasterThanHedgeDelay_shouldNotStartLocalRequest
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self requestParameters];
+    parameters.allowUsingLocalCachedRtWhenSsoExtFailed = YES;
+    parameters.hedgeSsoExtWithLocalCachedRt = YES;
+    [self setHedgeDelay:0.2];
+    
+    MSIDTokenResult *brokerResult = [self resultWithParameters:parameters];
+    MSIDTestTokenRequestProvider *localProvider = [[MSIDTestTokenRequestProvider alloc] initWithTestResponse:[self resultWithParameters:parameters] testError:nil testWebMSAuthResponse:nil];
+    MSIDTestTokenRequestProvider *brokerProvider = [[MSIDTestTokenRequestProvider alloc] initWithTestResponse:brokerResult testError:nil testWebMSAuthResponse:nil];
+    MSIDSilentController *brokerController = [self hedgedBrokerControllerWithParameters:parameters brokerProvider:brokerProvider localProvider:localProvider];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Acquire token"];
+    [brokerController acquireToken:^(MSIDTokenResult * _Nullable result, NSError * _Nullable error)
+    {
+        XCTAssertEqual(result, brokerResult);
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+    
+    XCTestExpectation *hedgeDelayExpectation = [self expectationWithDescription:@"Hedge delay passed"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.4 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [hedgeDelayExpectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+    
+    XCTAssertNil(localProvider.silentRequest);
+}
+
+- (void)testAcquireToken_whenHedgingEnabled_andSsoExtensionWinsRace_shouldReturnSsoExtensionResult
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self requestParameters];
+    parameters.allowUsingLocalCachedRtWhenSsoExtFailed = YES;
+    parameters.hedgeSsoExtWithLocalCachedRt = YES;
+    [self setHedgeDelay:0.1];
+    
+    MSIDTokenResult *localResult = [self resultWithParameters:parameters];
+    MSIDTokenResult *brokerResult = [self resultWithParameters:parameters];
+    MSIDSilentController *brokerController = [self hedgedBrokerControllerWithParameters:parameters
+                                                                           brokerResult:brokerResult
+                                                                            brokerError:nil
+                                                                            brokerDelay:0.3
+                                                                            localResult:localResult
+                                                                             localError:nil
+                                                                             localDelay:1.0];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Acquire token"];
+    [brokerController acquireToken:^(MSIDTokenResult * _Nullable result, NSError * _Nullable error)
+    {
+        XCTAssertEqual(result, brokerResult);
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+}
+
+- (void)testAcquireToken_whenHedgingEnabled_andBothLegsFail_shouldReturnLocalError
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self requestParameters];
+    parameters.allowUsingLocalCachedRtWhenSsoExtFailed = YES;
+    parameters.hedgeSsoExtWithLocalCachedRt = YES;
+    [self setHedgeDelay:0.1];
+    
+    NSError *localError = MSIDCreateError(MSIDErrorDomain, MSIDErrorServerInvalidGrant, @"Invalid grant", @"invalid_grant", nil, nil, parameters.correlationId, nil, YES);
+    NSError *brokerError = MSIDCreateError(MSIDErrorDomain, MSIDErrorServerInvalidGrant, @"Broker error", @"invalid_grant", nil, nil, parameters.correlationId, nil, YES);
+    MSIDSilentController *brokerController = [self hedgedBrokerControllerWithParameters:parameters
+                                                                           brokerResult:nil
+                                                                            brokerError:brokerError
+                                                                            brokerDelay:0.5
+                                                                            localResult:nil
+                                                                             localError:localError
+                                                                             localDelay:0];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Acquire token"];
+    [brokerController acquireToken:^(MSIDTokenResult * _Nullable result, NSError * _Nullable error)
+    {
+        XCTAssertNil(result);
+        XCTAssertEqualObjects(error, localError);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+}
+
+- (void)testAcquireToken_whenHedgingEnabled_andSsoExtensionFailsWithNetworkErrorAfterHedgeDelay_shouldReturnNetworkError
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self requestParameters];
+    parameters.allowUsingLocalCachedRtWhenSsoExtFailed = YES;
+    parameters.hedgeSsoExtWithLocalCachedRt = YES;
+    [self setHedgeDelay:0.1];
+    
+    NSError *networkError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil];
+    MSIDSilentController *brokerController = [self hedgedBrokerControllerWithParameters:parameters
+                                                                           brokerResult:nil
+                                                                            brokerError:networkError
+                                                                            brokerDelay:0.3
+                                                                            localResult:[self resultWithParameters:parameters]
+                                                                             localError:nil
+                                                                             localDelay:1.0];
+    
+    NSDate *startDate = [NSDate date];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Acquire token"];
+    [brokerController acquireToken:^(MSIDTokenResult * _Nullable result, NSError * _Nullable error)
+    {
+        XCTAssertNil(result);
+        XCTAssertEqualObjects(error, networkError);
+        XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:startDate], 1.0);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+}
+
+- (void)testAcquireToken_whenHedgingEnabled_andSsoExtensionFailsBoundAppRefreshTokenRedemption_shouldRetrySsoExtensionRequest
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self requestParameters];
+    parameters.allowUsingLocalCachedRtWhenSsoExtFailed = YES;
+    parameters.hedgeSsoExtWithLocalCachedRt = YES;
+    [self setHedgeDelay:0.2];
+    
+    NSError *bartRedemptionError = [NSError errorWithDomain:MSIDErrorDomain code:MSIDErrorBoundAppRefreshTokenRedemptionError userInfo:nil];
+    MSIDTestBoundAppRefreshTokenRequest *brokerRequest = [[MSIDTestBoundAppRefreshTokenRequest alloc] initWithTestResponse:nil testError:bartRedemptionError];
+    brokerRequest.resultAfterRetry = [self resultWithParameters:parameters];
+    brokerRequest.shouldSkipBoundAppRefreshTokenUsage = NO;
+    
+    MSIDTestTokenRequestProvider *brokerProvider = [[MSIDTestTokenRequestProvider alloc] initWithTestResponse:nil testError:bartRedemptionError testWebMSAuthResponse:nil];
+    brokerProvider.silentRequest = brokerRequest;
+    MSIDTestTokenRequestProvider *localProvider = [[MSIDTestTokenRequestProvider alloc] initWithTestResponse:[self resultWithParameters:parameters] testError:nil testWebMSAuthResponse:nil];
+    MSIDSilentController *brokerController = [self hedgedBrokerControllerWithParameters:parameters brokerProvider:brokerProvider localProvider:localProvider];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Acquire token"];
+    [brokerController acquireToken:^(MSIDTokenResult * _Nullable result, NSError * _Nullable error)
+    {
+        XCTAssertEqual(result, brokerRequest.resultAfterRetry);
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+    XCTAssertNil(localProvider.silentRequest);
+}
+
+- (void)testAcquireToken_whenHedgingDisabled_andSsoExtensionSlow_shouldWaitForSsoExtension
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [self requestParameters];
+    parameters.allowUsingLocalCachedRtWhenSsoExtFailed = YES;
+    [self setHedgeDelay:0.1];
+    
+    MSIDTokenResult *localResult = [self resultWithParameters:parameters];
+    MSIDTokenResult *brokerResult = [self resultWithParameters:parameters];
+    MSIDSilentController *brokerController = [self hedgedBrokerControllerWithParameters:parameters
+                                                                           brokerResult:brokerResult
+                                                                            brokerError:nil
+                                                                            brokerDelay:0.3
+                                                                            localResult:localResult
+                                                                             localError:nil
+                                                                             localDelay:0];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Acquire token"];
+    [brokerController acquireToken:^(MSIDTokenResult * _Nullable result, NSError * _Nullable error)
+    {
+        XCTAssertEqual(result, brokerResult);
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+}
+
+#pragma mark - Hedging helpers
+
+- (void)setHedgeDelay:(NSTimeInterval)delay
+{
+    MSIDSSOExtensionLatencyTracker *tracker = [MSIDSSOExtensionLatencyTracker sharedInstance];
+    [tracker reset];
+    tracker.minimumHedgeDelay = 0;
+    tracker.defaultHedgeDelay = delay;
+}
+
+- (MSIDSilentController *)hedgedBrokerControllerWithParameters:(MSIDRequestParameters *)parameters
+                                                  brokerResult:(MSIDTokenResult *)brokerResult
+                                                   brokerError:(NSError *)brokerError
+                                                   brokerDelay:(NSTimeInterval)brokerDelay
+                                                   localResult:(MSIDTokenResult *)localResult
+                                                    localError:(NSError *)localError
+                                                    localDelay:(NSTimeInterval)localDelay
+{
+    MSIDTestTokenRequestProvider *brokerProvider = [[MSIDTestTokenRequestProvider alloc] initWithTestResponse:brokerResult testError:brokerError testWebMSAuthResponse:nil];
+    brokerProvider.silentResponseDelay = brokerDelay;
+    MSIDTestTokenRequestProvider *localProvider = [[MSIDTestTokenRequestProvider alloc] initWithTestResponse:localResult testError:localError testWebMSAuthResponse:nil];
+    localProvider.silentResponseDelay = localDelay;
+    
+    return [self hedgedBrokerControllerWithParameters:parameters brokerProvider:brokerProvider localProvider:localProvider];
+}
+
+- (MSIDSilentController *)hedgedBrokerControllerWithParameters:(MSIDRequestParameters *)parameters
+                                                brokerProvider:(MSIDTestTokenRequestProvider *)brokerProvider
+                                                 localProvider:(MSIDTestTokenRequestProvider *)localProvider
+{
+    NSError *error = nil;
+    MSIDSilentController *localController = [[MSIDSilentController alloc] initWithRequestParameters:parameters forceRefresh:YES tokenRequestProvider:localProvider error:&error];
+    localController.isLocalFallbackMode = YES;
+    XCTAssertNotNil(localController);
+    XCTAssertNil(error);
+    
+    MSIDSilentController *brokerController = [[MSIDSSOExtensionSilentTokenRequestController alloc] initWithRequestParameters:parameters forceRefresh:NO tokenRequestProvider:brokerProvider fallbackInteractiveController:localController error:&error];
+    XCTAssertNotNil(brokerController);
+    XCTAssertNil(error);
+    
+    return brokerController;
+}
 @end
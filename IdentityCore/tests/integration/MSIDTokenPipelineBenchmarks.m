@@ -0,0 +1,252 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDBenchmarkTestCase.h"
+#import "MSIDDefaultTokenCacheAccessor.h"
+#import "MSIDAccountMetadataCacheAccessor.h"
+#import "MSIDTestCacheDataSource.h"
+#import "MSIDDefaultSilentTokenRequest.h"
+#import "MSIDDefaultTokenResponseValidator.h"
+#import "MSIDAADV2Oauth2Factory.h"
+#import "MSIDAADV2TokenResponse.h"
+#import "MSIDRequestParameters.h"
+#import "MSIDAccountIdentifier.h"
+#import "MSIDAccessToken.h"
+#import "MSIDTokenResult.h"
+#import "MSIDTestIdentifiers.h"
+#import "MSIDTestIdTokenUtil.h"
+#import "MSIDTestTokenResponse.h"
+#import "MSIDTestConfiguration.h"
+#import "MSIDTestURLSession.h"
+#import "MSIDTestURLResponse.h"
+#import "MSIDTestURLResponse+Util.h"
+#import "NSString+MSIDTestUtil.h"
+#import "NSString+MSIDExtensions.h"
+#import "MSIDAADNetworkConfiguration.h"
+#import "MSIDAadAuthorityCache.h"
+#import "MSIDAuthority+Internal.h"
+#import "MSIDLRUCache.h"
+
+static NSUInteger const MSIDPipelineBenchmarkAccountCount = 50;
+
+// Macrobenchmarks of the token pipeline over the in-memory cache data source and the stubbed URL session,
+// so that they measure the library and not the keychain or the network.
+@interface MSIDTokenPipelineBenchmarks : MSIDBenchmarkTestCase
+
+@property (nonatomic) MSIDTestCacheDataSource *dataSource;
+@property (nonatomic) MSIDDefaultTokenCacheAccessor *tokenCache;
+@property (nonatomic) MSIDAccountMetadataCacheAccessor *accountMetadataCache;
+
+@end
+
+@implementation MSIDTokenPipelineBenchmarks
+
+- (void)setUp
+{
+    [super setUp];
+    
+    [MSIDAADNetworkConfiguration.defaultConfiguration setValue:@"v2.0" forKey:@"aadApiVersion"];
+    self.dataSource = [MSIDTestCacheDataSource new];
+    self.tokenCache = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:self.dataSource otherCacheAccessors:nil];
+    self.accountMetadataCache = [[MSIDAccountMetadataCacheAccessor alloc] initWithDataSource:self.dataSource];
+}
+
+- (void)tearDown
+{
+    [[MSIDAadAuthorityCache sharedInstance] removeAllObjects];
+    [[MSIDAuthority openIdConfigurationCache] removeAllObjects];
+    [[MSIDLRUCache sharedInstance] removeAllObjects:nil];
+    XCTAssertTrue([MSIDTestURLSession noResponsesLeft]);
+    [MSIDTestURLSession clearResponses];
+    [MSIDAADNetworkConfiguration.defaultConfiguration setValue:nil forKey:@"aadApiVersion"];
+    [super tearDown];
+}
+
+#pragma mark - Cache
+
+- (void)testSaveTokenResponse_benchmark
+{
+    MSIDConfiguration *configuration = [MSIDTestConfiguration configurationWithAuthority:@"https://login.microsoftonline.com/common"
+                                                                                clientId:@"client_id"
+                                                                             redirectUri:nil
+                                                                                  target:@"user.read"];
+    __block NSUInteger index = 0;
+    
+    [self benchmark:@"cache_save_token_response" operations:100 block:^{
+        MSIDTokenResponse *response = [self tokenResponseForUid:[NSString stringWithFormat:@"uid%lu", (unsigned long)(index++ % MSIDPipelineBenchmarkAccountCount)]];
+        XCTAssertTrue([self.tokenCache saveTokensWithConfiguration:configuration
+                                                          response:response
+                                                           factory:[MSIDAADV2Oauth2Factory new]
+                                                           context:nil
+                                                             error:nil]);
+    }];
+}
+
+- (void)testGetAccessToken_benchmark
+{
+    MSIDConfiguration *configuration = [MSIDTestConfiguration configurationWithAuthority:@"https://login.microsoftonline.com/utid"
+                                                                                clientId:@"client_id"
+                                                                             redirectUri:nil
+                                                                                  target:@"user.read"];
+    
+    for (NSUInteger i = 0; i < MSIDPipelineBenchmarkAccountCount; i++)
+    {
+        MSIDTokenResponse *response = [self tokenResponseForUid:[NSString stringWithFormat:@"uid%lu", (unsigned long)i]];
+        XCTAssertTrue([self.tokenCache saveTokensWithConfiguration:configuration response:response factory:[MSIDAADV2Oauth2Factory new] context:nil error:nil]);
+    }
+    
+    MSIDAccountIdentifier *account = [[MSIDAccountIdentifier alloc] initWithDisplayableId:nil homeAccountId:@"uid25.utid"];
+    
+    [self benchmark:@"cache_get_access_token" operations:100 block:^{
+        XCTAssertNotNil([self.tokenCache getAccessTokenForAccount:account configuration:configuration context:nil error:nil]);
+    }];
+}
+
+#pragma mark - Silent request
+
+- (void)testSilentRequest_whenAccessTokenCached_benchmark
+{
+    MSIDRequestParameters *parameters = [self silentRequestParameters];
+    [self saveTokensWithExpiresIn:nil parameters:parameters];
+    
+    // Authority discovery is cached after the first request.
+    [MSIDTestURLSession addResponse:[MSIDTestURLResponse discoveryResponseForAuthority:DEFAULT_TEST_AUTHORITY_GUID]];
+    [self executeSilentRequestWithParameters:parameters forceRefresh:NO];
+    
+    [self benchmark:@"silent_request_cached_access_token" asyncBlock:^(dispatch_block_t done) {
+        [[self silentRequestWithParameters:parameters forceRefresh:NO] executeRequestWithCompletion:^(MSIDTokenResult *result, NSError *error) {
+            XCTAssertNil(error);
+            XCTAssertNotNil(result.accessToken);
+            done();
+        }];
+    }];
+}
+
+- (void)testSilentRequest_whenRefreshingToken_benchmark
+{
+    MSIDRequestParameters *parameters = [self silentRequestParameters];
+    [self saveTokensWithExpiresIn:@"1" parameters:parameters];
+    
+    // Authority discovery and OIDC metadata are cached after the first request.
+    [MSIDTestURLSession addResponse:[MSIDTestURLResponse discoveryResponseForAuthority:DEFAULT_TEST_AUTHORITY_GUID]];
+    [MSIDTestURLSession addResponse:[MSIDTestURLResponse oidcResponseForAuthority:DEFAULT_TEST_AUTHORITY_GUID]];
+    [MSIDTestURLSession addResponse:[self refreshTokenResponse]];
+    [self executeSilentRequestWithParameters:parameters forceRefresh:YES];
+    
+    [self benchmark:@"silent_request_refresh_token" asyncBlock:^(dispatch_block_t done) {
+        [MSIDTestURLSession addResponse:[self refreshTokenResponse]];
+        [[self silentRequestWithParameters:parameters forceRefresh:YES] executeRequestWithCompletion:^(MSIDTokenResult *result, NSError *error) {
+            XCTAssertNil(error);
+            XCTAssertEqualObjects(result.accessToken.accessToken, @"new at");
+            done();
+        }];
+    }];
+}
+
+#pragma mark - Helpers
+
+- (MSIDTokenResponse *)tokenResponseForUid:(NSString *)uid
+{
+    NSString *idToken = [MSIDTestIdTokenUtil idTokenWithPreferredUsername:[NSString stringWithFormat:@"%@@contoso.com", uid] subject:@"subject" givenName:@"Hello" familyName:@"World" name:@"Hello World" version:@"2.0" tid:@"utid"];
+    return [MSIDTestTokenResponse v2TokenResponseWithAT:@"access token"
+                                                     RT:[NSString stringWithFormat:@"refresh token %@", uid]
+                                                 scopes:[@"user.read" msidScopeSet]
+                                                idToken:idToken
+                                                    uid:uid
+                                                   utid:@"utid"
+                                               familyId:nil];
+}
+
+- (MSIDRequestParameters *)silentRequestParameters
+{
+    MSIDRequestParameters *parameters = [MSIDRequestParameters new];
+    parameters.authority = [DEFAULT_TEST_AUTHORITY_GUID aadAuthority];
+    parameters.clientId = @"my_client_id";
+    parameters.target = @"user.read tasks.read";
+    parameters.oidcScope = @"openid profile offline_access";
+    parameters.redirectUri = @"my_redirect_uri";
+    parameters.correlationId = [NSUUID new];
+    parameters.accountIdentifier = [[MSIDAccountIdentifier alloc] initWithDisplayableId:DEFAULT_TEST_ID_TOKEN_USERNAME homeAccountId:DEFAULT_TEST_HOME_ACCOUNT_ID];
+    return parameters;
+}
+
+- (void)saveTokensWithExpiresIn:(NSString *)expiresIn parameters:(MSIDRequestParameters *)parameters
+{
+    NSDictionary *json = [MSIDTestURLResponse tokenResponseWithAT:nil
+                                                       responseRT:nil
+                                                       responseID:nil
+                                                    responseScope:nil
+                                               responseClientInfo:nil
+                                                        expiresIn:expiresIn
+                                                             foci:nil
+                                                     extExpiresIn:nil];
+    MSIDAADV2TokenResponse *response = [[MSIDAADV2TokenResponse alloc] initWithJSONDictionary:json error:nil];
+    
+    XCTAssertTrue([self.tokenCache saveTokensWithConfiguration:parameters.msidConfiguration
+                                                      response:response
+                                                       factory:[MSIDAADV2Oauth2Factory new]
+                                                       context:nil
+                                                         error:nil]);
+}
+
+- (MSIDTestURLResponse *)refreshTokenResponse
+{
+    // Returns the same refresh token, so that every iteration can redeem it again.
+    return [MSIDTestURLResponse refreshTokenGrantResponseWithRT:DEFAULT_TEST_REFRESH_TOKEN
+                                                  requestClaims:nil
+                                                  requestScopes:@"user.read tasks.read openid profile offline_access"
+                                                     responseAT:@"new at"
+                                                     responseRT:DEFAULT_TEST_REFRESH_TOKEN
+                                                     responseID:nil
+                                                  responseScope:@"user.read tasks.read"
+                                             responseClientInfo:nil
+                                                            url:DEFAULT_TEST_TOKEN_ENDPOINT_GUID
+                                                   responseCode:200
+                                                      expiresIn:nil];
+}
+
+- (MSIDDefaultSilentTokenRequest *)silentRequestWithParameters:(MSIDRequestParameters *)parameters forceRefresh:(BOOL)forceRefresh
+{
+    return [[MSIDDefaultSilentTokenRequest alloc] initWithRequestParameters:parameters
+                                                               forceRefresh:forceRefresh
+                                                               oauthFactory:[MSIDAADV2Oauth2Factory new]
+                                                     tokenResponseValidator:[MSIDDefaultTokenResponseValidator new]
+                                                                 tokenCache:self.tokenCache
+                                                       accountMetadataCache:self.accountMetadataCache];
+}
+
+- (void)executeSilentRequestWithParameters:(MSIDRequestParameters *)parameters forceRefresh:(BOOL)forceRefresh
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"silent request"];
+    
+    [[self silentRequestWithParameters:parameters forceRefresh:forceRefresh] executeRequestWithCompletion:^(MSIDTokenResult *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertNotNil(result);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+}
+
+@end
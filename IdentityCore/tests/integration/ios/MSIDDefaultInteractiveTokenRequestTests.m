@@ -53,6 +53,11 @@
 #import "MSIDAccountMetadataCacheAccessor.h"
 #import "NSString+MSIDTestUtil.h"
 #import "MSIDWebAADAuthCodeResponse.h"
+#import "MSIDInteractiveRequestPrefetchContext.h"
+#import "MSIDAuthorizeWebRequestConfiguration.h"
+#import "MSIDPkce.h"
+#import "MSIDFlightManager.h"
+#import "MSIDFlightManagerMockProvider.h"
 
 @interface MSIDDefaultInteractiveTokenRequestTests : XCTestCase
 
@@ -91,6 +96,7 @@
     XCTAssertTrue([MSIDTestURLSession noResponsesLeft]);
     [MSIDAADNetworkConfiguration.defaultConfiguration setValue:nil forKey:@"aadApiVersion"];
     [MSIDTestSwizzle reset];
+    MSIDFlightManager.sharedInstance.flightProvider = nil;
     [super tearDown];
 }
 
@@ -202,6 +208,128 @@
     [self waitForExpectationsWithTimeout:1 handler:nil];
 }
 
+- (void)testInteractiveRequestFlow_whenPrefetchEnabled_shouldResolveAuthorityAtCreationAndReusePrefetchedPkceAndState
+{
+    MSIDFlightManagerMockProvider *flightProvider = [MSIDFlightManagerMockProvider new];
+    flightProvider.boolForKeyContainer = @{ MSID_FLIGHT_INTERACTIVE_PREFETCH_ENABLED : @YES };
+    MSIDFlightManager.sharedInstance.flightProvider = flightProvider;
+    
+    MSIDInteractiveTokenRequestParameters *parameters = [MSIDInteractiveTokenRequestParameters new];
+    parameters.target = @"fakescope1 fakescope2";
+    parameters.authority = [@"https://login.microsoftonline.com/common" aadAuthority];
+    parameters.redirectUri = @"x-msauth-test://com.microsoft.testapp";
+    parameters.clientId = @"my_client_id";
+    parameters.loginHint = @"fakeuser@contoso.com";
+    parameters.correlationId = [NSUUID new];
+    parameters.webviewType = MSIDWebviewTypeWKWebView;
+    parameters.oidcScope = @"openid profile offline_access";
+    parameters.authority.openIdConfigurationEndpoint = [NSURL URLWithString:@"https://login.microsoftonline.com/common/v2.0/.well-known/openid-configuration"];
+    parameters.enablePkce = YES;
+    
+    // Discovery and metadata are the only network calls the prefetch makes, stub them before the request is created.
+    NSString *authority = @"https://login.microsoftonline.com/common";
+    [MSIDTestURLSession addResponse:[MSIDTestURLResponse discoveryResponseForAuthority:authority]];
+    [MSIDTestURLSession addResponse:[MSIDTestURLResponse oidcResponseForAuthority:authority]];
+    
+    MSIDInteractiveTokenRequest *request = [[MSIDInteractiveTokenRequest alloc] initWithRequestParameters:parameters
+                                                                                             oauthFactory:[MSIDAADV2Oauth2Factory new] tokenResponseValidator:[MSIDDefaultTokenResponseValidator new]
+                                                                                               tokenCache:self.tokenCache accountMetadataCache:self.metadataCache extendedTokenCache:nil];
+    
+    MSIDInteractiveRequestPrefetchContext *prefetchContext = request.prefetchContext;
+    XCTAssertNotNil(prefetchContext);
+    XCTAssertTrue(prefetchContext.started);
+    
+    XCTestExpectation *prefetchExpectation = [self expectationWithDescription:@"Prefetch finished."];
+    [prefetchContext waitWithCompletion:^(NSError *error) {
+        XCTAssertNil(error);
+        [prefetchExpectation fulfill];
+    }];
+    [self waitForExpectations:@[prefetchExpectation] timeout:1];
+    
+    // Authority was resolved before the request was executed.
+    XCTAssertTrue([MSIDTestURLSession noResponsesLeft]);
+    XCTAssertNotNil(prefetchContext.pkce);
+    XCTAssertNotNil(prefetchContext.state);
+    
+    [MSIDTestSwizzle classMethod:@selector(startSessionWithWebView:oauth2Factory:configuration:context:completionHandler:)
+                           class:[MSIDWebviewAuthorization class]
+                           block:(id)^(
+                                __unused id obj,
+                                __unused NSObject<MSIDWebviewInteracting> *webview,
+                                __unused MSIDOauth2Factory *oauth2Factory,
+                                MSIDBaseWebRequestConfiguration *configuration,
+                                __unused id<MSIDRequestContext> context,
+                                MSIDWebviewAuthCompletionHandler completionHandler)
+    {
+        MSIDAuthorizeWebRequestConfiguration *authorizeConfiguration = (MSIDAuthorizeWebRequestConfiguration *)configuration;
+        XCTAssertEqual(authorizeConfiguration.pkce, prefetchContext.pkce);
+        XCTAssertEqualObjects(authorizeConfiguration.state, prefetchContext.state);
+        
+        NSString *responseString = [NSString stringWithFormat:@"x-msauth-test://com.microsoft.testapp?code=iamafakecode&client_info=%@", [@{ @"uid" : @"1", @"utid" : @"1234-5678-90abcdefg"} msidBase64UrlJson]];
+        
+        MSIDWebAADAuthCodeResponse *oauthResponse = [[MSIDWebAADAuthCodeResponse alloc] initWithURL:[NSURL URLWithString:responseString]
+                                                                                            context:nil error:nil];
+        completionHandler(oauthResponse, nil);
+    }];
+    
+    NSMutableDictionary *reqHeaders = [[MSIDTestURLResponse msidDefaultRequestHeaders] mutableCopy];
+    [reqHeaders setObject:@"application/x-www-form-urlencoded" forKey:@"Content-Type"];
+    
+    // Code redemption must use the verifier generated by the prefetch.
+    MSIDTestURLResponse *response =
+    [MSIDTestURLResponse requestURLString:@"https://login.microsoftonline.com/common/oauth2/v2.0/token"
+                           requestHeaders:reqHeaders
+                        requestParamsBody:@{ @"code" : @"iamafakecode",
+                                             @"client_id" : @"my_client_id",
+                                             @"scope" : @"fakescope1 fakescope2 openid profile offline_access",
+                                             @"redirect_uri" : @"x-msauth-test://com.microsoft.testapp",
+                                             @"grant_type" : @"authorization_code",
+                                             @"code_verifier" : prefetchContext.pkce.codeVerifier,
+                                             @"client_info" : @"1"}
+                        responseURLString:@"https://login.microsoftonline.com/common/oauth2/v2.0/token"
+                             responseCode:200
+                         httpHeaderFields:nil
+                         dictionaryAsJSON:@{ @"access_token" : @"i am a access token!",
+                                             @"expires_in" : @"600",
+                                             @"refresh_token" : @"i am a refresh token",
+                                             @"id_token" : [MSIDTestIdTokenUtil defaultV2IdToken],
+                                             @"id_token_expires_in" : @"1200",
+                                             @"client_info" : [@{ @"uid" : @"1", @"utid" : @"1234-5678-90abcdefg"} msidBase64UrlJson],
+                                             @"scope": @"fakescope1 fakescope2 openid profile offline_access"
+                                             }];
+    
+    [response->_requestHeaders removeObjectForKey:@"Content-Length"];
+    [MSIDTestURLSession addResponse:response];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Run request."];
+    
+    [request executeRequestWithCompletion:^(MSIDTokenResult * _Nullable result, NSError * _Nullable error, MSIDWebviewResponse * _Nullable installBrokerResponse) {
+        
+        XCTAssertNotNil(result);
+        XCTAssertNil(error);
+        XCTAssertNil(installBrokerResponse);
+        XCTAssertEqualObjects(result.accessToken.accessToken, @"i am a access token!");
+        XCTAssertGreaterThan(prefetchContext.authorizeURLReadyInterval, 0);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+}
+
+- (void)testInteractiveRequest_whenPrefetchDisabled_shouldNotStartPrefetch
+{
+    MSIDInteractiveTokenRequestParameters *parameters = [MSIDInteractiveTokenRequestParameters new];
+    parameters.authority = [@"https://login.microsoftonline.com/common" aadAuthority];
+    parameters.clientId = @"my_client_id";
+    
+    MSIDInteractiveTokenRequest *request = [[MSIDInteractiveTokenRequest alloc] initWithRequestParameters:parameters
+                                                                                             oauthFactory:[MSIDAADV2Oauth2Factory new] tokenResponseValidator:[MSIDDefaultTokenResponseValidator new]
+                                                                                               tokenCache:self.tokenCache accountMetadataCache:self.metadataCache extendedTokenCache:nil];
+    
+    XCTAssertNotNil(request);
+    XCTAssertNil(request.prefetchContext);
+}
+
 - (void)testInteractiveRequestFlow_whenValidWithCloudHostName_shouldReturnResultWithNoErrorAndCorrectAuthority
 {
     __block NSUUID *correlationId = [NSUUID new];
@@ -61,6 +61,8 @@
 #import "MSIDLastRequestTelemetry.h"
 #import "MSIDExecutionFlowLogger.h"
 #import "MSIDExecutionFlowConstants.h"
+#import "MSIDCircuitBreaker.h"
+#import "MSIDCircuitBreakerRegistry.h"
 
 @interface MSIDDefaultSilentTokenRequestTests : XCTestCase
 
@@ -1738,6 +1740,70 @@
     [self waitForExpectationsWithTimeout:1.0 handler:nil];
 }
 
+- (void)testAcquireTokenSilent_whenATExpiredButExtendedExpiresInFlagPresent_andTokenEndpointCircuitOpen_shouldReturnExtendedTokenWithoutNetworkCall
+{
+    [MSIDTestSwizzle instanceMethod:@selector(boolForKey:)
+                              class:[MSIDFlightManager class]
+                              block:(id)^(__unused id *obj, NSString *flightKey)
+     {
+        return [flightKey isEqualToString:MSID_FLIGHT_HTTP_CIRCUIT_BREAKER_ENABLED];
+     }];
+    
+    MSIDCircuitBreaker *circuitBreaker = [[MSIDCircuitBreakerRegistry sharedRegistry] circuitBreakerForURL:[NSURL URLWithString:DEFAULT_TEST_TOKEN_ENDPOINT_GUID]];
+    for (NSUInteger i = 0; i < circuitBreaker.failureThreshold; i++)
+    {
+        [circuitBreaker recordFailure];
+    }
+    XCTAssertEqual(circuitBreaker.state, MSIDCircuitBreakerStateOpen);
+    
+    MSIDRequestParameters *silentParameters = [self silentRequestParameters];
+    MSIDDefaultTokenCacheAccessor *tokenCache = self.tokenCache;
+
+    [self saveTokensInCache:tokenCache
+              configuration:silentParameters.msidConfiguration
+                      scope:nil
+                       foci:nil
+                accessToken:nil
+               refreshToken:nil
+                    idToken:nil
+                 clientInfo:nil
+                  expiresIn:@"1"
+               extExpiresIn:@"3600000"
+                  refreshIn:nil];
+
+    silentParameters.accountIdentifier = [[MSIDAccountIdentifier alloc] initWithDisplayableId:DEFAULT_TEST_ID_TOKEN_USERNAME homeAccountId:DEFAULT_TEST_HOME_ACCOUNT_ID];
+
+    NSString *authority = DEFAULT_TEST_AUTHORITY_GUID;
+    MSIDTestURLResponse *discoveryResponse = [MSIDTestURLResponse discoveryResponseForAuthority:authority];
+    [MSIDTestURLSession addResponse:discoveryResponse];
+
+    MSIDTestURLResponse *oidcResponse = [MSIDTestURLResponse oidcResponseForAuthority:authority];
+    [MSIDTestURLSession addResponse:oidcResponse];
+
+    // No token endpoint response: the open circuit must keep the request off the network.
+    MSIDDefaultSilentTokenRequest *silentRequest = [[MSIDDefaultSilentTokenRequest alloc] initWithRequestParameters:silentParameters
+                                                                                                       forceRefresh:NO
+                                                                                                       oauthFactory:[MSIDAADV2Oauth2Factory new]
+                                                                                             tokenResponseValidator:[MSIDDefaultTokenResponseValidator new]
+                                                                                                         tokenCache:tokenCache
+                                                                                                      accountMetadataCache:self.accountMetadataCache];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"silent request"];
+
+    [silentRequest executeRequestWithCompletion:^(MSIDTokenResult * _Nullable result, NSError * _Nullable error) {
+
+        XCTAssertNil(error);
+        XCTAssertNotNil(result);
+        XCTAssertEqualObjects(result.accessToken.accessToken, DEFAULT_TEST_ACCESS_TOKEN);
+        XCTAssertTrue(result.extendedLifeTimeToken);
+        [expectation fulfill];
+    }];
+
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+    XCTAssertEqual(circuitBreaker.metrics.rejectedRequestCount, 1u);
+    [[MSIDCircuitBreakerRegistry sharedRegistry] reset];
+}
+
 #pragma mark - FOCI
 
 - (void)testAcquireTokenSilent_whenExpiredAccessTokenInCache_andFamilyRefreshTokenInCache_shouldRefreshToken
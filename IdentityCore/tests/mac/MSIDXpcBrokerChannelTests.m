@@ -0,0 +1,362 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <XCTest/XCTest.h>
+#import "MSIDXpcBrokerChannel.h"
+#import "MSIDXpcLoopbackTransport.h"
+#import "MSIDError.h"
+
+typedef void (^MSIDXpcChannelTestReplyBlock)(NSDictionary *response, NSDate *startDate, NSString *processId, NSError *error);
+
+// Broker instance stand-in that holds replies until the test releases them, so several requests can be in flight.
+@interface MSIDXpcChannelTestBrokerService : NSObject <MSIDXpcBrokerInstanceProtocol>
+
+@property (nonatomic) NSMutableDictionary<NSString *, MSIDXpcChannelTestReplyBlock> *pendingReplies;
+@property (nonatomic) NSUInteger requestCount;
+
+- (NSUInteger)pendingReplyCount;
+- (void)replyToRequestId:(NSString *)requestId;
+
+@end
+
+@implementation MSIDXpcChannelTestBrokerService
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _pendingReplies = [NSMutableDictionary new];
+    }
+    
+    return self;
+}
+
+- (void)handleXpcWithRequestParams:(NSDictionary *)passedInParams
+                   parentViewFrame:(NSRect)__unused frame
+                   completionBlock:(MSIDXpcChannelTestReplyBlock)completionBlock
+{
+    @synchronized (self)
+    {
+        self.requestCount += 1;
+        self.pendingReplies[passedInParams[@"sso_request_id"]] = completionBlock;
+    }
+}
+
+- (void)canPerformWithMetadata:(NSDictionary *)__unused passedInParams
+               completionBlock:(void (^)(BOOL))completionBlock
+{
+    completionBlock(YES);
+}
+
+- (NSUInteger)pendingReplyCount
+{
+    @synchronized (self)
+    {
+        return self.pendingReplies.count;
+    }
+}
+
+- (void)replyToRequestId:(NSString *)requestId
+{
+    MSIDXpcChannelTestReplyBlock reply = nil;
+    @synchronized (self)
+    {
+        reply = self.pendingReplies[requestId];
+        [self.pendingReplies removeObjectForKey:requestId];
+    }
+    
+    if (reply) reply(@{@"sso_request_id": requestId}, [NSDate date], @"test-process", nil);
+}
+
+@end
+
+@interface MSIDXpcBrokerChannelTests : XCTestCase
+
+@property (nonatomic) MSIDXpcChannelTestBrokerService *service;
+@property (nonatomic) NSMutableArray<MSIDXpcBrokerChannelConnectionBlock> *connectionBlocks;
+@property (nonatomic) MSIDXpcBrokerChannel *channel;
+
+@end
+
+@implementation MSIDXpcBrokerChannelTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.service = [MSIDXpcChannelTestBrokerService new];
+    self.connectionBlocks = [NSMutableArray new];
+    
+    __weak typeof(self) weakSelf = self;
+    self.channel = [[MSIDXpcBrokerChannel alloc] initWithConnector:^(MSIDXpcBrokerChannelConnectionBlock connectionBlock) {
+        @synchronized (weakSelf.connectionBlocks)
+        {
+            [weakSelf.connectionBlocks addObject:connectionBlock];
+        }
+    }];
+}
+
+- (void)tearDown
+{
+    [self.channel invalidate];
+    self.channel = nil;
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (void)waitUntil:(BOOL (^)(void))condition
+{
+    NSPredicate *predicate = [NSPredicate predicateWithBlock:^BOOL(__unused id object, __unused NSDictionary *bindings) {
+        return condition();
+    }];
+    [self waitForExpectations:@[[[XCTNSPredicateExpectation alloc] initWithPredicate:predicate object:nil]] timeout:5.0];
+}
+
+- (NSUInteger)connectorCallCount
+{
+    @synchronized (self.connectionBlocks)
+    {
+        return self.connectionBlocks.count;
+    }
+}
+
+- (MSIDXpcLoopbackTransport *)connectLatestWithService:(id<MSIDXpcBrokerInstanceProtocol>)service
+{
+    MSIDXpcLoopbackTransport *transport = [[MSIDXpcLoopbackTransport alloc] initWithExportedObject:service];
+    MSIDXpcBrokerChannelConnectionBlock connectionBlock = nil;
+    @synchronized (self.connectionBlocks)
+    {
+        connectionBlock = self.connectionBlocks.lastObject;
+    }
+    
+    // Mirror the production connector, which reports drops through the same block.
+    transport.invalidationHandler = ^{
+        connectionBlock(nil, nil, [NSError errorWithDomain:NSCocoaErrorDomain code:NSXPCConnectionInvalid userInfo:nil]);
+    };
+    [transport resume];
+    connectionBlock(service, transport, nil);
+    return transport;
+}
+
+- (XCTestExpectation *)sendRequestId:(NSString *)requestId
+                        replyTimeout:(NSTimeInterval)replyTimeout
+                          completion:(MSIDXpcBrokerChannelReplyBlock)completion
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:requestId];
+    [self.channel sendRequest:@{@"sso_request_id": requestId}
+                correlationId:@"correlation"
+                 replyTimeout:replyTimeout
+                   completion:^(NSDictionary *reply, NSError *error, BOOL connectionDropped) {
+        if (completion) completion(reply, error, connectionDropped);
+        [expectation fulfill];
+    }];
+    return expectation;
+}
+
+#pragma mark - Tests
+
+- (void)testRequestsQueuedWhileConnecting_shareOneConnection_andArePipelined
+{
+    NSMutableDictionary *replies = [NSMutableDictionary new];
+    NSArray *requestIds = @[@"r1", @"r2", @"r3"];
+    NSMutableArray *expectations = [NSMutableArray new];
+    for (NSString *requestId in requestIds)
+    {
+        [expectations addObject:[self sendRequestId:requestId replyTimeout:0 completion:^(NSDictionary *reply, NSError *error, BOOL connectionDropped) {
+            XCTAssertNil(error);
+            XCTAssertFalse(connectionDropped);
+            @synchronized (replies)
+            {
+                replies[requestId] = reply;
+            }
+        }]];
+    }
+    
+    [self waitUntil:^BOOL{ return [self connectorCallCount] == 1; }];
+    MSIDXpcLoopbackTransport *transport = [self connectLatestWithService:self.service];
+    
+    // All three are sent before any reply arrives.
+    [self waitUntil:^BOOL{ return [self.service pendingReplyCount] == 3; }];
+    XCTAssertEqual(self.channel.metrics.inFlightCount, 3u);
+    XCTAssertEqual(self.channel.metrics.peakInFlightCount, 3u);
+    
+    // Replies can arrive in any order and are matched back to their requests.
+    [self.service replyToRequestId:@"r3"];
+    [self.service replyToRequestId:@"r1"];
+    [self.service replyToRequestId:@"r2"];
+    [self waitForExpectations:expectations timeout:5.0];
+    
+    for (NSString *requestId in requestIds)
+    {
+        XCTAssertEqualObjects(replies[requestId][@"sso_request_id"], requestId);
+    }
+    
+    MSIDXpcBrokerChannelMetrics *metrics = self.channel.metrics;
+    XCTAssertEqual([self connectorCallCount], 1u);
+    XCTAssertEqual(metrics.connectCount, 1u);
+    XCTAssertEqual(metrics.reconnectCount, 0u);
+    XCTAssertEqual(metrics.totalRequestCount, 3u);
+    XCTAssertEqual(metrics.inFlightCount, 0u);
+    XCTAssertFalse(transport.invalidated, @"connection stays open for later requests");
+}
+
+- (void)testRequestAfterConnected_isSentWithoutReconnecting
+{
+    XCTestExpectation *first = [self sendRequestId:@"r1" replyTimeout:0 completion:nil];
+    [self waitUntil:^BOOL{ return [self connectorCallCount] == 1; }];
+    [self connectLatestWithService:self.service];
+    [self waitUntil:^BOOL{ return [self.service pendingReplyCount] == 1; }];
+    [self.service replyToRequestId:@"r1"];
+    [self waitForExpectations:@[first] timeout:5.0];
+    
+    XCTestExpectation *second = [self sendRequestId:@"r2" replyTimeout:0 completion:nil];
+    [self waitUntil:^BOOL{ return [self.service pendingReplyCount] == 1; }];
+    [self.service replyToRequestId:@"r2"];
+    [self waitForExpectations:@[second] timeout:5.0];
+    
+    XCTAssertEqual([self connectorCallCount], 1u);
+    XCTAssertEqual(self.service.requestCount, 2u);
+}
+
+- (void)testConnectionDrop_failsInFlightAsDropped_andNextRequestReconnects
+{
+    __block NSError *dropError = nil;
+    __block BOOL dropped = NO;
+    XCTestExpectation *first = [self sendRequestId:@"r1" replyTimeout:0 completion:^(__unused NSDictionary *reply, NSError *error, BOOL connectionDropped) {
+        dropError = error;
+        dropped = connectionDropped;
+    }];
+    [self waitUntil:^BOOL{ return [self connectorCallCount] == 1; }];
+    MSIDXpcLoopbackTransport *transport = [self connectLatestWithService:self.service];
+    [self waitUntil:^BOOL{ return [self.service pendingReplyCount] == 1; }];
+    
+    [transport simulateInvalidation];
+    [self waitForExpectations:@[first] timeout:5.0];
+    XCTAssertTrue(dropped);
+    XCTAssertEqualObjects(dropError.domain, MSIDErrorDomain);
+    XCTAssertEqual(dropError.code, MSIDErrorBrokerXpcUnexpectedError);
+    
+    // A late reply for the dropped request is ignored.
+    [self.service replyToRequestId:@"r1"];
+    
+    XCTestExpectation *second = [self sendRequestId:@"r2" replyTimeout:0 completion:^(NSDictionary *reply, NSError *error, __unused BOOL connectionDropped) {
+        XCTAssertNotNil(reply);
+        XCTAssertNil(error);
+    }];
+    [self waitUntil:^BOOL{ return [self connectorCallCount] == 2; }];
+    [self connectLatestWithService:self.service];
+    [self waitUntil:^BOOL{ return [self.service pendingReplyCount] == 1; }];
+    [self.service replyToRequestId:@"r2"];
+    [self waitForExpectations:@[second] timeout:5.0];
+    
+    MSIDXpcBrokerChannelMetrics *metrics = self.channel.metrics;
+    XCTAssertEqual(metrics.connectCount, 2u);
+    XCTAssertEqual(metrics.reconnectCount, 1u);
+    XCTAssertEqual(metrics.failedRequestCount, 1u);
+}
+
+- (void)testConnectFailure_failsQueuedRequestsWithoutDroppedFlag
+{
+    NSError *connectError = [NSError errorWithDomain:@"test" code:1 userInfo:nil];
+    __block NSError *capturedError = nil;
+    __block BOOL dropped = YES;
+    XCTestExpectation *expectation = [self sendRequestId:@"r1" replyTimeout:0 completion:^(__unused NSDictionary *reply, NSError *error, BOOL connectionDropped) {
+        capturedError = error;
+        dropped = connectionDropped;
+    }];
+    [self waitUntil:^BOOL{ return [self connectorCallCount] == 1; }];
+    
+    MSIDXpcBrokerChannelConnectionBlock connectionBlock = self.connectionBlocks.lastObject;
+    connectionBlock(nil, nil, connectError);
+    [self waitForExpectations:@[expectation] timeout:5.0];
+    
+    XCTAssertEqualObjects(capturedError, connectError);
+    XCTAssertFalse(dropped, @"nothing was sent, so the request was not dropped mid-flight");
+    XCTAssertEqual(self.channel.metrics.connectCount, 0u);
+}
+
+- (void)testReplyTimeout_failsOnlyTimedOutRequest_connectionStaysOpen
+{
+    __block NSError *timeoutError = nil;
+    XCTestExpectation *expectation = [self sendRequestId:@"r1" replyTimeout:0.1 completion:^(__unused NSDictionary *reply, NSError *error, BOOL connectionDropped) {
+        timeoutError = error;
+        XCTAssertFalse(connectionDropped);
+    }];
+    [self waitUntil:^BOOL{ return [self connectorCallCount] == 1; }];
+    MSIDXpcLoopbackTransport *transport = [self connectLatestWithService:self.service];
+    [self waitForExpectations:@[expectation] timeout:5.0];
+    
+    XCTAssertEqual(timeoutError.code, MSIDErrorBrokerXpcUnexpectedError);
+    XCTAssertFalse(transport.invalidated);
+    XCTAssertEqual(self.channel.metrics.inFlightCount, 0u);
+}
+
+- (void)testQueueWait_isRecordedWhileConnectionIsPending
+{
+    XCTestExpectation *expectation = [self sendRequestId:@"r1" replyTimeout:0 completion:nil];
+    [self waitUntil:^BOOL{ return [self connectorCallCount] == 1; }];
+    [NSThread sleepForTimeInterval:0.1];
+    [self connectLatestWithService:self.service];
+    [self waitUntil:^BOOL{ return [self.service pendingReplyCount] == 1; }];
+    [self.service replyToRequestId:@"r1"];
+    [self waitForExpectations:@[expectation] timeout:5.0];
+    
+    MSIDXpcBrokerChannelMetrics *metrics = self.channel.metrics;
+    XCTAssertGreaterThanOrEqual(metrics.lastQueueWait, 0.1);
+    XCTAssertGreaterThanOrEqual(metrics.maxQueueWait, metrics.lastQueueWait);
+    XCTAssertGreaterThan(metrics.averageQueueWait, 0);
+}
+
+- (void)testIdleTimeout_closesConnection
+{
+    self.channel.idleTimeout = 0.1;
+    XCTestExpectation *expectation = [self sendRequestId:@"r1" replyTimeout:0 completion:nil];
+    [self waitUntil:^BOOL{ return [self connectorCallCount] == 1; }];
+    MSIDXpcLoopbackTransport *transport = [self connectLatestWithService:self.service];
+    [self waitUntil:^BOOL{ return [self.service pendingReplyCount] == 1; }];
+    [self.service replyToRequestId:@"r1"];
+    [self waitForExpectations:@[expectation] timeout:5.0];
+    
+    [self waitUntil:^BOOL{ return transport.invalidated; }];
+    XCTAssertEqual(self.channel.metrics.failedRequestCount, 0u);
+}
+
+- (void)testInvalidate_failsQueuedAndInFlightRequests
+{
+    XCTestExpectation *inFlight = [self sendRequestId:@"r1" replyTimeout:0 completion:^(__unused NSDictionary *reply, NSError *error, BOOL connectionDropped) {
+        XCTAssertNotNil(error);
+        XCTAssertFalse(connectionDropped);
+    }];
+    [self waitUntil:^BOOL{ return [self connectorCallCount] == 1; }];
+    MSIDXpcLoopbackTransport *transport = [self connectLatestWithService:self.service];
+    [self waitUntil:^BOOL{ return [self.service pendingReplyCount] == 1; }];
+    
+    [self.channel invalidate];
+    [self waitForExpectations:@[inFlight] timeout:5.0];
+    XCTAssertTrue(transport.invalidated);
+    XCTAssertEqual(self.channel.metrics.inFlightCount, 0u);
+}
+
+@end
@@ -42,6 +42,9 @@
 #import "MSIDInteractiveTokenRequestParameters.h"
 #import "MSIDAADV2Oauth2Factory.h"
 #import "MSIDDefaultTokenResponseValidator.h"
+#import "MSIDXpcCapabilityResult.h"
+#import "MSIDXpcLoopbackTransport.h"
+#import "MSIDXpcBrokerChannel.h"
 
 typedef void (^MSIDXpcTestEndpointReplyBlock)(NSXPCListenerEndpoint *endpoint, NSDictionary *parameters, NSError *error);
 typedef void (^MSIDXpcTestBrokerReplyBlock)(NSDictionary *response, NSDate *startDate, NSString *processId, NSError *error);
@@ -53,6 +56,7 @@ typedef void (^MSIDXpcTestBrokerReplyBlock)(NSDictionary *response, NSDate *star
 - (void)scheduleBlock:(dispatch_block_t)block afterTimeout:(NSTimeInterval)timeout;
 - (NSString *)codeSignRequirementForBundleId:(NSString *)bundleId devIdentity:(NSString *)devIdentity;
 - (BOOL)isXpcPlatformSupported;
+- (MSIDXpcBrokerChannel *)brokerChannelForProviderCache:(id<MSIDXpcProviderCaching>)xpcProviderCache;
 
 @end
 
@@ -286,6 +290,29 @@ typedef void (^MSIDXpcTestBrokerReplyBlock)(NSDictionary *response, NSDate *star
 
 @end
 
+// Drives the real connection code paths over in-process loopback transports instead of NSXPCConnection.
+@interface MSIDXpcLoopbackSingleSignOnProvider : MSIDXpcTestSingleSignOnProvider
+
+@property (nonatomic) MSIDXpcLoopbackTransport *dispatcherTransport;
+@property (nonatomic) MSIDXpcLoopbackTransport *directTransport;
+
+@end
+
+@implementation MSIDXpcLoopbackSingleSignOnProvider
+
+- (NSXPCConnection *)dispatcherConnectionWithMachServiceName:(NSString *)__unused machServiceName
+{
+    return (NSXPCConnection *)self.dispatcherTransport;
+}
+
+- (NSXPCConnection *)directConnectionWithEndpoint:(NSXPCListenerEndpoint *)__unused endpoint
+{
+    self.directConnectionRequestCount += 1;
+    return (NSXPCConnection *)self.directTransport;
+}
+
+@end
+
 @interface MSIDXpcSingleSignOnProviderTest : XCTestCase
 
 @property (nonatomic) MSIDFlightManagerMockProvider *flightProvider;
@@ -1302,6 +1329,235 @@ typedef void (^MSIDXpcTestBrokerReplyBlock)(NSDictionary *response, NSDate *star
     }
 }
 
+#pragma mark - Capability result cache
+
+- (void)swizzleDeviceInfoHandshakeWithCallCount:(NSUInteger *)callCount
+{
+    [MSIDTestSwizzle classMethod:NSSelectorFromString(@"canPerformRequest")
+                           class:[MSIDSSOExtensionGetDeviceInfoRequest class]
+                           block:(id)^(void)
+    {
+        return YES;
+    }];
+
+    [MSIDTestSwizzle instanceMethod:NSSelectorFromString(@"executeRequestWithCompletion:")
+                              class:[MSIDSSOExtensionGetDeviceInfoRequest class]
+                              block:(id)^(id __unused selfRef, MSIDGetDeviceInfoRequestCompletionBlock completionBlock)
+     {
+        @synchronized (self)
+        {
+            *callCount += 1;
+        }
+        completionBlock(nil, nil);
+     }];
+}
+
+- (void)testCanPerformRequest_secondCall_isAnsweredFromCachedResultWithoutHandshake
+{
+    __block NSUInteger handshakeCount = 0;
+    [self swizzleDeviceInfoHandshakeWithCallCount:&handshakeCount];
+
+    MSIDXpcProviderCacheMock *cacheMock = [[MSIDXpcProviderCacheMock alloc] initWithXpcInstallationStatus:YES
+                                                                                           isXpcValidated:YES];
+
+    XCTAssertTrue([MSIDXpcSingleSignOnProvider canPerformRequest:cacheMock]);
+    XCTAssertEqual(handshakeCount, 1u);
+    XCTAssertNotNil(cacheMock.cachedCapabilityResult);
+    XCTAssertTrue(cacheMock.cachedCapabilityResult.canPerform);
+
+    MSIDXpcCanPerformFailureReason reason = MSIDXpcCanPerformFailureReasonNoProviderInstalled;
+    XCTAssertTrue([MSIDXpcSingleSignOnProvider canPerformRequest:cacheMock reason:&reason]);
+    XCTAssertEqual(reason, MSIDXpcCanPerformFailureReasonNone);
+    XCTAssertEqual(handshakeCount, 1u, @"fresh cached result must not re-run the handshake");
+    XCTAssertEqual(cacheMock.beginCapabilityRefreshCallCount, 0u);
+}
+
+- (void)testCanPerformRequest_cachedFailure_returnsCachedReason
+{
+    MSIDXpcProviderCacheMock *cacheMock = [[MSIDXpcProviderCacheMock alloc] initWithXpcInstallationStatus:YES
+                                                                                           isXpcValidated:YES];
+    cacheMock.cachedCapabilityResult = [[MSIDXpcCapabilityResult alloc] initWithCanPerform:NO
+                                                                             failureReason:MSIDXpcCanPerformFailureReasonValidateCacheProviderFailed
+                                                                                 probeDate:[NSDate date]];
+
+    MSIDXpcCanPerformFailureReason reason = MSIDXpcCanPerformFailureReasonNone;
+    XCTAssertFalse([MSIDXpcSingleSignOnProvider canPerformRequest:cacheMock reason:&reason]);
+    XCTAssertEqual(reason, MSIDXpcCanPerformFailureReasonValidateCacheProviderFailed);
+}
+
+- (void)testCanPerformRequest_staleResult_returnsImmediatelyAndRefreshesOnceInBackground
+{
+    [MSIDTestSwizzle classMethod:NSSelectorFromString(@"canPerformRequest")
+                           class:[MSIDSSOExtensionGetDeviceInfoRequest class]
+                           block:(id)^(void)
+    {
+        return YES;
+    }];
+
+    XCTestExpectation *handshakeExpectation = [self expectationWithDescription:@"background handshake started"];
+    [MSIDTestSwizzle instanceMethod:NSSelectorFromString(@"executeRequestWithCompletion:")
+                              class:[MSIDSSOExtensionGetDeviceInfoRequest class]
+                              block:(id)^(id __unused selfRef, MSIDGetDeviceInfoRequestCompletionBlock __unused completionBlock)
+     {
+        // Never complete, so the background probe stays in flight for its full 1 sec wait.
+        [handshakeExpectation fulfill];
+     }];
+
+    MSIDXpcProviderCacheMock *cacheMock = [[MSIDXpcProviderCacheMock alloc] initWithXpcInstallationStatus:YES
+                                                                                           isXpcValidated:YES];
+    NSDate *expiredProbeDate = [NSDate dateWithTimeIntervalSinceNow:-(MSIDXpcCapabilityResultDefaultTTL + 1)];
+    cacheMock.cachedCapabilityResult = [[MSIDXpcCapabilityResult alloc] initWithCanPerform:NO
+                                                                             failureReason:MSIDXpcCanPerformFailureReasonValidateCacheProviderFailed
+                                                                                 probeDate:expiredProbeDate];
+
+    NSDate *start = [NSDate date];
+    XCTAssertFalse([MSIDXpcSingleSignOnProvider canPerformRequest:cacheMock]);
+    XCTAssertFalse([MSIDXpcSingleSignOnProvider canPerformRequest:cacheMock]);
+    XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:start], 0.5, @"callers must not wait for the probe");
+
+    [self waitForExpectations:@[handshakeExpectation] timeout:1.0];
+    XCTAssertEqual(cacheMock.beginCapabilityRefreshCallCount, 2u);
+    XCTAssertEqual(cacheMock.capabilityRefreshStartedCount, 1u, @"concurrent stale reads must share one refresh");
+
+    NSPredicate *refreshed = [NSPredicate predicateWithBlock:^BOOL(MSIDXpcProviderCacheMock *cache, __unused NSDictionary *bindings) {
+        return cache.cachedCapabilityResult.canPerform;
+    }];
+    [self waitForExpectations:@[[[XCTNSPredicateExpectation alloc] initWithPredicate:refreshed object:cacheMock]] timeout:5.0];
+}
+
+- (void)testCanPerformRequest_concurrentFirstCallers_shareOneProbe
+{
+    MSIDXpcProviderCacheMock *cacheMock = [[MSIDXpcProviderCacheMock alloc] initWithXpcInstallationStatus:NO
+                                                                                           isXpcValidated:NO];
+    cacheMock.installationCheckDelay = 0.3;
+    
+    __block NSUInteger canPerformCount = 0;
+    __block NSUInteger unexpectedReasonCount = 0;
+    dispatch_apply(5, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(__unused size_t i) {
+        MSIDXpcCanPerformFailureReason reason = MSIDXpcCanPerformFailureReasonNone;
+        BOOL canPerform = [MSIDXpcSingleSignOnProvider canPerformRequest:cacheMock reason:&reason];
+        @synchronized (self)
+        {
+            if (canPerform) canPerformCount++;
+            if (reason != MSIDXpcCanPerformFailureReasonNoProviderInstalled) unexpectedReasonCount++;
+        }
+    });
+    
+    XCTAssertEqual(cacheMock.isXpcProviderInstalledOnDeviceCallCount, 1u, @"concurrent first callers must wait for one probe");
+    XCTAssertEqual(canPerformCount, 0u);
+    XCTAssertEqual(unexpectedReasonCount, 0u);
+}
+
+- (void)testCapabilityResult_staleness
+{
+    MSIDXpcCapabilityResult *fresh = [[MSIDXpcCapabilityResult alloc] initWithCanPerform:YES
+                                                                           failureReason:MSIDXpcCanPerformFailureReasonNone
+                                                                               probeDate:[NSDate date]];
+    XCTAssertFalse([fresh isStaleWithTTL:60]);
+    XCTAssertTrue([fresh isStaleWithTTL:0]);
+
+    MSIDXpcCapabilityResult *invalidated = [fresh invalidatedResult];
+    XCTAssertTrue(invalidated.invalidated);
+    XCTAssertTrue(invalidated.canPerform);
+    XCTAssertTrue([invalidated isStaleWithTTL:60]);
+    XCTAssertFalse(fresh.invalidated);
+
+    MSIDXpcCapabilityResult *timedOut = [[MSIDXpcCapabilityResult alloc] initWithCanPerform:YES
+                                                                              failureReason:MSIDXpcCanPerformFailureReasonDeviceInfoHandshakeTimeout
+                                                                                  probeDate:[NSDate date]];
+    XCTAssertTrue([timedOut isStaleWithTTL:60], @"transient handshake failures should be re-probed");
+}
+
+- (void)testBrokerChannel_isReusedPerProviderCache_andReleasedWithIt
+{
+    MSIDXpcSingleSignOnProvider *provider = [MSIDXpcSingleSignOnProvider new];
+    __weak MSIDXpcProviderCacheMock *weakCache = nil;
+    __weak MSIDXpcBrokerChannel *weakChannel = nil;
+    
+    @autoreleasepool
+    {
+        MSIDXpcProviderCacheMock *cache = [self configuredXpcProviderCache];
+        MSIDXpcBrokerChannel *channel = [provider brokerChannelForProviderCache:cache];
+        
+        XCTAssertNotNil(channel);
+        XCTAssertEqual([provider brokerChannelForProviderCache:cache], channel);
+        XCTAssertNotEqual([provider brokerChannelForProviderCache:[self configuredXpcProviderCache]], channel);
+        XCTAssertNotNil([MSIDXpcSingleSignOnProvider brokerChannelMetricsForProviderCache:cache]);
+        
+        weakCache = cache;
+        weakChannel = channel;
+    }
+    
+    XCTAssertNil(weakCache, @"broker channel must not keep its provider cache alive");
+    XCTAssertNil(weakChannel, @"broker channel should be released with its provider cache");
+}
+
+- (void)testLoopbackDirectConnectionInvalidated_beforeReply_invalidatesCachedCapabilityResult
+{
+    MSIDXpcTestDispatcherProxy *dispatcherProxy = [MSIDXpcTestDispatcherProxy new];
+    MSIDXpcTestBrokerProxy *brokerProxy = [MSIDXpcTestBrokerProxy new];
+
+    MSIDXpcLoopbackSingleSignOnProvider *provider = [MSIDXpcLoopbackSingleSignOnProvider new];
+    provider.dispatcherTransport = [[MSIDXpcLoopbackTransport alloc] initWithExportedObject:dispatcherProxy];
+    provider.directTransport = [[MSIDXpcLoopbackTransport alloc] initWithExportedObject:brokerProxy];
+
+    MSIDXpcProviderCacheMock *cacheMock = [self configuredXpcProviderCache];
+    cacheMock.cachedCapabilityResult = [[MSIDXpcCapabilityResult alloc] initWithCanPerform:YES
+                                                                             failureReason:MSIDXpcCanPerformFailureReasonNone
+                                                                                 probeDate:[NSDate date]];
+
+    __block NSUInteger completionCount = 0;
+    __block NSError *capturedError = nil;
+    [self startRequestWithProvider:provider
+                             cache:cacheMock
+                        completion:^(__unused id response, NSError *error) {
+        completionCount += 1;
+        capturedError = error;
+    }];
+    [dispatcherProxy replyWithEndpoint:[NSXPCListenerEndpoint new] error:nil];
+
+    XCTAssertTrue(provider.dispatcherTransport.invalidated, @"dispatcher connection is released once the endpoint is received");
+    XCTAssertTrue(provider.directTransport.resumed);
+    XCTAssertEqual(completionCount, 0u);
+
+    [provider.directTransport simulateInvalidation];
+    [brokerProxy replyWithResponse:[self successfulBrokerResponse] error:nil];
+
+    XCTAssertEqual(completionCount, 1u);
+    XCTAssertNotNil(capturedError);
+    XCTAssertEqual(cacheMock.invalidateCachedCapabilityResultCallCount, 1u);
+    XCTAssertTrue(cacheMock.cachedCapabilityResult.invalidated);
+    XCTAssertTrue(cacheMock.cachedCapabilityResult.canPerform, @"last known result keeps answering callers until refreshed");
+}
+
+- (void)testLoopbackReplyThenOwnInvalidate_doesNotInvalidateCachedCapabilityResult
+{
+    MSIDXpcTestDispatcherProxy *dispatcherProxy = [MSIDXpcTestDispatcherProxy new];
+    MSIDXpcTestBrokerProxy *brokerProxy = [MSIDXpcTestBrokerProxy new];
+
+    MSIDXpcLoopbackSingleSignOnProvider *provider = [MSIDXpcLoopbackSingleSignOnProvider new];
+    provider.dispatcherTransport = [[MSIDXpcLoopbackTransport alloc] initWithExportedObject:dispatcherProxy];
+    provider.directTransport = [[MSIDXpcLoopbackTransport alloc] initWithExportedObject:brokerProxy];
+
+    MSIDXpcProviderCacheMock *cacheMock = [self configuredXpcProviderCache];
+
+    __block NSUInteger completionCount = 0;
+    __block id capturedResponse = nil;
+    [self startRequestWithProvider:provider
+                             cache:cacheMock
+                        completion:^(id response, __unused NSError *error) {
+        completionCount += 1;
+        capturedResponse = response;
+    }];
+    [dispatcherProxy replyWithEndpoint:[NSXPCListenerEndpoint new] error:nil];
+    [brokerProxy replyWithResponse:[self successfulBrokerResponse] error:nil];
+
+    XCTAssertEqual(completionCount, 1u);
+    XCTAssertNotNil(capturedResponse);
+    XCTAssertTrue(provider.directTransport.invalidated);
+    XCTAssertEqual(cacheMock.invalidateCachedCapabilityResultCallCount, 0u);
+}
+
 - (void)swizzleProviderCanPerformRequestReturning:(BOOL)result
                                             reason:(MSIDXpcCanPerformFailureReason)reasonValue
 {
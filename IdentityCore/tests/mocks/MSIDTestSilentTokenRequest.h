@@ -29,6 +29,8 @@
 
 @property (nonatomic) MSIDTokenResult *testTokenResult;
 @property (nonatomic) NSError *testError;
+// Delays the completion to simulate a slow request.
+@property (nonatomic) NSTimeInterval responseDelay;
 
 - (instancetype)initWithTestResponse:(MSIDTokenResult *)tokenResult
                            testError:(NSError *)error;
@@ -45,15 +45,34 @@
 #pragma mark - MSIDSilentTokenRequest
 
 - (void)executeRequestWithCompletion:(MSIDRequestCompletionBlock)completionBlock
+{
+    if (self.responseDelay > 0)
+    {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.responseDelay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [self completeRequestWithCompletion:completionBlock];
+        });
+        return;
+    }
+    
+    [self completeRequestWithCompletion:completionBlock];
+}
+
+- (void)completeRequestWithCompletion:(MSIDRequestCompletionBlock)completionBlock
 {
     if (self.skipLocalRt)
     {
         completionBlock(nil, nil);
+        return;
     }
-    else
+    
+    // Mirrors MSIDTokenResponseHandler, only the leg that wins a hedged request saves its response.
+    if (self.testTokenResult && self.hedge && ![self.hedge claimCacheWriteForLeg:self.hedgeLeg])
     {
-        completionBlock(self.testTokenResult, self.testError);
+        completionBlock(nil, [self.hedge cancellationErrorForLeg:self.hedgeLeg correlationId:nil]);
+        return;
     }
+    
+    completionBlock(self.testTokenResult, self.testError);
 }
 
 @end
@@ -31,6 +31,9 @@
 @interface MSIDTestTokenRequestProvider : NSObject <MSIDTokenRequestProviding>
 
 @property (nonatomic) MSIDTestSilentTokenRequest *silentRequest;
+@property (nonatomic) MSIDAccountMetadataSource accountSource;
+// Applied to silent requests created by the provider.
+@property (nonatomic) NSTimeInterval silentResponseDelay;
 
 - (instancetype)initWithTestResponse:(MSIDTokenResult *)tokenResult
                            testError:(NSError *)error
@@ -91,6 +91,7 @@
     if (!self.silentRequest)
     {
         _silentRequest = [[MSIDTestSilentTokenRequest alloc] initWithTestResponse:self.testTokenResult testError:self.testError];
+        _silentRequest.responseDelay = self.silentResponseDelay;
         return self.silentRequest;
     }
     return self.silentRequest;
@@ -124,7 +125,9 @@
 
 - (nullable MSIDSilentTokenRequest *)silentSSOExtensionTokenRequestWithParameters:(nonnull __unused MSIDRequestParameters *)parameters forceRefresh:(__unused BOOL)forceRefresh
 {
-    return [[MSIDTestSilentTokenRequest alloc] initWithTestResponse:self.testTokenResult testError:self.testError];
+    MSIDTestSilentTokenRequest *request = [[MSIDTestSilentTokenRequest alloc] initWithTestResponse:self.testTokenResult testError:self.testError];
+    request.responseDelay = self.silentResponseDelay;
+    return request;
 }
 
 - (nullable MSIDSilentTokenRequest *)silentXpcTokenRequestWithParameters:(nonnull MSIDRequestParameters *)parameters forceRefresh:(BOOL)forceRefresh { 
@@ -132,4 +135,9 @@
 }
 
 
+- (MSIDAccountMetadataSource)accountSourceForParameters:(nonnull __unused MSIDRequestParameters *)parameters
+{
+    return self.accountSource;
+}
+
 @end
@@ -0,0 +1,50 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+#import "MSIDXpcTransport.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// In-process stand-in for NSXPCConnection. Messages sent to the remote proxy are delivered directly
+// to exportedObject, and connection lifecycle events can be simulated from tests.
+@interface MSIDXpcLoopbackTransport : NSObject <MSIDXpcTransport>
+
+@property (nonatomic, readonly, nullable) id exportedObject;
+@property (nonatomic, readonly) BOOL resumed;
+@property (nonatomic, readonly) BOOL invalidated;
+@property (nonatomic, readonly) NSUInteger resumeCount;
+@property (nonatomic, readonly) NSUInteger invalidateCount;
+@property (nonatomic, readonly) NSUInteger proxyRequestCount;
+
+- (instancetype)initWithExportedObject:(nullable id)exportedObject;
+
+- (void)simulateInterruption;
+// Mirrors NSXPCConnection: the invalidation handler fires at most once per connection.
+- (void)simulateInvalidation;
+- (void)simulateProxyError:(NSError *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,113 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDXpcLoopbackTransport.h"
+
+@interface MSIDXpcLoopbackTransport ()
+
+@property (nonatomic, readwrite, nullable) id exportedObject;
+@property (nonatomic, readwrite) BOOL resumed;
+@property (nonatomic, readwrite) BOOL invalidated;
+@property (nonatomic, readwrite) NSUInteger resumeCount;
+@property (nonatomic, readwrite) NSUInteger invalidateCount;
+@property (nonatomic, readwrite) NSUInteger proxyRequestCount;
+@property (nonatomic, copy, nullable) void (^proxyErrorHandler)(NSError *error);
+
+@end
+
+@implementation MSIDXpcLoopbackTransport
+
+@synthesize remoteObjectInterface;
+@synthesize interruptionHandler;
+@synthesize invalidationHandler;
+
+- (instancetype)initWithExportedObject:(id)exportedObject
+{
+    self = [super init];
+    if (self)
+    {
+        _exportedObject = exportedObject;
+    }
+    
+    return self;
+}
+
+- (void)setCodeSigningRequirement:(NSString *)__unused requirement
+{
+}
+
+- (void)resume
+{
+    self.resumeCount += 1;
+    self.resumed = YES;
+}
+
+- (void)suspend
+{
+    self.resumed = NO;
+}
+
+- (void)invalidate
+{
+    self.invalidateCount += 1;
+    [self simulateInvalidation];
+}
+
+- (id)remoteObjectProxyWithErrorHandler:(void (^)(NSError *error))handler
+{
+    self.proxyRequestCount += 1;
+    self.proxyErrorHandler = handler;
+    
+    if (self.invalidated)
+    {
+        if (handler) handler([NSError errorWithDomain:NSCocoaErrorDomain code:NSXPCConnectionInvalid userInfo:nil]);
+        return nil;
+    }
+    
+    return self.exportedObject;
+}
+
+- (void)simulateInterruption
+{
+    if (self.interruptionHandler) self.interruptionHandler();
+}
+
+- (void)simulateInvalidation
+{
+    if (self.invalidated) return;
+    
+    self.invalidated = YES;
+    void (^handler)(void) = self.invalidationHandler;
+    // Like NSXPCConnection, drop the handlers once the connection is invalid.
+    self.invalidationHandler = nil;
+    self.interruptionHandler = nil;
+    if (handler) handler();
+}
+
+- (void)simulateProxyError:(NSError *)error
+{
+    if (self.proxyErrorHandler) self.proxyErrorHandler(error);
+}
+
+@end
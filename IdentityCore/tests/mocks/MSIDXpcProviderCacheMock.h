@@ -34,6 +34,13 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly) NSUInteger cachedBrokerInstanceEndpointSetCount;
 @property (nonatomic, readonly) NSUInteger setCachedBrokerInstanceEndpointRejectedCount;
 @property (nonatomic, readonly) NSUInteger clearCachedBrokerInstanceEndpointCallCount;
+@property (nonatomic, readonly) NSUInteger invalidateCachedCapabilityResultCallCount;
+@property (nonatomic, readonly) NSUInteger beginCapabilityRefreshCallCount;
+@property (nonatomic, readonly) NSUInteger capabilityRefreshStartedCount;
+@property (atomic, readonly) NSUInteger isXpcProviderInstalledOnDeviceCallCount;
+
+// Delays the installation check, which is the first step of every capability probe.
+@property (atomic) NSTimeInterval installationCheckDelay;
 
 - (instancetype)initWithXpcInstallationStatus:(BOOL)xpcInstallationStatus
                                isXpcValidated:(BOOL)isXpcValidated;
@@ -24,6 +24,7 @@
 
 
 #import "MSIDXpcProviderCacheMock.h"
+#import "MSIDXpcCapabilityResult.h"
 
 @interface MSIDXpcProviderCacheMock()
 
@@ -33,6 +34,10 @@
 @property (nonatomic, readwrite) NSUInteger cachedBrokerInstanceEndpointSetCount;
 @property (nonatomic, readwrite) NSUInteger setCachedBrokerInstanceEndpointRejectedCount;
 @property (nonatomic, readwrite) NSUInteger clearCachedBrokerInstanceEndpointCallCount;
+@property (nonatomic, readwrite) NSUInteger invalidateCachedCapabilityResultCallCount;
+@property (nonatomic, readwrite) NSUInteger beginCapabilityRefreshCallCount;
+@property (nonatomic, readwrite) NSUInteger capabilityRefreshStartedCount;
+@property (atomic, readwrite) NSUInteger isXpcProviderInstalledOnDeviceCallCount;
 
 @end
 
@@ -40,9 +45,12 @@
 {
     NSXPCListenerEndpoint *_cachedBrokerInstanceEndpoint;
     MSIDSsoProviderType _cachedXpcProviderType;
+    BOOL _capabilityRefreshInFlight;
 }
 
 @synthesize xpcConfiguration;
+@synthesize cachedCapabilityResult;
+@synthesize capabilityResultTTL;
 
 - (instancetype)initWithXpcInstallationStatus:(BOOL)xpcInstallationStatus
                                isXpcValidated:(BOOL)isXpcValidated
@@ -52,6 +60,7 @@
     {
         self.isXpcProviderInstalledOnDevice = xpcInstallationStatus;
         self.isXpcValidated = isXpcValidated;
+        self.capabilityResultTTL = MSIDXpcCapabilityResultDefaultTTL;
         
         return self;
     }
@@ -66,6 +75,12 @@
 
 - (BOOL)isXpcProviderInstalledOnDevice
 {
+    @synchronized (self)
+    {
+        self.isXpcProviderInstalledOnDeviceCallCount += 1;
+    }
+    
+    if (self.installationCheckDelay > 0) [NSThread sleepForTimeInterval:self.installationCheckDelay];
     return _isXpcProviderInstalledOnDevice;
 }
 
@@ -107,6 +122,34 @@
     _cachedBrokerInstanceEndpoint = nil;
 }
 
-@end
+- (void)invalidateCachedCapabilityResult
+{
+    @synchronized (self)
+    {
+        self.invalidateCachedCapabilityResultCallCount += 1;
+        self.cachedCapabilityResult = [self.cachedCapabilityResult invalidatedResult];
+    }
+}
 
+- (BOOL)beginCapabilityRefresh
+{
+    @synchronized (self)
+    {
+        self.beginCapabilityRefreshCallCount += 1;
+        if (_capabilityRefreshInFlight) return NO;
+        
+        _capabilityRefreshInFlight = YES;
+        self.capabilityRefreshStartedCount += 1;
+        return YES;
+    }
+}
 
+- (void)endCapabilityRefresh
+{
+    @synchronized (self)
+    {
+        _capabilityRefreshInFlight = NO;
+    }
+}
+
+@end
@@ -0,0 +1,50 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+#import <XCTest/XCTest.h>
+
+/*!
+    Base class for benchmarks. Benchmarks are skipped unless MSID_RUN_BENCHMARKS is set in the test environment,
+    so they don't slow down the regular test run (build.py --targets mac_benchmarks runs them).
+ 
+    Every benchmark takes MSID_BENCHMARK_SAMPLES timed samples (15 by default) after a warm up sample and reports
+    the median, p90 and minimum time per operation in nanoseconds. When MSID_BENCHMARK_OUTPUT is set, results are
+    merged into the JSON file at that path, scripts/compare_benchmarks.py compares two such files.
+ */
+@interface MSIDBenchmarkTestCase : XCTestCase
+
+/*! Times `operations` consecutive invocations of the block per sample. */
+- (void)benchmark:(NSString *)name
+       operations:(NSUInteger)operations
+            block:(void (^)(void))block;
+
+/*! Times one asynchronous operation per sample, the block has to call done when the operation finishes. */
+- (void)benchmark:(NSString *)name
+       asyncBlock:(void (^)(dispatch_block_t done))block;
+
+/*! Reports latencies measured elsewhere, e.g. by a cache replay, the same way as timed samples. */
+- (void)recordLatencies:(NSArray<NSNumber *> *)latencies name:(NSString *)name;
+
+@end
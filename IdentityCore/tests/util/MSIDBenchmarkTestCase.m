@@ -0,0 +1,173 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDBenchmarkTestCase.h"
+
+#define MSID_BENCHMARK_DEFAULT_SAMPLES 15
+#define MSID_BENCHMARK_ASYNC_TIMEOUT 10
+
+@implementation MSIDBenchmarkTestCase
+
+- (void)setUp
+{
+    [super setUp];
+    
+    if (!NSProcessInfo.processInfo.environment[@"MSID_RUN_BENCHMARKS"])
+    {
+        XCTSkip(@"Benchmarks run only when MSID_RUN_BENCHMARKS is set.");
+    }
+}
+
+#pragma mark - Benchmarks
+
+- (void)benchmark:(NSString *)name
+       operations:(NSUInteger)operations
+            block:(void (^)(void))block
+{
+    if (!operations) operations = 1;
+    
+    NSUInteger sampleCount = [self.class sampleCount];
+    NSMutableArray<NSNumber *> *samples = [NSMutableArray arrayWithCapacity:sampleCount];
+    
+    // First sample warms up caches and lazily initialized state and is not recorded.
+    for (NSUInteger i = 0; i <= sampleCount; i++)
+    {
+        uint64_t start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+        
+        for (NSUInteger op = 0; op < operations; op++)
+        {
+            @autoreleasepool
+            {
+                block();
+            }
+        }
+        
+        uint64_t end = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+        if (i) [samples addObject:@((double)(end - start) / operations)];
+    }
+    
+    [self recordSamples:samples name:name operations:operations];
+}
+
+- (void)benchmark:(NSString *)name
+       asyncBlock:(void (^)(dispatch_block_t done))block
+{
+    NSUInteger sampleCount = [self.class sampleCount];
+    NSMutableArray<NSNumber *> *samples = [NSMutableArray arrayWithCapacity:sampleCount];
+    
+    for (NSUInteger i = 0; i <= sampleCount; i++)
+    {
+        XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:name];
+        __block uint64_t end = 0;
+        uint64_t start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+        
+        block(^{
+            end = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+            [expectation fulfill];
+        });
+        
+        if ([XCTWaiter waitForExpectations:@[expectation] timeout:MSID_BENCHMARK_ASYNC_TIMEOUT] != XCTWaiterResultCompleted)
+        {
+            XCTFail(@"Benchmark %@ did not complete in %d seconds.", name, MSID_BENCHMARK_ASYNC_TIMEOUT);
+            return;
+        }
+        
+        if (i) [samples addObject:@((double)(end - start))];
+    }
+    
+    [self recordSamples:samples name:name operations:1];
+}
+
+#pragma mark - Results
+
+- (void)recordLatencies:(NSArray<NSNumber *> *)latencies name:(NSString *)name
+{
+    if (!latencies.count) return;
+    
+    [self recordSamples:[latencies mutableCopy] name:name operations:1];
+}
+
+- (void)recordSamples:(NSMutableArray<NSNumber *> *)samples
+                 name:(NSString *)name
+           operations:(NSUInteger)operations
+{
+    [samples sortUsingSelector:@selector(compare:)];
+    
+    NSUInteger count = samples.count;
+    NSDictionary *result = @{@"median_ns" : samples[count / 2],
+                             @"p90_ns" : samples[MIN(count - 1, (count * 9) / 10)],
+                             @"min_ns" : samples[0],
+                             @"samples" : @(count),
+                             @"operations_per_sample" : @(operations)};
+    
+    NSString *key = [NSString stringWithFormat:@"%@.%@", NSStringFromClass(self.class), name];
+    NSLog(@"[Benchmark] %@: median %.0f ns, p90 %.0f ns, min %.0f ns", key, [result[@"median_ns"] doubleValue], [result[@"p90_ns"] doubleValue], [result[@"min_ns"] doubleValue]);
+    
+    NSString *outputPath = NSProcessInfo.processInfo.environment[@"MSID_BENCHMARK_OUTPUT"];
+    if (outputPath.length) [self.class writeResult:result forKey:key toPath:outputPath];
+}
+
++ (void)writeResult:(NSDictionary *)result forKey:(NSString *)key toPath:(NSString *)path
+{
+    @synchronized (MSIDBenchmarkTestCase.class)
+    {
+        NSMutableDictionary *report = nil;
+        NSData *existingData = [NSData dataWithContentsOfFile:path];
+        if (existingData)
+        {
+            report = [[NSJSONSerialization JSONObjectWithData:existingData options:NSJSONReadingMutableContainers error:nil] mutableCopy];
+        }
+        
+        if (![report isKindOfClass:NSMutableDictionary.class] || ![report[@"benchmarks"] isKindOfClass:NSMutableDictionary.class])
+        {
+            report = [@{@"version" : @1, @"benchmarks" : [NSMutableDictionary new]} mutableCopy];
+        }
+        
+#if TARGET_OS_OSX
+        report[@"platform"] = @"macOS";
+#else
+        report[@"platform"] = @"iOS";
+#endif
+        report[@"benchmarks"][key] = result;
+        
+        [[NSFileManager defaultManager] createDirectoryAtPath:[path stringByDeletingLastPathComponent]
+                                  withIntermediateDirectories:YES
+                                                   attributes:nil
+                                                        error:nil];
+        
+        NSData *data = [NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted | NSJSONWritingSortedKeys error:nil];
+        if (![data writeToFile:path atomically:YES])
+        {
+            NSLog(@"[Benchmark] Failed to write results to %@", path);
+        }
+    }
+}
+
++ (NSUInteger)sampleCount
+{
+    NSInteger samples = [NSProcessInfo.processInfo.environment[@"MSID_BENCHMARK_SAMPLES"] integerValue];
+    return samples > 0 ? (NSUInteger)samples : MSID_BENCHMARK_DEFAULT_SAMPLES;
+}
+
+@end
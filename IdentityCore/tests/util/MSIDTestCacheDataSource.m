@@ -44,6 +44,7 @@
     NSMutableDictionary<NSString *, NSData *> *_tokenContents;
     NSMutableDictionary<NSString *, NSData *> *_accountContents;
     NSDictionary *_wipeInfo;
+    NSUInteger _changeCount;
 }
 
 @end
@@ -175,6 +176,8 @@
         {
             [_accountContents removeObjectForKey:accountComponentsKey];
         }
+        
+        _changeCount++;
     }
     
     return YES;
@@ -493,6 +496,7 @@
     
     @synchronized (self) {
         cacheContent[componentsKey] = serializedItem;
+        _changeCount++;
     }
     
     return YES;
@@ -575,6 +579,13 @@
     return YES;
 }
 
+- (NSString *)cacheChangeTokenWithContext:(__unused id<MSIDRequestContext>)context error:(__unused NSError *__autoreleasing*)error
+{
+    @synchronized (self) {
+        return [NSString stringWithFormat:@"%lu", (unsigned long)_changeCount];
+    }
+}
+
 - (MSIDAccountMetadataCacheItem *)accountMetadataWithKey:(MSIDCacheKey *)key serializer:(id<MSIDExtendedCacheItemSerializing>)serializer context:(id<MSIDRequestContext>)context error:(NSError *__autoreleasing *)error
 {
     if (!serializer)
@@ -713,6 +724,7 @@
     @synchronized (self)  {
         _tokenContents = [NSMutableDictionary dictionary];
         _wipeInfo = nil;
+        _changeCount++;
     }
 }
 
@@ -0,0 +1,70 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+@class MSIDTestCacheShape;
+@class MSIDAccountIdentifier;
+@protocol MSIDExtendedTokenCacheDataSource;
+
+// Keys of itemCounts
+extern NSString * const MSIDTestCacheItemCountAccounts;
+extern NSString * const MSIDTestCacheItemCountAccessTokens;
+extern NSString * const MSIDTestCacheItemCountRefreshTokens;
+extern NSString * const MSIDTestCacheItemCountIdTokens;
+extern NSString * const MSIDTestCacheItemCountLegacyTokens;
+extern NSString * const MSIDTestCacheItemCountAppMetadata;
+extern NSString * const MSIDTestCacheItemCountAccountMetadata;
+
+/*!
+    Fills a token cache data source with accounts, credentials, app metadata and account metadata following a
+    MSIDTestCacheShape. Identities are generated when the generator is created and all choices come from the shape's
+    seed, so the same shape always produces the same cache.
+ */
+@interface MSIDTestCacheGenerator : NSObject
+
+@property (nonatomic, readonly) MSIDTestCacheShape *shape;
+@property (nonatomic, readonly) NSString *environment;
+
+// Generated identities, replay operations refer to them by index.
+@property (nonatomic, readonly) NSArray<MSIDAccountIdentifier *> *accountIdentifiers;
+// Tenant ids per account, the first one is the home tenant.
+@property (nonatomic, readonly) NSArray<NSArray<NSString *> *> *tenantIds;
+// Family clients first, followed by the other clients.
+@property (nonatomic, readonly) NSArray<NSString *> *clientIds;
+// Access token targets are drawn from these scope sets.
+@property (nonatomic, readonly) NSArray<NSString *> *scopeSets;
+
+// Number of items written by the last populateDataSource:error: call.
+@property (nonatomic, readonly) NSDictionary<NSString *, NSNumber *> *itemCounts;
+
+- (instancetype)initWithShape:(MSIDTestCacheShape *)shape;
+
+- (BOOL)populateDataSource:(id<MSIDExtendedTokenCacheDataSource>)dataSource error:(NSError **)error;
+
+- (BOOL)isFamilyClientAtIndex:(NSUInteger)clientIndex;
+
+- (NSString *)usernameForAccountAtIndex:(NSUInteger)accountIndex;
+
+@end
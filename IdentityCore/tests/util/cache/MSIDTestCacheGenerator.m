@@ -0,0 +1,319 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDTestCacheGenerator.h"
+#import "MSIDTestCacheShape.h"
+#import "MSIDTestSeededRandom.h"
+#import "MSIDTestIdTokenUtil.h"
+#import "MSIDExtendedTokenCacheDataSource.h"
+#import "MSIDAccountCredentialCache.h"
+#import "MSIDAccountMetadataCacheAccessor.h"
+#import "MSIDAccountIdentifier.h"
+#import "MSIDAccountCacheItem.h"
+#import "MSIDCredentialCacheItem.h"
+#import "MSIDLegacyTokenCacheItem.h"
+#import "MSIDLegacyTokenCacheKey.h"
+#import "MSIDAppMetadataCacheItem.h"
+#import "MSIDKeyedArchiverSerializer.h"
+
+NSString * const MSIDTestCacheItemCountAccounts = @"accounts";
+NSString * const MSIDTestCacheItemCountAccessTokens = @"access_tokens";
+NSString * const MSIDTestCacheItemCountRefreshTokens = @"refresh_tokens";
+NSString * const MSIDTestCacheItemCountIdTokens = @"id_tokens";
+NSString * const MSIDTestCacheItemCountLegacyTokens = @"legacy_tokens";
+NSString * const MSIDTestCacheItemCountAppMetadata = @"app_metadata";
+NSString * const MSIDTestCacheItemCountAccountMetadata = @"account_metadata";
+
+// Separates the stream used while populating from the one used for identities.
+static uint64_t const MSIDTestCachePopulationSeedSalt = 0x5DEECE66DULL;
+static NSUInteger const MSIDTestCacheResourceCount = 8;
+
+@interface MSIDTestCacheGenerator()
+
+@property (nonatomic) NSMutableDictionary<NSString *, NSNumber *> *counts;
+
+@end
+
+@implementation MSIDTestCacheGenerator
+
+- (instancetype)initWithShape:(MSIDTestCacheShape *)shape
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _shape = [shape copy];
+        _environment = @"login.microsoftonline.com";
+        [self generateIdentities];
+    }
+    
+    return self;
+}
+
+- (void)generateIdentities
+{
+    MSIDTestSeededRandom *random = [[MSIDTestSeededRandom alloc] initWithSeed:self.shape.seed];
+    
+    NSMutableArray *accountIdentifiers = [NSMutableArray arrayWithCapacity:self.shape.accountCount];
+    NSMutableArray *tenantIds = [NSMutableArray arrayWithCapacity:self.shape.accountCount];
+    
+    for (NSUInteger i = 0; i < self.shape.accountCount; i++)
+    {
+        NSString *uid = [random nextGUIDString];
+        NSUInteger tenantCount = MAX(1, [random nextIntegerFrom:self.shape.minTenantsPerAccount to:self.shape.maxTenantsPerAccount]);
+        NSMutableArray *tenants = [NSMutableArray arrayWithCapacity:tenantCount];
+        
+        for (NSUInteger t = 0; t < tenantCount; t++)
+        {
+            [tenants addObject:[random nextGUIDString]];
+        }
+        
+        NSString *homeAccountId = [NSString stringWithFormat:@"%@.%@", uid, tenants[0]];
+        [accountIdentifiers addObject:[[MSIDAccountIdentifier alloc] initWithDisplayableId:[self usernameForAccountAtIndex:i] homeAccountId:homeAccountId]];
+        [tenantIds addObject:tenants];
+    }
+    
+    NSUInteger clientCount = self.shape.familyClientCount + self.shape.nonFamilyClientCount;
+    NSMutableArray *clientIds = [NSMutableArray arrayWithCapacity:clientCount];
+    for (NSUInteger i = 0; i < clientCount; i++)
+    {
+        [clientIds addObject:[random nextGUIDString]];
+    }
+    
+    NSMutableArray *resources = [NSMutableArray arrayWithCapacity:MSIDTestCacheResourceCount];
+    for (NSUInteger i = 0; i < MSIDTestCacheResourceCount; i++)
+    {
+        [resources addObject:[NSString stringWithFormat:@"api://%@", [random nextGUIDString]]];
+    }
+    
+    // Enough distinct scope sets that the access tokens of one account, tenant and client never share a target.
+    NSUInteger scopeSetCount = self.shape.maxAccessTokensPerClient + MSIDTestCacheResourceCount;
+    NSMutableArray *scopeSets = [NSMutableArray arrayWithCapacity:scopeSetCount];
+    for (NSUInteger i = 0; i < scopeSetCount; i++)
+    {
+        NSString *resource = resources[i % MSIDTestCacheResourceCount];
+        [scopeSets addObject:[NSString stringWithFormat:@"%@/scope%lu.read %@/scope%lu.write", resource, (unsigned long)i, resource, (unsigned long)i]];
+    }
+    
+    _accountIdentifiers = accountIdentifiers;
+    _tenantIds = tenantIds;
+    _clientIds = clientIds;
+    _scopeSets = scopeSets;
+}
+
+- (BOOL)isFamilyClientAtIndex:(NSUInteger)clientIndex
+{
+    return clientIndex < self.shape.familyClientCount;
+}
+
+- (NSString *)usernameForAccountAtIndex:(NSUInteger)accountIndex
+{
+    return [NSString stringWithFormat:@"user%lu@contoso.com", (unsigned long)accountIndex];
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)itemCounts
+{
+    return [self.counts copy];
+}
+
+#pragma mark - Population
+
+- (BOOL)populateDataSource:(id<MSIDExtendedTokenCacheDataSource>)dataSource error:(NSError **)error
+{
+    MSIDTestSeededRandom *random = [[MSIDTestSeededRandom alloc] initWithSeed:self.shape.seed ^ MSIDTestCachePopulationSeedSalt];
+    MSIDAccountCredentialCache *credentialCache = [[MSIDAccountCredentialCache alloc] initWithDataSource:dataSource];
+    MSIDAccountMetadataCacheAccessor *metadataCache = [[MSIDAccountMetadataCacheAccessor alloc] initWithDataSource:dataSource];
+    self.counts = [NSMutableDictionary new];
+    
+    for (NSUInteger c = 0; c < self.clientIds.count; c++)
+    {
+        MSIDAppMetadataCacheItem *appMetadata = [MSIDAppMetadataCacheItem new];
+        appMetadata.clientId = self.clientIds[c];
+        appMetadata.environment = self.environment;
+        appMetadata.familyId = [self isFamilyClientAtIndex:c] ? @"1" : nil;
+        
+        if (![credentialCache saveAppMetadata:appMetadata context:nil error:error]) return NO;
+        [self incrementCount:MSIDTestCacheItemCountAppMetadata by:1];
+    }
+    
+    for (NSUInteger a = 0; a < self.accountIdentifiers.count; a++)
+    {
+        if (![self populateAccountAtIndex:a random:random credentialCache:credentialCache dataSource:dataSource error:error]) return NO;
+        if (![self populateAccountMetadataAtIndex:a random:random metadataCache:metadataCache error:error]) return NO;
+    }
+    
+    return YES;
+}
+
+- (BOOL)populateAccountAtIndex:(NSUInteger)accountIndex
+                        random:(MSIDTestSeededRandom *)random
+               credentialCache:(MSIDAccountCredentialCache *)credentialCache
+                    dataSource:(id<MSIDExtendedTokenCacheDataSource>)dataSource
+                         error:(NSError **)error
+{
+    MSIDAccountIdentifier *accountIdentifier = self.accountIdentifiers[accountIndex];
+    NSArray<NSString *> *tenants = self.tenantIds[accountIndex];
+    NSString *username = [self usernameForAccountAtIndex:accountIndex];
+    
+    for (NSUInteger t = 0; t < tenants.count; t++)
+    {
+        NSString *tenantId = tenants[t];
+        
+        MSIDAccountCacheItem *account = [MSIDAccountCacheItem new];
+        account.accountType = MSIDAccountTypeMSSTS;
+        account.homeAccountId = accountIdentifier.homeAccountId;
+        account.environment = self.environment;
+        account.realm = tenantId;
+        account.localAccountId = t ? [random nextGUIDString] : [accountIdentifier.homeAccountId componentsSeparatedByString:@"."].firstObject;
+        account.username = username;
+        
+        if (![credentialCache saveAccount:account context:nil error:error]) return NO;
+        [self incrementCount:MSIDTestCacheItemCountAccounts by:1];
+        
+        NSString *idToken = [MSIDTestIdTokenUtil idTokenWithName:@"Test User" preferredUsername:username oid:account.localAccountId tenantId:tenantId];
+        
+        for (NSUInteger c = 0; c < self.clientIds.count; c++)
+        {
+            MSIDCredentialCacheItem *idTokenItem = [self credentialWithType:MSIDIDTokenType accountIndex:accountIndex tenantId:tenantId clientIndex:c];
+            idTokenItem.secret = idToken;
+            if (![credentialCache saveCredential:idTokenItem context:nil error:error]) return NO;
+            [self incrementCount:MSIDTestCacheItemCountIdTokens by:1];
+            
+            NSUInteger accessTokenCount = [random nextIntegerFrom:self.shape.minAccessTokensPerClient to:self.shape.maxAccessTokensPerClient];
+            NSUInteger scopeOffset = [random nextIndexBelow:self.scopeSets.count];
+            
+            for (NSUInteger i = 0; i < accessTokenCount; i++)
+            {
+                MSIDCredentialCacheItem *accessToken = [self credentialWithType:MSIDAccessTokenType accountIndex:accountIndex tenantId:tenantId clientIndex:c];
+                accessToken.target = self.scopeSets[(scopeOffset + i) % self.scopeSets.count];
+                accessToken.secret = [random nextGUIDString];
+                BOOL expired = [random nextBoolWithProbability:self.shape.expiredAccessTokenRatio];
+                accessToken.expiresOn = [NSDate dateWithTimeIntervalSinceNow:expired ? -600 : 3600];
+                accessToken.extendedExpiresOn = accessToken.expiresOn;
+                
+                if (![credentialCache saveCredential:accessToken context:nil error:error]) return NO;
+                [self incrementCount:MSIDTestCacheItemCountAccessTokens by:1];
+            }
+        }
+    }
+    
+    // Family apps share one family refresh token per account, the other apps have their own.
+    for (NSUInteger c = 0; c < self.clientIds.count; c++)
+    {
+        BOOL familyClient = [self isFamilyClientAtIndex:c];
+        if (familyClient && c > 0) continue;
+        
+        MSIDCredentialCacheItem *refreshToken = [self credentialWithType:MSIDRefreshTokenType accountIndex:accountIndex tenantId:nil clientIndex:c];
+        refreshToken.secret = [random nextGUIDString];
+        refreshToken.familyId = familyClient ? @"1" : nil;
+        
+        if (![credentialCache saveCredential:refreshToken context:nil error:error]) return NO;
+        [self incrementCount:MSIDTestCacheItemCountRefreshTokens by:1];
+    }
+    
+    for (NSUInteger c = 0; c < self.clientIds.count; c++)
+    {
+        if (![random nextBoolWithProbability:self.shape.legacyTokenRatio]) continue;
+        
+        MSIDLegacyTokenCacheItem *legacyToken = [MSIDLegacyTokenCacheItem new];
+        legacyToken.credentialType = MSIDLegacySingleResourceTokenType;
+        legacyToken.homeAccountId = accountIdentifier.homeAccountId;
+        legacyToken.environment = self.environment;
+        legacyToken.realm = tenants[0];
+        legacyToken.clientId = self.clientIds[c];
+        legacyToken.target = @"https://graph.windows.net";
+        legacyToken.accessToken = [random nextGUIDString];
+        legacyToken.refreshToken = [random nextGUIDString];
+        legacyToken.secret = legacyToken.accessToken;
+        legacyToken.oauthTokenType = @"Bearer";
+        legacyToken.expiresOn = [NSDate dateWithTimeIntervalSinceNow:3600];
+        legacyToken.cachedAt = [NSDate date];
+        
+        MSIDLegacyTokenCacheKey *key = [[MSIDLegacyTokenCacheKey alloc] initWithEnvironment:self.environment
+                                                                                      realm:tenants[0]
+                                                                                   clientId:self.clientIds[c]
+                                                                                   resource:legacyToken.target
+                                                                               legacyUserId:username];
+        
+        if (![dataSource saveToken:legacyToken key:key serializer:[MSIDKeyedArchiverSerializer new] context:nil error:error]) return NO;
+        [self incrementCount:MSIDTestCacheItemCountLegacyTokens by:1];
+    }
+    
+    return YES;
+}
+
+- (BOOL)populateAccountMetadataAtIndex:(NSUInteger)accountIndex
+                                random:(MSIDTestSeededRandom *)random
+                         metadataCache:(MSIDAccountMetadataCacheAccessor *)metadataCache
+                                 error:(NSError **)error
+{
+    NSString *homeAccountId = self.accountIdentifiers[accountIndex].homeAccountId;
+    NSURL *cacheAuthorityURL = [NSURL URLWithString:[NSString stringWithFormat:@"https://%@/%@", self.environment, self.tenantIds[accountIndex][0]]];
+    
+    for (NSString *clientId in self.clientIds)
+    {
+        MSIDAccountMetadataState state = [random nextBoolWithProbability:self.shape.signedOutRatio] ? MSIDAccountMetadataStateSignedOut : MSIDAccountMetadataStateSignedIn;
+        if (![metadataCache updateSignInStateForHomeAccountId:homeAccountId clientId:clientId state:state context:nil error:error]) return NO;
+        [self incrementCount:MSIDTestCacheItemCountAccountMetadata by:1];
+        
+        for (NSUInteger i = 0; i < self.shape.authorityMapEntriesPerClient; i++)
+        {
+            NSURL *requestAuthorityURL = [NSURL URLWithString:[NSString stringWithFormat:@"https://%@/%@", self.environment, [random nextGUIDString]]];
+            
+            if (![metadataCache updateAuthorityURL:cacheAuthorityURL
+                                     forRequestURL:requestAuthorityURL
+                                     homeAccountId:homeAccountId
+                                          clientId:clientId
+                                     instanceAware:NO
+                                           context:nil
+                                             error:error]) return NO;
+        }
+    }
+    
+    return YES;
+}
+
+#pragma mark - Helpers
+
+- (MSIDCredentialCacheItem *)credentialWithType:(MSIDCredentialType)type
+                                   accountIndex:(NSUInteger)accountIndex
+                                       tenantId:(NSString *)tenantId
+                                    clientIndex:(NSUInteger)clientIndex
+{
+    MSIDCredentialCacheItem *item = [MSIDCredentialCacheItem new];
+    item.credentialType = type;
+    item.homeAccountId = self.accountIdentifiers[accountIndex].homeAccountId;
+    item.environment = self.environment;
+    item.realm = tenantId;
+    item.clientId = self.clientIds[clientIndex];
+    item.cachedAt = [NSDate date];
+    return item;
+}
+
+- (void)incrementCount:(NSString *)key by:(NSUInteger)value
+{
+    self.counts[key] = @(self.counts[key].unsignedIntegerValue + value);
+}
+
+@end
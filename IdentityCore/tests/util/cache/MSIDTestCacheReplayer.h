@@ -0,0 +1,78 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+@class MSIDTestCacheGenerator;
+@protocol MSIDExtendedTokenCacheDataSource;
+
+// Operation dictionary keys and values. Index values are taken modulo the generator's counts,
+// so recorded sequences can be replayed against any shape.
+extern NSString * const MSIDTestCacheOperationKey;          // "op"
+extern NSString * const MSIDTestCacheOperationAccountKey;   // "account"
+extern NSString * const MSIDTestCacheOperationTenantKey;    // "tenant"
+extern NSString * const MSIDTestCacheOperationClientKey;    // "client"
+extern NSString * const MSIDTestCacheOperationScopesKey;    // "scopes"
+
+extern NSString * const MSIDTestCacheOperationGetAccounts;  // "get_accounts"
+extern NSString * const MSIDTestCacheOperationSilentToken;  // "silent_token"
+extern NSString * const MSIDTestCacheOperationSave;         // "save"
+
+@interface MSIDTestCacheReplayReport : NSObject
+
+// Latency of every replayed operation in nanoseconds, keyed by operation name.
+@property (nonatomic, readonly) NSDictionary<NSString *, NSArray<NSNumber *> *> *latenciesByOperation;
+// Number of silent_token operations that found an access token or refresh token.
+@property (nonatomic, readonly) NSUInteger silentTokenHits;
+@property (nonatomic, readonly) NSUInteger failedOperations;
+
+// Nearest rank percentile (0-100) in nanoseconds, 0 when the operation was not replayed.
+- (double)percentile:(double)percentile forOperation:(NSString *)operation;
+
+// count, p50_ns, p90_ns, p99_ns and max_ns for every operation.
+- (NSDictionary<NSString *, NSDictionary *> *)summary;
+
+@end
+
+/*!
+    Replays sequences of get accounts, silent token and save operations against a cache populated by
+    MSIDTestCacheGenerator and records the latency of every operation. Silent token operations do the cache side of a
+    silent request: access token lookup, falling back to the refresh token lookup.
+ */
+@interface MSIDTestCacheReplayer : NSObject
+
+- (instancetype)initWithGenerator:(MSIDTestCacheGenerator *)generator
+                       dataSource:(id<MSIDExtendedTokenCacheDataSource>)dataSource;
+
+// Reproducible sequence with 70% silent token, 20% get accounts and 10% save operations.
++ (NSArray<NSDictionary *> *)operationsWithGenerator:(MSIDTestCacheGenerator *)generator
+                                               count:(NSUInteger)count
+                                                seed:(uint64_t)seed;
+
+// Reads a recorded sequence, a JSON array of operation dictionaries.
++ (NSArray<NSDictionary *> *)operationsFromJSONData:(NSData *)data error:(NSError **)error;
+
+- (MSIDTestCacheReplayReport *)replayOperations:(NSArray<NSDictionary *> *)operations;
+
+@end
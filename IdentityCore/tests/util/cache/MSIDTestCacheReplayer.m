@@ -0,0 +1,290 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDTestCacheReplayer.h"
+#import "MSIDTestCacheGenerator.h"
+#import "MSIDTestCacheShape.h"
+#import "MSIDTestSeededRandom.h"
+#import "MSIDTestTokenResponse.h"
+#import "MSIDTestIdTokenUtil.h"
+#import "NSString+MSIDTestUtil.h"
+#import "MSIDExtendedTokenCacheDataSource.h"
+#import "MSIDDefaultTokenCacheAccessor.h"
+#import "MSIDLegacyTokenCacheAccessor.h"
+#import "MSIDAccountMetadataCacheAccessor.h"
+#import "MSIDAccountIdentifier.h"
+#import "MSIDConfiguration.h"
+#import "MSIDAADV2Oauth2Factory.h"
+#import "MSIDAADV2TokenResponse.h"
+
+NSString * const MSIDTestCacheOperationKey = @"op";
+NSString * const MSIDTestCacheOperationAccountKey = @"account";
+NSString * const MSIDTestCacheOperationTenantKey = @"tenant";
+NSString * const MSIDTestCacheOperationClientKey = @"client";
+NSString * const MSIDTestCacheOperationScopesKey = @"scopes";
+
+NSString * const MSIDTestCacheOperationGetAccounts = @"get_accounts";
+NSString * const MSIDTestCacheOperationSilentToken = @"silent_token";
+NSString * const MSIDTestCacheOperationSave = @"save";
+
+@interface MSIDTestCacheReplayReport()
+
+@property (nonatomic) NSMutableDictionary<NSString *, NSMutableArray<NSNumber *> *> *latencies;
+@property (nonatomic, readwrite) NSUInteger silentTokenHits;
+@property (nonatomic, readwrite) NSUInteger failedOperations;
+
+@end
+
+@implementation MSIDTestCacheReplayReport
+
+- (instancetype)init
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _latencies = [NSMutableDictionary new];
+    }
+    
+    return self;
+}
+
+- (void)addLatency:(uint64_t)latency forOperation:(NSString *)operation
+{
+    if (!self.latencies[operation]) self.latencies[operation] = [NSMutableArray new];
+    [self.latencies[operation] addObject:@(latency)];
+}
+
+- (NSDictionary<NSString *, NSArray<NSNumber *> *> *)latenciesByOperation
+{
+    return [self.latencies copy];
+}
+
+- (double)percentile:(double)percentile forOperation:(NSString *)operation
+{
+    NSArray<NSNumber *> *sorted = [self.latencies[operation] sortedArrayUsingSelector:@selector(compare:)];
+    if (!sorted.count) return 0;
+    
+    NSUInteger rank = (NSUInteger)ceil(MIN(MAX(percentile, 0), 100) / 100.0 * sorted.count);
+    return sorted[rank ? rank - 1 : 0].doubleValue;
+}
+
+- (NSDictionary<NSString *, NSDictionary *> *)summary
+{
+    NSMutableDictionary *summary = [NSMutableDictionary new];
+    
+    for (NSString *operation in self.latencies)
+    {
+        summary[operation] = @{@"count" : @(self.latencies[operation].count),
+                               @"p50_ns" : @([self percentile:50 forOperation:operation]),
+                               @"p90_ns" : @([self percentile:90 forOperation:operation]),
+                               @"p99_ns" : @([self percentile:99 forOperation:operation]),
+                               @"max_ns" : @([self percentile:100 forOperation:operation])};
+    }
+    
+    return summary;
+}
+
+@end
+
+@interface MSIDTestCacheReplayer()
+
+@property (nonatomic) MSIDTestCacheGenerator *generator;
+@property (nonatomic) MSIDDefaultTokenCacheAccessor *tokenCache;
+@property (nonatomic) MSIDAccountMetadataCacheAccessor *accountMetadataCache;
+@property (nonatomic) MSIDAADV2Oauth2Factory *factory;
+
+@end
+
+@implementation MSIDTestCacheReplayer
+
+- (instancetype)initWithGenerator:(MSIDTestCacheGenerator *)generator
+                       dataSource:(id<MSIDExtendedTokenCacheDataSource>)dataSource
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _generator = generator;
+        MSIDLegacyTokenCacheAccessor *legacyAccessor = [[MSIDLegacyTokenCacheAccessor alloc] initWithDataSource:dataSource otherCacheAccessors:nil];
+        _tokenCache = [[MSIDDefaultTokenCacheAccessor alloc] initWithDataSource:dataSource otherCacheAccessors:@[legacyAccessor]];
+        _accountMetadataCache = [[MSIDAccountMetadataCacheAccessor alloc] initWithDataSource:dataSource];
+        _factory = [MSIDAADV2Oauth2Factory new];
+    }
+    
+    return self;
+}
+
+#pragma mark - Sequences
+
++ (NSArray<NSDictionary *> *)operationsWithGenerator:(MSIDTestCacheGenerator *)generator
+                                               count:(NSUInteger)count
+                                                seed:(uint64_t)seed
+{
+    MSIDTestSeededRandom *random = [[MSIDTestSeededRandom alloc] initWithSeed:seed];
+    NSMutableArray *operations = [NSMutableArray arrayWithCapacity:count];
+    
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        double roll = [random nextDouble];
+        NSString *name = roll < 0.7 ? MSIDTestCacheOperationSilentToken : (roll < 0.9 ? MSIDTestCacheOperationGetAccounts : MSIDTestCacheOperationSave);
+        
+        [operations addObject:@{MSIDTestCacheOperationKey : name,
+                                MSIDTestCacheOperationAccountKey : @([random nextIndexBelow:generator.accountIdentifiers.count]),
+                                MSIDTestCacheOperationTenantKey : @([random nextIndexBelow:generator.shape.maxTenantsPerAccount]),
+                                MSIDTestCacheOperationClientKey : @([random nextIndexBelow:generator.clientIds.count]),
+                                MSIDTestCacheOperationScopesKey : @([random nextIndexBelow:generator.scopeSets.count])}];
+    }
+    
+    return operations;
+}
+
++ (NSArray<NSDictionary *> *)operationsFromJSONData:(NSData *)data error:(NSError **)error
+{
+    id json = [NSJSONSerialization JSONObjectWithData:data options:0 error:error];
+    if (!json) return nil;
+    
+    if (![json isKindOfClass:NSArray.class])
+    {
+        if (error) *error = MSIDCreateError(MSIDErrorDomain, MSIDErrorInvalidInternalParameter, @"Recorded cache operations should be a JSON array.", nil, nil, nil, nil, nil, NO);
+        return nil;
+    }
+    
+    for (id operation in json)
+    {
+        if (![operation isKindOfClass:NSDictionary.class] || ![operation[MSIDTestCacheOperationKey] isKindOfClass:NSString.class])
+        {
+            if (error) *error = MSIDCreateError(MSIDErrorDomain, MSIDErrorInvalidInternalParameter, @"Every recorded cache operation should be a dictionary with an op name.", nil, nil, nil, nil, nil, NO);
+            return nil;
+        }
+    }
+    
+    return json;
+}
+
+#pragma mark - Replay
+
+- (MSIDTestCacheReplayReport *)replayOperations:(NSArray<NSDictionary *> *)operations
+{
+    MSIDTestCacheReplayReport *report = [MSIDTestCacheReplayReport new];
+    
+    for (NSDictionary *operation in operations)
+    {
+        NSString *name = operation[MSIDTestCacheOperationKey];
+        NSUInteger accountIndex = [self index:operation[MSIDTestCacheOperationAccountKey] count:self.generator.accountIdentifiers.count];
+        NSUInteger clientIndex = [self index:operation[MSIDTestCacheOperationClientKey] count:self.generator.clientIds.count];
+        NSArray<NSString *> *tenants = self.generator.tenantIds[accountIndex];
+        NSString *tenantId = tenants[[self index:operation[MSIDTestCacheOperationTenantKey] count:tenants.count]];
+        NSString *target = self.generator.scopeSets[[self index:operation[MSIDTestCacheOperationScopesKey] count:self.generator.scopeSets.count]];
+        
+        MSIDAccountIdentifier *accountIdentifier = self.generator.accountIdentifiers[accountIndex];
+        NSString *clientId = self.generator.clientIds[clientIndex];
+        NSString *familyId = [self.generator isFamilyClientAtIndex:clientIndex] ? @"1" : nil;
+        
+        // Inputs are prepared outside of the timed section, only the cache calls are measured.
+        BOOL result = NO;
+        uint64_t start = 0;
+        
+        if ([name isEqualToString:MSIDTestCacheOperationGetAccounts])
+        {
+            MSIDAuthority *authority = [[NSString stringWithFormat:@"https://%@/common", self.generator.environment] aadAuthority];
+            start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+            
+            NSArray *accounts = [self.tokenCache accountsWithAuthority:authority
+                                                              clientId:clientId
+                                                              familyId:familyId
+                                                     accountIdentifier:nil
+                                                  accountMetadataCache:self.accountMetadataCache
+                                                  signedInAccountsOnly:YES
+                                                               context:nil
+                                                                 error:nil];
+            result = accounts != nil;
+        }
+        else if ([name isEqualToString:MSIDTestCacheOperationSilentToken])
+        {
+            MSIDConfiguration *configuration = [self configurationWithTenantId:tenantId clientId:clientId target:target];
+            start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+            
+            BOOL hit = [self.tokenCache getAccessTokenForAccount:accountIdentifier configuration:configuration context:nil error:nil] != nil;
+            if (!hit)
+            {
+                hit = [self.tokenCache getRefreshTokenWithAccount:accountIdentifier familyId:familyId configuration:configuration context:nil error:nil] != nil;
+            }
+            
+            if (hit) report.silentTokenHits++;
+            result = YES;
+        }
+        else if ([name isEqualToString:MSIDTestCacheOperationSave])
+        {
+            MSIDConfiguration *configuration = [self configurationWithTenantId:tenantId clientId:clientId target:target];
+            MSIDTokenResponse *response = [self tokenResponseForAccountAtIndex:accountIndex tenantId:tenantId target:target familyId:familyId];
+            start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+            
+            result = [self.tokenCache saveTokensWithConfiguration:configuration response:response factory:self.factory context:nil error:nil];
+        }
+        else
+        {
+            report.failedOperations++;
+            continue;
+        }
+        
+        [report addLatency:clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - start forOperation:name];
+        if (!result) report.failedOperations++;
+    }
+    
+    return report;
+}
+
+#pragma mark - Helpers
+
+- (NSUInteger)index:(NSNumber *)value count:(NSUInteger)count
+{
+    return count ? [value unsignedIntegerValue] % count : 0;
+}
+
+- (MSIDConfiguration *)configurationWithTenantId:(NSString *)tenantId clientId:(NSString *)clientId target:(NSString *)target
+{
+    MSIDAuthority *authority = [[NSString stringWithFormat:@"https://%@/%@", self.generator.environment, tenantId] aadAuthority];
+    return [[MSIDConfiguration alloc] initWithAuthority:authority redirectUri:nil clientId:clientId target:target];
+}
+
+- (MSIDTokenResponse *)tokenResponseForAccountAtIndex:(NSUInteger)accountIndex
+                                             tenantId:(NSString *)tenantId
+                                               target:(NSString *)target
+                                             familyId:(NSString *)familyId
+{
+    NSArray<NSString *> *homeAccountIdParts = [self.generator.accountIdentifiers[accountIndex].homeAccountId componentsSeparatedByString:@"."];
+    NSString *username = [self.generator usernameForAccountAtIndex:accountIndex];
+    NSString *idToken = [MSIDTestIdTokenUtil idTokenWithName:@"Test User" preferredUsername:username oid:homeAccountIdParts.firstObject tenantId:tenantId];
+    
+    return [MSIDTestTokenResponse v2TokenResponseWithAT:[NSUUID UUID].UUIDString
+                                                     RT:[NSUUID UUID].UUIDString
+                                                 scopes:[NSOrderedSet orderedSetWithArray:[target componentsSeparatedByString:@" "]]
+                                                idToken:idToken
+                                                    uid:homeAccountIdParts.firstObject
+                                                   utid:homeAccountIdParts.lastObject
+                                               familyId:familyId];
+}
+
+@end
@@ -0,0 +1,79 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+/*!
+    Parameters of a synthetic token cache generated by MSIDTestCacheGenerator.
+    Counts given as ranges are drawn uniformly per account or per account, tenant and client.
+ */
+@interface MSIDTestCacheShape : NSObject <NSCopying>
+
+@property (nonatomic) uint64_t seed;
+
+@property (nonatomic) NSUInteger accountCount;
+
+// Tenants each account has tokens in, including its home tenant.
+@property (nonatomic) NSUInteger minTenantsPerAccount;
+@property (nonatomic) NSUInteger maxTenantsPerAccount;
+
+// Apps sharing the family refresh token, and apps with their own refresh tokens.
+@property (nonatomic) NSUInteger familyClientCount;
+@property (nonatomic) NSUInteger nonFamilyClientCount;
+
+// Access tokens with distinct scopes per account, tenant and client.
+@property (nonatomic) NSUInteger minAccessTokensPerClient;
+@property (nonatomic) NSUInteger maxAccessTokensPerClient;
+
+// Share of access tokens that are already expired.
+@property (nonatomic) double expiredAccessTokenRatio;
+
+// Share of account and client pairs that also have a legacy (ADAL) single resource token in the home tenant.
+@property (nonatomic) double legacyTokenRatio;
+
+// Share of account and client pairs whose account metadata says signed out.
+@property (nonatomic) double signedOutRatio;
+
+// Authority URL map entries recorded in the account metadata per account and client.
+@property (nonatomic) NSUInteger authorityMapEntriesPerClient;
+
+/*! A few accounts in a few tenants used by a couple of apps. */
++ (instancetype)defaultShape;
+
+/*! One user with guest accounts in hundreds of tenants. */
++ (instancetype)manyTenantsShape;
+
+/*! Thousands of access tokens with distinct scopes. */
++ (instancetype)manyAccessTokensShape;
+
+/*! Many apps of the same family sharing refresh tokens. */
++ (instancetype)manyFamilyAppsShape;
+
+/*! Legacy single resource tokens next to the default cache items for most apps. */
++ (instancetype)legacyAndDefaultShape;
+
+/*! Large account metadata with many authority map entries. */
++ (instancetype)largeAccountMetadataShape;
+
+@end
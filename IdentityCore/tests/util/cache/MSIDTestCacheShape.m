@@ -0,0 +1,129 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDTestCacheShape.h"
+
+@implementation MSIDTestCacheShape
+
+- (instancetype)init
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _seed = 1;
+        _accountCount = 3;
+        _minTenantsPerAccount = 1;
+        _maxTenantsPerAccount = 2;
+        _familyClientCount = 2;
+        _nonFamilyClientCount = 1;
+        _minAccessTokensPerClient = 1;
+        _maxAccessTokensPerClient = 3;
+        _expiredAccessTokenRatio = 0.1;
+    }
+    
+    return self;
+}
+
++ (instancetype)defaultShape
+{
+    return [self new];
+}
+
++ (instancetype)manyTenantsShape
+{
+    MSIDTestCacheShape *shape = [self new];
+    shape.accountCount = 1;
+    shape.minTenantsPerAccount = 200;
+    shape.maxTenantsPerAccount = 200;
+    shape.familyClientCount = 1;
+    shape.nonFamilyClientCount = 1;
+    return shape;
+}
+
++ (instancetype)manyAccessTokensShape
+{
+    MSIDTestCacheShape *shape = [self new];
+    shape.accountCount = 2;
+    shape.minTenantsPerAccount = 2;
+    shape.maxTenantsPerAccount = 2;
+    shape.familyClientCount = 1;
+    shape.nonFamilyClientCount = 1;
+    shape.minAccessTokensPerClient = 200;
+    shape.maxAccessTokensPerClient = 300;
+    shape.expiredAccessTokenRatio = 0.3;
+    return shape;
+}
+
++ (instancetype)manyFamilyAppsShape
+{
+    MSIDTestCacheShape *shape = [self new];
+    shape.accountCount = 5;
+    shape.familyClientCount = 30;
+    shape.nonFamilyClientCount = 5;
+    return shape;
+}
+
++ (instancetype)legacyAndDefaultShape
+{
+    MSIDTestCacheShape *shape = [self new];
+    shape.accountCount = 10;
+    shape.familyClientCount = 3;
+    shape.nonFamilyClientCount = 3;
+    shape.legacyTokenRatio = 0.8;
+    return shape;
+}
+
++ (instancetype)largeAccountMetadataShape
+{
+    MSIDTestCacheShape *shape = [self new];
+    shape.accountCount = 20;
+    shape.familyClientCount = 3;
+    shape.nonFamilyClientCount = 3;
+    shape.signedOutRatio = 0.3;
+    shape.authorityMapEntriesPerClient = 20;
+    return shape;
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    MSIDTestCacheShape *shape = [[self.class allocWithZone:zone] init];
+    shape.seed = self.seed;
+    shape.accountCount = self.accountCount;
+    shape.minTenantsPerAccount = self.minTenantsPerAccount;
+    shape.maxTenantsPerAccount = self.maxTenantsPerAccount;
+    shape.familyClientCount = self.familyClientCount;
+    shape.nonFamilyClientCount = self.nonFamilyClientCount;
+    shape.minAccessTokensPerClient = self.minAccessTokensPerClient;
+    shape.maxAccessTokensPerClient = self.maxAccessTokensPerClient;
+    shape.expiredAccessTokenRatio = self.expiredAccessTokenRatio;
+    shape.legacyTokenRatio = self.legacyTokenRatio;
+    shape.signedOutRatio = self.signedOutRatio;
+    shape.authorityMapEntriesPerClient = self.authorityMapEntriesPerClient;
+    return shape;
+}
+
+@end
@@ -0,0 +1,53 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import <Foundation/Foundation.h>
+
+/*!
+    Deterministic pseudo random generator (splitmix64) for tests that need reproducible random data.
+    Two instances created with the same seed produce the same sequence on every platform.
+ */
+@interface MSIDTestSeededRandom : NSObject
+
+@property (nonatomic, readonly) uint64_t seed;
+
+- (instancetype)initWithSeed:(uint64_t)seed;
+
+- (uint64_t)nextUInt64;
+
+/*! Uniform integer in [0, upperBound), 0 when upperBound is 0. */
+- (NSUInteger)nextIndexBelow:(NSUInteger)upperBound;
+
+/*! Uniform integer in [minimum, maximum]. */
+- (NSUInteger)nextIntegerFrom:(NSUInteger)minimum to:(NSUInteger)maximum;
+
+/*! Uniform double in [0, 1). */
+- (double)nextDouble;
+
+- (BOOL)nextBoolWithProbability:(double)probability;
+
+/*! Lowercase GUID formatted string. */
+- (NSString *)nextGUIDString;
+
+@end
@@ -0,0 +1,86 @@
+//
+// Copyright (c) Microsoft Corporation.
+// All rights reserved.
+//
+// This code is licensed under the MIT License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.  
+
+#import "MSIDTestSeededRandom.h"
+
+@implementation MSIDTestSeededRandom
+{
+    uint64_t _state;
+}
+
+- (instancetype)initWithSeed:(uint64_t)seed
+{
+    self = [super init];
+    
+    if (self)
+    {
+        _seed = seed;
+        _state = seed;
+    }
+    
+    return self;
+}
+
+- (uint64_t)nextUInt64
+{
+    uint64_t z = (_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+- (NSUInteger)nextIndexBelow:(NSUInteger)upperBound
+{
+    if (!upperBound) return 0;
+    
+    return (NSUInteger)([self nextUInt64] % upperBound);
+}
+
+- (NSUInteger)nextIntegerFrom:(NSUInteger)minimum to:(NSUInteger)maximum
+{
+    if (maximum <= minimum) return minimum;
+    
+    return minimum + [self nextIndexBelow:maximum - minimum + 1];
+}
+
+- (double)nextDouble
+{
+    return (double)([self nextUInt64] >> 11) / (double)(1ULL << 53);
+}
+
+- (BOOL)nextBoolWithProbability:(double)probability
+{
+    return [self nextDouble] < probability;
+}
+
+- (NSString *)nextGUIDString
+{
+    uint64_t high = [self nextUInt64];
+    uint64_t low = [self nextUInt64];
+    
+    return [NSString stringWithFormat:@"%08llx-%04llx-%04llx-%04llx-%012llx",
+            high >> 32, (high >> 16) & 0xFFFF, high & 0xFFFF, low >> 48, low & 0xFFFFFFFFFFFFULL];
+}
+
+@end
@@ -82,6 +82,33 @@ target_specifiers = [
         "min_warn_codecov" : 70.0,
         "platform" : "visionOS"
     },
+    {
+        # Runs only the benchmarks, writes their results to ./build/benchmarks. Not run by default,
+        # use --targets mac_benchmarks and compare the results with scripts/compare_benchmarks.py
+        "name" : "Mac Benchmarks",
+        "target" : "mac_benchmarks",
+        "scheme" : "IdentityCore Mac",
+        "operations" : [ "build", "test" ],
+        "platform" : "Mac",
+        "default" : False,
+        "only_testing" : [ "IdentityCoreTests Mac/MSIDPrimitiveBenchmarks",
+                           "IdentityCoreTests Mac/MSIDTokenPipelineBenchmarks",
+                           "IdentityCoreTests Mac/MSIDCacheReplayBenchmarks",
+                           "IdentityCoreTests Mac/MSIDDIContainerBenchmarks",
+                           "IdentityCoreTests Mac/MSIDLazyErrorBenchmarks",
+                           "IdentityCoreTests Mac/MSIDURLFormEncoderBenchmarks",
+                           "IdentityCoreTests Mac/MSIDTracerBenchmarks",
+                           "IdentityCoreTests Mac/MSIDMetadataCacheBenchmarks",
+                           "IdentityCoreTests Mac/MSIDAccountEnumerationViewBenchmarks",
+                           "IdentityCoreTests Mac/MSIDDefaultTokenCacheAccessorLookupBenchmarks",
+                           "IdentityCoreTests Mac/MSIDCacheLookupMetricsBenchmarks",
+                           "IdentityCoreTests Mac/MSIDCacheCompactorBenchmarks",
+                           "IdentityCoreTests Mac/MSIDFlightManagerBenchmarks",
+                           "IdentityCoreTests Mac/MSIDLegacyCacheLookupBenchmarks",
+                           "IdentityCoreTests Mac/MSIDDefaultAccessorAccountEnumerationPerformanceTests",
+                           "IdentityCoreTests Mac/MSIDDefaultCredentialCacheKeyPerformanceTests" ],
+        "test_env" : { "MSID_RUN_BENCHMARKS" : "1", "MSID_BENCHMARK_OUTPUT" : os.path.abspath("./build/benchmarks/mac.json") },
+    },
 ]
 
 def print_operation_start(name, operation) :
@@ -114,6 +141,8 @@ class BuildTarget:
         self.min_codecov = target.get("min_codecov")
         self.min_warn_codecov = target.get("min_warn_codecov")
         self.use_sonarcube = target.get("use_sonarcube")
+        self.only_testing = target.get("only_testing")
+        self.test_env = target.get("test_env")
         self.coverage = None
         self.failed = False
         self.skipped = False
@@ -136,6 +165,13 @@ class BuildTarget:
             command += xcb_operation + " "
             if (xcb_operation in ("test", "test-without-building")) :
                 command += "-parallel-testing-enabled NO "
+                # xcodebuild passes TEST_RUNNER_ prefixed variables to the test process without the prefix
+                if (self.test_env != None) :
+                    for key, value in self.test_env.items() :
+                        command = "TEST_RUNNER_" + key + "='" + value + "' " + command
+                if (self.only_testing != None) :
+                    for test_identifier in self.only_testing :
+                        command += "-only-testing:'" + test_identifier + "' "
         
         if (self.project != None) :
             command += " -project " + self.project
@@ -416,7 +452,7 @@ if (args.targets != None) :
 targets = []
 
 for spec in target_specifiers :
-    if (args.targets == None or spec["target"] in args.targets) :
+    if ((args.targets == None and spec.get("default", True)) or (args.targets != None and spec["target"] in args.targets)) :
         targets.append(BuildTarget(spec))
 
 if requires_simulator(targets) :
@@ -425,6 +461,13 @@ if requires_simulator(targets) :
 # Ensure log/report output directories exist before any xcodebuild invocation.
 os.makedirs("./build/logs", exist_ok=True)
 os.makedirs("./build/reports", exist_ok=True)
+os.makedirs("./build/benchmarks", exist_ok=True)
+
+# Benchmarks merge their results into the output file, start from a clean one.
+for target in targets :
+    benchmark_output = (target.test_env or {}).get("MSID_BENCHMARK_OUTPUT")
+    if (benchmark_output != None and os.path.exists(benchmark_output)) :
+        os.remove(benchmark_output)
 
 # start by cleaning up any derived data that might be lying around
 if (clean) :
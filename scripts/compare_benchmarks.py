@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""
+Script to compare benchmark results written by MSIDBenchmarkTestCase (MSID_BENCHMARK_OUTPUT) against a baseline.
+Fails when the chosen metric of any benchmark regressed by more than the tolerance.
+
+Example:
+    python3 build.py --targets mac_benchmarks
+    python3 scripts/compare_benchmarks.py baseline/mac.json build/benchmarks/mac.json --tolerance 0.15
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_benchmarks(path):
+    """Load the benchmarks dictionary from a results file."""
+    with open(path) as results_file:
+        results = json.load(results_file)
+    
+    benchmarks = results.get("benchmarks")
+    if not isinstance(benchmarks, dict):
+        raise ValueError("No benchmarks found in " + path)
+    
+    return benchmarks
+
+
+def compare(baseline, current, metric, tolerance):
+    """Print a comparison table and return the names of regressed benchmarks."""
+    regressions = []
+    names = sorted(set(baseline) | set(current))
+    width = max([len(name) for name in names] + [len("Benchmark")])
+    
+    print("{0:<{w}}  {1:>14}  {2:>14}  {3:>8}".format("Benchmark", "Baseline (ns)", "Current (ns)", "Change", w=width))
+    
+    for name in names:
+        if name not in current:
+            print("{0:<{w}}  {1:>14.0f}  {2:>14}  {3:>8}".format(name, baseline[name][metric], "-", "missing", w=width))
+            continue
+        
+        if name not in baseline:
+            print("{0:<{w}}  {1:>14}  {2:>14.0f}  {3:>8}".format(name, "-", current[name][metric], "new", w=width))
+            continue
+        
+        baseline_value = baseline[name][metric]
+        current_value = current[name][metric]
+        change = (current_value - baseline_value) / baseline_value if baseline_value else 0.0
+        marker = ""
+        
+        if change > tolerance:
+            regressions.append(name)
+            marker = "  REGRESSION"
+        
+        print("{0:<{w}}  {1:>14.0f}  {2:>14.0f}  {3:>+7.1%}{4}".format(name, baseline_value, current_value, change, marker, w=width))
+    
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare IdentityCore benchmark results against a baseline")
+    parser.add_argument("baseline", help="Baseline results file")
+    parser.add_argument("current", help="Current results file")
+    parser.add_argument("--metric", default="median_ns", choices=["median_ns", "p90_ns", "min_ns"], help="Metric to compare (default: median_ns)")
+    parser.add_argument("--tolerance", type=float, default=0.15, help="Allowed relative slowdown before failing (default: 0.15)")
+    args = parser.parse_args()
+    
+    regressions = compare(load_benchmarks(args.baseline), load_benchmarks(args.current), args.metric, args.tolerance)
+    
+    if regressions:
+        print("\n{0} benchmark(s) regressed by more than {1:.0%}: {2}".format(len(regressions), args.tolerance, ", ".join(regressions)))
+        return 1
+    
+    print("\nNo regressions beyond {0:.0%}.".format(args.tolerance))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())